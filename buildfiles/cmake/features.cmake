@@ -111,5 +111,6 @@ feature(sonar BFIN DEPENDS math)
 feature(vision_tools DEPENDS vision)
 feature(vision_viewer DEPENDS vision)
 feature(plot DEPENDS core network control estimation vehicle vision)
+feature(gainsweep DEPENDS core math vehicle estimation control)
 
 check_features()
@@ -10,6 +10,9 @@
 #ifndef RAM_CONTROL_COMBINECONTROLLER_08_07_2008
 #define RAM_CONTROL_COMBINECONTROLLER_08_07_2008
 
+// Library Includes
+#include <boost/scoped_ptr.hpp>
+
 // Project Includes
 #include "control/include/Common.h"
 #include "control/include/ControllerBase.h"
@@ -19,10 +22,13 @@
 #include "vehicle/include/Common.h"
 
 #include "core/include/ConfigNode.h"
+#include "core/include/EventPool.h"
+#include "core/include/BinaryTrace.h"
 
 #include "math/include/Vector2.h"
 #include "math/include/Vector3.h"
 #include "math/include/Quaternion.h"
+#include "math/include/Events.h"
 
 // Must Be Included last
 #include "control/include/Export.h"
@@ -35,6 +41,14 @@ namespace control {
  *  This class easily lets you change out just the rotational, or just the
  *  depth just the in plane controller.  Which allows for much easier over
  *  all experimentation with controllers.
+ *
+ *  An update allocates nothing and formats nothing.  The control signal
+ *  events come from a pool, and if the "ControlTrace" config value names a
+ *  file in the log directory, every update records a row to it as a
+ *  core::BinaryTrace.  The row holds the measured orientation (4), angular
+ *  rate (3) and depth, the desired orientation (4), angular rate (3),
+ *  depth and speed, then the torque (3) and force (3) out.  The tracedump
+ *  tool turns it into the control.log the matlab scripts load.
  */
 
 class RAM_EXPORT CombineController : public ControllerBase
@@ -84,6 +98,9 @@ private:
     /** Does all initialzation based on the configuration settings */
     void init(core::ConfigNode config);
 
+    /** Records the state and output of an update to m_trace */
+    void recordTrace(const math::Vector3& force, const math::Vector3& torque);
+
     /** Controller which handles the inplane vehicle motion */
     ITranslationalControllerImpPtr m_transController;
     
@@ -95,6 +112,12 @@ private:
 
     /** Delay the start of the controller */
     double m_initializationPause;
+
+    /** Reused for the three control signal events of each update */
+    core::EventPool<math::Vector3Event> m_signalEvents;
+
+    /** Forces and torques of each update, NULL unless configured */
+    boost::scoped_ptr<core::BinaryTrace> m_trace;
 };
     
 } // namespace control
@@ -1,5 +1,6 @@
 function [result] = plotDepthData(file,depth_start,color)
 
+% file is a control.log written by tracedump from the ControlTrace
 a = load (file);
 
 % Find the offset index for the starting depth
@@ -11,7 +12,8 @@ depth_m = a(offset:end,8);
 depth_a = 1/5*(a(offset:end-4,8)+a(offset+1:end-3,8)+a(offset+2:end-2,8)+a(offset+3:end-1,8)+a(offset+4:end,8));
 depth_d = a(end,16);
 
-control_signal = a(offset+4:end,24)*1000;
+% Commanded z force
+control_signal = a(offset+4:end,23)*1000;
 
 % time
 t = a(offset+4:end,end)/1000;
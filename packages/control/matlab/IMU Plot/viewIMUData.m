@@ -9,6 +9,8 @@ close all
 
 %% load log files
 imuData = load('imu.log');
+% control.log is the Controller's ControlTrace, run through tracedump:
+%   tracedump control.trace control.log
 controlData = load('control.log');
 %imuRotating   = load('rotating_imu.log');
 
@@ -23,8 +25,8 @@ mag=imuData(:,4:6);
 accel=imuData(:,1:3);
 
 % Control.log
-% M-Quat M-AngRate M-Depth D-Quat D-AngRate D-Depth D-Speed RotTorq TranForce AdaptCtrlParams Time
-%    4      3        1       4       3        1        1       3       3           12 
+% M-Quat M-AngRate M-Depth D-Quat D-AngRate D-Depth D-Speed RotTorq TranForce Time
+%    4      3        1       4       3        1        1       3       3        1
 q_m  = controlData(:,1:4); %measured quaternion (unitless)
 w_m  = (180/pi)*controlData(:,5:7); %measured angular rate (we're converting to deg/s)
 depth_m = controlData(:,8); %measured depth (magical units ~= 2.3ft?)
@@ -10,6 +10,8 @@ close all;
 %      depth_m = measured depth
 %      depth_a = 5 pt averaged depth = y
 %      depth_d = desired depth
+% control.log is the Controller's ControlTrace, run through tracedump:
+%   tracedump control.trace control.log
 a = load('control.log');
 depth_m = a(5:end,8);
 depth_a = 1/5*(a(1:end-4,8)+a(2:end-3,8)+a(3:end-2,8)+a(4:end-1,8)+a(5:end,8));
@@ -24,7 +26,7 @@ u = -a(:,23);  %Control Signal values (flipped)
 m =28;      % vehicle mass (kg)
 kd = 11.5;  % drag coefficient
 buoy = .02; % Buoyant Force
-Ts = -1/1000 * (a(2,34) - a(3,34)); % Sampling time delay
+Ts = -1/1000 * (a(2,end) - a(3,end)); % Sampling time delay
 Rv = 0.550;  % Covariance of process noise: artbitrarily chosen
 Rn = 1.1e-4; % Covariance of sensor noise: determined by finding the variance of the depth sensor readings for a constant depth
 nbar = 0; %assumed
@@ -9,6 +9,8 @@ print_out = 1; %This is to print out everything
 %      depth_m = measured depth
 %      depth_a = 5 pt averaged depth = y
 %      depth_d = desired depth
+% control.log is the Controller's ControlTrace, run through tracedump:
+%   tracedump control.trace control.log
 a = load('control.log');
 depth_m = a(54:end,8);
 depth_a = 1/5*(a(1:end-4,8)+a(2:end-3,8)+a(3:end-2,8)+a(4:end-1,8)+a(5:end,8));
@@ -24,7 +26,7 @@ u = -a(:,23);  %Control Signal values (flipped)
 m =28;      % Vehicle Mass (kg)
 kd = 11.5;  % Drag Coefficient
 buoy = .02; % Buoyant Force
-Ts = 1/1000 * (a(3,34) - a(2,34)); % This is our sampling time delay
+Ts = 1/1000 * (a(3,end) - a(2,end)); % This is our sampling time delay
 alpha = 10^-2; % Spread of sigma points
 beta = 2; %Prior knowledge about distribution of x: Optimal for gaussian 
 Rv = 0.550; % Covariance of process noise: artbitrarily chosen              
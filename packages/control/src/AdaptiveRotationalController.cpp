@@ -56,7 +56,7 @@ AdaptiveRotationalController::AdaptiveRotationalController(
     m_params[12][0] = config["adaptParams"][12].asDouble(0.2);
     m_params[13][0] = config["adaptParams"][13].asDouble(0.2);
     m_params[14][0] = config["adaptParams"][14].asDouble(0.2);
-    LOGGER.info("dQuat(4) dOmega(3) eQuat(4) eOmega(3) "
+    LOGGER.debug("dQuat(4) dOmega(3) eQuat(4) eOmega(3) "
                 "params(15) torque(3) shat(3)");
 }
 
@@ -268,7 +268,7 @@ math::Vector3 AdaptiveRotationalController::rotationalUpdate(
 
     output = output-(m_rotK)*shat;
  
-    LOGGER.infoStream() << qd[0] << " "
+    LOGGER.debugStream() << qd[0] << " "
                         << qd[1] << " "
                         << qd[2] << " "
                         << qd[3] << " "
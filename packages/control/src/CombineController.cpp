@@ -32,6 +32,7 @@
 #include "core/include/SubsystemMaker.h"
 #include "core/include/EventHub.h"
 #include "core/include/Events.h"
+#include "core/include/Logging.h"
 
 #include "math/include/Helpers.h"
 #include "math/include/Vector3.h"
@@ -54,7 +55,8 @@ CombineController::CombineController(core::EventHubPtr eventHub,
     m_transController(ITranslationalControllerImpPtr()),
     m_depthController(IDepthControllerImpPtr()),
     m_rotController(IRotationalControllerImpPtr()),
-    m_initializationPause(0)
+    m_initializationPause(0),
+    m_signalEvents(8)
 { 
     init(config);
 }
@@ -65,7 +67,8 @@ CombineController::CombineController(core::ConfigNode config,
     m_transController(ITranslationalControllerImpPtr()),
     m_depthController(IDepthControllerImpPtr()),
     m_rotController(IRotationalControllerImpPtr()),
-    m_initializationPause(0)
+    m_initializationPause(0),
+    m_signalEvents(8)
 {
     init(config);
 }
@@ -73,6 +76,12 @@ CombineController::CombineController(core::ConfigNode config,
 CombineController::~CombineController()
 {
     unbackground(true);
+
+    if (m_trace && m_trace->getDropped() > 0)
+    {
+        LOGGER.warnStream() << "Control trace dropped "
+                            << m_trace->getDropped() << " updates";
+    }
 }
 
 void CombineController::init(core::ConfigNode config)
@@ -91,7 +100,24 @@ void CombineController::init(core::ConfigNode config)
 
     m_initializationPause = config["initializationPause"].asDouble(0);
 
-    LOGGER.infoStream() << "ForceOut TorqueOut";
+    if (config.exists("ControlTrace"))
+    {
+        boost::filesystem::path traceFile = core::Logging::getLogDir() /
+            config["ControlTrace"].asString();
+        m_trace.reset(new core::BinaryTrace(traceFile.string(), 23));
+        if (m_trace->isOpen())
+        {
+            LOGGER.infoStream() << "Tracing control state to "
+                                << traceFile.string();
+            m_trace->background(100);
+        }
+        else
+        {
+            LOGGER.warnStream() << "Could not open control trace "
+                                << traceFile.string();
+            m_trace.reset();
+        }
+    }
 }
 
 void CombineController::doUpdate(const double& timestep,
@@ -134,21 +160,17 @@ void CombineController::doUpdate(const double& timestep,
     translationalForceOut = inPlaneControlForce + depthControlForce;
     rotationalTorqueOut = rotControlTorque;
 
-    LOGGER.infoStream() << translationalForceOut[0] << " "
-                        << translationalForceOut[1] << " "
-                        << translationalForceOut[2] << " " 
-                        << rotationalTorqueOut[0] << " "
-                        << rotationalTorqueOut[1] << " "
-                        << rotationalTorqueOut[2];
+    if (m_trace)
+        recordTrace(translationalForceOut, rotationalTorqueOut);
 
     // publish the individual control signals
-    math::Vector3EventPtr dEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr dEvent = m_signalEvents.acquire();
     dEvent->vector3 = depthControlForce;
 
-    math::Vector3EventPtr tEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr tEvent = m_signalEvents.acquire();
     tEvent->vector3 = inPlaneControlForce;
     
-    math::Vector3EventPtr oEvent = math::Vector3EventPtr(new math::Vector3Event());
+    math::Vector3EventPtr oEvent = m_signalEvents.acquire();
     oEvent->vector3 = rotControlTorque;
 
     publish(IController::DEPTH_CONTROL_SIGNAL_UPDATE, dEvent);
@@ -156,6 +178,29 @@ void CombineController::doUpdate(const double& timestep,
     publish(IController::ORIENTATION_CONTROL_SIGNAL_UPDATE, oEvent);
 }
 
+void CombineController::recordTrace(const math::Vector3& force,
+                                    const math::Vector3& torque)
+{
+    math::Quaternion mQuat(m_stateEstimator->getEstimatedOrientation());
+    math::Vector3 mRate(m_stateEstimator->getEstimatedAngularRate());
+    math::Quaternion dQuat(m_desiredState->getDesiredOrientation());
+    math::Vector3 dRate(m_desiredState->getDesiredAngularRate());
+
+    // The columns of the old control.log, which the matlab scripts read
+    double row[23] = {
+        mQuat[0], mQuat[1], mQuat[2], mQuat[3],
+        mRate[0], mRate[1], mRate[2],
+        m_stateEstimator->getEstimatedDepth(),
+        dQuat[0], dQuat[1], dQuat[2], dQuat[3],
+        dRate[0], dRate[1], dRate[2],
+        m_desiredState->getDesiredDepth(),
+        m_desiredState->getDesiredVelocity()[0],
+        torque[0], torque[1], torque[2],
+        force[0], force[1], force[2]
+    };
+    m_trace->record(row);
+}
+
 ITranslationalControllerPtr CombineController::getTranslationalController()
 { 
     return m_transController;
@@ -25,6 +25,7 @@
 #include "core/include/SubsystemMaker.h"
 #include "core/include/EventHub.h"
 #include "core/include/TimeVal.h"
+#include "core/include/LatencyTracker.h"
 
 #include "math/include/Helpers.h"
 #include "math/include/Events.h"
@@ -143,6 +144,10 @@ void ControllerBase::update(double timestep)
 
     doUpdate(timestep, translationalForce, rotationalTorque);
 
+    // The forces are based on whatever the estimator had taken in
+    core::LatencyTracker::forward(core::LatencyTracker::CONTROLLER,
+                                  core::LatencyTracker::ESTIMATOR);
+
     // Actually set motor values
     m_vehicle->applyForcesAndTorques(translationalForce, rotationalTorque);
 }
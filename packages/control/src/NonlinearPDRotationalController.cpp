@@ -44,7 +44,7 @@ NonlinearPDRotationalController::NonlinearPDRotationalController(
                                   config["inertia"][2][2].asDouble(1.288)))
 {
     // logging header
-    LOGGER.info("NonlinarPD dQuat(4) eQuat(4) pTerm(3) dTerm(3) "
+    LOGGER.debug("NonlinarPD dQuat(4) eQuat(4) pTerm(3) dTerm(3) "
                 "gyroTerm(3) torques(3)");
 }
 
@@ -88,7 +88,7 @@ math::Vector3 NonlinearPDRotationalController::rotationalUpdate(
     math::Vector3 gTerm = w_tilde * inertiaEstimate * w_error;
 
     // log everything we might want to know
-    LOGGER.infoStream() << q_des[0] << " "
+    LOGGER.debugStream() << q_des[0] << " "
                         << q_des[1] << " "
                         << q_des[2] << " "
                         << q_des[3] << " "
@@ -39,7 +39,7 @@ PIDDepthController::PIDDepthController(
     m_dtMin(config["dtMin"].asDouble(0.02)),
     m_dtMax(config["dtMax"].asDouble(0.5))
 {
-    LOGGER.info("PIDRegulator dDepth eDepth eRate eQuat(4) timestep "
+    LOGGER.debug("PIDRegulator dDepth eDepth eRate eQuat(4) timestep "
                 "pSig dSig iSig forces_n(3) forces_b(3)");
 }
 
@@ -77,7 +77,7 @@ math::Vector3 PIDDepthController::depthUpdate(
     math::Vector3 controlSignal_b = orientation * controlSignal_n;
 
     // log everything we could possibly want to know
-    LOGGER.infoStream() << dDepth << " "
+    LOGGER.debugStream() << dDepth << " "
                         << eDepth << " "
                         << eRate << " "
                         << orientation[0] << " "
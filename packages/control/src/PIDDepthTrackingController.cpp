@@ -40,7 +40,7 @@ PIDDepthTrackingController::PIDDepthTrackingController(
     m_dtMax(config["dtMax"].asDouble(0.5))
 {
     // logging header
-    LOGGER.info("PIDTracking dDepth dRate dAccel eDepth eRate eQuat(4) "
+    LOGGER.debug("PIDTracking dDepth dRate dAccel eDepth eRate eQuat(4) "
                 "mass timestep pSig dSig iSig accelSig dragSig"
                 "force_n(3) force_b(3)");
 }
@@ -90,7 +90,7 @@ math::Vector3 PIDDepthTrackingController::depthUpdate(
     math::Vector3 controlSignal_b = orientation * controlSignal_n;
 
     // log everything we could possibly want to know
-    LOGGER.infoStream() << dDepth << " "
+    LOGGER.debugStream() << dDepth << " "
                         << dRate << " "
                         << dAccel << " "
                         << eDepth << " "
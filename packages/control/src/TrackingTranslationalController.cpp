@@ -51,7 +51,7 @@ TrackingTranslationalController::TrackingTranslationalController(
     m_dtMax = config["dtmax"].asDouble(0.5);
     
     // logging header
-    LOGGER.info("PIDTracking dPosition(2) dVelocity(2) dAccel(2) " 
+    LOGGER.debug("PIDTracking dPosition(2) dVelocity(2) dAccel(2) " 
                 "ePosition(2) eVelocity(2) mass timestep "
                 "pxSig pySig dxSig dySig ixSig iySig accelxSig accelySig"
                 "eQuat(4) forces_n(3) forces_b(3)");
@@ -73,9 +73,12 @@ math::Vector3 TrackingTranslationalController::translationalUpdate(
     math::Quaternion orientation = estimator->getEstimatedOrientation();
     double mass = estimator->getEstimatedMass();
 
-    // propagate the desired state
-    dPosition += dVelocity * timestep;
-    desiredState->setDesiredPosition(dPosition);
+    // propagate the desired state, holding position leaves it unchanged
+    if (dVelocity != math::Vector2::ZERO)
+    {
+        dPosition += dVelocity * timestep;
+        desiredState->setDesiredPosition(dPosition);
+    }
 
     // make sure timestep is not to large or small
     if(timestep < m_dtMin)
@@ -108,7 +111,7 @@ math::Vector3 TrackingTranslationalController::translationalUpdate(
     math::Vector3 controlSignal_b = orientation * controlSignal_n;
 
     // log everything we could possibly want to know
-    LOGGER.infoStream() << dPosition[0] << " "
+    LOGGER.debugStream() << dPosition[0] << " "
                         << dPosition[1] << " "
                         << dVelocity[0] << " "
                         << dVelocity[1] << " "
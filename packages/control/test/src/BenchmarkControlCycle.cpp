@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/control/test/src/BenchmarkControlCycle.cpp
+ */
+
+// Times CombineController::update, with the tracking translational, PID
+// depth and nonlinear PD rotational controllers, against a mock vehicle and
+// estimator whose state changes every tick.  Reports the mean and
+// percentiles of the time per tick, which show its jitter, and the heap
+// allocations per tick, counted by replacing operator new.
+//
+// Usage: BenchmarkControlCycle [ticks] [trace file]
+//
+// Given a trace file name, the controller also writes its binary control
+// trace to that file in the log directory.
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+#include <time.h>
+
+// Project Includes
+#include "core/include/EventHub.h"
+#include "core/include/ConfigNode.h"
+#include "control/include/CombineController.h"
+#include "control/include/IController.h"
+#include "vehicle/test/include/MockVehicle.h"
+#include "estimation/test/include/MockEstimator.h"
+
+using namespace ram;
+
+static volatile bool g_counting = false;
+static volatile size_t g_allocations = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+    if (g_counting)
+        g_allocations = g_allocations + 1;
+    void* memory = malloc(size ? size : 1);
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) throw()
+{
+    free(memory);
+}
+
+static double nowMicroseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/** Stands in for a subscriber like the logger or the GUI */
+static void signalHandler(core::EventPtr event)
+{
+}
+
+int main(int argc, char* argv[])
+{
+    int ticks = 100000;
+    if (argc > 1)
+        ticks = std::atoi(argv[1]);
+
+    std::string trace;
+    if (argc > 2)
+        trace = ", 'ControlTrace' : '" + std::string(argv[2]) + "'";
+
+    core::EventHubPtr eventHub(new core::EventHub("eventHub"));
+    MockVehicle* vehicle = new MockVehicle();
+    MockEstimator* estimator = new MockEstimator(eventHub);
+
+    control::CombineController controller(
+        eventHub, vehicle::IVehiclePtr(vehicle),
+        estimation::IStateEstimatorPtr(estimator),
+        core::ConfigNode::fromString(
+            "{ 'name' : 'BenchmarkController',"
+            "  'TranslationalController' : {"
+            "      'type' : 'TrackingTranslationalController',"
+            "      'x1kp' : 1, 'x1kd' : 0.5, 'x2kp' : 1, 'x2kd' : 0.5 },"
+            "  'DepthController' : {"
+            "      'type' : 'PIDDepthController',"
+            "      'kp' : 20, 'kd' : 5, 'ki' : 0.5 },"
+            "  'RotationalController' : {"
+            "      'type' : 'NonlinearPDRotationalController',"
+            "      'kp' : 15, 'kd' : 4 }" + trace + "}"));
+    controller.changeDepth(2);
+    controller.translate(math::Vector2(3, 1));
+
+    core::EventConnectionPtr connections[] = {
+        eventHub->subscribeToType(
+            control::IController::DEPTH_CONTROL_SIGNAL_UPDATE, &signalHandler),
+        eventHub->subscribeToType(
+            control::IController::TRANSLATION_CONTROL_SIGNAL_UPDATE,
+            &signalHandler),
+        eventHub->subscribeToType(
+            control::IController::ORIENTATION_CONTROL_SIGNAL_UPDATE,
+            &signalHandler)
+    };
+
+    std::vector<double> times(ticks);
+    size_t allocations = 0;
+    for (int i = 0; i < ticks; ++i)
+    {
+        // A slowly moving vehicle, so every controller has work to do
+        double t = i * 0.025;
+        estimator->estDepth = 2 + 0.1 * std::sin(t);
+        estimator->estDepthDot = 0.1 * std::cos(t);
+        estimator->estPosition = math::Vector2(3 + 0.2 * std::sin(t), 1);
+        estimator->estVelocity = math::Vector2(0.2 * std::cos(t), 0);
+        estimator->estAngularRate = math::Vector3(0, 0, 0.05 * std::cos(t));
+        estimator->estOrientation = math::Quaternion(
+            math::Radian(0.05 * std::sin(t)), math::Vector3::UNIT_Z);
+
+        g_allocations = 0;
+        g_counting = true;
+        double start = nowMicroseconds();
+        controller.update(0.025);
+        times[i] = nowMicroseconds() - start;
+        g_counting = false;
+        allocations += g_allocations;
+    }
+
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for (int i = 0; i < ticks; ++i)
+        total += times[i];
+
+    std::cout << ticks << " ticks" << std::endl << std::fixed
+              << std::setprecision(3)
+              << "  mean " << total / ticks << " us"
+              << "  p50 " << times[ticks / 2] << " us"
+              << "  p99 " << times[(int)(ticks * 0.99)] << " us"
+              << "  p99.9 " << times[(int)(ticks * 0.999)] << " us"
+              << "  max " << times[ticks - 1] << " us" << std::endl
+              << "  " << std::setprecision(2)
+              << (double)allocations / ticks << " allocations per tick"
+              << std::endl;
+
+    // Keeps the subscribers alive through the run
+    for (size_t i = 0; i < sizeof(connections) / sizeof(connections[0]); ++i)
+        connections[i]->disconnect();
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2007 Robotics at Maryland
+ * Copyright (C) 2007 Joseph Lisee <jlisee@umd.edu>
+ * All rights reserved.
+ *
+ * Author: Joseph Lisee <jlisee@umd.edu>
+ * File:  packages/control/test/src/TestQueuedEventHubLanes.cxx
+ */
+
+// STD Includes
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/EventHub.h"
+#include "core/include/QueuedEventHub.h"
+
+#include "vehicle/include/IVehicle.h"
+#include "vehicle/include/device/IThruster.h"
+#include "vehicle/include/device/IDepthSensor.h"
+#include "vehicle/include/device/IIMU.h"
+#include "estimation/include/IStateEstimator.h"
+#include "control/include/IController.h"
+
+using namespace ram;
+
+static std::string configFile(std::string name)
+{
+    return std::string(getenv("RAM_SVN_DIR")) + "/data/config/" + name;
+}
+
+struct QueuedEventHubLanesFixture
+{
+    QueuedEventHubLanesFixture() :
+        eventHub(new core::EventHub("EventHub"))
+    {
+    }
+
+    core::QueuedEventHubPtr makeHub(std::string file)
+    {
+        core::ConfigNode config(
+            core::ConfigNode::fromFile(configFile(file))["QueuedEventHub"]);
+        config.set("name", "QueuedEventHub");
+
+        core::SubsystemList deps;
+        deps.push_back(eventHub);
+        return core::QueuedEventHubPtr(new core::QueuedEventHub(config, deps));
+    }
+
+    void checkLanes(core::QueuedEventHubPtr qeventHub)
+    {
+        CHECK_EQUAL(core::QueuedEventHub::CRITICAL_LANE, qeventHub->getTypeLane(
+                        vehicle::device::IThruster::DISABLED));
+        CHECK_EQUAL(core::QueuedEventHub::CRITICAL_LANE, qeventHub->getTypeLane(
+                        vehicle::device::IThruster::ENABLED));
+        CHECK_EQUAL(core::QueuedEventHub::CRITICAL_LANE, qeventHub->getTypeLane(
+                        control::IController::AT_DEPTH));
+
+        CHECK_EQUAL(core::QueuedEventHub::LATEST_LANE, qeventHub->getTypeLane(
+            estimation::IStateEstimator::ESTIMATED_DEPTH_UPDATE));
+        CHECK_EQUAL(core::QueuedEventHub::LATEST_LANE, qeventHub->getTypeLane(
+            estimation::IStateEstimator::ESTIMATED_ORIENTATION_UPDATE));
+        CHECK_EQUAL(core::QueuedEventHub::LATEST_LANE, qeventHub->getTypeLane(
+                        vehicle::device::IDepthSensor::UPDATE));
+        CHECK_EQUAL(core::QueuedEventHub::LATEST_LANE, qeventHub->getTypeLane(
+                        vehicle::IVehicle::VEHICLE_THRUST_UPDATE));
+
+        // There is more than one IMU, so their updates can't be coalesced
+        CHECK_EQUAL(core::QueuedEventHub::NORMAL_LANE, qeventHub->getTypeLane(
+                        vehicle::device::IIMU::UPDATE));
+        CHECK_EQUAL(core::QueuedEventHub::NORMAL_LANE, qeventHub->getTypeLane(
+                        control::IController::DESIRED_DEPTH_UPDATE));
+    }
+
+    void handler(core::EventPtr event)
+    {
+        received.push_back(event->type);
+    }
+
+    core::EventHubPtr eventHub;
+    std::vector<core::Event::EventType> received;
+};
+
+SUITE(QueuedEventHubLanes)
+{
+
+TEST_FIXTURE(QueuedEventHubLanesFixture, base)
+{
+    checkLanes(makeHub("base.yml"));
+}
+
+TEST_FIXTURE(QueuedEventHubLanesFixture, testbase)
+{
+    checkLanes(makeHub("testbase.yml"));
+}
+
+TEST_FIXTURE(QueuedEventHubLanesFixture, publishOrder)
+{
+    core::QueuedEventHubPtr qeventHub(makeHub("base.yml"));
+    qeventHub->subscribeToAll(
+        boost::bind(&QueuedEventHubLanesFixture::handler, this, _1));
+
+    // Sensor updates pile up behind a slow consumer, then the safety trips
+    const core::Event::EventType& depth =
+        estimation::IStateEstimator::ESTIMATED_DEPTH_UPDATE;
+    eventHub->publish(depth, core::EventPtr(new core::Event()));
+    eventHub->publish(control::IController::DESIRED_DEPTH_UPDATE,
+                      core::EventPtr(new core::Event()));
+    eventHub->publish(depth, core::EventPtr(new core::Event()));
+    eventHub->publish(depth, core::EventPtr(new core::Event()));
+    eventHub->publish(vehicle::device::IThruster::DISABLED,
+                      core::EventPtr(new core::Event()));
+
+    CHECK_EQUAL(3, qeventHub->publishEvents());
+    CHECK_EQUAL(2u, qeventHub->getCoalescedCount());
+
+    CHECK_EQUAL(3u, received.size());
+    if (3u == received.size())
+    {
+        CHECK_EQUAL(vehicle::device::IThruster::DISABLED, received[0]);
+        CHECK_EQUAL(control::IController::DESIRED_DEPTH_UPDATE, received[1]);
+        CHECK_EQUAL(depth, received[2]);
+    }
+}
+
+} // SUITE(QueuedEventHubLanes)
@@ -14,6 +14,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <iosfwd>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
 
 // Project Includes
 #include "core/include/Subsystem.h"
@@ -26,6 +32,9 @@
 namespace ram {
 namespace core {
 
+class PeriodicScheduler;
+class DependencyGraph;
+
 typedef std::map<std::string, SubsystemPtr> NameSubsystemMap;
 typedef NameSubsystemMap::iterator NameSubsystemMapIter;
     
@@ -34,8 +43,41 @@ typedef NameSubsystemMap::iterator NameSubsystemMapIter;
 class RAM_EXPORT Application
 {
 public:
+    /** Timing of the passes through the main loop, in seconds */
+    struct MainLoopStats
+    {
+        MainLoopStats() :
+            passes(0), threads(1), steals(0), lastPass(0), meanPass(0),
+            maxPass(0) {}
+
+        unsigned int passes;
+        int threads;
+
+        /** Subsystems one thread took from the queue of another */
+        unsigned int steals;
+        
+        double lastPass;
+        double meanPass;
+        double maxPass;
+
+        /** Duration of the last update of each subsystem */
+        std::map<std::string, double> updateTime;
+        std::map<std::string, double> maxUpdateTime;
+    };
+    
     /** Starts up the application with the Subsystem definied in the given
         config file
+
+        Subsystems are created in dependency order.  If the root of the config
+        sets "SubsystemCreationThreads" above 1, that many threads create
+        the subsystems, each one starting as soon as everything it depends
+        on exists.  A timeline of the startup is written to "startup.txt" in
+        the log directory, next to the dependency graph.
+
+        Setting "TraceEvents" to 1 turns on the EventTracer, whose trace is
+        written to "events.json" in the log directory on destruction.
+        Setting "TraceLatency" to 1 turns on the LatencyTracker, whose
+        report is written to "latency.txt" the same way.
     */
     Application(std::string configPath = "");
 
@@ -57,6 +99,20 @@ public:
      *  updated in a continous loop, as fast as possible.  It will stop when
      *  stopMainLoop() is called.
      *
+     *  If the config has a "VirtualTime" section the clock only moves by
+     *  "step" seconds (default 0.01) after each pass through the
+     *  subsystems, which are updated in dependency order at their
+     *  "update_interval" instead of being backgrounded.  The loop also stops
+     *  after "duration" seconds of virtual time, if given.
+     *
+     *  If the root of the config sets "MainLoopThreads" above 1, each pass
+     *  is shared by that many threads, this one included.  A subsystem is
+     *  only updated once every non-backgrounded subsystem it depends on has
+     *  been updated that pass, the rest run at the same time.  Each thread
+     *  keeps its own queue of ready subsystems and takes from the others
+     *  when it runs out.  Subsystems written in Python still run one at a
+     *  time, under the interpreter lock.
+     *
      *  @param singleSubsystem
      *      If true, the system will only run if a single subsystem is
      *      backgrounded at a time, this helps catch bugs related to process
@@ -67,9 +123,39 @@ public:
 
     /** Stops the loop started by the mainLoop() */
     void stopMainLoop();
+
+    /** How long the passes through the main loop, and the updates in them,
+        have taken so far */
+    MainLoopStats getMainLoopStats();
     
 private:
     typedef std::vector<std::string> NameList;
+
+    enum CreationResult {
+        CREATED,
+        // No config section, or a dependency failed
+        MISSING,
+        // No maker for the type
+        INVALID,
+        SKIPPED
+    };
+
+    /** How long each subsystem took to start, all in seconds */
+    struct StartupTime
+    {
+        StartupTime() : start(0), construct(0), background(0) {}
+
+        /** Since creation of the first subsystem began */
+        double start;
+        double construct;
+
+        /** Time taken to set the priority, affinity and background it */
+        double background;
+        NameList dependencies;
+    };
+
+    struct CreationState;
+    struct LoopState;
     
     /** Does all the work to determine in what order we should start up
      subsystems using a topological sort and BGL */
@@ -78,6 +164,51 @@ private:
     /** Removes a subsystem from the dependency order (for broken subsystems) */
     void remove_from_order(std::string name);
 
+    /** The mainLoop when running in virtual time */
+    void lockstepLoop();
+
+    /** The mainLoop when running with more than one thread */
+    void parallelLoop(bool singleSubsystem);
+
+    /** Rebuilds the tasks if the set of non-backgrounded subsystems has
+        changed since the last pass */
+    void updateLoopTasks(LoopState* state);
+
+    /** Runs the passes started by the main thread until the loop stops */
+    void loopWorker(LoopState* state, size_t worker);
+
+    /** Updates subsystems until every one in the current pass is done */
+    void runPass(LoopState* state, size_t worker);
+
+    /** Records the first error, which is thrown once the pass is over */
+    void loopFailed(LoopState* state, std::string error, bool python);
+
+    /** Adds one update of the subsystem to the main loop stats */
+    void recordUpdate(const std::string& name, double seconds);
+
+    /** Adds one pass to the main loop stats */
+    void recordPass(double seconds, unsigned int steals);
+
+    /** Creates every subsystem in m_order, filling in m_creationResults */
+    void createSubsystems(ConfigNode sysConfig, DependencyGraph& depGraph,
+                          int threads);
+
+    /** Creates subsystems as they become ready, until there are none left */
+    void creationWorker(CreationState* state);
+
+    /** Records the first error, which stops all the workers */
+    void creationFailed(CreationState* state, std::string error);
+
+    CreationResult createSubsystem(std::string subsystemName,
+                                   ConfigNode sysConfig, SubsystemList deps,
+                                   SubsystemPtr& subsystem);
+
+    /** Writes the time taken by each subsystem, and the critical path */
+    void writeStartupTimeline(std::ostream& out, int threads);
+
+    /** Seconds since the epoch on the real clock */
+    static double wallTime();
+
     /** Whether or not the main loop is running*/
     bool m_running;
     
@@ -89,6 +220,35 @@ private:
 
     /** Records when the the subsystem was last updated */
     std::map<std::string, TimeVal> m_lastUpdate;
+
+    /** Runs the periodic subsystems, NULL if there is no "Scheduler" config
+        section */
+    boost::shared_ptr<PeriodicScheduler> m_scheduler;
+
+    /** Threads which share each pass of the main loop */
+    int m_loopThreads;
+
+    /** The subsystems each subsystem depends on */
+    std::map<std::string, NameList> m_dependencies;
+
+    boost::mutex m_loopStatsMutex;
+    MainLoopStats m_loopStats;
+    
+    /** Update interval (ms) of each subsystem stepped in virtual time */
+    std::map<std::string, int> m_updateIntervals;
+
+    /** How far virtual time moves each pass of the main loop (usec) */
+    boost::int64_t m_virtualStep;
+
+    /** How long to run in virtual time (usec), negative for no limit */
+    boost::int64_t m_virtualDuration;
+
+    std::map<std::string, CreationResult> m_creationResults;
+
+    std::map<std::string, StartupTime> m_startupTimes;
+
+    /** When subsystem creation began */
+    double m_startupBegin;
 };
 
 } // namespace core
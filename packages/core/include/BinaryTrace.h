@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/BinaryTrace.h
+ */
+
+#ifndef RAM_CORE_BINARYTRACE_H_07_18_2011
+#define RAM_CORE_BINARYTRACE_H_07_18_2011
+
+// STD Includes
+#include <string>
+#include <vector>
+#include <cstdio>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+
+// Project Includes
+#include "core/include/Updatable.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Records rows of doubles from a realtime thread into a binary file
+ *
+ *  record() copies a timestamped row into a fixed ring and returns, it never
+ *  allocates, formats or blocks, so it can be called every control cycle.
+ *  While backgrounded the rows are written out in batches by the background
+ *  thread, and whatever is left is written when the trace is destroyed.
+ *  Rows are dropped, and counted, if the ring fills up before it is written.
+ *
+ *  The file holds the 8 byte magic "RAMTRACE", the number of values per row
+ *  as a 32 bit integer, then the rows.  Each row is the time of the record
+ *  as a 64 bit count of microseconds, on the EventTracer clock, followed by
+ *  the values, all in native byte order.
+ *
+ *  Only one thread may call record().  BinaryTraceReader reads the file
+ *  back, and the tracedump tool turns it into text.
+ */
+class RAM_EXPORT BinaryTrace : public Updatable
+{
+public:
+    static const char* const MAGIC;
+
+    /** Opens the file, rows of values which do not fit capacity rows are
+        dropped until they are written out */
+    BinaryTrace(const std::string& filename, int values,
+                size_t capacity = 4096);
+
+    virtual ~BinaryTrace();
+
+    /** Copies in a row of as many values as the trace was made for
+     *
+     *  @return
+     *      false if the row was dropped because the ring is full
+     */
+    bool record(const double* values);
+
+    /** Writes out the recorded rows */
+    virtual void update(double timestep);
+
+    /** Returns false if the file could not be opened */
+    bool isOpen() const;
+
+    /** Returns the number of values in each row */
+    int getValues() const;
+
+    /** Returns the number of rows dropped because the ring was full */
+    size_t getDropped() const;
+
+private:
+    /** Writes rows [m_read, end) to the file */
+    void write(size_t end);
+
+    FILE* m_file;
+    int m_values;
+    size_t m_capacity;
+
+    /** Bytes in a row, counting the time */
+    size_t m_rowBytes;
+
+    /** capacity rows, laid out as they are in the file */
+    std::vector<char> m_rows;
+
+    /** Rows recorded, only moved on by record() once the row is written */
+    volatile size_t m_written;
+
+    /** Rows written out, only moved on by update() */
+    volatile size_t m_read;
+
+    volatile size_t m_dropped;
+};
+
+/** Reads back the rows of a file written by BinaryTrace */
+class RAM_EXPORT BinaryTraceReader : boost::noncopyable
+{
+public:
+    /** Opens the file and checks its header */
+    BinaryTraceReader(const std::string& filename);
+
+    ~BinaryTraceReader();
+
+    /** Returns false if the file could not be opened or is not a trace */
+    bool isOpen() const;
+
+    /** Returns the number of values in each row */
+    int getValues() const;
+
+    /** Reads the next row
+     *
+     *  @param time
+     *      Set to when the row was recorded, in microseconds on the
+     *      EventTracer clock
+     *  @param values
+     *      Filled with getValues() values
+     *
+     *  @return
+     *      false once there are no more whole rows
+     */
+    bool next(boost::int64_t& time, double* values);
+
+private:
+    FILE* m_file;
+    int m_values;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_BINARYTRACE_H_07_18_2011
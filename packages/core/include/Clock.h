@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/Clock.h
+ */
+
+#ifndef RAM_CORE_CLOCK_H_06_21_2011
+#define RAM_CORE_CLOCK_H_06_21_2011
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** The source of time for the whole process
+ *
+ *  Normally this reads the system clocks.  In virtual time, time only moves
+ *  when advance() is called, which lets a recorded run be replayed in
+ *  lockstep as fast as the CPU allows, with the same results every time.
+ *
+ *  A thread sleeping in virtual time blocks until another thread advances
+ *  the clock past its wake up time.  The thread which advances the clock
+ *  can never be woken that way, so its sleeps return immediately.
+ *
+ *  All times are in microseconds.
+ */
+class RAM_EXPORT Clock
+{
+public:
+    /** Switches to virtual time
+     *
+     *  The calling thread becomes the one which advances the clock.
+     *
+     *  @param startTime
+     *      What timeOfDay() returns until the clock is first advanced
+     */
+    static void setVirtual(boost::int64_t startTime = 0);
+
+    /** Switches back to the system clocks, waking every sleeping thread */
+    static void setReal();
+
+    static bool isVirtual();
+
+    /** Moves virtual time forward, waking the threads sleeping till then */
+    static void advance(boost::int64_t usec);
+
+    /** Time since the epoch */
+    static boost::int64_t timeOfDay();
+
+    /** Time on a clock which never jumps, only meaningful for differences */
+    static boost::int64_t monotonicTime();
+
+    /** Sleeps until the given monotonicTime() */
+    static void sleepUntil(boost::int64_t time);
+
+    /** Sleeps for the given duration */
+    static void sleep(boost::int64_t usec);
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_CLOCK_H_06_21_2011
@@ -78,17 +78,31 @@ public:
 
     /** Map a value to the the given int inside a config node */
     void set(std::string key, int value);
+
+    /** Map a value to the the given double inside a config node */
+    void set(std::string key, double value);
     
     /** Builds a config node from the given string, this uses the python ver. */
     static ConfigNode fromString(std::string data);
 
+    /** Builds a config node from YAML text, parsed natively so it can be
+        used without holding the Python interpreter lock */
+    static ConfigNode fromYamlString(std::string data);
+
+    /** True if the node is a Python object, which can only be used while
+        holding the interpreter lock */
+    bool isPython();
+
     /** Returns the config file in a python evalable format */
     std::string toString();
 
     /** Attempts to load the config from file, the extension determines the
-     backend used (NOT YET!!! - see below)
+     backend used
 
-     @warning: This currently assume yml files and python yaml library 
+     ".yml" and ".sml" files are parsed natively, without Python, unless
+     the RAM_PYTHON_CONFIG environment variable is set, then they are loaded
+     through the python yaml library.  ".ymlc" files are snapshots written
+     by the compileconfig tool.
     */
     static ConfigNode fromFile(std::string fileName);
 
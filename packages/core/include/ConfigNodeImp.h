@@ -63,6 +63,9 @@ public:
     /** Map a key to a given value */
     virtual void set(std::string key, int value) = 0;
 
+    /** Map a key to a given value */
+    virtual void set(std::string key, double value) = 0;
+
     /** Returns the config file in a python evalable format */
     virtual std::string toString() = 0;
 
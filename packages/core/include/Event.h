@@ -15,6 +15,7 @@
 
 // Library Includes
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 
 // Project Includes
 #include "core/include/Forward.h"
@@ -50,6 +51,15 @@ struct RAM_EXPORT Event
      */
     double timeStamp;
 
+    /** When the data behind the event arrived from the hardware
+     *
+     *  Microseconds on the monotonic clock of LatencyTracker::now(), set by
+     *  the driver which read the data, and 0 when unknown.  Events derived
+     *  from the data should carry it on, so the time the data takes to reach
+     *  each stage can be measured.
+     */
+    boost::int64_t arrivalTime;
+
   protected:
     /** Copies all elements of the event into the given event */
     void copyInto(EventPtr inEvent);
@@ -103,7 +103,7 @@ public:
      *
      *  This event goes out through the event hub as well.
      */
-    virtual void publish(Event::EventType type, EventPtr event);
+    virtual void publish(const Event::EventType& type, EventPtr event);
 
     /** Does nothing for this class */
     virtual void update(double timestep);
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/EventPool.h
+ */
+
+#ifndef RAM_CORE_EVENTPOOL_H_07_18_2011
+#define RAM_CORE_EVENTPOOL_H_07_18_2011
+
+// STD Includes
+#include <vector>
+#include <cstddef>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+// Project Includes
+#include "core/include/TimeVal.h"
+
+namespace ram {
+namespace core {
+
+/** Reuses events which are published over and over from one thread
+ *
+ *  Holds a fixed ring of events made up front.  acquire() hands out the
+ *  next one which nothing else still refers to, so an event only comes back
+ *  once every handler, queue and logger is done with it.  Only when every
+ *  event in the ring is still held is a new one allocated, it takes the
+ *  place of the held one, which is then freed as usual by its last holder.
+ *
+ *  Reused events get a fresh timeStamp, but keep the rest of their fields,
+ *  so the caller must set every field it publishes.  A pool must only be
+ *  used from one thread at a time.
+ *
+ *  @code
+ *  core::EventPool<math::Vector3Event> m_pool;
+ *  ...
+ *  math::Vector3EventPtr event = m_pool.acquire();
+ *  event->vector3 = force;
+ *  publish(FORCE_UPDATE, event);
+ *  @endcode
+ */
+template <class T>
+class EventPool : boost::noncopyable
+{
+public:
+    typedef boost::shared_ptr<T> TPtr;
+
+    EventPool(size_t size = 4) :
+        m_next(0),
+        m_allocations(0)
+    {
+        if (0 == size)
+            size = 1;
+        m_events.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            m_events.push_back(TPtr(new T()));
+    }
+
+    /** Returns an event which is referenced by nothing but the pool */
+    TPtr acquire()
+    {
+        size_t size = m_events.size();
+        for (size_t i = 0; i < size; ++i)
+        {
+            TPtr& event = m_events[(m_next + i) % size];
+            if (event.unique())
+            {
+                m_next = (m_next + i + 1) % size;
+                // Stamped like a new event would be
+                event->timeStamp = TimeVal::timeOfDay().get_double();
+                event->arrivalTime = 0;
+                return event;
+            }
+        }
+
+        // Everything is still in use, replace the next one
+        TPtr& event = m_events[m_next];
+        event = TPtr(new T());
+        m_next = (m_next + 1) % size;
+        m_allocations++;
+        return event;
+    }
+
+    /** The number of events in the ring */
+    size_t size() const { return m_events.size(); }
+
+    /** The number of events made because the whole ring was in use */
+    size_t getAllocations() const { return m_allocations; }
+
+private:
+    std::vector<TPtr> m_events;
+    size_t m_next;
+    size_t m_allocations;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTPOOL_H_07_18_2011
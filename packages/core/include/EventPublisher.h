@@ -55,7 +55,7 @@ public:
                                          boost::function<void (EventPtr)> handler);
     
     /** Call all handlers of the given type with the given event */
-    virtual void publish(Event::EventType type, EventPtr event);
+    virtual void publish(const Event::EventType& type, EventPtr event);
 
     /** Gets the id of the EventPublisher, or "UNNAMED" if it has no name */
     std::string getPublisherName();
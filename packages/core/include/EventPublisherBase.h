@@ -21,6 +21,7 @@
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/EventConnection.h"
 #include "core/include/EventHub.h"
+#include "core/include/EventTracer.h"
 #include "core/include/Forward.h"
 
 // Must Be Included last
@@ -40,8 +41,14 @@ class EventPublisherBaseTemplate :
     public EventPublisherBase
 {
 public:
+    /** @param traced
+     *      Whether publishes are given to the EventTracer, the EventHub's
+     *      own publishers are not, their time is part of the publish which
+     *      reached the hub
+     */
     EventPublisherBaseTemplate(EventHubPtr hub = EventHubPtr(),
-                               std::string name = "UNNAMED");
+                               std::string name = "UNNAMED",
+                               bool traced = true);
     
     virtual ~EventPublisherBaseTemplate() {};
 
@@ -50,7 +57,8 @@ public:
         boost::function<void (EventPtr)> handler);
     
 
-    virtual void publish(T subscribeType, Event::EventType etype,
+    virtual void publish(const T& subscribeType,
+                         const Event::EventType& etype,
                          EventPublisher* sender, EventPtr event);
 
     std::string getPublisherName();
@@ -98,6 +106,8 @@ private:
 
     /// The hub to which all messages are puslished
     EventHubPtr m_hub;
+
+    bool m_traced;
     
     /// Protects access to map of types->signals
     ReadWriteMutex m_signalMapMutex;
@@ -116,9 +126,11 @@ private:
     
 template<typename T>
 EventPublisherBaseTemplate<T>::EventPublisherBaseTemplate(EventHubPtr hub,
-                                                          std::string name) :
+                                                          std::string name,
+                                                          bool traced) :
     m_name(name),
-    m_hub(hub)    
+    m_hub(hub),
+    m_traced(traced)
 {
 }
     
@@ -127,6 +139,10 @@ EventConnectionPtr EventPublisherBaseTemplate<T>::subscribe(
     T type,
     boost::function<void (EventPtr)> handler)
 {
+    // Untraced handlers are called directly, not through another function
+    if (EventTracer::isEnabled())
+        handler = EventTracer::traceHandler(handler);
+
     ReadWriteMutex::ScopedWriteLock lock(m_signalMapMutex);
     return EventConnectionPtr(
         new typename EventPublisherBaseTemplate<T>::Connection(type, this,
@@ -134,11 +150,16 @@ EventConnectionPtr EventPublisherBaseTemplate<T>::subscribe(
 }
 
 template<typename T>
-void EventPublisherBaseTemplate<T>::publish(T subscribeType,
-                                            Event::EventType etype,
+void EventPublisherBaseTemplate<T>::publish(const T& subscribeType,
+                                            const Event::EventType& etype,
                                             EventPublisher* sender,
                                             EventPtr event)
 {
+    bool tracing = m_traced && EventTracer::isEnabled();
+    boost::int64_t start = 0;
+    if (tracing)
+        start = EventTracer::now();
+    
     // Set event property
     event->type = etype;
     event->sender = sender;
@@ -157,6 +178,9 @@ void EventPublisherBaseTemplate<T>::publish(T subscribeType,
 
     if (m_hub)
         m_hub->publish(event);
+
+    if (tracing)
+        EventTracer::recordPublish(etype, start, EventTracer::now());
 }
 
 template<typename T>
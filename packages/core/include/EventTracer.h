@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/EventTracer.h
+ */
+
+#ifndef RAM_CORE_EVENTTRACER_H_07_12_2011
+#define RAM_CORE_EVENTTRACER_H_07_12_2011
+
+// STD Includes
+#include <map>
+#include <string>
+#include <iosfwd>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+
+// Project Includes
+#include "core/include/Event.h"
+#include "core/include/TimingStats.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Records how long events take to get through publishers, hubs and handlers
+ *
+ *  While enabled, every publish by an EventPublisher or out of a
+ *  QueuedEventHub, every call of a handler and the time each event waits in
+ *  a QueuedEventHub are recorded.  Each thread writes to buffers of its own
+ *  without locking, so tracing does not serialize the threads publishing
+ *  events.  The statistics cover everything since tracing was first
+ *  enabled, and the last RING_SIZE records of each running thread are kept
+ *  for writeChromeTrace().  A thread's buffers are freed when it exits,
+ *  only the last RING_SIZE records of all the exited threads are kept.
+ *
+ *  Handlers are only timed if they were subscribed while tracing was
+ *  enabled, so it must be enabled before the subsystems are created.
+ *  While disabled each publish only costs a check of a flag.  Times are in
+ *  microseconds on the system's monotonic clock, which keeps running in
+ *  virtual time.
+ */
+class RAM_EXPORT EventTracer
+{
+public:
+    /** Records kept by each thread for writeChromeTrace() */
+    static const size_t RING_SIZE = 4096;
+
+    /** Event types and handlers past this many share one set of stats */
+    static const int MAX_NAMES = 256;
+
+    /** Durations in the power of two buckets of TimingStats */
+    struct RAM_EXPORT Histogram
+    {
+        Histogram();
+
+        void record(boost::int64_t usec);
+
+        /** Adds the counts of other into this */
+        void merge(const Histogram& other);
+
+        double getMean() const;
+
+        /** The smallest bucket limit at least fraction of the durations
+            fell under, -1 if there are none */
+        boost::int64_t getPercentile(double fraction) const;
+
+        unsigned int count;
+        boost::int64_t total;
+        boost::int64_t max;
+        unsigned int buckets[TimingStats::BUCKETS];
+    };
+
+    struct TypeStats
+    {
+        /** From the start of the publish, until every handler returned */
+        Histogram publishTime;
+
+        /** Each call of a handler of the type */
+        Histogram handlerTime;
+
+        /** From being queued in a QueuedEventHub until it was published */
+        Histogram queueTime;
+    };
+
+    typedef std::map<std::string, TypeStats> TypeStatsMap;
+    typedef std::map<std::string, Histogram> HandlerStatsMap;
+
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() { return s_enabled; }
+
+    /** The time tracing uses */
+    static boost::int64_t now();
+
+    /** Records one publish of the event type */
+    static void recordPublish(const Event::EventType& type,
+                              boost::int64_t start, boost::int64_t end);
+
+    /** Records one event waiting in a queue */
+    static void recordQueued(const Event::EventType& type,
+                             boost::int64_t queued, boost::int64_t published);
+
+    /** Wraps the handler so that each call of it is recorded while
+     *  tracing is enabled
+     *
+     *  Handlers are named after the type of the function object they hold,
+     *  so a bound member function is named after its class.
+     */
+    static boost::function<void (EventPtr)> traceHandler(
+        boost::function<void (EventPtr)> handler);
+
+    /** Statistics of each event type seen while enabled, merged from every
+     *  thread.  Counts may be a little behind when events are flowing. */
+    static TypeStatsMap getTypeStats();
+
+    /** Time spent in each handler, merged from every thread */
+    static HandlerStatsMap getHandlerStats();
+
+    /** Writes the kept records in the Chrome trace event JSON format
+     *
+     *  The file can be opened in chrome://tracing or the Perfetto UI.
+     *  Publishes and handler calls are slices on the thread which ran them,
+     *  time spent queued is an async slice per event type.
+     */
+    static void writeChromeTrace(std::ostream& out);
+
+private:
+    EventTracer() {}
+
+    static volatile bool s_enabled;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_EVENTTRACER_H_07_12_2011
@@ -50,6 +50,33 @@ struct IntEvent : public core::Event
 
 typedef boost::shared_ptr< IntEvent > IntEventPtr;
 
+/** Published by Updatable under IUpdatable::PROFILE about once a second
+ *
+ *  data is the number of updates since the last event, all times are in
+ *  microseconds.
+ */
+struct ProfileEvent : public IntEvent
+{
+    ProfileEvent() : deadlineMisses(0), meanJitter(0), maxJitter(0),
+                     jitter99(0), maxRunTime(0) {}
+
+    virtual EventPtr clone();
+
+    /** Updates which finished after the next release time */
+    int deadlineMisses;
+
+    /** How late updates started relative to their release time */
+    double meanJitter;
+    double maxJitter;
+
+    /** Histogram bucket limit 99% of updates started within */
+    double jitter99;
+
+    double maxRunTime;
+};
+
+typedef boost::shared_ptr< ProfileEvent > ProfileEventPtr;
+
 } // namespace core
 } // namespace ram
 
@@ -38,6 +38,28 @@ private:
     std::string m_key;
 };
 
+/** Thrown by the native config nodes for bad files and failed conversions */
+class ConfigException : public std::exception
+{
+public:
+    ConfigException(std::string message) :
+        m_message(message)
+    {
+    }
+
+    virtual ~ConfigException() throw ()
+    {
+    }
+
+    virtual const char* what() const throw()
+    {
+        return m_message.c_str();
+    }
+
+private:
+    std::string m_message;
+};
+
 } // namespace core
 } // namespace ram
 
@@ -27,6 +27,8 @@ namespace core {
 class RAM_EXPORT IUpdatable
 {
 public:
+    /** Sent about once a second with a ProfileEvent describing the timing of
+     *  the background updates */
     static const ram::core::Event::EventType PROFILE;
 
     enum Priority
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/LatencyTracker.h
+ */
+
+#ifndef RAM_CORE_LATENCYTRACKER_H_07_15_2011
+#define RAM_CORE_LATENCYTRACKER_H_07_15_2011
+
+// STD Includes
+#include <map>
+#include <string>
+#include <iosfwd>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/Event.h"
+#include "core/include/EventTracer.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Measures how long sensor data takes to become a thruster command
+ *
+ *  Drivers stamp each event with the time its bytes arrived
+ *  (Event::arrivalTime), and record() it at the DRIVER stage.  Every later
+ *  stage records the age of the newest data it has used from each source,
+ *  so there is a histogram of the latency from the arrival of a sensors
+ *  data to each stage:
+ *
+ *    DRIVER -> ESTIMATOR -> CONTROLLER -> THRUSTERS
+ *
+ *  Stages which see the events themselves call record(), stages which only
+ *  see the results of earlier ones, like the controller, call forward().
+ *  A sample is counted at most once per stage, so data which is overwritten
+ *  before the controller runs does not count.
+ *
+ *  While disabled each call only costs a check of a flag.  Times are in
+ *  microseconds on the same monotonic clock as the EventTracer.
+ */
+class RAM_EXPORT LatencyTracker
+{
+public:
+    /** The data has been read and published by its driver */
+    static const char* const DRIVER;
+
+    /** An estimation module has folded the data into the estimated state */
+    static const char* const ESTIMATOR;
+
+    /** A controller has computed forces from an estimate using the data */
+    static const char* const CONTROLLER;
+
+    /** Thruster speeds based on the data were sent to the SensorBoard */
+    static const char* const THRUSTERS;
+
+    /** Latency to each stage, by stage name */
+    typedef std::map<std::string, EventTracer::Histogram> StageStatsMap;
+
+    /** Latencies of each source, by source name */
+    typedef std::map<std::string, StageStatsMap> SourceStatsMap;
+
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled() { return s_enabled; }
+
+    /** The time arrival times are taken with */
+    static boost::int64_t now();
+
+    /** Records data from the source, which arrived at the given time,
+        reaching the stage now.  Ignored when arrival is 0. */
+    static void record(const std::string& source, const std::string& stage,
+                       boost::int64_t arrival);
+
+    /** Records the event reaching the stage now, named after its sender */
+    static void record(EventPtr event, const std::string& stage);
+
+    /** Records that the newest data from every source, which has reached
+        the from stage, has now reached the stage as well */
+    static void forward(const std::string& stage, const std::string& from);
+
+    /** Every latency recorded while enabled */
+    static SourceStatsMap getStats();
+
+    /** Writes a table of the count, mean, median, 99th percentile and
+        maximum latency, in microseconds, of each source at each stage */
+    static void writeReport(std::ostream& out);
+
+private:
+    LatencyTracker() {}
+
+    static volatile bool s_enabled;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_LATENCYTRACKER_H_07_15_2011
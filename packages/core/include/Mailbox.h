@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/Mailbox.h
+ */
+
+#ifndef RAM_CORE_MAILBOX_H_08_02_2011
+#define RAM_CORE_MAILBOX_H_08_02_2011
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/thread/thread.hpp>
+
+// System Includes
+#ifdef RAM_WINDOWS
+#include <windows.h> // For MemoryBarrier()
+#endif // RAM_WINDOWS
+
+namespace ram {
+namespace core {
+
+/** Holds the latest value one thread writes for any number of readers
+ *
+ *  A sequence lock: the writer bumps a counter to odd, copies the value in
+ *  and bumps it back to even.  Readers copy the value out and check the
+ *  counter did not move while they did, trying again if it did.  Neither
+ *  side ever blocks the other, so a reader in the controller or the Python
+ *  layer never waits on the sensor thread and the sensor thread never waits
+ *  on them.
+ *
+ *  Readers which poll can pass back the version of the value they hold to
+ *  readIfChanged(), which only copies when there is something new.
+ *
+ *  Only one thread may write.  T must be plain data, a reader can copy out
+ *  a half written value before finding out it has to try again.
+ *
+ *  @code
+ *  core::Mailbox<RawIMUData> m_rawState;
+ *  ...
+ *  m_rawState.write(newState);  // sensor thread
+ *  ...
+ *  RawIMUData state;
+ *  m_rawState.read(state);      // any other thread
+ *  @endcode
+ */
+template <class T>
+class Mailbox : boost::noncopyable
+{
+public:
+    typedef unsigned long Version;
+
+    Mailbox() :
+        m_sequence(0),
+        m_value()
+    {
+    }
+
+    explicit Mailbox(const T& value) :
+        m_sequence(0),
+        m_value(value)
+    {
+    }
+
+    /** Replaces the value, must only be called from the writing thread */
+    void write(const T& value)
+    {
+        m_sequence = m_sequence + 1;
+        memoryBarrier();
+        m_value = value;
+        memoryBarrier();
+        m_sequence = m_sequence + 1;
+    }
+
+    /** Copies out the latest value
+     *
+     *  @return
+     *      The version of the value copied, for readIfChanged()
+     */
+    Version read(T& value) const
+    {
+        while (true)
+        {
+            Version before = m_sequence;
+            if (before & 1)
+            {
+                // The writer is part way through, let it finish
+                boost::this_thread::yield();
+                continue;
+            }
+
+            memoryBarrier();
+            value = m_value;
+            memoryBarrier();
+
+            if (before == m_sequence)
+                return before;
+        }
+    }
+
+    /** Copies out the latest value only if it is newer than version
+     *
+     *  @param version
+     *      The version last read, updated when a new value is copied.  Start
+     *      from 0 to always get the first value written.
+     *
+     *  @return
+     *      True if value was updated
+     */
+    bool readIfChanged(T& value, Version& version) const
+    {
+        if (getVersion() == version)
+            return false;
+
+        version = read(value);
+        return true;
+    }
+
+    /** The number of writes made, times two */
+    Version getVersion() const
+    {
+        Version version = m_sequence;
+        return version & ~((Version)1);
+    }
+
+private:
+    static void memoryBarrier()
+    {
+#ifdef RAM_WINDOWS
+        MemoryBarrier();
+#else
+        __sync_synchronize();
+#endif
+    }
+
+    /** Odd while a write is under way */
+    volatile Version m_sequence;
+
+    T m_value;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_MAILBOX_H_08_02_2011
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/PeriodicScheduler.h
+ */
+
+#ifndef RAM_CORE_PERIODICSCHEDULER_H_06_14_2011
+#define RAM_CORE_PERIODICSCHEDULER_H_06_14_2011
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+// Forward declare boost::thread
+namespace boost { class thread; }
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+class Updatable;
+
+/** Runs periodic Updatables on a fixed set of worker threads
+ *
+ *  Each task is released on absolute deadlines on Clock::monotonicTime(), so
+ *  the period does not drift with the time taken by the update.  A task
+ *  which overruns its period is run again immediately, skipping any whole
+ *  periods it missed so it keeps its original phase.
+ *
+ *  Each worker can be pinned to a CPU core.  A worker runs its tasks in
+ *  earliest release order, shortest period first on ties.  With real time
+ *  enabled the workers run SCHED_FIFO, with rate monotonic priorities: the
+ *  worker whose shortest period is smallest gets the highest priority.
+ *
+ *  Tasks without a core preference go to the least loaded worker, by total
+ *  update rate.  The scheduler owns the thread priorities, so
+ *  Updatable::setPriority() has no effect on a scheduled task.
+ *
+ *  Updatables are scheduled here when they are backgrounded with a positive
+ *  interval while a default scheduler is set, see setDefault().
+ */
+class RAM_EXPORT PeriodicScheduler : boost::noncopyable
+{
+public:
+    /** Creates a scheduler from config
+     *
+     *  @param config
+     *      "workers" is a list of the cores to pin each worker to, -1 for
+     *      unpinned, the default is an unpinned worker per CPU.  "realtime",
+     *      when 1 the workers run with rate monotonic SCHED_FIFO priorities.
+     */
+    PeriodicScheduler(ConfigNode config);
+
+    /** Creates a scheduler with a worker for each entry of workerCores */
+    PeriodicScheduler(std::vector<int> workerCores, bool realTime = false);
+
+    /** Stops all workers, every task should be removed before this */
+    ~PeriodicScheduler();
+
+    /** Adds the task, or changes its interval if its already present
+     *
+     *  @param interval
+     *      Time between updates in milliseconds, must be positive
+     *  @param core
+     *      Prefer a worker pinned to this core, -1 for no preference
+     */
+    void add(Updatable* updatable, int interval, int core = -1);
+
+    /** Removes the task
+     *
+     *  @param wait
+     *      If true and the task is currently updating, waits for that update
+     *      to finish.  Do not use from inside the task's own update.
+     */
+    void remove(Updatable* updatable, bool wait = false);
+
+    /** True if the task is scheduled here */
+    bool contains(Updatable* updatable);
+
+    /** Returns the worker running the task, -1 if its not present */
+    int getWorker(Updatable* updatable);
+
+    size_t getWorkerCount();
+
+    /** Returns the SCHED_FIFO priority the worker runs at, 0 if real time
+     *  is off or the worker has no tasks */
+    int getWorkerPriority(size_t worker);
+
+    /** Scheduler used by Updatable::background, NULL (the default) runs each
+     *  Updatable in its own thread */
+    static void setDefault(PeriodicScheduler* scheduler);
+
+    static PeriodicScheduler* getDefault();
+
+private:
+    struct Task
+    {
+        Updatable* updatable;
+        size_t worker;
+        boost::int64_t period;
+        boost::int64_t release;
+        boost::int64_t lastStart;
+        bool first;
+        bool running;
+        bool removed;
+    };
+
+    struct Worker
+    {
+        int core;
+        int priority;
+        bool priorityChanged;
+        boost::thread* thread;
+        /** Signaled to make the worker recheck its tasks */
+        boost::condition* wakeup;
+        /** Counts the signals, so one sent while awake is not lost */
+        unsigned int wakeups;
+    };
+
+    typedef std::vector<Task*> TaskList;
+
+    /** Starts the worker threads */
+    void start(std::vector<int> workerCores);
+
+    /** The loop run by each worker thread */
+    void run(size_t worker);
+
+    /** Finds the task, or returns NULL, must hold m_mutex */
+    Task* findTask(Updatable* updatable);
+
+    /** Deletes the task, must hold m_mutex */
+    void eraseTask(Task* task);
+
+    /** Makes the worker recheck its tasks, must hold m_mutex */
+    void wakeWorker(size_t worker);
+
+    /** Picks the least loaded worker, preferring ones pinned to core */
+    size_t pickWorker(int core);
+
+    /** Recomputes the rate monotonic worker priorities, must hold m_mutex */
+    void updatePriorities();
+
+    /** Guards all of the below */
+    boost::mutex m_mutex;
+
+    /** Signaled whenever a task finishes an update */
+    boost::condition m_taskDone;
+
+    bool m_running;
+
+    bool m_realTime;
+
+    std::vector<Worker> m_workers;
+
+    TaskList m_tasks;
+
+    static PeriodicScheduler* s_default;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_PERIODICSCHEDULER_H_06_14_2011
@@ -85,6 +85,8 @@ public:
     virtual void set(std::string key, std::string str);
 
     virtual void set(std::string key, int value);
+
+    virtual void set(std::string key, double value);
     
     /** Open a file using the python Yaml parser */
     static ConfigNodeImpPtr fromYamlFile(std::string filename);
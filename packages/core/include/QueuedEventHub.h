@@ -31,15 +31,35 @@ namespace core {
  *  This class can be used to isolate the user from having its EventHandlers
  *  being called from other threads. It currently queues all events it recieves
  *  not just the ones that are currently subscribed for.
+ *
+ *  Each event type is queued in one of three lanes.  Queued events are
+ *  published critical lane first, then the normal lane, then the latest
+ *  lane, each in the order the events arrived.  Only the newest event of
+ *  each type is kept in the latest lane, so a consumer which falls behind
+ *  skips straight to the current value instead of working through stale
+ *  ones.
  */
 class RAM_EXPORT QueuedEventHub : public EventHub
 {
 public:
+    enum Lane {
+        /** Published ahead of everything else, like safety events */
+        CRITICAL_LANE,
+        /** Every event in arrival order, where types start out */
+        NORMAL_LANE,
+        /** Only the newest queued event of the type, like sensor updates */
+        LATEST_LANE
+    };
+    
     /** Normal contructor */
     QueuedEventHub(ram::core::EventHubPtr eventHub,
                    std::string name = "QueuedEventHub");
 
-    /** Standard subsystem constructor */
+    /** Standard subsystem constructor
+     *
+     *  The "CriticalEvents" and "LatestEvents" lists of the config name the
+     *  event types queued in those lanes, see setNameLane().
+     */
     QueuedEventHub(ConfigNode config, SubsystemList deps = SubsystemList());
 
     virtual ~QueuedEventHub();
@@ -51,7 +71,36 @@ public:
     virtual void publish(EventPtr event);
 
     /** Publishs the event into the internal event queue (with sender=this) */
-    virtual void publish(Event::EventType type, EventPtr event);
+    virtual void publish(const Event::EventType& type, EventPtr event);
+
+    using EventHub::subscribeToType;
+
+    /** Subscribes to the type, and queues it in the given lane
+     *
+     *  When subscribers ask for different lanes, the type goes in the most
+     *  urgent one: critical over normal over latest.  The lane stays after
+     *  the connection is disconnected.
+     */
+    EventConnectionPtr subscribeToType(Event::EventType type,
+                                       boost::function<void (EventPtr)> handler,
+                                       Lane lane);
+
+    /** Sets which lane events of the type are queued in, from now on */
+    void setTypeLane(Event::EventType type, Lane lane);
+
+    /** Sets the lane of the type with the given name
+     *
+     *  The name is the type without the line number it starts with, like
+     *  "ram::control::IController::AT_DEPTH", so a config file can name
+     *  types from packages this one does not link against.  A lane set by
+     *  type, or asked for by a subscriber, takes precedence.
+     */
+    void setNameLane(std::string name, Lane lane);
+
+    Lane getTypeLane(Event::EventType type);
+
+    /** Number of events dropped from the latest lane for a newer one */
+    unsigned int getCoalescedCount();
     
     /** @copydoc QueuedEventPublisher::publishEvents() */
     int publishEvents();
@@ -10,13 +10,22 @@
 #ifndef RAM_CORE_QUEUEDEVENTHUBIMP_12_26_2007
 #define RAM_CORE_QUEUEDEVENTHUBIMP_12_26_2007
 
+// STD Includes
+#include <map>
+#include <set>
+#include <deque>
+#include <string>
+
 // Library Includes
 #include <boost/function.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
 
 // Project Includes
-#include "core/include/ThreadedQueue.h"
 #include "core/include/Forward.h"
 #include "core/include/Event.h"
+#include "core/include/QueuedEventHub.h"
 
 namespace ram {
 namespace core {
@@ -30,9 +39,22 @@ public:
     /** Set the function used twhich publishes use the given function */
     void setPublishFunction(boost::function<void (EventPtr)> publishFunction);
     
-    /** Store event on the internal queue */
+    /** Store event on the internal queue, in the lane of its type */
     void queueEvent(EventPtr event);
 
+    /** @copydoc QueuedEventHub::setTypeLane() */
+    void setTypeLane(Event::EventType type, QueuedEventHub::Lane lane);
+
+    /** Moves the type to the lane, if it is more urgent than its current */
+    void requestTypeLane(Event::EventType type, QueuedEventHub::Lane lane);
+
+    /** @copydoc QueuedEventHub::setNameLane() */
+    void setNameLane(std::string name, QueuedEventHub::Lane lane);
+
+    QueuedEventHub::Lane getTypeLane(Event::EventType type);
+
+    unsigned int getCoalescedCount();
+
     /** @copydoc QueuedEventPublisher::publishEvents() */
     int publishEvents();
 
@@ -40,11 +62,62 @@ public:
     int waitAndPublishEvents();
     
 private:
+    /** An event, and when it was queued if it is being traced */
+    struct QueuedEvent
+    {
+        QueuedEvent(EventPtr event_ = EventPtr(), boost::int64_t queued_ = 0) :
+            event(event_), queued(queued_) {}
+        
+        EventPtr event;
+        boost::int64_t queued;
+    };
+
+    typedef std::map<Event::EventType, QueuedEventHub::Lane> LaneMap;
+    typedef std::map<Event::EventType, QueuedEvent> LatestMap;
+    typedef std::map<std::string, QueuedEventHub::Lane> NameLaneMap;
+
+    /** Finds the lane of the type, looking it up by name the first time
+     *  the type is seen, m_mutex must be held */
+    LaneMap::iterator findLane(const Event::EventType& type);
+
+    /** Takes the next event by lane, false if there are none
+     *
+     *  @param wait
+     *      If true, waits for an event instead of returning false
+     */
+    bool pop(QueuedEvent& queued, bool wait);
+
+    /** Publishes the event, giving the EventTracer its wait in the queue
+        and the time it took */
+    void publish(const QueuedEvent& queued);
+    
     /** Function which events are published to */
     boost::function<void (EventPtr)> m_publishFunction;
     
-    /** Thread safe queue for events */
-    ThreadedQueue<EventPtr> m_eventQueue;
+    /** Guards all the lanes, and the lane of each type */
+    boost::mutex m_mutex;
+
+    /** Signaled when an event is queued */
+    boost::condition m_eventQueued;
+
+    /** Types not in here go in the normal lane */
+    LaneMap m_lanes;
+
+    /** Lanes by type name, copied into m_lanes as the types show up */
+    NameLaneMap m_nameLanes;
+
+    /** Types already found to have no lane by name */
+    std::set<Event::EventType> m_unnamed;
+    
+    std::deque<QueuedEvent> m_critical;
+    std::deque<QueuedEvent> m_normal;
+
+    /** Types with an event in the latest lane, in the order they first
+        arrived, and the newest event of each */
+    std::deque<Event::EventType> m_latestOrder;
+    LatestMap m_latest;
+
+    unsigned int m_coalesced;
 };
 
 } // namespace core
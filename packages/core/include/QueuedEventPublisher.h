@@ -52,7 +52,7 @@ public:
                                          boost::function<void (EventPtr)>  handler);
     
     /**Publish the event to the internal queue */
-    virtual void publish(Event::EventType type, EventPtr event);
+    virtual void publish(const Event::EventType& type, EventPtr event);
 
     /** Publishes all queued events and any that arrive while publishing those events
      *
@@ -43,7 +43,8 @@ public:
     virtual EventConnectionPtr subscribe(T type,
         boost::function<void (EventPtr)>  handler);
     
-    virtual void publish(T subscribeType, Event::EventType etype,
+    virtual void publish(const T& subscribeType,
+                         const Event::EventType& etype,
                          EventPublisher* sender,
                          EventPtr event);
 
@@ -182,8 +183,9 @@ EventConnectionPtr QueuedEventPublisherBaseTemplate<T>::subscribe(
 }
 
 template<typename T>
-void QueuedEventPublisherBaseTemplate<T>::publish(T subscribeType,
-                                                  Event::EventType etype,
+void QueuedEventPublisherBaseTemplate<T>::publish(
+    const T& subscribeType,
+    const Event::EventType& etype,
                                                   EventPublisher* sender,
                                                   EventPtr event)
 {
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/SnapshotConfigNodeImp.h
+ */
+
+#ifndef RAM_CORE_SNAPSHOTCONFIGNODEIMP_06_28_2011
+#define RAM_CORE_SNAPSHOTCONFIGNODEIMP_06_28_2011
+
+// STD Includes
+#include <string>
+#include <map>
+#include <utility>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/ConfigNodeImp.h"
+#include "core/include/YamlConfigNodeImp.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Implements the ConfigNodeImp on a compiled config file mapped into memory
+ *
+ *  A snapshot is a config tree flattened into fixed size records, written
+ *  by compile().  Every map carries its own hash table of its keys, and
+ *  every scalar has its int and double value worked out ahead of time, so
+ *  nothing is parsed when the file is loaded or read.
+ *
+ *  The file is never written to.  Values given to set() are kept in memory
+ *  in front of the file.
+ */
+class RAM_EXPORT SnapshotConfigNodeImp : public ConfigNodeImp
+{
+public:
+    /** Opens a snapshot written by compile() */
+    static ConfigNodeImpPtr fromSnapshotFile(std::string filename);
+
+    /** Writes the tree out as a snapshot */
+    static void compile(YamlConfigNodeImp::NodePtr root,
+                        std::string fileName);
+
+    /** Loads the YAML file, and its includes, and writes it as a snapshot */
+    static void compile(std::string yamlFileName, std::string fileName);
+
+    virtual ~SnapshotConfigNodeImp() {};
+
+    virtual ConfigNodeImpPtr idx(int index);
+
+    virtual ConfigNodeImpPtr map(std::string key);
+
+    virtual std::string asString();
+
+    virtual std::string asString(const std::string& def);
+
+    virtual double asDouble();
+
+    virtual double asDouble(const double def);
+
+    virtual int asInt();
+
+    virtual int asInt(const int def);
+
+    virtual NodeNameList subNodes();
+
+    virtual size_t size();
+
+    virtual void set(std::string key, std::string str);
+
+    virtual void set(std::string key, int value);
+
+    virtual void set(std::string key, double value);
+
+    virtual std::string toString();
+
+    virtual void writeToFile(std::string fileName, bool silent);
+
+    /** Value of the file's first eight bytes */
+    static const char MAGIC[8];
+
+    static const boost::uint32_t VERSION;
+
+    /** Marks a node index that refers to nothing */
+    static const boost::uint32_t NO_NODE;
+
+private:
+    class Snapshot;
+    typedef boost::shared_ptr<Snapshot> SnapshotPtr;
+
+    SnapshotConfigNodeImp(SnapshotPtr snapshot, boost::uint32_t node,
+                          std::string debugPath);
+
+    /** Throws a ConfigException with our path in the message */
+    void error(std::string message);
+
+    /** Copies the node, and any values set on it, out of the snapshot */
+    YamlConfigNodeImp::NodePtr toYamlNode(boost::uint32_t node);
+
+    SnapshotPtr m_snapshot;
+
+    boost::uint32_t m_node;
+
+    std::string m_debugPath;
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_SNAPSHOTCONFIGNODEIMP_06_28_2011
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/TimingStats.h
+ */
+
+#ifndef RAM_CORE_TIMINGSTATS_H_06_14_2011
+#define RAM_CORE_TIMINGSTATS_H_06_14_2011
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Collects release jitter and deadline miss statistics for a periodic task
+ *
+ *  Both histograms use power of two buckets in microseconds: bucket 0 holds
+ *  values under 1us, bucket i holds [2^(i-1), 2^i) and the last bucket holds
+ *  everything larger.  All times are in microseconds.
+ */
+class RAM_EXPORT TimingStats
+{
+public:
+    static const int BUCKETS = 18;
+
+    TimingStats();
+
+    /** Clears all counts */
+    void reset();
+
+    /** Records a single update of the task
+     *
+     *  @param jitter
+     *      How long after its release time the update started
+     *  @param runTime
+     *      How long the update took
+     *  @param overrun
+     *      How long after its deadline (the next release) the update
+     *      finished, zero or negative if the deadline was met
+     */
+    void record(boost::int64_t jitter, boost::int64_t runTime,
+                boost::int64_t overrun);
+
+    /** Adds the counts from other into this */
+    void merge(const TimingStats& other);
+
+    unsigned int getUpdates() const { return m_updates; }
+
+    unsigned int getDeadlineMisses() const { return m_deadlineMisses; }
+
+    boost::int64_t getMaxJitter() const { return m_maxJitter; }
+
+    double getMeanJitter() const;
+
+    boost::int64_t getMaxRunTime() const { return m_maxRunTime; }
+
+    double getMeanRunTime() const;
+
+    /** Number of updates whose jitter fell in the given bucket */
+    unsigned int getJitterCount(int bucket) const;
+
+    /** Number of deadline misses whose overrun fell in the given bucket */
+    unsigned int getMissCount(int bucket) const;
+
+    /** The smallest bucket limit which at least fraction of the updates
+     *  started under, -1 if there have been no updates */
+    boost::int64_t getJitterPercentile(double fraction) const;
+
+    /** Exclusive upper bound of the bucket, -1 for the last bucket */
+    static boost::int64_t getBucketLimit(int bucket);
+
+    /** Bucket the given time falls in */
+    static int getBucket(boost::int64_t usec);
+
+private:
+    unsigned int m_updates;
+    unsigned int m_deadlineMisses;
+    boost::int64_t m_totalJitter;
+    boost::int64_t m_maxJitter;
+    boost::int64_t m_totalRunTime;
+    boost::int64_t m_maxRunTime;
+    unsigned int m_jitter[BUCKETS];
+    unsigned int m_misses[BUCKETS];
+};
+
+} // namespace core
+} // namespace ram
+
+#endif // RAM_CORE_TIMINGSTATS_H_06_14_2011
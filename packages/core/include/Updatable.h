@@ -21,6 +21,7 @@ namespace boost { class thread; }
 #include "core/include/IUpdatable.h"
 #include "core/include/CountDownLatch.h"
 #include "core/include/EventPublisher.h"
+#include "core/include/TimingStats.h"
 
 // Must Be Included last
 #include "core/include/Export.h"
@@ -28,10 +29,14 @@ namespace boost { class thread; }
 namespace ram {
 namespace core {
 
+class PeriodicScheduler;
+
 /** Represents and object which can be updated, asyncronously or sequentially.
  *
  *  All you have to do to use it is subclass and implement the update() method,
- *  will be called the given interval in a background thread.
+ *  will be called the given interval in a background thread.  If a default
+ *  PeriodicScheduler is set, objects backgrounded with a positive interval
+ *  are run by its workers instead of their own thread.
  */
 class RAM_EXPORT Updatable : public IUpdatable, boost::noncopyable
 {
@@ -39,6 +44,7 @@ public:
     Updatable(EventPublisher *publisher = NULL);
     virtual ~Updatable();
 
+    /** Ignored, with a warning, while run by a PeriodicScheduler */
     virtual void setPriority(Priority priority);
 
     virtual Priority getPriority();
@@ -55,6 +61,9 @@ public:
 
     virtual bool backgrounded();
 
+    /** Returns the timing of all updates since the object was backgrounded */
+    TimingStats getTimingStats();
+
 protected:
     /** Gets copies of the internal state */
     void getState(bool& backgrounded, int& interval);
@@ -72,9 +81,19 @@ private:
         AFFINITY = 2
     };
     
+    friend class PeriodicScheduler;
+
     /** Joins and delete's the background thread */
     void cleanUpBackgroundThread();
 
+    /** Records the timing of one update, see TimingStats::record
+     *
+     *  Once a second publishes a ProfileEvent with the timing since the last
+     *  one.
+     */
+    void recordUpdate(boost::int64_t jitter, boost::int64_t runTime,
+                      boost::int64_t overrun);
+
     /** Determines constants relating to thead, based on OS and machine
      *
      *  Determines the proper thread priorities, and CPU count.
@@ -114,9 +133,23 @@ private:
     
     CountDownLatch m_threadStopped;
 
+    /** The scheduler running our updates, NULL if we have our own thread */
+    PeriodicScheduler* m_scheduler;
+
     /** The publisher to use for profiling updates */
     EventPublisher *m_publisher;
-    unsigned int m_profileCount;
+
+    /** Guards the timing statistics */
+    boost::mutex m_statsMutex;
+
+    /** Timing since background() was called */
+    TimingStats m_stats;
+
+    /** Timing since the last profile event */
+    TimingStats m_profileStats;
+
+    /** When the last profile event was published, monotonic usec */
+    boost::int64_t m_lastProfile;
 };
 
 } // namespace core
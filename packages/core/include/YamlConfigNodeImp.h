@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/include/YamlConfigNodeImp.h
+ */
+
+#ifndef RAM_CORE_YAMLCONFIGNODEIMP_06_28_2011
+#define RAM_CORE_YAMLCONFIGNODEIMP_06_28_2011
+
+// STD Includes
+#include <string>
+#include <vector>
+#include <map>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/ConfigNodeImp.h"
+
+// Must Be Included last
+#include "core/include/Export.h"
+
+namespace ram {
+namespace core {
+
+/** Implements the ConfigNodeImp with a YAML parser written in C++
+ *
+ *  This reads the subset of YAML our config files use: block and flow maps
+ *  and sequences, plain and quoted scalars and comments.  Scalars are typed
+ *  like the Python yaml module does (yes/no are booleans, an int needs no
+ *  decimal point, a float needs one), so values convert the same way they
+ *  did through PythonConfigNodeImp.  INCLUDE keys are merged in as the file
+ *  is loaded.
+ *
+ *  No Python is needed, and lookups are plain map finds.
+ */
+class RAM_EXPORT YamlConfigNodeImp : public ConfigNodeImp
+{
+public:
+    struct Node;
+    typedef boost::shared_ptr<Node> NodePtr;
+
+    /** What a scalar resolves to */
+    enum ScalarType {
+        NONE,
+        BOOL,
+        INT,
+        FLOAT,
+        STRING
+    };
+    
+    /** One node of the parsed tree */
+    struct Node
+    {
+        enum Type {
+            NIL,
+            SCALAR,
+            SEQUENCE,
+            MAP
+        };
+        
+        Node(Type type_ = NIL) : type(type_), quoted(false) {}
+
+        /** Adds the value to a map, replacing any with the same key */
+        void insert(std::string key, NodePtr value);
+
+        /** Returns the value of the key, or NULL if this has no such key */
+        NodePtr find(std::string key);
+
+        void erase(std::string key);
+
+        Type type;
+
+        /** The text of a scalar */
+        std::string text;
+
+        /** Quoted scalars are always strings */
+        bool quoted;
+
+        /** Items of a sequence, or values of a map */
+        std::vector<NodePtr> items;
+
+        /** Keys of a map in file order, parallel to items */
+        std::vector<std::string> keys;
+
+        /** Index into items of each key */
+        std::map<std::string, size_t> index;
+    };
+    
+    YamlConfigNodeImp(NodePtr node, std::string debugPath = "ROOT");
+
+    virtual ~YamlConfigNodeImp() {};
+    
+    /** Loads the file, and everything it INCLUDEs */
+    static ConfigNodeImpPtr fromYamlFile(std::string filename);
+
+    /** Parses the file, and everything it INCLUDEs, into a tree */
+    static NodePtr parseFile(std::string filename);
+
+    /** Parses YAML text into a tree, no includes are done
+     *
+     *  @param source
+     *      Name used in error messages
+     */
+    static NodePtr parse(std::string text, std::string source = "<string>");
+
+    /** A deep copy of the tree, which shares nothing with the original */
+    static NodePtr copy(NodePtr node);
+
+    /** The node this refers to, NULL when made for a key which is missing */
+    NodePtr getNode();
+    
+    virtual ConfigNodeImpPtr idx(int index);
+
+    virtual ConfigNodeImpPtr map(std::string key);
+
+    virtual std::string asString();
+
+    virtual std::string asString(const std::string& def);
+    
+    virtual double asDouble();
+
+    virtual double asDouble(const double def);
+
+    virtual int asInt();
+
+    virtual int asInt(const int def);
+
+    /** Empty for anything but a map */
+    virtual NodeNameList subNodes();
+
+    virtual size_t size();
+    
+    virtual void set(std::string key, std::string str);
+
+    virtual void set(std::string key, int value);
+
+    virtual void set(std::string key, double value);
+
+    /** The tree as a Python literal, like PythonConfigNodeImp returns */
+    virtual std::string toString();
+
+    virtual void writeToFile(std::string fileName, bool silent);
+
+    /** Resolves a scalar like the Python yaml module, the int and double
+     *  value are filled in when it is a number or boolean */
+    static ScalarType resolve(const std::string& text, bool quoted,
+                              int& intValue, double& doubleValue);
+    
+    /** The tree as a Python literal */
+    static std::string toString(NodePtr node);
+
+    /** Writes the tree out as YAML */
+    static void writeToFile(NodePtr node, std::string fileName, bool silent);
+    
+private:
+    /** Throws a ConfigException with our path in the message */
+    void error(std::string message);
+
+    NodePtr m_node;
+
+    std::string m_debugPath;
+};
+
+} // namespace core
+} // namespace ram
+    
+#endif // RAM_CORE_YAMLCONFIGNODEIMP_06_28_2011
@@ -15,14 +15,24 @@
 // STD Includes
 #include <cassert>
 #include <utility>
+#include <algorithm>
 #include <set>
 #include <map>
+#include <deque>
 #include <sstream>
+#include <fstream>
 #include <exception>
+#include <stdexcept>
 
 // Library Includes
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 // Project Includes
 #include "core/include/Application.h"
@@ -31,6 +41,11 @@
 #include "core/include/Logging.h"
 #include "core/include/SubsystemMaker.h"
 #include "core/include/DependencyGraph.h"
+#include "core/include/PeriodicScheduler.h"
+#include "core/include/Clock.h"
+#include "core/include/GILock.h"
+#include "core/include/EventTracer.h"
+#include "core/include/LatencyTracker.h"
 #include "core/include/Feature.h"
 
 #ifdef RAM_WITH_WRAPPERS
@@ -41,20 +56,101 @@
 #define PYTHON_ERROR_CATCH(message)                     \
     catch(boost::python::error_already_set err) {       \
         std::cerr << "ERROR: " << message << std::endl; \
-        PyErr_Print();                                  \
+        ram::core::ScopedGILock gil;                    \
+        printPythonError();                             \
         throw err;                                      \
     }
 
+/** PyErr_Print, but leaves the error set for whoever catches the rethrow */
+static void printPythonError()
+{
+    PyObject* type = 0;
+    PyObject* value = 0;
+    PyObject* traceback = 0;
+    PyErr_Fetch(&type, &value, &traceback);
+    Py_XINCREF(type);
+    Py_XINCREF(value);
+    Py_XINCREF(traceback);
+    PyErr_Restore(type, value, traceback);
+    PyErr_Print();
+    PyErr_Restore(type, value, traceback);
+}
+
+/** "Type: message" of the current Python error, which stays set */
+static std::string pythonErrorMessage()
+{
+    PyObject* type = 0;
+    PyObject* value = 0;
+    PyObject* traceback = 0;
+    PyErr_Fetch(&type, &value, &traceback);
+    if (!type)
+        return "unknown Python error";
+    PyErr_NormalizeException(&type, &value, &traceback);
+
+    namespace py = boost::python;
+    std::string message;
+    try {
+        py::object typeObj(py::handle<>(py::borrowed(type)));
+        message = py::extract<std::string>(typeObj.attr("__name__"));
+        if (value)
+        {
+            py::object valueObj(py::handle<>(py::borrowed(value)));
+            message += ": ";
+            message += py::extract<std::string>(py::str(valueObj));
+        }
+    } catch (py::error_already_set&) {
+        // Formatting failed, the original error is the one to report
+        PyErr_Clear();
+    }
+
+    PyErr_Restore(type, value, traceback);
+    return message;
+}
+
 #else
 #define PYTHON_ERROR_TRY
 #define PYTHON_ERROR_CATCH(message)
 #endif
 
+/** Gives a thread a Python thread state for as long as this lives, without
+ *  holding the interpreter lock.  Otherwise each ScopedGILock would make and
+ *  free its own, losing any Python error set while it was held. */
+class ScopedPythonThread : boost::noncopyable
+{
+public:
+    ScopedPythonThread(bool python) : m_python(python), m_threadState(0)
+    {
+        if (m_python)
+        {
+            m_gilState = PyGILState_Ensure();
+            m_threadState = PyEval_SaveThread();
+        }
+    }
+
+    ~ScopedPythonThread()
+    {
+        if (m_python)
+        {
+            PyEval_RestoreThread(m_threadState);
+            PyGILState_Release(m_gilState);
+        }
+    }
+
+private:
+    bool m_python;
+    PyGILState_STATE m_gilState;
+    PyThreadState* m_threadState;
+};
+
 namespace ram {
 namespace core {
     
 Application::Application(std::string configPath) :
-    m_running(false)
+    m_running(false),
+    m_loopThreads(1),
+    m_virtualStep(0),
+    m_virtualDuration(-1),
+    m_startupBegin(0)
 {
     boost::filesystem::path path(configPath);
     ConfigNode rootCfg = core::ConfigNode::fromFile(path.string());
@@ -66,6 +162,38 @@ Application::Application(std::string configPath) :
         mode = "warning";
     }
 
+    // Trace from the start, so startup events are in the trace as well
+    if (rootCfg["TraceEvents"].asInt(0))
+        EventTracer::setEnabled(true);
+    if (rootCfg["TraceLatency"].asInt(0))
+        LatencyTracker::setEnabled(true);
+    
+    // Switch to virtual time before anything is created, so even the
+    // timestamps of startup events are repeatable
+    if (rootCfg.exists("VirtualTime"))
+    {
+        ConfigNode timeCfg(rootCfg["VirtualTime"]);
+        Clock::setVirtual((boost::int64_t)(
+                              timeCfg["startTime"].asDouble(0) * 1000000));
+        m_virtualStep = (boost::int64_t)(timeCfg["step"].asDouble(0.01) *
+                                         1000000);
+        m_virtualDuration = (boost::int64_t)(
+            timeCfg["duration"].asDouble(-1) * 1000000);
+        assert(m_virtualStep > 0 && "Virtual time step must be positive");
+    }
+    
+    // Periodic subsystems run on a shared set of workers instead of a
+    // thread each
+    if (rootCfg.exists("Scheduler") && !Clock::isVirtual())
+    {
+        m_scheduler.reset(new PeriodicScheduler(rootCfg["Scheduler"]));
+        PeriodicScheduler::setDefault(m_scheduler.get());
+    }
+
+    // Ignored in virtual time, which must update in a repeatable order
+    m_loopThreads = std::max(1, rootCfg["MainLoopThreads"].asInt(1));
+    m_loopStats.threads = m_loopThreads;
+    
     if (rootCfg.exists("Subsystems"))
     {
         ConfigNode sysConfig(rootCfg["Subsystems"]);
@@ -74,62 +202,20 @@ Application::Application(std::string configPath) :
         DependencyGraph depGraph(sysConfig);
         m_order = depGraph.getOrder();
 
+        // Independent subsystems are created at the same time when given
+        // more than one thread
+        int threads = rootCfg["SubsystemCreationThreads"].asInt(1);
+        createSubsystems(sysConfig, depGraph, threads);
+
         std::vector<std::string> badSubsystemNames;
         std::set<std::string> invalidSystems;
-        
-        // Create all the subsystems
         BOOST_FOREACH(std::string subsystemName, m_order)
         {
-            // Skip "creationMode"
-            if (subsystemName == "creationMode") {
-                continue;
-            }
-
-            // If the subsystem has no configuration section, ignore it
-            if (!sysConfig.exists(subsystemName)) {
-                badSubsystemNames.push_back(subsystemName);
-                continue;
-            }
-
-            // Set 'name' properly in the config
-            ConfigNode config(sysConfig[subsystemName]);
-            config.set("name", subsystemName);
-        
-            // Build list of dependencies
-            SubsystemList deps;
-            NameList depNames = depGraph.getDependencies(subsystemName);
-            bool abort = false;
-            BOOST_FOREACH(std::string depName, depNames)
-            {
-                if (!hasSubsystem(depName) ||
-                    invalidSystems.count(depName) == 1) {
-                    // The dependencies have not been satisfied
-                    abort = true;
-                    break;
-                }
-                deps.push_back(getSubsystem(depName));
-            }
-
-            if (abort) {
-                // The dependencies were not satisfied
-                // do not make this subsystem
-                // Remove from the order
+            CreationResult result = m_creationResults[subsystemName];
+            if (MISSING == result)
                 badSubsystemNames.push_back(subsystemName);
-                continue;
-            }
-
-            // Create out new subsystem and store it
-            PYTHON_ERROR_TRY {
-                try {
-                    SubsystemPtr subsystem(SubsystemMaker::newObject(
-                                               std::make_pair(config, deps) ));
-                    m_subsystems[subsystemName] = subsystem;
-                } catch (core::MakerNotFoundException& ex) {
-                    std::cout << ex.what() << " - "
-                              << subsystemName << std::endl;
-                    invalidSystems.insert(subsystemName);
-                }
-            } PYTHON_ERROR_CATCH("Subsystem construction");
+            else if (INVALID == result)
+                invalidSystems.insert(subsystemName);
         }
         
         // Add invalid systems to the bad subsystems
@@ -161,14 +247,9 @@ Application::Application(std::string configPath) :
         // maybe another function, maybe a scheduler?
         BOOST_FOREACH(std::string name, m_order)
         {
+            double start = wallTime();
             PYTHON_ERROR_TRY {
                 ConfigNode cfg(sysConfig[name]);
-                if (cfg.exists("update_interval"))
-                {
-                    int updateInterval = cfg["update_interval"].asInt();
-                    m_subsystems[name]->background(updateInterval);
-                }
-                
                 if (cfg.exists("priority"))
                 {
                     std::string priority(cfg["priority"].asString());
@@ -176,12 +257,36 @@ Application::Application(std::string configPath) :
                         IUpdatable::stringToPriority(priority));
                 }
                 
+                // Set before backgrounding so the scheduler can place it on
+                // a worker pinned to that core
                 if (cfg.exists("affinity"))
                 {
                     m_subsystems[name]->setAffinity(cfg["affinity"].asInt());
                 }
+
+                if (cfg.exists("update_interval"))
+                {
+                    int updateInterval = cfg["update_interval"].asInt();
+
+                    // In virtual time the main loop steps everything
+                    if (Clock::isVirtual())
+                        m_updateIntervals[name] = updateInterval;
+                    else
+                        m_subsystems[name]->background(updateInterval);
+                }
             } PYTHON_ERROR_CATCH("Subsystem setup");
+            m_startupTimes[name].background = wallTime() - start;
         } // foreach name in order
+
+        // Record how the subsystems depend on each other, and how long each
+        // one took to start
+        boost::filesystem::path logDir(Logging::getLogDir());
+        std::ofstream graphFile(
+            (logDir / "dependencies.dot").native_file_string().c_str());
+        depGraph.writeDependencyGraph(graphFile);
+        std::ofstream timelineFile(
+            (logDir / "startup.txt").native_file_string().c_str());
+        writeStartupTimeline(timelineFile, threads);
     } // if subsystem section of config exists
     
     // Write out the yaml config file in its current state
@@ -191,6 +296,11 @@ Application::Application(std::string configPath) :
 
 Application::~Application()
 {
+    // Leave virtual time first, so no background thread is left sleeping on
+    // a clock which will never move again
+    if (Clock::isVirtual())
+        Clock::setReal();
+    
     PYTHON_ERROR_TRY {
         // Go through subsystems in the reverse order of construction and
         // shut them down
@@ -203,6 +313,359 @@ Application::~Application()
             m_subsystems.erase(name);
         }
     } PYTHON_ERROR_CATCH("Subsystem cleanup");
+
+    if (PeriodicScheduler::getDefault() == m_scheduler.get())
+        PeriodicScheduler::setDefault(0);
+
+    if (EventTracer::isEnabled())
+    {
+        boost::filesystem::path logDir(Logging::getLogDir());
+        std::ofstream traceFile(
+            (logDir / "events.json").native_file_string().c_str());
+        EventTracer::writeChromeTrace(traceFile);
+    }
+
+    if (LatencyTracker::isEnabled())
+    {
+        boost::filesystem::path logDir(Logging::getLogDir());
+        std::ofstream reportFile(
+            (logDir / "latency.txt").native_file_string().c_str());
+        LatencyTracker::writeReport(reportFile);
+    }
+}
+
+/** Shared by the threads creating subsystems, guarded by mutex */
+struct Application::CreationState
+{
+    boost::mutex mutex;
+
+    /** Signaled when a subsystem is finished, or creation fails */
+    boost::condition changed;
+
+    ConfigNode sysConfig;
+
+    bool threaded;
+
+    /** Set when the interpreter is running, so Python errors are possible */
+    bool python;
+
+    /** Set when the config is a Python object, so reading it needs the
+        interpreter lock */
+    bool pythonConfig;
+
+    /** Indices into m_order of the subsystems whose dependencies are done */
+    std::set<size_t> ready;
+
+    /** How many dependencies each subsystem is still waiting on */
+    std::map<std::string, int> waiting;
+
+    /** Dependencies, and dependents, of each subsystem */
+    std::map<std::string, NameList> dependencies;
+    std::map<std::string, std::vector<size_t> > dependents;
+
+    size_t remaining;
+
+    /** Set when a constructor throws, no more subsystems are started */
+    bool failed;
+    std::string error;
+    PyObject* errorType;
+    PyObject* errorValue;
+    PyObject* errorTraceback;
+
+    CreationState(ConfigNode config) :
+        sysConfig(config),
+        threaded(false),
+        python(false),
+        pythonConfig(false),
+        remaining(0),
+        failed(false),
+        errorType(0),
+        errorValue(0),
+        errorTraceback(0)
+    {
+    }
+};
+
+double Application::wallTime()
+{
+    // Startup is timed on the real clock, even in virtual time
+    boost::posix_time::time_duration sinceEpoch =
+        boost::posix_time::microsec_clock::universal_time() -
+        boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1));
+    return sinceEpoch.total_microseconds() / 1000000.0;
+}
+
+void Application::createSubsystems(ConfigNode sysConfig,
+                                   DependencyGraph& depGraph,
+                                   int threads)
+{
+    CreationState state(sysConfig);
+    state.threaded = threads > 1;
+    state.python = (0 != Py_IsInitialized());
+    state.pythonConfig = state.python && sysConfig.isPython();
+    state.remaining = m_order.size();
+    m_startupBegin = wallTime();
+
+    // A subsystem is ready once all the subsystems it depends on are done
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        std::string name(m_order[i]);
+        NameList depNames = depGraph.getDependencies(name);
+        state.dependencies[name] = depNames;
+        m_dependencies[name] = depNames;
+        m_startupTimes[name].dependencies = depNames;
+        state.waiting[name] = (int)depNames.size();
+        BOOST_FOREACH(std::string depName, depNames)
+        {
+            state.dependents[depName].push_back(i);
+        }
+        if (depNames.empty())
+            state.ready.insert(i);
+    }
+
+    if (!state.threaded)
+    {
+        // Lowest index first, so this is exactly m_order
+        creationWorker(&state);
+        return;
+    }
+
+    // Python subsystem makers, and a Python config, need the interpreter
+    // lock, the workers can't get it while this thread holds it
+    PyThreadState* threadState = 0;
+    if (state.python)
+    {
+        PyEval_InitThreads();
+        threadState = PyEval_SaveThread();
+    }
+    
+    boost::thread_group workers;
+    for (int i = 0; i < threads; ++i)
+    {
+        workers.create_thread(
+            boost::bind(&Application::creationWorker, this, &state));
+    }
+    workers.join_all();
+
+    if (state.python)
+        PyEval_RestoreThread(threadState);
+
+    // Report the first failure from this thread, as a serial start would
+    if (state.failed)
+    {
+        if (state.errorType)
+        {
+            PyErr_Restore(state.errorType, state.errorValue,
+                          state.errorTraceback);
+            throw boost::python::error_already_set();
+        }
+        throw std::runtime_error("Subsystem construction: " + state.error);
+    }
+}
+
+void Application::creationWorker(CreationState* state)
+{
+    ScopedPythonThread pythonThread(state->threaded && state->python);
+    boost::mutex::scoped_lock lock(state->mutex);
+
+    while (true)
+    {
+        while (state->ready.empty() && (state->remaining > 0) &&
+               !state->failed)
+        {
+            state->changed.wait(lock);
+        }
+        if (state->ready.empty() || state->failed)
+            return;
+
+        size_t index = *state->ready.begin();
+        state->ready.erase(state->ready.begin());
+        std::string name(m_order[index]);
+
+        // Every dependency is done, so this only needs the ones that worked
+        SubsystemList deps;
+        bool abort = false;
+        BOOST_FOREACH(std::string depName, state->dependencies[name])
+        {
+            if (CREATED != m_creationResults[depName])
+            {
+                abort = true;
+                break;
+            }
+            deps.push_back(getSubsystem(depName));
+        }
+
+        lock.unlock();
+        double start = wallTime();
+        CreationResult result = MISSING;
+        SubsystemPtr subsystem;
+        
+        if (!abort)
+        {
+            // Python subsystem makers take the interpreter lock themselves,
+            // so C++ constructors run in parallel unless the config is Python
+            boost::scoped_ptr<ScopedGILock> gil;
+            if (state->threaded && state->pythonConfig)
+                gil.reset(new ScopedGILock());
+
+            try {
+                result = createSubsystem(name, state->sysConfig, deps,
+                                         subsystem);
+            }
+#ifdef RAM_WITH_WRAPPERS
+            catch (boost::python::error_already_set&) {
+                if (!state->threaded)
+                    throw;
+                // Formatted here, where the error is set
+                ScopedGILock errorGil;
+                creationFailed(state, pythonErrorMessage());
+                return;
+            }
+#endif
+            catch (std::exception& ex) {
+                if (!state->threaded)
+                    throw;
+                creationFailed(state, ex.what());
+                return;
+            } catch (...) {
+                if (!state->threaded)
+                    throw;
+                creationFailed(state, "unknown exception");
+                return;
+            }
+        }
+        
+        double end = wallTime();
+        lock.lock();
+
+        m_creationResults[name] = result;
+        if (CREATED == result)
+            m_subsystems[name] = subsystem;
+        m_startupTimes[name].start = start - m_startupBegin;
+        m_startupTimes[name].construct = end - start;
+
+        // Dependents waiting on only this subsystem can now start
+        BOOST_FOREACH(size_t dependent, state->dependents[name])
+        {
+            if (0 == --state->waiting[m_order[dependent]])
+                state->ready.insert(dependent);
+        }
+        state->remaining--;
+        state->changed.notify_all();
+    }
+}
+
+void Application::creationFailed(CreationState* state, std::string error)
+{
+    // Hold onto the Python error so the main thread can raise it
+    boost::scoped_ptr<ScopedGILock> gil;
+    if (state->python)
+        gil.reset(new ScopedGILock());
+    
+    PyObject* type = 0;
+    PyObject* value = 0;
+    PyObject* traceback = 0;
+    if (state->python && PyErr_Occurred())
+        PyErr_Fetch(&type, &value, &traceback);
+    
+    boost::mutex::scoped_lock lock(state->mutex);
+    if (!state->failed)
+    {
+        state->failed = true;
+        state->error = error;
+        state->errorType = type;
+        state->errorValue = value;
+        state->errorTraceback = traceback;
+    }
+    else
+    {
+        Py_XDECREF(type);
+        Py_XDECREF(value);
+        Py_XDECREF(traceback);
+    }
+    state->changed.notify_all();
+}
+
+Application::CreationResult Application::createSubsystem(
+    std::string subsystemName, ConfigNode sysConfig, SubsystemList deps,
+    SubsystemPtr& subsystem)
+{
+    // Skip "creationMode"
+    if (subsystemName == "creationMode")
+        return SKIPPED;
+
+    // If the subsystem has no configuration section, ignore it
+    if (!sysConfig.exists(subsystemName))
+        return MISSING;
+
+    // Set 'name' properly in the config
+    ConfigNode config(sysConfig[subsystemName]);
+    config.set("name", subsystemName);
+
+    // Create out new subsystem and store it
+    PYTHON_ERROR_TRY {
+        try {
+            subsystem = SubsystemMaker::newObject(
+                std::make_pair(config, deps));
+        } catch (core::MakerNotFoundException& ex) {
+            std::cout << ex.what() << " - "
+                      << subsystemName << std::endl;
+            return INVALID;
+        }
+    } PYTHON_ERROR_CATCH("Subsystem construction");
+
+    return CREATED;
+}
+
+void Application::writeStartupTimeline(std::ostream& out, int threads)
+{
+    // The longest chain of constructors through the dependency graph, no
+    // number of threads can start up faster than this
+    std::map<std::string, double> pathTime;
+    std::map<std::string, std::string> pathPrevious;
+    std::string last;
+    double total = 0;
+    BOOST_FOREACH(std::string name, m_order)
+    {
+        StartupTime& time = m_startupTimes[name];
+        double longest = 0;
+        BOOST_FOREACH(std::string depName, time.dependencies)
+        {
+            if (pathTime[depName] > longest)
+            {
+                longest = pathTime[depName];
+                pathPrevious[name] = depName;
+            }
+        }
+        pathTime[name] = longest + time.construct;
+        if (last.empty() || (pathTime[name] > pathTime[last]))
+            last = name;
+
+        total = std::max(total, time.start + time.construct);
+    }
+
+    out << "# Subsystem startup, times in seconds" << std::endl
+        << "# name start construct background" << std::endl;
+    BOOST_FOREACH(std::string name, m_order)
+    {
+        StartupTime& time = m_startupTimes[name];
+        out << name << " " << time.start << " " << time.construct << " "
+            << time.background << std::endl;
+    }
+    out << "# Constructed in " << total << " with " << threads
+        << " thread(s)" << std::endl;
+
+    if (last.empty())
+        return;
+
+    NameList path;
+    for (std::string name = last; !name.empty(); name = pathPrevious[name])
+        path.insert(path.begin(), name);
+    
+    out << "# Critical path " << pathTime[last] << ":";
+    BOOST_FOREACH(std::string name, path)
+        out << " " << name;
+    out << std::endl;
 }
 
 void Application::remove_from_order(std::string name)
@@ -240,6 +703,18 @@ std::vector<std::string> Application::getSubsystemNames()
 void Application::mainLoop(bool singleSubsystem)
 {
     m_running = true;
+
+    if (Clock::isVirtual())
+    {
+        lockstepLoop();
+        return;
+    }
+
+    if (m_loopThreads > 1)
+    {
+        parallelLoop(singleSubsystem);
+        return;
+    }
     
     typedef std::pair<std::string, SubsystemPtr> Pair;
     TimeVal now;
@@ -247,6 +722,7 @@ void Application::mainLoop(bool singleSubsystem)
     // Run until stopMainLoop is called
     while (m_running)
     {
+        TimeVal passStart(TimeVal::timeOfDay());
         int updated = 0;
         // Update each subsystem which isn't backgrounded
         BOOST_FOREACH(Pair item, m_subsystems)
@@ -262,9 +738,12 @@ void Application::mainLoop(bool singleSubsystem)
                     TimeVal timeSinceLastUpdate(now - m_lastUpdate[item.first]);
                     subsystem->update(timeSinceLastUpdate.get_double());
                     m_lastUpdate[item.first] = now;
+                    recordUpdate(item.first,
+                                 (TimeVal::timeOfDay() - now).get_double());
                 }
             } PYTHON_ERROR_CATCH("Subsystem loop");
         }
+        recordPass((TimeVal::timeOfDay() - passStart).get_double(), 0);
 
         assert(((updated == 1) || (!singleSubsystem)) &&
                "Single subsystem is updating multiple subsystems");
@@ -275,6 +754,484 @@ void Application::stopMainLoop()
 {
     m_running = false;
 }
+
+Application::MainLoopStats Application::getMainLoopStats()
+{
+    boost::mutex::scoped_lock lock(m_loopStatsMutex);
+    return m_loopStats;
+}
+
+void Application::recordUpdate(const std::string& name, double seconds)
+{
+    boost::mutex::scoped_lock lock(m_loopStatsMutex);
+    m_loopStats.updateTime[name] = seconds;
+    double& longest = m_loopStats.maxUpdateTime[name];
+    longest = std::max(longest, seconds);
+}
+
+void Application::recordPass(double seconds, unsigned int steals)
+{
+    boost::mutex::scoped_lock lock(m_loopStatsMutex);
+    m_loopStats.passes++;
+    m_loopStats.steals += steals;
+    m_loopStats.lastPass = seconds;
+    m_loopStats.meanPass +=
+        (seconds - m_loopStats.meanPass) / m_loopStats.passes;
+    m_loopStats.maxPass = std::max(m_loopStats.maxPass, seconds);
+}
+
+/** Shared by the threads running the main loop
+ *
+ *  The main thread starts each pass by queueing the subsystems with nothing
+ *  to wait on, then works through it with the others.  Everything besides
+ *  the queues is guarded by mutex.
+ */
+struct Application::LoopState
+{
+    /** One non-backgrounded subsystem */
+    struct Task
+    {
+        Task() : dependencies(0), waiting(0), python(false), updateTime(0) {}
+
+        std::string name;
+        SubsystemPtr subsystem;
+
+        /** Tasks which wait on this one each pass */
+        std::vector<size_t> dependents;
+
+        /** How many tasks this one waits on each pass */
+        int dependencies;
+
+        /** How many are left to finish this pass */
+        int waiting;
+
+        /** Implemented in Python, so it needs the interpreter lock */
+        bool python;
+
+        /** Only touched by the thread updating the task */
+        TimeVal lastUpdate;
+        double updateTime;
+    };
+
+    /** Ready tasks of one thread, the owner works from the back, where its
+        own tasks' dependents go, and the others steal from the front */
+    struct Queue
+    {
+        boost::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    boost::mutex mutex;
+
+    /** Signaled when a pass starts, a task is queued or the pass ends */
+    boost::condition changed;
+
+    std::vector<Task> tasks;
+    std::vector<boost::shared_ptr<Queue> > queues;
+
+    /** Written by each thread while it works, read between passes */
+    std::vector<unsigned int> steals;
+
+    /** Whether each subsystem in m_order was updated in the last pass */
+    std::vector<bool> foreground;
+
+    bool python;
+    
+    /** Counts up as passes are started */
+    unsigned int pass;
+
+    /** Tasks not yet finished in the current pass */
+    size_t remaining;
+
+    bool stopping;
+
+    /** The first error of the pass, holding onto any Python error */
+    bool failed;
+    std::string error;
+    PyObject* errorType;
+    PyObject* errorValue;
+    PyObject* errorTraceback;
+
+    LoopState(int threads) :
+        steals(threads, 0),
+        python(false),
+        pass(0),
+        remaining(0),
+        stopping(false),
+        failed(false),
+        errorType(0),
+        errorValue(0),
+        errorTraceback(0)
+    {
+        for (int i = 0; i < threads; ++i)
+            queues.push_back(boost::shared_ptr<Queue>(new Queue()));
+    }
+
+    /** Queues the tasks with nothing to wait on, spread over the threads */
+    void startPass()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        remaining = tasks.size();
+
+        size_t next = 0;
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            tasks[i].waiting = tasks[i].dependencies;
+            if (0 == tasks[i].dependencies)
+            {
+                Queue& queue = *queues[next++ % queues.size()];
+                boost::mutex::scoped_lock queueLock(queue.mutex);
+                queue.tasks.push_back(i);
+            }
+        }
+        pass++;
+        changed.notify_all();
+    }
+
+    /** Lets the other threads finish */
+    void stop()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        stopping = true;
+        changed.notify_all();
+    }
+
+    /** Must hold mutex, which every thread queueing tasks does */
+    bool queued()
+    {
+        BOOST_FOREACH(boost::shared_ptr<Queue> queue, queues)
+        {
+            boost::mutex::scoped_lock lock(queue->mutex);
+            if (!queue->tasks.empty())
+                return true;
+        }
+        return false;
+    }
+
+    /** Takes from the back of the worker's own queue, or else the front of
+        the next one with anything in it */
+    bool take(size_t worker, size_t& index)
+    {
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            Queue& queue = *queues[(worker + i) % queues.size()];
+            boost::mutex::scoped_lock lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            
+            if (0 == i)
+            {
+                index = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                index = queue.tasks.front();
+                queue.tasks.pop_front();
+                steals[worker]++;
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+void Application::parallelLoop(bool singleSubsystem)
+{
+    LoopState state(m_loopThreads);
+    state.python = (0 != Py_IsInitialized());
+    if (state.python)
+        PyEval_InitThreads();
+
+    boost::thread_group workers;
+    for (int i = 1; i < m_loopThreads; ++i)
+    {
+        workers.create_thread(
+            boost::bind(&Application::loopWorker, this, &state, (size_t)i));
+    }
+
+    // The workers use state, so they must be done before it goes
+    try {
+        while (m_running && !state.failed)
+        {
+            // Checking backgrounded() may need the interpreter, so this is
+            // done before it is released for the pass
+            PYTHON_ERROR_TRY {
+                updateLoopTasks(&state);
+            } PYTHON_ERROR_CATCH("Subsystem loop");
+            
+            assert(((state.tasks.size() == 1) || (!singleSubsystem)) &&
+                   "Single subsystem is updating multiple subsystems");
+
+            TimeVal passStart(TimeVal::timeOfDay());
+            state.startPass();
+
+            PyThreadState* threadState = 0;
+            if (state.python)
+                threadState = PyEval_SaveThread();
+            runPass(&state, 0);
+            if (state.python)
+                PyEval_RestoreThread(threadState);
+
+            unsigned int steals = 0;
+            for (size_t i = 0; i < state.steals.size(); ++i)
+            {
+                steals += state.steals[i];
+                state.steals[i] = 0;
+            }
+            BOOST_FOREACH(LoopState::Task& task, state.tasks)
+            {
+                recordUpdate(task.name, task.updateTime);
+            }
+            recordPass((TimeVal::timeOfDay() - passStart).get_double(),
+                       steals);
+        }
+    } catch (...) {
+        state.stop();
+        workers.join_all();
+        throw;
+    }
+    state.stop();
+    workers.join_all();
+
+    BOOST_FOREACH(LoopState::Task& task, state.tasks)
+    {
+        m_lastUpdate[task.name] = task.lastUpdate;
+    }
+    
+    // Report the failure from this thread, as the serial loop would
+    if (state.failed)
+    {
+        if (state.errorType)
+        {
+            PyErr_Restore(state.errorType, state.errorValue,
+                          state.errorTraceback);
+            throw boost::python::error_already_set();
+        }
+        throw std::runtime_error("Subsystem loop: " + state.error);
+    }
+}
+
+void Application::updateLoopTasks(LoopState* state)
+{
+    std::vector<bool> foreground(m_order.size(), false);
+    std::map<std::string, size_t> taskIndex;
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        foreground[i] = !m_subsystems[m_order[i]]->backgrounded();
+        if (foreground[i])
+        {
+            size_t index = taskIndex.size();
+            taskIndex[m_order[i]] = index;
+        }
+    }
+    if (foreground == state->foreground)
+        return;
+
+    // Carry over when each subsystem was last updated
+    BOOST_FOREACH(LoopState::Task& task, state->tasks)
+    {
+        m_lastUpdate[task.name] = task.lastUpdate;
+    }
+    state->foreground = foreground;
+    state->tasks.clear();
+    state->tasks.resize(taskIndex.size());
+
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        if (!foreground[i])
+            continue;
+
+        std::string name(m_order[i]);
+        size_t index = taskIndex[name];
+        LoopState::Task& task = state->tasks[index];
+        task.name = name;
+        task.subsystem = m_subsystems[name];
+        task.lastUpdate = m_lastUpdate[name];
+        task.python = (0 != dynamic_cast<boost::python::detail::wrapper_base*>(
+                           task.subsystem.get()));
+
+        // Wait on the nearest non-backgrounded subsystems up the dependency
+        // graph, ordering through backgrounded ones isn't ours to keep
+        std::set<std::string> seen;
+        NameList search(m_dependencies[name]);
+        while (!search.empty())
+        {
+            std::string depName(search.back());
+            search.pop_back();
+            if (!seen.insert(depName).second)
+                continue;
+
+            std::map<std::string, size_t>::iterator iter =
+                taskIndex.find(depName);
+            if (taskIndex.end() != iter)
+            {
+                state->tasks[iter->second].dependents.push_back(index);
+                task.dependencies++;
+            }
+            else
+            {
+                NameList& deps = m_dependencies[depName];
+                search.insert(search.end(), deps.begin(), deps.end());
+            }
+        }
+    }
+}
+
+void Application::loopWorker(LoopState* state, size_t worker)
+{
+    boost::mutex::scoped_lock lock(state->mutex);
+    unsigned int pass = 0;
+    
+    while (true)
+    {
+        while ((pass == state->pass) && !state->stopping)
+            state->changed.wait(lock);
+        if (state->stopping)
+            return;
+        
+        pass = state->pass;
+        lock.unlock();
+        runPass(state, worker);
+        lock.lock();
+    }
+}
+
+void Application::runPass(LoopState* state, size_t worker)
+{
+    while (true)
+    {
+        size_t index = 0;
+        if (!state->take(worker, index))
+        {
+            boost::mutex::scoped_lock lock(state->mutex);
+            if (0 == state->remaining)
+                return;
+            if (!state->queued())
+                state->changed.wait(lock);
+            continue;
+        }
+
+        LoopState::Task& task = state->tasks[index];
+        {
+            boost::scoped_ptr<ScopedGILock> gil;
+            if (state->python && task.python)
+                gil.reset(new ScopedGILock());
+
+            TimeVal now(TimeVal::timeOfDay());
+            try {
+                task.subsystem->update((now - task.lastUpdate).get_double());
+            }
+#ifdef RAM_WITH_WRAPPERS
+            catch (boost::python::error_already_set&) {
+                loopFailed(state, gil ? pythonErrorMessage() : "Python error",
+                           0 != gil.get());
+            }
+#endif
+            catch (std::exception& ex) {
+                loopFailed(state, ex.what(), 0 != gil.get());
+            } catch (...) {
+                loopFailed(state, "unknown exception", 0 != gil.get());
+            }
+            task.lastUpdate = now;
+            task.updateTime = (TimeVal::timeOfDay() - now).get_double();
+        }
+
+        // Dependents go on this thread's queue, where their inputs are
+        // still in cache
+        boost::mutex::scoped_lock lock(state->mutex);
+        bool queued = false;
+        BOOST_FOREACH(size_t dependent, task.dependents)
+        {
+            if (0 == --state->tasks[dependent].waiting)
+            {
+                LoopState::Queue& queue = *state->queues[worker];
+                boost::mutex::scoped_lock queueLock(queue.mutex);
+                queue.tasks.push_back(dependent);
+                queued = true;
+            }
+        }
+        state->remaining--;
+        if (queued || (0 == state->remaining))
+            state->changed.notify_all();
+    }
+}
+
+void Application::loopFailed(LoopState* state, std::string error,
+                             bool python)
+{
+    // The interpreter lock is only held for Python subsystems
+    PyObject* type = 0;
+    PyObject* value = 0;
+    PyObject* traceback = 0;
+    if (python && PyErr_Occurred())
+        PyErr_Fetch(&type, &value, &traceback);
+
+    boost::mutex::scoped_lock lock(state->mutex);
+    if (!state->failed)
+    {
+        state->failed = true;
+        state->error = error;
+        state->errorType = type;
+        state->errorValue = value;
+        state->errorTraceback = traceback;
+    }
+    else
+    {
+        Py_XDECREF(type);
+        Py_XDECREF(value);
+        Py_XDECREF(traceback);
+    }
+}
+
+void Application::lockstepLoop()
+{
+    boost::int64_t end = Clock::monotonicTime() + m_virtualDuration;
+    
+    // Pretend everything was last updated one step ago
+    TimeVal now(TimeVal::timeOfDay());
+    TimeVal step(m_virtualStep / 1000000, m_virtualStep % 1000000);
+    BOOST_FOREACH(std::string name, m_order)
+    {
+        m_lastUpdate[name] = now - step;
+    }
+
+    // Time only moves between passes, and each pass updates in dependency
+    // order from this one thread, so a run is exactly repeatable
+    while (m_running &&
+           ((m_virtualDuration < 0) || (Clock::monotonicTime() < end)))
+    {
+        now.now();
+        
+        BOOST_FOREACH(std::string name, m_order)
+        {
+            SubsystemPtr subsystem = m_subsystems[name];
+
+            PYTHON_ERROR_TRY {
+                if (subsystem->backgrounded())
+                    continue;
+
+                // Honor the configured update rate
+                TimeVal timeSinceLastUpdate(now - m_lastUpdate[name]);
+                std::map<std::string, int>::iterator iter =
+                    m_updateIntervals.find(name);
+                boost::int64_t elapsed =
+                    (boost::int64_t)timeSinceLastUpdate.seconds() * 1000000 +
+                    timeSinceLastUpdate.microseconds();
+                if ((m_updateIntervals.end() != iter) &&
+                    (elapsed < (boost::int64_t)iter->second * 1000))
+                {
+                    continue;
+                }
+                
+                subsystem->update(timeSinceLastUpdate.get_double());
+                m_lastUpdate[name] = now;
+            } PYTHON_ERROR_CATCH("Subsystem loop");
+        }
+
+        Clock::advance(m_virtualStep);
+    }
+}
     
 } // namespace core
 } // namespace ram
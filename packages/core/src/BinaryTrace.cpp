@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/BinaryTrace.cpp
+ */
+
+// STD Includes
+#include <cstring>
+#include <algorithm>
+
+// Project Includes
+#include "core/include/BinaryTrace.h"
+#include "core/include/EventTracer.h"
+
+// System Includes
+#ifdef RAM_WINDOWS
+#include <windows.h> // For MemoryBarrier()
+#endif // RAM_WINDOWS
+
+namespace ram {
+namespace core {
+
+namespace {
+
+/** Makes every write before it visible to other threads before any after */
+inline void memoryBarrier()
+{
+#ifdef RAM_WINDOWS
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+} // namespace
+
+const char* const BinaryTrace::MAGIC = "RAMTRACE";
+
+BinaryTrace::BinaryTrace(const std::string& filename, int values,
+                         size_t capacity) :
+    m_file(0),
+    m_values(values),
+    m_capacity(capacity > 0 ? capacity : 1),
+    m_rowBytes(sizeof(boost::int64_t) + values * sizeof(double)),
+    m_rows(m_capacity * m_rowBytes),
+    m_written(0),
+    m_read(0),
+    m_dropped(0)
+{
+    m_file = fopen(filename.c_str(), "wb");
+    if (m_file)
+    {
+        boost::int32_t count = values;
+        fwrite(MAGIC, 1, strlen(MAGIC), m_file);
+        fwrite(&count, sizeof(count), 1, m_file);
+    }
+}
+
+BinaryTrace::~BinaryTrace()
+{
+    unbackground(true);
+
+    write(m_written);
+    if (m_file)
+        fclose(m_file);
+}
+
+bool BinaryTrace::record(const double* values)
+{
+    size_t written = m_written;
+    if (written - m_read >= m_capacity)
+    {
+        m_dropped = m_dropped + 1;
+        return false;
+    }
+
+    char* row = &m_rows[(written % m_capacity) * m_rowBytes];
+    boost::int64_t time = EventTracer::now();
+    memcpy(row, &time, sizeof(time));
+    memcpy(row + sizeof(time), values, m_values * sizeof(double));
+
+    memoryBarrier();
+    m_written = written + 1;
+    return true;
+}
+
+void BinaryTrace::update(double)
+{
+    size_t end = m_written;
+    memoryBarrier();
+    write(end);
+}
+
+void BinaryTrace::write(size_t end)
+{
+    size_t read = m_read;
+    while (read < end)
+    {
+        // Up to the end of the ring in one go, then from its start
+        size_t first = read % m_capacity;
+        size_t rows = std::min(end - read, m_capacity - first);
+        if (m_file)
+            fwrite(&m_rows[first * m_rowBytes], m_rowBytes, rows, m_file);
+        read += rows;
+    }
+    if (m_file)
+        fflush(m_file);
+
+    // The rows must be copied out before record() may reuse them
+    memoryBarrier();
+    m_read = read;
+}
+
+bool BinaryTrace::isOpen() const
+{
+    return 0 != m_file;
+}
+
+int BinaryTrace::getValues() const
+{
+    return m_values;
+}
+
+size_t BinaryTrace::getDropped() const
+{
+    return m_dropped;
+}
+
+BinaryTraceReader::BinaryTraceReader(const std::string& filename) :
+    m_file(fopen(filename.c_str(), "rb")),
+    m_values(0)
+{
+    if (!m_file)
+        return;
+
+    char magic[8];
+    boost::int32_t count = 0;
+    size_t length = strlen(BinaryTrace::MAGIC);
+    bool good = (fread(magic, 1, length, m_file) == length) &&
+        (0 == memcmp(magic, BinaryTrace::MAGIC, length)) &&
+        (fread(&count, sizeof(count), 1, m_file) == 1) && (count >= 0);
+    if (good)
+    {
+        m_values = count;
+    }
+    else
+    {
+        fclose(m_file);
+        m_file = 0;
+    }
+}
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+    if (m_file)
+        fclose(m_file);
+}
+
+bool BinaryTraceReader::isOpen() const
+{
+    return 0 != m_file;
+}
+
+int BinaryTraceReader::getValues() const
+{
+    return m_values;
+}
+
+bool BinaryTraceReader::next(boost::int64_t& time, double* values)
+{
+    // A row cut short by a crash is left out
+    return m_file && (fread(&time, sizeof(time), 1, m_file) == 1) &&
+        (fread(values, sizeof(double), m_values, m_file) ==
+         (size_t)m_values);
+}
+
+} // namespace core
+} // namespace ram
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/Clock.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <errno.h>
+
+// Library Includes
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
+// Project Includes
+#include "core/include/Clock.h"
+
+// System Includes
+#ifdef RAM_POSIX
+#include <time.h>
+#include <sys/time.h>
+#elif defined(RAM_WINDOWS)
+    #include <windows.h> // For Sleep()
+    #include "core/include/TimeVal.h" // For gettimeofday()
+#else
+    #error "Unsupported platform"
+#endif // RAM_POSIX
+
+const static boost::int64_t USEC_PER_SEC = 1000000;
+const static boost::int64_t USEC_PER_MILLISEC = 1000;
+const static long NSEC_PER_USEC = 1000;
+
+// Virtual time state, all guarded by virtualMutex
+static boost::mutex virtualMutex;
+static boost::condition virtualAdvanced;
+
+// Only written under virtualMutex, but checked without it first so reading
+// the clock in real time, the usual case, never takes the lock.  Outside
+// the lock it is only touched with atomic operations, which are full
+// barriers.
+#ifdef RAM_WINDOWS
+static volatile LONG virtualTime = 0;
+#else
+static volatile int virtualTime = 0;
+#endif
+static boost::int64_t virtualNow = 0;
+static boost::int64_t virtualStart = 0;
+static boost::thread::id virtualDriver;
+
+/** Atomically sets virtualTime, must hold virtualMutex */
+static void setVirtualTime(bool on)
+{
+#ifdef RAM_WINDOWS
+    InterlockedExchange(&virtualTime, on ? 1 : 0);
+#else
+    if (on)
+        __sync_fetch_and_or(&virtualTime, 1);
+    else
+        __sync_fetch_and_and(&virtualTime, 0);
+#endif
+}
+
+/** Unlocked check of virtualTime, recheck it under the lock if true */
+static bool virtualTimeOn()
+{
+#ifdef RAM_WINDOWS
+    return 0 != InterlockedCompareExchange(&virtualTime, 0, 0);
+#else
+    return 0 != __sync_fetch_and_add(&virtualTime, 0);
+#endif
+}
+
+namespace ram {
+namespace core {
+
+void Clock::setVirtual(boost::int64_t startTime)
+{
+    boost::mutex::scoped_lock lock(virtualMutex);
+    virtualNow = 0;
+    virtualStart = startTime;
+    virtualDriver = boost::this_thread::get_id();
+
+    // Publish the flag last, unlocked readers then take the lock
+    setVirtualTime(true);
+}
+
+void Clock::setReal()
+{
+    boost::mutex::scoped_lock lock(virtualMutex);
+    setVirtualTime(false);
+    virtualAdvanced.notify_all();
+}
+
+bool Clock::isVirtual()
+{
+    return virtualTimeOn();
+}
+
+void Clock::advance(boost::int64_t usec)
+{
+    boost::mutex::scoped_lock lock(virtualMutex);
+    assert(virtualTime && "Can only advance virtual time");
+    virtualNow += usec;
+    virtualDriver = boost::this_thread::get_id();
+    virtualAdvanced.notify_all();
+}
+
+boost::int64_t Clock::timeOfDay()
+{
+    if (virtualTimeOn())
+    {
+        boost::mutex::scoped_lock lock(virtualMutex);
+        if (virtualTime)
+            return virtualStart + virtualNow;
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (boost::int64_t)now.tv_sec * USEC_PER_SEC + now.tv_usec;
+}
+
+boost::int64_t Clock::monotonicTime()
+{
+    if (virtualTimeOn())
+    {
+        boost::mutex::scoped_lock lock(virtualMutex);
+        if (virtualTime)
+            return virtualNow;
+    }
+
+#ifdef RAM_LINUX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (boost::int64_t)now.tv_sec * USEC_PER_SEC +
+        now.tv_nsec / NSEC_PER_USEC;
+#else
+    // No monotonic clock, fall back to the time of day
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (boost::int64_t)now.tv_sec * USEC_PER_SEC + now.tv_usec;
+#endif
+}
+
+void Clock::sleepUntil(boost::int64_t time)
+{
+    if (virtualTimeOn())
+    {
+        boost::mutex::scoped_lock lock(virtualMutex);
+        if (virtualTime)
+        {
+            if (boost::this_thread::get_id() == virtualDriver)
+                return;
+
+            while (virtualTime && virtualNow < time)
+                virtualAdvanced.wait(lock);
+            return;
+        }
+    }
+
+#ifdef RAM_LINUX
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)(time / USEC_PER_SEC);
+    deadline.tv_nsec = (long)(time % USEC_PER_SEC) * NSEC_PER_USEC;
+
+    // Restart after signals, the deadline is absolute so nothing is lost
+    while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                                    &deadline, NULL))
+    {
+    }
+#else
+    boost::int64_t remaining = time - monotonicTime();
+    if (remaining <= 0)
+        return;
+#ifdef RAM_POSIX
+    struct timespec sleep;
+    sleep.tv_sec = (time_t)(remaining / USEC_PER_SEC);
+    sleep.tv_nsec = (long)(remaining % USEC_PER_SEC) * NSEC_PER_USEC;
+    nanosleep(&sleep, NULL);
+#else
+    Sleep((DWORD)(remaining / USEC_PER_MILLISEC));
+#endif
+#endif // RAM_LINUX
+}
+
+void Clock::sleep(boost::int64_t usec)
+{
+    sleepUntil(monotonicTime() + usec);
+}
+
+} // namespace core
+} // namespace ram
@@ -7,6 +7,9 @@
  * File:  packages/core/src/ConfigNode.cpp
  */
 
+// STD Includes
+#include <cstdlib>
+
 // Library Includes
 #include <boost/filesystem.hpp>
 
@@ -14,6 +17,8 @@
 #include "core/include/ConfigNode.h"
 #include "core/include/ConfigNodeImp.h"
 #include "core/include/PythonConfigNodeImp.h"
+#include "core/include/YamlConfigNodeImp.h"
+#include "core/include/SnapshotConfigNodeImp.h"
 
 namespace ram {
 namespace core {
@@ -96,12 +101,29 @@ void ConfigNode::set(std::string key, int value)
     assert(m_impl.get() && "No ConfigNode impl found");
     m_impl->set(key, value);
 }
+
+void ConfigNode::set(std::string key, double value)
+{
+    assert(m_impl.get() && "No ConfigNode impl found");
+    m_impl->set(key, value);
+}
     
 ConfigNode ConfigNode::fromString(std::string data)
 {
     return ConfigNode(ConfigNodeImpPtr(new PythonConfigNodeImp(data)));
 }
 
+ConfigNode ConfigNode::fromYamlString(std::string data)
+{
+    return ConfigNode(ConfigNodeImpPtr(
+        new YamlConfigNodeImp(YamlConfigNodeImp::parse(data))));
+}
+
+bool ConfigNode::isPython()
+{
+    return 0 != dynamic_cast<PythonConfigNodeImp*>(m_impl.get());
+}
+
 std::string ConfigNode::toString()
 {
     assert(m_impl.get() && "No ConfigNode impl found");
@@ -112,7 +134,13 @@ ConfigNode ConfigNode::fromFile(std::string configPath)
 {
     boost::filesystem::path path(configPath);
     if (path.extension() == ".yml" || path.extension() == ".sml") {
-        return ConfigNode(PythonConfigNodeImp::fromYamlFile(path.string()));
+        // Lets a config the native parser gets wrong be loaded the old way
+        if (getenv("RAM_PYTHON_CONFIG"))
+            return ConfigNode(PythonConfigNodeImp::fromYamlFile(path.string()));
+        return ConfigNode(YamlConfigNodeImp::fromYamlFile(path.string()));
+    } else if (path.extension() == ".ymlc") {
+        return ConfigNode(
+            SnapshotConfigNodeImp::fromSnapshotFile(path.string()));
     } else {
         assert(false && "Invalid configuration type!");
     }
@@ -16,7 +16,8 @@ namespace core {
 
 Event::Event() :
     sender(0),
-    timeStamp(TimeVal::timeOfDay().get_double())
+    timeStamp(TimeVal::timeOfDay().get_double()),
+    arrivalTime(0)
 {
 }
 
@@ -32,6 +33,7 @@ void Event::copyInto(EventPtr inEvent)
     inEvent->type = type;
     inEvent->sender = sender;
     inEvent->timeStamp = timeStamp;
+    inEvent->arrivalTime = arrivalTime;
 }    
     
 } // namespace core
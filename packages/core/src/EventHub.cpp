@@ -6,12 +6,14 @@
  * Author: Joseph Lisee <jlisee@umd.edu>
  * File:  packages/core/src/EventHub.cpp
  */
-
+// STD Includes
+#include <set>
 
 // Project Includes
 #include "core/include/EventHub.h"
 #include "core/include/EventPublisherBase.h"
 #include "core/include/SubsystemMaker.h"
+#include "core/include/ReadWriteMutex.h"
 
 // Event Types
 RAM_CORE_EVENT_TYPE(ram::core::EventHub, ALL_EVENTS);
@@ -22,8 +24,43 @@ RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::core::EventHub, EventHub);
 namespace ram {
 namespace core {
 
+namespace {
+
+struct TypeNames
+{
+    ReadWriteMutex mutex;
+    std::set<Event::EventType> names;
+};
+
+/** Never freed, hubs owned by static objects still publish while the
+ *  process exits */
+TypeNames& getTypeNames()
+{
+    static TypeNames* names = new TypeNames();
+    return *names;
+}
+
+/** Returns the one shared copy of the type, so (type, publisher) keys can
+ *  hold a pointer instead of copying the string on every publish */
+const Event::EventType* internType(const Event::EventType& type)
+{
+    TypeNames& names = getTypeNames();
+    {
+        ReadWriteMutex::ScopedReadLock lock(names.mutex);
+        std::set<Event::EventType>::const_iterator iter =
+            names.names.find(type);
+        if (names.names.end() != iter)
+            return &(*iter);
+    }
+
+    ReadWriteMutex::ScopedWriteLock lock(names.mutex);
+    return &(*names.names.insert(type).first);
+}
+
+} // namespace
+
 typedef EventPublisherBaseTemplate<Event::EventType> TypeEventPublisherType;
-typedef std::pair<Event::EventType, EventPublisher*> TypePublisherPair;
+typedef std::pair<const Event::EventType*, EventPublisher*> TypePublisherPair;
 typedef EventPublisherBaseTemplate<TypePublisherPair>
     TypePublisherEventPublisherType;
     
@@ -41,17 +78,19 @@ asType(EventPublisherBasePtr basePtr)
 
 EventHub::EventHub(std::string name) : 
     Subsystem(name),
-    m_impType(new EventPublisherBaseTemplate<Event::EventType>()),
-    m_impTypePublisher(new EventPublisherBaseTemplate<TypePublisherPair>()),
-    m_impAll(new EventPublisherBaseTemplate<Event::EventType>())
+    m_impType(new TypeEventPublisherType(EventHubPtr(), getName(), false)),
+    m_impTypePublisher(
+        new TypePublisherEventPublisherType(EventHubPtr(), getName(), false)),
+    m_impAll(new TypeEventPublisherType(EventHubPtr(), getName(), false))
 {
 }
     
 EventHub::EventHub(ConfigNode config, SubsystemList deps) :
     Subsystem(config["name"].asString()),
-    m_impType(new EventPublisherBaseTemplate<Event::EventType>()),
-    m_impTypePublisher(new EventPublisherBaseTemplate<TypePublisherPair>()),
-    m_impAll(new EventPublisherBaseTemplate<Event::EventType>())
+    m_impType(new TypeEventPublisherType(EventHubPtr(), getName(), false)),
+    m_impTypePublisher(
+        new TypePublisherEventPublisherType(EventHubPtr(), getName(), false)),
+    m_impAll(new TypeEventPublisherType(EventHubPtr(), getName(), false))
 {
 }
 
@@ -66,7 +105,7 @@ EventConnectionPtr EventHub::subscribe(
 {
     // Subscribe to the internal event publisher which handles subscribes
     // who want events of a particular type from a certain publisher
-    TypePublisherPair pair(type, publisher);
+    TypePublisherPair pair(internType(type), publisher);
     return asType<TypePublisherEventPublisherType>(m_impTypePublisher)->
         subscribe(pair, handler);
 }
@@ -98,8 +137,9 @@ void EventHub::publish(EventPtr event)
                                                        event);
 
     // Publish to all subscribers to specific EventType & EventPublisher pairs
+    TypePublisherPair pair(internType(event->type), event->sender);
     asType<TypePublisherEventPublisherType>(m_impTypePublisher)->publish(
-        std::make_pair(event->type, event->sender),
+        pair,
         event->type,
         event->sender,
         event);
@@ -112,7 +152,7 @@ void EventHub::publish(EventPtr event)
         event);
 }
 
-void EventHub::publish(Event::EventType etype, EventPtr event)
+void EventHub::publish(const Event::EventType& etype, EventPtr event)
 {
     event->type = etype;
     event->sender = this;
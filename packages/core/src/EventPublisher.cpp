@@ -47,7 +47,7 @@ EventConnectionPtr EventPublisher::subscribe(
     return asType(m_imp)->subscribe(type, handler);
 }
 
-void EventPublisher::publish(Event::EventType type, EventPtr event)
+void EventPublisher::publish(const Event::EventType& type, EventPtr event)
 {
     asType(m_imp)->publish(type, type, this, event);
 }
@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/EventTracer.cpp
+ */
+
+// STD Includes
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <ostream>
+#include <cstdio>
+#include <cstdlib>
+#include <typeinfo>
+
+// Compiler Includes
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif // __GNUC__
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+// Project Includes
+#include "core/include/EventTracer.h"
+
+// System Includes
+#ifdef RAM_POSIX
+#include <time.h>
+#include <sys/time.h>
+#elif defined(RAM_WINDOWS)
+    #include <windows.h> // For MemoryBarrier()
+    #include "core/include/TimeVal.h" // For gettimeofday()
+#else
+    #error "Unsupported platform"
+#endif // RAM_POSIX
+
+namespace ram {
+namespace core {
+
+namespace {
+
+enum RecordKind {
+    PUBLISH,
+    HANDLER,
+    QUEUED
+};
+
+struct Record
+{
+    boost::int64_t start;
+    boost::int64_t end;
+    int type;
+    int handler;
+    int kind;
+};
+
+/** Statistics of one thread, or of all the threads which have exited */
+struct ThreadStats
+{
+    /** Indexed by event type id */
+    EventTracer::TypeStats types[EventTracer::MAX_NAMES];
+
+    /** Indexed by handler id */
+    EventTracer::Histogram handlers[EventTracer::MAX_NAMES];
+
+    void merge(const ThreadStats& other, size_t names)
+    {
+        for (size_t id = 0; id < names; ++id)
+        {
+            types[id].publishTime.merge(other.types[id].publishTime);
+            types[id].handlerTime.merge(other.types[id].handlerTime);
+            types[id].queueTime.merge(other.types[id].queueTime);
+            handlers[id].merge(other.handlers[id]);
+        }
+    }
+};
+
+/** Everything one thread has traced, only ever written by that thread */
+struct ThreadData : public ThreadStats
+{
+    ThreadData(int id_) : id(id_), written(0) {}
+
+    int id;
+
+    /** Ids of the event types this thread has seen, saves locking the
+        shared table for every event */
+    std::map<std::string, int> typeIds;
+
+    /** records[i % RING_SIZE] holds the i'th record, written counts them
+        all and is only moved on once the record is complete */
+    volatile size_t written;
+    Record records[EventTracer::RING_SIZE];
+};
+
+/** The last records of a thread */
+struct ThreadRecords
+{
+    int id;
+    std::vector<Record> records;
+};
+
+void releaseThreadData(ThreadData* data);
+
+/** Shared between threads, guarded by mutex */
+struct TracerState
+{
+    TracerState() : exitedRecords(0), threadData(&releaseThreadData)
+    {
+        // Id 0 collects everything past MAX_NAMES
+        names.push_back("(other)");
+    }
+
+    boost::mutex mutex;
+    std::map<std::string, int> ids;
+    std::vector<std::string> names;
+
+    /** Threads still running */
+    std::vector<ThreadData*> threads;
+
+    /** Merged statistics of the threads which have exited, and the records
+        of the most recent of them, at most RING_SIZE in all */
+    ThreadStats exited;
+    std::deque<ThreadRecords> exitedThreads;
+    size_t exitedRecords;
+
+    boost::thread_specific_ptr<ThreadData> threadData;
+};
+
+/** Built on first use so publishers in static constructors can be traced */
+TracerState& getState()
+{
+    static TracerState* state = new TracerState();
+    return *state;
+}
+
+/** Makes every write before it visible to other threads before any after */
+inline void memoryBarrier()
+{
+#ifdef RAM_WINDOWS
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+int getNameId(const std::string& name)
+{
+    TracerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    std::map<std::string, int>::iterator iter = state.ids.find(name);
+    if (state.ids.end() != iter)
+        return iter->second;
+    if ((int)state.names.size() >= EventTracer::MAX_NAMES)
+        return 0;
+
+    int id = (int)state.names.size();
+    state.names.push_back(name);
+    state.ids[name] = id;
+    return id;
+}
+
+ThreadData& getThreadData()
+{
+    TracerState& state = getState();
+    ThreadData* data = state.threadData.get();
+    if (!data)
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        data = new ThreadData((int)state.threads.size() + 1);
+        state.threads.push_back(data);
+        state.threadData.reset(data);
+    }
+    return *data;
+}
+
+int getTypeId(ThreadData& data, const Event::EventType& type)
+{
+    std::map<std::string, int>::iterator iter = data.typeIds.find(type);
+    if (data.typeIds.end() != iter)
+        return iter->second;
+
+    int id = getNameId(type);
+    data.typeIds[type] = id;
+    return id;
+}
+
+void append(ThreadData& data, RecordKind kind, int type, int handler,
+            boost::int64_t start, boost::int64_t end)
+{
+    Record& record = data.records[data.written % EventTracer::RING_SIZE];
+    record.start = start;
+    record.end = end;
+    record.type = type;
+    record.handler = handler;
+    record.kind = kind;
+
+    memoryBarrier();
+    data.written = data.written + 1;
+}
+
+/** Copies the records which were not overwritten while copying */
+std::vector<Record> copyRecords(ThreadData& data)
+{
+    size_t end = data.written;
+    memoryBarrier();
+    size_t begin = (end > EventTracer::RING_SIZE) ?
+        end - EventTracer::RING_SIZE : 0;
+
+    std::vector<Record> records;
+    for (size_t i = begin; i < end; ++i)
+        records.push_back(data.records[i % EventTracer::RING_SIZE]);
+
+    // The owner may have moved on to the slot of the oldest ones
+    memoryBarrier();
+    size_t after = data.written;
+    size_t valid = (after + 1 > EventTracer::RING_SIZE) ?
+        after + 1 - EventTracer::RING_SIZE : 0;
+    if (valid > begin)
+    {
+        records.erase(records.begin(),
+                      records.begin() + std::min(valid - begin,
+                                                 records.size()));
+    }
+    return records;
+}
+
+/** Frees the data of a thread as it exits, keeping what the statistics and
+ *  the trace still need */
+void releaseThreadData(ThreadData* data)
+{
+    TracerState& state = getState();
+    std::vector<Record> records(copyRecords(*data));
+
+    boost::mutex::scoped_lock lock(state.mutex);
+    state.threads.erase(std::remove(state.threads.begin(),
+                                    state.threads.end(), data),
+                        state.threads.end());
+    state.exited.merge(*data, state.names.size());
+
+    if (!records.empty())
+    {
+        ThreadRecords exited;
+        exited.id = data->id;
+        state.exitedThreads.push_back(exited);
+        state.exitedThreads.back().records.swap(records);
+        state.exitedRecords += state.exitedThreads.back().records.size();
+    }
+    while (state.exitedRecords > EventTracer::RING_SIZE)
+    {
+        state.exitedRecords -= state.exitedThreads.front().records.size();
+        state.exitedThreads.pop_front();
+    }
+
+    delete data;
+}
+
+std::string handlerName(const boost::function<void (EventPtr)>& handler)
+{
+    std::string result(handler.target_type().name());
+
+#ifdef __GNUC__
+    int status;
+    char* realname = abi::__cxa_demangle(result.c_str(), 0, 0, &status);
+    if (0 == status)
+        result = std::string(realname);
+    free(realname);
+#endif // __GNUC__
+
+    return result;
+}
+
+/** Stands in for a handler, timing each call while tracing is enabled */
+struct TracedHandler
+{
+    TracedHandler(boost::function<void (EventPtr)> handler_, int id_) :
+        handler(handler_), id(id_) {}
+
+    void operator()(EventPtr event)
+    {
+        if (!EventTracer::isEnabled())
+        {
+            handler(event);
+            return;
+        }
+
+        boost::int64_t start = EventTracer::now();
+        handler(event);
+        boost::int64_t end = EventTracer::now();
+
+        ThreadData& data = getThreadData();
+        int type = getTypeId(data, event->type);
+        data.types[type].handlerTime.record(end - start);
+        data.handlers[id].record(end - start);
+        append(data, HANDLER, type, id, start, end);
+    }
+
+    boost::function<void (EventPtr)> handler;
+    int id;
+};
+
+void writeString(std::ostream& out, const std::string& str)
+{
+    out << '"';
+    BOOST_FOREACH(char c, str)
+    {
+        if (('"' == c) || ('\\' == c))
+        {
+            out << '\\' << c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            sprintf(escaped, "\\u%04x", (unsigned char)c);
+            out << escaped;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+volatile bool EventTracer::s_enabled = false;
+const size_t EventTracer::RING_SIZE;
+const int EventTracer::MAX_NAMES;
+
+EventTracer::Histogram::Histogram() :
+    count(0),
+    total(0),
+    max(0)
+{
+    for (int i = 0; i < TimingStats::BUCKETS; ++i)
+        buckets[i] = 0;
+}
+
+void EventTracer::Histogram::record(boost::int64_t usec)
+{
+    count++;
+    total += usec;
+    if (usec > max)
+        max = usec;
+    buckets[TimingStats::getBucket(usec)]++;
+}
+
+void EventTracer::Histogram::merge(const Histogram& other)
+{
+    count += other.count;
+    total += other.total;
+    if (other.max > max)
+        max = other.max;
+    for (int i = 0; i < TimingStats::BUCKETS; ++i)
+        buckets[i] += other.buckets[i];
+}
+
+double EventTracer::Histogram::getMean() const
+{
+    if (0 == count)
+        return 0;
+    return (double)total / count;
+}
+
+boost::int64_t EventTracer::Histogram::getPercentile(double fraction) const
+{
+    if (0 == count)
+        return -1;
+
+    unsigned int under = 0;
+    for (int i = 0; i < TimingStats::BUCKETS; ++i)
+    {
+        under += buckets[i];
+        if (under >= fraction * count)
+            return TimingStats::getBucketLimit(i);
+    }
+    return -1;
+}
+
+void EventTracer::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+boost::int64_t EventTracer::now()
+{
+#ifdef RAM_LINUX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (boost::int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (boost::int64_t)now.tv_sec * 1000000 + now.tv_usec;
+#endif
+}
+
+void EventTracer::recordPublish(const Event::EventType& type,
+                                boost::int64_t start, boost::int64_t end)
+{
+    ThreadData& data = getThreadData();
+    int id = getTypeId(data, type);
+    data.types[id].publishTime.record(end - start);
+    append(data, PUBLISH, id, -1, start, end);
+}
+
+void EventTracer::recordQueued(const Event::EventType& type,
+                               boost::int64_t queued,
+                               boost::int64_t published)
+{
+    ThreadData& data = getThreadData();
+    int id = getTypeId(data, type);
+    data.types[id].queueTime.record(published - queued);
+    append(data, QUEUED, id, -1, queued, published);
+}
+
+boost::function<void (EventPtr)> EventTracer::traceHandler(
+    boost::function<void (EventPtr)> handler)
+{
+    return TracedHandler(handler, getNameId(handlerName(handler)));
+}
+
+EventTracer::TypeStatsMap EventTracer::getTypeStats()
+{
+    TracerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    std::vector<const ThreadStats*> threads(state.threads.begin(),
+                                            state.threads.end());
+    threads.push_back(&state.exited);
+
+    TypeStatsMap result;
+    BOOST_FOREACH(const ThreadStats* data, threads)
+    {
+        for (size_t id = 0; id < state.names.size(); ++id)
+        {
+            const TypeStats& stats = data->types[id];
+            if ((0 == stats.publishTime.count) &&
+                (0 == stats.handlerTime.count) &&
+                (0 == stats.queueTime.count))
+            {
+                continue;
+            }
+
+            TypeStats& merged = result[state.names[id]];
+            merged.publishTime.merge(stats.publishTime);
+            merged.handlerTime.merge(stats.handlerTime);
+            merged.queueTime.merge(stats.queueTime);
+        }
+    }
+    return result;
+}
+
+EventTracer::HandlerStatsMap EventTracer::getHandlerStats()
+{
+    TracerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    std::vector<const ThreadStats*> threads(state.threads.begin(),
+                                            state.threads.end());
+    threads.push_back(&state.exited);
+
+    HandlerStatsMap result;
+    BOOST_FOREACH(const ThreadStats* data, threads)
+    {
+        for (size_t id = 0; id < state.names.size(); ++id)
+        {
+            if (data->handlers[id].count > 0)
+                result[state.names[id]].merge(data->handlers[id]);
+        }
+    }
+    return result;
+}
+
+void EventTracer::writeChromeTrace(std::ostream& out)
+{
+    TracerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    // Exited threads first, they ran earlier
+    std::vector<ThreadRecords> threads(state.exitedThreads.begin(),
+                                       state.exitedThreads.end());
+    BOOST_FOREACH(ThreadData* data, state.threads)
+    {
+        threads.push_back(ThreadRecords());
+        threads.back().id = data->id;
+        threads.back().records = copyRecords(*data);
+    }
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+    bool first = true;
+    int queuedId = 0;
+    BOOST_FOREACH(const ThreadRecords& thread, threads)
+    {
+        if (!first)
+            out << "," << std::endl;
+        first = false;
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            << "\"tid\": " << thread.id << ", \"args\": {\"name\": "
+            << "\"Thread " << thread.id << "\"}}";
+
+        BOOST_FOREACH(const Record& record, thread.records)
+        {
+            const std::string& type = state.names[record.type];
+            out << "," << std::endl;
+
+            if (QUEUED == record.kind)
+            {
+                // Waits of the same type overlap, so each needs an id
+                queuedId++;
+                out << "{\"name\": ";
+                writeString(out, type);
+                out << ", \"cat\": \"queue\", \"ph\": \"b\", \"id\": "
+                    << queuedId << ", \"pid\": 1, \"tid\": " << thread.id
+                    << ", \"ts\": " << record.start << "}," << std::endl
+                    << "{\"name\": ";
+                writeString(out, type);
+                out << ", \"cat\": \"queue\", \"ph\": \"e\", \"id\": "
+                    << queuedId << ", \"pid\": 1, \"tid\": " << thread.id
+                    << ", \"ts\": " << record.end << "}";
+                continue;
+            }
+
+            out << "{\"name\": ";
+            if (HANDLER == record.kind)
+                writeString(out, state.names[record.handler]);
+            else
+                writeString(out, type);
+            out << ", \"cat\": \""
+                << ((HANDLER == record.kind) ? "handler" : "publish")
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread.id
+                << ", \"ts\": " << record.start << ", \"dur\": "
+                << record.end - record.start << ", \"args\": {\"type\": ";
+            writeString(out, type);
+            out << "}}";
+        }
+    }
+    out << std::endl << "]}" << std::endl;
+}
+
+} // namespace core
+} // namespace ram
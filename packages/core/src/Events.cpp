@@ -22,6 +22,8 @@ static ram::core::SpecificEventConverter<ram::core::StringEvent>
 RAM_CORE_STRINGEVENT;
 static ram::core::SpecificEventConverter<ram::core::IntEvent>
 RAM_CORE_INTEVENT;
+static ram::core::SpecificEventConverter<ram::core::ProfileEvent>
+RAM_CORE_PROFILEEVENT;
    
 #endif // RAM_WITH_WRAPPERS
 
@@ -36,5 +38,18 @@ EventPtr StringEvent::clone()
     return event;
 }
 
+EventPtr ProfileEvent::clone()
+{
+    ProfileEventPtr event = ProfileEventPtr(new ProfileEvent());
+    copyInto(event);
+    event->data = data;
+    event->deadlineMisses = deadlineMisses;
+    event->meanJitter = meanJitter;
+    event->maxJitter = maxJitter;
+    event->jitter99 = jitter99;
+    event->maxRunTime = maxRunTime;
+    return event;
+}
+
 } // namespace core
 } // namespace ram
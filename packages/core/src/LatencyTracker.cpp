@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/LatencyTracker.cpp
+ */
+
+// STD Includes
+#include <vector>
+#include <algorithm>
+#include <ostream>
+#include <iomanip>
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/LatencyTracker.h"
+#include "core/include/EventPublisher.h"
+
+namespace ram {
+namespace core {
+
+namespace {
+
+/** Arrival time of the newest data from each source */
+typedef std::map<std::string, boost::int64_t> ArrivalMap;
+
+struct TrackerState
+{
+    boost::mutex mutex;
+
+    /** Newest data from each source to reach each stage */
+    std::map<std::string, ArrivalMap> newest;
+
+    LatencyTracker::SourceStatsMap stats;
+};
+
+TrackerState& getState()
+{
+    static TrackerState* state = new TrackerState();
+    return *state;
+}
+
+} // namespace
+
+const char* const LatencyTracker::DRIVER = "driver";
+const char* const LatencyTracker::ESTIMATOR = "estimator";
+const char* const LatencyTracker::CONTROLLER = "controller";
+const char* const LatencyTracker::THRUSTERS = "thrusters";
+
+volatile bool LatencyTracker::s_enabled = false;
+
+void LatencyTracker::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+boost::int64_t LatencyTracker::now()
+{
+    return EventTracer::now();
+}
+
+void LatencyTracker::record(const std::string& source,
+                            const std::string& stage,
+                            boost::int64_t arrival)
+{
+    if (!s_enabled || (0 == arrival))
+        return;
+
+    boost::int64_t latency = now() - arrival;
+
+    TrackerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    state.stats[source][stage].record(latency);
+    state.newest[stage][source] = arrival;
+}
+
+void LatencyTracker::record(EventPtr event, const std::string& stage)
+{
+    if (!s_enabled || (0 == event->arrivalTime))
+        return;
+
+    std::string source(event->type);
+    if (event->sender)
+        source = event->sender->getPublisherName();
+    record(source, stage, event->arrivalTime);
+}
+
+void LatencyTracker::forward(const std::string& stage,
+                             const std::string& from)
+{
+    if (!s_enabled)
+        return;
+
+    boost::int64_t current = now();
+
+    TrackerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    ArrivalMap& reached = state.newest[stage];
+    BOOST_FOREACH(ArrivalMap::value_type pair, state.newest[from])
+    {
+        // Only count each sample the first time it gets here
+        boost::int64_t& last = reached[pair.first];
+        if (pair.second <= last)
+            continue;
+
+        last = pair.second;
+        state.stats[pair.first][stage].record(current - pair.second);
+    }
+}
+
+LatencyTracker::SourceStatsMap LatencyTracker::getStats()
+{
+    TrackerState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return state.stats;
+}
+
+void LatencyTracker::writeReport(std::ostream& out)
+{
+    static const char* const STAGES[] = {DRIVER, ESTIMATOR, CONTROLLER,
+                                         THRUSTERS};
+    static const size_t STAGE_COUNT = sizeof(STAGES) / sizeof(STAGES[0]);
+
+    SourceStatsMap stats(getStats());
+
+    out << std::left << std::setw(20) << "source" << std::setw(12)
+        << "stage" << std::right << std::setw(10) << "count"
+        << std::setw(10) << "mean" << std::setw(10) << "p50"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+
+    BOOST_FOREACH(SourceStatsMap::value_type& source, stats)
+    {
+        // The known stages in pipeline order, then any others by name
+        std::vector<std::string> order(STAGES, STAGES + STAGE_COUNT);
+        BOOST_FOREACH(StageStatsMap::value_type& stage, source.second)
+        {
+            if (order.end() == std::find(order.begin(), order.end(),
+                                         stage.first))
+            {
+                order.push_back(stage.first);
+            }
+        }
+
+        BOOST_FOREACH(std::string stage, order)
+        {
+            StageStatsMap::iterator iter = source.second.find(stage);
+            if (source.second.end() == iter)
+                continue;
+
+            const EventTracer::Histogram& histogram = iter->second;
+            out << std::left << std::setw(20) << source.first
+                << std::setw(12) << stage << std::right
+                << std::setw(10) << histogram.count
+                << std::setw(10) << (boost::int64_t)histogram.getMean()
+                << std::setw(10) << histogram.getPercentile(0.5)
+                << std::setw(10) << histogram.getPercentile(0.99)
+                << std::setw(10) << histogram.max << std::endl;
+        }
+    }
+}
+
+} // namespace core
+} // namespace ram
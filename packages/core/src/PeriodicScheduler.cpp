@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/PeriodicScheduler.cpp
+ */
+
+// STD Includes
+#include <stdio.h>
+#include <algorithm>
+
+// Library Includes
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+// Project Includes
+#include "core/include/PeriodicScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/Clock.h"
+
+// System Includes
+#ifdef RAM_LINUX
+#include <sched.h>
+#include <pthread.h>
+#endif // RAM_LINUX
+
+const static boost::int64_t USEC_PER_SEC = 1000000;
+const static boost::int64_t USEC_PER_MILLISEC = 1000;
+
+// Longest a worker waits before rechecking its tasks (in usec), the waits
+// are on the wall clock so this bounds the effect of it being stepped
+const static boost::int64_t MAX_SLEEP = 10000;
+
+namespace ram {
+namespace core {
+
+PeriodicScheduler* PeriodicScheduler::s_default = 0;
+
+PeriodicScheduler::PeriodicScheduler(ConfigNode config) :
+    m_running(false),
+    m_realTime(config["realtime"].asInt(0) != 0)
+{
+    std::vector<int> workerCores;
+    if (config.exists("workers"))
+    {
+        ConfigNode workers(config["workers"]);
+        for (size_t i = 0; i < workers.size(); ++i)
+            workerCores.push_back(workers[(int)i].asInt());
+    }
+    else
+    {
+        unsigned int cpus = std::max(boost::thread::hardware_concurrency(), 1u);
+        workerCores.assign(cpus, -1);
+    }
+
+    start(workerCores);
+}
+
+PeriodicScheduler::PeriodicScheduler(std::vector<int> workerCores,
+                                     bool realTime) :
+    m_running(false),
+    m_realTime(realTime)
+{
+    start(workerCores);
+}
+
+PeriodicScheduler::~PeriodicScheduler()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_running = false;
+        for (size_t i = 0; i < m_workers.size(); ++i)
+            wakeWorker(i);
+    }
+
+    BOOST_FOREACH(Worker& worker, m_workers)
+    {
+        worker.thread->join();
+        delete worker.thread;
+        delete worker.wakeup;
+    }
+
+    BOOST_FOREACH(Task* task, m_tasks)
+    {
+        delete task;
+    }
+
+    if (this == s_default)
+        s_default = 0;
+}
+
+void PeriodicScheduler::add(Updatable* updatable, int interval, int core)
+{
+    assert(interval > 0 && "Only periodic tasks can be scheduled");
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    Task* task = findTask(updatable);
+    if (task)
+    {
+        task->period = interval * USEC_PER_MILLISEC;
+        task->removed = false;
+    }
+    else
+    {
+        task = new Task;
+        task->updatable = updatable;
+        task->worker = pickWorker(core);
+        task->period = interval * USEC_PER_MILLISEC;
+        task->release = Clock::monotonicTime();
+        task->lastStart = task->release;
+        task->first = true;
+        task->running = false;
+        task->removed = false;
+        m_tasks.push_back(task);
+    }
+
+    // The task may now be the worker's earliest release
+    wakeWorker(task->worker);
+    updatePriorities();
+}
+
+void PeriodicScheduler::remove(Updatable* updatable, bool wait)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    Task* task = findTask(updatable);
+    if (!task)
+        return;
+
+    if (task->running)
+    {
+        // The worker deletes it once the update finishes
+        task->removed = true;
+        while (wait && findTask(updatable))
+            m_taskDone.wait(lock);
+    }
+    else
+    {
+        eraseTask(task);
+    }
+
+    updatePriorities();
+}
+
+bool PeriodicScheduler::contains(Updatable* updatable)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    Task* task = findTask(updatable);
+    return task && !task->removed;
+}
+
+int PeriodicScheduler::getWorker(Updatable* updatable)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    Task* task = findTask(updatable);
+    if (!task || task->removed)
+        return -1;
+    return (int)task->worker;
+}
+
+size_t PeriodicScheduler::getWorkerCount()
+{
+    return m_workers.size();
+}
+
+int PeriodicScheduler::getWorkerPriority(size_t worker)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    assert(worker < m_workers.size() && "Invalid worker");
+    return m_workers[worker].priority;
+}
+
+void PeriodicScheduler::setDefault(PeriodicScheduler* scheduler)
+{
+    s_default = scheduler;
+}
+
+PeriodicScheduler* PeriodicScheduler::getDefault()
+{
+    return s_default;
+}
+
+void PeriodicScheduler::start(std::vector<int> workerCores)
+{
+    assert(!workerCores.empty() && "Scheduler needs at least one worker");
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_running = true;
+
+    BOOST_FOREACH(int core, workerCores)
+    {
+        Worker worker = {core, 0, false, 0, new boost::condition(), 0};
+        m_workers.push_back(worker);
+    }
+
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i].thread = new boost::thread(
+            boost::bind(&PeriodicScheduler::run, this, i));
+    }
+}
+
+void PeriodicScheduler::run(size_t index)
+{
+    int core = 0;
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        core = m_workers[index].core;
+    }
+
+#ifdef RAM_LINUX
+    if (core >= 0)
+    {
+        cpu_set_t cpuMask;
+        CPU_ZERO(&cpuMask);
+        CPU_SET(core, &cpuMask);
+        if (sched_setaffinity(0, sizeof(cpuMask), &cpuMask))
+            perror("ERROR sched_setaffinity");
+    }
+#endif
+
+    while (true)
+    {
+        Task* task = 0;
+        boost::int64_t period = 0;
+        boost::int64_t wake = 0;
+        bool priorityChanged = false;
+        int priority = 0;
+        unsigned int wakeups = 0;
+
+        // Find the next task to run and claim it if its due
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            if (!m_running)
+                break;
+
+            Worker& worker = m_workers[index];
+            priorityChanged = worker.priorityChanged;
+            priority = worker.priority;
+            worker.priorityChanged = false;
+            wakeups = worker.wakeups;
+
+            BOOST_FOREACH(Task* candidate, m_tasks)
+            {
+                if (candidate->worker != index || candidate->removed)
+                    continue;
+
+                if (!task || candidate->release < task->release ||
+                    (candidate->release == task->release &&
+                     candidate->period < task->period))
+                {
+                    task = candidate;
+                }
+            }
+
+            boost::int64_t now = Clock::monotonicTime();
+            wake = now + MAX_SLEEP;
+            if (task && task->release > now)
+            {
+                wake = std::min(wake, task->release);
+                task = 0;
+            }
+            else if (task)
+            {
+                // add() can change the period while the task runs
+                task->running = true;
+                period = task->period;
+            }
+        }
+
+#ifdef RAM_LINUX
+        if (priorityChanged)
+        {
+            struct sched_param param;
+            param.sched_priority = priority;
+            int policy = (0 == priority) ? SCHED_OTHER : SCHED_FIFO;
+            if (pthread_setschedparam(pthread_self(), policy, &param))
+                perror("ERROR pthread_setschedparam");
+        }
+#endif
+
+        if (!task)
+        {
+            // Sleep until the release, unless add() or shutdown wakes us
+            boost::mutex::scoped_lock lock(m_mutex);
+            Worker& worker = m_workers[index];
+            boost::int64_t now = Clock::monotonicTime();
+            if (m_running && worker.wakeups == wakeups && now < wake)
+            {
+                worker.wakeup->timed_wait(
+                    lock, boost::posix_time::microseconds(wake - now));
+            }
+            continue;
+        }
+
+        boost::int64_t start = Clock::monotonicTime();
+        double timestep = (double)period / USEC_PER_SEC;
+        if (!task->first)
+            timestep = (double)(start - task->lastStart) / USEC_PER_SEC;
+
+        task->updatable->update(timestep);
+
+        boost::int64_t end = Clock::monotonicTime();
+        boost::int64_t deadline = task->release + period;
+
+        // The first release is whenever the task was added, so its jitter
+        // says nothing about the schedule
+        if (!task->first)
+        {
+            task->updatable->recordUpdate(start - task->release, end - start,
+                                          end - deadline);
+        }
+
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            task->running = false;
+            task->first = false;
+            task->lastStart = start;
+
+            // Keep the phase, skipping any whole periods that were missed
+            task->release = deadline;
+            if (end > deadline)
+                task->release += ((end - deadline) / period) * period;
+
+            if (task->removed)
+                eraseTask(task);
+            m_taskDone.notify_all();
+        }
+    }
+}
+
+PeriodicScheduler::Task* PeriodicScheduler::findTask(Updatable* updatable)
+{
+    BOOST_FOREACH(Task* task, m_tasks)
+    {
+        if (task->updatable == updatable)
+            return task;
+    }
+    return 0;
+}
+
+void PeriodicScheduler::wakeWorker(size_t worker)
+{
+    m_workers[worker].wakeups++;
+    m_workers[worker].wakeup->notify_one();
+}
+
+void PeriodicScheduler::eraseTask(Task* task)
+{
+    m_tasks.erase(std::find(m_tasks.begin(), m_tasks.end(), task));
+    delete task;
+}
+
+size_t PeriodicScheduler::pickWorker(int core)
+{
+    bool havePinned = false;
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        if (core >= 0 && m_workers[i].core == core)
+            havePinned = true;
+    }
+
+    // Load is measured as the total update rate of each worker
+    size_t best = 0;
+    double bestLoad = -1;
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        if (havePinned && m_workers[i].core != core)
+            continue;
+
+        double load = 0;
+        BOOST_FOREACH(Task* task, m_tasks)
+        {
+            if (task->worker == i && !task->removed)
+                load += 1.0 / task->period;
+        }
+
+        if (bestLoad < 0 || load < bestLoad)
+        {
+            best = i;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+void PeriodicScheduler::updatePriorities()
+{
+    if (!m_realTime)
+        return;
+
+    // Rank the distinct periods, shortest first
+    std::vector<boost::int64_t> periods;
+    BOOST_FOREACH(Task* task, m_tasks)
+    {
+        if (!task->removed)
+            periods.push_back(task->period);
+    }
+    std::sort(periods.begin(), periods.end());
+    periods.erase(std::unique(periods.begin(), periods.end()), periods.end());
+
+    int highest = 0;
+    int lowest = 0;
+#ifdef RAM_LINUX
+    highest = sched_get_priority_max(SCHED_FIFO);
+    lowest = sched_get_priority_min(SCHED_FIFO);
+#endif
+
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        // A worker runs at the priority of its most frequent task
+        boost::int64_t shortest = -1;
+        BOOST_FOREACH(Task* task, m_tasks)
+        {
+            if (task->worker == i && !task->removed &&
+                (shortest < 0 || task->period < shortest))
+            {
+                shortest = task->period;
+            }
+        }
+
+        int priority = 0;
+        if (shortest > 0)
+        {
+            int rank = (int)(std::lower_bound(periods.begin(), periods.end(),
+                                              shortest) - periods.begin());
+            priority = std::max(highest - rank, lowest);
+        }
+
+        if (priority != m_workers[i].priority)
+        {
+            m_workers[i].priority = priority;
+            m_workers[i].priorityChanged = true;
+            wakeWorker(i);
+        }
+    }
+}
+
+} // namespace core
+} // namespace ram
@@ -313,6 +313,19 @@ void PythonConfigNodeImp::set(std::string key, int value)
     }
 }
 
+void PythonConfigNodeImp::set(std::string key, double value)
+{
+    try {
+        m_pyobj[key] = py::object(value);
+    } catch(py::error_already_set err) {
+        printf("ConfigNode (set value) at: %s with key: %s Error:\n",
+	       m_debugPath.c_str(), key.c_str());
+        PyErr_Print();
+
+        throw err;
+    }
+}
+
     
 struct null_deleter
 {
@@ -47,6 +47,20 @@ QueuedEventHub::QueuedEventHub(ConfigNode config, SubsystemList deps) :
     m_waitUpdate(false)
 {
     m_imp->setPublishFunction(boost::bind(&QueuedEventHub::_publish, this, _1));
+
+    if (config.exists("CriticalEvents"))
+    {
+        ConfigNode critical(config["CriticalEvents"]);
+        for (size_t i = 0; i < critical.size(); ++i)
+            setNameLane(critical[i].asString(), CRITICAL_LANE);
+    }
+    
+    if (config.exists("LatestEvents"))
+    {
+        ConfigNode latest(config["LatestEvents"]);
+        for (size_t i = 0; i < latest.size(); ++i)
+            setNameLane(latest[i].asString(), LATEST_LANE);
+    }
 }
 
 QueuedEventHub::~QueuedEventHub()
@@ -64,13 +78,42 @@ void QueuedEventHub::publish(EventPtr event)
     m_imp->queueEvent(event);
 }
 
-void QueuedEventHub::publish(Event::EventType etype, EventPtr event)
+void QueuedEventHub::publish(const Event::EventType& etype, EventPtr event)
 {
     event->type = etype;
     event->sender = this;
     publish(event);
 }
     
+EventConnectionPtr QueuedEventHub::subscribeToType(
+    Event::EventType type,
+    boost::function<void (EventPtr)> handler,
+    Lane lane)
+{
+    m_imp->requestTypeLane(type, lane);
+    return EventHub::subscribeToType(type, handler);
+}
+
+void QueuedEventHub::setTypeLane(Event::EventType type, Lane lane)
+{
+    m_imp->setTypeLane(type, lane);
+}
+
+void QueuedEventHub::setNameLane(std::string name, Lane lane)
+{
+    m_imp->setNameLane(name, lane);
+}
+
+QueuedEventHub::Lane QueuedEventHub::getTypeLane(Event::EventType type)
+{
+    return m_imp->getTypeLane(type);
+}
+
+unsigned int QueuedEventHub::getCoalescedCount()
+{
+    return m_imp->getCoalescedCount();
+}
+
 int QueuedEventHub::publishEvents()
 {
     return m_imp->publishEvents();
@@ -9,11 +9,13 @@
 
 // Project Includes
 #include "core/include/QueuedEventHubImp.h"
+#include "core/include/EventTracer.h"
 
 namespace ram {
 namespace core {
 
-QueuedEventHubImp::QueuedEventHubImp()
+QueuedEventHubImp::QueuedEventHubImp() :
+    m_coalesced(0)
 {
 }
 
@@ -24,17 +26,115 @@ void QueuedEventHubImp::setPublishFunction(boost::function<void (EventPtr)> publ
     
 void QueuedEventHubImp::queueEvent(EventPtr event)
 {
-    m_eventQueue.push(event);    
+    boost::int64_t time = 0;
+    if (EventTracer::isEnabled())
+        time = EventTracer::now();
+    QueuedEvent queued(event, time);
+    
+    boost::mutex::scoped_lock lock(m_mutex);
+    LaneMap::iterator lane = findLane(event->type);
+    if ((m_lanes.end() == lane) ||
+        (QueuedEventHub::NORMAL_LANE == lane->second))
+    {
+        m_normal.push_back(queued);
+    }
+    else if (QueuedEventHub::CRITICAL_LANE == lane->second)
+    {
+        m_critical.push_back(queued);
+    }
+    else
+    {
+        // Replace the older event in place, it keeps its turn
+        LatestMap::iterator latest = m_latest.find(event->type);
+        if (m_latest.end() == latest)
+        {
+            m_latest.insert(std::make_pair(event->type, queued));
+            m_latestOrder.push_back(event->type);
+        }
+        else
+        {
+            latest->second = queued;
+            m_coalesced++;
+        }
+    }
+    m_eventQueued.notify_all();
+}
+
+void QueuedEventHubImp::setTypeLane(Event::EventType type,
+                                    QueuedEventHub::Lane lane)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_lanes[type] = lane;
+}
+
+void QueuedEventHubImp::requestTypeLane(Event::EventType type,
+                                        QueuedEventHub::Lane lane)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    LaneMap::iterator iter = findLane(type);
+    if (m_lanes.end() == iter)
+        m_lanes[type] = lane;
+    else if (lane < iter->second)
+        iter->second = lane;
+}
+
+void QueuedEventHubImp::setNameLane(std::string name,
+                                    QueuedEventHub::Lane lane)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_nameLanes[name] = lane;
+    // Let types already seen pick up the new name
+    m_unnamed.clear();
+}
+
+QueuedEventHub::Lane QueuedEventHubImp::getTypeLane(Event::EventType type)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    LaneMap::iterator iter = findLane(type);
+    if (m_lanes.end() == iter)
+        return QueuedEventHub::NORMAL_LANE;
+    return iter->second;
+}
+
+unsigned int QueuedEventHubImp::getCoalescedCount()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_coalesced;
 }
                                    
+QueuedEventHubImp::LaneMap::iterator
+QueuedEventHubImp::findLane(const Event::EventType& type)
+{
+    LaneMap::iterator iter = m_lanes.find(type);
+    if ((m_lanes.end() != iter) || m_nameLanes.empty() ||
+        (m_unnamed.end() != m_unnamed.find(type)))
+    {
+        return iter;
+    }
+
+    // Strip the line number RAM_CORE_EVENT_TYPE puts in front of the name
+    std::string::size_type space = type.find(' ');
+    std::string name(type);
+    if (std::string::npos != space)
+        name = type.substr(space + 1);
+    NameLaneMap::iterator named = m_nameLanes.find(name);
+    if (m_nameLanes.end() == named)
+    {
+        m_unnamed.insert(type);
+        return m_lanes.end();
+    }
+    return m_lanes.insert(std::make_pair(type, named->second)).first;
+}
+
 int QueuedEventHubImp::publishEvents()
 {
-    EventPtr event;
+    QueuedEvent queued;
     int published = 0;
-    
-    while(m_eventQueue.popNoWait(event))
+
+    // One at a time, so a critical event queued by a handler goes next
+    while(pop(queued, false))
     {
-        m_publishFunction(event);
+        publish(queued);
         published++;
     }
     
@@ -44,12 +144,60 @@ int QueuedEventHubImp::publishEvents()
 int QueuedEventHubImp::waitAndPublishEvents()
 {
     // Wait for events and publish the new event
-    EventPtr event = m_eventQueue.popWait();
-    
-    m_publishFunction(event);
+    QueuedEvent queued;
+    pop(queued, true);
+    publish(queued);
     
     return 1 + publishEvents();    
 }
+
+bool QueuedEventHubImp::pop(QueuedEvent& queued, bool wait)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (wait && m_critical.empty() && m_normal.empty() &&
+           m_latestOrder.empty())
+    {
+        m_eventQueued.wait(lock);
+    }
+    
+    if (!m_critical.empty())
+    {
+        queued = m_critical.front();
+        m_critical.pop_front();
+    }
+    else if (!m_normal.empty())
+    {
+        queued = m_normal.front();
+        m_normal.pop_front();
+    }
+    else if (!m_latestOrder.empty())
+    {
+        LatestMap::iterator latest = m_latest.find(m_latestOrder.front());
+        queued = latest->second;
+        m_latest.erase(latest);
+        m_latestOrder.pop_front();
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void QueuedEventHubImp::publish(const QueuedEvent& queued)
+{
+    // Events queued before tracing was enabled have no time
+    if (!EventTracer::isEnabled() || (0 == queued.queued))
+    {
+        m_publishFunction(queued.event);
+        return;
+    }
+
+    boost::int64_t start = EventTracer::now();
+    m_publishFunction(queued.event);
+    EventTracer::recordQueued(queued.event->type, queued.queued, start);
+    EventTracer::recordPublish(queued.event->type, start, EventTracer::now());
+}
     
 } // namespace core
 } // namespace ram
@@ -39,7 +39,8 @@ EventConnectionPtr QueuedEventPublisher::subscribe(
     return asType(m_imp)->subscribe(type, handler);
 }
     
-void QueuedEventPublisher::publish(Event::EventType type, EventPtr event)
+void QueuedEventPublisher::publish(const Event::EventType& type,
+                                   EventPtr event)
 {
     asType(m_imp)->publish(type, type, this, event);
 };
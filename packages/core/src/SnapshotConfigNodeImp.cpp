@@ -0,0 +1,796 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/SnapshotConfigNodeImp.cpp
+ */
+
+// STD Includes
+#include <cstring>
+#include <sstream>
+#include <fstream>
+#include <vector>
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+
+// Project Includes
+#include "core/include/SnapshotConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+// System Includes
+#ifdef RAM_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif // RAM_POSIX
+
+namespace ram {
+namespace core {
+
+// The file is a Header, then the NodeRecords, Entries, buckets and strings
+// it points to, all in the byte order of the machine which wrote it
+
+struct Header
+{
+    char magic[8];
+    boost::uint32_t version;
+    boost::uint32_t root;
+    boost::uint32_t nodeCount;
+    boost::uint32_t entryCount;
+    boost::uint32_t bucketCount;
+    boost::uint32_t stringSize;
+
+    /** Byte offsets of each section from the start of the file */
+    boost::uint32_t nodes;
+    boost::uint32_t entries;
+    boost::uint32_t buckets;
+    boost::uint32_t strings;
+};
+
+struct NodeRecord
+{
+    /** YamlConfigNodeImp::Node::Type */
+    boost::uint32_t type;
+
+    /** YamlConfigNodeImp::ScalarType of a scalar */
+    boost::uint32_t scalarType;
+
+    /** First Entry of a map or sequence, offset of a scalar's text */
+    boost::uint32_t first;
+
+    /** Number of entries, or length of the text */
+    boost::uint32_t count;
+
+    /** First bucket of a map's hash table, its size is a power of two */
+    boost::uint32_t buckets;
+    boost::uint32_t bucketCount;
+
+    boost::int32_t intValue;
+    boost::uint32_t reserved;
+    double doubleValue;
+};
+
+struct Entry
+{
+    /** Key of a map entry, zero for sequences */
+    boost::uint32_t key;
+    boost::uint32_t keyLength;
+    boost::uint32_t hash;
+
+    boost::uint32_t node;
+};
+
+typedef YamlConfigNodeImp::Node Node;
+typedef YamlConfigNodeImp::NodePtr NodePtr;
+
+const char SnapshotConfigNodeImp::MAGIC[8] = {
+    'R', 'A', 'M', 'C', 'F', 'G', '\0', '\0'};
+const boost::uint32_t SnapshotConfigNodeImp::VERSION = 1;
+const boost::uint32_t SnapshotConfigNodeImp::NO_NODE = 0xffffffff;
+
+/** 32 bit FNV-1a */
+static boost::uint32_t hashKey(const char* key, size_t length)
+{
+    boost::uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/** The mapped file, and the values set in front of it */
+class SnapshotConfigNodeImp::Snapshot : boost::noncopyable
+{
+public:
+    Snapshot(std::string filename) :
+        data(0),
+        size(0),
+        header(0),
+        nodes(0),
+        entries(0),
+        buckets(0),
+        strings(0)
+    {
+#ifdef RAM_POSIX
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw ConfigException("Could not open config snapshot: " +
+                                  filename);
+
+        struct stat info;
+        if ((0 == fstat(fd, &info)) && (info.st_size > 0))
+        {
+            size = (size_t)info.st_size;
+            void* mapped = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            data = (MAP_FAILED == mapped) ? 0 : (const char*)mapped;
+        }
+        close(fd);
+#else
+        std::ifstream file(filename.c_str(),
+                           std::ios::in | std::ios::binary);
+        if (!file)
+            throw ConfigException("Could not open config snapshot: " +
+                                  filename);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        copy = ss.str();
+        data = copy.data();
+        size = copy.size();
+#endif // RAM_POSIX
+
+        if (!data || !validate())
+        {
+            unmap();
+            throw ConfigException("Invalid config snapshot: " + filename);
+        }
+    }
+
+    ~Snapshot()
+    {
+        unmap();
+    }
+
+    const NodeRecord& node(boost::uint32_t index)
+    {
+        return nodes[index];
+    }
+
+    const Entry& entry(boost::uint32_t index)
+    {
+        return entries[index];
+    }
+
+    const char* string(boost::uint32_t offset)
+    {
+        return strings + offset;
+    }
+
+    /** Returns the child with the key, or NO_NODE */
+    boost::uint32_t find(boost::uint32_t index, const std::string& key)
+    {
+        const NodeRecord& record = nodes[index];
+        if ((Node::MAP != record.type) || (0 == record.bucketCount))
+            return NO_NODE;
+
+        boost::uint32_t hash = hashKey(key.data(), key.size());
+        boost::uint32_t mask = record.bucketCount - 1;
+        // Bounded, so a table corrupted to have no empty bucket still ends
+        boost::uint32_t probe = hash & mask;
+        for (boost::uint32_t step = 0; step < record.bucketCount; ++step)
+        {
+            boost::uint32_t bucket = buckets[record.buckets + probe];
+            probe = (probe + 1) & mask;
+            if (0 == bucket)
+                return NO_NODE;
+
+            const Entry& candidate = entries[bucket - 1];
+            if ((candidate.hash == hash) &&
+                (candidate.keyLength == key.size()) &&
+                (0 == memcmp(strings + candidate.key, key.data(),
+                             key.size())))
+            {
+                return candidate.node;
+            }
+        }
+        return NO_NODE;
+    }
+
+    /** Returns the value set for the key on the node, or NULL */
+    NodePtr findOverride(boost::uint32_t index, const std::string& key)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if (overrides.empty())
+            return NodePtr();
+
+        OverrideMap::iterator iter = overrides.find(std::make_pair(index, key));
+        if (overrides.end() == iter)
+            return NodePtr();
+        return iter->second;
+    }
+
+    /** Keys set on the node which the file doesn't have */
+    NodeNameList overrideKeys(boost::uint32_t index)
+    {
+        NodeNameList keys;
+        boost::mutex::scoped_lock lock(mutex);
+        OverrideMap::iterator iter =
+            overrides.lower_bound(std::make_pair(index, std::string()));
+        for (; (overrides.end() != iter) && (iter->first.first == index);
+             ++iter)
+        {
+            keys.insert(iter->first.second);
+        }
+        return keys;
+    }
+
+    void setOverride(boost::uint32_t index, const std::string& key,
+                     NodePtr value)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        overrides[std::make_pair(index, key)] = value;
+    }
+
+private:
+    /** Checks every offset in the file, so lookups never have to */
+    bool validate()
+    {
+        if (size < sizeof(Header))
+            return false;
+
+        header = (const Header*)data;
+        if ((0 != memcmp(header->magic, MAGIC, sizeof(MAGIC))) ||
+            (VERSION != header->version))
+        {
+            return false;
+        }
+
+        if (!fits(header->nodes, header->nodeCount, sizeof(NodeRecord)) ||
+            !fits(header->entries, header->entryCount, sizeof(Entry)) ||
+            !fits(header->buckets, header->bucketCount,
+                  sizeof(boost::uint32_t)) ||
+            !fits(header->strings, header->stringSize, 1) ||
+            (0 != (header->nodes % sizeof(double))) ||
+            (header->root >= header->nodeCount))
+        {
+            return false;
+        }
+
+        nodes = (const NodeRecord*)(data + header->nodes);
+        entries = (const Entry*)(data + header->entries);
+        buckets = (const boost::uint32_t*)(data + header->buckets);
+        strings = data + header->strings;
+
+        for (boost::uint32_t i = 0; i < header->nodeCount; ++i)
+        {
+            const NodeRecord& record = nodes[i];
+            if (Node::SCALAR == record.type)
+            {
+                if (!inRange(record.first, record.count, header->stringSize))
+                    return false;
+            }
+            else if ((Node::MAP == record.type) ||
+                     (Node::SEQUENCE == record.type))
+            {
+                if (!inRange(record.first, record.count, header->entryCount))
+                    return false;
+                // Lookups stop at an empty bucket, so there must be one
+                if ((Node::MAP == record.type) &&
+                    ((record.count > 0) || (record.bucketCount > 0)) &&
+                    ((record.bucketCount <= record.count) ||
+                     (0 != (record.bucketCount & (record.bucketCount - 1))) ||
+                     !inRange(record.buckets, record.bucketCount,
+                              header->bucketCount)))
+                {
+                    return false;
+                }
+            }
+            else if (Node::NIL != record.type)
+            {
+                return false;
+            }
+        }
+
+        for (boost::uint32_t i = 0; i < header->entryCount; ++i)
+        {
+            if ((entries[i].node >= header->nodeCount) ||
+                !inRange(entries[i].key, entries[i].keyLength,
+                         header->stringSize))
+            {
+                return false;
+            }
+        }
+
+        for (boost::uint32_t i = 0; i < header->bucketCount; ++i)
+        {
+            if (buckets[i] > header->entryCount)
+                return false;
+        }
+        return true;
+    }
+
+    bool fits(boost::uint32_t offset, boost::uint32_t count, size_t itemSize)
+    {
+        return ((boost::uint64_t)offset + (boost::uint64_t)count * itemSize)
+            <= size;
+    }
+
+    static bool inRange(boost::uint32_t first, boost::uint32_t count,
+                        boost::uint32_t total)
+    {
+        return ((boost::uint64_t)first + count) <= total;
+    }
+
+    void unmap()
+    {
+#ifdef RAM_POSIX
+        if (data)
+            munmap((void*)data, size);
+#endif // RAM_POSIX
+        data = 0;
+    }
+
+    typedef std::map<std::pair<boost::uint32_t, std::string>, NodePtr>
+        OverrideMap;
+
+    const char* data;
+    size_t size;
+#ifndef RAM_POSIX
+    std::string copy;
+#endif // RAM_POSIX
+
+    const Header* header;
+    const NodeRecord* nodes;
+    const Entry* entries;
+    const boost::uint32_t* buckets;
+    const char* strings;
+
+    /** Guards overrides */
+    boost::mutex mutex;
+    OverrideMap overrides;
+
+public:
+    boost::uint32_t root()
+    {
+        return header->root;
+    }
+};
+
+/** Flattens a tree into the sections of a snapshot */
+class SnapshotWriter
+{
+public:
+    std::vector<NodeRecord> nodes;
+    std::vector<Entry> entries;
+    std::vector<boost::uint32_t> buckets;
+    std::string strings;
+
+    boost::uint32_t add(NodePtr node)
+    {
+        boost::uint32_t index = (boost::uint32_t)nodes.size();
+        NodeRecord record;
+        memset(&record, 0, sizeof(record));
+        nodes.push_back(record);
+
+        if (!node || (Node::NIL == node->type))
+        {
+            record.type = Node::NIL;
+        }
+        else if (Node::SCALAR == node->type)
+        {
+            int intValue = 0;
+            double doubleValue = 0;
+            record.type = Node::SCALAR;
+            record.scalarType = YamlConfigNodeImp::resolve(
+                node->text, node->quoted, intValue, doubleValue);
+            record.intValue = intValue;
+            record.doubleValue = doubleValue;
+            record.first = addString(node->text);
+            record.count = (boost::uint32_t)node->text.size();
+        }
+        else
+        {
+            record.type = node->type;
+            record.first = (boost::uint32_t)entries.size();
+            record.count = (boost::uint32_t)node->items.size();
+
+            // Reserve all the entries first, so they are contiguous
+            Entry empty;
+            memset(&empty, 0, sizeof(empty));
+            entries.resize(entries.size() + record.count, empty);
+
+            for (boost::uint32_t i = 0; i < record.count; ++i)
+            {
+                boost::uint32_t child = add(node->items[i]);
+                Entry& entry = entries[record.first + i];
+                entry.node = child;
+                if (Node::MAP == node->type)
+                {
+                    const std::string& key = node->keys[i];
+                    entry.key = addString(key);
+                    entry.keyLength = (boost::uint32_t)key.size();
+                    entry.hash = hashKey(key.data(), key.size());
+                }
+            }
+
+            if ((Node::MAP == node->type) && (record.count > 0))
+                addBuckets(record);
+        }
+
+        nodes[index] = record;
+        return index;
+    }
+
+private:
+    /** Builds a linear probing table at most half full */
+    void addBuckets(NodeRecord& record)
+    {
+        record.bucketCount = 2;
+        while (record.bucketCount < record.count * 2)
+            record.bucketCount *= 2;
+        record.buckets = (boost::uint32_t)buckets.size();
+        buckets.resize(buckets.size() + record.bucketCount, 0);
+
+        boost::uint32_t mask = record.bucketCount - 1;
+        for (boost::uint32_t i = 0; i < record.count; ++i)
+        {
+            boost::uint32_t probe = entries[record.first + i].hash & mask;
+            while (0 != buckets[record.buckets + probe])
+                probe = (probe + 1) & mask;
+            buckets[record.buckets + probe] = record.first + i + 1;
+        }
+    }
+
+    boost::uint32_t addString(const std::string& text)
+    {
+        std::map<std::string, boost::uint32_t>::iterator iter =
+            m_stringOffsets.find(text);
+        if (m_stringOffsets.end() != iter)
+            return iter->second;
+
+        boost::uint32_t offset = (boost::uint32_t)strings.size();
+        strings.append(text);
+        strings.push_back('\0');
+        m_stringOffsets[text] = offset;
+        return offset;
+    }
+
+    std::map<std::string, boost::uint32_t> m_stringOffsets;
+};
+
+ConfigNodeImpPtr SnapshotConfigNodeImp::fromSnapshotFile(std::string filename)
+{
+    SnapshotPtr snapshot(new Snapshot(filename));
+    return ConfigNodeImpPtr(
+        new SnapshotConfigNodeImp(snapshot, snapshot->root(), "ROOT"));
+}
+
+void SnapshotConfigNodeImp::compile(YamlConfigNodeImp::NodePtr root,
+                                    std::string fileName)
+{
+    SnapshotWriter writer;
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.root = writer.add(root);
+
+    header.nodeCount = (boost::uint32_t)writer.nodes.size();
+    header.entryCount = (boost::uint32_t)writer.entries.size();
+    header.bucketCount = (boost::uint32_t)writer.buckets.size();
+    header.stringSize = (boost::uint32_t)writer.strings.size();
+
+    // Every section size is a multiple of the next section's alignment
+    header.nodes = sizeof(Header);
+    header.entries = header.nodes + header.nodeCount * sizeof(NodeRecord);
+    header.buckets = header.entries + header.entryCount * sizeof(Entry);
+    header.strings = header.buckets +
+        header.bucketCount * sizeof(boost::uint32_t);
+
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (!file)
+        throw ConfigException("Could not write config snapshot: " + fileName);
+
+    file.write((const char*)&header, sizeof(header));
+    if (!writer.nodes.empty())
+        file.write((const char*)&writer.nodes[0],
+                   writer.nodes.size() * sizeof(NodeRecord));
+    if (!writer.entries.empty())
+        file.write((const char*)&writer.entries[0],
+                   writer.entries.size() * sizeof(Entry));
+    if (!writer.buckets.empty())
+        file.write((const char*)&writer.buckets[0],
+                   writer.buckets.size() * sizeof(boost::uint32_t));
+    file.write(writer.strings.data(), writer.strings.size());
+
+    if (!file)
+        throw ConfigException("Could not write config snapshot: " + fileName);
+}
+
+void SnapshotConfigNodeImp::compile(std::string yamlFileName,
+                                    std::string fileName)
+{
+    compile(YamlConfigNodeImp::parseFile(yamlFileName), fileName);
+}
+
+SnapshotConfigNodeImp::SnapshotConfigNodeImp(SnapshotPtr snapshot,
+                                             boost::uint32_t node,
+                                             std::string debugPath) :
+    m_snapshot(snapshot),
+    m_node(node),
+    m_debugPath(debugPath)
+{
+}
+
+ConfigNodeImpPtr SnapshotConfigNodeImp::idx(int index)
+{
+    std::stringstream ss;
+    ss << m_debugPath << "[" << index << "]";
+
+    if ((NO_NODE == m_node) || (Node::NIL == m_snapshot->node(m_node).type))
+        return ConfigNodeImpPtr(
+            new SnapshotConfigNodeImp(m_snapshot, NO_NODE, ss.str()));
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if (Node::SEQUENCE != record.type)
+        error("not a sequence");
+
+    // Negative indices count from the end like they do in Python
+    int size = (int)record.count;
+    if (index < 0)
+        index += size;
+    if ((index < 0) || (index >= size))
+        error("index out of range");
+
+    return ConfigNodeImpPtr(new SnapshotConfigNodeImp(
+        m_snapshot, m_snapshot->entry(record.first + index).node, ss.str()));
+}
+
+ConfigNodeImpPtr SnapshotConfigNodeImp::map(std::string key)
+{
+    std::string debugPath(m_debugPath + "." + key);
+    if (NO_NODE == m_node)
+        return ConfigNodeImpPtr(
+            new SnapshotConfigNodeImp(m_snapshot, NO_NODE, debugPath));
+
+    NodePtr value = m_snapshot->findOverride(m_node, key);
+    if (value)
+        return ConfigNodeImpPtr(new YamlConfigNodeImp(value, debugPath));
+
+    return ConfigNodeImpPtr(new SnapshotConfigNodeImp(
+        m_snapshot, m_snapshot->find(m_node, key), debugPath));
+}
+
+std::string SnapshotConfigNodeImp::asString()
+{
+    if (NO_NODE == m_node)
+        return "None";
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if (Node::NIL == record.type)
+        return "None";
+    if (Node::SCALAR != record.type)
+        return toString();
+
+    switch (record.scalarType)
+    {
+        case YamlConfigNodeImp::NONE:
+            return "None";
+        case YamlConfigNodeImp::BOOL:
+            return record.intValue ? "True" : "False";
+        case YamlConfigNodeImp::INT:
+            return boost::lexical_cast<std::string>(record.intValue);
+        default:
+            return std::string(m_snapshot->string(record.first),
+                               record.count);
+    }
+}
+
+std::string SnapshotConfigNodeImp::asString(const std::string& def)
+{
+    if (NO_NODE == m_node)
+        return def;
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if ((Node::NIL == record.type) ||
+        ((Node::SCALAR == record.type) &&
+         (YamlConfigNodeImp::NONE == record.scalarType)))
+    {
+        return def;
+    }
+    return asString();
+}
+
+double SnapshotConfigNodeImp::asDouble()
+{
+    if ((NO_NODE == m_node) ||
+        (Node::SCALAR != m_snapshot->node(m_node).type))
+    {
+        error("can't convert to double");
+    }
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if ((YamlConfigNodeImp::NONE == record.scalarType) ||
+        (YamlConfigNodeImp::STRING == record.scalarType))
+    {
+        error("can't convert '" + asString() + "' to double");
+    }
+    return record.doubleValue;
+}
+
+double SnapshotConfigNodeImp::asDouble(const double def)
+{
+    if (NO_NODE == m_node)
+        return def;
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if ((Node::SCALAR != record.type) ||
+        (YamlConfigNodeImp::NONE == record.scalarType) ||
+        (YamlConfigNodeImp::STRING == record.scalarType))
+    {
+        return def;
+    }
+    return record.doubleValue;
+}
+
+int SnapshotConfigNodeImp::asInt()
+{
+    if ((NO_NODE == m_node) ||
+        (Node::SCALAR != m_snapshot->node(m_node).type))
+    {
+        error("can't convert to int");
+    }
+
+    // Floats don't convert, just like through Python
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if ((YamlConfigNodeImp::INT != record.scalarType) &&
+        (YamlConfigNodeImp::BOOL != record.scalarType))
+    {
+        error("can't convert '" + asString() + "' to int");
+    }
+    return record.intValue;
+}
+
+int SnapshotConfigNodeImp::asInt(const int def)
+{
+    if (NO_NODE == m_node)
+        return def;
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if ((Node::SCALAR != record.type) ||
+        ((YamlConfigNodeImp::INT != record.scalarType) &&
+         (YamlConfigNodeImp::BOOL != record.scalarType)))
+    {
+        return def;
+    }
+    return record.intValue;
+}
+
+NodeNameList SnapshotConfigNodeImp::subNodes()
+{
+    NodeNameList subnodes;
+    if (NO_NODE == m_node)
+        return subnodes;
+
+    const NodeRecord& record = m_snapshot->node(m_node);
+    if (Node::MAP != record.type)
+        return subnodes;
+
+    for (boost::uint32_t i = 0; i < record.count; ++i)
+    {
+        const Entry& entry = m_snapshot->entry(record.first + i);
+        subnodes.insert(std::string(m_snapshot->string(entry.key),
+                                    entry.keyLength));
+    }
+
+    NodeNameList overrides = m_snapshot->overrideKeys(m_node);
+    subnodes.insert(overrides.begin(), overrides.end());
+    return subnodes;
+}
+
+size_t SnapshotConfigNodeImp::size()
+{
+    if (NO_NODE != m_node)
+    {
+        const NodeRecord& record = m_snapshot->node(m_node);
+        if (Node::MAP == record.type)
+            return subNodes().size();
+        else if ((Node::SEQUENCE == record.type) ||
+                 ((Node::SCALAR == record.type) &&
+                  (YamlConfigNodeImp::STRING == record.scalarType)))
+            return record.count;
+    }
+
+    error("has no size");
+    return 0;
+}
+
+void SnapshotConfigNodeImp::set(std::string key, std::string str)
+{
+    if ((NO_NODE == m_node) || (Node::MAP != m_snapshot->node(m_node).type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr value(new Node(Node::SCALAR));
+    value->text = str;
+    value->quoted = true;
+    m_snapshot->setOverride(m_node, key, value);
+}
+
+void SnapshotConfigNodeImp::set(std::string key, int value)
+{
+    if ((NO_NODE == m_node) || (Node::MAP != m_snapshot->node(m_node).type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr node(new Node(Node::SCALAR));
+    node->text = boost::lexical_cast<std::string>(value);
+    m_snapshot->setOverride(m_node, key, node);
+}
+
+void SnapshotConfigNodeImp::set(std::string key, double value)
+{
+    if ((NO_NODE == m_node) || (Node::MAP != m_snapshot->node(m_node).type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr node(new Node(Node::SCALAR));
+    node->text = boost::lexical_cast<std::string>(value);
+    m_snapshot->setOverride(m_node, key, node);
+}
+
+std::string SnapshotConfigNodeImp::toString()
+{
+    return YamlConfigNodeImp::toString(toYamlNode(m_node));
+}
+
+void SnapshotConfigNodeImp::writeToFile(std::string fileName, bool silent)
+{
+    YamlConfigNodeImp::writeToFile(toYamlNode(m_node), fileName, silent);
+}
+
+void SnapshotConfigNodeImp::error(std::string message)
+{
+    throw ConfigException("ConfigNode \"" + m_debugPath + "\": " + message);
+}
+
+YamlConfigNodeImp::NodePtr SnapshotConfigNodeImp::toYamlNode(
+    boost::uint32_t index)
+{
+    if (NO_NODE == index)
+        return NodePtr(new Node());
+
+    const NodeRecord& record = m_snapshot->node(index);
+    NodePtr node(new Node((Node::Type)record.type));
+    if (Node::SCALAR == record.type)
+    {
+        node->text = std::string(m_snapshot->string(record.first),
+                                 record.count);
+        node->quoted = (YamlConfigNodeImp::STRING == record.scalarType);
+        return node;
+    }
+
+    for (boost::uint32_t i = 0; i < record.count; ++i)
+    {
+        const Entry& entry = m_snapshot->entry(record.first + i);
+        NodePtr child = toYamlNode(entry.node);
+        if (Node::MAP == record.type)
+            node->insert(std::string(m_snapshot->string(entry.key),
+                                     entry.keyLength), child);
+        else
+            node->items.push_back(child);
+    }
+
+    if (Node::MAP == record.type)
+    {
+        BOOST_FOREACH(std::string key, m_snapshot->overrideKeys(index))
+        {
+            node->insert(key, m_snapshot->findOverride(index, key));
+        }
+    }
+    return node;
+}
+
+} // namespace core
+} // namespace ram
@@ -25,6 +25,7 @@
 
 // Project Includes
 #include "core/include/TimeVal.h"
+#include "core/include/Clock.h"
 
 // On windows we need our own gettimeofday
 #ifdef RAM_WINDOWS
@@ -133,7 +134,9 @@ TimeVal TimeVal::timeOfDay()
     
 void TimeVal::now()
 {
-    gettimeofday(time_val(), NULL);
+    boost::int64_t usec = Clock::timeOfDay();
+    timeval_.tv_sec = (long)(usec / USEC_PER_SEC);
+    timeval_.tv_usec = (long)(usec % USEC_PER_SEC);
 }
     
 void TimeVal::sleep(double seconds)
@@ -143,18 +146,8 @@ void TimeVal::sleep(double seconds)
     
 void TimeVal::sleep(const TimeVal& duration)
 {
-#ifdef RAM_POSIX
-    struct timespec sleep = {0, 0};
-    struct timespec act_sleep = {0, 0};
-
-    sleep.tv_sec = duration.seconds();
-    sleep.tv_nsec = duration.microseconds() * 1000;
-    
-    nanosleep(&sleep, &act_sleep);  
-#else
-    long milliseconds = duration.get_double() / 1000;
-    Sleep(milliseconds);
-#endif
+    Clock::sleep((boost::int64_t)duration.seconds() * USEC_PER_SEC +
+                 duration.microseconds());
 }
     
 inline bool
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/TimingStats.cpp
+ */
+
+// STD Includes
+#include <cassert>
+
+// Project Includes
+#include "core/include/TimingStats.h"
+
+namespace ram {
+namespace core {
+
+TimingStats::TimingStats()
+{
+    reset();
+}
+
+void TimingStats::reset()
+{
+    m_updates = 0;
+    m_deadlineMisses = 0;
+    m_totalJitter = 0;
+    m_maxJitter = 0;
+    m_totalRunTime = 0;
+    m_maxRunTime = 0;
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        m_jitter[i] = 0;
+        m_misses[i] = 0;
+    }
+}
+
+void TimingStats::record(boost::int64_t jitter, boost::int64_t runTime,
+                         boost::int64_t overrun)
+{
+    if (jitter < 0)
+        jitter = 0;
+
+    m_updates++;
+    m_totalJitter += jitter;
+    m_totalRunTime += runTime;
+    if (jitter > m_maxJitter)
+        m_maxJitter = jitter;
+    if (runTime > m_maxRunTime)
+        m_maxRunTime = runTime;
+    m_jitter[getBucket(jitter)]++;
+
+    if (overrun > 0)
+    {
+        m_deadlineMisses++;
+        m_misses[getBucket(overrun)]++;
+    }
+}
+
+void TimingStats::merge(const TimingStats& other)
+{
+    m_updates += other.m_updates;
+    m_deadlineMisses += other.m_deadlineMisses;
+    m_totalJitter += other.m_totalJitter;
+    m_totalRunTime += other.m_totalRunTime;
+    if (other.m_maxJitter > m_maxJitter)
+        m_maxJitter = other.m_maxJitter;
+    if (other.m_maxRunTime > m_maxRunTime)
+        m_maxRunTime = other.m_maxRunTime;
+    for (int i = 0; i < BUCKETS; ++i)
+    {
+        m_jitter[i] += other.m_jitter[i];
+        m_misses[i] += other.m_misses[i];
+    }
+}
+
+double TimingStats::getMeanJitter() const
+{
+    if (0 == m_updates)
+        return 0;
+    return (double)m_totalJitter / m_updates;
+}
+
+double TimingStats::getMeanRunTime() const
+{
+    if (0 == m_updates)
+        return 0;
+    return (double)m_totalRunTime / m_updates;
+}
+
+unsigned int TimingStats::getJitterCount(int bucket) const
+{
+    assert(bucket >= 0 && bucket < BUCKETS && "Invalid bucket");
+    return m_jitter[bucket];
+}
+
+unsigned int TimingStats::getMissCount(int bucket) const
+{
+    assert(bucket >= 0 && bucket < BUCKETS && "Invalid bucket");
+    return m_misses[bucket];
+}
+
+boost::int64_t TimingStats::getJitterPercentile(double fraction) const
+{
+    if (0 == m_updates)
+        return -1;
+
+    unsigned int needed = (unsigned int)(fraction * m_updates + 0.5);
+    unsigned int count = 0;
+    for (int i = 0; i < BUCKETS - 1; ++i)
+    {
+        count += m_jitter[i];
+        if (count >= needed)
+            return getBucketLimit(i);
+    }
+    return m_maxJitter;
+}
+
+boost::int64_t TimingStats::getBucketLimit(int bucket)
+{
+    assert(bucket >= 0 && bucket < BUCKETS && "Invalid bucket");
+    if (BUCKETS - 1 == bucket)
+        return -1;
+    return ((boost::int64_t)1) << bucket;
+}
+
+int TimingStats::getBucket(boost::int64_t usec)
+{
+    int bucket = 0;
+    while (usec > 0 && bucket < BUCKETS - 1)
+    {
+        usec >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+} // namespace core
+} // namespace ram
@@ -21,6 +21,8 @@
 #include "core/include/TimeVal.h"
 #include "core/include/Events.h"
 #include "core/include/Updatable.h"
+#include "core/include/PeriodicScheduler.h"
+#include "core/include/Clock.h"
 
 // System Includes
 #ifdef RAM_POSIX
@@ -47,11 +49,10 @@
 #include <iostream>
 
 const static long USEC_PER_MILLISEC = 1000;
-const static long NSEC_PER_MILLISEC = 1000000;
 const static long NSEC_PER_USEC = 1000;
 
-// How close do we try to get to actual sleep time (in usec)
-const static long SLEEP_THRESHOLD = 500;
+// How often timing is published under IUpdatable::PROFILE (in usec)
+const static boost::int64_t PROFILE_PERIOD = 1000000;
 
 static int HIGH_PRIORITY_VALUE = 0;
 static int NORMAL_PRIORITY_VALUE = 0;
@@ -67,75 +68,6 @@ namespace core {
 
 typedef boost::int64_t Usec;
 
-// Adapted from the avahi library, under LPGL
-int timeval_compare(const struct timeval *a, const struct timeval *b) {
-    assert(a);
-    assert(b);
-
-    if (a->tv_sec < b->tv_sec)
-        return -1;
-
-    if (a->tv_sec > b->tv_sec)
-        return 1;
-
-    if (a->tv_usec < b->tv_usec)
-        return -1;
-
-    if (a->tv_usec > b->tv_usec)
-        return 1;
-
-    return 0;
-}
-
-Usec timeval_diff(const struct timeval *a, const struct timeval *b) {
-    assert(a);
-    assert(b);
-
-    if (timeval_compare(a, b) < 0)
-        return - timeval_diff(b, a);
-
-    return ((Usec) a->tv_sec - b->tv_sec)*1000000 + a->tv_usec - b->tv_usec;
-}
-
-struct timeval* timeval_add(struct timeval *a, Usec usec) {
-    Usec u;
-    assert(a);
-
-    u = usec + a->tv_usec;
-
-    if (u < 0) {
-        a->tv_usec = (long) (1000000 + (u % 1000000));
-        a->tv_sec += (long) (-1 + (u / 1000000));
-    } else {
-        a->tv_usec = (long) (u % 1000000);
-        a->tv_sec += (long) (u / 1000000);
-    }
-
-    return a;
-}
-
-Usec age(const struct timeval *a) {
-    struct timeval now;
-    
-    assert(a);
-
-    gettimeofday(&now, NULL);
-
-    return timeval_diff(&now, a);
-}
-
-struct timeval *elapse_time(struct timeval *tv, unsigned msec) {
-    assert(tv);
-
-    gettimeofday(tv, NULL);
-
-    if (msec)
-        timeval_add(tv, (Usec) msec*1000);
-        
-    return tv;
-}
-
-    
 Updatable::Updatable(EventPublisher *publisher) :
     m_backgrounded(0),
     m_interval(100),
@@ -145,14 +77,19 @@ Updatable::Updatable(EventPublisher *publisher) :
     m_settingChange(0),
     m_backgroundThread(0),
     m_threadStopped(1),
+    m_scheduler(0),
     m_publisher(publisher),
-    m_profileCount(0)
+    m_lastProfile(0)
 {
     initThreadingSettings();
 }
 
 Updatable::~Updatable()
 {
+    // Make sure no scheduler still has a pointer to us
+    if (m_scheduler)
+        m_scheduler->remove(this, true);
+    
     // Join and delete background thread if its still running
     cleanUpBackgroundThread();
 }
@@ -221,6 +158,12 @@ void Updatable::setPriority(Priority priority)
         // Set priority change flag
         m_settingChange |= PRIORITY;
     }
+
+    if (m_scheduler)
+    {
+        fprintf(stderr, "WARNING: priority of a scheduled Updatable is set "
+                "by its PeriodicScheduler, setPriority has no effect\n");
+    }
 }
 
 Updatable::Priority Updatable::getPriority()
@@ -246,23 +189,61 @@ int Updatable::getAffinity()
      
 void Updatable::background(int interval)
 {
+    PeriodicScheduler* scheduler = 0;
+    if (interval > 0)
+        scheduler = PeriodicScheduler::getDefault();
+    
     bool startThread = false;
+    PeriodicScheduler* oldScheduler = 0;
+    int affinity = -1;
+    bool warnPriority = false;
 
     {
         boost::mutex::scoped_lock lock(m_upStateMutex);
 
         // Set state
         m_interval = interval;
+        affinity = m_affinity;
 
         // Only start up the background thread if we aren't already
-        // running
+        // running, once running a thread stays a thread, but a scheduled
+        // task can't run all out so it moves to its own thread
         if (!m_backgrounded)
         {
-            startThread = true;
             m_backgrounded = true;
+            m_scheduler = scheduler;
+            startThread = !scheduler;
+            warnPriority = scheduler && (NORMAL_PRIORITY != m_priority);
+            
+            boost::mutex::scoped_lock statsLock(m_statsMutex);
+            m_stats.reset();
+            m_profileStats.reset();
+            m_lastProfile = Clock::monotonicTime();
+        }
+        else if (m_scheduler && !scheduler)
+        {
+            oldScheduler = m_scheduler;
+            m_scheduler = 0;
+            startThread = true;
+        }
+        else
+        {
+            scheduler = m_scheduler;
         }
     }
 
+    if (oldScheduler)
+        oldScheduler->remove(this, true);
+
+    if (warnPriority)
+    {
+        fprintf(stderr, "WARNING: scheduling an Updatable with a non default "
+                "priority, its PeriodicScheduler sets the priority instead\n");
+    }
+
+    if (scheduler)
+        scheduler->add(this, interval, affinity);
+
     if (startThread)
     {
         // Join and delete background thread if it exists, if it does exist
@@ -285,6 +266,8 @@ void Updatable::background(int interval)
 
 void Updatable::unbackground(bool join)
 {
+    PeriodicScheduler* scheduler = 0;
+    
     {
         boost::mutex::scoped_lock lock(m_upStateMutex);
 
@@ -295,8 +278,13 @@ void Updatable::unbackground(bool join)
         // The run loop check this value to determine whether it should keep
         // running, next loop through it will stop.
         m_backgrounded = false;
+        scheduler = m_scheduler;
+        m_scheduler = 0;
     }
 
+    if (scheduler)
+        scheduler->remove(this, join);
+
     // Wait for background thread to stop runnig and the delete it
     if (join)
         cleanUpBackgroundThread();
@@ -308,6 +296,12 @@ bool Updatable::backgrounded()
     return m_backgrounded;
 }
 
+TimingStats Updatable::getTimingStats()
+{
+    boost::mutex::scoped_lock lock(m_statsMutex);
+    return m_stats;
+}
+
 void Updatable::getState(bool& backgrounded, int& interval)
 {
     boost::mutex::scoped_lock lock(m_upStateMutex);
@@ -317,30 +311,12 @@ void Updatable::getState(bool& backgrounded, int& interval)
     
 void Updatable::loop()
 {
-    struct timeval last;
-    struct timeval start;
-    struct timeval profile; // last time a profile update happened
-    Usec sleep_time;
-    Usec offset;
-
-    // This call determines the time it takes for a gettimeofday call
-    // This makes the calls more accurate
-    gettimeofday(&last, NULL);
-    gettimeofday(&start, NULL);
-    offset = timeval_diff(&start, &last);
-
-    // Get time of day for profiling
-    gettimeofday(&profile, NULL);
-    m_profileCount = 0;
-
-    // Zero last so we can check
-    last.tv_usec = 0;
+    // All times are absolute on the monotonic clock, in usec
+    Usec last = 0;
+    Usec release = Clock::monotonicTime();
     
     while (1)
     {
-        // Grab current time
-        gettimeofday(&start, NULL);
-
         // Grab our running state
         bool in_background = false;
         int interval = 10;
@@ -360,52 +336,45 @@ void Updatable::loop()
         
         if (in_background)
         {
+            // Grab current time
+            Usec start = Clock::monotonicTime();
+            
             // On the first loop through, set the step to ideal
             double diff = (double)(interval *(double)1000);
-            if (0 != last.tv_usec)
-                diff = (double)(timeval_diff(&start, &last) + offset);
-
-            // Record time for next run 
-            last = start;
+            if (0 != last)
+                diff = (double)(start - last);
             
             // Call our update function
             update(diff / (double)1000000);
-            m_profileCount += 1;
-
-            Usec profile_time = timeval_diff(&last, &profile);
-            // If 1 second has passed since the last profile, publish and reset
-            if (profile_time > 1000000)
-            {
-                if (m_publisher) {
-                    IntEventPtr event(new IntEvent());
-                    event->data = m_profileCount;
-                    m_publisher->publish(IUpdatable::PROFILE, event);
-                }
-                profile = last;
-                m_profileCount = 0;
-            }
+            Usec end = Clock::monotonicTime();
 
             // Only sleep if we aren't running all out
             if (interval > 0)
             {
-                // Determine next time to awake
-                struct timeval next = start;
-                timeval_add(&next, (Usec)interval * USEC_PER_MILLISEC);
-            
-                // Sleep for the rest for the remainder of our time
-                sleep_time = -age(&next);
-
-                // Handle overrun
-                if (sleep_time < 0)
-                    sleep_time = interval * USEC_PER_MILLISEC;
-
-                // If the wait ends early keep waiting
-                while(sleep_time > SLEEP_THRESHOLD)
-                {
-                    waitForUpdate((long)sleep_time);
-                    sleep_time = -age(&next);
-                }
+                Usec period = (Usec)interval * USEC_PER_MILLISEC;
+                Usec deadline = release + period;
+
+                // The first release is just when we started
+                if (0 != last)
+                    recordUpdate(start - release, end - start, end - deadline);
+
+                // Keep the phase, skipping any whole periods that were missed
+                release = deadline;
+                if (end > deadline)
+                    release += ((end - deadline) / period) * period;
+
+                // Sleep till the absolute release time, so the time taken by
+                // update does not add up
+                Clock::sleepUntil(release);
+            }
+            else
+            {
+                recordUpdate(0, end - start, -1);
+                release = end;
             }
+            
+            // Record time for next run 
+            last = start;
         }
         // Time to quit
         else
@@ -431,6 +400,41 @@ void Updatable::waitForUpdate(long microseconds)
 #endif
 }
     
+void Updatable::recordUpdate(boost::int64_t jitter, boost::int64_t runTime,
+                             boost::int64_t overrun)
+{
+    TimingStats profile;
+    bool publish = false;
+    
+    {
+        boost::mutex::scoped_lock lock(m_statsMutex);
+        m_stats.record(jitter, runTime, overrun);
+        m_profileStats.record(jitter, runTime, overrun);
+
+        // If 1 second has passed since the last profile, publish and reset
+        Usec now = Clock::monotonicTime();
+        if (now - m_lastProfile > PROFILE_PERIOD)
+        {
+            profile = m_profileStats;
+            publish = true;
+            m_profileStats.reset();
+            m_lastProfile = now;
+        }
+    }
+
+    if (publish && m_publisher)
+    {
+        ProfileEventPtr event(new ProfileEvent());
+        event->data = profile.getUpdates();
+        event->deadlineMisses = profile.getDeadlineMisses();
+        event->meanJitter = profile.getMeanJitter();
+        event->maxJitter = (double)profile.getMaxJitter();
+        event->jitter99 = (double)profile.getJitterPercentile(0.99);
+        event->maxRunTime = (double)profile.getMaxRunTime();
+        m_publisher->publish(IUpdatable::PROFILE, event);
+    }
+}
+    
 void Updatable::cleanUpBackgroundThread()
 {
     boost::mutex::scoped_lock lock(m_threadStateMutex);
@@ -0,0 +1,1225 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/YamlConfigNodeImp.cpp
+ */
+
+#ifdef RAM_WINDOWS
+#define _CRT_SECURE_NO_WARNINGS // turn off warning about getenv
+#endif
+
+// STD Includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <fstream>
+
+// Library Includes
+#include <boost/foreach.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+// Project Includes
+#include "core/include/YamlConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+namespace ram {
+namespace core {
+
+/** Turns YAML text into a YamlConfigNodeImp::Node tree
+ *
+ *  The block structure is handled line by line, flow collections and
+ *  scalars character by character.  A flow collection which spans several
+ *  lines is joined into one line first.
+ */
+class YamlParser
+{
+public:
+    typedef YamlConfigNodeImp::Node Node;
+    typedef YamlConfigNodeImp::NodePtr NodePtr;
+
+    YamlParser(const std::string& text, std::string source) :
+        m_source(source),
+        m_lineNumber(0)
+    {
+        splitLines(text);
+    }
+
+    NodePtr parse()
+    {
+        size_t i = 0;
+        if (m_lines.empty())
+            return NodePtr(new Node());
+
+        NodePtr root = parseBlock(i, m_lines[0].indent);
+        if (i < m_lines.size())
+        {
+            m_lineNumber = m_lines[i].number;
+            error("unexpected text '" + m_lines[i].text + "'");
+        }
+        return root;
+    }
+
+private:
+    struct Line
+    {
+        int indent;
+        std::string text;
+        int number;
+    };
+
+    /** Breaks the text into lines, removing comments and blank lines */
+    void splitLines(const std::string& text)
+    {
+        std::istringstream in(text);
+        std::string raw;
+        int number = 0;
+        int depth = 0;
+        Line* joining = 0;
+
+        while (std::getline(in, raw))
+        {
+            number++;
+            m_lineNumber = number;
+            if (!raw.empty() && ('\r' == raw[raw.size() - 1]))
+                raw.erase(raw.size() - 1);
+
+            size_t indent = raw.find_first_not_of(' ');
+            if (std::string::npos == indent)
+                continue;
+            if ('\t' == raw[indent])
+                error("tabs can't be used for indentation");
+
+            std::string content = trim(stripComment(raw.substr(indent),
+                                                    depth));
+            if (content.empty())
+                continue;
+
+            if (joining)
+            {
+                // Still inside a flow collection from an earlier line
+                joining->text += " " + content;
+            }
+            else
+            {
+                if ((content == "---") || (content == "..."))
+                    continue;
+
+                Line line;
+                line.indent = (int)indent;
+                line.text = content;
+                line.number = number;
+                m_lines.push_back(line);
+            }
+
+            joining = (depth > 0) ? &m_lines.back() : 0;
+        }
+
+        if (depth > 0)
+            error("unterminated flow collection");
+    }
+
+    /** Removes any comment, and tracks how deep in flow collections the
+     *  end of the line is.  Like pyyaml, a '#' starts a comment after
+     *  whitespace, a closing quote or a flow indicator, but is part of a
+     *  plain scalar anywhere else. */
+    std::string stripComment(const std::string& text, int& depth)
+    {
+        char quote = 0;
+        bool separated = true;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            char c = text[i];
+            if (quote)
+            {
+                if (('\\' == c) && ('"' == quote))
+                    i++;
+                else if (c == quote)
+                {
+                    // Two single quotes is an escaped quote
+                    if (('\'' == c) && (i + 1 < text.size()) &&
+                        ('\'' == text[i + 1]))
+                    {
+                        i++;
+                    }
+                    else
+                    {
+                        quote = 0;
+                        separated = true;
+                    }
+                }
+                continue;
+            }
+
+            if (('#' == c) && separated)
+                return text.substr(0, i);
+
+            bool tokenStart = (0 == i) || isTokenBreak(text[i - 1]);
+            bool indicator = false;
+            if ((('\'' == c) || ('"' == c)) && tokenStart)
+            {
+                quote = c;
+            }
+            else if ((('[' == c) || ('{' == c)) && (tokenStart || depth > 0))
+            {
+                depth++;
+                indicator = true;
+            }
+            else if (((']' == c) || ('}' == c) || (',' == c)) && (depth > 0))
+            {
+                if (',' != c)
+                    depth--;
+                indicator = true;
+            }
+            separated = indicator || (' ' == c) || ('\t' == c);
+        }
+        return text;
+    }
+
+    static bool isTokenBreak(char c)
+    {
+        return (' ' == c) || ('[' == c) || ('{' == c) || (',' == c) ||
+            (':' == c) || ('-' == c);
+    }
+
+    static std::string trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(' ');
+        if (std::string::npos == begin)
+            return "";
+        size_t end = text.find_last_not_of(' ');
+        return text.substr(begin, end - begin + 1);
+    }
+
+    static bool isSequenceItem(const std::string& text)
+    {
+        return (text == "-") || (0 == text.compare(0, 2, "- "));
+    }
+
+    /** Returns the position of the ':' ending a mapping key, or npos */
+    static size_t findKeyEnd(const std::string& text)
+    {
+        if (text.empty() || ('[' == text[0]) || ('{' == text[0]))
+            return std::string::npos;
+
+        char quote = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            char c = text[i];
+            if (quote)
+            {
+                if (('\\' == c) && ('"' == quote))
+                    i++;
+                else if (c == quote)
+                    quote = 0;
+            }
+            else if ((('\'' == c) || ('"' == c)) && (0 == i))
+            {
+                quote = c;
+            }
+            else if ((':' == c) &&
+                     ((i + 1 == text.size()) || (' ' == text[i + 1])))
+            {
+                return i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    /** Parses the block starting at line i, which is at the given indent */
+    NodePtr parseBlock(size_t& i, int indent)
+    {
+        const Line& line = m_lines[i];
+        m_lineNumber = line.number;
+
+        if (isSequenceItem(line.text))
+            return parseSequence(i, indent);
+        else if (std::string::npos != findKeyEnd(line.text))
+            return parseMap(i, indent);
+
+        i++;
+        return parseInline(line.text);
+    }
+
+    NodePtr parseMap(size_t& i, int indent)
+    {
+        NodePtr map(new Node(Node::MAP));
+
+        while ((i < m_lines.size()) && (m_lines[i].indent == indent) &&
+               !isSequenceItem(m_lines[i].text))
+        {
+            const Line line = m_lines[i];
+            m_lineNumber = line.number;
+
+            size_t keyEnd = findKeyEnd(line.text);
+            if (std::string::npos == keyEnd)
+                error("expected a key in '" + line.text + "'");
+
+            NodePtr keyNode = parseInline(trim(line.text.substr(0, keyEnd)));
+            std::string rest(trim(line.text.substr(keyEnd + 1)));
+            NodePtr value;
+            i++;
+
+            if (!rest.empty())
+            {
+                value = parseInline(rest);
+            }
+            else if ((i < m_lines.size()) && (m_lines[i].indent > indent))
+            {
+                value = parseBlock(i, m_lines[i].indent);
+            }
+            else if ((i < m_lines.size()) && (m_lines[i].indent == indent) &&
+                     isSequenceItem(m_lines[i].text))
+            {
+                // A sequence may sit at the same indent as its key
+                value = parseSequence(i, indent);
+            }
+            else
+            {
+                value = NodePtr(new Node());
+            }
+
+            map->insert(keyNode->text, value);
+        }
+
+        checkDedent(i, indent);
+        return map;
+    }
+
+    NodePtr parseSequence(size_t& i, int indent)
+    {
+        NodePtr sequence(new Node(Node::SEQUENCE));
+
+        while ((i < m_lines.size()) && (m_lines[i].indent == indent) &&
+               isSequenceItem(m_lines[i].text))
+        {
+            Line& line = m_lines[i];
+            m_lineNumber = line.number;
+
+            size_t offset = line.text.find_first_not_of(' ', 1);
+            if (std::string::npos == offset)
+            {
+                // The item is the block on the following lines
+                i++;
+                if ((i < m_lines.size()) && (m_lines[i].indent > indent))
+                    sequence->items.push_back(
+                        parseBlock(i, m_lines[i].indent));
+                else
+                    sequence->items.push_back(NodePtr(new Node()));
+                continue;
+            }
+
+            std::string rest(line.text.substr(offset));
+            if (isSequenceItem(rest) ||
+                (std::string::npos != findKeyEnd(rest)))
+            {
+                // A nested block starting on this line ("- key: value"), the
+                // rest of it lines up with the text after the dash
+                line.indent += (int)offset;
+                line.text = rest;
+                sequence->items.push_back(parseBlock(i, line.indent));
+            }
+            else
+            {
+                i++;
+                sequence->items.push_back(parseInline(rest));
+            }
+        }
+
+        checkDedent(i, indent);
+        return sequence;
+    }
+
+    /** Makes sure the next line does not continue a finished block */
+    void checkDedent(size_t i, int indent)
+    {
+        if ((i < m_lines.size()) && (m_lines[i].indent > indent))
+        {
+            m_lineNumber = m_lines[i].number;
+            error("bad indentation of '" + m_lines[i].text + "'");
+        }
+    }
+
+    /** Parses a value which sits on one line */
+    NodePtr parseInline(const std::string& text)
+    {
+        if (text.empty())
+            return NodePtr(new Node());
+        
+        char first = text[0];
+        if (('|' == first) || ('>' == first) || ('&' == first) ||
+            ('*' == first) || ('!' == first))
+        {
+            error("unsupported YAML feature in '" + text + "'");
+        }
+
+        if (('[' == first) || ('{' == first) || ('\'' == first) ||
+            ('"' == first))
+        {
+            size_t pos = 0;
+            NodePtr node = parseFlow(text, pos);
+            skipSpaces(text, pos);
+            if (pos != text.size())
+                error("unexpected text after '" + text.substr(0, pos) + "'");
+            return node;
+        }
+
+        NodePtr scalar(new Node(Node::SCALAR));
+        scalar->text = text;
+        return scalar;
+    }
+
+    NodePtr parseFlow(const std::string& text, size_t& pos)
+    {
+        skipSpaces(text, pos);
+        if (pos >= text.size())
+            error("unexpected end of line");
+
+        char c = text[pos];
+        if ('[' == c)
+        {
+            NodePtr sequence(new Node(Node::SEQUENCE));
+            pos++;
+            while (!endOfFlow(text, pos, ']'))
+                sequence->items.push_back(parseFlow(text, pos));
+            return sequence;
+        }
+        else if ('{' == c)
+        {
+            NodePtr map(new Node(Node::MAP));
+            pos++;
+            while (!endOfFlow(text, pos, '}'))
+            {
+                NodePtr key = parseFlow(text, pos);
+                skipSpaces(text, pos);
+                NodePtr value;
+                if ((pos < text.size()) && (':' == text[pos]))
+                {
+                    pos++;
+                    skipSpaces(text, pos);
+                    if ((pos < text.size()) &&
+                        ((',' == text[pos]) || ('}' == text[pos])))
+                        value = NodePtr(new Node());
+                    else
+                        value = parseFlow(text, pos);
+                }
+                else
+                {
+                    value = NodePtr(new Node());
+                }
+                map->insert(key->text, value);
+            }
+            return map;
+        }
+        else if (('\'' == c) || ('"' == c))
+        {
+            NodePtr scalar(new Node(Node::SCALAR));
+            scalar->quoted = true;
+            scalar->text = parseQuoted(text, pos);
+            return scalar;
+        }
+
+        // Plain scalar, up to the next flow indicator
+        size_t begin = pos;
+        while (pos < text.size())
+        {
+            char next = text[pos];
+            if ((',' == next) || (']' == next) || ('}' == next))
+                break;
+            if ((':' == next) && ((pos + 1 == text.size()) ||
+                                  isFlowBreak(text[pos + 1])))
+                break;
+            pos++;
+        }
+
+        NodePtr scalar(new Node(Node::SCALAR));
+        scalar->text = trim(text.substr(begin, pos - begin));
+        return scalar;
+    }
+
+    static bool isFlowBreak(char c)
+    {
+        return (' ' == c) || (',' == c) || (']' == c) || ('}' == c);
+    }
+
+    /** Skips the separator after an item, returns true at the closing
+     *  bracket, which is consumed */
+    bool endOfFlow(const std::string& text, size_t& pos, char close)
+    {
+        skipSpaces(text, pos);
+        if (pos >= text.size())
+            error("unterminated flow collection");
+
+        if (',' == text[pos])
+        {
+            pos++;
+            skipSpaces(text, pos);
+        }
+        if ((pos < text.size()) && (close == text[pos]))
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    std::string parseQuoted(const std::string& text, size_t& pos)
+    {
+        char quote = text[pos++];
+        std::string value;
+        while (pos < text.size())
+        {
+            char c = text[pos++];
+            if (c == quote)
+            {
+                if (('\'' == quote) && (pos < text.size()) &&
+                    ('\'' == text[pos]))
+                {
+                    value += '\'';
+                    pos++;
+                    continue;
+                }
+                return value;
+            }
+
+            if (('\\' == c) && ('"' == quote) && (pos < text.size()))
+            {
+                char escape = text[pos++];
+                switch (escape)
+                {
+                    case 'n': value += '\n'; break;
+                    case 't': value += '\t'; break;
+                    case 'r': value += '\r'; break;
+                    case '0': value += '\0'; break;
+                    case 'x':
+                        value += (char)strtol(text.substr(pos, 2).c_str(),
+                                              0, 16);
+                        pos += 2;
+                        break;
+                    default: value += escape; break;
+                }
+                continue;
+            }
+
+            value += c;
+        }
+
+        error("unterminated quoted string");
+        return value;
+    }
+
+    static void skipSpaces(const std::string& text, size_t& pos)
+    {
+        while ((pos < text.size()) && (' ' == text[pos]))
+            pos++;
+    }
+
+    void error(std::string message)
+    {
+        std::stringstream ss;
+        ss << m_source << ":" << m_lineNumber << ": " << message;
+        throw ConfigException(ss.str());
+    }
+
+    std::vector<Line> m_lines;
+
+    std::string m_source;
+
+    int m_lineNumber;
+};
+
+static std::string readFile(std::string filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+        throw ConfigException("Could not open config file: " + filename);
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/** Merges in the files named by INCLUDE keys, like PythonConfigNodeImp does
+ *  when a node is first looked at */
+static void resolveIncludes(YamlConfigNodeImp::NodePtr node)
+{
+    typedef YamlConfigNodeImp::Node Node;
+    typedef YamlConfigNodeImp::NodePtr NodePtr;
+
+    if (Node::MAP == node->type)
+    {
+        std::set<std::string> loaded;
+        NodePtr include = node->find("INCLUDE");
+        while (include && (Node::SCALAR == include->type) &&
+               (loaded.end() == loaded.find(include->text)))
+        {
+            // All paths are resolved from the root of the SVN dir
+            std::string includePath(include->text);
+            loaded.insert(includePath);
+            const char* basePath = getenv("RAM_SVN_DIR");
+            if (!basePath)
+                throw ConfigException("RAM_SVN_DIR must be set to include " +
+                                      includePath);
+            boost::filesystem::path fullPath(
+                boost::filesystem::path(basePath) / includePath);
+
+            // Place all loaded items into this node, a new INCLUDE among
+            // them is loaded next
+            NodePtr included = YamlConfigNodeImp::parse(
+                readFile(fullPath.string()), fullPath.string());
+            if (Node::MAP == included->type)
+            {
+                for (size_t i = 0; i < included->keys.size(); ++i)
+                    node->insert(included->keys[i], included->items[i]);
+            }
+            include = node->find("INCLUDE");
+        }
+        node->erase("INCLUDE");
+        node->erase("INCLUDE_LOADED");
+    }
+
+    BOOST_FOREACH(NodePtr child, node->items)
+    {
+        resolveIncludes(child);
+    }
+}
+
+/** Formats a double so Python reads back the same value */
+static std::string formatDouble(double value)
+{
+    if (value != value)
+        return "float('nan')";
+    if ((value > 0) && (value * 0.5 == value))
+        return "float('inf')";
+    if ((value < 0) && (value * 0.5 == value))
+        return "-float('inf')";
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (strtod(buffer, 0) != value)
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+    std::string text(buffer);
+    if (std::string::npos == text.find_first_of(".e"))
+        text += ".0";
+    return text;
+}
+
+static std::string pythonString(const std::string& text)
+{
+    std::string result("'");
+    BOOST_FOREACH(char c, text)
+    {
+        switch (c)
+        {
+            case '\'': result += "\\'"; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default: result += c; break;
+        }
+    }
+    return result + "'";
+}
+
+/** Quotes a string scalar when YAML would read it as something else */
+static std::string yamlString(const std::string& text)
+{
+    int intValue;
+    double doubleValue;
+    bool quote = text.empty() ||
+        (YamlConfigNodeImp::STRING !=
+         YamlConfigNodeImp::resolve(text, false, intValue, doubleValue)) ||
+        (std::string::npos != std::string("-?:,[]{}#&*!|>'\"%@`").find(
+            text[0])) ||
+        (' ' == text[0]) || (' ' == text[text.size() - 1]) ||
+        (':' == text[text.size() - 1]) ||
+        (std::string::npos != text.find(": ")) ||
+        (std::string::npos != text.find(" #"));
+
+    bool control = false;
+    BOOST_FOREACH(char c, text)
+    {
+        if ((unsigned char)c < ' ')
+            control = true;
+    }
+
+    if (control)
+    {
+        std::string result("\"");
+        BOOST_FOREACH(char c, text)
+        {
+            switch (c)
+            {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default: result += c; break;
+            }
+        }
+        return result + "\"";
+    }
+    else if (quote)
+    {
+        std::string result("'");
+        BOOST_FOREACH(char c, text)
+        {
+            if ('\'' == c)
+                result += "''";
+            else
+                result += c;
+        }
+        return result + "'";
+    }
+    return text;
+}
+
+static bool isBlock(YamlConfigNodeImp::NodePtr node)
+{
+    typedef YamlConfigNodeImp::Node Node;
+    return ((Node::MAP == node->type) || (Node::SEQUENCE == node->type)) &&
+        !node->items.empty();
+}
+
+/** Writes a node which fits after a key or dash, ending the line */
+static void writeInline(std::ostream& out, YamlConfigNodeImp::NodePtr node)
+{
+    typedef YamlConfigNodeImp::Node Node;
+    if (Node::MAP == node->type)
+        out << "{}";
+    else if (Node::SEQUENCE == node->type)
+        out << "[]";
+    else if (Node::NIL == node->type)
+        out << "null";
+    else if (node->quoted)
+        out << yamlString(node->text);
+    else
+        out << node->text;
+    out << std::endl;
+}
+
+/** Writes a non empty map or sequence in block style */
+static void writeBlock(std::ostream& out, YamlConfigNodeImp::NodePtr node,
+                       int indent)
+{
+    typedef YamlConfigNodeImp::Node Node;
+    std::string spaces(indent, ' ');
+
+    for (size_t i = 0; i < node->items.size(); ++i)
+    {
+        YamlConfigNodeImp::NodePtr value = node->items[i];
+        if (Node::MAP == node->type)
+            out << spaces << yamlString(node->keys[i]) << ":";
+        else
+            out << spaces << "-";
+
+        if (isBlock(value))
+        {
+            out << std::endl;
+            writeBlock(out, value, indent + 4);
+        }
+        else
+        {
+            out << " ";
+            writeInline(out, value);
+        }
+    }
+}
+
+void YamlConfigNodeImp::Node::insert(std::string key, NodePtr value)
+{
+    std::map<std::string, size_t>::iterator iter = index.find(key);
+    if (index.end() != iter)
+    {
+        items[iter->second] = value;
+    }
+    else
+    {
+        index[key] = items.size();
+        keys.push_back(key);
+        items.push_back(value);
+    }
+}
+
+YamlConfigNodeImp::NodePtr YamlConfigNodeImp::Node::find(std::string key)
+{
+    std::map<std::string, size_t>::iterator iter = index.find(key);
+    if (index.end() == iter)
+        return NodePtr();
+    return items[iter->second];
+}
+
+void YamlConfigNodeImp::Node::erase(std::string key)
+{
+    std::map<std::string, size_t>::iterator iter = index.find(key);
+    if (index.end() == iter)
+        return;
+
+    size_t position = iter->second;
+    keys.erase(keys.begin() + position);
+    items.erase(items.begin() + position);
+    index.clear();
+    for (size_t i = 0; i < keys.size(); ++i)
+        index[keys[i]] = i;
+}
+
+YamlConfigNodeImp::YamlConfigNodeImp(NodePtr node, std::string debugPath) :
+    m_node(node),
+    m_debugPath(debugPath)
+{
+}
+
+ConfigNodeImpPtr YamlConfigNodeImp::fromYamlFile(std::string filename)
+{
+    return ConfigNodeImpPtr(new YamlConfigNodeImp(parseFile(filename)));
+}
+
+YamlConfigNodeImp::NodePtr YamlConfigNodeImp::parseFile(std::string filename)
+{
+    NodePtr root = parse(readFile(filename), filename);
+    resolveIncludes(root);
+    return root;
+}
+
+YamlConfigNodeImp::NodePtr YamlConfigNodeImp::parse(std::string text,
+                                                    std::string source)
+{
+    YamlParser parser(text, source);
+    return parser.parse();
+}
+
+YamlConfigNodeImp::NodePtr YamlConfigNodeImp::copy(NodePtr node)
+{
+    NodePtr result(new Node(*node));
+    for (size_t i = 0; i < result->items.size(); ++i)
+        result->items[i] = copy(result->items[i]);
+    return result;
+}
+
+YamlConfigNodeImp::NodePtr YamlConfigNodeImp::getNode()
+{
+    return m_node;
+}
+
+ConfigNodeImpPtr YamlConfigNodeImp::idx(int index)
+{
+    std::stringstream ss;
+    ss << m_debugPath << "[" << index << "]";
+
+    if (!m_node || (Node::NIL == m_node->type))
+        return ConfigNodeImpPtr(new YamlConfigNodeImp(NodePtr(), ss.str()));
+    if (Node::SEQUENCE != m_node->type)
+        error("not a sequence");
+
+    // Negative indices count from the end like they do in Python
+    int size = (int)m_node->items.size();
+    if (index < 0)
+        index += size;
+    if ((index < 0) || (index >= size))
+        error("index out of range");
+
+    return ConfigNodeImpPtr(new YamlConfigNodeImp(m_node->items[index],
+                                                  ss.str()));
+}
+
+ConfigNodeImpPtr YamlConfigNodeImp::map(std::string key)
+{
+    NodePtr value;
+    if (m_node && (Node::MAP == m_node->type))
+        value = m_node->find(key);
+
+    return ConfigNodeImpPtr(new YamlConfigNodeImp(value,
+                                                  m_debugPath + "." + key));
+}
+
+std::string YamlConfigNodeImp::asString()
+{
+    if (!m_node || (Node::NIL == m_node->type))
+        return "None";
+    if (Node::SCALAR != m_node->type)
+        return toString(m_node);
+
+    int intValue;
+    double doubleValue;
+    switch (resolve(m_node->text, m_node->quoted, intValue, doubleValue))
+    {
+        case NONE:
+            return "None";
+        case BOOL:
+            return intValue ? "True" : "False";
+        case INT:
+            return boost::lexical_cast<std::string>(intValue);
+        default:
+            return m_node->text;
+    }
+}
+
+std::string YamlConfigNodeImp::asString(const std::string& def)
+{
+    int intValue;
+    double doubleValue;
+    if (!m_node || (Node::NIL == m_node->type) ||
+        ((Node::SCALAR == m_node->type) &&
+         (NONE == resolve(m_node->text, m_node->quoted, intValue,
+                          doubleValue))))
+    {
+        return def;
+    }
+    return asString();
+}
+
+double YamlConfigNodeImp::asDouble()
+{
+    int intValue;
+    double doubleValue;
+    if (!m_node || (Node::SCALAR != m_node->type))
+        error("can't convert to double");
+
+    ScalarType type = resolve(m_node->text, m_node->quoted, intValue,
+                              doubleValue);
+    if ((NONE == type) || (STRING == type))
+        error("can't convert '" + m_node->text + "' to double");
+    return doubleValue;
+}
+
+double YamlConfigNodeImp::asDouble(const double def)
+{
+    int intValue;
+    double doubleValue;
+    if (!m_node || (Node::SCALAR != m_node->type))
+        return def;
+
+    ScalarType type = resolve(m_node->text, m_node->quoted, intValue,
+                              doubleValue);
+    if ((NONE == type) || (STRING == type))
+        return def;
+    return doubleValue;
+}
+
+int YamlConfigNodeImp::asInt()
+{
+    int intValue;
+    double doubleValue;
+    if (!m_node || (Node::SCALAR != m_node->type))
+        error("can't convert to int");
+
+    // Floats don't convert, just like through Python
+    ScalarType type = resolve(m_node->text, m_node->quoted, intValue,
+                              doubleValue);
+    if ((INT != type) && (BOOL != type))
+        error("can't convert '" + m_node->text + "' to int");
+    return intValue;
+}
+
+int YamlConfigNodeImp::asInt(const int def)
+{
+    int intValue;
+    double doubleValue;
+    if (!m_node || (Node::SCALAR != m_node->type))
+        return def;
+
+    ScalarType type = resolve(m_node->text, m_node->quoted, intValue,
+                              doubleValue);
+    if ((INT != type) && (BOOL != type))
+        return def;
+    return intValue;
+}
+
+NodeNameList YamlConfigNodeImp::subNodes()
+{
+    NodeNameList subnodes;
+    if (m_node && (Node::MAP == m_node->type))
+        subnodes.insert(m_node->keys.begin(), m_node->keys.end());
+    return subnodes;
+}
+
+size_t YamlConfigNodeImp::size()
+{
+    if (m_node)
+    {
+        int intValue;
+        double doubleValue;
+        if ((Node::MAP == m_node->type) || (Node::SEQUENCE == m_node->type))
+            return m_node->items.size();
+        else if ((Node::SCALAR == m_node->type) &&
+                 (STRING == resolve(m_node->text, m_node->quoted, intValue,
+                                    doubleValue)))
+            return m_node->text.size();
+    }
+
+    error("has no size");
+    return 0;
+}
+
+void YamlConfigNodeImp::set(std::string key, std::string str)
+{
+    if (!m_node || (Node::MAP != m_node->type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr value(new Node(Node::SCALAR));
+    value->text = str;
+    value->quoted = true;
+    m_node->insert(key, value);
+}
+
+void YamlConfigNodeImp::set(std::string key, int value)
+{
+    if (!m_node || (Node::MAP != m_node->type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr node(new Node(Node::SCALAR));
+    node->text = boost::lexical_cast<std::string>(value);
+    m_node->insert(key, node);
+}
+
+void YamlConfigNodeImp::set(std::string key, double value)
+{
+    if (!m_node || (Node::MAP != m_node->type))
+        error("can't set '" + key + "', not a map");
+
+    NodePtr node(new Node(Node::SCALAR));
+    node->text = boost::lexical_cast<std::string>(value);
+    m_node->insert(key, node);
+}
+
+std::string YamlConfigNodeImp::toString()
+{
+    return toString(m_node);
+}
+
+void YamlConfigNodeImp::writeToFile(std::string fileName, bool silent)
+{
+    writeToFile(m_node, fileName, silent);
+}
+
+YamlConfigNodeImp::ScalarType YamlConfigNodeImp::resolve(
+    const std::string& text, bool quoted, int& intValue, double& doubleValue)
+{
+    if (quoted)
+        return STRING;
+
+    if (text.empty() || (text == "~") || (text == "null") ||
+        (text == "Null") || (text == "NULL"))
+    {
+        return NONE;
+    }
+
+    static const char* TRUE_VALUES[] = {
+        "yes", "Yes", "YES", "true", "True", "TRUE", "on", "On", "ON", 0};
+    static const char* FALSE_VALUES[] = {
+        "no", "No", "NO", "false", "False", "FALSE", "off", "Off", "OFF", 0};
+    for (int i = 0; TRUE_VALUES[i]; ++i)
+    {
+        if (text == TRUE_VALUES[i])
+        {
+            intValue = 1;
+            doubleValue = 1;
+            return BOOL;
+        }
+        if (text == FALSE_VALUES[i])
+        {
+            intValue = 0;
+            doubleValue = 0;
+            return BOOL;
+        }
+    }
+
+    // Underscores may separate digits
+    std::string number;
+    BOOST_FOREACH(char c, text)
+    {
+        if ('_' != c)
+            number += c;
+    }
+    if (number.empty())
+        return STRING;
+    size_t digits = (('-' == number[0]) || ('+' == number[0])) ? 1 : 0;
+    if (digits >= number.size())
+        return STRING;
+    std::string magnitude(number.substr(digits));
+
+    // Ints: 0b binary, 0x hex, leading 0 octal, or decimal
+    int base = 0;
+    size_t skip = 0;
+    if (0 == magnitude.compare(0, 2, "0b"))
+    {
+        base = 2;
+        skip = 2;
+    }
+    else if (0 == magnitude.compare(0, 2, "0x"))
+    {
+        base = 16;
+        skip = 2;
+    }
+    else if (('0' == magnitude[0]) && (magnitude.size() > 1))
+    {
+        base = 8;
+        skip = 1;
+    }
+    else
+    {
+        base = 10;
+    }
+
+    const char* validDigits = (2 == base) ? "01" :
+        (8 == base) ? "01234567" :
+        (10 == base) ? "0123456789" : "0123456789abcdefABCDEF";
+    if ((magnitude.size() > skip) &&
+        (std::string::npos ==
+         magnitude.find_first_not_of(validDigits, skip)))
+    {
+        errno = 0;
+        long value = strtol(magnitude.c_str() + skip, 0, base);
+        if ('-' == number[0])
+            value = -value;
+        intValue = (int)value;
+        doubleValue = (double)value;
+        if ((ERANGE == errno) || ((long)intValue != value))
+            doubleValue = strtod(number.c_str(), 0);
+        return INT;
+    }
+
+    // Floats: .inf and .nan, or digits with a decimal point, an exponent
+    // or both.  Unlike pyyaml, which leaves them strings, -.5 and 1e+20
+    // are read as numbers, so asDouble() works on them.
+    if ((magnitude == ".inf") || (magnitude == ".Inf") ||
+        (magnitude == ".INF"))
+    {
+        doubleValue = ('-' == number[0]) ? -HUGE_VAL : HUGE_VAL;
+        intValue = 0;
+        return FLOAT;
+    }
+    if ((text == ".nan") || (text == ".NaN") || (text == ".NAN"))
+    {
+        doubleValue = strtod("nan", 0);
+        intValue = 0;
+        return FLOAT;
+    }
+
+    size_t pos = magnitude.find_first_not_of("0123456789");
+    size_t mantissaDigits = std::min(pos, magnitude.size());
+    bool point = (std::string::npos != pos) && ('.' == magnitude[pos]);
+    if (point)
+    {
+        size_t fraction = pos + 1;
+        pos = magnitude.find_first_not_of("0123456789", fraction);
+        mantissaDigits += std::min(pos, magnitude.size()) - fraction;
+    }
+    if (0 == mantissaDigits)
+        return STRING;
+
+    if (std::string::npos != pos)
+    {
+        if (('e' != magnitude[pos]) && ('E' != magnitude[pos]))
+            return STRING;
+        // YAML 1.1 wants a sign on the exponent, so 1e5 stays a string
+        pos++;
+        if ((pos >= magnitude.size()) ||
+            (('-' != magnitude[pos]) && ('+' != magnitude[pos])))
+        {
+            return STRING;
+        }
+        pos++;
+        if ((pos >= magnitude.size()) ||
+            (std::string::npos !=
+             magnitude.find_first_not_of("0123456789", pos)))
+        {
+            return STRING;
+        }
+    }
+    else if (!point)
+    {
+        return STRING;
+    }
+
+    doubleValue = strtod(number.c_str(), 0);
+    intValue = 0;
+    return FLOAT;
+}
+
+std::string YamlConfigNodeImp::toString(NodePtr node)
+{
+    if (!node || (Node::NIL == node->type))
+        return "None";
+
+    std::string result;
+    if (Node::MAP == node->type)
+    {
+        result = "{";
+        for (size_t i = 0; i < node->keys.size(); ++i)
+        {
+            if (i > 0)
+                result += ", ";
+            result += pythonString(node->keys[i]) + ": " +
+                toString(node->items[i]);
+        }
+        return result + "}";
+    }
+    else if (Node::SEQUENCE == node->type)
+    {
+        result = "[";
+        for (size_t i = 0; i < node->items.size(); ++i)
+        {
+            if (i > 0)
+                result += ", ";
+            result += toString(node->items[i]);
+        }
+        return result + "]";
+    }
+
+    int intValue;
+    double doubleValue;
+    switch (resolve(node->text, node->quoted, intValue, doubleValue))
+    {
+        case NONE:
+            return "None";
+        case BOOL:
+            return intValue ? "True" : "False";
+        case INT:
+            if ((double)intValue == doubleValue)
+                return boost::lexical_cast<std::string>(intValue);
+            return formatDouble(doubleValue);
+        case FLOAT:
+            return formatDouble(doubleValue);
+        default:
+            return pythonString(node->text);
+    }
+}
+
+void YamlConfigNodeImp::writeToFile(NodePtr node, std::string fileName,
+                                    bool silent)
+{
+    std::ofstream file(fileName.c_str());
+    if (!file)
+    {
+        if (silent)
+        {
+            printf("Error during write out of %s\n", fileName.c_str());
+            return;
+        }
+        throw ConfigException("Could not write config file: " + fileName);
+    }
+
+    if (!node)
+        writeInline(file, NodePtr(new Node()));
+    else if (isBlock(node))
+        writeBlock(file, node, 0);
+    else
+        writeInline(file, node);
+}
+
+void YamlConfigNodeImp::error(std::string message)
+{
+    throw ConfigException("ConfigNode \"" + m_debugPath + "\": " + message);
+}
+
+} // namespace core
+} // namespace ram
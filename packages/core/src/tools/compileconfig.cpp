@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/tools/compileconfig.cpp
+ */
+
+// STD Includes
+#include <iostream>
+#include <cstdlib>
+
+// Project Includes
+#include "core/include/SnapshotConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+using namespace ram;
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <config.yml> <config.ymlc>"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        core::SnapshotConfigNodeImp::compile(std::string(argv[1]),
+                                             std::string(argv[2]));
+    }
+    catch (core::ConfigException& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
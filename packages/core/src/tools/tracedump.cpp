@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/src/tools/tracedump.cpp
+ */
+
+// Writes a BinaryTrace out as text, a row per line, in the layout the
+// "%m %r%n" log appenders use: the values separated by spaces, then the
+// milliseconds since the first row.  A ControlTrace dumped this way loads
+// into the matlab scripts like the old control.log did.
+//
+// Usage: tracedump <file.trace> [out.log]
+
+// STD Includes
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/BinaryTrace.h"
+
+using namespace ram;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <file.trace> [out.log]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    core::BinaryTraceReader reader(argv[1]);
+    if (!reader.isOpen())
+    {
+        std::cerr << "Could not read trace " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream file;
+    if (argc == 3)
+    {
+        file.open(argv[2]);
+        if (!file)
+        {
+            std::cerr << "Could not open " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = (argc == 3) ? file : std::cout;
+    out << std::setprecision(10);
+
+    boost::int64_t time;
+    boost::int64_t start = 0;
+    bool first = true;
+    std::vector<double> values(reader.getValues() + 1);
+    while (reader.next(time, &values[0]))
+    {
+        if (first)
+            start = time;
+        first = false;
+
+        for (int i = 0; i < reader.getValues(); ++i)
+            out << values[i] << " ";
+        out << (time - start) / 1000 << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
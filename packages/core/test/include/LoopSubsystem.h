@@ -37,6 +37,7 @@ public:
         if (0 == m_stopIterations)
             publish(STOP, ram::core::EventPtr(new ram::core::Event()));
         m_stopIterations -= 1;
+        startTimes.push_back(ram::core::TimeVal::timeOfDay().get_double());
         
         // Don't record first update
         if (0 != m_start.get_double())
@@ -58,6 +59,9 @@ public:
 
     std::vector<double> actualUpdates;
     std::vector<double> expectedUpdates;
+
+    /** When each update began, since the epoch */
+    std::vector<double> startTimes;
     
 private:
     ram::core::TimeVal m_start;
@@ -14,6 +14,7 @@
 // STD Includes
 #include <sstream>
 #include <cstdlib>
+#include <algorithm>
 
 // Library Includes
 #include <UnitTest++/UnitTest++.h>
@@ -27,6 +28,12 @@
 #include "core/test/include/LoopSubsystem.h"
 #include "core/include/Application.h"
 #include "core/include/SubsystemMaker.h"
+#include "core/include/Feature.h"
+
+#ifdef RAM_WITH_WRAPPERS
+#include <boost/python.hpp>
+#include "core/include/GILock.h"
+#endif
 
 namespace ba = boost::assign;
 namespace bf = boost::filesystem;
@@ -34,6 +41,24 @@ namespace bf = boost::filesystem;
 const std::string LoopSubsystem::STOP("CORE_TEST_LOOPSUBSYSTEM");
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(LoopSubsystem, LoopSubsystem);
 
+#ifdef RAM_WITH_WRAPPERS
+/** Fails to construct with a Python exception, as a wrapped subsystem can */
+class PythonErrorSubsystem : public MockSubsystem
+{
+public:
+    PythonErrorSubsystem(ram::core::ConfigNode config_,
+                         ram::core::SubsystemList dependents_) :
+        MockSubsystem(config_, dependents_)
+    {
+        // Locked like a Python subsystem maker does
+        ram::core::ScopedGILock gil;
+        PyErr_SetString(PyExc_ValueError, "no sensors found");
+        boost::python::throw_error_already_set();
+    }
+};
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(PythonErrorSubsystem, PythonErrorSubsystem);
+#endif
+
 static bf::path getConfigRoot()
 {
     bf::path root(getenv("RAM_SVN_DIR"));
@@ -116,6 +141,63 @@ TEST(Dependencies)
     CHECK(expected == subServant->dependents);
 }
 
+TEST(parallelCreation)
+{
+    bf::path path(getConfigRoot() / "parallelSubsystems.yml");
+    ram::core::Application app(path.string());
+
+    CHECK_EQUAL(4u, app.getSubsystemNames().size());
+    
+    MockSubsystem* servant2 =
+        dynamic_cast<MockSubsystem*>(app.getSubsystem("Servant2").get());
+    ram::core::SubsystemList expected =
+        ba::list_of(app.getSubsystem("Manager"));
+    CHECK(servant2);
+    CHECK(expected == servant2->dependents);
+
+    // Only created once both the servants exist
+    MockSubsystem* subServant =
+        dynamic_cast<MockSubsystem*>(app.getSubsystem("SubServant").get());
+    expected =
+        ba::list_of(app.getSubsystem("Servant1"))(app.getSubsystem("Servant2"));
+    CHECK(subServant);
+    CHECK_EQUAL(11, subServant->config["test"].asInt());
+    CHECK(expected == subServant->dependents);
+}
+
+#ifdef RAM_WITH_WRAPPERS
+TEST(parallelCreationPythonError)
+{
+    bf::path path(getConfigRoot() / "pythonErrorSubsystems.yml");
+    bool raised = false;
+    std::string message;
+    try {
+        ram::core::Application app(path.string());
+    } catch (boost::python::error_already_set&) {
+        // The error raised on a worker thread is raised again here
+        raised = true;
+        PyObject* type = 0;
+        PyObject* value = 0;
+        PyObject* traceback = 0;
+        PyErr_Fetch(&type, &value, &traceback);
+        PyErr_NormalizeException(&type, &value, &traceback);
+        CHECK(PyErr_GivenExceptionMatches(type, PyExc_ValueError));
+        if (value)
+        {
+            boost::python::object valueObj(boost::python::handle<>(
+                boost::python::borrowed(value)));
+            message = boost::python::extract<std::string>(
+                boost::python::str(valueObj));
+        }
+        Py_XDECREF(type);
+        Py_XDECREF(value);
+        Py_XDECREF(traceback);
+    }
+    CHECK(raised);
+    CHECK_EQUAL("no sensors found", message);
+}
+#endif
+
 TEST(BadDependencies)
 {
     bf::path path(getConfigRoot() / "bad_subsystems.yml");
@@ -180,6 +262,43 @@ TEST(mainLoop)
     }
 }
 
+TEST(parallelMainLoop)
+{
+    bf::path path(getConfigRoot() / "parallelLoopSubsystems.yml");
+    ram::core::Application app(path.string());
+
+    app.getSubsystem("SubsystemA")->subscribe(LoopSubsystem::STOP,
+                                              boost::bind(stopLoop, &app, _1));
+    app.mainLoop();
+
+    LoopSubsystem* subsystemA =
+        dynamic_cast<LoopSubsystem*>(app.getSubsystem("SubsystemA").get());
+    LoopSubsystem* subsystemC =
+        dynamic_cast<LoopSubsystem*>(app.getSubsystem("SubsystemC").get());
+    CHECK(subsystemA);
+    CHECK(subsystemC);
+
+    // C depends on A, so each pass it only starts once A is done
+    size_t passes = std::min(subsystemA->startTimes.size(),
+                             subsystemC->startTimes.size());
+    CHECK(passes >= 10u);
+    for (size_t i = 0; i < passes; ++i)
+    {
+        CHECK(subsystemC->startTimes[i] >=
+              subsystemA->startTimes[i] + 0.045);
+    }
+
+    // A and B run side by side, so a pass takes about A + C (70ms) instead
+    // of A + B + C (120ms)
+    ram::core::Application::MainLoopStats stats = app.getMainLoopStats();
+    CHECK_EQUAL(3, stats.threads);
+    CHECK(stats.passes >= 10u);
+    CHECK(stats.meanPass < 0.1);
+    CHECK(stats.maxPass >= stats.meanPass);
+    CHECK_CLOSE(0.05, stats.updateTime["SubsystemB"], 0.02);
+    CHECK_CLOSE(0.02, stats.maxUpdateTime["SubsystemC"], 0.02);
+}
+
 TEST(setPriority)
 {
     bf::path path(getConfigRoot() / "prioritySubsystems.yml");
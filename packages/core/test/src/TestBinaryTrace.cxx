@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestBinaryTrace.cxx
+ */
+
+// STD Includes
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/BinaryTrace.h"
+
+using namespace ram;
+
+static const char* TRACE_FILE = "/tmp/ram_test_binarytrace.bin";
+
+/** Reads back the rows of a trace, checking its header */
+static std::vector<double> readTrace(int values, size_t& rows)
+{
+    std::vector<double> result;
+    rows = 0;
+    core::BinaryTraceReader reader(TRACE_FILE);
+    CHECK(reader.isOpen());
+    CHECK_EQUAL(values, reader.getValues());
+    if (reader.getValues() != values)
+        return result;
+
+    boost::int64_t time;
+    boost::int64_t last = 0;
+    std::vector<double> row(values);
+    while (reader.next(time, &row[0]))
+    {
+        CHECK(time >= last);
+        last = time;
+        result.insert(result.end(), row.begin(), row.end());
+        rows++;
+    }
+    return result;
+}
+
+TEST(BinaryTraceRecord)
+{
+    {
+        core::BinaryTrace trace(TRACE_FILE, 3, 8);
+        CHECK(trace.isOpen());
+        CHECK_EQUAL(3, trace.getValues());
+
+        // More rows than the ring holds, written out as they go
+        for (int i = 0; i < 20; ++i)
+        {
+            double values[] = {i, i * 2.0, i * 3.0};
+            CHECK(trace.record(values));
+            if (i % 4 == 3)
+                trace.update(0);
+        }
+        CHECK_EQUAL(0u, trace.getDropped());
+    }
+
+    size_t rows;
+    std::vector<double> values = readTrace(3, rows);
+    CHECK_EQUAL(20u, rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        CHECK_EQUAL((double)i, values[i * 3]);
+        CHECK_EQUAL(i * 3.0, values[i * 3 + 2]);
+    }
+    remove(TRACE_FILE);
+}
+
+TEST(BinaryTraceDropped)
+{
+    {
+        core::BinaryTrace trace(TRACE_FILE, 1, 4);
+        for (int i = 0; i < 6; ++i)
+        {
+            double value = i;
+            trace.record(&value);
+        }
+        CHECK_EQUAL(2u, trace.getDropped());
+    }
+
+    // The rows which fit are kept, the rest are lost
+    size_t rows;
+    std::vector<double> values = readTrace(1, rows);
+    CHECK_EQUAL(4u, rows);
+    CHECK_EQUAL(3.0, values[3]);
+    remove(TRACE_FILE);
+}
+
+TEST(BinaryTraceReaderTruncated)
+{
+    {
+        core::BinaryTrace trace(TRACE_FILE, 2, 8);
+        double values[] = {1, 2};
+        trace.record(values);
+        trace.record(values);
+    }
+
+    // Cut the last row short, as a crash while writing would
+    std::vector<char> bytes(1024);
+    FILE* file = fopen(TRACE_FILE, "rb");
+    bytes.resize(fread(&bytes[0], 1, bytes.size(), file));
+    fclose(file);
+    file = fopen(TRACE_FILE, "wb");
+    fwrite(&bytes[0], 1, bytes.size() - 4, file);
+    fclose(file);
+
+    size_t rows;
+    readTrace(2, rows);
+    CHECK_EQUAL(1u, rows);
+
+    // Anything else is not a trace at all
+    file = fopen(TRACE_FILE, "wb");
+    fputs("ForceOut TorqueOut\n", file);
+    fclose(file);
+    CHECK(!core::BinaryTraceReader(TRACE_FILE).isOpen());
+    CHECK(!core::BinaryTraceReader("/nonexistent/trace.bin").isOpen());
+    remove(TRACE_FILE);
+}
+
+TEST(BinaryTraceBadFile)
+{
+    core::BinaryTrace trace("/nonexistent/dir/trace.bin", 2);
+    CHECK(!trace.isOpen());
+    double values[] = {1, 2};
+    CHECK(trace.record(values));
+    trace.update(0);
+}
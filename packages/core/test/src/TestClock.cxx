@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestClock.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/Clock.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+static void sleepThenStamp(boost::int64_t wakeTime, boost::int64_t* woke)
+{
+    core::Clock::sleepUntil(wakeTime);
+    *woke = core::Clock::monotonicTime();
+}
+
+struct VirtualFixture
+{
+    VirtualFixture()
+    {
+        core::Clock::setVirtual(5000000);
+    }
+
+    ~VirtualFixture()
+    {
+        core::Clock::setReal();
+    }
+};
+
+SUITE(Clock) {
+
+TEST(realTime)
+{
+    CHECK(!core::Clock::isVirtual());
+    boost::int64_t start = core::Clock::monotonicTime();
+    core::Clock::sleep(20000);
+    CHECK(core::Clock::monotonicTime() - start >= 20000);
+}
+
+TEST_FIXTURE(VirtualFixture, virtualTime)
+{
+    CHECK(core::Clock::isVirtual());
+    CHECK_EQUAL(0, core::Clock::monotonicTime());
+    CHECK_EQUAL(5000000, core::Clock::timeOfDay());
+
+    core::Clock::advance(1500);
+    CHECK_EQUAL(1500, core::Clock::monotonicTime());
+    CHECK_EQUAL(5001500, core::Clock::timeOfDay());
+
+    // TimeVal goes through the clock as well
+    CHECK_CLOSE(5.0015, core::TimeVal::timeOfDay().get_double(), 0.000001);
+}
+
+TEST_FIXTURE(VirtualFixture, driverDoesNotSleep)
+{
+    // Would never return if the driving thread blocked
+    core::Clock::sleep(1000000);
+    core::TimeVal::sleep(1.0);
+    CHECK_EQUAL(0, core::Clock::monotonicTime());
+}
+
+TEST_FIXTURE(VirtualFixture, sleepWaitsForAdvance)
+{
+    boost::int64_t woke = -1;
+    boost::thread sleeper(boost::bind(sleepThenStamp, 10000, &woke));
+
+    // Real time passing does not wake the sleeper
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    CHECK_EQUAL(-1, woke);
+
+    core::Clock::advance(5000);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    CHECK_EQUAL(-1, woke);
+
+    core::Clock::advance(5000);
+    sleeper.join();
+    CHECK_EQUAL(10000, woke);
+}
+
+TEST_FIXTURE(VirtualFixture, setRealWakesSleepers)
+{
+    boost::int64_t woke = -1;
+    boost::thread sleeper(boost::bind(sleepThenStamp, 10000, &woke));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+
+    core::Clock::setReal();
+    sleeper.join();
+    CHECK(woke != -1);
+}
+
+} // SUITE(Clock)
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestEventPool.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/EventPool.h"
+#include "core/include/Events.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+TEST(EventPoolReuse)
+{
+    core::EventPool<core::StringEvent> pool(2);
+    CHECK_EQUAL(2u, pool.size());
+
+    // Released events come back instead of new ones
+    core::StringEvent* first = pool.acquire().get();
+    core::StringEvent* second = pool.acquire().get();
+    CHECK(first != second);
+    CHECK_EQUAL(first, pool.acquire().get());
+    CHECK_EQUAL(second, pool.acquire().get());
+    CHECK_EQUAL(0u, pool.getAllocations());
+}
+
+TEST(EventPoolHeld)
+{
+    core::EventPool<core::StringEvent> pool(2);
+
+    // An event still held by a subscriber is never handed out again
+    core::StringEventPtr held = pool.acquire();
+    held->string = "held";
+    core::StringEventPtr next = pool.acquire();
+    CHECK(held != next);
+    next.reset();
+    CHECK(held != pool.acquire());
+    CHECK_EQUAL(0u, pool.getAllocations());
+    CHECK_EQUAL("held", held->string);
+}
+
+TEST(EventPoolExhausted)
+{
+    core::EventPool<core::StringEvent> pool(2);
+    core::StringEventPtr a = pool.acquire();
+    core::StringEventPtr b = pool.acquire();
+
+    // With everything held a new event is made, the old ones stay valid
+    a->string = "a";
+    b->string = "b";
+    core::StringEventPtr c = pool.acquire();
+    CHECK(c != a && c != b);
+    CHECK_EQUAL(1u, pool.getAllocations());
+    CHECK_EQUAL("a", a->string);
+    CHECK_EQUAL("b", b->string);
+}
+
+TEST(EventPoolTimeStamp)
+{
+    core::EventPool<core::StringEvent> pool(1);
+
+    // A reused event is stamped when handed out, not when first made
+    core::StringEvent* event = pool.acquire().get();
+    event->timeStamp = 1;
+    double before = core::TimeVal::timeOfDay().get_double();
+    CHECK_EQUAL(event, pool.acquire().get());
+    CHECK(event->timeStamp >= before);
+    CHECK(event->timeStamp <= core::TimeVal::timeOfDay().get_double());
+}
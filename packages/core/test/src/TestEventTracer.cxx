@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestEventTracer.cxx
+ */
+
+// STD Includes
+#include <sstream>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/foreach.hpp>
+
+// Project Includes
+#include "core/include/EventTracer.h"
+#include "core/include/EventHub.h"
+#include "core/include/QueuedEventHub.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/EventConnection.h"
+#include "core/test/include/Reciever.h"
+
+using namespace ram;
+
+// Every test uses its own event types, the statistics are never cleared
+struct TracerFixture
+{
+    TracerFixture()
+    {
+        core::EventTracer::setEnabled(true);
+    }
+
+    ~TracerFixture()
+    {
+        core::EventTracer::setEnabled(false);
+    }
+};
+
+static void publishEvents(core::EventPublisher* publisher, int count)
+{
+    for (int i = 0; i < count; ++i)
+        publisher->publish("TracerThreads", core::EventPtr(new core::Event()));
+}
+
+SUITE(EventTracer) {
+
+TEST(Histogram)
+{
+    core::EventTracer::Histogram histogram;
+    CHECK_EQUAL(-1, histogram.getPercentile(0.5));
+
+    histogram.record(100);
+    histogram.record(300);
+    histogram.record(1500);
+    CHECK_EQUAL(3u, histogram.count);
+    CHECK_EQUAL(1500, histogram.max);
+    CHECK_CLOSE(633.3, histogram.getMean(), 0.1);
+    CHECK_EQUAL(core::TimingStats::getBucketLimit(
+                    core::TimingStats::getBucket(300)),
+                histogram.getPercentile(0.6));
+
+    core::EventTracer::Histogram other;
+    other.record(5000);
+    histogram.merge(other);
+    CHECK_EQUAL(4u, histogram.count);
+    CHECK_EQUAL(5000, histogram.max);
+}
+
+TEST_FIXTURE(TracerFixture, publish)
+{
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "TracerPublish", boost::bind(&Reciever::handler, &recv, _1));
+
+    for (int i = 0; i < 3; ++i)
+        publisher.publish("TracerPublish", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(3, recv.calls);
+
+    core::EventTracer::TypeStatsMap stats =
+        core::EventTracer::getTypeStats();
+    CHECK_EQUAL(3u, stats["TracerPublish"].publishTime.count);
+    CHECK_EQUAL(3u, stats["TracerPublish"].handlerTime.count);
+    CHECK_EQUAL(0u, stats["TracerPublish"].queueTime.count);
+
+    // The handler is named after the class it is bound to
+    bool found = false;
+    typedef std::pair<std::string, core::EventTracer::Histogram> HandlerPair;
+    BOOST_FOREACH(HandlerPair handler, core::EventTracer::getHandlerStats())
+    {
+        if (std::string::npos != handler.first.find("Reciever"))
+            found = true;
+    }
+    CHECK(found);
+}
+
+TEST(disabled)
+{
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "TracerDisabled", boost::bind(&Reciever::handler, &recv, _1));
+
+    publisher.publish("TracerDisabled", core::EventPtr(new core::Event()));
+    CHECK_EQUAL(1, recv.calls);
+
+    core::EventTracer::TypeStatsMap stats =
+        core::EventTracer::getTypeStats();
+    CHECK(stats.end() == stats.find("TracerDisabled"));
+}
+
+TEST(subscribedDisabled)
+{
+    // Only handlers subscribed while tracing are wrapped to be timed
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "TracerSubscribedDisabled",
+        boost::bind(&Reciever::handler, &recv, _1));
+
+    core::EventTracer::setEnabled(true);
+    publisher.publish("TracerSubscribedDisabled",
+                      core::EventPtr(new core::Event()));
+    core::EventTracer::setEnabled(false);
+    CHECK_EQUAL(1, recv.calls);
+
+    core::EventTracer::TypeStats stats =
+        core::EventTracer::getTypeStats()["TracerSubscribedDisabled"];
+    CHECK_EQUAL(1u, stats.publishTime.count);
+    CHECK_EQUAL(0u, stats.handlerTime.count);
+}
+
+TEST_FIXTURE(TracerFixture, queued)
+{
+    Reciever recv;
+    core::EventHubPtr eventHub(new core::EventHub());
+    core::QueuedEventHubPtr queuedEventHub(
+        new core::QueuedEventHub(eventHub));
+    core::EventPublisher publisher(eventHub);
+    core::EventConnectionPtr connection = queuedEventHub->subscribeToType(
+        "TracerQueued", boost::bind(&Reciever::handler, &recv, _1));
+
+    publisher.publish("TracerQueued", core::EventPtr(new core::Event()));
+    publisher.publish("TracerQueued", core::EventPtr(new core::Event()));
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+    CHECK_EQUAL(2, queuedEventHub->publishEvents());
+    CHECK_EQUAL(2, recv.calls);
+
+    // Published once by the publisher, to the hub handler which queues it,
+    // and again out of the queue to recv
+    core::EventTracer::TypeStats stats =
+        core::EventTracer::getTypeStats()["TracerQueued"];
+    CHECK_EQUAL(4u, stats.publishTime.count);
+    CHECK_EQUAL(4u, stats.handlerTime.count);
+    CHECK_EQUAL(2u, stats.queueTime.count);
+    CHECK(stats.queueTime.max >= 5000);
+}
+
+TEST_FIXTURE(TracerFixture, threads)
+{
+    Reciever recv;
+    core::EventPublisher publisher;
+    core::EventConnectionPtr connection = publisher.subscribe(
+        "TracerThreads", boost::bind(&Reciever::handler, &recv, _1));
+
+    // Each thread traces into its own buffers, which are merged on reading
+    boost::thread first(boost::bind(publishEvents, &publisher, 10));
+    first.join();
+    boost::thread second(boost::bind(publishEvents, &publisher, 20));
+    second.join();
+    publishEvents(&publisher, 5);
+
+    // The exited threads' buffers are gone, but not what they recorded
+    core::EventTracer::TypeStats stats =
+        core::EventTracer::getTypeStats()["TracerThreads"];
+    CHECK_EQUAL(35u, stats.publishTime.count);
+    CHECK_EQUAL(35u, stats.handlerTime.count);
+
+    std::stringstream trace;
+    core::EventTracer::writeChromeTrace(trace);
+    std::string json(trace.str());
+    const std::string slice("{\"name\": \"TracerThreads\", "
+                            "\"cat\": \"publish\"");
+    size_t publishes = 0;
+    for (size_t pos = json.find(slice); std::string::npos != pos;
+         pos = json.find(slice, pos + 1))
+    {
+        publishes++;
+    }
+    CHECK_EQUAL(35u, publishes);
+}
+
+TEST_FIXTURE(TracerFixture, writeChromeTrace)
+{
+    core::EventHubPtr eventHub(new core::EventHub());
+    core::QueuedEventHubPtr queuedEventHub(
+        new core::QueuedEventHub(eventHub));
+    core::EventPublisher publisher(eventHub);
+    publisher.publish("Tracer \"Chrome\"", core::EventPtr(new core::Event()));
+    queuedEventHub->publishEvents();
+
+    std::stringstream trace;
+    core::EventTracer::writeChromeTrace(trace);
+    std::string json(trace.str());
+
+    CHECK(std::string::npos != json.find("\"traceEvents\": ["));
+    CHECK(std::string::npos !=
+          json.find("\"name\": \"Tracer \\\"Chrome\\\"\""));
+    CHECK(std::string::npos !=
+          json.find("\"cat\": \"publish\", \"ph\": \"X\""));
+    CHECK(std::string::npos !=
+          json.find("\"cat\": \"queue\", \"ph\": \"b\""));
+    CHECK(std::string::npos !=
+          json.find("\"cat\": \"queue\", \"ph\": \"e\""));
+    CHECK_EQUAL("]}", json.substr(json.size() - 3, 2));
+}
+
+} // SUITE(EventTracer)
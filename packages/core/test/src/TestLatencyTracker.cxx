@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestLatencyTracker.cxx
+ */
+
+// STD Includes
+#include <sstream>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/thread.hpp>
+
+// Project Includes
+#include "core/include/LatencyTracker.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/Events.h"
+
+using namespace ram;
+
+// Every test uses its own sources and stages, the statistics are never
+// cleared
+struct LatencyFixture
+{
+    LatencyFixture()
+    {
+        core::LatencyTracker::setEnabled(true);
+    }
+
+    ~LatencyFixture()
+    {
+        core::LatencyTracker::setEnabled(false);
+    }
+};
+
+SUITE(LatencyTracker) {
+
+TEST(arrivalTimeCloned)
+{
+    core::StringEventPtr original(new core::StringEvent());
+    CHECK_EQUAL(0, original->arrivalTime);
+
+    original->arrivalTime = 12345;
+    core::EventPtr cloned(original->clone());
+    CHECK_EQUAL(12345, cloned->arrivalTime);
+}
+
+TEST_FIXTURE(LatencyFixture, record)
+{
+    boost::int64_t arrival = core::LatencyTracker::now();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+    core::LatencyTracker::record("RecordSource", "driver", arrival);
+
+    // Unknown arrival times are ignored
+    core::LatencyTracker::record("RecordSource", "driver", 0);
+
+    core::LatencyTracker::SourceStatsMap stats =
+        core::LatencyTracker::getStats();
+    CHECK_EQUAL(1u, stats["RecordSource"]["driver"].count);
+    CHECK(stats["RecordSource"]["driver"].max >= 5000);
+}
+
+TEST_FIXTURE(LatencyFixture, recordEvent)
+{
+    core::EventPublisher publisher(core::EventHubPtr(), "RecordEventSource");
+    core::EventPtr event(new core::Event());
+    event->sender = &publisher;
+    event->arrivalTime = core::LatencyTracker::now();
+    core::LatencyTracker::record(event, "recordEventStage");
+
+    core::LatencyTracker::SourceStatsMap stats =
+        core::LatencyTracker::getStats();
+    CHECK_EQUAL(1u, stats["RecordEventSource"]["recordEventStage"].count);
+}
+
+TEST_FIXTURE(LatencyFixture, forward)
+{
+    boost::int64_t arrival = core::LatencyTracker::now();
+    core::LatencyTracker::record("ForwardA", "forwardFrom", arrival);
+    core::LatencyTracker::record("ForwardB", "forwardFrom", arrival - 1000);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+
+    // Each sample only counts once at the next stage
+    core::LatencyTracker::forward("forwardTo", "forwardFrom");
+    core::LatencyTracker::forward("forwardTo", "forwardFrom");
+
+    core::LatencyTracker::SourceStatsMap stats =
+        core::LatencyTracker::getStats();
+    CHECK_EQUAL(1u, stats["ForwardA"]["forwardTo"].count);
+    CHECK_EQUAL(1u, stats["ForwardB"]["forwardTo"].count);
+    CHECK(stats["ForwardA"]["forwardTo"].max >= 5000);
+    CHECK(stats["ForwardB"]["forwardTo"].max >= 6000);
+
+    // Newer data is counted again, and carries on down the pipeline
+    core::LatencyTracker::record("ForwardA", "forwardFrom",
+                                 core::LatencyTracker::now());
+    core::LatencyTracker::forward("forwardTo", "forwardFrom");
+    core::LatencyTracker::forward("forwardLast", "forwardTo");
+
+    stats = core::LatencyTracker::getStats();
+    CHECK_EQUAL(2u, stats["ForwardA"]["forwardTo"].count);
+    CHECK_EQUAL(1u, stats["ForwardB"]["forwardTo"].count);
+    CHECK_EQUAL(1u, stats["ForwardA"]["forwardLast"].count);
+    CHECK_EQUAL(1u, stats["ForwardB"]["forwardLast"].count);
+}
+
+TEST(disabled)
+{
+    core::LatencyTracker::record("DisabledSource", "driver",
+                                 core::LatencyTracker::now());
+
+    core::LatencyTracker::SourceStatsMap stats =
+        core::LatencyTracker::getStats();
+    CHECK(stats.end() == stats.find("DisabledSource"));
+}
+
+TEST_FIXTURE(LatencyFixture, writeReport)
+{
+    boost::int64_t arrival = core::LatencyTracker::now();
+    core::LatencyTracker::record("ReportSource",
+                                 core::LatencyTracker::ESTIMATOR, arrival);
+    core::LatencyTracker::record("ReportSource",
+                                 core::LatencyTracker::DRIVER, arrival);
+
+    std::stringstream report;
+    core::LatencyTracker::writeReport(report);
+    std::string text(report.str());
+
+    // Stages are in pipeline order, not by name
+    size_t driver = text.find("ReportSource        driver");
+    size_t estimator = text.find("ReportSource        estimator");
+    CHECK(std::string::npos != driver);
+    CHECK(std::string::npos != estimator);
+    CHECK(driver < estimator);
+}
+
+} // SUITE(LatencyTracker)
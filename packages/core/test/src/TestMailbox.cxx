@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestMailbox.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+// Project Includes
+#include "core/include/Mailbox.h"
+
+using namespace ram;
+
+namespace {
+
+struct Sample
+{
+    int values[16];
+};
+
+Sample makeSample(int value)
+{
+    Sample sample;
+    for (int i = 0; i < 16; ++i)
+        sample.values[i] = value;
+    return sample;
+}
+
+void writeSamples(core::Mailbox<Sample>* mailbox, int count)
+{
+    for (int i = 1; i <= count; ++i)
+        mailbox->write(makeSample(i));
+}
+
+} // namespace
+
+TEST(MailboxReadWrite)
+{
+    core::Mailbox<int> mailbox(5);
+    int value = 0;
+    CHECK_EQUAL(0u, mailbox.read(value));
+    CHECK_EQUAL(5, value);
+
+    mailbox.write(7);
+    CHECK_EQUAL(2u, mailbox.read(value));
+    CHECK_EQUAL(7, value);
+    CHECK_EQUAL(2u, mailbox.getVersion());
+}
+
+TEST(MailboxReadIfChanged)
+{
+    core::Mailbox<int> mailbox;
+    core::Mailbox<int>::Version version = 0;
+    int value = -1;
+
+    // Nothing written yet
+    CHECK(!mailbox.readIfChanged(value, version));
+    CHECK_EQUAL(-1, value);
+
+    mailbox.write(3);
+    CHECK(mailbox.readIfChanged(value, version));
+    CHECK_EQUAL(3, value);
+
+    // Only copies again once there is something new
+    value = -1;
+    CHECK(!mailbox.readIfChanged(value, version));
+    CHECK_EQUAL(-1, value);
+
+    mailbox.write(4);
+    mailbox.write(5);
+    CHECK(mailbox.readIfChanged(value, version));
+    CHECK_EQUAL(5, value);
+}
+
+TEST(MailboxNoTornReads)
+{
+    core::Mailbox<Sample> mailbox(makeSample(0));
+    const int writes = 200000;
+    boost::thread writer(boost::bind(writeSamples, &mailbox, writes));
+
+    // Every value read must be one whole write, and they only go forward
+    int last = 0;
+    int torn = 0;
+    int backwards = 0;
+    while (last < writes)
+    {
+        Sample sample;
+        mailbox.read(sample);
+        for (int i = 1; i < 16; ++i)
+        {
+            if (sample.values[i] != sample.values[0])
+                torn++;
+        }
+        if (sample.values[0] < last)
+            backwards++;
+        last = sample.values[0];
+    }
+    writer.join();
+
+    CHECK_EQUAL(0, torn);
+    CHECK_EQUAL(0, backwards);
+}
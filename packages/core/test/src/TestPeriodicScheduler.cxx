@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestPeriodicScheduler.cxx
+ */
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "core/include/PeriodicScheduler.h"
+#include "core/include/Updatable.h"
+#include "core/include/Clock.h"
+
+using namespace ram;
+
+static void sleepFor(double seconds)
+{
+    core::Clock::sleepUntil(
+        core::Clock::monotonicTime() +
+        (boost::int64_t)(seconds * 1000000));
+}
+
+class Counter : public core::Updatable
+{
+public:
+    Counter(double runTime_ = 0) : runTime(runTime_), count(0), last(0) {}
+
+    ~Counter()
+        {
+            unbackground(true);
+        }
+
+    virtual void update(double timestep)
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            count++;
+            last = timestep;
+            if (runTime > 0)
+                sleepFor(runTime);
+        }
+
+    int getCount()
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            return count;
+        }
+
+    double runTime;
+    boost::mutex mutex;
+    int count;
+    double last;
+};
+
+static std::vector<int> workers(int count)
+{
+    return std::vector<int>(count, -1);
+}
+
+SUITE(PeriodicScheduler) {
+
+TEST(monotonicTime)
+{
+    boost::int64_t start = core::Clock::monotonicTime();
+    sleepFor(0.05);
+    boost::int64_t duration = core::Clock::monotonicTime() - start;
+    CHECK(duration >= 50000);
+    CHECK(duration < 100000);
+}
+
+TEST(addRemove)
+{
+    core::PeriodicScheduler scheduler(workers(1));
+    Counter counter;
+
+    scheduler.add(&counter, 10);
+    CHECK(scheduler.contains(&counter));
+    CHECK_EQUAL(0, scheduler.getWorker(&counter));
+
+    sleepFor(0.5);
+    scheduler.remove(&counter, true);
+    CHECK(!scheduler.contains(&counter));
+
+    // Should be about 50 updates, give plenty of room for a loaded machine
+    int count = counter.getCount();
+    CHECK_CLOSE(50, count, 10);
+    CHECK_CLOSE(0.01, counter.last, 0.005);
+
+    // No more updates once removed
+    sleepFor(0.05);
+    CHECK_EQUAL(count, counter.getCount());
+
+    core::TimingStats stats(counter.getTimingStats());
+    CHECK_EQUAL((unsigned int)count - 1, stats.getUpdates());
+}
+
+TEST(addWakesWorker)
+{
+    core::PeriodicScheduler scheduler(workers(1));
+    Counter slow;
+    Counter added;
+
+    // Leave the worker waiting on the slow task's next release
+    scheduler.add(&slow, 1000);
+    sleepFor(0.05);
+
+    // The new task is due now, it should not wait out the worker's sleep
+    scheduler.add(&added, 1000);
+    sleepFor(0.002);
+    CHECK_EQUAL(1, added.getCount());
+
+    scheduler.remove(&added, true);
+    scheduler.remove(&slow, true);
+}
+
+TEST(noDrift)
+{
+    // Updates take most of the period, so a relative sleep would lose about
+    // a third of the updates
+    core::PeriodicScheduler scheduler(workers(1));
+    Counter counter(0.006);
+
+    scheduler.add(&counter, 10);
+    sleepFor(1.0);
+    scheduler.remove(&counter, true);
+
+    CHECK_CLOSE(100, counter.getCount(), 10);
+}
+
+TEST(overrun)
+{
+    core::PeriodicScheduler scheduler(workers(1));
+    Counter counter(0.025);
+
+    scheduler.add(&counter, 10);
+    sleepFor(0.5);
+    scheduler.remove(&counter, true);
+
+    core::TimingStats stats(counter.getTimingStats());
+    CHECK(stats.getUpdates() > 0);
+    CHECK_EQUAL(stats.getUpdates(), stats.getDeadlineMisses());
+
+    // Missed periods are skipped, not run back to back
+    CHECK_CLOSE(20, counter.getCount(), 5);
+}
+
+TEST(spreadAcrossWorkers)
+{
+    core::PeriodicScheduler scheduler(workers(2));
+    Counter a;
+    Counter b;
+    Counter c;
+
+    scheduler.add(&a, 10);
+    scheduler.add(&b, 10);
+    scheduler.add(&c, 100);
+    CHECK_EQUAL(2u, scheduler.getWorkerCount());
+    CHECK(scheduler.getWorker(&a) != scheduler.getWorker(&b));
+
+    // The slow task goes on the same worker as one of the fast tasks
+    CHECK(scheduler.getWorker(&c) >= 0);
+
+    scheduler.remove(&a, true);
+    scheduler.remove(&b, true);
+    scheduler.remove(&c, true);
+}
+
+TEST(preferPinnedWorker)
+{
+    std::vector<int> cores;
+    cores.push_back(-1);
+    cores.push_back(0);
+    core::PeriodicScheduler scheduler(cores);
+    Counter a;
+    Counter b;
+
+    scheduler.add(&a, 10, 0);
+    scheduler.add(&b, 10, 0);
+    CHECK_EQUAL(1, scheduler.getWorker(&a));
+    CHECK_EQUAL(1, scheduler.getWorker(&b));
+
+    scheduler.remove(&a, true);
+    scheduler.remove(&b, true);
+}
+
+TEST(rateMonotonicPriorities)
+{
+    core::PeriodicScheduler scheduler(workers(2), true);
+    Counter fast;
+    Counter slow;
+
+    CHECK_EQUAL(0, scheduler.getWorkerPriority(0));
+    scheduler.add(&slow, 100);
+    scheduler.add(&fast, 10);
+
+    int fastPriority =
+        scheduler.getWorkerPriority(scheduler.getWorker(&fast));
+    int slowPriority =
+        scheduler.getWorkerPriority(scheduler.getWorker(&slow));
+    CHECK(fastPriority > slowPriority);
+    CHECK(slowPriority > 0);
+
+    // Slow is now the fastest task
+    scheduler.remove(&fast, true);
+    CHECK_EQUAL(fastPriority,
+                scheduler.getWorkerPriority(scheduler.getWorker(&slow)));
+    scheduler.remove(&slow, true);
+}
+
+TEST(defaultScheduler)
+{
+    core::PeriodicScheduler scheduler(workers(1));
+    core::PeriodicScheduler::setDefault(&scheduler);
+
+    {
+        Counter counter;
+        counter.background(10);
+        CHECK(counter.backgrounded());
+        CHECK(scheduler.contains(&counter));
+
+        // Running all out needs its own thread
+        counter.background(-1);
+        CHECK(!scheduler.contains(&counter));
+        CHECK(counter.backgrounded());
+
+        counter.unbackground(true);
+        CHECK(!counter.backgrounded());
+    }
+
+    {
+        Counter counter;
+        counter.background(10);
+        sleepFor(0.1);
+        counter.unbackground(true);
+        CHECK(!scheduler.contains(&counter));
+        CHECK(counter.getCount() > 0);
+    }
+
+    core::PeriodicScheduler::setDefault(0);
+}
+
+} // SUITE(PeriodicScheduler)
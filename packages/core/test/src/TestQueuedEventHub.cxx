@@ -303,3 +303,102 @@ TEST_FIXTURE(QueuedEventHubFixture, publichEventPublisher)
 
     connectionB->disconnect();
 }
+
+TEST_FIXTURE(QueuedEventHubFixture, criticalLane)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+    queuedEventHub->setTypeLane("Critical",
+                                 ram::core::QueuedEventHub::CRITICAL_LANE);
+
+    publisherA.publish("A", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("B", ram::core::EventPtr(new ram::core::Event()));
+    publisherB.publish("Critical", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(3, queuedEventHub->publishEvents());
+
+    // The critical event jumps ahead of the normal ones queued before it
+    CHECK_EQUAL(3, recv.calls);
+    CHECK_EQUAL("Critical", recv.events[0]->type);
+    CHECK_EQUAL("A", recv.events[1]->type);
+    CHECK_EQUAL("B", recv.events[2]->type);
+}
+
+TEST_FIXTURE(QueuedEventHubFixture, latestLane)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+    queuedEventHub->setTypeLane("Depth",
+                                 ram::core::QueuedEventHub::LATEST_LANE);
+    queuedEventHub->setTypeLane("Speed",
+                                 ram::core::QueuedEventHub::LATEST_LANE);
+
+    ram::core::EventPtr newest(new ram::core::Event());
+    publisherA.publish("Depth", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("Speed", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("Depth", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("Normal", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("Depth", newest);
+    CHECK_EQUAL(2u, queuedEventHub->getCoalescedCount());
+    CHECK_EQUAL(3, queuedEventHub->publishEvents());
+
+    // Normal events go first, then the newest of each type in the order
+    // the types first arrived
+    CHECK_EQUAL(3, recv.calls);
+    CHECK_EQUAL("Normal", recv.events[0]->type);
+    CHECK_EQUAL("Depth", recv.events[1]->type);
+    CHECK(newest == recv.events[1]);
+    CHECK_EQUAL("Speed", recv.events[2]->type);
+
+    // Once published the type queues again
+    publisherA.publish("Depth", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(1, queuedEventHub->publishEvents());
+    CHECK_EQUAL(2u, queuedEventHub->getCoalescedCount());
+}
+
+TEST_FIXTURE(QueuedEventHubFixture, subscribeToTypeLane)
+{
+    CHECK_EQUAL(ram::core::QueuedEventHub::NORMAL_LANE,
+                queuedEventHub->getTypeLane("Type"));
+
+    ram::core::EventConnectionPtr latest =
+        queuedEventHub->subscribeToType("Type",
+            boost::bind(&Reciever::handler, &recv, _1),
+            ram::core::QueuedEventHub::LATEST_LANE);
+    CHECK_EQUAL(ram::core::QueuedEventHub::LATEST_LANE,
+                queuedEventHub->getTypeLane("Type"));
+
+    // A more urgent lane wins, a less urgent one doesn't
+    Reciever recvB;
+    ram::core::EventConnectionPtr critical =
+        queuedEventHub->subscribeToType("Type",
+            boost::bind(&Reciever::handler, &recvB, _1),
+            ram::core::QueuedEventHub::CRITICAL_LANE);
+    CHECK_EQUAL(ram::core::QueuedEventHub::CRITICAL_LANE,
+                queuedEventHub->getTypeLane("Type"));
+    ram::core::EventConnectionPtr normal =
+        queuedEventHub->subscribeToType("Type",
+            boost::bind(&Reciever::handler, &recvB, _1),
+            ram::core::QueuedEventHub::NORMAL_LANE);
+    CHECK_EQUAL(ram::core::QueuedEventHub::CRITICAL_LANE,
+                queuedEventHub->getTypeLane("Type"));
+
+    publisherA.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    publisherA.publish("Type", ram::core::EventPtr(new ram::core::Event()));
+    queuedEventHub->publishEvents();
+    CHECK_EQUAL(2, recv.calls);
+    CHECK_EQUAL(4, recvB.calls);
+
+    latest->disconnect();
+    critical->disconnect();
+    normal->disconnect();
+}
+
+TEST_FIXTURE(QueuedEventHubFixture, waitAndPublishEventsLanes)
+{
+    queuedEventHub->subscribeToAll(boost::bind(&Reciever::handler, &recv, _1));
+    queuedEventHub->setTypeLane("Latest",
+                                 ram::core::QueuedEventHub::LATEST_LANE);
+
+    // Waiting wakes up for an event in any lane
+    publisherA.publish("Latest", ram::core::EventPtr(new ram::core::Event()));
+    CHECK_EQUAL(1, queuedEventHub->waitAndPublishEvents());
+    CHECK_EQUAL(1, recv.calls);
+}
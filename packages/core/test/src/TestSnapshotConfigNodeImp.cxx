@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestSnapshotConfigNodeImp.cxx
+ */
+
+#ifdef RAM_WINDOWS
+#define _CRT_SECURE_NO_WARNINGS // turn off warning about getenv
+#endif
+
+// STD Includes
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/SnapshotConfigNodeImp.h"
+#include "core/include/YamlConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+using namespace ram;
+
+const std::string SNAPSHOT_YAML(
+    "TestInt: 10\n"
+    "TestDouble: 23.5\n"
+    "TestStr: Str\n"
+    "Quoted: '12'\n"
+    "Array: [4, 5, 6]\n"
+    "Map: {A: D, B: E, C: F}\n"
+    "Nested:\n"
+    "    - name: first\n"
+    "      flag: on\n"
+    "Empty:\n");
+
+static std::string snapshotFile()
+{
+    return std::string(getenv("RAM_SVN_DIR")) +
+        "/build/packages/core/testSnapshot.ymlc";
+}
+
+struct SnapshotFixture
+{
+    SnapshotFixture() :
+        yamlNode(core::ConfigNodeImpPtr(new core::YamlConfigNodeImp(
+            core::YamlConfigNodeImp::parse(SNAPSHOT_YAML)))),
+        configNode(compileAndLoad())
+    {
+    }
+
+    ~SnapshotFixture()
+    {
+        remove(snapshotFile().c_str());
+    }
+
+    static core::ConfigNode compileAndLoad()
+    {
+        core::SnapshotConfigNodeImp::compile(
+            core::YamlConfigNodeImp::parse(SNAPSHOT_YAML), snapshotFile());
+        return core::ConfigNode::fromFile(snapshotFile());
+    }
+
+    core::ConfigNode yamlNode;
+    core::ConfigNode configNode;
+};
+
+SUITE(SnapshotConfigNodeImp) {
+
+TEST_FIXTURE(SnapshotFixture, lookups)
+{
+    CHECK_EQUAL(10, configNode["TestInt"].asInt());
+    CHECK_CLOSE(23.5, configNode["TestDouble"].asDouble(), 0.0001);
+    CHECK_EQUAL("Str", configNode["TestStr"].asString());
+    CHECK_EQUAL("12", configNode["Quoted"].asString());
+    CHECK_EQUAL(-1, configNode["Quoted"].asInt(-1));
+    CHECK_EQUAL(3u, configNode["Array"].size());
+    CHECK_EQUAL(6, configNode["Array"][-1].asInt());
+    CHECK_EQUAL("E", configNode["Map"]["B"].asString());
+    CHECK_EQUAL("first", configNode["Nested"][0]["name"].asString());
+    CHECK_EQUAL(1, configNode["Nested"][0]["flag"].asInt());
+    CHECK_EQUAL("None", configNode["Empty"].asString());
+}
+
+TEST_FIXTURE(SnapshotFixture, missing)
+{
+    CHECK(!configNode.exists("NotThere"));
+    CHECK_EQUAL("Def", configNode["NotThere"]["Deeper"].asString("Def"));
+    CHECK_EQUAL(2, configNode["Map"]["Z"].asInt(2));
+    CHECK_THROW(configNode["NotThere"].asInt(), core::ConfigException);
+    CHECK_THROW(configNode["Array"][3].asInt(), core::ConfigException);
+}
+
+TEST_FIXTURE(SnapshotFixture, matchesYaml)
+{
+    CHECK_EQUAL(yamlNode.toString(), configNode.toString());
+    CHECK_EQUAL(yamlNode.subNodes().size(), configNode.subNodes().size());
+}
+
+TEST_FIXTURE(SnapshotFixture, set)
+{
+    CHECK_EQUAL("NotHere", configNode["Map"]["TestSet"].asString("NotHere"));
+
+    configNode["Map"].set("TestSet", "MyVal");
+    configNode["Map"].set("A", 7);
+    CHECK_EQUAL("MyVal", configNode["Map"]["TestSet"].asString());
+    CHECK_EQUAL(7, configNode["Map"]["A"].asInt());
+    CHECK_EQUAL(4u, configNode["Map"].size());
+    CHECK_EQUAL("{'A': 7, 'B': 'E', 'C': 'F', 'TestSet': 'MyVal'}",
+                configNode["Map"].toString());
+
+    CHECK_THROW(configNode["Array"].set("A", 1), core::ConfigException);
+}
+
+TEST(corrupt)
+{
+    std::string filename(snapshotFile());
+    {
+        std::ofstream file(filename.c_str());
+        file << "Not a snapshot";
+    }
+
+    CHECK_THROW(core::ConfigNode::fromFile(filename), core::ConfigException);
+    remove(filename.c_str());
+}
+
+TEST(fullHashTable)
+{
+    std::string filename(snapshotFile());
+    core::SnapshotConfigNodeImp::compile(
+        core::YamlConfigNodeImp::parse("a: 1\nb: 2\n"), filename);
+
+    // Shrink the root map's hash table to its two keys, leaving it without
+    // the empty bucket lookups stop at.  The Header has 8 magic bytes, then
+    // the root index at byte 12 and the node offset at byte 32, and
+    // bucketCount is at byte 20 of each 40 byte NodeRecord.
+    {
+        std::fstream file(filename.c_str(), std::ios::in | std::ios::out |
+                          std::ios::binary);
+        boost::uint32_t root = 0;
+        boost::uint32_t nodes = 0;
+        file.seekg(12);
+        file.read((char*)&root, sizeof(root));
+        file.seekg(32);
+        file.read((char*)&nodes, sizeof(nodes));
+
+        boost::uint32_t bucketCount = 2;
+        file.seekp(nodes + root * 40 + 20);
+        file.write((char*)&bucketCount, sizeof(bucketCount));
+    }
+
+    CHECK_THROW(core::ConfigNode::fromFile(filename), core::ConfigException);
+    remove(filename.c_str());
+}
+
+} // SUITE(SnapshotConfigNodeImp)
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestTimingStats.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "core/include/TimingStats.h"
+
+using namespace ram;
+
+SUITE(TimingStats) {
+
+TEST(getBucket)
+{
+    CHECK_EQUAL(0, core::TimingStats::getBucket(0));
+    CHECK_EQUAL(1, core::TimingStats::getBucket(1));
+    CHECK_EQUAL(2, core::TimingStats::getBucket(2));
+    CHECK_EQUAL(2, core::TimingStats::getBucket(3));
+    CHECK_EQUAL(11, core::TimingStats::getBucket(1500));
+    CHECK_EQUAL(core::TimingStats::BUCKETS - 1,
+                core::TimingStats::getBucket(10000000));
+
+    // Every value is under its buckets limit
+    CHECK(1500 < core::TimingStats::getBucketLimit(11));
+    CHECK(1500 >= core::TimingStats::getBucketLimit(10));
+    CHECK_EQUAL(-1, core::TimingStats::getBucketLimit(
+                    core::TimingStats::BUCKETS - 1));
+}
+
+TEST(record)
+{
+    core::TimingStats stats;
+    stats.record(100, 2000, -5);
+    stats.record(300, 4000, 250);
+    stats.record(-10, 3000, -1);
+
+    // Finishing right on the deadline meets it
+    stats.record(0, 3000, 0);
+
+    CHECK_EQUAL(4u, stats.getUpdates());
+    CHECK_EQUAL(1u, stats.getDeadlineMisses());
+    CHECK_EQUAL(300, stats.getMaxJitter());
+    CHECK_CLOSE(400.0 / 4, stats.getMeanJitter(), 0.0001);
+    CHECK_EQUAL(4000, stats.getMaxRunTime());
+    CHECK_CLOSE(3000, stats.getMeanRunTime(), 0.0001);
+
+    // Early starts count as no jitter
+    CHECK_EQUAL(2u, stats.getJitterCount(0));
+    CHECK_EQUAL(1u, stats.getJitterCount(core::TimingStats::getBucket(100)));
+    CHECK_EQUAL(1u, stats.getJitterCount(core::TimingStats::getBucket(300)));
+    CHECK_EQUAL(1u, stats.getMissCount(core::TimingStats::getBucket(250)));
+
+    stats.reset();
+    CHECK_EQUAL(0u, stats.getUpdates());
+    CHECK_EQUAL(0u, stats.getJitterCount(0));
+    CHECK_EQUAL(0, stats.getMeanJitter());
+}
+
+TEST(getJitterPercentile)
+{
+    core::TimingStats stats;
+    CHECK_EQUAL(-1, stats.getJitterPercentile(0.5));
+
+    for (int i = 0; i < 99; ++i)
+        stats.record(10, 0, -1);
+    stats.record(5000, 0, -1);
+
+    CHECK_EQUAL(16, stats.getJitterPercentile(0.5));
+    CHECK_EQUAL(16, stats.getJitterPercentile(0.99));
+    CHECK_EQUAL(8192, stats.getJitterPercentile(1));
+}
+
+TEST(merge)
+{
+    core::TimingStats a;
+    core::TimingStats b;
+    a.record(10, 100, -1);
+    b.record(20, 300, 50);
+
+    a.merge(b);
+    CHECK_EQUAL(2u, a.getUpdates());
+    CHECK_EQUAL(1u, a.getDeadlineMisses());
+    CHECK_EQUAL(20, a.getMaxJitter());
+    CHECK_CLOSE(200, a.getMeanRunTime(), 0.0001);
+}
+
+} // SUITE(TimingStats)
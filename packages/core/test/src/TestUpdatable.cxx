@@ -30,6 +30,7 @@ get the mutex from the lower priority threads.
 
 // Project Includes
 #include "core/include/Updatable.h"
+#include "core/include/Clock.h"
 
 #ifdef RAM_LINUX
 // Linux Includes
@@ -92,6 +93,20 @@ TEST(setPriority)
     CHECK_EQUAL(test1.getPriority(), ram::core::IUpdatable::LOW_PRIORITY);
 }
 
+TEST(timingStats)
+{
+    Spinner test1;
+    test1.background(10);
+    ram::core::Clock::sleepUntil(
+        ram::core::Clock::monotonicTime() + 300000);
+    test1.unbackground(true);
+
+    // The first update has no release time to measure against
+    ram::core::TimingStats stats(test1.getTimingStats());
+    CHECK_EQUAL((unsigned int)test1.tid, stats.getUpdates());
+    CHECK_CLOSE(30, (int)stats.getUpdates(), 6);
+}
+
 #ifdef RAM_LINUX
 TEST(getTID)
 {
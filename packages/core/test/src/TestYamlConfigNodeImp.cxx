@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/core/test/src/TestYamlConfigNodeImp.cxx
+ */
+
+#ifdef RAM_WINDOWS
+#define _CRT_SECURE_NO_WARNINGS // turn off warning about getenv
+#endif
+
+// STD Includes
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/filesystem.hpp>
+#include <boost/python.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "core/include/YamlConfigNodeImp.h"
+#include "core/include/PythonConfigNodeImp.h"
+#include "core/include/Exception.h"
+
+using namespace ram;
+namespace bf = boost::filesystem;
+namespace py = boost::python;
+
+static core::ConfigNode parse(std::string text)
+{
+    return core::ConfigNode(core::ConfigNodeImpPtr(
+        new core::YamlConfigNodeImp(core::YamlConfigNodeImp::parse(text))));
+}
+
+static std::string dataFile(std::string name)
+{
+    return std::string(getenv("RAM_SVN_DIR")) + "/packages/core/test/data/" +
+        name;
+}
+
+static core::ConfigNode load(std::string filename)
+{
+    return core::ConfigNode(core::YamlConfigNodeImp::fromYamlFile(filename));
+}
+
+// Compares the Python literals of two config trees.  The includes are merged
+// into the native tree, and pyyaml leaves numbers like -.5 as strings.
+const char* COMPARE_TREES =
+    "inf = float('inf')\n"
+    "nan = float('nan')\n"
+    "def number(text):\n"
+    "    try:\n"
+    "        return float(text)\n"
+    "    except ValueError:\n"
+    "        return None\n"
+    "def sameTree(a, b):\n"
+    "    if isinstance(a, dict):\n"
+    "        a = dict((k, v) for k, v in a.items()\n"
+    "                 if k not in ('INCLUDE', 'INCLUDE_LOADED'))\n"
+    "        return (isinstance(b, dict) and sorted(a) == sorted(b) and\n"
+    "                all(sameTree(a[k], b[k]) for k in a))\n"
+    "    if isinstance(a, list):\n"
+    "        return (isinstance(b, list) and len(a) == len(b) and\n"
+    "                all(sameTree(x, y) for x, y in zip(a, b)))\n"
+    "    if isinstance(a, str) and isinstance(b, float):\n"
+    "        return number(a) == b\n"
+    "    return (type(a) == type(b)) and ((a == b) or (a != a and b != b))\n"
+    "same = sameTree(eval(python), eval(native))\n";
+
+static bool sameTree(std::string python, std::string native)
+{
+    py::object main_module((py::handle<>(py::borrowed(
+        PyImport_AddModule("__main__")))));
+    py::object main_namespace = main_module.attr("__dict__");
+    main_namespace["python"] = python;
+    main_namespace["native"] = native;
+
+    py::handle<> ignored(PyRun_String(COMPARE_TREES, Py_file_input,
+                                      main_namespace.ptr(),
+                                      main_namespace.ptr()));
+    return py::extract<bool>(main_namespace["same"]);
+}
+
+const std::string BASIC_YAML(
+    "# A comment\n"
+    "TestInt: 10\n"
+    "TestDouble: 23.5   # Trailing comment\n"
+    "TestStr: Str\n"
+    "Array: [4, 5, 6]\n"
+    "Map:\n"
+    "    A: D\n"
+    "    B: E\n"
+    "    C: F\n"
+    "List:\n"
+    "    - 1\n"
+    "    - name: first\n"
+    "      value: 2\n"
+    "Empty:\n");
+
+struct YamlConfigNodeFixture
+{
+    YamlConfigNodeFixture() : configNode(parse(BASIC_YAML)) {}
+
+    core::ConfigNode configNode;
+};
+
+SUITE(YamlConfigNodeImp) {
+
+TEST_FIXTURE(YamlConfigNodeFixture, basic)
+{
+    CHECK_EQUAL(10, configNode["TestInt"].asInt());
+    CHECK_CLOSE(23.5, configNode["TestDouble"].asDouble(), 0.0001);
+    CHECK_EQUAL("Str", configNode["TestStr"].asString());
+    CHECK_EQUAL(3u, configNode["Array"].size());
+    CHECK_EQUAL(6, configNode["Array"][2].asInt());
+    CHECK_EQUAL(4, configNode["Array"][-3].asInt());
+    CHECK_EQUAL("E", configNode["Map"]["B"].asString());
+    CHECK_EQUAL(1, configNode["List"][0].asInt());
+    CHECK_EQUAL("first", configNode["List"][1]["name"].asString());
+    CHECK_EQUAL(2, configNode["List"][1]["value"].asInt());
+    CHECK_EQUAL("None", configNode["Empty"].asString());
+}
+
+TEST_FIXTURE(YamlConfigNodeFixture, defaults)
+{
+    CHECK_EQUAL("Def", configNode["NotThere"].asString("Def"));
+    CHECK_EQUAL("Def", configNode["Empty"].asString("Def"));
+    CHECK_EQUAL(2, configNode["NotThere"].asInt(2));
+    CHECK_EQUAL(2, configNode["TestStr"].asInt(2));
+    CHECK_CLOSE(1.5, configNode["NotThere"]["Deeper"].asDouble(1.5), 0.0001);
+    CHECK(!configNode.exists("NotThere"));
+    CHECK(configNode.exists("Map"));
+}
+
+TEST_FIXTURE(YamlConfigNodeFixture, subNodes)
+{
+    core::NodeNameList subnodes = configNode["Map"].subNodes();
+    CHECK_EQUAL(3u, subnodes.size());
+    CHECK(subnodes.end() != subnodes.find("A"));
+    CHECK(subnodes.end() != subnodes.find("C"));
+    CHECK_EQUAL(3u, configNode["Map"].size());
+    CHECK(configNode["Array"].subNodes().empty());
+}
+
+TEST(flow)
+{
+    core::ConfigNode node(parse(
+        "Flow: {a: 1, b: [x, 'y, z'], c: {d: -2.5e+1}}\n"
+        "Split: [1,\n"
+        "        2]\n"));
+    CHECK_EQUAL(1, node["Flow"]["a"].asInt());
+    CHECK_EQUAL(2u, node["Flow"]["b"].size());
+    CHECK_EQUAL("y, z", node["Flow"]["b"][1].asString());
+    CHECK_CLOSE(-25.0, node["Flow"]["c"]["d"].asDouble(), 0.0001);
+    CHECK_EQUAL(2, node["Split"][1].asInt());
+}
+
+TEST(quoting)
+{
+    core::ConfigNode node(parse(
+        "single: 'it''s # not a comment'\n"
+        "double: \"tab\\there\"\n"
+        "number: '10'\n"
+        "hash: a#b\n"));
+    CHECK_EQUAL("it's # not a comment", node["single"].asString());
+    CHECK_EQUAL("tab\there", node["double"].asString());
+    CHECK_EQUAL("a#b", node["hash"].asString());
+
+    // Quoted numbers are strings, like they are to Python
+    CHECK_EQUAL(5, node["number"].asInt(5));
+    CHECK_EQUAL(2u, node["number"].size());
+}
+
+TEST(comments)
+{
+    // A '#' right after a quote or a flow indicator starts a comment too
+    core::ConfigNode node(parse(
+        "order: ['a', 'b',\n"
+        "        'c']# 'd',\n"
+        "        #'e']\n"
+        "appenders: ['Log']#'Console']\n"
+        "distance: [2,7]#5\n"
+        "tasks: ['x',\n"
+        "        'y'#, 'z'\n"
+        "        ]\n"
+        "plain: a#b # c\n"));
+    CHECK_EQUAL(3u, node["order"].size());
+    CHECK_EQUAL("c", node["order"][2].asString());
+    CHECK_EQUAL(1u, node["appenders"].size());
+    CHECK_EQUAL(2u, node["distance"].size());
+    CHECK_EQUAL(7, node["distance"][1].asInt());
+    CHECK_EQUAL(2u, node["tasks"].size());
+    CHECK_EQUAL("a#b", node["plain"].asString());
+}
+
+TEST(typing)
+{
+    core::ConfigNode node(parse(
+        "hex: 0x1F\n"
+        "octal: 010\n"
+        "under: 1_000\n"
+        "yes: yes\n"
+        "off: off\n"
+        "float: 1.0\n"
+        "exp: 1e5\n"
+        "signedExp: 1e+20\n"
+        "point: -.575\n"
+        "trailing: 3.\n"
+        "dot: .\n"
+        "inf: -.inf\n"
+        "nan: .NaN\n"
+        "null: ~\n"));
+    CHECK_EQUAL(31, node["hex"].asInt());
+    CHECK_EQUAL(8, node["octal"].asInt());
+    CHECK_EQUAL(1000, node["under"].asInt());
+    CHECK_EQUAL(1, node["yes"].asInt());
+    CHECK_EQUAL("False", node["off"].asString());
+
+    // Floats don't become ints, and YAML 1.1 needs a '.' in a float
+    CHECK_THROW(node["float"].asInt(), core::ConfigException);
+    CHECK_EQUAL("1e5", node["exp"].asString());
+    CHECK_THROW(node["exp"].asDouble(), core::ConfigException);
+    CHECK_CLOSE(1e20, node["signedExp"].asDouble(), 1);
+    CHECK_CLOSE(-0.575, node["point"].asDouble(), 0.0001);
+    CHECK_CLOSE(3.0, node["trailing"].asDouble(), 0.0001);
+    CHECK_EQUAL(".", node["dot"].asString());
+    CHECK(node["inf"].asDouble() < -1e300);
+    double nan = node["nan"].asDouble();
+    CHECK(nan != nan);
+    CHECK_EQUAL("None", node["null"].asString());
+}
+
+TEST(errors)
+{
+    CHECK_THROW(parse("a: &anchor 1\n"), core::ConfigException);
+    CHECK_THROW(parse("a:\n\t- 1\n"), core::ConfigException);
+    CHECK_THROW(parse("a: [1, 2\n"), core::ConfigException);
+
+    core::ConfigNode node(parse("a: [1]\n"));
+    CHECK_THROW(node["a"][1].asInt(), core::ConfigException);
+    CHECK_THROW(node["a"]["b"].asInt(), core::ConfigException);
+}
+
+TEST_FIXTURE(YamlConfigNodeFixture, set)
+{
+    CHECK_EQUAL("NotHere", configNode["Map"]["TestSet"].asString("NotHere"));
+
+    configNode["Map"].set("TestSet", "MyVal");
+    configNode["Map"].set("TestInt", 5);
+    configNode["Map"].set("Number", "12");
+    configNode["Map"].set("TestDouble", 0.1);
+    CHECK_EQUAL("MyVal", configNode["Map"]["TestSet"].asString());
+    CHECK_EQUAL(5, configNode["Map"]["TestInt"].asInt());
+    CHECK_EQUAL(-1, configNode["Map"]["Number"].asInt(-1));
+    CHECK_EQUAL(0.1, configNode["Map"]["TestDouble"].asDouble());
+    CHECK_EQUAL(7u, configNode["Map"].size());
+}
+
+TEST(copy)
+{
+    core::YamlConfigNodeImp::NodePtr tree(core::YamlConfigNodeImp::parse(
+        "Controller: {kp: 10, gains: [1, 2]}"));
+    core::ConfigNode copy(core::ConfigNodeImpPtr(new core::YamlConfigNodeImp(
+        core::YamlConfigNodeImp::copy(tree))));
+    copy["Controller"].set("kp", 20.5);
+
+    core::ConfigNode original(core::ConfigNodeImpPtr(
+        new core::YamlConfigNodeImp(tree)));
+    CHECK_EQUAL(10, original["Controller"]["kp"].asInt());
+    CHECK_EQUAL(20.5, copy["Controller"]["kp"].asDouble());
+    CHECK_EQUAL(original["Controller"]["gains"].toString(),
+                copy["Controller"]["gains"].toString());
+}
+
+TEST(toString)
+{
+    core::ConfigNode node(parse(
+        "b: [1, 2.5, 'x']\n"
+        "a: {c: yes, d: ~}\n"
+        "e: it's\n"));
+
+    // Python literal, in file order
+    CHECK_EQUAL("{'b': [1, 2.5, 'x'], 'a': {'c': True, 'd': None}, "
+                "'e': 'it\\'s'}", node.toString());
+}
+
+TEST(include)
+{
+    core::ConfigNode configNode(
+        load(dataFile("testInclude.yml")));
+    core::ConfigNode sub = configNode["Base"]["Sub"];
+
+    CHECK_EQUAL(100, sub["count"].asInt());
+    CHECK_EQUAL(1, configNode["Other"]["key"].asInt());
+    CHECK_EQUAL("Sonar", configNode["Base"]["Sys2"]["type"].asString());
+    CHECK_CLOSE(57.6, sub["setting"].asDouble(), 0.0001);
+    CHECK_EQUAL(67, configNode["Other"]["recVal"].asInt());
+
+    // The INCLUDE keys themselves are gone
+    CHECK_EQUAL(2u, configNode["Base"].subNodes().size());
+    CHECK(!configNode.exists("INCLUDE"));
+}
+
+TEST(writeToFile)
+{
+    core::ConfigNode node(parse(
+        "Map:\n"
+        "    list: [1, two, '3']\n"
+        "    empty: {}\n"
+        "    nested:\n"
+        "        - a: 1\n"
+        "Str: 'yes'\n"));
+
+    std::string filepath = std::string(getenv("RAM_SVN_DIR"))
+        + "/build/packages/core/testYamlWrite.yml";
+    node.writeToFile(filepath);
+    core::ConfigNode copy(load(filepath));
+    remove(filepath.c_str());
+
+    CHECK_EQUAL(node.toString(), copy.toString());
+}
+
+TEST(matchesPython)
+{
+    // Every config in the tree must load the same as through pyyaml, files
+    // pyyaml can't load are left out
+    bf::path root(getenv("RAM_SVN_DIR"));
+    const char* DIRS[] = {"data", "packages", "sandbox", "tools", "wrappers",
+                          0};
+    std::string mismatched;
+    int compared = 0;
+    for (int i = 0; DIRS[i]; ++i)
+    {
+        bf::recursive_directory_iterator end;
+        for (bf::recursive_directory_iterator itr(root / DIRS[i]);
+             itr != end; ++itr)
+        {
+            bf::path path(itr->path());
+            if ((path.extension() != ".yml") && (path.extension() != ".sml"))
+                continue;
+
+            std::string python;
+            try {
+                python = core::ConfigNode(
+                    core::PythonConfigNodeImp::fromYamlFile(path.string()))
+                    .toString();
+            } catch (py::error_already_set&) {
+                PyErr_Clear();
+                continue;
+            }
+
+            std::string native;
+            try {
+                native = load(path.string()).toString();
+            } catch (core::ConfigException&) {
+                mismatched += " " + path.string();
+                continue;
+            }
+
+            if (!sameTree(python, native))
+                mismatched += " " + path.string();
+            compared++;
+        }
+    }
+    CHECK_EQUAL("", mismatched);
+    CHECK(compared > 100);
+}
+
+} // SUITE(YamlConfigNodeImp)
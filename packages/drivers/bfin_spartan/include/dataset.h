@@ -36,6 +36,24 @@ int destroyDataset(struct dataset* s);
 signed short getSample(struct dataset* s, int ch, int index);
 int putSample(struct dataset* s, int ch, int index, signed short value);
 struct dataset * loadDataset(const char * filename);
+
+struct sampleSpan;
+
+/* Fills span with up to length samples of channel ch from start on,
+ * stopping at the end of the allocation unit holding start.
+ *
+ * Returns the length of the span, or -1 if the channel or range is out of
+ * bounds.  Read a longer range one span at a time.
+ */
+int datasetUnitSpan(struct dataset* s, int ch, int start, int length,
+                    struct sampleSpan* span);
+
+/* Copies length samples of channel ch, from start on, into out
+ *
+ * Returns 0, or -1 if the channel or range is out of bounds.
+ */
+int copySamples(struct dataset* s, int ch, int start, int length,
+                signed short* out);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/drivers/bfin_spartan/include/mappeddataset.h
+ */
+
+#ifndef RAM_DRIVER_BFIN_MAPPEDDATASET_07_15_2011
+#define RAM_DRIVER_BFIN_MAPPEDDATASET_07_15_2011
+
+// STD Includes
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DATASET_CHANNELS 4
+
+/* Bytes of one sample of every channel in a raw capture */
+#define DATASET_FRAME_SIZE (DATASET_CHANNELS * 2)
+
+/* Starts a planar dataset file, followed by a 64 bit little endian count of
+ * samples per channel, then each channel after the other */
+#define PLANAR_DATASET_MAGIC "RAMSONP1"
+#define PLANAR_DATASET_HEADER_SIZE 16
+
+/* A run of samples from one channel
+ *
+ * Sample i is data[i * stride].  The span was bounds checked when it was
+ * made, so the samples can be read in a tight loop without any more checks.
+ */
+struct sampleSpan
+{
+    const signed short* data;
+    int length;
+    int stride;
+};
+
+static inline signed short spanSample(const struct sampleSpan* span, int i)
+{
+    return span->data[i * span->stride];
+}
+
+/* A capture on disk, mapped into memory instead of being read in
+ *
+ * Raw captures, as written by the sonar board, have the samples of all four
+ * channels interleaved, so their spans have a stride of DATASET_CHANNELS.
+ * Planar files, made from captures by planarizeDataset, store each channel
+ * contiguously, so their spans have a stride of 1.  Pages are read in by
+ * the kernel as they are touched, so opening a dataset is immediate however
+ * big it is.
+ */
+struct mappedDataset
+{
+    /* Samples per channel */
+    int64_t size;
+
+    /* 1 when each channel is contiguous */
+    int planar;
+
+    /* The first sample of the first channel */
+    const signed short* samples;
+
+    void* mapping;
+    size_t mappingSize;
+};
+
+/* Maps a raw capture, or planar dataset, read only
+ *
+ * Returns NULL if the file can not be opened or mapped, which happens for
+ * files bigger than the address space on 32 bit machines.  Those can still
+ * be read with a datasetReader.
+ */
+struct mappedDataset* mapDataset(const char* filename);
+
+int unmapDataset(struct mappedDataset* s);
+
+/* Fills span with length samples of channel ch from start on
+ *
+ * Returns 0, or -1 if the channel or range is out of bounds.
+ */
+int datasetSpan(const struct mappedDataset* s, int ch, int64_t start,
+                int length, struct sampleSpan* span);
+
+/* Reads a raw capture from start to end, a block at a time
+ *
+ * Only one block is ever in memory, so captures of any size can be read.
+ * Each block is split into contiguous channels as it is read.
+ */
+struct datasetReader
+{
+    int fd;
+
+    /* Samples per channel in the capture */
+    int64_t size;
+
+    /* Index of the first sample of the current block */
+    int64_t position;
+
+    /* Samples per channel in the current block */
+    int length;
+
+    /* Most samples per channel in a block */
+    int blockSize;
+
+    unsigned char* raw;
+    signed short* channels[DATASET_CHANNELS];
+};
+
+/* Opens a raw capture for reading in blocks of blockSize samples */
+struct datasetReader* openDatasetReader(const char* filename, int blockSize);
+
+int closeDatasetReader(struct datasetReader* r);
+
+/* Reads the next block, filling one span per channel
+ *
+ * Returns the number of samples per channel read, 0 at the end of the
+ * capture, or -1 on a read error.
+ */
+int readDatasetBlock(struct datasetReader* r,
+                     struct sampleSpan spans[DATASET_CHANNELS]);
+
+/* Writes a planar copy of a raw capture, for mapping with mapDataset
+ *
+ * The capture is streamed through a datasetReader, so it need not fit in
+ * memory.  Returns 0, or -1 on error.
+ */
+int planarizeDataset(const char* capture, const char* planar);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // RAM_DRIVER_BFIN_MAPPEDDATASET_07_15_2011
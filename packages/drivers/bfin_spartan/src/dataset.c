@@ -19,6 +19,7 @@
 
 // Project Includes
 #include "drivers/bfin_spartan/include/dataset.h"
+#include "drivers/bfin_spartan/include/mappeddataset.h"
 
 struct dataset * createDataset(int size)
 {
@@ -130,16 +131,70 @@ int putSample(struct dataset* s, int ch, int index, signed short value)
     return 0; //added by ML.  Otherwise, no return for non-void
 }
 
+int datasetUnitSpan(struct dataset* s, int ch, int start, int length,
+                    struct sampleSpan* span)
+{
+    if(s == NULL || span == NULL)
+        return -1;
+
+    if(ch < 0 || ch > 3)
+    {
+        fprintf(stderr, "Bad channel number: %d\n", ch);
+        return -1;
+    }
+
+    if(start < 0 || length < 0 || length > s->size - start)
+    {
+        fprintf(stderr, "Span out of range! Size: %d, requested: %d to %d\n",
+                s->size, start, start + length);
+        return -1;
+    }
+
+    int unit = start >> ALLOC_UNIT_NUMBITS;
+    int offset = start & ALLOC_UNIT_MASK;
+    if(length > ALLOC_UNIT_SIZE - offset)
+        length = ALLOC_UNIT_SIZE - offset;
+
+    span->data = s->data[unit][ch] + offset;
+    span->length = length;
+    span->stride = 1;
+    return length;
+}
+
+int copySamples(struct dataset* s, int ch, int start, int length,
+                signed short* out)
+{
+    struct sampleSpan span;
+    while(length > 0)
+    {
+        if(datasetUnitSpan(s, ch, start, length, &span) < 0)
+            return -1;
+
+        memcpy(out, span.data, span.length * sizeof(signed short));
+        out += span.length;
+        start += span.length;
+        length -= span.length;
+    }
+    return 0;
+}
+
 struct dataset * loadDataset(const char * filename)
 {
-    struct stat fileStat;
-    if(stat(filename, &fileStat) != 0)
+    // Each block read is exactly one allocation unit of every channel
+    struct datasetReader * r = openDatasetReader(filename, ALLOC_UNIT_SIZE);
+    if(!r)
+        return NULL;
+
+    fprintf(stderr, "Loading a dataset of %lld bytes\n",
+            (long long) r->size * DATASET_FRAME_SIZE);
+    if(r->size > (int64_t) MAX_SEGMENTS * ALLOC_UNIT_SIZE)
     {
-        fprintf(stderr, "Could not stat file\n");
+        fprintf(stderr, "Dataset too large to load, use mapDataset or a "
+                "datasetReader\n");
+        closeDatasetReader(r);
         return NULL;
     }
-    fprintf(stderr, "Loading a dataset of %d bytes\n", (int)fileStat.st_size); //gives warning about %d.  Check that this is right?
-    struct dataset * s = createDataset(fileStat.st_size / 8);
+    struct dataset * s = createDataset((int) r->size);
 
     if(!s)
     {
@@ -147,18 +202,19 @@ struct dataset * loadDataset(const char * filename)
         exit(-1);
     }
 
-    FILE * f = fopen(filename, "rb");
+    struct sampleSpan spans[DATASET_CHANNELS];
+    int unit, j, length;
+    for(unit=0; (length = readDatasetBlock(r, spans)) > 0; unit++)
+        for(j=0; j<4; j++)
+            memcpy(s->data[unit][j], spans[j].data,
+                   length * sizeof(signed short));
+
+    closeDatasetReader(r);
 
-    if(!f)
+    if(length < 0)
     {
-        fprintf(stderr, "Could not open dataset\n");
         destroyDataset(s);
         return NULL;
     }
-
-    int i, j;
-    for(i=0; i<fileStat.st_size / 8; i++)
-        for(j=0; j<4; j++)
-            putSample(s, j, i, (signed short) (fgetc(f) | (fgetc(f) << 8)));
     return s;
 }
@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/drivers/bfin_spartan/src/mappeddataset.c
+ */
+
+// Captures run to several gigabytes, past the range of a 32 bit off_t
+#define _FILE_OFFSET_BITS 64
+
+// STD Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+// UNIX Includes
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Project Includes
+#include "drivers/bfin_spartan/include/mappeddataset.h"
+
+/* Samples are stored little endian, like the Blackfin and x86 which read
+ * them, so they are used straight from the mapping. */
+
+static int readPlanarHeader(const unsigned char* header, int64_t* size)
+{
+    if(memcmp(header, PLANAR_DATASET_MAGIC, 8) != 0)
+        return -1;
+
+    uint64_t count = 0;
+    int i;
+    for(i=7; i>=0; i--)
+        count = (count << 8) | header[8 + i];
+    *size = (int64_t) count;
+    return 0;
+}
+
+struct mappedDataset* mapDataset(const char* filename)
+{
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0)
+    {
+        fprintf(stderr, "Could not open dataset %s: %s\n", filename,
+                strerror(errno));
+        return NULL;
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0)
+    {
+        fprintf(stderr, "Could not stat dataset %s\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    if((uint64_t) fileStat.st_size > (uint64_t) (size_t) -1)
+    {
+        fprintf(stderr, "Dataset %s is too big to map, read it with a "
+                "datasetReader\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+    struct mappedDataset* s =
+        (struct mappedDataset*) malloc(sizeof(struct mappedDataset));
+    memset(s, 0, sizeof(struct mappedDataset));
+    s->mappingSize = (size_t) fileStat.st_size;
+
+    if(s->mappingSize > 0)
+    {
+        s->mapping = mmap(NULL, s->mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+        if(s->mapping == MAP_FAILED)
+        {
+            fprintf(stderr, "Could not map dataset %s: %s\n", filename,
+                    strerror(errno));
+            close(fd);
+            free(s);
+            return NULL;
+        }
+    }
+
+    // The mapping stays valid once the file is closed
+    close(fd);
+
+    const unsigned char* bytes = (const unsigned char*) s->mapping;
+    int64_t planarSize = 0;
+    if(s->mappingSize >= PLANAR_DATASET_HEADER_SIZE &&
+       readPlanarHeader(bytes, &planarSize) == 0)
+    {
+        // Divided rather than multiplied, a bad count can't overflow
+        if(planarSize < 0 || (uint64_t) planarSize >
+           (s->mappingSize - PLANAR_DATASET_HEADER_SIZE) / DATASET_FRAME_SIZE)
+        {
+            fprintf(stderr, "Planar dataset %s is truncated\n", filename);
+            unmapDataset(s);
+            return NULL;
+        }
+
+        s->planar = 1;
+        s->size = planarSize;
+        s->samples = (const signed short*)
+            (bytes + PLANAR_DATASET_HEADER_SIZE);
+    }
+    else
+    {
+        // Any trailing partial frame is ignored, like loadDataset does
+        s->planar = 0;
+        s->size = s->mappingSize / DATASET_FRAME_SIZE;
+        s->samples = (const signed short*) bytes;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    // Datasets are nearly always scanned from start to end
+    if(s->mapping)
+        madvise(s->mapping, s->mappingSize, MADV_SEQUENTIAL);
+#endif
+
+    return s;
+}
+
+int unmapDataset(struct mappedDataset* s)
+{
+    if(s == NULL)
+        return -1;
+
+    if(s->mapping)
+        munmap(s->mapping, s->mappingSize);
+    free(s);
+    return 0;
+}
+
+int datasetSpan(const struct mappedDataset* s, int ch, int64_t start,
+                int length, struct sampleSpan* span)
+{
+    if(s == NULL || span == NULL)
+        return -1;
+
+    if(ch < 0 || ch >= DATASET_CHANNELS)
+    {
+        fprintf(stderr, "Bad channel number: %d\n", ch);
+        return -1;
+    }
+
+    if(start < 0 || length < 0 || length > s->size - start)
+    {
+        fprintf(stderr, "Span out of range! Size: %lld, requested: %lld "
+                "to %lld\n", (long long) s->size, (long long) start,
+                (long long) (start + length));
+        return -1;
+    }
+
+    if(s->planar)
+    {
+        span->data = s->samples + ch * s->size + start;
+        span->stride = 1;
+    }
+    else
+    {
+        span->data = s->samples + start * DATASET_CHANNELS + ch;
+        span->stride = DATASET_CHANNELS;
+    }
+    span->length = length;
+    return 0;
+}
+
+struct datasetReader* openDatasetReader(const char* filename, int blockSize)
+{
+    if(blockSize <= 0)
+    {
+        fprintf(stderr, "Bad block size: %d\n", blockSize);
+        return NULL;
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if(fd < 0)
+    {
+        fprintf(stderr, "Could not open dataset %s: %s\n", filename,
+                strerror(errno));
+        return NULL;
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0)
+    {
+        fprintf(stderr, "Could not stat dataset %s\n", filename);
+        close(fd);
+        return NULL;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    struct datasetReader* r =
+        (struct datasetReader*) malloc(sizeof(struct datasetReader));
+    memset(r, 0, sizeof(struct datasetReader));
+    r->fd = fd;
+    r->size = fileStat.st_size / DATASET_FRAME_SIZE;
+    r->blockSize = blockSize;
+    r->raw = (unsigned char*) malloc((size_t) blockSize * DATASET_FRAME_SIZE);
+
+    int ch;
+    int failed = (r->raw == NULL);
+    for(ch=0; ch<DATASET_CHANNELS; ch++)
+    {
+        r->channels[ch] =
+            (signed short*) malloc((size_t) blockSize * sizeof(signed short));
+        failed = failed || (r->channels[ch] == NULL);
+    }
+
+    if(failed)
+    {
+        fprintf(stderr, "Could not allocate blocks of %d samples\n",
+                blockSize);
+        closeDatasetReader(r);
+        return NULL;
+    }
+
+    return r;
+}
+
+int closeDatasetReader(struct datasetReader* r)
+{
+    if(r == NULL)
+        return -1;
+
+    int ch;
+    for(ch=0; ch<DATASET_CHANNELS; ch++)
+        free(r->channels[ch]);
+    free(r->raw);
+    close(r->fd);
+    free(r);
+    return 0;
+}
+
+int readDatasetBlock(struct datasetReader* r,
+                     struct sampleSpan spans[DATASET_CHANNELS])
+{
+    if(r == NULL)
+        return -1;
+
+    r->position += r->length;
+    r->length = 0;
+
+    int64_t remaining = r->size - r->position;
+    int length = remaining < r->blockSize ? (int) remaining : r->blockSize;
+    size_t wanted = (size_t) length * DATASET_FRAME_SIZE;
+
+    // Fill the whole block, read() may return less than asked for
+    size_t got = 0;
+    while(got < wanted)
+    {
+        ssize_t bytes = read(r->fd, r->raw + got, wanted - got);
+        if(bytes > 0)
+            got += bytes;
+        else if(bytes == 0)
+            break;
+        else if(errno != EINTR)
+        {
+            fprintf(stderr, "Could not read dataset: %s\n", strerror(errno));
+            return -1;
+        }
+    }
+    length = got / DATASET_FRAME_SIZE;
+
+    const unsigned char* frame = r->raw;
+    signed short* ch0 = r->channels[0];
+    signed short* ch1 = r->channels[1];
+    signed short* ch2 = r->channels[2];
+    signed short* ch3 = r->channels[3];
+    int i;
+    for(i=0; i<length; i++, frame += DATASET_FRAME_SIZE)
+    {
+        ch0[i] = (signed short) (frame[0] | (frame[1] << 8));
+        ch1[i] = (signed short) (frame[2] | (frame[3] << 8));
+        ch2[i] = (signed short) (frame[4] | (frame[5] << 8));
+        ch3[i] = (signed short) (frame[6] | (frame[7] << 8));
+    }
+
+    int ch;
+    for(ch=0; ch<DATASET_CHANNELS; ch++)
+    {
+        spans[ch].data = r->channels[ch];
+        spans[ch].length = length;
+        spans[ch].stride = 1;
+    }
+
+    r->length = length;
+    return length;
+}
+
+int planarizeDataset(const char* capture, const char* planar)
+{
+    struct datasetReader* r = openDatasetReader(capture, 1 << 16);
+    if(r == NULL)
+        return -1;
+
+    int fd = open(planar, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        fprintf(stderr, "Could not create %s: %s\n", planar, strerror(errno));
+        closeDatasetReader(r);
+        return -1;
+    }
+
+    unsigned char header[PLANAR_DATASET_HEADER_SIZE];
+    memcpy(header, PLANAR_DATASET_MAGIC, 8);
+    int i;
+    for(i=0; i<8; i++)
+        header[8 + i] = (unsigned char) ((uint64_t) r->size >> (8 * i));
+
+    int result = 0;
+    if(write(fd, header, sizeof(header)) != (ssize_t) sizeof(header))
+        result = -1;
+
+    // Each block goes to the same place in every channel
+    struct sampleSpan spans[DATASET_CHANNELS];
+    int length = 0;
+    while(result == 0 && (length = readDatasetBlock(r, spans)) > 0)
+    {
+        int ch;
+        for(ch=0; ch<DATASET_CHANNELS && result == 0; ch++)
+        {
+            size_t bytes = (size_t) length * sizeof(signed short);
+            off_t offset = PLANAR_DATASET_HEADER_SIZE +
+                ((off_t) ch * r->size + r->position) * sizeof(signed short);
+            if(pwrite(fd, spans[ch].data, bytes, offset) != (ssize_t) bytes)
+                result = -1;
+        }
+    }
+    if(length < 0)
+        result = -1;
+
+    if(result != 0)
+        fprintf(stderr, "Could not write %s: %s\n", planar, strerror(errno));
+
+    close(fd);
+    closeDatasetReader(r);
+    return result;
+}
@@ -23,6 +23,12 @@ extern "C" {
 #define SYNC_FAIL_MILLISEC 1000
 #define SYNC_FAIL_SECONDS (SYNC_FAIL_MILLISEC/1000)
 
+/* The largest packet, checksum included, we will accept */
+#define DVL_MAX_PACKET 512
+
+/* The smallest packet holding everything RawDVLData takes from PD4 */
+#define DVL_MIN_PACKET 41
+
 /* These are error messages */
 #define ERR_NOSYNC            0x0001
 #define ERR_TOOBIG            0x0002
@@ -112,6 +118,30 @@ int openDVL(const char *devName);
  */
 int readDVLData(int fd, RawDVLData *dvl);
 
+/** Decodes a complete PD4 packet, starting with its 0x7D00 sync
+ *
+ *  @param len  Bytes in the packet, including the checksum
+ *
+ *  @return  0 on success, ERR_CHKSUM if the checksum does not match
+ */
+int dvl_decodePacket(const unsigned char *packet, int len, RawDVLData *dvl);
+
+/** Parses the first complete packet out of bytes read from the DVL
+ *
+ *  Meant to be called each time more bytes arrive, with every byte not yet
+ *  consumed.  Bytes before the sync are skipped, and a packet which is too
+ *  big or has a bad checksum only gives up its sync, so parsing picks up
+ *  again at the next sync.
+ *
+ *  @param consumed  Set to the number of bytes which can be discarded
+ *
+ *  @return  1 if dvl was filled with a good packet, 0 if more bytes are
+ *           needed, or the error (ERR_TOOBIG, ERR_CHKSUM) of a bad packet
+ *           negated
+ */
+int dvl_parsePacket(const unsigned char *data, int len, RawDVLData *dvl,
+                    int *consumed);
+
 // If we are compiling as C++ code we need to use extern "C" linkage
 #ifdef __cplusplus
 } // extern "C"
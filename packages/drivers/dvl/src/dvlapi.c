@@ -84,17 +84,15 @@ int readDVLData(int fd, RawDVLData* dvl)
     /* So in the PD4 data format we should only get 47 bytes.
        We'll stick with the enormous buffer just in case.
        */
-    unsigned char dvlData[512];
+    unsigned char dvlData[DVL_MAX_PACKET];
 
-    int len, i, tempsize;
-    uint16_t checksum;
+    int len, tempsize;
     static CompleteDVLPacket dbgpkt;
 
     if(dvl_waitSync(fd))
         return dvl->valid= ERR_NOSYNC;
 
     dvl->valid= -1; // Packet is not yet valid
-    dvl->privDbgInf= &dbgpkt;
 
     /* We got these in the dvl_waitSync() call */
     dvlData[0]= 0x7D;
@@ -107,24 +105,37 @@ int readDVLData(int fd, RawDVLData* dvl)
     while(len < 4)
         len+= read(fd, dvlData + len, 6 - len);
 
-    tempsize= dvl_convert16(dvlData[3], dvlData[2]);
+    /* The size does not include the two checksum bytes */
+    tempsize= dvl_convert16(dvlData[3], dvlData[2]) + 2;
+    if(tempsize < DVL_MIN_PACKET || tempsize > DVL_MAX_PACKET)
+        return dvl->valid= ERR_TOOBIG;
 
     while(len < tempsize)
         len+= read(fd, dvlData + len, tempsize - len);
 
-    checksum= 0;
-    for(i= 0;i < len;i++)
-        checksum+= dvlData[i];
+    dbgpkt.checksum= dvl_convert16(dvlData[len - 1], dvlData[len - 2]);
 
-    tempsize+= 2;
-    while(len < tempsize)
-        len+= read(fd, dvlData + len, tempsize - len);
+    if(dvl_decodePacket(dvlData, len, dvl)) {
+        fprintf(stderr, "WARNING! Bad checksum.\n");
+        return ERR_CHKSUM;
+    }
 
-    dbgpkt.checksum= dvl_convert16(dvlData[46], dvlData[45]);
+    dvl->privDbgInf= &dbgpkt;
+    return 0;
+}
 
-    if(checksum != dbgpkt.checksum) {
-        fprintf(stderr, "WARNING! Bad checksum.\n");
-        fprintf(stderr, "Expected 0x%02x but got 0x%02x\n", checksum, dbgpkt.checksum);
+int dvl_decodePacket(const unsigned char *dvlData, int len, RawDVLData *dvl)
+{
+    int i;
+    uint16_t checksum= 0;
+
+    dvl->privDbgInf= NULL;
+
+    /* The checksum is the last two bytes, and covers everything before */
+    for(i= 0;i < len - 2;i++)
+        checksum+= dvlData[i];
+
+    if(checksum != dvl_convert16(dvlData[len - 1], dvlData[len - 2])) {
         dvl->valid= ERR_CHKSUM;
         return ERR_CHKSUM;
     }
@@ -152,6 +163,46 @@ int readDVLData(int fd, RawDVLData* dvl)
     return 0;
 }
 
+int dvl_parsePacket(const unsigned char *data, int len, RawDVLData *dvl,
+                    int *consumed)
+{
+    int start, size;
+
+    /* Find the 0x7D00 sync, like dvl_waitSync */
+    for(start= 0;start < len - 1;start++) {
+        if(data[start] == 0x7D && data[start + 1] == 0x00)
+            break;
+    }
+
+    if(start >= len - 1) {
+        /* A trailing 0x7D may be the start of the next sync */
+        *consumed= (len > 0 && data[len - 1] == 0x7D) ? len - 1 : len;
+        return 0;
+    }
+
+    *consumed= start;
+    if(len - start < 4)
+        return 0;
+
+    /* The size covers everything but the checksum */
+    size= dvl_convert16(data[start + 3], data[start + 2]) + 2;
+    if(size < DVL_MIN_PACKET || size > DVL_MAX_PACKET) {
+        *consumed= start + 2;
+        return -ERR_TOOBIG;
+    }
+
+    if(len - start < size)
+        return 0;
+
+    if(dvl_decodePacket(data + start, size, dvl)) {
+        *consumed= start + 2;
+        return -ERR_CHKSUM;
+    }
+
+    *consumed= start + size;
+    return 1;
+}
+
 /* Some code from cutecom, which in turn may have come from minicom */
 int openDVL(const char* devName)
 {
@@ -38,6 +38,12 @@ typedef struct _RawIMUData
     int checksumValid;
 } RawIMUData;
 
+/** Bytes of a frame after the four 0xFF sync bytes, ending in the checksum */
+#define IMU_FRAME_SIZE 34
+
+/** Bytes of sync before each frame */
+#define IMU_SYNC_SIZE 4
+
 /** Opens a serial channel to the imu using the given devices
  *
  *  @param  devName  Device filename
@@ -52,6 +58,29 @@ int openIMU(const char * devName);
  */
 int readIMUData(int fd, RawIMUData * imu);
 
+/** Decodes the frame following the sync bytes, and checks its checksum
+ *
+ *  @param frame  IMU_FRAME_SIZE bytes, without the sync
+ *
+ *  @return  Non zero if the checksum was valid
+ */
+int imu_decodeFrame(const unsigned char* frame, RawIMUData* imu);
+
+/** Parses the first complete frame out of bytes read from the IMU
+ *
+ *  Meant to be called each time more bytes arrive, with every byte not yet
+ *  consumed.  Bytes before the sync are skipped, and a frame with a bad
+ *  checksum only gives up its sync bytes, so parsing picks up again at the
+ *  next sync.
+ *
+ *  @param consumed  Set to the number of bytes which can be discarded
+ *
+ *  @return  1 if imu was filled with a good frame, 0 if more bytes are
+ *           needed, -1 if a frame had a bad checksum
+ */
+int imu_parseFrame(const unsigned char* data, int len, RawIMUData* imu,
+                   int* consumed);
+
 // If we are compiling as C++ code we need to use extern "C" linkage
 #ifdef __cplusplus
 } // extern "C"
@@ -70,14 +70,23 @@ double imu_convertData(unsigned char msb, unsigned char lsb, double range)
 
 int readIMUData(int fd, RawIMUData* imu)
 {
-    unsigned char imuData[34];
+    unsigned char imuData[IMU_FRAME_SIZE];
 
     imu_waitSync(fd);
 
     int len = 0;
+    while(len < IMU_FRAME_SIZE)
+        len += read(fd, imuData+len, IMU_FRAME_SIZE-len);
+
+    if(!imu_decodeFrame(imuData, imu))
+        printf("WARNING! IMU Checksum Bad!\n");
+
+    return imu->checksumValid;
+}
+
+int imu_decodeFrame(const unsigned char* imuData, RawIMUData* imu)
+{
     int i=0, sum=0;
-    while(len < 34)
-        len += read(fd, imuData+len, 34-len);
 
     imu->messageID = imuData[0];
     imu->sampleTimer = (imuData[3]<<8) | imuData[4];
@@ -98,19 +107,55 @@ int readIMUData(int fd, RawIMUData* imu)
     imu->tempY = (((imu_convert16(imuData[29], imuData[30])*5.0)/32768.0)/0.0084)+25.0;
     imu->tempZ = (((imu_convert16(imuData[31], imuData[32])*5.0)/32768.0)/0.0084)+25.0;
 
-    for(i=0; i<33; i++)
+    for(i=0; i<IMU_FRAME_SIZE-1; i++)
         sum+=imuData[i];
 
-    sum += 0xFF * 4;
+    sum += 0xFF * IMU_SYNC_SIZE;
 
-    imu->checksumValid = (imuData[33] == (sum&0xFF));
-
-    if(!imu->checksumValid)
-        printf("WARNING! IMU Checksum Bad!\n");
+    imu->checksumValid = (imuData[IMU_FRAME_SIZE-1] == (sum&0xFF));
 
     return imu->checksumValid;
 }
 
+int imu_parseFrame(const unsigned char* data, int len, RawIMUData* imu,
+                   int* consumed)
+{
+    int start = 0;
+    int fs = 0;
+
+    /* Find the end of the first run of sync bytes, like imu_waitSync */
+    while(start < len && fs != IMU_SYNC_SIZE)
+    {
+        if(data[start] == 0xFF)
+            fs++;
+        else
+            fs=0;
+        start++;
+    }
+
+    if(fs != IMU_SYNC_SIZE)
+    {
+        /* Keep any sync bytes seen so far, they may start the next frame */
+        *consumed = start - fs;
+        return 0;
+    }
+
+    if(len - start < IMU_FRAME_SIZE)
+    {
+        *consumed = start - IMU_SYNC_SIZE;
+        return 0;
+    }
+
+    if(!imu_decodeFrame(data + start, imu))
+    {
+        *consumed = start;
+        return -1;
+    }
+
+    *consumed = start + IMU_FRAME_SIZE;
+    return 1;
+}
+
 /*
 int openIMU(const char * devName)
 {
@@ -26,6 +26,7 @@
 // Project Includes
 #include "estimation/include/IStateEstimator.h"
 #include "estimation/include/Obstacle.h"
+#include "estimation/include/StateHistory.h"
 
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/EventPublisher.h"
@@ -73,6 +74,28 @@ public:
     void setEstimatedThrust(math::Vector3 forces, math::Vector3 torques);
     void setEstimatedMass(double mass);
 
+    /* Each change to the position, depth or orientation, or their rates, is
+       kept in a StateHistory, the "historySize" most recent snapshots at least
+       "historyResolution" seconds apart, so measurements which arrive late
+       can be fused against the state when they were taken.  Times are
+       microseconds on the clock of core::LatencyTracker::now(), the clock
+       of Event::arrivalTime. */
+
+    /** Gets the state at the time, the current state if the time is 0
+     *
+     *  @return
+     *      false if the time is older than the history, the oldest state
+     *      kept is given instead
+     */
+    bool getStateAt(boost::int64_t time, StateSnapshot& state);
+
+    /** Fuses a position fix taken at the given time
+     *
+     *  The current position, and the history since the time, are moved by
+     *  the difference between the fix and the position at that time.
+     */
+    void correctEstimatedPosition(boost::int64_t time, math::Vector2 position);
+
 
     /* The estimated state will contain all information about obstacles in a
        mapping from obstacle name to a pointer to that obstacle.  These functions
@@ -88,6 +111,9 @@ public:
 
 private:
 
+    /** Records the current state in the history, the lock must be held */
+    void recordState();
+
     void publishPositionUpdate(const math::Vector2& position);
     void publishVelocityUpdate(const math::Vector2& velocity);
     void publishLinearAccelUpdate(const math::Vector3& linearAccel);
@@ -115,6 +141,8 @@ private:
 
     std::map<Obstacle::ObstacleType, ObstaclePtr> m_obstacleMap;
 
+    StateHistory m_history;
+
 
 };
 
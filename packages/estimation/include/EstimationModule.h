@@ -54,6 +54,9 @@ public:
     virtual void update(core::EventPtr event) = 0;
 
 protected:
+    /** Calls update, then records how old the sensor data of the event is */
+    void handleEvent(core::EventPtr event);
+
     std::string m_name;
     EstimatedStatePtr m_estimatedState;
     core::EventConnectionPtr m_connection;
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/estimation/include/StateHistory.h
+ */
+
+/* StateHistory keeps the recent estimated states of the vehicle so that
+** measurements which arrive late, like those from vision, can be fused
+** against the state the vehicle was in when they were taken.
+*/
+
+#ifndef RAM_ESTIMATION_STATEHISTORY_H
+#define RAM_ESTIMATION_STATEHISTORY_H
+
+// STD Includes
+#include <vector>
+#include <cstddef>
+
+// Library Includes
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "math/include/Vector2.h"
+#include "math/include/Vector3.h"
+#include "math/include/Quaternion.h"
+
+namespace ram {
+namespace estimation {
+
+/** The estimated vehicle state at one time */
+struct StateSnapshot
+{
+    StateSnapshot();
+
+    /** Microseconds on the clock of core::LatencyTracker::now() */
+    boost::int64_t time;
+
+    math::Vector2 position;
+    math::Vector2 velocity;
+    double depth;
+    double depthRate;
+    math::Quaternion orientation;
+    math::Vector3 angularRate;
+};
+
+/** A bounded ring of timestamped state snapshots, oldest dropped first
+ *
+ *  Snapshots are kept no closer together than the resolution, a snapshot
+ *  recorded within it of the start of the newest one replaces it, so a
+ *  burst of setters from one sensor update only takes one slot.  The ring
+ *  is allocated up front and nothing is allocated afterwards.  Not thread
+ *  safe, EstimatedState guards it with its own lock.
+ */
+class StateHistory
+{
+public:
+    /** @param size - the most snapshots kept
+     *  @param resolution - microseconds between kept snapshots
+     */
+    StateHistory(size_t size = 512, boost::int64_t resolution = 2000);
+
+    /** Adds the state as the newest, its time must not go backwards */
+    void record(const StateSnapshot& state);
+
+    /** Interpolates the state at the given time
+     *
+     *  Positions, rates and depth are interpolated linearly, orientation
+     *  spherically, between the snapshots on either side of the time.
+     *  Times after the newest snapshot give the newest.
+     *
+     *  @return
+     *      false if there is no history, or the time is older than all of
+     *      it, in which case the oldest snapshot is given
+     */
+    bool getState(boost::int64_t time, StateSnapshot& state) const;
+
+    /** Moves the position of every snapshot from the time on by the offset
+     *
+     *  Position is only ever integrated from velocity, so a correction to
+     *  it at some past time shifts every later position by the same amount.
+     *  This re-propagates a delayed position fix without replaying the
+     *  sensor updates since.
+     *
+     *  @return
+     *      The number of snapshots moved
+     */
+    size_t shiftPosition(boost::int64_t time, const math::Vector2& offset);
+
+    /** The number of snapshots held */
+    size_t size() const;
+
+    /** The most snapshots which can be held */
+    size_t capacity() const;
+
+    /** The time of the oldest snapshot, 0 when empty */
+    boost::int64_t getOldestTime() const;
+
+    /** The time of the newest snapshot, 0 when empty */
+    boost::int64_t getNewestTime() const;
+
+    void clear();
+
+private:
+    /** The snapshot index places from the oldest */
+    StateSnapshot& at(size_t index);
+    const StateSnapshot& at(size_t index) const;
+
+    std::vector<StateSnapshot> m_states;
+
+    /** Where the oldest snapshot is */
+    size_t m_head;
+    size_t m_count;
+
+    boost::int64_t m_resolution;
+
+    /** When the newest snapshot was first recorded, before any replaced it */
+    boost::int64_t m_newestStart;
+};
+
+} // namespace estimation
+} // namespace ram
+
+#endif // RAM_ESTIMATION_STATEHISTORY_H
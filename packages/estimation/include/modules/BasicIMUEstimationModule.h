@@ -16,6 +16,7 @@
 // STD Includes
 #include <map>
 #include <string>
+#include <vector>
 
 // Library Includes
 
@@ -39,13 +40,9 @@ namespace estimation {
 
 const static int FILTER_SIZE = 30;
 
-typedef std::set<std::string> StringSet;
-
 typedef RawIMUData FilteredIMUData;
 typedef boost::shared_ptr<FilteredIMUData> FilteredIMUDataPtr;
-typedef std::map<std::string, FilteredIMUDataPtr > FilteredStateMap;
 typedef math::AveragingFilter<double, FILTER_SIZE> IMUAveragingFilter;
-typedef std::map<std::string, IMUAveragingFilter > DeviceAveragingMap;
 
 class BasicIMUEstimationModule : public EstimationModule
 {
@@ -65,26 +62,39 @@ private:
     // any helper functions should be prototyped here
 
 
-    // any necessary persistent variables should be declared here
-    StringSet imuList;
+    /** The filters and filtered data of one IMU */
+    struct IMUSlot
+    {
+        IMUSlot() : seen(false), filteredState() {}
+
+        /** Whether an update has come from this IMU yet */
+        bool seen;
+
+        // filterd and rotated IMU data
+        FilteredIMUData filteredState;
 
-    // filterd and rotated IMU data
-    FilteredStateMap m_filteredState;
+        IMUAveragingFilter accelX;
+        IMUAveragingFilter accelY;
+        IMUAveragingFilter accelZ;
+
+        IMUAveragingFilter gyroX;
+        IMUAveragingFilter gyroY;
+        IMUAveragingFilter gyroZ;
+
+        IMUAveragingFilter magX;
+        IMUAveragingFilter magY;
+        IMUAveragingFilter magZ;
+    };
 
     std::string m_magIMUName;
     std::string m_cgIMUName;
 
-    DeviceAveragingMap m_filteredAccelX; 
-    DeviceAveragingMap m_filteredAccelY;
-    DeviceAveragingMap m_filteredAccelZ; 
-
-    DeviceAveragingMap m_filteredGyroX; 
-    DeviceAveragingMap m_filteredGyroY;
-    DeviceAveragingMap m_filteredGyroZ;
+    /** SensorRegistry IDs of the two IMUs */
+    int m_magIMUID;
+    int m_cgIMUID;
 
-    DeviceAveragingMap m_filteredMagX; 
-    DeviceAveragingMap m_filteredMagY;
-    DeviceAveragingMap m_filteredMagZ; 
+    /** Indexed by sensor ID, only the slots of the two IMUs are used */
+    std::vector<IMUSlot> m_imus;
 
     core::ReadWriteMutex m_stateMutex;
 
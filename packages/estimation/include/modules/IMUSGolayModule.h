@@ -16,6 +16,7 @@
 // STD Includes
 #include <map>
 #include <string>
+#include <vector>
 
 // Library Includes
 
@@ -32,18 +33,14 @@
 #include "math/include/Vector3.h"
 #include "math/include/Quaternion.h"
 #include "math/include/Events.h"
-#include "math/include/SGolaySmoothingFilter.h"
+#include "math/include/SGolayFilterBank.h"
 
 namespace ram {
 namespace estimation {
 
 
-typedef std::set<std::string> StringSet;
-
 typedef RawIMUData FilteredIMUData;
 typedef boost::shared_ptr<FilteredIMUData> FilteredIMUDataPtr;
-typedef std::map<std::string, FilteredIMUDataPtr > FilteredStateMap;
-typedef std::map<std::string, math::SGolaySmoothingFilterPtr > DeviceSGolayMap;
 
 class IMUSGolayModule : public EstimationModule
 {
@@ -62,10 +59,20 @@ public:
 private:
     const static int FILTER_SIZE;
 
-    StringSet imuList;
+    /** The filter and filtered data of one IMU */
+    struct IMUSlot
+    {
+        IMUSlot() : seen(false), filteredState() {}
+
+        /** Whether an update has come from this IMU yet */
+        bool seen;
 
-    // filterd and rotated IMU data
-    FilteredStateMap m_filteredState;
+        // filterd and rotated IMU data
+        FilteredIMUData filteredState;
+
+        /** Accel, mag then gyro axes, filtered together */
+        math::SGolayFilterBankPtr filter;
+    };
 
     int m_degree;
     int m_windowSize;
@@ -73,17 +80,12 @@ private:
     std::string m_magIMUName;
     std::string m_cgIMUName;
 
-    DeviceSGolayMap m_filteredAccelX; 
-    DeviceSGolayMap m_filteredAccelY;
-    DeviceSGolayMap m_filteredAccelZ; 
-
-    DeviceSGolayMap m_filteredGyroX; 
-    DeviceSGolayMap m_filteredGyroY;
-    DeviceSGolayMap m_filteredGyroZ;
+    /** SensorRegistry IDs of the two IMUs */
+    int m_magIMUID;
+    int m_cgIMUID;
 
-    DeviceSGolayMap m_filteredMagX; 
-    DeviceSGolayMap m_filteredMagY;
-    DeviceSGolayMap m_filteredMagZ; 
+    /** Indexed by sensor ID, only the slots of the two IMUs are used */
+    std::vector<IMUSlot> m_imus;
 
     core::ReadWriteMutex m_stateMutex;
 
@@ -16,6 +16,7 @@
 #include "estimation/include/EstimatedState.h"
 #include "math/include/Events.h"
 #include "core/include/ReadWriteMutex.h"
+#include "core/include/LatencyTracker.h"
 
 namespace ram {
 namespace estimation {
@@ -31,7 +32,10 @@ EstimatedState::EstimatedState(core::ConfigNode config, core::EventHubPtr eventH
     m_estDepthRate(0),
     m_estThrusterForces(math::Vector3::ZERO), 
     m_estThrusterTorques(math::Vector3::ZERO),
-    m_estMass(0)
+    m_estMass(0),
+    m_history(config["historySize"].asInt(512),
+              (boost::int64_t)(config["historyResolution"].asDouble(0.002)
+                               * 1e6))
 {
 }
 
@@ -106,6 +110,7 @@ void EstimatedState::setEstimatedPosition(math::Vector2 position)
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
         m_estPosition = position;
+        recordState();
     }    
     publishPositionUpdate(position);
 }
@@ -115,6 +120,7 @@ void EstimatedState::setEstimatedVelocity(math::Vector2 velocity)
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
         m_estVelocity = velocity;
+        recordState();
     }
     publishVelocityUpdate(velocity);
 }
@@ -135,6 +141,7 @@ void EstimatedState::setEstimatedAngularRate(
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
         m_estAngularRate = angularRate;
+        recordState();
     }
     publishAngularRateUpdate(angularRate);
 }
@@ -147,6 +154,7 @@ void EstimatedState::setEstimatedOrientation(
         // make sure we only store and give out unit quaternions
         orientation.normalise();
         m_estOrientation = orientation;
+        recordState();
     }
     publishOrientationUpdate(orientation);
 }
@@ -156,6 +164,7 @@ void EstimatedState::setEstimatedDepth(double depth)
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
         m_estDepth = depth;
+        recordState();
     }
     publishDepthUpdate(depth);
 }
@@ -165,6 +174,7 @@ void EstimatedState::setEstimatedDepthRate(double depthRate)
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
         m_estDepthRate = depthRate;
+        recordState();
     }
     publishDepthRateUpdate(depthRate);
 }
@@ -192,6 +202,60 @@ void EstimatedState::setEstimatedMass(double mass)
     m_estMass = mass;
 }
 
+bool EstimatedState::getStateAt(boost::int64_t time, StateSnapshot& state)
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    if (0 == time || time >= m_history.getNewestTime())
+    {
+        state.time = time;
+        state.position = m_estPosition;
+        state.velocity = m_estVelocity;
+        state.depth = m_estDepth;
+        state.depthRate = m_estDepthRate;
+        state.orientation = m_estOrientation;
+        state.angularRate = m_estAngularRate;
+        return true;
+    }
+    return m_history.getState(time, state);
+}
+
+void EstimatedState::correctEstimatedPosition(boost::int64_t time,
+                                              math::Vector2 position)
+{
+    math::Vector2 corrected;
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
+        math::Vector2 offset = position - m_estPosition;
+
+        if (0 != time && time < m_history.getNewestTime())
+        {
+            // Everything since was integrated from the old position
+            StateSnapshot then;
+            m_history.getState(time, then);
+            offset = position - then.position;
+            m_history.shiftPosition(time, offset);
+        }
+
+        m_estPosition += offset;
+        corrected = m_estPosition;
+        recordState();
+    }
+    publishPositionUpdate(corrected);
+}
+
+void EstimatedState::recordState()
+{
+    StateSnapshot state;
+    state.time = core::LatencyTracker::now();
+    state.position = m_estPosition;
+    state.velocity = m_estVelocity;
+    state.depth = m_estDepth;
+    state.depthRate = m_estDepthRate;
+    state.orientation = m_estOrientation;
+    state.angularRate = m_estAngularRate;
+    m_history.record(state);
+}
+
 void EstimatedState::addObstacle(Obstacle::ObstacleType name, ObstaclePtr obstacle)
 {
     if(m_obstacleMap.find(name) == m_obstacleMap.end())
@@ -15,6 +15,7 @@
 
 // Package Includes
 #include "estimation/include/EstimationModule.h"
+#include "core/include/LatencyTracker.h"
 #include <boost/bind.hpp>
 
 namespace ram {
@@ -28,8 +29,9 @@ EstimationModule::EstimationModule(core::EventHubPtr eventHub,
     m_estimatedState(estState),
     m_connection(eventHub->subscribeToType(
                      type,
-                     boost::bind(&ram::estimation::EstimationModule::update,
-                                 this, _1)))
+                     boost::bind(
+                         &ram::estimation::EstimationModule::handleEvent,
+                         this, _1)))
 {
 }
 
@@ -38,5 +40,11 @@ EstimationModule::~EstimationModule()
     m_connection->disconnect();
 }
 
+void EstimationModule::handleEvent(core::EventPtr event)
+{
+    update(event);
+    core::LatencyTracker::record(event, core::LatencyTracker::ESTIMATOR);
+}
+
 } // namespace estimation
 } // namespace ram
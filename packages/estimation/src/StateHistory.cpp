@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/estimation/src/StateHistory.cpp
+ */
+
+// Project Includes
+#include "estimation/include/StateHistory.h"
+
+namespace ram {
+namespace estimation {
+
+StateSnapshot::StateSnapshot() :
+    time(0),
+    position(math::Vector2::ZERO),
+    velocity(math::Vector2::ZERO),
+    depth(0),
+    depthRate(0),
+    orientation(math::Quaternion::IDENTITY),
+    angularRate(math::Vector3::ZERO)
+{
+}
+
+StateHistory::StateHistory(size_t size, boost::int64_t resolution) :
+    m_states(size > 0 ? size : 1),
+    m_head(0),
+    m_count(0),
+    m_resolution(resolution),
+    m_newestStart(0)
+{
+}
+
+void StateHistory::record(const StateSnapshot& state)
+{
+    if (m_count > 0 && (state.time - m_newestStart) < m_resolution)
+    {
+        // Still within the newest snapshot, replace it
+        at(m_count - 1) = state;
+        return;
+    }
+
+    if (m_count < m_states.size())
+    {
+        m_count++;
+    }
+    else
+    {
+        // Full, drop the oldest
+        m_head = (m_head + 1) % m_states.size();
+    }
+    at(m_count - 1) = state;
+    m_newestStart = state.time;
+}
+
+bool StateHistory::getState(boost::int64_t time, StateSnapshot& state) const
+{
+    if (0 == m_count)
+        return false;
+
+    if (time < at(0).time)
+    {
+        state = at(0);
+        return false;
+    }
+
+    if (time >= at(m_count - 1).time)
+    {
+        state = at(m_count - 1);
+        return true;
+    }
+
+    // Find the first snapshot after the time, the one before is at or
+    // before it
+    size_t low = 1;
+    size_t high = m_count - 1;
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        if (at(middle).time > time)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+
+    const StateSnapshot& before = at(low - 1);
+    const StateSnapshot& after = at(low);
+    double fraction = (double)(time - before.time) /
+        (double)(after.time - before.time);
+
+    state.time = time;
+    state.position = before.position +
+        (after.position - before.position) * fraction;
+    state.velocity = before.velocity +
+        (after.velocity - before.velocity) * fraction;
+    state.depth = before.depth + (after.depth - before.depth) * fraction;
+    state.depthRate = before.depthRate +
+        (after.depthRate - before.depthRate) * fraction;
+    state.orientation = math::Quaternion::Slerp(
+        fraction, before.orientation, after.orientation, true);
+    state.angularRate = before.angularRate +
+        (after.angularRate - before.angularRate) * fraction;
+    return true;
+}
+
+size_t StateHistory::shiftPosition(boost::int64_t time,
+                                   const math::Vector2& offset)
+{
+    size_t shifted = 0;
+    while (shifted < m_count && at(m_count - 1 - shifted).time >= time)
+    {
+        at(m_count - 1 - shifted).position += offset;
+        shifted++;
+    }
+    return shifted;
+}
+
+size_t StateHistory::size() const
+{
+    return m_count;
+}
+
+size_t StateHistory::capacity() const
+{
+    return m_states.size();
+}
+
+boost::int64_t StateHistory::getOldestTime() const
+{
+    return m_count > 0 ? at(0).time : 0;
+}
+
+boost::int64_t StateHistory::getNewestTime() const
+{
+    return m_count > 0 ? at(m_count - 1).time : 0;
+}
+
+void StateHistory::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_newestStart = 0;
+}
+
+StateSnapshot& StateHistory::at(size_t index)
+{
+    return m_states[(m_head + index) % m_states.size()];
+}
+
+const StateSnapshot& StateHistory::at(size_t index) const
+{
+    return m_states[(m_head + index) % m_states.size()];
+}
+
+} // namespace estimation
+} // namespace ram
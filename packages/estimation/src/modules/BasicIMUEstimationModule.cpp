@@ -14,6 +14,7 @@
 
 // STD Includes
 #include <iostream>
+#include <algorithm>
 
 // Library Includes
 #include <log4cpp/Category.hh>
@@ -25,6 +26,7 @@
 #include "estimation/include/modules/BasicIMUEstimationModule.h"
 
 #include "vehicle/include/device/IIMU.h"
+#include "vehicle/include/device/SensorRegistry.h"
 
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("StEstIMU"));
 
@@ -37,7 +39,10 @@ BasicIMUEstimationModule::BasicIMUEstimationModule(core::ConfigNode config,
     EstimationModule(eventHub,"BasicIMUEstimationModule",estState,
                      vehicle::device::IIMU::RAW_UPDATE),
     m_magIMUName(config["magIMUNum"].asString("MagBoom")),
-    m_cgIMUName(config["cgIMUNum"].asString("IMU"))
+    m_cgIMUName(config["cgIMUNum"].asString("IMU")),
+    m_magIMUID(vehicle::device::SensorRegistry::intern(m_magIMUName)),
+    m_cgIMUID(vehicle::device::SensorRegistry::intern(m_cgIMUName)),
+    m_imus(std::max(m_magIMUID, m_cgIMUID) + 1)
 {
     /* initialization of estimator from config values should be done here */
     LOGGER.info("% IMU-Name[1] Accel[3] Mag[3] Gyro[3] Accel-Raw[3] Mag-Raw[3]"
@@ -58,9 +63,12 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
     /* This is where the estimation should be done
        The result should be stored in m_estimatedState */
 
-    std::string name = ievent->name;
+    /* Events made outside of a device, like in tests, are not stamped */
+    int id = ievent->sensorID;
+    if(vehicle::device::SensorRegistry::UNKNOWN == id)
+        id = vehicle::device::SensorRegistry::intern(ievent->name);
    
-    if(name != m_magIMUName && name != m_cgIMUName)
+    if(id != m_magIMUID && id != m_cgIMUID)
     {
         LOGGER.warn("BasicIMUEstimationModule: update: Invalid IMU Name");
         return;
@@ -68,106 +76,74 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
 
     double timestep = ievent->timestep;
     bool magIsCorrupt = ievent->magIsCorrupt;
-    imuList.insert(name);
 
-    if(m_filteredState.find(name) == m_filteredState.end())
-    {
-        FilteredIMUDataPtr filteredData = FilteredIMUDataPtr(
-            new FilteredIMUData());
-        m_filteredState[name] = filteredData;
-    }
+    IMUSlot& imu = m_imus[id];
+    imu.seen = true;
 
     /* grab the new state and filter it */
-    RawIMUData newState = ievent->rawIMUData;
-
-    m_filteredAccelX[name].addValue(newState.accelX); 
-    m_filteredAccelY[name].addValue(newState.accelY);
-    m_filteredAccelZ[name].addValue(newState.accelZ);
+    const RawIMUData& newState = ievent->rawIMUData;
 
-    m_filteredMagX[name].addValue(newState.magX);
-    m_filteredMagY[name].addValue(newState.magY);
-    m_filteredMagZ[name].addValue(newState.magZ);
+    imu.accelX.addValue(newState.accelX); 
+    imu.accelY.addValue(newState.accelY);
+    imu.accelZ.addValue(newState.accelZ);
 
-    m_filteredGyroX[name].addValue(newState.gyroX);
-    m_filteredGyroY[name].addValue(newState.gyroY);
-    m_filteredGyroZ[name].addValue(newState.gyroZ);
+    imu.magX.addValue(newState.magX);
+    imu.magY.addValue(newState.magY);
+    imu.magZ.addValue(newState.magZ);
 
-    if(m_filteredState.find(name) == m_filteredState.end())
-    {
-        LOGGER.warn("IMU filtered state has not been created yet.");
-        return;
-    }
+    imu.gyroX.addValue(newState.gyroX);
+    imu.gyroY.addValue(newState.gyroY);
+    imu.gyroZ.addValue(newState.gyroZ);
 
-    FilteredIMUDataPtr filteredState = m_filteredState[name];
+    FilteredIMUData& filteredState = imu.filteredState;
 
-    if(!filteredState)
-    {
-        LOGGER.warn("IMU filtered state smart pointer is empty.");
-        return;
-    }
-
-    filteredState->accelX = m_filteredAccelX[name].getValue();
-    filteredState->accelY = m_filteredAccelY[name].getValue();
-    filteredState->accelZ = m_filteredAccelZ[name].getValue();
+    filteredState.accelX = imu.accelX.getValue();
+    filteredState.accelY = imu.accelY.getValue();
+    filteredState.accelZ = imu.accelZ.getValue();
  
-    filteredState->magX = m_filteredMagX[name].getValue();
-    filteredState->magY = m_filteredMagY[name].getValue();
-    filteredState->magZ = m_filteredMagZ[name].getValue();
+    filteredState.magX = imu.magX.getValue();
+    filteredState.magY = imu.magY.getValue();
+    filteredState.magZ = imu.magZ.getValue();
     
-    filteredState->gyroX = m_filteredGyroX[name].getValue();
-    filteredState->gyroY = m_filteredGyroY[name].getValue();
-    filteredState->gyroZ = m_filteredGyroZ[name].getValue();
+    filteredState.gyroX = imu.gyroX.getValue();
+    filteredState.gyroY = imu.gyroY.getValue();
+    filteredState.gyroZ = imu.gyroZ.getValue();
 
     /* Pull the averaged values from the averaging filter and put them
      * into OGRE format for the following calculations
      */
 
-    if(m_filteredState.find(m_cgIMUName) == m_filteredState.end())
+    if(!m_imus[m_cgIMUID].seen)
     {
         LOGGER.warn("CG IMU not yet created");
         return;
     }
 
-    if(m_filteredState.find(m_magIMUName) == m_filteredState.end())
+    if(!m_imus[m_magIMUID].seen)
     {
         LOGGER.warn("MAGBOOM IMU not yet created");
         return;
     }
 
-    if(!(m_filteredState[m_cgIMUName]))
-    {
-        LOGGER.warn("CG IMU is empty.");
-        return;
-    }
-
-    if(!(m_filteredState[m_magIMUName]))
-    {
-        LOGGER.warn("MAGBOOM IMU is empty");
-        return;
-    }
-        
-    if(imuList.find(m_cgIMUName) == imuList.end())
-    {
-        LOGGER.warn("CG IMU not created yet so we cannot estimate anything");
-        return;
-    }
+    const FilteredIMUData& cgState = m_imus[m_cgIMUID].filteredState;
+    const FilteredIMUData& magState = m_imus[m_magIMUID].filteredState;
 
     math::Vector3 mag, accel;
     {
         core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-        accel[0] = m_filteredState[m_cgIMUName]->accelX;
-        accel[1] = m_filteredState[m_cgIMUName]->accelY;
-        accel[2] = m_filteredState[m_cgIMUName]->accelZ;
+        accel[0] = cgState.accelX;
+        accel[1] = cgState.accelY;
+        accel[2] = cgState.accelZ;
         
-        mag[0] = m_filteredState[m_cgIMUName]->magX;
-        mag[1] = m_filteredState[m_cgIMUName]->magY;
-        mag[2] = m_filteredState[m_cgIMUName]->magZ;
+        mag[0] = cgState.magX;
+        mag[1] = cgState.magY;
+        mag[2] = cgState.magZ;
     }
 
     math::Quaternion estOrientation = math::Quaternion::IDENTITY;
     
-    if(imuList.find(m_magIMUName) != imuList.end())
+    if(m_imus[m_magIMUID].seen)
     {
 
         /* If we have the magboom IMU, compute the quaternion from the
@@ -178,9 +154,9 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
         {
             core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-            mag[0] = m_filteredState[m_magIMUName]->magX;
-            mag[1] = m_filteredState[m_magIMUName]->magY;
-            mag[2] = m_filteredState[m_magIMUName]->magZ;
+            mag[0] = magState.magX;
+            mag[1] = magState.magY;
+            mag[2] = magState.magZ;
         }
         // LOGGER.info("quatFromMagAccel - With MagBoom");
         estOrientation = estimation::Utility::quaternionFromMagAccel(mag,accel);
@@ -210,9 +186,9 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
         {
             core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-            omega[0] = m_filteredState[m_cgIMUName]->gyroX;
-            omega[1] = m_filteredState[m_cgIMUName]->gyroY;
-            omega[2] = m_filteredState[m_cgIMUName]->gyroZ;
+            omega[0] = cgState.gyroX;
+            omega[1] = cgState.gyroY;
+            omega[2] = cgState.gyroZ;
         }
 
         math::Quaternion oldOrientation = 
@@ -224,13 +200,13 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
                                                                  timestep);
     }
 
-    math::Vector3 estLinearAccel(m_filteredState[m_cgIMUName]->accelX,
-                                 m_filteredState[m_cgIMUName]->accelY,
-                                 m_filteredState[m_cgIMUName]->accelZ);
+    math::Vector3 estLinearAccel(cgState.accelX,
+                                 cgState.accelY,
+                                 cgState.accelZ);
     
-    math::Vector3 estAngularRate(m_filteredState[m_cgIMUName]->gyroX,
-                                 m_filteredState[m_cgIMUName]->gyroY,
-                                 m_filteredState[m_cgIMUName]->gyroZ);
+    math::Vector3 estAngularRate(cgState.gyroX,
+                                 cgState.gyroY,
+                                 cgState.gyroZ);
 
     // Update local storage of previous orientation and estimator
     m_estimatedState->setEstimatedOrientation(estOrientation);
@@ -238,16 +214,16 @@ void BasicIMUEstimationModule::update(core::EventPtr event)
     m_estimatedState->setEstimatedAngularRate(estAngularRate);
 
     // Log data directly
-    LOGGER.infoStream() << name << " "
-                        << m_filteredState[name]->accelX << " "
-                        << m_filteredState[name]->accelY << " "
-                        << m_filteredState[name]->accelZ << " "
-                        << m_filteredState[name]->magX << " "
-                        << m_filteredState[name]->magY << " "
-                        << m_filteredState[name]->magZ << " "
-                        << m_filteredState[name]->gyroX << " "
-                        << m_filteredState[name]->gyroY << " "
-                        << m_filteredState[name]->gyroZ << " "
+    LOGGER.infoStream() << ievent->name << " "
+                        << filteredState.accelX << " "
+                        << filteredState.accelY << " "
+                        << filteredState.accelZ << " "
+                        << filteredState.magX << " "
+                        << filteredState.magY << " "
+                        << filteredState.magZ << " "
+                        << filteredState.gyroX << " "
+                        << filteredState.gyroY << " "
+                        << filteredState.gyroZ << " "
                         << newState.accelX << " "
                         << newState.accelY << " "
                         << newState.accelZ << " "
@@ -14,6 +14,7 @@
 
 // STD Includes
 #include <iostream>
+#include <algorithm>
 
 // Library Includes
 #include <log4cpp/Category.hh>
@@ -25,6 +26,7 @@
 #include "estimation/include/modules/IMUSGolayModule.h"
 
 #include "vehicle/include/device/IIMU.h"
+#include "vehicle/include/device/SensorRegistry.h"
 
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("StEstIMU"));
 
@@ -41,70 +43,21 @@ IMUSGolayModule::IMUSGolayModule(core::ConfigNode config,
     m_degree(config["degree"].asInt(2)),
     m_windowSize(config["windowSize"].asInt(25)),
     m_magIMUName(config["magIMUNum"].asString("MagBoom")),
-    m_cgIMUName(config["cgIMUNum"].asString("IMU"))
+    m_cgIMUName(config["cgIMUNum"].asString("IMU")),
+    m_magIMUID(vehicle::device::SensorRegistry::intern(m_magIMUName)),
+    m_cgIMUID(vehicle::device::SensorRegistry::intern(m_cgIMUName)),
+    m_imus(std::max(m_magIMUID, m_cgIMUID) + 1)
 {
     // initialization of estimator from config values should be done here
     LOGGER.info("% IMU-Name[1] Accel[3] Mag[3] Gyro[3] Accel-Raw[3] Mag-Raw[3]"
                 " Gyro-Raw[3] Quat[4] TimeStamp[1]");
 
-    // initialize accelerometer data filters
-    m_filteredAccelX[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
+    // one filter bank per IMU covers all nine axes
+    m_imus[m_magIMUID].filter = math::SGolayFilterBankPtr(
+        new math::SGolayFilterBank(9, m_windowSize, m_degree));
 
-    m_filteredAccelY[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredAccelZ[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredAccelX[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredAccelY[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredAccelZ[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-
-    // initialize magnetometer data filters
-    m_filteredMagX[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredMagY[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredMagZ[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredMagX[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredMagY[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredMagZ[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-
-    // initialize gyro data filters
-    m_filteredGyroX[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredGyroY[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredGyroZ[m_magIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredGyroX[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredGyroY[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
-
-    m_filteredGyroZ[m_cgIMUName] = math::SGolaySmoothingFilterPtr(
-        new math::SGolaySmoothingFilter(m_windowSize, m_degree));
+    m_imus[m_cgIMUID].filter = math::SGolayFilterBankPtr(
+        new math::SGolayFilterBank(9, m_windowSize, m_degree));
 }
 
 void IMUSGolayModule::update(core::EventPtr event)
@@ -121,69 +74,71 @@ void IMUSGolayModule::update(core::EventPtr event)
     /* This is where the estimation should be done
        The result should be stored in m_estimatedState */
 
-    std::string name = ievent->name;
+    /* Events made outside of a device, like in tests, are not stamped */
+    int id = ievent->sensorID;
+    if(vehicle::device::SensorRegistry::UNKNOWN == id)
+        id = vehicle::device::SensorRegistry::intern(ievent->name);
 
-    if(name != m_magIMUName && name != m_cgIMUName)
+    if(id != m_magIMUID && id != m_cgIMUID)
     {
-        std::cout << name << " youre an idiot" << std::endl;
+        std::cout << ievent->name << " youre an idiot" << std::endl;
         LOGGER.warn("BasicIMUEstimationModule: update: Invalid IMU Name");
         return;
     }
 
     double timestep = ievent->timestep;
     bool magIsCorrupt = ievent->magIsCorrupt;
-    imuList.insert(name);
 
-    if(m_filteredState.find(name) == m_filteredState.end())
-        m_filteredState[name] = FilteredIMUDataPtr(new FilteredIMUData());
+    IMUSlot& imu = m_imus[id];
+    imu.seen = true;
 
     /* grab the new state and filter it */
-    RawIMUData newState = ievent->rawIMUData;
+    const RawIMUData& newState = ievent->rawIMUData;
 
-    m_filteredAccelX[name]->addValue(newState.accelX); 
-    m_filteredAccelY[name]->addValue(newState.accelY);
-    m_filteredAccelZ[name]->addValue(newState.accelZ);
+    double values[9] = {
+        newState.accelX, newState.accelY, newState.accelZ,
+        newState.magX, newState.magY, newState.magZ,
+        newState.gyroX, newState.gyroY, newState.gyroZ
+    };
+    imu.filter->addValues(values);
+    imu.filter->getValues(values);
 
-    m_filteredMagX[name]->addValue(newState.magX);
-    m_filteredMagY[name]->addValue(newState.magY);
-    m_filteredMagZ[name]->addValue(newState.magZ);
+    FilteredIMUData& filteredState = imu.filteredState;
+    filteredState.accelX = values[0];
+    filteredState.accelY = values[1];
+    filteredState.accelZ = values[2];
 
-    m_filteredGyroX[name]->addValue(newState.gyroX);
-    m_filteredGyroY[name]->addValue(newState.gyroY);
-    m_filteredGyroZ[name]->addValue(newState.gyroZ);
+    filteredState.magX = values[3];
+    filteredState.magY = values[4];
+    filteredState.magZ = values[5];
 
-    m_filteredState[name]->accelX = m_filteredAccelX[name]->getValue();
-    m_filteredState[name]->accelY = m_filteredAccelY[name]->getValue();
-    m_filteredState[name]->accelZ = m_filteredAccelZ[name]->getValue();
- 
-    m_filteredState[name]->magX = m_filteredMagX[name]->getValue();
-    m_filteredState[name]->magY = m_filteredMagY[name]->getValue();
-    m_filteredState[name]->magZ = m_filteredMagZ[name]->getValue();
-
-    m_filteredState[name]->gyroX = m_filteredGyroX[name]->getValue();
-    m_filteredState[name]->gyroY = m_filteredGyroY[name]->getValue();
-    m_filteredState[name]->gyroZ = m_filteredGyroZ[name]->getValue();
+    filteredState.gyroX = values[6];
+    filteredState.gyroY = values[7];
+    filteredState.gyroZ = values[8];
 
     /* Pull the averaged values from the averaging filter and put them
      * into OGRE format for the following calculations
      */
 
+    const FilteredIMUData& cgState = m_imus[m_cgIMUID].filteredState;
+    const FilteredIMUData& magState = m_imus[m_magIMUID].filteredState;
+
     math::Vector3 mag, accel;
     {
         core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-        accel[0] = m_filteredState[m_cgIMUName]->accelX;
-        accel[1] = m_filteredState[m_cgIMUName]->accelY;
-        accel[2] = m_filteredState[m_cgIMUName]->accelZ;
+        accel[0] = cgState.accelX;
+        accel[1] = cgState.accelY;
+        accel[2] = cgState.accelZ;
         
-        mag[0] = m_filteredState[m_cgIMUName]->magX;
-        mag[1] = m_filteredState[m_cgIMUName]->magY;
-        mag[2] = m_filteredState[m_cgIMUName]->magZ;
+        mag[0] = cgState.magX;
+        mag[1] = cgState.magY;
+        mag[2] = cgState.magZ;
     }
 
     math::Quaternion estOrientation = math::Quaternion::IDENTITY;
     
-    if(imuList.find(m_magIMUName) != imuList.end()) {
+    if(m_imus[m_magIMUID].seen) {
 
         /* If we have the magboom IMU, compute the quaternion from the
          * magnetometer reading from the magboom IMU and the linear
@@ -193,9 +148,9 @@ void IMUSGolayModule::update(core::EventPtr event)
         {
             core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-            mag[0] = m_filteredState[m_magIMUName]->magX;
-            mag[1] = m_filteredState[m_magIMUName]->magY;
-            mag[2] = m_filteredState[m_magIMUName]->magZ;
+            mag[0] = magState.magX;
+            mag[1] = magState.magY;
+            mag[2] = magState.magZ;
         }
         // LOGGER.info("quatFromMagAccel - With MagBoom");
         //currently using quest for estimation
@@ -221,9 +176,9 @@ void IMUSGolayModule::update(core::EventPtr event)
         {
             core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
 
-            omega[0] = m_filteredState[m_cgIMUName]->gyroX;
-            omega[1] = m_filteredState[m_cgIMUName]->gyroY;
-            omega[2] = m_filteredState[m_cgIMUName]->gyroZ;
+            omega[0] = cgState.gyroX;
+            omega[1] = cgState.gyroY;
+            omega[2] = cgState.gyroZ;
         }
 
         math::Quaternion oldOrientation = 
@@ -245,16 +200,16 @@ void IMUSGolayModule::update(core::EventPtr event)
     // publish(vehicle::device::IIMU::UPDATE, oevent);
 
     // Log data directly
-    LOGGER.infoStream() << name << " "
-                        << m_filteredState[name]->accelX << " "
-                        << m_filteredState[name]->accelY << " "
-                        << m_filteredState[name]->accelZ << " "
-                        << m_filteredState[name]->magX << " "
-                        << m_filteredState[name]->magY << " "
-                        << m_filteredState[name]->magZ << " "
-                        << m_filteredState[name]->gyroX << " "
-                        << m_filteredState[name]->gyroY << " "
-                        << m_filteredState[name]->gyroZ << " "
+    LOGGER.infoStream() << ievent->name << " "
+                        << filteredState.accelX << " "
+                        << filteredState.accelY << " "
+                        << filteredState.accelZ << " "
+                        << filteredState.magX << " "
+                        << filteredState.magY << " "
+                        << filteredState.magZ << " "
+                        << filteredState.gyroX << " "
+                        << filteredState.gyroY << " "
+                        << filteredState.gyroZ << " "
                         << newState.accelX << " "
                         << newState.accelY << " "
                         << newState.accelZ << " "
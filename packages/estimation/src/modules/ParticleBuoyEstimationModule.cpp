@@ -94,14 +94,16 @@ void ParticleBuoyEstimationModule::update(core::EventPtr event)
                                 buoyEvent->y * m_camHeight,
                                 buoyEvent->range);
 
-    // get the current estimated state
-    math::Vector2 robotPosition = m_estimatedState->getEstimatedPosition();
-    double robotDepth = m_estimatedState->getEstimatedDepth();
+    // get the estimated state when the frame was captured
+    StateSnapshot state;
+    m_estimatedState->getStateAt(buoyEvent->arrivalTime, state);
+    math::Vector2 robotPosition = state.position;
+    double robotDepth = state.depth;
 
     // TODO: need to get offsets for how far camera is from cg
     // should be config values
     math::Vector3 cameraLocation(robotPosition[0], robotPosition[1], robotDepth);
-    math::Quaternion cameraOrientation = m_estimatedState->getEstimatedOrientation();
+    math::Quaternion cameraOrientation = state.orientation;
 
     /*******************************************************/
     /********* Initialization ******************************/
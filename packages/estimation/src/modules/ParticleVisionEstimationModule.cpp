@@ -96,14 +96,16 @@ void ParticleVisionEstimationModule::update(core::EventPtr event)
                                 visionEvent->y * m_camHeight,
                                 visionEvent->range);
 
-    // get the current estimated state
-    math::Vector2 robotPosition = m_estimatedState->getEstimatedPosition();
-    double robotDepth = m_estimatedState->getEstimatedDepth();
+    // get the estimated state when the frame was captured
+    StateSnapshot state;
+    m_estimatedState->getStateAt(visionEvent->arrivalTime, state);
+    math::Vector2 robotPosition = state.position;
+    double robotDepth = state.depth;
 
     // TODO: need to get offsets for how far camera is from cg
     // should be config values
     math::Vector3 cameraLocation(robotPosition[0], robotPosition[1], robotDepth);
-    math::Quaternion cameraOrientation = m_estimatedState->getEstimatedOrientation();
+    math::Quaternion cameraOrientation = state.orientation;
 
     /*******************************************************/
     /********* Initialization ******************************/
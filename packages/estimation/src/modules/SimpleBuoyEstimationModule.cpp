@@ -96,14 +96,17 @@ void SimpleBuoyEstimationModule::update(core::EventPtr event)
                                 buoyEvent->y * m_camHeight,
                                 buoyEvent->range);
 
-    // get the current estimated state
-    math::Vector2 robotPosition = m_estimatedState->getEstimatedPosition();
-    double robotDepth = m_estimatedState->getEstimatedDepth();
+    // get the estimated state from when the frame was captured, vision
+    // runs well behind the other sensors
+    StateSnapshot state;
+    m_estimatedState->getStateAt(buoyEvent->arrivalTime, state);
+    math::Vector2 robotPosition = state.position;
+    double robotDepth = state.depth;
 
     // TODO: need to get offsets for how far camera is from cg
     // should be config values
     math::Vector3 cameraLocation(robotPosition[0], robotPosition[1], robotDepth);
-    math::Quaternion cameraOrientation = m_estimatedState->getEstimatedOrientation();
+    math::Quaternion cameraOrientation = state.orientation;
 
     math::Vector3 measurement_w = img2world(measurement_i,
                                             cameraLocation,
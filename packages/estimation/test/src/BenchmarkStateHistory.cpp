@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/estimation/test/src/BenchmarkStateHistory.cpp
+ */
+
+// Times the work of fusing a late measurement with a StateHistory: recording
+// a snapshot, interpolating the state at a past time, and re-propagating a
+// position correction from that time to now.  The history is full and the
+// snapshots 10ms apart, like the DVL and IMU updates, and corrections are
+// timed for a delay of a vision frame (150ms) and of the whole history.
+//
+// Usage: BenchmarkStateHistory [iterations] [history size]
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <time.h>
+
+// Project Includes
+#include "estimation/include/StateHistory.h"
+
+using namespace ram;
+
+static double nowMicroseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static const boost::int64_t SPACING = 10000;
+
+static estimation::StateSnapshot makeState(boost::int64_t time)
+{
+    double t = time / 1e6;
+    estimation::StateSnapshot state;
+    state.time = time;
+    state.position = math::Vector2(std::sin(t), std::cos(t));
+    state.velocity = math::Vector2(std::cos(t), -std::sin(t));
+    state.depth = 2 + 0.1 * std::sin(t);
+    state.depthRate = 0.1 * std::cos(t);
+    state.orientation = math::Quaternion(math::Radian(0.5 * std::sin(t)),
+                                         math::Vector3::UNIT_Z);
+    state.angularRate = math::Vector3(0, 0, 0.5 * std::cos(t));
+    return state;
+}
+
+static void report(const char* name, double total, int iterations)
+{
+    std::cout << "  " << std::setw(28) << std::left << name << std::right
+              << std::setw(10) << total * 1000 / iterations << " ns"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int iterations = 100000;
+    if (argc > 1)
+        iterations = std::atoi(argv[1]);
+    size_t size = 512;
+    if (argc > 2)
+        size = std::atoi(argv[2]);
+
+    estimation::StateHistory history(size, SPACING / 2);
+    boost::int64_t time = 0;
+    for (size_t i = 0; i < size; ++i, time += SPACING)
+        history.record(makeState(time));
+
+    std::cout << iterations << " iterations, " << history.size()
+              << " snapshots" << std::endl << std::fixed
+              << std::setprecision(1);
+
+    // Recording, each drops the oldest
+    estimation::StateSnapshot state = makeState(time);
+    double start = nowMicroseconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        state.time = time;
+        history.record(state);
+        time += SPACING;
+    }
+    report("record", nowMicroseconds() - start, iterations);
+
+    // Interpolating at a vision delay behind the newest
+    double sum = 0;
+    boost::int64_t delayed = history.getNewestTime() - 150000 - SPACING / 3;
+    start = nowMicroseconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        history.getState(delayed - (i % 8) * SPACING, state);
+        sum += state.position[0];
+    }
+    report("getState (150ms)", nowMicroseconds() - start, iterations);
+
+    // Fusing a vision fix, the lookup and re-propagation together
+    math::Vector2 offset(1e-9, -1e-9);
+    start = nowMicroseconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        history.getState(delayed, state);
+        history.shiftPosition(delayed, offset);
+    }
+    report("correct (150ms)", nowMicroseconds() - start, iterations);
+
+    // The worst case, a fix as old as the history
+    boost::int64_t oldest = history.getOldestTime() + SPACING / 3;
+    start = nowMicroseconds();
+    for (int i = 0; i < iterations; ++i)
+    {
+        history.getState(oldest, state);
+        history.shiftPosition(oldest, offset);
+    }
+    report("correct (whole history)", nowMicroseconds() - start, iterations);
+
+    // Keeps the lookups from being optimized out
+    if (sum != sum)
+        std::cout << sum << std::endl;
+    return 0;
+}
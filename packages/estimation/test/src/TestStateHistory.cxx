@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/estimation/test/src/TestStateHistory.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "estimation/include/StateHistory.h"
+#include "estimation/include/EstimatedState.h"
+#include "core/include/EventHub.h"
+#include "core/include/LatencyTracker.h"
+#include "core/include/TimeVal.h"
+#include "math/include/Vector2.h"
+#include "math/test/include/MathChecks.h"
+
+using namespace ram;
+
+static estimation::StateSnapshot makeState(boost::int64_t time, double x)
+{
+    estimation::StateSnapshot state;
+    state.time = time;
+    state.position = math::Vector2(x, -x);
+    state.velocity = math::Vector2(1, -1);
+    state.depth = x / 10;
+    return state;
+}
+
+TEST(StateHistoryEmpty)
+{
+    estimation::StateHistory history(4, 0);
+    estimation::StateSnapshot state;
+
+    CHECK_EQUAL(0u, history.size());
+    CHECK_EQUAL(4u, history.capacity());
+    CHECK(!history.getState(100, state));
+}
+
+TEST(StateHistoryInterpolate)
+{
+    estimation::StateHistory history(8, 0);
+    history.record(makeState(1000, 0));
+    history.record(makeState(2000, 10));
+    history.record(makeState(4000, 20));
+
+    estimation::StateSnapshot state;
+    CHECK(history.getState(1500, state));
+    CHECK_EQUAL(1500, state.time);
+    CHECK_CLOSE(5, state.position[0], 0.0001);
+    CHECK_CLOSE(-5, state.position[1], 0.0001);
+    CHECK_CLOSE(0.5, state.depth, 0.0001);
+
+    CHECK(history.getState(3000, state));
+    CHECK_CLOSE(15, state.position[0], 0.0001);
+
+    // Exactly on a snapshot
+    CHECK(history.getState(2000, state));
+    CHECK_CLOSE(10, state.position[0], 0.0001);
+
+    // After the newest gives the newest
+    CHECK(history.getState(9000, state));
+    CHECK_CLOSE(20, state.position[0], 0.0001);
+
+    // Before the oldest gives the oldest, but says it is not valid
+    CHECK(!history.getState(500, state));
+    CHECK_CLOSE(0, state.position[0], 0.0001);
+}
+
+TEST(StateHistoryInterpolateOrientation)
+{
+    estimation::StateHistory history(8, 0);
+    estimation::StateSnapshot state = makeState(0, 0);
+    history.record(state);
+    state.time = 1000;
+    state.orientation = math::Quaternion(math::Degree(90),
+                                         math::Vector3::UNIT_Z);
+    history.record(state);
+
+    CHECK(history.getState(500, state));
+    math::Quaternion expected(math::Degree(45), math::Vector3::UNIT_Z);
+    CHECK_CLOSE(expected, state.orientation, 0.0001);
+}
+
+TEST(StateHistoryResolution)
+{
+    estimation::StateHistory history(8, 1000);
+    history.record(makeState(0, 0));
+    history.record(makeState(400, 1));
+    history.record(makeState(800, 2));
+    CHECK_EQUAL(1u, history.size());
+    CHECK_EQUAL(800, history.getNewestTime());
+
+    // Measured from when the newest slot started, not when it was replaced
+    history.record(makeState(1000, 3));
+    CHECK_EQUAL(2u, history.size());
+    CHECK_EQUAL(800, history.getOldestTime());
+    CHECK_EQUAL(1000, history.getNewestTime());
+}
+
+TEST(StateHistoryWrap)
+{
+    estimation::StateHistory history(3, 0);
+    for (int i = 0; i < 5; ++i)
+        history.record(makeState(i * 1000, i));
+
+    CHECK_EQUAL(3u, history.size());
+    CHECK_EQUAL(2000, history.getOldestTime());
+    CHECK_EQUAL(4000, history.getNewestTime());
+
+    estimation::StateSnapshot state;
+    CHECK(history.getState(2500, state));
+    CHECK_CLOSE(2.5, state.position[0], 0.0001);
+    CHECK(!history.getState(1500, state));
+
+    history.clear();
+    CHECK_EQUAL(0u, history.size());
+}
+
+TEST(StateHistoryShiftPosition)
+{
+    estimation::StateHistory history(3, 0);
+    for (int i = 0; i < 5; ++i)
+        history.record(makeState(i * 1000, i));
+
+    CHECK_EQUAL(2u, history.shiftPosition(2500, math::Vector2(1, 2)));
+
+    estimation::StateSnapshot state;
+    CHECK(history.getState(2000, state));
+    CHECK_CLOSE(2, state.position[0], 0.0001);
+    CHECK(history.getState(3000, state));
+    CHECK_CLOSE(4, state.position[0], 0.0001);
+    CHECK_CLOSE(-1, state.position[1], 0.0001);
+    CHECK(history.getState(4000, state));
+    CHECK_CLOSE(5, state.position[0], 0.0001);
+}
+
+TEST(EstimatedStateCorrectPosition)
+{
+    core::EventHubPtr eventHub(new core::EventHub("eventHub"));
+    estimation::EstimatedState estimatedState(
+        core::ConfigNode::fromString("{}"), eventHub);
+
+    estimatedState.setEstimatedPosition(math::Vector2(0, 0));
+    core::TimeVal::sleep(0.01);
+    boost::int64_t fixTime = core::LatencyTracker::now();
+    core::TimeVal::sleep(0.01);
+    estimatedState.setEstimatedPosition(math::Vector2(2, 0));
+    core::TimeVal::sleep(0.01);
+    estimatedState.setEstimatedPosition(math::Vector2(4, 0));
+
+    // The position then lies between the snapshots around it
+    estimation::StateSnapshot state;
+    CHECK(estimatedState.getStateAt(fixTime, state));
+    CHECK(state.position[0] > 0 && state.position[0] < 2);
+    math::Vector2 then = state.position;
+
+    // A fix one meter off then moves now by the same
+    estimatedState.correctEstimatedPosition(fixTime,
+                                            then + math::Vector2(0, 1));
+    CHECK_CLOSE(4, estimatedState.getEstimatedPosition()[0], 0.0001);
+    CHECK_CLOSE(1, estimatedState.getEstimatedPosition()[1], 0.0001);
+
+    CHECK(estimatedState.getStateAt(0, state));
+    CHECK_CLOSE(1, state.position[1], 0.0001);
+
+    // A fix with no time is taken as current
+    estimatedState.correctEstimatedPosition(0, math::Vector2(5, 5));
+    CHECK_CLOSE(5, estimatedState.getEstimatedPosition()[0], 0.0001);
+    CHECK_CLOSE(5, estimatedState.getEstimatedPosition()[1], 0.0001);
+}
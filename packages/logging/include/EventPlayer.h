@@ -54,10 +54,16 @@ public:
 
     /** Starts the current event playback*/
     virtual void stop();
+
+    /** True if playing back in virtual time, stepped by update() */
+    bool stepping();
     
     // IUpdatable methods
 
-    /** Sleeps until the next event from the file is ready to be broadcast */
+    /** Sleeps until the next event from the file is ready to be broadcast
+     *
+     *  When stepping, sends every event which is due instead.
+     */
     virtual void update(double);
 
     virtual void setPriority(core::IUpdatable::Priority priority);
@@ -86,6 +92,9 @@ private:
     /** Creates all parts of the underlying logging system */
     void init(core::ConfigNode config, core::SubsystemList deps);
 
+    /** Publishes the "present event" and moves on to the next one */
+    void sendPresentEvent();
+
     /** The archive we reading from */
     boost::archive::text_iarchive* m_archive;
 
@@ -125,6 +134,9 @@ private:
 
     /** EventPlayer subsystem */
     EventPlayer *m_player;
+
+    /** Playing back in virtual time, without a background thread */
+    bool m_stepping;
 };
 
 class EventPlayer : public core::Subsystem
@@ -33,7 +33,11 @@ public:
     /** Start the playback camera producing images */
     void start();
     
-    /** Runs in the background pulling out images from the camera */
+    /** Runs in the background pulling out images from the camera
+     *
+     *  In virtual time there is no background thread, each update sends a
+     *  frame only if one is due.
+     */
     virtual void update(double timestep);
     
     virtual size_t width();
@@ -74,6 +78,9 @@ private:
     double m_nextUpdate;
 
     double m_updateInterval;
+
+    /** Playing back in virtual time, without a background thread */
+    bool m_stepping;
 };
 
 }  // namespace logging
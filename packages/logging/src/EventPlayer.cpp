@@ -29,6 +29,7 @@
 #include "core/include/EventHub.h"
 #include "core/include/Events.h"
 #include "core/include/TimeVal.h"
+#include "core/include/Clock.h"
 
 // Register controller in subsystem maker system
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::logging::EventPlayer, EventPlayer);
@@ -46,12 +47,16 @@ EventPlayer::EventPlayer(core::ConfigNode config) :
     Subsystem(config["name"].asString("EventPlayer"))
 {
     m_playerThread = new PlayerThread(config, this);
+    if (config["autoStart"].asInt(0))
+        start();
 }
 
 EventPlayer::EventPlayer(core::ConfigNode config, core::SubsystemList deps) :
     Subsystem(config["name"].asString("EventPlayer"), deps)
 {
     m_playerThread = new PlayerThread(config, deps, this);
+    if (config["autoStart"].asInt(0))
+        start();
 }
 
 EventPlayer::~EventPlayer()
@@ -95,7 +100,9 @@ void EventPlayer::unbackground(bool join)
 
 bool EventPlayer::backgrounded()
 {
-    return true;
+    // Playback has its own thread, except in virtual time where the
+    // main loop has to step it
+    return !core::Clock::isVirtual();
 }
 
 void EventPlayer::setPriority(core::IUpdatable::Priority priority)
@@ -116,9 +123,10 @@ int EventPlayer::getAffinity()
     return -1;
 }
 
-void EventPlayer::update(double)
+void EventPlayer::update(double timestep)
 {
-
+    if (m_playerThread->stepping())
+        m_playerThread->update(timestep);
 }
 
 
@@ -151,7 +159,8 @@ PlayerThread::PlayerThread(core::ConfigNode config, EventPlayer *player) :
     m_stoppedTime(-1),
     m_stopageTime(0),
     m_fileLength(-1),
-    m_presentEvent(0)
+    m_presentEvent(0),
+    m_stepping(false)
 {
     m_player = player;
     init(config, core::SubsystemList());
@@ -165,7 +174,8 @@ PlayerThread::PlayerThread(core::ConfigNode config, core::SubsystemList deps, Ev
     m_stoppedTime(-1),
     m_stopageTime(0),
     m_fileLength(-1),
-    m_presentEvent(0)
+    m_presentEvent(0),
+    m_stepping(false)
 {
     m_player = player;
     init(config, deps);
@@ -215,8 +225,12 @@ void PlayerThread::start()
             m_stopageTime += timeStopped;
         }
 
-        // Now start backup the background thread
-        background(-1);
+        // Now start backup the background thread, in virtual time the
+        // main loop steps us instead
+        if (core::Clock::isVirtual())
+            m_stepping = true;
+        else
+            background(-1);
     }
 
     m_player->publishStart();
@@ -225,7 +239,10 @@ void PlayerThread::start()
 void PlayerThread::stop()
 {
     // Stop the background thread
-    unbackground(true);;
+    if (m_stepping)
+        m_stepping = false;
+    else
+        unbackground(true);
 
     // Record when stopped playback
     {
@@ -237,17 +254,34 @@ void PlayerThread::stop()
 }
 
     
+bool PlayerThread::stepping()
+{
+    return m_stepping;
+}
+    
 void PlayerThread::update(double)
 {
+    // In virtual time we are stepped by the main loop, so rather than
+    // sleeping until the next event send everything that is now due
+    if (m_stepping)
+    {
+        double now = getTimeOfDay() - m_stopageTime;
+        while ((m_pastEvents.size() > m_presentEvent) &&
+               (m_pastEvents.at(m_presentEvent)->timeStamp + m_startTime
+                <= now))
+        {
+            sendPresentEvent();
+        }
+        return;
+    }
+    
     // If the "current event" is in the pastEvents vector
     if(m_pastEvents.size() > m_presentEvent){
 
         ram::core::EventPtr event = m_pastEvents.at(m_presentEvent);
 
         // Grab essentially the place we are in the log file
-        double delta = event->timeStamp;
-        m_currentTime = delta;
-        double sendTime = m_startTime + delta + m_stopageTime;
+        m_currentTime = event->timeStamp;
 
         // If in the "past" send the event, other wise sleep until it must
         // be sent out
@@ -260,24 +294,36 @@ void PlayerThread::update(double)
             eventSleep(sleepTime);
             now = getTimeOfDay() - m_stopageTime;
         }
+
+        sendPresentEvent();
+    }
+}
+
+void PlayerThread::sendPresentEvent()
+{
+    ram::core::EventPtr event = m_pastEvents.at(m_presentEvent);
+
+    // Grab essentially the place we are in the log file
+    double delta = event->timeStamp;
+    m_currentTime = delta;
+    double sendTime = m_startTime + delta + m_stopageTime;
         
-        // Clone the event to send
-        core::EventPtr eventToSend(event->clone());
-        eventToSend->timeStamp = sendTime;
+    // Clone the event to send
+    core::EventPtr eventToSend(event->clone());
+    eventToSend->timeStamp = sendTime;
             
-        if (eventToSend->sender)
-        {
-            // Republish the event with the events sender
-            eventToSend->sender->publish(eventToSend->type, eventToSend);
-        }
-        else
-        {
-            // Republish just to the event hub
-            m_eventHub->publish(eventToSend);
-        }
-        m_player->publishUpdate();
-        m_presentEvent++;
+    if (eventToSend->sender)
+    {
+        // Republish the event with the events sender
+        eventToSend->sender->publish(eventToSend->type, eventToSend);
+    }
+    else
+    {
+        // Republish just to the event hub
+        m_eventHub->publish(eventToSend);
     }
+    m_player->publishUpdate();
+    m_presentEvent++;
 }
 
 void PlayerThread::setPriority(core::IUpdatable::Priority priority)
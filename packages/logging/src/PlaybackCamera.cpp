@@ -15,6 +15,7 @@
 #include "logging/include/EventPlayer.h"
 
 #include "core/include/TimeVal.h"
+#include "core/include/Clock.h"
 #include "core/include/EventHub.h"
 
 #include "vision/include/CameraMaker.h"
@@ -59,7 +60,8 @@ PlaybackCamera::PlaybackCamera(vision::CameraPtr camera,
                                core::EventHubPtr eventHub) :
     m_camera(camera),
     m_nextUpdate(0),
-    m_updateInterval(0)
+    m_updateInterval(0),
+    m_stepping(false)
 {
     eventHub->subscribeToType(EventPlayer::START,
                               boost::bind(&PlaybackCamera::startHandler, this,
@@ -88,6 +90,11 @@ PlaybackCamera::~PlaybackCamera()
 
 void PlaybackCamera::stop()
 {
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+        m_stepping = false;
+    }
+    
     // Stop the background thread
     unbackground(true);
 }
@@ -105,8 +112,12 @@ void PlaybackCamera::start()
     // Determine when we should send off the next frame
     m_nextUpdate = getTimeOfDay() + m_updateInterval;
 
-    // Start the background thread
-    background(-1);
+    // Start the background thread, in virtual time whoever updates the
+    // camera steps us instead
+    if (core::Clock::isVirtual())
+        m_stepping = true;
+    else
+        background(-1);
 }
    
 void PlaybackCamera::update(double timestep)
@@ -115,9 +126,17 @@ void PlaybackCamera::update(double timestep)
 
     {
         core::ReadWriteMutex::ScopedWriteLock lock(m_mutex);
+
+        // When stepped we can't wait, so just do nothing until the next
+        // frame is due
+        if (core::Clock::isVirtual() &&
+            (!m_stepping || (getTimeOfDay() < m_nextUpdate)))
+        {
+            return;
+        }
         
-        // Send an image
-        m_camera->update(0);
+        // Send an image, a frame time passes for the wrapped camera
+        m_camera->update(m_updateInterval);
     
         // Advance the update the standard ammount
         m_nextUpdate += m_updateInterval;
@@ -133,7 +152,8 @@ void PlaybackCamera::update(double timestep)
         sleepTime = m_nextUpdate - getTimeOfDay();
     }
     
-    nextFrameSleep(sleepTime);
+    if (!m_stepping)
+        nextFrameSleep(sleepTime);
 }
     
 size_t PlaybackCamera::width()
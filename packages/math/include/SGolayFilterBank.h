@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/math/include/SGolayFilterBank.h
+ */
+
+#ifndef RAM_MATH_SGOLAYFILTERBANK_H_07_16_2011
+#define RAM_MATH_SGOLAYFILTERBANK_H_07_16_2011
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "math/include/MatrixN.h"
+
+// Must Be Included last
+#include "math/include/Export.h"
+
+namespace ram {
+namespace math {
+
+class SGolayFilterBank;
+typedef boost::shared_ptr<SGolayFilterBank> SGolayFilterBankPtr;
+
+/** Savitzky-Golay filters of several channels sampled together
+ *
+ *  Gives the same fit as one SGolaySmoothingFilter per channel, but keeps
+ *  the windows of every channel in one circular buffer, so adding a sample
+ *  writes it instead of shifting each window.  Every sample is stored twice,
+ *  WindowSize apart, so the current window is always contiguous.  The value
+ *  and every derivative of all the channels are then found in one pass over
+ *  the window, each sample of channels being scaled by the coefficient of
+ *  every order (two channels at a time with SSE2).  Nothing is allocated
+ *  after construction.
+ */
+class RAM_EXPORT SGolayFilterBank
+{
+public:
+    /** Construct a bank of filters
+     *
+     *  @param channels - the number of values in each sample
+     *  @param size - the window size of the filters (made odd if even)
+     *  @param degree - the polynomial degree of the least-squares fit
+     */
+    SGolayFilterBank(int channels, int size, int degree);
+
+    /** Puts a new sample, of one value per channel, into the filters */
+    void addValues(const double* newValues);
+
+    /** The filtered value, or given order derivative, of the channel
+     *
+     *  The derivatives are taken with respect to time, given the time
+     *  between samples, at the newest sample.  Returns 0 for orders above
+     *  the degree of the fit, or derivatives without a timestep.
+     */
+    double getValue(int channel, int order = 0, double timestep = 0) const;
+
+    /** Copies the value, or given order derivative, of every channel */
+    void getValues(double* values, int order = 0, double timestep = 0) const;
+
+    int getChannels() const;
+
+    /** Returns the window size for the filters */
+    int getWindowSize() const;
+
+    /** Returns the polynomial degree for the least squares fit */
+    int getDegree() const;
+
+    /** Returns the matrix of coefficients for the filters */
+    MatrixN getCoefficientMatrix() const;
+
+    /** Resets every window to zeros */
+    void clear();
+
+private:
+    /** Fits every order of every channel to the current window */
+    void update();
+
+    /** The factor turning a fit coefficient into a time derivative */
+    double derivativeScale(int order, double timestep) const;
+
+    int m_channels;
+    int m_windowSize;
+    int m_degree;
+
+    /** Channels rounded up to an even number, the length of one sample */
+    int m_stride;
+
+    /** The coefficient of each order, for each sample of the window from
+        the oldest */
+    std::vector<double> m_coeffs;
+
+    /** 2 * m_windowSize samples, each written at i and i + m_windowSize */
+    std::vector<double> m_history;
+
+    /** Where the oldest sample of the window is */
+    int m_head;
+
+    /** Row per order, of m_stride fit coefficients */
+    std::vector<double> m_values;
+};
+
+} // namespace math
+} // namespace ram
+
+#endif // RAM_MATH_SGOLAYFILTERBANK_H_07_16_2011
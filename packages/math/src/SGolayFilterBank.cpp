@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/math/src/SGolayFilterBank.cpp
+ */
+
+// STD Includes
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+// Library Includes
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+// Project Includes
+#include "math/include/SGolayFilterBank.h"
+#include "math/include/SGolaySmoothingFilter.h"
+#include "math/include/Helpers.h"
+
+namespace ram {
+namespace math {
+
+SGolayFilterBank::SGolayFilterBank(int channels, int size, int degree) :
+    m_channels(channels),
+    m_windowSize(0),
+    m_degree(degree),
+    m_stride((channels + 1) & ~1),
+    m_head(0)
+{
+    assert(channels > 0 && "Filter bank needs a channel");
+
+    // The fit only depends on the window size and degree, so it is the same
+    // as that of a single filter
+    SGolaySmoothingFilter prototype(size, degree);
+    m_windowSize = prototype.getWindowSize();
+    MatrixN coeffMatrix(prototype.getCoefficientMatrix());
+
+    m_coeffs.resize((m_degree + 1) * m_windowSize);
+    for (int order = 0; order <= m_degree; ++order)
+    {
+        for (int i = 0; i < m_windowSize; ++i)
+            m_coeffs[i * (m_degree + 1) + order] = coeffMatrix[order][i];
+    }
+
+    m_history.resize(2 * m_windowSize * m_stride, 0.0);
+    m_values.resize((m_degree + 1) * m_stride, 0.0);
+}
+
+void SGolayFilterBank::addValues(const double* newValues)
+{
+    // The oldest sample is replaced in both of its copies, after which the
+    // window starts one sample later
+    double* first = &m_history[m_head * m_stride];
+    double* second = first + m_windowSize * m_stride;
+    std::copy(newValues, newValues + m_channels, first);
+    std::copy(newValues, newValues + m_channels, second);
+
+    m_head++;
+    if (m_head == m_windowSize)
+        m_head = 0;
+
+    update();
+}
+
+void SGolayFilterBank::update()
+{
+    const double* window = &m_history[m_head * m_stride];
+    std::fill(m_values.begin(), m_values.end(), 0.0);
+
+    // Each sample of the window is loaded once, and scaled by the
+    // coefficient of every order
+    const double* sample = window;
+    const double* coeffs = &m_coeffs[0];
+    for (int i = 0; i < m_windowSize; ++i, sample += m_stride)
+    {
+        for (int order = 0; order <= m_degree; ++order)
+        {
+            double coeff = *coeffs++;
+            double* values = &m_values[order * m_stride];
+
+#ifdef __SSE2__
+            __m128d scale = _mm_set1_pd(coeff);
+            for (int channel = 0; channel < m_stride; channel += 2)
+            {
+                __m128d sum = _mm_loadu_pd(values + channel);
+                sum = _mm_add_pd(
+                    sum, _mm_mul_pd(scale, _mm_loadu_pd(sample + channel)));
+                _mm_storeu_pd(values + channel, sum);
+            }
+#else
+            for (int channel = 0; channel < m_stride; ++channel)
+                values[channel] += coeff * sample[channel];
+#endif // __SSE2__
+        }
+    }
+}
+
+double SGolayFilterBank::derivativeScale(int order, double timestep) const
+{
+    if (order == 0)
+        return 1;
+    if (order < 0 || order > m_degree || timestep <= 0)
+        return 0;
+
+    // The fit is a polynomial in samples, so its nth derivative in time at
+    // the newest sample is n! a_n / timestep^n
+    return math::factorial(order) / std::pow(timestep, order);
+}
+
+double SGolayFilterBank::getValue(int channel, int order,
+                                  double timestep) const
+{
+    assert(channel >= 0 && channel < m_channels && "Invalid channel");
+
+    double scale = derivativeScale(order, timestep);
+    if (scale == 0)
+        return 0;
+    return m_values[order * m_stride + channel] * scale;
+}
+
+void SGolayFilterBank::getValues(double* values, int order,
+                                 double timestep) const
+{
+    double scale = derivativeScale(order, timestep);
+    for (int channel = 0; channel < m_channels; ++channel)
+    {
+        values[channel] = (scale == 0) ? 0 :
+            m_values[order * m_stride + channel] * scale;
+    }
+}
+
+int SGolayFilterBank::getChannels() const
+{
+    return m_channels;
+}
+
+int SGolayFilterBank::getWindowSize() const
+{
+    return m_windowSize;
+}
+
+int SGolayFilterBank::getDegree() const
+{
+    return m_degree;
+}
+
+MatrixN SGolayFilterBank::getCoefficientMatrix() const
+{
+    MatrixN coeffMatrix(0.0, m_degree + 1, m_windowSize);
+    for (int order = 0; order <= m_degree; ++order)
+    {
+        for (int i = 0; i < m_windowSize; ++i)
+            coeffMatrix[order][i] = m_coeffs[i * (m_degree + 1) + order];
+    }
+    return coeffMatrix;
+}
+
+void SGolayFilterBank::clear()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0);
+    std::fill(m_values.begin(), m_values.end(), 0.0);
+    m_head = 0;
+}
+
+} // namespace math
+} // namespace ram
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/math/test/src/BenchmarkSGolayFilterBank.cpp
+ */
+
+// Reports the throughput, in samples of every channel per second, of one
+// SGolaySmoothingFilter per channel against a single SGolayFilterBank, for
+// the nine IMU axes and a few window sizes.
+//
+// Usage: BenchmarkSGolayFilterBank [samples]
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <sys/time.h>
+
+// Project Includes
+#include "math/include/SGolaySmoothingFilter.h"
+#include "math/include/SGolayFilterBank.h"
+
+using namespace ram;
+
+static const int CHANNELS = 9;
+static const int DEGREE = 2;
+
+static double seconds()
+{
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void report(std::string name, int samples, double elapsed,
+                   double checksum)
+{
+    std::cout << std::left << std::setw(36) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0)
+              << samples / elapsed << " samples/sec"
+              << "  (checksum " << std::setprecision(6) << checksum << ")"
+              << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int samples = 200000;
+    if (argc > 1)
+        samples = std::atoi(argv[1]);
+
+    // Noisy IMU like readings, generated up front so only filtering is timed
+    std::vector<double> data(samples * CHANNELS);
+    srand(42);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = (double)rand() / RAND_MAX - 0.5 + (i % CHANNELS);
+
+    int sizes[] = {5, 11, 21};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        int size = sizes[s];
+        std::cout << "Window " << size << ", degree " << DEGREE << ", "
+                  << CHANNELS << " channels" << std::endl;
+
+        std::vector<math::SGolaySmoothingFilter> filters(
+            CHANNELS, math::SGolaySmoothingFilter(size, DEGREE));
+        double checksum = 0;
+        double start = seconds();
+        for (int i = 0; i < samples; ++i)
+        {
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                filters[channel].addValue(data[i * CHANNELS + channel]);
+                checksum += filters[channel].getValue();
+            }
+        }
+        report("  SGolaySmoothingFilter per channel", samples,
+               seconds() - start, checksum);
+
+        math::SGolayFilterBank bank(CHANNELS, size, DEGREE);
+        double values[CHANNELS];
+        checksum = 0;
+        start = seconds();
+        for (int i = 0; i < samples; ++i)
+        {
+            bank.addValues(&data[i * CHANNELS]);
+            bank.getValues(values);
+            for (int channel = 0; channel < CHANNELS; ++channel)
+                checksum += values[channel];
+        }
+        report("  SGolayFilterBank", samples, seconds() - start, checksum);
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/math/test/src/TestSGolayFilterBank.cxx
+ */
+
+// STD Includes
+#include <cstdlib>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "math/include/SGolayFilterBank.h"
+#include "math/include/SGolaySmoothingFilter.h"
+
+using namespace ram::math;
+
+SUITE(SGolayFilterBankTest) {
+
+TEST(matchesSingleFilters)
+{
+    // An odd number of channels, to cover the padding of each sample
+    const int channels = 3;
+    SGolayFilterBank bank(channels, 7, 2);
+    SGolaySmoothingFilter filters[channels] = {
+        SGolaySmoothingFilter(7, 2),
+        SGolaySmoothingFilter(7, 2),
+        SGolaySmoothingFilter(7, 2)
+    };
+    CHECK_EQUAL(7, bank.getWindowSize());
+    CHECK_EQUAL(2, bank.getDegree());
+    CHECK_EQUAL(channels, bank.getChannels());
+
+    srand(42);
+    for (int sample = 0; sample < 50; ++sample)
+    {
+        double values[channels];
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            values[channel] = (double)rand() / RAND_MAX * 10 - 5;
+            filters[channel].addValue(values[channel]);
+        }
+        bank.addValues(values);
+
+        // Only the first derivative is scaled the same by both
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            CHECK_CLOSE(filters[channel].getValue(),
+                        bank.getValue(channel), 1e-9);
+            CHECK_CLOSE(filters[channel].getValue(1, 0.1),
+                        bank.getValue(channel, 1, 0.1), 1e-9);
+        }
+    }
+}
+
+TEST(evenWindowSize)
+{
+    SGolayFilterBank bank(2, 4, 2);
+    SGolaySmoothingFilter filter(4, 2);
+    CHECK_EQUAL(filter.getWindowSize(), bank.getWindowSize());
+    CHECK_ARRAY_CLOSE(filter.getCoefficientMatrix()[0],
+                      bank.getCoefficientMatrix()[0],
+                      bank.getWindowSize(), 1e-12);
+}
+
+TEST(derivatives)
+{
+    // A quadratic is fit exactly, so every derivative comes out exact
+    const double timestep = 0.1;
+    SGolayFilterBank bank(1, 7, 2);
+    double t = 0;
+    for (int sample = 0; sample < 10; ++sample)
+    {
+        t = sample * timestep;
+        double value = 3 + 2 * t + 0.5 * t * t;
+        bank.addValues(&value);
+    }
+
+    CHECK_CLOSE(3 + 2 * t + 0.5 * t * t, bank.getValue(0), 1e-9);
+    CHECK_CLOSE(2 + t, bank.getValue(0, 1, timestep), 1e-9);
+    CHECK_CLOSE(1, bank.getValue(0, 2, timestep), 1e-9);
+
+    // Past the degree, or without a timestep, there is nothing to give
+    CHECK_EQUAL(0, bank.getValue(0, 3, timestep));
+    CHECK_EQUAL(0, bank.getValue(0, 1));
+}
+
+TEST(getValues)
+{
+    SGolayFilterBank bank(4, 5, 2);
+    double ones[] = {1, 2, 3, 4};
+    for (int sample = 0; sample < 5; ++sample)
+        bank.addValues(ones);
+
+    double values[4];
+    bank.getValues(values);
+    CHECK_ARRAY_CLOSE(ones, values, 4, 1e-9);
+
+    bank.getValues(values, 1, 0.1);
+    double zeros[] = {0, 0, 0, 0};
+    CHECK_ARRAY_CLOSE(zeros, values, 4, 1e-9);
+}
+
+TEST(clear)
+{
+    SGolayFilterBank bank(2, 5, 2);
+    double values[] = {5, -5};
+    for (int sample = 0; sample < 5; ++sample)
+        bank.addValues(values);
+    bank.clear();
+    CHECK_EQUAL(0, bank.getValue(0));
+    CHECK_EQUAL(0, bank.getValue(1));
+
+    // Starts from a window of zeros again, like a new filter
+    SGolaySmoothingFilter filter(5, 2);
+    filter.addValue(5);
+    bank.addValues(values);
+    CHECK_CLOSE(filter.getValue(), bank.getValue(0), 1e-9);
+}
+
+} // SUITE(SGolayFilterBankTest)
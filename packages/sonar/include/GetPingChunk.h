@@ -12,6 +12,7 @@
 #define _RAM_SONAR_PING_CHUNK
 
 #include "PingDetect.h"
+#include "PingTracker.h"
 
 // Forward declare
 extern "C" {
@@ -33,9 +34,7 @@ class getPingChunk {
     int detected;
     pingDetect pdetect;
     adcdata_t sample[NCHANNELS];
-    int last_detected;
-    int last_ping_index[NCHANNELS];
-    int last_value[NCHANNELS];
+    pingTracker tracker;
 
     public:
     getPingChunk(const int* kBands);
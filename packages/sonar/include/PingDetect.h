@@ -41,6 +41,22 @@ class pingDetect
     pingDetect(const int* hydro_threshold, int nchan, const int* bands, int p_detect_frame);
     ~pingDetect();
     int p_update(adcdata_t *sample);
+
+    /**
+     * Block version of the Fourier transform stage of p_update.  Runs
+     * nSamples samples, stored [nSamples][NCHANNELS], through the transform
+     * and writes the L1 magnitude of every band after each sample to magL1,
+     * stored [nSamples][nKBands][NCHANNELS].
+     *
+     * Each sample's magnitudes must then be passed to p_detect, in order.
+     */
+    void p_transform(const adcdata_t *samples, int nSamples, adcmath_t *magL1);
+
+    /**
+     * Detection stage of p_update for one sample, given its band magnitudes
+     * ([nKBands][NCHANNELS]).  Returns the same value as p_update.
+     */
+    int p_detect(const adcmath_t *magL1);
     void reset_minmax();
     void purge();
 }; //pingDetect
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/sonar/include/PingPipeline.h
+ */
+
+#ifndef _RAM_SONAR_PING_PIPELINE
+#define _RAM_SONAR_PING_PIPELINE
+
+#include "Sonar.h"
+#include "PingDetect.h"
+#include "PingTracker.h"
+#include "filter/BlockFiniteInputResponseFilter.h"
+
+// Forward declare
+extern "C" {
+    struct dataset;
+}
+
+namespace ram {
+namespace sonar {
+
+/**
+ * Block based version of getPingChunk.  The dataset is streamed through
+ *
+ *   FIR filter -> sliding DFT -> ping detection -> chunk extraction
+ *
+ * BLOCKSIZE samples at a time, each stage consuming the contiguous output
+ * buffer of the one before it.  Without a filter it finds exactly the same
+ * chunks as getPingChunk.
+ */
+class PingPipeline {
+public:
+    /** Samples per block, divides the dataset allocation unit */
+    static const int BLOCKSIZE = 256;
+    /** Order of the optional band-pass filter */
+    static const int FIR_ORDER = 31;
+
+    typedef filter::BlockFiniteInputResponseFilter<adc<16>, FIR_ORDER, NCHANNELS>
+        Filter;
+
+    /**
+     * @param kBands   Frequency bands, as for getPingChunk
+     * @param firTaps  FIR_ORDER+1 filter taps, or NULL to skip the filter
+     * @param firShift Right shift bringing the filter output back to
+     *                 adcdata_t range (15 for Q15 taps)
+     */
+    PingPipeline(const int* kBands, const adcdata_t* firTaps = NULL,
+                 int firShift = 15);
+    ~PingPipeline();
+
+    /** Same contract as getPingChunk::getChunk */
+    int getChunk(adcdata_t** data, int* locations, struct dataset* dataSet);
+
+private:
+    /** Interleaves nSamples samples starting at start into samples */
+    void readBlock(struct dataset* dataSet, int start, int nSamples);
+
+    /** Runs the block through the filter, in place */
+    void filterBlock(int nSamples);
+
+    pingDetect pdetect;
+    pingTracker tracker;
+    Filter* fir;
+    int firShift;
+
+    adcdata_t samples[BLOCKSIZE][NCHANNELS];
+    Filter::ACCUM::SIGNED filtered[BLOCKSIZE][NCHANNELS];
+    adcmath_t magL1[BLOCKSIZE][nKBands][NCHANNELS];
+};
+
+}//sonar
+}//ram
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/sonar/include/PingTracker.h
+ */
+
+#ifndef _RAM_SONAR_PING_TRACKER
+#define _RAM_SONAR_PING_TRACKER
+
+#include "PingDetect.h"
+
+// Forward declare
+extern "C" {
+    struct dataset;
+}
+
+namespace ram {
+namespace sonar {
+
+/**
+ * Chunk extraction stage of the ping detector.  It is fed the detection
+ * result of pingDetect for each sample of a dataset, in order, and waits
+ * until every channel has detected the ping within MAX_PING_SEP samples of
+ * the others.  It then copies ENV_CALC_FRAME samples around each channel's
+ * detection point out of the dataset.
+ */
+class pingTracker {
+    int last_detected;
+    int last_ping_index[NCHANNELS];
+    int last_value[NCHANNELS];
+
+    public:
+    pingTracker();
+    void purge();
+
+    /**
+     * @param i        Index of the sample in dataSet
+     * @param detected Value returned by pingDetect for sample i
+     * @param pdetect  The detector, recalibrated when needed
+     *
+     * @return 1 if a ping was found and data and locations were filled in
+     *         (see getPingChunk::getChunk), 0 if otherwise
+     */
+    int update(int i, int detected, pingDetect& pdetect, adcdata_t** data,
+               int* locations, struct dataset* dataSet);
+};
+
+}//sonar
+}//ram
+#endif
@@ -70,6 +70,28 @@ public:
 		}
 	}
 	
+	/**
+	 * Process a block of samples stored [nSamples][nChannels].
+	 *
+	 * @param triggered If not NULL, receives for each sample a bitmask of
+	 *                  the triggered channels (bit n for channel n).
+	 */
+	void updateBlock(const T *samples, int nSamples, int *triggered)
+	{
+		for (int i = 0 ; i < nSamples ; i ++, samples += nChannels)
+		{
+			update(samples);
+			if (triggered)
+			{
+				int mask = 0;
+				for (int channel = 0 ; channel < nChannels ; channel ++)
+					if (countAboveThresholds[channel] >= N)
+						mask |= 1 << channel;
+				triggered[i] = mask;
+			}
+		}
+	}
+	
 	void setThresholds(const T &thresh)
 	{
 		for (int channel = 0 ; channel < nChannels ; channel ++)
@@ -5,7 +5,9 @@
  * Based on work by Leo Singer.
  * @author Copyright 2008 Robotics@Maryland. All rights reserved.
  *
- * TODO: Currently nonfunctioning.  Fix based on SDFTSpectrum.h
+ * Single bin sliding DFT using the recursion from SDFTSpectrum.h.  Unlike
+ * TiledSlidingDFT, N does not have to be divisible by k, and the output is
+ * not scaled by the coefficient amplitude (see getUnity()).
  */
 
 
@@ -15,100 +17,119 @@
 
 #include "../Sonar.h"
 #include "SlidingDFT.h"
+#include "SlidingKernels.h"
+#include <strings.h>
+#include <string.h>
+#include <complex>
 
 
 namespace ram {
 namespace sonar {
 
-template<ADC, int nchannels, int k, int N>
+template<typename ADC, int nchannels, int k, int N>
 class FastSlidingDFT : public SlidingDFT<ADC> {
 
 public:
 	FastSlidingDFT()
 	{
-		coefreal = cos(2 * M_PI * k / N) * ADC::SIGNED_MAX;
-		coefimag = sin(2 * M_PI * k / N) * ADC::SIGNED_MAX;
+		coefreal = (typename ADC::SIGNED)
+			((double)ADC::SIGNED_MAX * std::cos(2 * M_PI * (double)k / N));
+		coefimag = (typename ADC::SIGNED)
+			((double)ADC::SIGNED_MAX * std::sin(2 * M_PI * (double)k / N));
 		purge();
 	}
-	
+
 	virtual void purge()
 	{
-		bzero(sumreal, sizeof(*sumreal) * nchannels);
-		bzero(sumimag, sizeof(*sumimag) * nchannels);
+		for (int channel = 0 ; channel < nchannels ; channel ++)
+			fourier[channel] = 0;
 		bzero(mag, sizeof(*mag) * nchannels);
 		bzero(window, sizeof(**window) * N * nchannels);
 		curidx = 0;
 	}
-	
+
 	virtual void update(const typename ADC::SIGNED* sample)
 	{
+		//	After http://www.comm.toronto.edu/~dimitris/ece431/slidingdft.pdf
+
+		/*	Step 1: Replace the oldest sample in the window with the new one.
+		 *	Since all ADC data is real, only the real part of the DFT sum
+		 *	changes, by the difference of the two.
+		 */
+
+		typename ADC::DOUBLE_WIDE::SIGNED diff[nchannels];
 		for (int channel = 0 ; channel < nchannels ; channel ++)
 		{
-			
-			//	After http://www.comm.toronto.edu/~dimitris/ece431/slidingdft.pdf
-			
-			/*	Step 1: Subtract the old data from the real part sum.
-			 *	This removes the x(0) term from the DFT, corresponding to the
-			 *	data point that is getting pushed out of the window.
-			 *	Since all ADC data is real, we do not touch the imaginary part.
-			 */
-			
-			sumreal[channel] -= window[channel][curidx];
-			
-			/*	Step 2: Add the new data point in the x(0) position.
-			 *	Also store new data in the buffer.
-			 */
-			
-			sumreal[channel] += sample[channel];
-			window[channel][curidx] = sample[channel];
-			
-			/*	Step 3: Phase-shift the DFT sum.
-			 *	Note that after step 2, the point that should be x(N-1) is in the
-			 *	x(0) position.  We can correct this simply "rotating" the DFT *backwards*
-			 *	one index.  We use a single complex multiplication to achieve this, using a
-			 *	constanst factor:
-			 *	
-			 *	coef = exp(2*pi*i*k/N)
-			 *
-			 *	Note that the exponent is positive; this causes the backwards shift.
-			 */
-			
-			typename ADC::DOUBLE_WIDE::SIGNED tmp = coefreal * sumreal[channel] - coefimag * sumimag[channel];
-			sumimag[channel] = coefreal * sumimag[channel] + coefimag * sumreal[channel];
-			sumreal[channel] = tmp;
-			
-			/*	We compute the L1 norm (|a|+|b|) instead of the L2 norm 
-			 *	sqrt(a^2+b^2) in order to aovid integer overflow.  Since we are only
-			 *	using the magnitude for thresholding, this is an acceptable 
-			 *	approximation.
-			 */
-			
-			mag[channel] = abs(sumreal[channel]) + abs(sumimag[channel]);
+			diff[channel] = sample[channel] - window[curidx][channel];
+			window[curidx][channel] = sample[channel];
 		}
-		
-		/*	curidx represents the index into the circular buffers 
-		 *	windowreal[channel] and windowimag[channel] at which the just-received
-		 *	sample will be added to the DFT sum.
+
+		/*	Step 2: Phase-shift the DFT sum.
+		 *	After step 1, the point that should be x(N-1) is in the x(0)
+		 *	position.  We correct this by "rotating" the DFT *backwards* one
+		 *	index with a single fixed point complex multiplication by
+		 *
+		 *	coef = exp(2*pi*i*k/N)
+		 *
+		 *	Note that the exponent is positive; this causes the backwards shift.
+		 */
+
+		Kernels::rotate(fourier, diff, coefreal, coefimag,
+		                ADC::BITDEPTH - 1, nchannels);
+
+		/*	We compute the L1 norm (|a|+|b|) instead of the L2 norm
+		 *	sqrt(a^2+b^2) in order to aovid integer overflow.  Since we are only
+		 *	using the magnitude for thresholding, this is an acceptable
+		 *	approximation.
+		 */
+
+		for (int channel = 0 ; channel < nchannels ; channel ++)
+			mag[channel] = fixed::magL1(fourier[channel]);
+
+		/*	curidx represents the index into the circular buffer window
+		 *	holding the oldest sample.
 		 */
-		
+
 		++curidx;
 		if (curidx == N)
 			curidx = 0;
 	}
-	
-	
+
+
+	virtual void updateBlock(const typename ADC::SIGNED * samples, int nSamples,
+	                         typename ADC::DOUBLE_WIDE::SIGNED * magL1 = NULL)
+	{
+		//	Qualified calls so the per-sample step is not a virtual call
+		for (int i = 0 ; i < nSamples ; i ++, samples += nchannels)
+		{
+			FastSlidingDFT::update(samples);
+			if (magL1)
+			{
+				memcpy(magL1, mag, sizeof(*mag) * nchannels);
+				magL1 += nchannels;
+			}
+		}
+	}
+
+
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getMagL1(int channel) const {return mag[channel];}
-	virtual typename ADC::DOUBLE_WIDE::SIGNED getReal(int channel) const {return sumreal[channel];}
-	virtual typename ADC::DOUBLE_WIDE::SIGNED getImag(int channel) const {return sumimag[channel];}
+	virtual typename ADC::DOUBLE_WIDE::SIGNED getReal(int channel) const {return fourier[channel].real();}
+	virtual typename ADC::DOUBLE_WIDE::SIGNED getImag(int channel) const {return fourier[channel].imag();}
+	virtual typename ADC::DOUBLE_WIDE::SIGNED getUnity() const {return N * ADC::SIGNED_MAX;}
 	virtual int getCountChannels() const {return nchannels;}
 	virtual int getFourierIndex() const {return k;}
 	virtual int getWindowSize() const {return N;}
-	
+
 private:
-	typename ADC::SIGNED  coefreal, coefimag;
-	typename ADC::SIGNED window[nchannels][N];
-	typename ADC::DOUBLE_WIDE::SIGNED sumreal[nchannels], sumimag[nchannels], mag[nchannels];
-	
+	typedef dft::SlidingKernels<typename ADC::SIGNED,
+	                            typename ADC::DOUBLE_WIDE::SIGNED,
+	                            typename ADC::QUADRUPLE_WIDE::SIGNED> Kernels;
+
+	typename ADC::SIGNED coefreal, coefimag;
+	typename ADC::SIGNED window[N][nchannels];
+	std::complex<typename ADC::DOUBLE_WIDE::SIGNED> fourier[nchannels];
+	typename ADC::DOUBLE_WIDE::SIGNED mag[nchannels];
+
 	int curidx;
 };
 
@@ -117,4 +138,3 @@ private:
 } // namespace ram
 
 #endif
-
@@ -31,6 +31,26 @@ public:
 	virtual ~SlidingDFT() {}
 	virtual void purge() =0;
 	virtual void update(const typename ADC::SIGNED *) =0;
+	
+	/**
+	 * Process a block of samples stored [nSamples][getCountChannels()].
+	 *
+	 * @param magL1 If not NULL, receives the L1 magnitude of every channel
+	 *              after each sample, also stored [nSamples][channels].
+	 */
+	virtual void updateBlock(const typename ADC::SIGNED *samples, int nSamples,
+	                         typename ADC::DOUBLE_WIDE::SIGNED *magL1 = NULL)
+	{
+		int nchannels = getCountChannels();
+		for (int i = 0 ; i < nSamples ; i ++)
+		{
+			update(samples + i * nchannels);
+			if (magL1)
+				for (int channel = 0 ; channel < nchannels ; channel ++)
+					*magL1++ = getMagL1(channel);
+		}
+	}
+	
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getReal(int channel) const =0;
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getImag(int channel) const =0;
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getMagL1(int channel) const =0;
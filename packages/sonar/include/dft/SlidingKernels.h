@@ -0,0 +1,200 @@
+/**
+ * @file SlidingKernels.h
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ * Per-sample inner loops shared by the sliding DFTs and the SDFT based
+ * spectrum analyzers.  Each kernel updates every channel of one frequency
+ * bin at once.  The generic versions are plain C++; the specialization for
+ * 16 bit samples with 32 bit accumulators (adc<9> through adc<16>) uses
+ * SSE2/SSE4.1 when the compiler targets them and is bit-exact with the
+ * generic version.
+ *
+ */
+
+#ifndef _RAM_SONAR_DFT_SLIDINGKERNELS_H
+#define _RAM_SONAR_DFT_SLIDINGKERNELS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <complex>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+
+namespace ram {
+namespace sonar {
+namespace dft {
+
+/**
+ * Reference implementation of the sliding kernels.
+ *
+ * @param S Sample type (ADC::SIGNED)
+ * @param W Accumulator type (ADC::DOUBLE_WIDE::SIGNED)
+ * @param Q Intermediate product type (ADC::QUADRUPLE_WIDE::SIGNED)
+ */
+template<typename S, typename W, typename Q>
+struct ScalarSlidingKernels
+{
+	/**
+	 * One step of the tiled (sliding dot product) DFT.
+	 *
+	 * Replaces the window terms winRe/winIm with coef * sample, moves the
+	 * running sums by the difference and recomputes the L1 magnitude.
+	 */
+	static void tiled(const S* sample, S coefRe, S coefIm,
+	                  W* winRe, W* winIm, W* sumRe, W* sumIm, W* mag,
+	                  int nchannels, int first = 0)
+	{
+		for (int channel = first ; channel < nchannels ; channel ++)
+		{
+			sumRe[channel] -= winRe[channel];
+			sumIm[channel] -= winIm[channel];
+			winRe[channel] = (W) coefRe * sample[channel];
+			winIm[channel] = (W) coefIm * sample[channel];
+			sumRe[channel] += winRe[channel];
+			sumIm[channel] += winIm[channel];
+			mag[channel] = abs(sumRe[channel]) + abs(sumIm[channel]);
+		}
+	}
+
+	/**
+	 * One step of the sliding DFT recursion for one bin:
+	 *
+	 *   F <- (F + diff) * coef >> shift
+	 *
+	 * where diff is the newest sample minus the sample leaving the window.
+	 */
+	static void rotate(std::complex<W>* fourier, const W* diff,
+	                   S coefRe, S coefIm, int shift,
+	                   int nchannels, int first = 0)
+	{
+		for (int channel = first ; channel < nchannels ; channel ++)
+		{
+			W &fourRe = fourier[channel].real();
+			W &fourIm = fourier[channel].imag();
+
+			W rhsRe = fourRe + diff[channel];
+
+			fourRe = (W) (((Q)coefRe * rhsRe - (Q)coefIm * fourIm) >> shift);
+			fourIm = (W) (((Q)coefRe * fourIm + (Q)coefIm * rhsRe) >> shift);
+		}
+	}
+};
+
+/**
+ * Kernels used by the DFT classes.  Defaults to the reference
+ * implementation; specialized below for platforms with SIMD support.
+ */
+template<typename S, typename W, typename Q>
+struct SlidingKernels : public ScalarSlidingKernels<S, W, Q> {};
+
+#ifdef __SSE2__
+
+template<>
+struct SlidingKernels<int16_t, int32_t, int64_t>
+	: public ScalarSlidingKernels<int16_t, int32_t, int64_t>
+{
+	typedef ScalarSlidingKernels<int16_t, int32_t, int64_t> Scalar;
+
+	/** Four channels per iteration, 16x16->32 bit products */
+	static void tiled(const int16_t* sample, int16_t coefRe, int16_t coefIm,
+	                  int32_t* winRe, int32_t* winIm,
+	                  int32_t* sumRe, int32_t* sumIm, int32_t* mag,
+	                  int nchannels)
+	{
+		const __m128i cRe = _mm_set1_epi16(coefRe);
+		const __m128i cIm = _mm_set1_epi16(coefIm);
+		int channel = 0;
+		for ( ; channel + 4 <= nchannels ; channel += 4)
+		{
+			__m128i x = _mm_loadl_epi64((const __m128i*) (sample + channel));
+
+			//	Full 32 bit products from the low and high halves
+			__m128i pRe = _mm_unpacklo_epi16(_mm_mullo_epi16(x, cRe),
+			                                 _mm_mulhi_epi16(x, cRe));
+			__m128i pIm = _mm_unpacklo_epi16(_mm_mullo_epi16(x, cIm),
+			                                 _mm_mulhi_epi16(x, cIm));
+
+			__m128i sRe = _mm_loadu_si128((__m128i*) (sumRe + channel));
+			__m128i sIm = _mm_loadu_si128((__m128i*) (sumIm + channel));
+			sRe = _mm_sub_epi32(sRe, _mm_loadu_si128((__m128i*) (winRe + channel)));
+			sIm = _mm_sub_epi32(sIm, _mm_loadu_si128((__m128i*) (winIm + channel)));
+			sRe = _mm_add_epi32(sRe, pRe);
+			sIm = _mm_add_epi32(sIm, pIm);
+
+			_mm_storeu_si128((__m128i*) (winRe + channel), pRe);
+			_mm_storeu_si128((__m128i*) (winIm + channel), pIm);
+			_mm_storeu_si128((__m128i*) (sumRe + channel), sRe);
+			_mm_storeu_si128((__m128i*) (sumIm + channel), sIm);
+			_mm_storeu_si128((__m128i*) (mag + channel),
+			                 _mm_add_epi32(abs32(sRe), abs32(sIm)));
+		}
+		Scalar::tiled(sample, coefRe, coefIm, winRe, winIm, sumRe, sumIm, mag,
+		              nchannels, channel);
+	}
+
+#ifdef __SSE4_1__
+	/**
+	 * Two channels per 128 bit register.  std::complex<int32_t> is stored
+	 * as {re, im}, so the real parts sit in the even lanes where
+	 * _mm_mul_epi32 picks up its operands.
+	 */
+	static void rotate(std::complex<int32_t>* fourier, const int32_t* diff,
+	                   int16_t coefRe, int16_t coefIm, int shift,
+	                   int nchannels)
+	{
+		const __m128i cRe = _mm_set_epi32(0, coefRe, 0, coefRe);
+		const __m128i cIm = _mm_set_epi32(0, coefIm, 0, coefIm);
+		const __m128i count = _mm_cvtsi32_si128(shift);
+		const __m128i lowMask = _mm_set_epi32(0, -1, 0, -1);
+		int32_t* four = reinterpret_cast<int32_t*>(fourier);
+		int channel = 0;
+		for ( ; channel + 2 <= nchannels ; channel += 2)
+		{
+			__m128i f = _mm_loadu_si128((__m128i*) (four + 2 * channel));
+			__m128i d = _mm_set_epi32(0, diff[channel + 1], 0, diff[channel]);
+
+			//	Even lanes: rhsRe = re + diff, odd lanes: im
+			__m128i rhs = _mm_add_epi32(f, d);
+			__m128i im = _mm_srli_epi64(rhs, 32);
+
+			__m128i re64 = _mm_sub_epi64(_mm_mul_epi32(rhs, cRe),
+			                             _mm_mul_epi32(im, cIm));
+			__m128i im64 = _mm_add_epi64(_mm_mul_epi32(im, cRe),
+			                             _mm_mul_epi32(rhs, cIm));
+
+			//	Truncating to 32 bits only keeps bits [shift, shift + 32),
+			//	which are the same for logical and arithmetic shifts.
+			re64 = _mm_and_si128(_mm_srl_epi64(re64, count), lowMask);
+			im64 = _mm_slli_epi64(_mm_srl_epi64(im64, count), 32);
+
+			_mm_storeu_si128((__m128i*) (four + 2 * channel),
+			                 _mm_or_si128(re64, im64));
+		}
+		Scalar::rotate(fourier, diff, coefRe, coefIm, shift, nchannels, channel);
+	}
+#endif // __SSE4_1__
+
+private:
+	/** SSE2 has no packed absolute value, so use (x ^ s) - s */
+	static __m128i abs32(__m128i x)
+	{
+		__m128i s = _mm_srai_epi32(x, 31);
+		return _mm_sub_epi32(_mm_xor_si128(x, s), s);
+	}
+};
+
+#endif // __SSE2__
+
+
+} // namespace dft
+} // namespace sonar
+} // namespace ram
+
+
+#endif
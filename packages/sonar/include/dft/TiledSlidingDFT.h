@@ -18,7 +18,9 @@
 
 #include "../Sonar.h"
 #include "SlidingDFT.h"
+#include "SlidingKernels.h"
 #include <strings.h>
+#include <string.h>
 #include <cassert>
 
 namespace ram {
@@ -55,59 +57,28 @@ public:
 	
 	virtual void update(const typename ADC::SIGNED * sample)
 	{
-		for (int channel = 0 ; channel < nchannels ; channel ++)
-		{
-			/*	We subtract window____[channel][firstidx] because both windowreal[i]
-			 *	and windowimag[i] are circular buffers.  On the next call of this 
-			 *	function, window____[channel][firstidx] will be overwritten with 
-			 *	computations from the next sample.
-			 */
-			
-			sumreal[channel] -= windowreal[channel][curidx];
-			sumimag[channel] -= windowimag[channel][curidx];
-			
-			/*	For each sample we receive, we only need to compute one new term in
-			 *	the DFT sum.  These two lines together compute 
-			 *
-			 *		f(N-1) x cos(2 pi k (N - 1) / N) 
-			 *
-			 *	and
-			 *
-			 *		f(N-1) x sin(2 pi k (N - 1) / N)
-			 *
-			 *	which are, respectively, the real and imaginary parts of 
-			 *	
-			 *		f(N-1) x exp(2 pi i k (N - 1) / N)
-			 *	
-			 *	which is simply the last term of the sum for F(k).
-			 */
-			
-			windowreal[channel][curidx] = (typename ADC::DOUBLE_WIDE::SIGNED) coefreal[curidx] * sample[channel];
-			windowimag[channel][curidx] = (typename ADC::DOUBLE_WIDE::SIGNED) coefimag[curidx] * sample[channel];
-			
-			/*	The next two lines update the real and imaginary part of the complex
-			 *	output amplitude.
-			 *	
-			 *	We add window____[channel][curidx] to sum____[chan constnel] because all 
-			 *	of the previous N-1 terms of F(k), numbered 0,1,...,N-3,N-2, were 
-			 *	calculated and summed during previous iterations of this function - 
-			 *	hence the name "sliding DFT".
-			 */
-			
-			sumreal[channel] += windowreal[channel][curidx];
-			sumimag[channel] += windowimag[channel][curidx];
-			
-			/*	We compute the L1 norm (|a|+|b|) instead of the L2 norm 
-			 *	sqrt(a^2+b^2) in order to aovid integer overflow.  Since we are only
-			 *	using the magnitude for thresholding, this is an acceptable 
-			 *	approximation.
-			 */
-			
-			mag[channel] = abs(sumreal[channel]) + abs(sumimag[channel]);
-		}
+		/*	For each sample we receive, we only need to compute one new term in
+		 *	the DFT sum for every channel:
+		 *
+		 *		f(N-1) x exp(2 pi i k (N - 1) / N)
+		 *
+		 *	The kernel subtracts the term computed N samples ago (still held in
+		 *	window____[curidx]), stores the new term there and adds it to the
+		 *	running sums - hence the name "sliding DFT".  The window buffers
+		 *	are laid out [N][nchannels] so all channels are updated together.
+		 *
+		 *	The L1 norm (|a|+|b|) is computed instead of the L2 norm 
+		 *	sqrt(a^2+b^2) in order to aovid integer overflow.  Since we are only
+		 *	using the magnitude for thresholding, this is an acceptable 
+		 *	approximation.
+		 */
+		
+		Kernels::tiled(sample, coefreal[curidx], coefimag[curidx],
+		               windowreal[curidx], windowimag[curidx],
+		               sumreal, sumimag, mag, nchannels);
 		
 		/*	curidx represents the index into the circular buffers 
-		 *	windowreal[channel] and windowimag[channel] at which the just-received
+		 *	windowreal and windowimag at which the just-received
 		 *	sample will be added to the DFT sum.
 		 */
 		
@@ -117,6 +88,22 @@ public:
 	}
 	
 	
+	virtual void updateBlock(const typename ADC::SIGNED * samples, int nSamples,
+	                         typename ADC::DOUBLE_WIDE::SIGNED * magL1 = NULL)
+	{
+		//	Qualified calls so the per-sample step is not a virtual call
+		for (int i = 0 ; i < nSamples ; i ++, samples += nchannels)
+		{
+			TiledSlidingDFT::update(samples);
+			if (magL1)
+			{
+				memcpy(magL1, mag, sizeof(*mag) * nchannels);
+				magL1 += nchannels;
+			}
+		}
+	}
+	
+	
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getMagL1(int channel) const {return mag[channel];}
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getReal(int channel) const {return sumreal[channel];}
 	virtual typename ADC::DOUBLE_WIDE::SIGNED getImag(int channel) const {return sumimag[channel];}
@@ -125,8 +112,12 @@ public:
 	virtual int getWindowSize() const {return N;}
 	
 private:
+	typedef dft::SlidingKernels<typename ADC::SIGNED,
+	                            typename ADC::DOUBLE_WIDE::SIGNED,
+	                            typename ADC::QUADRUPLE_WIDE::SIGNED> Kernels;
+	
 	typename ADC::SIGNED coefreal[N], coefimag[N];
-	typename ADC::DOUBLE_WIDE::SIGNED windowreal[nchannels][N], windowimag[nchannels][N];
+	typename ADC::DOUBLE_WIDE::SIGNED windowreal[N][nchannels], windowimag[N][nchannels];
 	typename ADC::DOUBLE_WIDE::SIGNED sumreal[nchannels], sumimag[nchannels], mag[nchannels];
 	int curidx;
 	
@@ -0,0 +1,379 @@
+/**
+ * @file BlockFiniteInputResponseFilter.h
+ * Block mode fixed point finite input response filter
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ * Same response as FiniteInputResponseFilter, but filters whole blocks of
+ * samples at a time.  Short filters use a direct form convolution with a
+ * SIMD dot product; long filters use overlap-save FFT convolution, which
+ * costs O(log N) instead of O(N) per sample.  BlockFiniteInputResponseFilter
+ * picks between the two based on the order of the filter.
+ *
+ */
+
+#ifndef _RAM_SONAR_FILTER_BLOCKFINITEINPUTRESPONSEFILTER_H
+#define _RAM_SONAR_FILTER_BLOCKFINITEINPUTRESPONSEFILTER_H
+
+#include <string.h>
+#include <stdint.h>
+#include <boost/mpl/if.hpp>
+#include <boost/integer/static_log2.hpp>
+#include "adctypes.h"
+#include "fixed/fixed.h"
+#include "filter/FiniteInputResponseFilter.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef __BFIN
+#include <fftw3.h>
+#endif
+
+namespace ram {
+namespace sonar {
+namespace filter {
+
+/**
+ * Filters of at least this order use overlap-save convolution, when it is
+ * available.
+ */
+static const int OVERLAP_SAVE_MIN_ORDER = 64;
+
+/**
+ * Reference dot product used by the direct form engine.
+ *
+ * @param S Sample and tap type
+ * @param A Accumulator type
+ */
+template<typename S, typename A>
+struct ScalarFIRKernels
+{
+	static A dot(const S* taps, const S* x, int len)
+	{
+		A acc = 0;
+		for (int i = 0 ; i < len ; i ++)
+			acc += (A)taps[i] * x[i];
+		return acc;
+	}
+};
+
+template<typename S, typename A>
+struct FIRKernels : public ScalarFIRKernels<S, A> {};
+
+#ifdef __SSE2__
+
+template<>
+struct FIRKernels<int16_t, int64_t> : public ScalarFIRKernels<int16_t, int64_t>
+{
+	/**
+	 * Eight taps per iteration; len must be a multiple of 8.
+	 *
+	 * _mm_madd_epi16 adds pairs of products in 32 bits, which only
+	 * overflows when both products are -32768 * -32768.  Callers must not
+	 * pass taps equal to -32768.
+	 */
+	static int64_t dot(const int16_t* taps, const int16_t* x, int len)
+	{
+		__m128i acc = _mm_setzero_si128();
+		for (int i = 0 ; i < len ; i += 8)
+		{
+			__m128i p = _mm_madd_epi16(_mm_loadu_si128((__m128i*) (taps + i)),
+			                           _mm_loadu_si128((__m128i*) (x + i)));
+			__m128i sign = _mm_srai_epi32(p, 31);
+			acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p, sign));
+			acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p, sign));
+		}
+		int64_t sum[2];
+		_mm_storeu_si128((__m128i*) sum, acc);
+		return sum[0] + sum[1];
+	}
+};
+
+#endif // __SSE2__
+
+
+/**
+ * Direct form block filter.  Keeps the last N samples of each channel in
+ * front of the current block, so every output is one contiguous dot
+ * product against the reversed taps.
+ */
+template<typename ADC, int N, int nchannels>
+class DirectFIREngine {
+public:
+	typedef typename FiniteInputResponseFilter<ADC, N, nchannels>::ACCUM ACCUM;
+
+	/** Largest number of samples filtered per pass */
+	static const int BLOCKSIZE = 256;
+
+private:
+	static const int bufLen = N + 1;
+	/** Tap count rounded up to the SIMD width */
+	static const int paddedLen = (bufLen + 7) & ~7;
+
+	typedef FIRKernels<typename ADC::SIGNED, typename ACCUM::SIGNED> Kernels;
+	typedef ScalarFIRKernels<typename ADC::SIGNED, typename ACCUM::SIGNED> Scalar;
+
+	/** Taps in reverse order, zero padded */
+	typename ADC::SIGNED Brev[paddedLen];
+	/** N samples of history, the current block and room for the padding */
+	typename ADC::SIGNED hist[nchannels][BLOCKSIZE + paddedLen - 1];
+	typename ACCUM::SIGNED Y[nchannels];
+	/** False if a tap would overflow the SIMD kernel */
+	bool useKernels;
+
+public:
+	DirectFIREngine(const typename ADC::SIGNED* coefs)
+	{
+		useKernels = true;
+		bzero(Brev, sizeof(Brev));
+		for (int i = 0 ; i < bufLen ; i ++)
+		{
+			Brev[N - i] = coefs[i];
+			if (coefs[i] == ADC::SIGNED_MIN)
+				useKernels = false;
+		}
+		purge();
+	}
+
+	void purge()
+	{
+		bzero(hist, sizeof(hist));
+		bzero(Y, sizeof(*Y) * nchannels);
+	}
+
+	/**
+	 * Filter a block of samples stored [nSamples][nchannels], writing the
+	 * output after each sample to out, also stored [nSamples][nchannels].
+	 */
+	void updateBlock(const typename ADC::SIGNED *samples, int nSamples,
+	                 typename ACCUM::SIGNED *out)
+	{
+		while (nSamples > 0)
+		{
+			int n = (nSamples < BLOCKSIZE) ? nSamples : BLOCKSIZE;
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+			{
+				typename ADC::SIGNED *x = hist[channel];
+				for (int i = 0 ; i < n ; i ++)
+					x[N + i] = samples[i * nchannels + channel];
+
+				for (int i = 0 ; i < n ; i ++)
+				{
+					out[i * nchannels + channel] = useKernels ?
+						Kernels::dot(Brev, x + i, paddedLen) :
+						Scalar::dot(Brev, x + i, bufLen);
+				}
+
+				//	Keep the last N samples for the next block
+				memmove(x, x + n, sizeof(*x) * N);
+			}
+			memcpy(Y, out + (n - 1) * nchannels, sizeof(*Y) * nchannels);
+			samples += n * nchannels;
+			out += n * nchannels;
+			nSamples -= n;
+		}
+	}
+
+	const typename ACCUM::SIGNED& operator[] (int channel) const
+	{
+		return Y[channel];
+	}
+};
+
+
+#ifndef __BFIN
+
+/**
+ * Overlap-save block filter.  Each pass transforms the last N samples of
+ * history followed by up to L new samples, multiplies by the transformed
+ * taps and keeps the outputs not affected by circular wrap-around.  The
+ * result is rounded back to fixed point, so it may differ from the direct
+ * form by the floating point error of the FFT.
+ */
+template<typename ADC, int N, int nchannels>
+class OverlapSaveFIREngine {
+public:
+	typedef typename FiniteInputResponseFilter<ADC, N, nchannels>::ACCUM ACCUM;
+
+	/** FFT size, the first power of two at least four times the taps */
+	static const int M = 1 << (boost::static_log2<4 * (N + 1) - 1>::value + 1);
+	/** New samples filtered per FFT */
+	static const int L = M - N;
+
+private:
+	static const int bufLen = N + 1;
+	static const int nFreq = M / 2 + 1;
+
+	/** Time domain input, [nchannels][M] */
+	double *in;
+	/** Time domain output, [nchannels][M] */
+	double *outTime;
+	/** Frequency domain, [nchannels][nFreq] */
+	fftw_complex *freq;
+	/** Transformed taps, divided by M to normalize the inverse FFT */
+	fftw_complex *H;
+
+	fftw_plan forward;
+	fftw_plan inverse;
+
+	typename ADC::SIGNED hist[nchannels][N + 1];
+	typename ACCUM::SIGNED Y[nchannels];
+
+	OverlapSaveFIREngine(const OverlapSaveFIREngine&);
+	OverlapSaveFIREngine& operator=(const OverlapSaveFIREngine&);
+
+public:
+	OverlapSaveFIREngine(const typename ADC::SIGNED* coefs)
+	{
+		const int dim = M;
+		in = (double*) fftw_malloc(sizeof(double) * M * nchannels);
+		outTime = (double*) fftw_malloc(sizeof(double) * M * nchannels);
+		freq = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nFreq * nchannels);
+		H = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nFreq);
+
+		//	Transform the taps once
+		fftw_plan tapPlan = fftw_plan_dft_r2c_1d(M, in, H, FFTW_ESTIMATE);
+		for (int i = 0 ; i < M ; i ++)
+			in[i] = (i < bufLen) ? coefs[i] : 0;
+		fftw_execute(tapPlan);
+		fftw_destroy_plan(tapPlan);
+		for (int k = 0 ; k < nFreq ; k ++)
+		{
+			H[k][0] /= M;
+			H[k][1] /= M;
+		}
+
+		forward = fftw_plan_many_dft_r2c(
+			1, &dim, nchannels,
+			in, NULL, 1, M,
+			freq, NULL, 1, nFreq,
+			FFTW_PATIENT);
+		inverse = fftw_plan_many_dft_c2r(
+			1, &dim, nchannels,
+			freq, NULL, 1, nFreq,
+			outTime, NULL, 1, M,
+			FFTW_PATIENT);
+
+		purge();
+	}
+
+	~OverlapSaveFIREngine()
+	{
+		fftw_destroy_plan(forward);
+		fftw_destroy_plan(inverse);
+		fftw_free(in);
+		fftw_free(outTime);
+		fftw_free(freq);
+		fftw_free(H);
+	}
+
+	void purge()
+	{
+		bzero(hist, sizeof(hist));
+		bzero(Y, sizeof(*Y) * nchannels);
+	}
+
+	/**
+	 * Filter a block of samples stored [nSamples][nchannels], writing the
+	 * output after each sample to out, also stored [nSamples][nchannels].
+	 */
+	void updateBlock(const typename ADC::SIGNED *samples, int nSamples,
+	                 typename ACCUM::SIGNED *out)
+	{
+		while (nSamples > 0)
+		{
+			int n = (nSamples < L) ? nSamples : L;
+
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+			{
+				double *x = in + channel * M;
+				for (int i = 0 ; i < N ; i ++)
+					x[i] = hist[channel][i];
+				for (int i = 0 ; i < n ; i ++)
+					x[N + i] = samples[i * nchannels + channel];
+				for (int i = N + n ; i < M ; i ++)
+					x[i] = 0;
+
+				//	Keep the last N samples for the next pass
+				for (int i = 0 ; i < N ; i ++)
+					hist[channel][i] = (typename ADC::SIGNED) x[n + i];
+			}
+
+			fftw_execute(forward);
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+			{
+				fftw_complex *X = freq + channel * nFreq;
+				for (int k = 0 ; k < nFreq ; k ++)
+				{
+					double re = X[k][0] * H[k][0] - X[k][1] * H[k][1];
+					double im = X[k][0] * H[k][1] + X[k][1] * H[k][0];
+					X[k][0] = re;
+					X[k][1] = im;
+				}
+			}
+			fftw_execute(inverse);
+
+			//	Outputs before index N wrapped around the end of the buffer
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+			{
+				const double *y = outTime + channel * M + N;
+				for (int i = 0 ; i < n ; i ++)
+					out[i * nchannels + channel] =
+						fixed::round<typename ACCUM::SIGNED>(y[i]);
+			}
+
+			memcpy(Y, out + (n - 1) * nchannels, sizeof(*Y) * nchannels);
+			samples += n * nchannels;
+			out += n * nchannels;
+			nSamples -= n;
+		}
+	}
+
+	const typename ACCUM::SIGNED& operator[] (int channel) const
+	{
+		return Y[channel];
+	}
+};
+
+#endif // __BFIN
+
+
+/**
+ * Block mode FIR filter with the same constructor and output as
+ * FiniteInputResponseFilter.
+ *
+ * @param ADC The adctype (@see adctypes.h)
+ * @param N   The order of the filter (N+1 taps)
+ * @param nchannels The number of hydrophone channels
+ */
+template<typename ADC, int N, int nchannels>
+class BlockFiniteInputResponseFilter : public
+#ifdef __BFIN
+	DirectFIREngine<ADC, N, nchannels>
+#else
+	boost::mpl::if_c<(N >= OVERLAP_SAVE_MIN_ORDER),
+	                 OverlapSaveFIREngine<ADC, N, nchannels>,
+	                 DirectFIREngine<ADC, N, nchannels> >::type
+#endif
+{
+public:
+#ifdef __BFIN
+	typedef DirectFIREngine<ADC, N, nchannels> Engine;
+#else
+	typedef typename boost::mpl::if_c<(N >= OVERLAP_SAVE_MIN_ORDER),
+	                                  OverlapSaveFIREngine<ADC, N, nchannels>,
+	                                  DirectFIREngine<ADC, N, nchannels> >::type Engine;
+#endif
+
+	BlockFiniteInputResponseFilter(const typename ADC::SIGNED* coefs)
+		: Engine(coefs) {}
+};
+
+} // namespace filter
+} // namespace sonar
+} // namespace ram
+
+
+#endif
@@ -29,8 +29,11 @@ template<typename ADC, int N, int nchannels>
 class FiniteInputResponseFilter {
 private:
     static const int bufLen = N + 1;
-	int idx;
+public:
+    /** Type wide enough to hold the output without overflow */
     typedef adc<2 * ADC::BITDEPTH + boost::static_log2<bufLen>::value> ACCUM;
+private:
+	int idx;
 	typename ADC::SIGNED X[bufLen][nchannels];
     typename ADC::SIGNED B[bufLen];
     typename ACCUM::SIGNED Y[nchannels];
@@ -69,6 +72,20 @@ public:
                 Y[channel] += (typename ADC::DOUBLE_WIDE::SIGNED)B[i] * X[i - bufLen + idx][channel];
 	}
     
+    /**
+     * Filter a block of samples stored [nSamples][nchannels], writing the
+     * output after each sample to out, also stored [nSamples][nchannels].
+     */
+    void updateBlock(const typename ADC::SIGNED *samples, int nSamples,
+                     typename ACCUM::SIGNED *out)
+    {
+        for (int i = 0 ; i < nSamples ; i ++)
+        {
+            update(samples + i * nchannels);
+            memcpy(out + i * nchannels, Y, sizeof(*Y) * nchannels);
+        }
+    }
+    
     const typename ACCUM::SIGNED& operator[] (int channel)
     {
         return Y[channel];
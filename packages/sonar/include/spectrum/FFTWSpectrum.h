@@ -130,6 +130,12 @@ public:
 		
 	}
 	
+	void updateBlock(const typename ADC::SIGNED* samples, int nSamples)
+	{
+		for (int i = 0 ; i < nSamples ; i ++)
+			update(samples + i * nchannels);
+	}
+	
 	const std::complex<typename ADC::DOUBLE_WIDE::SIGNED> &getAmplitude(int k, int channel) const
 	{
 		return fourier[k][channel];
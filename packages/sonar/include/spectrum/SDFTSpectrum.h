@@ -13,6 +13,7 @@
 
 
 #include "Spectrum.h"
+#include "../dft/SlidingKernels.h"
 #include <cmath>
 #include <string.h>
 
@@ -22,6 +23,10 @@ namespace sonar {
 template<typename ADC, int N, int nchannels>
 class SDFTSpectrum : Spectrum<ADC> {
 private:
+	typedef dft::SlidingKernels<typename ADC::SIGNED,
+	                            typename ADC::DOUBLE_WIDE::SIGNED,
+	                            typename ADC::QUADRUPLE_WIDE::SIGNED> Kernels;
+	
     /**
      * Index into the circular buffer referring to the oldest sample.
      */
@@ -29,7 +34,29 @@ private:
 	typename ADC::SIGNED data[N][nchannels];
 	std::complex<typename ADC::DOUBLE_WIDE::SIGNED> fourier[N][nchannels];
 	std::complex<typename ADC::SIGNED> coef[N];
+	
+	/**
+	 * Computes the difference between each new sample and the sample it
+	 * replaces in the window, then stores the new samples.
+	 */
+	void slide(const typename ADC::SIGNED *samples, int nSamples,
+	           typename ADC::DOUBLE_WIDE::SIGNED diff[][nchannels])
+	{
+		for (int i = 0 ; i < nSamples ; i ++, samples += nchannels)
+		{
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+				diff[i][channel] = samples[channel] - data[idx][channel];
+			memcpy(data[idx], samples, sizeof(*samples) * nchannels);
+			++idx;
+			if (idx == N)
+				idx = 0;
+		}
+	}
+	
 public:
+	/** Number of samples processed at a time by updateBlock() */
+	static const int BLOCKSIZE = 256;
+	
 	SDFTSpectrum()
 	{
 		//	Sample cosine and sine and store as signed 16 bit integers
@@ -46,29 +73,22 @@ public:
 	void purge()
 	{
 		bzero(data, sizeof(**data) * N * nchannels);
-		bzero(fourier, sizeof(**fourier) * N);
+		bzero(fourier, sizeof(**fourier) * N * nchannels);
 		idx = N - 1;
 	}
 	
 	void update(const typename ADC::SIGNED *sample)
 	{
+		typename ADC::DOUBLE_WIDE::SIGNED diff[nchannels];
 		for (int channel = 0 ; channel < nchannels ; channel ++)
-		{
-			typename ADC::DOUBLE_WIDE::SIGNED diff = sample[channel] - data[idx][channel];
-			for (int k = 0 ; k < N ; k ++)
-			{
-				//	Make some convenient shorthands for numbers we need
-				typename ADC::SIGNED coefRe = coef[k].real();
-				typename ADC::SIGNED coefIm = coef[k].imag();
-				typename ADC::DOUBLE_WIDE::SIGNED &fourRe = fourier[k][channel].real();
-				typename ADC::DOUBLE_WIDE::SIGNED &fourIm = fourier[k][channel].imag();
-				
-				typename ADC::DOUBLE_WIDE::SIGNED rhsRe = fourRe + diff;
-				
-				fourRe = (typename ADC::DOUBLE_WIDE::SIGNED) (((typename ADC::QUADRUPLE_WIDE::SIGNED)coefRe * rhsRe - (typename ADC::QUADRUPLE_WIDE::SIGNED)coefIm * fourIm) >> (ADC::BITDEPTH - 1));
-				fourIm = (typename ADC::DOUBLE_WIDE::SIGNED) (((typename ADC::QUADRUPLE_WIDE::SIGNED)coefRe * fourIm + (typename ADC::QUADRUPLE_WIDE::SIGNED)coefIm * rhsRe) >> (ADC::BITDEPTH - 1));
-			}
-		}
+			diff[channel] = sample[channel] - data[idx][channel];
+		
+		//	Every channel of a bin shares the same coefficient, so rotate them
+		//	together
+		for (int k = 0 ; k < N ; k ++)
+			Kernels::rotate(fourier[k], diff,
+			                coef[k].real(), coef[k].imag(),
+			                ADC::BITDEPTH - 1, nchannels);
         
         //  Overwrite the old samples
         memcpy(data[idx], sample, sizeof(*sample)*nchannels);
@@ -78,6 +98,27 @@ public:
 			idx = 0;
 	}
 	
+	/**
+	 * Process a block of samples stored [nSamples][nchannels].  Each bin is
+	 * carried through the whole block before moving on to the next one.
+	 */
+	void updateBlock(const typename ADC::SIGNED *samples, int nSamples)
+	{
+		typename ADC::DOUBLE_WIDE::SIGNED diff[BLOCKSIZE][nchannels];
+		while (nSamples > 0)
+		{
+			int n = (nSamples < BLOCKSIZE) ? nSamples : BLOCKSIZE;
+			slide(samples, n, diff);
+			for (int k = 0 ; k < N ; k ++)
+				for (int i = 0 ; i < n ; i ++)
+					Kernels::rotate(fourier[k], diff[i],
+					                coef[k].real(), coef[k].imag(),
+					                ADC::BITDEPTH - 1, nchannels);
+			samples += n * nchannels;
+			nSamples -= n;
+		}
+	}
+	
 	const std::complex<typename ADC::DOUBLE_WIDE::SIGNED> &getAmplitude(int k, int channel) const
 	{ return fourier[k][channel]; }
 };
@@ -15,6 +15,8 @@
 
 
 #include "Spectrum.h"
+#include "../dft/SlidingKernels.h"
+#include "../fixed/fixed.h"
 #include <cmath>
 #include <string.h>
 
@@ -24,12 +26,38 @@ namespace sonar {
 template<typename ADC, int N, int nchannels, int nFreqBands>
 class SparseSDFTSpectrum : Spectrum<ADC> {
 private:
+	typedef dft::SlidingKernels<typename ADC::SIGNED,
+	                            typename ADC::DOUBLE_WIDE::SIGNED,
+	                            typename ADC::QUADRUPLE_WIDE::SIGNED> Kernels;
+	
 	int idx;
 	typename ADC::SIGNED data[N][nchannels];
 	std::complex<typename ADC::DOUBLE_WIDE::SIGNED> fourier[nFreqBands][nchannels];
 	std::complex<typename ADC::SIGNED> coef[nFreqBands];
 	int kBands[nFreqBands];
+	
+	/**
+	 * Computes the difference between each new sample and the sample it
+	 * replaces in the window, then stores the new samples.
+	 */
+	void slide(const typename ADC::SIGNED *samples, int nSamples,
+	           typename ADC::DOUBLE_WIDE::SIGNED diff[][nchannels])
+	{
+		for (int i = 0 ; i < nSamples ; i ++, samples += nchannels)
+		{
+			for (int channel = 0 ; channel < nchannels ; channel ++)
+				diff[i][channel] = samples[channel] - data[idx][channel];
+			memcpy(data[idx], samples, sizeof(*samples) * nchannels);
+			++idx;
+			if (idx == N)
+				idx = 0;
+		}
+	}
+	
 public:
+	/** Number of samples processed at a time by updateBlock() */
+	static const int BLOCKSIZE = 256;
+	
 	SparseSDFTSpectrum(const int *kBands)
 	{
 		memcpy(this->kBands, kBands, sizeof(int) * nFreqBands);
@@ -54,23 +82,16 @@ public:
 	
 	void update(const typename ADC::SIGNED *sample)
 	{
+		typename ADC::DOUBLE_WIDE::SIGNED diff[nchannels];
 		for (int channel = 0 ; channel < nchannels ; channel ++)
-		{
-			typename ADC::DOUBLE_WIDE::SIGNED diff = sample[channel] - data[idx][channel];
-			for (int kIdx = 0 ; kIdx < nFreqBands ; kIdx ++)
-			{
-				//	Make some convenient shorthands for numbers we need
-				typename ADC::SIGNED coefRe = coef[kIdx].real();
-				typename ADC::SIGNED coefIm = coef[kIdx].imag();
-				typename ADC::DOUBLE_WIDE::SIGNED &fourRe = fourier[kIdx][channel].real();
-				typename ADC::DOUBLE_WIDE::SIGNED &fourIm = fourier[kIdx][channel].imag();
-				
-				typename ADC::DOUBLE_WIDE::SIGNED rhsRe = fourRe + diff;
-				
-				fourRe = (typename ADC::DOUBLE_WIDE::SIGNED)(((typename ADC::QUADRUPLE_WIDE::SIGNED)coefRe * rhsRe - (typename ADC::QUADRUPLE_WIDE::SIGNED)coefIm * fourIm) >> (ADC::BITDEPTH - 1));
-				fourIm = (typename ADC::DOUBLE_WIDE::SIGNED)(((typename ADC::QUADRUPLE_WIDE::SIGNED)coefRe * fourIm + (typename ADC::QUADRUPLE_WIDE::SIGNED)coefIm * rhsRe) >> (ADC::BITDEPTH - 1));
-			}
-		}
+			diff[channel] = sample[channel] - data[idx][channel];
+		
+		//	Every channel of a bin shares the same coefficient, so rotate them
+		//	together
+		for (int kIdx = 0 ; kIdx < nFreqBands ; kIdx ++)
+			Kernels::rotate(fourier[kIdx], diff,
+			                coef[kIdx].real(), coef[kIdx].imag(),
+			                ADC::BITDEPTH - 1, nchannels);
         
         //  Overwrite the old samples
 		memcpy(data[idx], sample, sizeof(*sample) * nchannels);
@@ -80,6 +101,47 @@ public:
 			idx = 0;
 	}
 	
+	/**
+	 * Process a block of samples stored [nSamples][nchannels].  Each bin is
+	 * carried through the whole block before moving on to the next one.
+	 *
+	 * @param magL1 If not NULL, receives the L1 magnitude of every bin after
+	 *              each sample, stored [nSamples][nFreqBands][nchannels].
+	 */
+	void updateBlock(const typename ADC::SIGNED *samples, int nSamples,
+	                 typename ADC::DOUBLE_WIDE::SIGNED *magL1)
+	{
+		typename ADC::DOUBLE_WIDE::SIGNED diff[BLOCKSIZE][nchannels];
+		while (nSamples > 0)
+		{
+			int n = (nSamples < BLOCKSIZE) ? nSamples : BLOCKSIZE;
+			slide(samples, n, diff);
+			for (int kIdx = 0 ; kIdx < nFreqBands ; kIdx ++)
+			{
+				for (int i = 0 ; i < n ; i ++)
+				{
+					Kernels::rotate(fourier[kIdx], diff[i],
+					                coef[kIdx].real(), coef[kIdx].imag(),
+					                ADC::BITDEPTH - 1, nchannels);
+					if (magL1)
+					{
+						typename ADC::DOUBLE_WIDE::SIGNED *out =
+							magL1 + (i * nFreqBands + kIdx) * nchannels;
+						for (int channel = 0 ; channel < nchannels ; channel ++)
+							out[channel] = fixed::magL1(fourier[kIdx][channel]);
+					}
+				}
+			}
+			samples += n * nchannels;
+			nSamples -= n;
+			if (magL1)
+				magL1 += n * nFreqBands * nchannels;
+		}
+	}
+	
+	void updateBlock(const typename ADC::SIGNED *samples, int nSamples)
+	{ updateBlock(samples, nSamples, NULL); }
+	
 	const typename std::complex<typename ADC::DOUBLE_WIDE::SIGNED> &getAmplitudeForBinIndex(int kIdx, int channel) const
 	{ return fourier[kIdx][channel]; }
 	
@@ -25,6 +25,12 @@ public:
 	virtual ~Spectrum() {}
 	virtual void purge() =0;
 	virtual void update(const typename ADC::SIGNED *) =0;
+	
+	/**
+	 * Process a block of samples stored [nSamples][nchannels].  The
+	 * amplitudes afterwards are the same as after nSamples calls to update().
+	 */
+	virtual void updateBlock(const typename ADC::SIGNED *samples, int nSamples) =0;
 	virtual const std::complex<typename ADC::DOUBLE_WIDE::SIGNED> &getAmplitude(int k, int channel) const =0;
 	virtual const std::complex<typename ADC::DOUBLE_WIDE::SIGNED> &operator() (int k, int channel) const 
 	{ return getAmplitude(k, channel); }
@@ -58,21 +58,43 @@ void pingDetect::purge()
 }
         
 /* Updates the Fourier Transform with sample then updates the min-max
- * algorithm.
+ * algorithm through p_detect.
+ */
+int
+pingDetect::p_update(adcdata_t *sample)
+{
+    adcmath_t magL1[nKBands][NCHANNELS];
+    spectrum.update(sample);
+    for(int kBand=0; kBand<nKBands; kBand++)
+        for(int channel=0; channel<numchan; channel++)
+            magL1[kBand][channel] = fixed::magL1(spectrum.getAmplitudeForBinIndex(kBand,channel));
+
+    return p_detect(*magL1);
+}
+
+/* Runs a block of samples through the Fourier Transform, leaving the
+ * magnitudes for p_detect.  See PingDetect.h
+ */
+void
+pingDetect::p_transform(const adcdata_t *samples, int nSamples, adcmath_t *magL1)
+{
+    spectrum.updateBlock(samples, nSamples, magL1);
+}
+
+/* Updates the min-max algorithm with the magnitudes of one sample.
  * It returns a sum of the channel values indicating if ping was found.
  * 1 -for channel 1, 2 -for ch 2, 4-for ch 3, 8- for chan 4.
  * So, the value is 0 if there were no pings found, 15 if all 4 found.
  */
 int
-pingDetect::p_update(adcdata_t *sample)
+pingDetect::p_detect(const adcmath_t *magL1)
 {
     detected = 0;
-    spectrum.update(sample);
     for(int channel=0; channel<numchan; channel++)
     {
         for (int kBand = 0 ; kBand < nKBands ; kBand ++)
         {
-            adc<16>::DOUBLE_WIDE::SIGNED temp = fixed::magL1(spectrum.getAmplitudeForBinIndex(kBand,channel));
+            adcmath_t temp = magL1[kBand*NCHANNELS + channel];
             if(temp>currmax[channel][kBand])
                 currmax[channel][kBand]=temp; //update the maximum
         }
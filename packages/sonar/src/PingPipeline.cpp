@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/sonar/src/PingPipeline.cpp
+ */
+
+// STD Includes
+#include <cstring>
+
+// Project Includes
+#include "sonar/include/PingPipeline.h"
+
+#include "drivers/bfin_spartan/include/dataset.h"
+
+namespace ram {
+namespace sonar {
+
+PingPipeline::PingPipeline(const int* kBands, const adcdata_t* firTaps,
+                           int firShift_)
+    : pdetect(PD_THRESHOLDS, NCHANNELS, kBands, PING_DETECT_FRAME),
+      fir(0),
+      firShift(firShift_)
+{
+    if (firTaps)
+        fir = new Filter(firTaps);
+}
+
+PingPipeline::~PingPipeline()
+{
+    delete fir;
+}
+
+int PingPipeline::getChunk(adcdata_t** data, int* locations,
+                           struct dataset* dataSet)
+{
+    pdetect.purge();
+    tracker.purge();
+    if (fir)
+        fir->purge();
+
+    for (int start = 0; start < dataSet->size; start += BLOCKSIZE)
+    {
+        int nSamples = dataSet->size - start;
+        if (nSamples > BLOCKSIZE)
+            nSamples = BLOCKSIZE;
+
+        readBlock(dataSet, start, nSamples);
+        if (fir)
+            filterBlock(nSamples);
+        pdetect.p_transform(*samples, nSamples, **magL1);
+
+        // Detection and extraction stay per sample, they can recalibrate
+        // the detector as they go
+        for (int i = 0; i < nSamples; ++i)
+        {
+            int detected = pdetect.p_detect(*magL1[i]);
+            if (tracker.update(start + i, detected, pdetect, data, locations,
+                               dataSet))
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+void PingPipeline::readBlock(struct dataset* dataSet, int start, int nSamples)
+{
+    // BLOCKSIZE divides ALLOC_UNIT_SIZE, so a block never spans two units
+    int unit = start >> ALLOC_UNIT_NUMBITS;
+    int offset = start & ALLOC_UNIT_MASK;
+    for (int channel = 0; channel < NCHANNELS; ++channel)
+    {
+        const signed short* src = dataSet->data[unit][channel] + offset;
+        for (int i = 0; i < nSamples; ++i)
+            samples[i][channel] = src[i];
+    }
+}
+
+void PingPipeline::filterBlock(int nSamples)
+{
+    fir->updateBlock(*samples, nSamples, *filtered);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        for (int channel = 0; channel < NCHANNELS; ++channel)
+        {
+            Filter::ACCUM::SIGNED y = filtered[i][channel] >> firShift;
+            if (y > adc<16>::SIGNED_MAX)
+                y = adc<16>::SIGNED_MAX;
+            else if (y < adc<16>::SIGNED_MIN)
+                y = adc<16>::SIGNED_MIN;
+            samples[i][channel] = (adcdata_t) y;
+        }
+    }
+}
+
+}//sonar
+}//ram
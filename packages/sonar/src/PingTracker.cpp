@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/sonar/src/PingTracker.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+
+// Project Includes
+#include "sonar/include/Sonar.h"
+#include "sonar/include/PingTracker.h"
+
+#include "drivers/bfin_spartan/include/dataset.h"
+
+namespace ram {
+namespace sonar {
+
+pingTracker::pingTracker()
+{
+    purge();
+}
+
+void pingTracker::purge()
+{
+    last_detected=0;
+    for(int channel=0; channel<NCHANNELS; channel++)
+    {
+        last_ping_index[channel]=0;
+        last_value[channel]=0;
+    }
+}
+
+int
+pingTracker::update(int i, int detected, pingDetect& pdetect,
+                    adcdata_t** data, int* locations, struct dataset* dataSet)
+{
+    if(i<DFT_FRAME) //The DFT initializes to 0, so I ignore all points before it
+        return 0;
+    else if(i==DFT_FRAME)
+        pdetect.reset_minmax();
+
+    if(i-last_detected>MAX_PING_SEP)
+    {
+        for(int j=0; j<NCHANNELS; j++)
+            last_value[j]=0;
+        last_detected=0;
+    }
+
+    if(detected !=0)
+    {
+        last_detected=i;
+        for(int channel=0; channel<NCHANNELS; channel++)
+        {
+            if(((detected & (1 << channel)) != 0) && (last_value[channel]!=1))
+            {
+                last_value[channel]=1;
+                last_ping_index[channel]=i;
+            }
+        }
+    }
+
+    for(int channel=0; channel<NCHANNELS; channel++)
+        if(last_value[channel]!=1)
+            return 0;
+
+    for(int channel=0; channel<NCHANNELS; channel++)
+    {
+        if(last_ping_index[channel]<ENV_CALC_FRAME) //too close to the start, skip it
+        {
+            pdetect.reset_minmax();
+            for(int j=0; j<NCHANNELS; j++)
+                last_value[j]=0;
+            return 0;
+        }
+    }
+
+    for(int channel=0; channel<NCHANNELS; channel++)
+    {
+        int start=last_ping_index[channel]-ENV_CALC_FRAME+1+DFT_FRAME/2; //might need to be tweaked
+
+        // A ping near the end runs past it, those samples read as -1 as
+        // they did through getSample
+        int length=std::min(ENV_CALC_FRAME, dataSet->size-start);
+        copySamples(dataSet, channel, start, length, data[channel]);
+        for(int k=length; k<ENV_CALC_FRAME; k++)
+            data[channel][k]=-1;
+
+        locations[channel]=last_ping_index[channel]-ENV_CALC_FRAME+1;
+    }
+    //cout<<"Ping Detected at "<<locations[0]<<endl;
+
+    return 1;
+}
+
+}//sonar
+}//ram
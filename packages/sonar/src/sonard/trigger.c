@@ -48,15 +48,20 @@ int blockTrigger(struct dataset * s, int ch, int highestDftSample)
 
     fprintf(stderr, "Searching region %d to %d\n", searchStart, searchEnd);
 
-    for(i=searchStart; i<searchEnd; i+= BLOCKSIZE)
+    /* Copy out the region once, instead of range checking every sample */
+    signed short region[BACKTRACK];
+    if(copySamples(s, ch, searchStart, BACKTRACK, region) != 0)
+        return -1;
+
+    for(i=0; i<BACKTRACK; i+= BLOCKSIZE)
     {
         lastBlockMax = blockMax;
-        blockMax = sAbs(getSample(s, ch, i+j));
+        blockMax = sAbs(region[i]);
 
         /* Find maximum of this block */
         for(j=0; j<BLOCKSIZE; j++)
         {
-            signed short curSample = sAbs(getSample(s, ch, i+j));
+            signed short curSample = sAbs(region[i+j]);
             if(sAbs(curSample) > blockMax)
                 blockMax = curSample;
         }
@@ -66,7 +71,7 @@ int blockTrigger(struct dataset * s, int ch, int highestDftSample)
         if(blockJump > highestJump)
         {
             highestJump = blockJump;
-            highestJumpIndex = i;
+            highestJumpIndex = searchStart + i;
             triggeredBlock = curBlock;
         }
         curBlock++;
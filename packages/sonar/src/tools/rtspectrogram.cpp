@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 
@@ -18,6 +19,7 @@
 #include "fixed/fixed.h"
 
 #include "drivers/bfin_spartan/include/dataset.h"
+#include "drivers/bfin_spartan/include/mappeddataset.h"
 #include "drivers/bfin_spartan/include/spartan.h"
 
 using namespace ram::sonar;
@@ -32,19 +34,6 @@ static const int datasetSize = 0xA0000;
 
 typedef adc<16> myadc;
 
-int grabSamples(struct dataset* data, myadc::SIGNED* samples, int i)
-{
-    for (int channel = 0 ; channel < NCHANNELS ; channel ++)
-    {
-        myadc::SIGNED result = getSample(data, channel, i);
-        if (result == -1)
-            return false;
-        else
-            samples[channel] = result;
-    }
-    return true;
-}
-
 int main(int argc, char *argv[])
 {
     bool do_loop = false;
@@ -73,16 +62,26 @@ int main(int argc, char *argv[])
         myadc::QUADRUPLE_WIDE::SIGNED hist[NCHANNELS][numRows];
         bzero(*hist, sizeof(**hist) * NCHANNELS * numRows);
         
-        int sampleCount = 0;
         myadc::SIGNED sample[NCHANNELS];
-        while ((do_loop || skip * sampleCount < datasetSize - 1) && grabSamples(data, sample, skip * sampleCount))
+        struct sampleSpan spans[NCHANNELS];
+        const int end = std::min(data->size, datasetSize);
+        //	Every skip'th sample, read a unit at a time
+        for (int start = 0 ; start < end ; start += spans[0].length)
         {
-            ++sampleCount;
-            //	Update spectrogram
-            spectrum.update(sample);
             for (int channel = 0 ; channel < NCHANNELS ; channel ++)
-                for (int i = 0 ; i < numRows ; i ++)
-                    hist[channel][i] += fixed::magL1(spectrum.getAmplitudeForBinIndex(i, channel));
+                datasetUnitSpan(data, channel, start, end - start, &spans[channel]);
+            
+            for (int k = (skip - start % skip) % skip ; k < spans[0].length ; k += skip)
+            {
+                for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+                    sample[channel] = spanSample(&spans[channel], k);
+                
+                //	Update spectrogram
+                spectrum.update(sample);
+                for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+                    for (int i = 0 ; i < numRows ; i ++)
+                        hist[channel][i] += fixed::magL1(spectrum.getAmplitudeForBinIndex(i, channel));
+            }
         }
         
         myadc::QUADRUPLE_WIDE::SIGNED histMax = 1;
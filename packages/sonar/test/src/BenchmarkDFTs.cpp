@@ -0,0 +1,153 @@
+/**
+ * BenchmarkDFTs.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ * Reports the throughput, in samples (one value per channel) per second, of
+ * the sliding DFT and spectrum classes, and of the SIMD sliding kernels
+ * against the scalar reference kernels.
+ *
+ * Usage: benchmarkDFTs [number of samples]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "Sonar.h"
+#include "dft/SlidingKernels.h"
+#include "dft/TiledSlidingDFT.h"
+#include "dft/FastSlidingDFT.h"
+#include "spectrum/SDFTSpectrum.h"
+#include "spectrum/SparseSDFTSpectrum.h"
+
+using namespace ram::sonar;
+
+typedef adc<16> myadc;
+
+static double now()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void report(const char* name, int nchannels, int nSamples, double dt)
+{
+	printf("%-40s %2d ch  %12.0f samples/sec\n", name, nchannels,
+	       nSamples / dt);
+}
+
+static myadc::SIGNED* makeInput(int nchannels, int nSamples)
+{
+	myadc::SIGNED* in = new myadc::SIGNED[nchannels * nSamples];
+	srand(42);
+	for (int i = 0 ; i < nchannels * nSamples ; i ++)
+		in[i] = (myadc::SIGNED)((2.0 * rand() / RAND_MAX - 1) *
+		                        adc<12>::SIGNED_MAX);
+	return in;
+}
+
+/** Benchmarks anything with an update(const SIGNED*) member */
+template<typename T, int nchannels>
+void benchUpdate(const char* name, T& dft, int nSamples)
+{
+	myadc::SIGNED* in = makeInput(nchannels, nSamples);
+	double start = now();
+	for (int i = 0 ; i < nSamples ; i ++)
+		dft.update(&in[i * nchannels]);
+	report(name, nchannels, nSamples, now() - start);
+	delete [] in;
+}
+
+/** Rotates nBands bins per sample with the given kernel implementation */
+template<typename K, int nchannels, int nBands>
+void benchRotate(const char* name, int nSamples)
+{
+	std::complex<myadc::DOUBLE_WIDE::SIGNED> fourier[nBands][nchannels];
+	myadc::DOUBLE_WIDE::SIGNED diff[nchannels];
+	myadc::SIGNED* in = makeInput(nchannels, nSamples);
+	for (int kIdx = 0 ; kIdx < nBands ; kIdx ++)
+		for (int channel = 0 ; channel < nchannels ; channel ++)
+			fourier[kIdx][channel] = 0;
+
+	double start = now();
+	for (int i = 0 ; i < nSamples ; i ++)
+	{
+		for (int channel = 0 ; channel < nchannels ; channel ++)
+			diff[channel] = in[i * nchannels + channel];
+		for (int kIdx = 0 ; kIdx < nBands ; kIdx ++)
+			K::rotate(fourier[kIdx], diff, 32000, 5000,
+			          myadc::BITDEPTH - 1, nchannels);
+	}
+	report(name, nchannels, nSamples, now() - start);
+
+	//	Keep the compiler from discarding the work
+	if (fourier[0][0].real() == 12345)
+		printf("\n");
+	delete [] in;
+}
+
+int main(int argc, char* argv[])
+{
+	int nSamples = 1 << 20;
+	if (argc > 1)
+		nSamples = atoi(argv[1]);
+
+	typedef dft::SlidingKernels<myadc::SIGNED, myadc::DOUBLE_WIDE::SIGNED,
+	                            myadc::QUADRUPLE_WIDE::SIGNED> Kernels;
+	typedef dft::ScalarSlidingKernels<myadc::SIGNED,
+	                                  myadc::DOUBLE_WIDE::SIGNED,
+	                                  myadc::QUADRUPLE_WIDE::SIGNED> Scalar;
+
+#if defined(__SSE4_1__)
+	printf("Kernels: SSE2 tiled, SSE4.1 rotate\n");
+#elif defined(__SSE2__)
+	printf("Kernels: SSE2 tiled, scalar rotate\n");
+#else
+	printf("Kernels: scalar\n");
+#endif
+	printf("%d samples per run\n\n", nSamples);
+
+	benchRotate<Scalar, NCHANNELS, nKBands>("rotate scalar, 2 bands", nSamples);
+	benchRotate<Kernels, NCHANNELS, nKBands>("rotate SIMD, 2 bands", nSamples);
+	benchRotate<Scalar, NCHANNELS, 8>("rotate scalar, 8 bands", nSamples);
+	benchRotate<Kernels, NCHANNELS, 8>("rotate SIMD, 8 bands", nSamples);
+	printf("\n");
+
+	{
+		TiledSlidingDFT<myadc, NCHANNELS, 4, DFT_FRAME> dft;
+		benchUpdate<SlidingDFT<myadc>, NCHANNELS>(
+			"TiledSlidingDFT N=512", dft, nSamples);
+	}
+	{
+		FastSlidingDFT<myadc, NCHANNELS, 26, DFT_FRAME> dft;
+		benchUpdate<SlidingDFT<myadc>, NCHANNELS>(
+			"FastSlidingDFT N=512", dft, nSamples);
+	}
+	{
+		SparseSDFTSpectrum<myadc, DFT_FRAME, NCHANNELS, nKBands>
+			spectrum(kBands);
+		benchUpdate<SparseSDFTSpectrum<myadc, DFT_FRAME, NCHANNELS, nKBands>,
+			NCHANNELS>("SparseSDFTSpectrum N=512, 2 bands", spectrum,
+			           nSamples);
+	}
+	{
+		static const int bands[8] = {20, 22, 24, 26, 28, 30, 32, 34};
+		SparseSDFTSpectrum<myadc, DFT_FRAME, NCHANNELS, 8> spectrum(bands);
+		benchUpdate<SparseSDFTSpectrum<myadc, DFT_FRAME, NCHANNELS, 8>,
+			NCHANNELS>("SparseSDFTSpectrum N=512, 8 bands", spectrum,
+			           nSamples);
+	}
+	{
+		//	Every bin is computed, so use a smaller window
+		SDFTSpectrum<myadc, 64, NCHANNELS>* spectrum =
+			new SDFTSpectrum<myadc, 64, NCHANNELS>();
+		benchUpdate<SDFTSpectrum<myadc, 64, NCHANNELS>, NCHANNELS>(
+			"SDFTSpectrum N=64", *spectrum, nSamples / 16);
+		delete spectrum;
+	}
+
+	return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * BenchmarkDataset.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ * Compares the ways of getting at the samples of a capture: loading it into
+ * a dataset and reading it through getSample, mapping it and iterating
+ * interleaved spans, streaming it through a datasetReader, and mapping a
+ * planar copy of it.  Each prints the time to open the capture, the sample
+ * throughput of a pass over every channel, and a checksum which must agree
+ * between them.
+ *
+ * Usage: benchmarkDataset [capture file] [planar file]
+ *
+ * Without a capture a synthetic one of SYNTHETIC_MB is written to /tmp, and
+ * removed afterwards.  The planar copy goes next to the capture unless
+ * given.  Captures too big for a dataset, like the synthetic one, skip the
+ * getSample passes, so give a small capture to compare against those.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include <string>
+
+#include "drivers/bfin_spartan/include/dataset.h"
+#include "drivers/bfin_spartan/include/mappeddataset.h"
+
+static const int SYNTHETIC_MB = 2048;
+static const int READER_BLOCK = 1 << 16;
+
+static double now()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void report(const char* name, double openTime, double passTime,
+                   long long samples, long long checksum)
+{
+	printf("%-28s open %8.3f s  pass %8.3f s  %12.0f samples/sec  "
+	       "checksum %lld\n", name, openTime, passTime,
+	       samples / passTime, checksum);
+}
+
+/** Noise with a tone on each channel, written a block at a time */
+static bool writeSynthetic(const char* filename, long long frames)
+{
+	FILE* f = fopen(filename, "wb");
+	if (f == NULL)
+		return false;
+
+	static const int BLOCK = 1 << 16;
+	unsigned char* buffer = new unsigned char[BLOCK * DATASET_FRAME_SIZE];
+	srand(42);
+	for (long long start = 0 ; start < frames ; start += BLOCK)
+	{
+		int length = (frames - start < BLOCK) ? (int)(frames - start) : BLOCK;
+		unsigned char* out = buffer;
+		for (int i = 0 ; i < length ; i ++)
+		{
+			for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+			{
+				int value = (rand() % 100) - 50 +
+					(int) (1000 * sin((start + i) * 0.05 + ch));
+				*out++ = value & 0xFF;
+				*out++ = (value >> 8) & 0xFF;
+			}
+		}
+		fwrite(buffer, DATASET_FRAME_SIZE, length, f);
+	}
+	delete [] buffer;
+	fclose(f);
+	return true;
+}
+
+/** What loadDataset used to do, two fgetc calls and a putSample a sample */
+static struct dataset* loadPerSample(const char* filename, long long frames)
+{
+	struct dataset* s = createDataset((int) frames);
+	FILE* f = fopen(filename, "rb");
+	if (s == NULL || f == NULL)
+		return s;
+	for (int i = 0 ; i < s->size ; i ++)
+		for (int j = 0 ; j < 4 ; j ++)
+			putSample(s, j, i, (signed short) (fgetc(f) | (fgetc(f) << 8)));
+	fclose(f);
+	return s;
+}
+
+static long long sumDataset(struct dataset* s)
+{
+	long long sum = 0;
+	for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+		for (int i = 0 ; i < s->size ; i ++)
+			sum += getSample(s, ch, i);
+	return sum;
+}
+
+static long long sumMapped(struct mappedDataset* s)
+{
+	long long sum = 0;
+	for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+	{
+		// Spans are limited to an int of samples
+		for (long long start = 0 ; start < s->size ; start += READER_BLOCK)
+		{
+			int length = (s->size - start < READER_BLOCK) ?
+				(int) (s->size - start) : READER_BLOCK;
+			struct sampleSpan span;
+			datasetSpan(s, ch, start, length, &span);
+			for (int i = 0 ; i < span.length ; i ++)
+				sum += spanSample(&span, i);
+		}
+	}
+	return sum;
+}
+
+static void benchLoaded(const char* capture, long long frames)
+{
+	if (frames > (long long) MAX_SEGMENTS * ALLOC_UNIT_SIZE)
+	{
+		printf("%-28s skipped, capture does not fit a dataset\n",
+		       "loadDataset");
+		return;
+	}
+
+	double start = now();
+	struct dataset* s = loadPerSample(capture, frames);
+	double openTime = now() - start;
+	start = now();
+	long long sum = sumDataset(s);
+	report("fgetc + getSample", openTime, now() - start, frames * 4, sum);
+	destroyDataset(s);
+
+	start = now();
+	s = loadDataset(capture);
+	openTime = now() - start;
+	start = now();
+	sum = sumDataset(s);
+	report("loadDataset + getSample", openTime, now() - start, frames * 4,
+	       sum);
+	destroyDataset(s);
+}
+
+static void benchMapped(const char* name, const char* filename)
+{
+	double start = now();
+	struct mappedDataset* s = mapDataset(filename);
+	double openTime = now() - start;
+	if (s == NULL)
+		return;
+
+	// The first pass faults the pages in, the second shows the span loop
+	start = now();
+	long long sum = sumMapped(s);
+	double firstPass = now() - start;
+	start = now();
+	sum = sumMapped(s);
+	report(name, openTime, now() - start, s->size * 4, sum);
+	printf("%-28s first pass %8.3f s, faulting the capture in\n", "",
+	       firstPass);
+	unmapDataset(s);
+}
+
+static void benchReader(const char* capture)
+{
+	double start = now();
+	struct datasetReader* r = openDatasetReader(capture, READER_BLOCK);
+	double openTime = now() - start;
+	if (r == NULL)
+		return;
+
+	// Channels are summed a block at a time, so the checksum matches
+	long long sum = 0;
+	struct sampleSpan spans[DATASET_CHANNELS];
+	start = now();
+	while (readDatasetBlock(r, spans) > 0)
+	{
+		for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+			for (int i = 0 ; i < spans[ch].length ; i ++)
+				sum += spans[ch].data[i];
+	}
+	report("datasetReader", openTime, now() - start, r->size * 4, sum);
+	closeDatasetReader(r);
+}
+
+int main(int argc, char* argv[])
+{
+	std::string capture("/tmp/benchmarkDataset.bin");
+	bool synthetic = (argc < 2);
+	if (!synthetic)
+	{
+		capture = argv[1];
+	}
+	else
+	{
+		long long frames = (long long) SYNTHETIC_MB * 1024 * 1024 /
+			DATASET_FRAME_SIZE;
+		printf("Writing a %d MB synthetic capture to %s\n", SYNTHETIC_MB,
+		       capture.c_str());
+		if (!writeSynthetic(capture.c_str(), frames))
+			return 1;
+	}
+	std::string planar = (argc > 2) ? argv[2] : capture + ".planar";
+
+	struct datasetReader* r = openDatasetReader(capture.c_str(), 1);
+	if (r == NULL)
+		return 1;
+	long long frames = r->size;
+	closeDatasetReader(r);
+	printf("%lld samples, %d channels, %.1f MB\n\n", frames,
+	       DATASET_CHANNELS, frames * DATASET_FRAME_SIZE / 1048576.0);
+
+	benchLoaded(capture.c_str(), frames);
+	benchMapped("mapDataset interleaved", capture.c_str());
+	benchReader(capture.c_str());
+
+	double start = now();
+	if (planarizeDataset(capture.c_str(), planar.c_str()) == 0)
+	{
+		printf("%-28s %8.3f s\n", "planarizeDataset", now() - start);
+		benchMapped("mapDataset planar", planar.c_str());
+	}
+
+	if (argc < 3)
+		unlink(planar.c_str());
+	if (synthetic)
+		unlink(capture.c_str());
+	return 0;
+}
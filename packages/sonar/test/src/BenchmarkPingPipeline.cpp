@@ -0,0 +1,128 @@
+/**
+ * BenchmarkPingPipeline.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ * Compares the per-sample ping chunk extraction (getPingChunk) with the
+ * block based PingPipeline on the same data, with and without the band-pass
+ * filter stage.
+ *
+ * Usage: benchmarkPingPipeline [dataset file]
+ *
+ * Without a dataset file a synthetic ping is used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "sonar/include/Sonar.h"
+#include "sonar/include/GetPingChunk.h"
+#include "sonar/include/PingPipeline.h"
+
+#include "drivers/bfin_spartan/include/dataset.h"
+
+using namespace ram::sonar;
+
+static const int TRIALS = 5;
+
+static double now()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/** Noise with a short burst at frequencyOfInterest, delayed per channel */
+static struct dataset* makeDataset()
+{
+	static const int pingStart = LARGE_DATASET / 2;
+	static const int pingLength = SAMPRATE / 250;
+	static const int delays[NCHANNELS] = {0, 40, 75, 110};
+
+	struct dataset* dataSet = createDataset(LARGE_DATASET);
+	srand(42);
+	for (int i = 0 ; i < dataSet->size ; i ++)
+	{
+		for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+		{
+			double value = 50.0 * rand() / RAND_MAX;
+			int n = i - pingStart - delays[channel];
+			if (n >= 0 && n < pingLength)
+				value += 2000 * sin(2 * M_PI * frequencyOfInterest * n / SAMPRATE);
+			putSample(dataSet, channel, i, (signed short) value);
+		}
+	}
+	return dataSet;
+}
+
+/** Windowed sinc band-pass around frequencyOfInterest, Q15 taps */
+static void makeBandPass(adcdata_t* taps, int order)
+{
+	double bandwidth = 4000.0 / SAMPRATE;
+	double center = frequencyOfInterest / SAMPRATE;
+	for (int n = 0 ; n <= order ; n ++)
+	{
+		double m = n - order / 2.0;
+		double sinc = (m == 0) ? 2 * bandwidth :
+			sin(2 * M_PI * bandwidth * m) / (M_PI * m);
+		double window = 0.54 - 0.46 * cos(2 * M_PI * n / order);
+		taps[n] = (adcdata_t) (32767 * 2 * sinc * window *
+		                       cos(2 * M_PI * center * m));
+	}
+}
+
+template<typename T>
+static void bench(const char* name, T& detector, struct dataset* dataSet,
+                  adcdata_t** data, int* locations)
+{
+	int found = 0;
+	double start = now();
+	for (int trial = 0 ; trial < TRIALS ; trial ++)
+		found = detector.getChunk(data, locations, dataSet);
+	double dt = (now() - start) / TRIALS;
+
+	printf("%-30s %8.3f s  %12.0f samples/sec  ", name, dt,
+	       dataSet->size / dt);
+	if (found == 1)
+		printf("ping at %d %d %d %d\n", locations[0], locations[1],
+		       locations[2], locations[3]);
+	else
+		printf("no ping\n");
+}
+
+int main(int argc, char* argv[])
+{
+	struct dataset* dataSet;
+	if (argc > 1)
+		dataSet = loadDataset(argv[1]);
+	else
+		dataSet = makeDataset();
+	if (dataSet == NULL)
+		return 1;
+
+	adcdata_t* data[NCHANNELS];
+	int locations[NCHANNELS];
+	for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+		data[channel] = new adcdata_t[ENV_CALC_FRAME];
+
+	printf("%d samples, %d channels, block size %d\n\n", dataSet->size,
+	       NCHANNELS, PingPipeline::BLOCKSIZE);
+
+	getPingChunk perSample(kBands);
+	bench("getPingChunk (per sample)", perSample, dataSet, data, locations);
+
+	PingPipeline blocked(kBands);
+	bench("PingPipeline", blocked, dataSet, data, locations);
+
+	adcdata_t taps[PingPipeline::FIR_ORDER + 1];
+	makeBandPass(taps, PingPipeline::FIR_ORDER);
+	PingPipeline filtered(kBands, taps);
+	bench("PingPipeline with FIR", filtered, dataSet, data, locations);
+
+	for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+		delete [] data[channel];
+	destroyDataset(dataSet);
+	return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * TestBlockFiniteInputResponseFilter.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ */
+
+#include <UnitTest++/UnitTest++.h>
+#include <cstdlib>
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "filter/FiniteInputResponseFilter.h"
+#include "filter/BlockFiniteInputResponseFilter.h"
+#include "adctypes.h"
+
+using namespace ram::sonar;
+
+SUITE(TestBlockFiniteInputResponseFilter)
+{
+    typedef adc<16> myadc;
+    static const int NCHANNELS = 4;
+    //  Not a multiple of any internal block size
+    static const int NSAMPLES = 1000;
+
+    myadc::SIGNED randSample()
+    {
+        return (myadc::SIGNED)((2.0 * std::rand() / RAND_MAX - 1) * myadc::SIGNED_MAX);
+    }
+
+    /**
+     * Runs the per sample filter and the block engine over the same input,
+     * in uneven block sizes, and checks that every output is within tolerance.
+     */
+    template<typename Engine, int ORDER>
+    void checkAgainstDirectForm(const myadc::SIGNED* taps, double tolerance)
+    {
+        typedef filter::FiniteInputResponseFilter<myadc, ORDER, NCHANNELS> Filter;
+        Filter fir(taps);
+        Engine* blockFir = new Engine(taps);
+
+        myadc::SIGNED* samples = new myadc::SIGNED[NSAMPLES * NCHANNELS];
+        typename Filter::ACCUM::SIGNED* out =
+            new typename Filter::ACCUM::SIGNED[NSAMPLES * NCHANNELS];
+        for (int i = 0 ; i < NSAMPLES * NCHANNELS ; i ++)
+            samples[i] = randSample();
+
+        static const int blocks[] = {1, 7, 300, 64, 628};
+        for (int b = 0, i = 0 ; i < NSAMPLES ; i += blocks[b ++])
+            blockFir->updateBlock(samples + i * NCHANNELS, blocks[b],
+                                  out + i * NCHANNELS);
+
+        for (int i = 0 ; i < NSAMPLES ; i ++)
+        {
+            fir.update(samples + i * NCHANNELS);
+            for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+                CHECK_CLOSE((double)fir[channel],
+                            (double)out[i * NCHANNELS + channel], tolerance);
+        }
+        for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+            CHECK_EQUAL(out[(NSAMPLES - 1) * NCHANNELS + channel],
+                        (*blockFir)[channel]);
+
+        delete [] samples;
+        delete [] out;
+        delete blockFir;
+    }
+
+    TEST(DirectEngineMatchesDirectForm)
+    {
+        static const int ORDER = 10;
+        myadc::SIGNED taps[ORDER+1];
+        for (int i = 0 ; i <= ORDER ; i ++)
+            taps[i] = randSample();
+        checkAgainstDirectForm<
+            filter::DirectFIREngine<myadc, ORDER, NCHANNELS>, ORDER>(taps, 0);
+    }
+
+    TEST(DirectEngineMatchesDirectFormMostNegativeTap)
+    {
+        static const int ORDER = 12;
+        myadc::SIGNED taps[ORDER+1];
+        for (int i = 0 ; i <= ORDER ; i ++)
+            taps[i] = myadc::SIGNED_MIN;
+        checkAgainstDirectForm<
+            filter::DirectFIREngine<myadc, ORDER, NCHANNELS>, ORDER>(taps, 0);
+    }
+
+#ifndef __BFIN
+    TEST(OverlapSaveEngineMatchesDirectForm)
+    {
+        static const int ORDER = 127;
+        myadc::SIGNED taps[ORDER+1];
+        for (int i = 0 ; i <= ORDER ; i ++)
+            taps[i] = randSample();
+        //  Outputs are up to 2^37, so allow for double precision FFT error
+        checkAgainstDirectForm<
+            filter::OverlapSaveFIREngine<myadc, ORDER, NCHANNELS>, ORDER>(taps, 4);
+    }
+#endif
+
+    TEST(SelectsEngineByOrder)
+    {
+        CHECK((boost::is_base_of<
+            filter::DirectFIREngine<myadc, 31, NCHANNELS>,
+            filter::BlockFiniteInputResponseFilter<myadc, 31, NCHANNELS> >::value));
+#ifndef __BFIN
+        CHECK((boost::is_base_of<
+            filter::OverlapSaveFIREngine<myadc, 127, NCHANNELS>,
+            filter::BlockFiniteInputResponseFilter<myadc, 127, NCHANNELS> >::value));
+#endif
+    }
+
+}
@@ -147,4 +147,4 @@ TEST_UTILITY(CheckAgainstFFTW, (const adcdata_t *adcdataSamples, int countFrames
 }
 
 #include "TestTiledSlidingDFT.inl"
-//	#include "TestFastSlidingDFT.inl"
+#include "TestFastSlidingDFT.inl"
@@ -1,5 +1,5 @@
 /*
- *  TestTiledSlidingDFT.cpp
+ *  TestFastSlidingDFT.inl
  *  sonarController
  *
  *  Created by Leo Singer on 1/16/08.
@@ -8,13 +8,19 @@
  */
 
 #include "dft/FastSlidingDFT.h"
+#include "spectrum/SparseSDFTSpectrum.h"
 
 struct FastSlidingDFTTestFixture {};
 
 
-TEST_FIXTURE(FastSlidingDFTTestFixture, CompareDFTRandomInput)
+//	FastSlidingDFT runs the same fixed point recursion as SparseSDFTSpectrum,
+//	so the two must agree exactly.
+TEST_FIXTURE(FastSlidingDFTTestFixture, MatchesSparseSDFTSpectrum)
 {
-	FastSlidingDFT<3, 5, 20> myDFT;
+	static const int nchannels = 3, k = 5, N = 20;
+	FastSlidingDFT<adc<10>, nchannels, k, N> myDFT;
+	const int kBand[1] = {k};
+	SparseSDFTSpectrum<adc<10>, N, nchannels, 1> spectrum(kBand);
 	int seed = 42, countFrames = 200;
 	int countInputData = myDFT.getCountChannels() * countFrames;
 	
@@ -22,23 +28,16 @@ TEST_FIXTURE(FastSlidingDFTTestFixture, CompareDFTRandomInput)
 	
 	rand_adcdata_vector(in, countInputData, seed);
 	
-	TEST_UTILITY_FUNC(CheckAgainstFFTW)(in, countFrames, myDFT, false);
-	
-	delete [] in;
-}
-
-
-TEST_FIXTURE(FastSlidingDFTTestFixture, CompareDFTCosineInput)
-{
-	FastSlidingDFT<3, 5, 20> myDFT;
-	int countFrames = 200;
-	int countInputData = myDFT.getCountChannels() * countFrames;
-	
-	adcdata_t *in = new adcdata_t[countInputData];
-	
-	cos_adcdata_vector(in, myDFT.getCountChannels(), countFrames/8, countFrames);
-	
-	TEST_UTILITY_FUNC(CheckAgainstFFTW)(in, countFrames, myDFT, false);
+	for (int i = 0 ; i < countFrames ; i ++)
+	{
+		myDFT.update(&in[i * nchannels]);
+		spectrum.update(&in[i * nchannels]);
+		for (int channel = 0 ; channel < nchannels ; channel ++)
+		{
+			CHECK_EQUAL(spectrum.getAmplitude(k, channel).real(), myDFT.getReal(channel));
+			CHECK_EQUAL(spectrum.getAmplitude(k, channel).imag(), myDFT.getImag(channel));
+		}
+	}
 	
 	delete [] in;
 }
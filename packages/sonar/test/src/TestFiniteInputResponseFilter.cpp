@@ -104,5 +104,32 @@ SUITE(TestFiniteInputResponseFilter)
         }
     }
     
+    TEST(BlockUpdateMatchesPerSample)
+    {
+        typedef adc<16> myadc;
+        static const int NCHANNELS = 4;
+        static const int ORDER = 10;
+        static const int NSAMPLES = 100;
+        typedef filter::FiniteInputResponseFilter<myadc, ORDER, NCHANNELS> Filter;
+        myadc::SIGNED taps[ORDER+1];
+        for (int i = 0 ; i <= ORDER ; i ++)
+            taps[i] = (double)std::rand() / RAND_MAX * myadc::SIGNED_MAX;
+        Filter fir(taps);
+        Filter blockFir(taps);
+        myadc::SIGNED samples[NSAMPLES][NCHANNELS];
+        for (int i = 0 ; i < NSAMPLES ; i ++)
+            for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+                samples[i][channel] = (double)std::rand() / RAND_MAX * myadc::SIGNED_MAX;
+        
+        Filter::ACCUM::SIGNED out[NSAMPLES][NCHANNELS];
+        blockFir.updateBlock(*samples, NSAMPLES, *out);
+        for (int i = 0 ; i < NSAMPLES ; i ++)
+        {
+            fir.update(samples[i]);
+            for (int channel = 0 ; channel < NCHANNELS ; channel ++)
+                CHECK_EQUAL(fir[channel], out[i][channel]);
+        }
+    }
+    
 }
 
@@ -0,0 +1,190 @@
+/**
+ * TestMappedDataset.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ */
+
+#include <UnitTest++/UnitTest++.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "drivers/bfin_spartan/include/dataset.h"
+#include "drivers/bfin_spartan/include/mappeddataset.h"
+
+using namespace std;
+
+SUITE(TestMappedDataset)
+{
+	//	Spans a few allocation units, and ends part way into one
+	static const int nSamples = 3 * ALLOC_UNIT_SIZE + 100;
+
+	static signed short expectedSample(int ch, int i)
+	{
+		return (signed short) ((i * 7 + ch * 1000) % 65536 - 32768);
+	}
+
+	static string tempFile()
+	{
+		char name[] = "/tmp/TestMappedDatasetXXXXXX";
+		int fd = mkstemp(name);
+		close(fd);
+		return name;
+	}
+
+	static void writeFile(const string& name, const vector<unsigned char>& bytes)
+	{
+		FILE* f = fopen(name.c_str(), "wb");
+		fwrite(&bytes[0], 1, bytes.size(), f);
+		fclose(f);
+	}
+
+	static vector<unsigned char> planarHeader(uint64_t count)
+	{
+		vector<unsigned char> header(PLANAR_DATASET_MAGIC,
+		                             PLANAR_DATASET_MAGIC + 8);
+		for (int i = 0 ; i < 8 ; i ++)
+			header.push_back((unsigned char) (count >> (8 * i)));
+		return header;
+	}
+
+	struct CaptureFixture
+	{
+		CaptureFixture() : capture(tempFile()), planar(tempFile())
+		{
+			//	Little endian and interleaved, as the sonar board writes
+			vector<unsigned char> bytes;
+			for (int i = 0 ; i < nSamples ; i ++)
+			{
+				for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+				{
+					unsigned short value = expectedSample(ch, i);
+					bytes.push_back(value & 0xFF);
+					bytes.push_back(value >> 8);
+				}
+			}
+			writeFile(capture, bytes);
+			loaded = loadDataset(capture.c_str());
+		}
+
+		~CaptureFixture()
+		{
+			destroyDataset(loaded);
+			unlink(capture.c_str());
+			unlink(planar.c_str());
+		}
+
+		//	Every span of the dataset agrees with getSample
+		void checkMapped(struct mappedDataset* mapped)
+		{
+			CHECK(mapped);
+			if (!mapped)
+				return;
+			CHECK_EQUAL(nSamples, mapped->size);
+
+			for (int ch = 0 ; ch < DATASET_CHANNELS ; ch ++)
+			{
+				struct sampleSpan span;
+				CHECK_EQUAL(0, datasetSpan(mapped, ch, 0, nSamples, &span));
+				int wrong = 0;
+				for (int i = 0 ; i < nSamples ; i ++)
+					if (spanSample(&span, i) != getSample(loaded, ch, i))
+						wrong ++;
+				CHECK_EQUAL(0, wrong);
+			}
+		}
+
+		string capture;
+		string planar;
+		struct dataset* loaded;
+	};
+
+	TEST_FIXTURE(CaptureFixture, Loaded)
+	{
+		CHECK(loaded);
+		CHECK_EQUAL(nSamples, loaded->size);
+		CHECK_EQUAL(expectedSample(2, 1234), getSample(loaded, 2, 1234));
+	}
+
+	TEST_FIXTURE(CaptureFixture, RawMatchesGetSample)
+	{
+		struct mappedDataset* mapped = mapDataset(capture.c_str());
+		CHECK(mapped && !mapped->planar);
+		checkMapped(mapped);
+		unmapDataset(mapped);
+	}
+
+	TEST_FIXTURE(CaptureFixture, PlanarMatchesGetSample)
+	{
+		CHECK_EQUAL(0, planarizeDataset(capture.c_str(), planar.c_str()));
+		struct mappedDataset* mapped = mapDataset(planar.c_str());
+		CHECK(mapped && mapped->planar);
+		checkMapped(mapped);
+		unmapDataset(mapped);
+	}
+
+	TEST_FIXTURE(CaptureFixture, SpanOutOfRange)
+	{
+		struct mappedDataset* mapped = mapDataset(capture.c_str());
+		struct sampleSpan span;
+		CHECK_EQUAL(-1, datasetSpan(mapped, 0, 1, nSamples, &span));
+		CHECK_EQUAL(-1, datasetSpan(mapped, 4, 0, 1, &span));
+		CHECK_EQUAL(-1, datasetSpan(mapped, 0, -1, 1, &span));
+		unmapDataset(mapped);
+	}
+
+	TEST_FIXTURE(CaptureFixture, UnitSpansMatchGetSample)
+	{
+		//	Stops at the end of each unit, and of the dataset
+		struct sampleSpan span;
+		CHECK_EQUAL(ALLOC_UNIT_SIZE - 10,
+		            datasetUnitSpan(loaded, 1, 10, nSamples - 10, &span));
+		CHECK_EQUAL(100,
+		            datasetUnitSpan(loaded, 1, 3 * ALLOC_UNIT_SIZE, 100, &span));
+		CHECK_EQUAL(-1,
+		            datasetUnitSpan(loaded, 1, 3 * ALLOC_UNIT_SIZE, 101, &span));
+
+		//	Crosses two unit boundaries
+		int start = ALLOC_UNIT_SIZE - 5;
+		int length = ALLOC_UNIT_SIZE + 10;
+		vector<signed short> copied(length);
+		CHECK_EQUAL(0, copySamples(loaded, 3, start, length, &copied[0]));
+		int wrong = 0;
+		for (int i = 0 ; i < length ; i ++)
+			if (copied[i] != getSample(loaded, 3, start + i))
+				wrong ++;
+		CHECK_EQUAL(0, wrong);
+		CHECK_EQUAL(-1, copySamples(loaded, 3, nSamples - 5, 6, &copied[0]));
+	}
+
+	TEST_FIXTURE(CaptureFixture, BadPlanarHeader)
+	{
+		vector<unsigned char> bytes(planarHeader(10));
+		bytes.resize(bytes.size() + 10 * DATASET_FRAME_SIZE);
+		writeFile(planar, bytes);
+		struct mappedDataset* mapped = mapDataset(planar.c_str());
+		CHECK(mapped && mapped->planar);
+		unmapDataset(mapped);
+
+		//	One sample more than the file holds
+		bytes = planarHeader(11);
+		bytes.resize(bytes.size() + 10 * DATASET_FRAME_SIZE);
+		writeFile(planar, bytes);
+		CHECK(!mapDataset(planar.c_str()));
+
+		//	Counts which overflow when multiplied out to a size
+		bytes = planarHeader(((uint64_t) 1 << 61) + 1);
+		bytes.resize(bytes.size() + 10 * DATASET_FRAME_SIZE);
+		writeFile(planar, bytes);
+		CHECK(!mapDataset(planar.c_str()));
+
+		bytes = planarHeader((uint64_t) -1);
+		bytes.resize(bytes.size() + 10 * DATASET_FRAME_SIZE);
+		writeFile(planar, bytes);
+		CHECK(!mapDataset(planar.c_str()));
+	}
+}
@@ -0,0 +1,86 @@
+/**
+ * TestSlidingKernels.cpp
+ *
+ * @author Copyright 2011 Robotics@Maryland. All rights reserved.
+ *
+ */
+
+#include <UnitTest++/UnitTest++.h>
+#include <cstdlib>
+#include <complex>
+#include <cmath>
+
+#include "Sonar.h"
+#include "dft/SlidingKernels.h"
+
+using namespace ram::sonar;
+using namespace std;
+
+SUITE(TestSlidingKernels)
+{
+	typedef adc<16> myadc;
+	typedef dft::SlidingKernels<myadc::SIGNED, myadc::DOUBLE_WIDE::SIGNED,
+	                            myadc::QUADRUPLE_WIDE::SIGNED> Kernels;
+	typedef dft::ScalarSlidingKernels<myadc::SIGNED,
+	                                  myadc::DOUBLE_WIDE::SIGNED,
+	                                  myadc::QUADRUPLE_WIDE::SIGNED> Scalar;
+
+	//	Odd channel count so both the vector and remainder paths are used
+	static const int nChannels = 7;
+
+	myadc::SIGNED randSample()
+	{
+		return (myadc::SIGNED)((2.0 * rand() / RAND_MAX - 1) * myadc::SIGNED_MAX);
+	}
+
+	TEST(TiledMatchesScalar)
+	{
+		myadc::DOUBLE_WIDE::SIGNED win[2][2][nChannels] = {{{0}}};
+		myadc::DOUBLE_WIDE::SIGNED sum[2][2][nChannels] = {{{0}}};
+		myadc::DOUBLE_WIDE::SIGNED mag[2][nChannels];
+
+		srand(42);
+		for (int i = 0 ; i < 1000 ; i ++)
+		{
+			myadc::SIGNED sample[nChannels];
+			for (int channel = 0 ; channel < nChannels ; channel ++)
+				sample[channel] = randSample();
+			myadc::SIGNED coefRe = randSample(), coefIm = randSample();
+
+			Kernels::tiled(sample, coefRe, coefIm, win[0][0], win[0][1],
+			               sum[0][0], sum[0][1], mag[0], nChannels);
+			Scalar::tiled(sample, coefRe, coefIm, win[1][0], win[1][1],
+			              sum[1][0], sum[1][1], mag[1], nChannels);
+
+			CHECK_ARRAY_EQUAL(sum[1][0], sum[0][0], nChannels);
+			CHECK_ARRAY_EQUAL(sum[1][1], sum[0][1], nChannels);
+			CHECK_ARRAY_EQUAL(mag[1], mag[0], nChannels);
+		}
+	}
+
+	TEST(RotateMatchesScalar)
+	{
+		complex<myadc::DOUBLE_WIDE::SIGNED> fourier[2][nChannels];
+		for (int channel = 0 ; channel < nChannels ; channel ++)
+			fourier[0][channel] = fourier[1][channel] = 0;
+
+		srand(42);
+		for (int i = 0 ; i < 1000 ; i ++)
+		{
+			myadc::DOUBLE_WIDE::SIGNED diff[nChannels];
+			for (int channel = 0 ; channel < nChannels ; channel ++)
+				diff[channel] = randSample() - randSample();
+			//	Unit magnitude, like the real DFT coefficients
+			double theta = 2 * M_PI * rand() / RAND_MAX;
+			myadc::SIGNED coefRe = (myadc::SIGNED)(cos(theta) * myadc::SIGNED_MAX);
+			myadc::SIGNED coefIm = (myadc::SIGNED)(sin(theta) * myadc::SIGNED_MAX);
+
+			Kernels::rotate(fourier[0], diff, coefRe, coefIm,
+			                myadc::BITDEPTH - 1, nChannels);
+			Scalar::rotate(fourier[1], diff, coefRe, coefIm,
+			               myadc::BITDEPTH - 1, nChannels);
+
+			CHECK_ARRAY_EQUAL(fourier[1], fourier[0], nChannels);
+		}
+	}
+}
@@ -48,3 +48,38 @@ TEST(SparseSDFTSpectrumGivesSameResultsAsDense)
 			}
 	}
 }
+
+TEST(SparseSDFTSpectrumBlockUpdateMatchesPerSample)
+{
+	static const int nSamples = 1000;				//	Not a multiple of the block size
+	static const int nChannels = 4;					//	Number of input channels
+	static const int N = 512;						//	Fourier window size
+	static const int nKBands = 3;					//	Number of k-values to examine
+	static const int kBands[3] = {20, 9, 501};		//	k-values we want to examine
+	typedef adc<16> myadc;
+	
+	SparseSDFTSpectrum<myadc, N, nChannels, nKBands> spectrum(kBands);
+	SparseSDFTSpectrum<myadc, N, nChannels, nKBands> blockSpectrum(kBands);
+	
+	adcdata_t samples[nSamples][nChannels];
+	for (int i = 0 ; i < nSamples ; i ++)
+		for (int channel = 0 ; channel < nChannels ; channel ++)
+			samples[i][channel] = (adcdata_t)(((double)rand() / RAND_MAX) * myadc::SIGNED_MAX);
+	
+	myadc::DOUBLE_WIDE::SIGNED magL1[nSamples][nKBands][nChannels];
+	blockSpectrum.updateBlock(*samples, nSamples, **magL1);
+	
+	for (int i = 0 ; i < nSamples ; i ++)
+	{
+		spectrum.update(samples[i]);
+		for (int channel = 0 ; channel < nChannels ; channel ++)
+			for (int kIdx = 0 ; kIdx < nKBands ; kIdx++)
+				CHECK_EQUAL(fixed::magL1(spectrum.getAmplitudeForBinIndex(kIdx, channel)),
+				            magL1[i][kIdx][channel]);
+	}
+	
+	for (int channel = 0 ; channel < nChannels ; channel ++)
+		for (int kIdx = 0 ; kIdx < nKBands ; kIdx++)
+			CHECK_EQUAL(spectrum.getAmplitudeForBinIndex(kIdx, channel),
+			            blockSpectrum.getAmplitudeForBinIndex(kIdx, channel));
+}
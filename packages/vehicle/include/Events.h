@@ -19,6 +19,7 @@
 #include "drivers/imu/include/imuapi.h"
 #include "drivers/dvl/include/dvlapi.h"
 #include "vehicle/include/device/Common.h"
+#include "vehicle/include/device/SensorRegistry.h"
 
 namespace ram {
 namespace vehicle {
@@ -88,7 +89,11 @@ typedef boost::shared_ptr<SonarEvent> SonarEventPtr;
 
 struct RawIMUDataEvent : public core::Event
 {
+    RawIMUDataEvent() : sensorID(device::SensorRegistry::UNKNOWN) {}
+
     std::string name;
+    /** The SensorRegistry ID of name, UNKNOWN if it was not stamped */
+    int sensorID;
     RawIMUData rawIMUData;
     bool magIsCorrupt;
     double timestep;
@@ -100,7 +105,11 @@ typedef boost::shared_ptr<RawIMUDataEvent> RawIMUDataEventPtr;
 
 struct RawDVLDataEvent : public core::Event
 {
+    RawDVLDataEvent() : sensorID(device::SensorRegistry::UNKNOWN) {}
+
     std::string name;
+    /** The SensorRegistry ID of name, UNKNOWN if it was not stamped */
+    int sensorID;
     RawDVLData rawDVLData;
     math::Vector2 velocity_b;
     double angularOffset;
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/SimVehicle.h
+ */
+
+#ifndef RAM_VEHICLE_SIMVEHICLE_H
+#define RAM_VEHICLE_SIMVEHICLE_H
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
+// Project Includes
+#include "vehicle/include/Vehicle.h"
+#include "vehicle/include/VehicleDynamics.h"
+
+#include "core/include/ReadWriteMutex.h"
+
+namespace ram {
+namespace vehicle {
+
+namespace device {
+class SimThruster;
+class SimSensor;
+}
+
+/** A Vehicle whose devices act on a simulated body instead of hardware
+ *
+ *  It is configured like the Vehicle, its Devices being SimThrusters,
+ *  SimIMUs, SimDVLs and SimDepthSensors, so the controller's forces go
+ *  through the same thruster allocation and the estimator takes in the
+ *  same raw events as on the real vehicle.  Time is virtual: step() moves
+ *  the body forward as fast as it can be computed, so a tool can run a
+ *  mission in a fraction of its length, or many of them side by side.
+ *  When backgrounded, or updated by the application, it steps by the real
+ *  time passed instead.
+ *
+ *  Config values, besides the Vehicle's:
+ *    Dynamics - the body, see VehicleDynamics
+ *    physicsTimestep - seconds per physics step, default 0.001
+ */
+class SimVehicle : public Vehicle
+{
+public:
+    SimVehicle(core::ConfigNode config,
+               core::SubsystemList deps = core::SubsystemList());
+
+    virtual ~SimVehicle();
+
+    /** Advances the body, thrusters and sensors by the timestep
+     *
+     *  The timestep is split into physics steps, and the sensors publish
+     *  from within this call as they come due.
+     */
+    void step(double timestep);
+
+    /** Virtual seconds simulated so far */
+    double getTime();
+
+    /** The actual state of the body, to judge the estimate against */
+    VehicleDynamics::State getTrueState();
+
+    /** Energy in Joules the thrusters have spent so far */
+    double getThrusterEnergy();
+
+    /** Updates the devices then steps by the given time */
+    virtual void update(double timestep);
+
+private:
+    core::ReadWriteMutex m_stateMutex;
+    VehicleDynamics m_dynamics;
+    double m_time;
+
+    double m_physicsTimestep;
+
+    std::vector<boost::shared_ptr<device::SimThruster> > m_thrusters;
+    std::vector<boost::shared_ptr<device::SimSensor> > m_sensors;
+};
+
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_SIMVEHICLE_H
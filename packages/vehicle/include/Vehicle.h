@@ -15,15 +15,19 @@
 
 // Library Includes
 #include "boost/tuple/tuple.hpp"
+#include <boost/scoped_ptr.hpp>
 
 // Project Includes
 #include "core/include/ConfigNode.h"
 #include "core/include/EventPublisher.h"
 #include "core/include/ReadWriteMutex.h"
 #include "core/include/Updatable.h"
+#include "core/include/EventPool.h"
+#include "core/include/BinaryTrace.h"
 
 #include "vehicle/include/Common.h"
 #include "vehicle/include/IVehicle.h"
+#include "vehicle/include/Events.h"
 
 #include "math/include/MatrixN.h"
 #include "math/include/VectorN.h"
@@ -151,6 +155,13 @@ private:
 
     math::MatrixN m_controlSignalToThrusterForces;
     bool m_controlSignalToThrusterForcesCreated;
+
+    /** Reused for the VEHICLE_THRUST_UPDATE of each applyForcesAndTorques */
+    core::EventPool<ThrustUpdateEvent> m_thrustEvents;
+
+    /** Thruster forces, starboard port bottom top fore aft, of each
+        applyForcesAndTorques when the ThrustTrace config value is set */
+    boost::scoped_ptr<core::BinaryTrace> m_thrustTrace;
     
     enum thrusters {PRT = 0, STR, TOP, FOR, BOT, AFT};
     enum forceAndThrustIndices {FX = 0, FY, FZ, TX, TY, TZ};
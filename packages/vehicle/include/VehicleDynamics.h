@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/VehicleDynamics.h
+ */
+
+#ifndef RAM_VEHICLE_VEHICLEDYNAMICS_H
+#define RAM_VEHICLE_VEHICLEDYNAMICS_H
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+#include "math/include/Vector3.h"
+#include "math/include/Quaternion.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+
+/** A six degree of freedom rigid body model of the vehicle in the water
+ *
+ *  Position and velocity are in the inertial frame, +x north, +y east and
+ *  +z down, so the z position is the depth.  The orientation rotates body
+ *  vectors into the inertial frame, the same as the estimated orientation,
+ *  and the angular rate is in the body frame, +x fore, +y starboard and +z
+ *  down.
+ *
+ *  The body is pushed by the applied force and torque, its weight, its
+ *  buoyancy acting at the center of buoyancy, and linear plus quadratic
+ *  drag against the water, which may have a current.  Buoyancy fades out
+ *  as the vehicle breaks the surface.  Added mass and inertia are lumped
+ *  onto the diagonal.  It is stepped with semi-implicit Euler, so keep the
+ *  step to a few milliseconds.
+ *
+ *  Config values, all optional, with three element arrays along the body
+ *  axes:
+ *    mass, inertia, addedMass, addedInertia - kg and kg m^2
+ *    linearDrag, quadraticDrag - N per m/s and per (m/s)^2
+ *    angularLinearDrag, angularQuadraticDrag - Nm per rad/s, (rad/s)^2
+ *    buoyancy - N, centerOfBuoyancy - m from the center of mass
+ *    current - m/s of the water in the inertial frame
+ *    initialPosition - m, initialYaw - degrees
+ */
+class RAM_EXPORT VehicleDynamics
+{
+public:
+    struct State
+    {
+        State();
+
+        math::Vector3 position;
+        math::Vector3 velocity;
+
+        /** Change in velocity over the last step, divided by its length */
+        math::Vector3 acceleration;
+
+        math::Quaternion orientation;
+        math::Vector3 angularRate;
+    };
+
+    VehicleDynamics(core::ConfigNode config);
+
+    /** Advances the body by the timestep
+     *
+     *  @param force
+     *      The applied force in the body frame, in Newtons
+     *  @param torque
+     *      The applied torque about the center of mass in the body frame
+     */
+    void step(double timestep, const math::Vector3& force,
+              const math::Vector3& torque);
+
+    const State& getState() const;
+
+    void setState(const State& state);
+
+    /** Mass of the vehicle, without the added mass of the water */
+    double getMass() const;
+
+private:
+    static math::Vector3 readVector(core::ConfigNode node,
+                                    const math::Vector3& def);
+
+    State m_state;
+
+    double m_mass;
+
+    /** Mass and inertia including that of the water moved with the body */
+    math::Vector3 m_effectiveMass;
+    math::Vector3 m_effectiveInertia;
+
+    math::Vector3 m_inertia;
+
+    math::Vector3 m_linearDrag;
+    math::Vector3 m_quadraticDrag;
+    math::Vector3 m_angularLinearDrag;
+    math::Vector3 m_angularQuadraticDrag;
+
+    double m_buoyancy;
+    math::Vector3 m_centerOfBuoyancy;
+
+    math::Vector3 m_current;
+};
+
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_VEHICLEDYNAMICS_H
@@ -13,12 +13,16 @@
 // STD Includes
 #include <string>
 
+// Library Includes
+#include <boost/cstdint.hpp>
+
 // Project Includes
 #include "vehicle/include/device/Device.h"
 #include "vehicle/include/device/IVelocitySensor.h"
+#include "vehicle/include/device/SensorReactor.h"
 
 #include "core/include/Updatable.h"
-#include "core/include/ReadWriteMutex.h"
+#include "core/include/Mailbox.h"
 #include "core/include/ConfigNode.h"
 
 #include "math/include/Vector2.h"
@@ -58,7 +62,10 @@ public:
     
     virtual std::string getName() { return Device::getName(); }
     
-    /** This is called at the desired interval to read data from the IMU */
+    /** This is called at the desired interval to read data from the DVL
+     *
+     *  Not used when the DVL is read by the SensorReactor.
+     */
     virtual void update(double timestep);
 
     virtual void setPriority(core::IUpdatable::Priority priority) {
@@ -77,18 +84,41 @@ public:
         return Updatable::getAffinity();
     }
     
-    virtual void background(int interval) {
-        Updatable::background(interval);
-    };
+    /** Starts reading the DVL, on the SensorReactor if it is used */
+    virtual void background(int interval);
     
-    virtual void unbackground(bool join = false) {
-        Updatable::unbackground(join);
-    };
-    virtual bool backgrounded() {
-        return Updatable::backgrounded();
-    };
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
     
 private:
+    /** Parses and publishes every complete packet, for the SensorReactor */
+    size_t onData(const unsigned char* data, size_t length);
+
+    /** Closes and opens the serial port again, for the SensorReactor
+     *
+     *  @return
+     *      The new descriptor, -1 if it could not be opened
+     */
+    int reopen();
+
+    /** Stores the new state, and publishes the velocity and ranges
+     *
+     *  @param arrival
+     *      When the data was read, on the clock of LatencyTracker::now()
+     */
+    void processState(const RawDVLData& newState, double timestep,
+                      boost::int64_t arrival);
+
+    /** Reads the DVL as data arrives, instead of polling, when set */
+    SensorReactorPtr m_reactor;
+
+    /** Id of the serial port with m_reactor, -1 when not registered */
+    int m_reactorID;
+
+    /** Time of the last packet parsed by onData */
+    double m_lastPacketTime;
+    
     IVehiclePtr m_vehicle;
     
     /** Name of the serial device file */
@@ -103,11 +133,8 @@ private:
     /** sensor location **/
     math::Vector3 m_location;
 
-    /** Protects access to raw state */
-    core::ReadWriteMutex m_stateMutex;
-
-    /** The raw data read back from the DVL */
-    RawDVLData* m_rawState;
+    /** The raw data read back from the DVL, written only as it is read */
+    core::Mailbox<RawDVLData>* m_rawState;
 
     static const int BAD_VELOCITY;
 };
@@ -31,9 +31,13 @@ public:
     virtual ~Device() {};
 
     virtual std::string getName();
+
+    /** The SensorRegistry ID of the name, given when the device is made */
+    int getSensorID();
     
 private:
     std::string m_name;
+    int m_sensorID;
 };
     
 } // namespace device
@@ -13,12 +13,16 @@
 // STD Includes
 #include <string>
 
+// Library Includes
+#include <boost/cstdint.hpp>
+
 // Project Includes
 #include "vehicle/include/device/Device.h"
 #include "vehicle/include/device/IIMU.h"
+#include "vehicle/include/device/SensorReactor.h"
 
 #include "core/include/Updatable.h"
-#include "core/include/ReadWriteMutex.h"
+#include "core/include/Mailbox.h"
 #include "core/include/ConfigNode.h"
 
 #include "math/include/Vector3.h"
@@ -59,7 +63,10 @@ public:
 
     virtual std::string getName() { return Device::getName(); }
     
-    /** This is called at the desired interval to read data from the IMU */
+    /** This is called at the desired interval to read data from the IMU
+     *
+     *  Not used when the IMU is read by the SensorReactor.
+     */
     virtual void update(double timestep);
 
     virtual void setPriority(core::IUpdatable::Priority priority) {
@@ -78,18 +85,41 @@ public:
         return Updatable::getAffinity();
     }
     
-    virtual void background(int interval) {
-        Updatable::background(interval);
-    };
+    /** Starts reading the IMU, on the SensorReactor if it is used */
+    virtual void background(int interval);
     
-    virtual void unbackground(bool join = false) {
-        Updatable::unbackground(join);
-    };
-    virtual bool backgrounded() {
-        return Updatable::backgrounded();
-    };
+    virtual void unbackground(bool join = false);
+
+    virtual bool backgrounded();
     
 private:
+    /** Parses and publishes every complete frame, for the SensorReactor */
+    size_t onData(const unsigned char* data, size_t length);
+
+    /** Closes and opens the serial port again, for the SensorReactor
+     *
+     *  @return
+     *      The new descriptor, -1 if it could not be opened
+     */
+    int reopen();
+
+    /** Stores the new state, and publishes it in the vehicle frame
+     *
+     *  @param arrival
+     *      When the data was read, on the clock of LatencyTracker::now()
+     */
+    void processState(const RawIMUData& newState, double timestep,
+                      boost::int64_t arrival);
+    
+    /** Reads the IMU as data arrives, instead of polling, when set */
+    SensorReactorPtr m_reactor;
+
+    /** Id of the serial port with m_reactor, -1 when not registered */
+    int m_reactorID;
+
+    /** Time of the last frame parsed by onData */
+    double m_lastFrameTime;
+    
     /** Name of the serial device file */
     std::string m_devfile;
     
@@ -118,10 +148,8 @@ private:
     /** Nominal value of magnetic vector length obtained experimentally **/
     double m_magNominalLength;
     
-    /** Protects access to raw state */
-    core::ReadWriteMutex m_stateMutex;
-    /** The raw data read back from the IMU */
-    RawIMUData* m_rawState;
+    /** The raw data read back from the IMU, written only as it is read */
+    core::Mailbox<RawIMUData>* m_rawState;
 };
 
     
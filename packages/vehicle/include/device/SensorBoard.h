@@ -21,7 +21,7 @@
 #include "core/include/Event.h"
 #include "core/include/Updatable.h"
 #include "core/include/ConfigNode.h"
-#include "core/include/ReadWriteMutex.h"
+#include "core/include/Mailbox.h"
 
 #include "math/include/SGolaySmoothingFilter.h"
 
@@ -277,6 +277,15 @@ private:
         double mainBusVoltage;
     };
 
+    /** The parts of the state the getters report */
+    struct BoardStatus
+    {
+        int thrusterState;
+        int battEnabled;
+        int battUsed;
+        double mainBusVoltage;
+    };
+
     /** Opens the FD if needed and syncs with the board */
     void establishConnection();
 
@@ -300,12 +309,18 @@ private:
     /** Calculates the bus voltage for getMainBusVoltage */
     double calculateMainBusVoltage(struct boardInfo* telemetry);
 
-    /** Mutex which protects access to state */
-    core::ReadWriteMutex m_stateMutex;
+    /** Protects the thruster commands waiting to be sent */
+    boost::mutex m_thrusterMutex;
+
+    /** The thruster commands update() sends next */
+    int m_thrusterValues[6];
 
-    /** Vehicle state */
+    /** Vehicle state, only touched by update() */
     VehicleState m_state;
 
+    /** Latest status for the getters, written only by update() */
+    core::Mailbox<BoardStatus> m_status;
+
     // Hacked depth calibration stuff
     double m_depthCalibSlope;
     double m_depthCalibIntercept;
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SensorReactor.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SENSORREACTOR_07_14_2011
+#define RAM_VEHICLE_DEVICE_SENSORREACTOR_07_14_2011
+
+// STD Includes
+#include <map>
+#include <vector>
+
+// Library Includes
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+class SensorReactor;
+typedef boost::shared_ptr<SensorReactor> SensorReactorPtr;
+
+/** Waits on the serial ports of many sensors with one thread
+ *
+ *  Instead of each sensor blocking a thread of its own on reads of a few
+ *  bytes, the reactor waits on every registered descriptor at once (with
+ *  epoll on Linux).  Whatever bytes are waiting are read in one go into the
+ *  buffer of that device, and handed to its handler, which parses out and
+ *  publishes every complete frame.  Bytes the handler does not consume are
+ *  kept until more arrive, so a sample goes out as soon as its last byte is
+ *  read.
+ *
+ *  Devices given a ReopenHandler are not dropped when their port closes or
+ *  fails, the reactor keeps trying to open them again every RETRY_MS.
+ */
+class RAM_EXPORT SensorReactor : boost::noncopyable
+{
+public:
+    /** Bytes buffered for each device */
+    static const size_t BUFFER_SIZE = 4096;
+
+    /** Called with all the unconsumed bytes of the device
+     *
+     *  @return
+     *      The number of bytes, from the start, which can be discarded
+     */
+    typedef boost::function<size_t (const unsigned char*, size_t)>
+        DataHandler;
+
+    /** Opens the device again after it closed or failed
+     *
+     *  The old descriptor is not closed by the reactor, this should close
+     *  it.
+     *
+     *  @return
+     *      The new descriptor, or -1 to be called again later
+     */
+    typedef boost::function<int ()> ReopenHandler;
+
+    /** Time between attempts to reopen a device */
+    static const int RETRY_MS = 1000;
+
+    SensorReactor();
+
+    /** Stops the background thread if running */
+    ~SensorReactor();
+
+    /** The reactor shared by all the devices of the process
+     *
+     *  Created, and started, when first asked for, and destroyed when the
+     *  last device lets go of it.
+     */
+    static SensorReactorPtr getShared();
+
+    /** Starts handling devices on the reactors own thread */
+    void start();
+
+    /** Stops and joins the background thread */
+    void stop();
+
+    /** Starts watching the descriptor, it is made non blocking
+     *
+     *  @param fd
+     *      The open device, or -1 when it could not be opened, in which
+     *      case reopen is called until it is
+     *  @param reopen
+     *      When given, the device is opened again with it if it closes or
+     *      fails, instead of being dropped
+     *
+     *  @return
+     *      The id to remove the device with
+     */
+    int addDevice(int fd, DataHandler handler,
+                  ReopenHandler reopen = ReopenHandler());
+
+    /** Stops watching the device
+     *
+     *  Once this returns the handler is not running, and will not be
+     *  called again.  Called from a handler, on the reactor thread, it
+     *  returns at once and the device is dropped once the handlers of the
+     *  current poll() are done.
+     */
+    void removeDevice(int id);
+
+    /** Number of devices being watched or reopened, closed ones without a
+     *  ReopenHandler are dropped */
+    size_t getDeviceCount();
+
+    /** Waits for, then handles, the descriptors with data ready
+     *
+     *  @param timeoutMS
+     *      How long to wait for data, -1 waits forever
+     *
+     *  Closed devices due to be reopened are reopened afterwards.
+     *
+     *  @return
+     *      The number of descriptors read from
+     */
+    int poll(int timeoutMS);
+
+private:
+    struct Device
+    {
+        Device() : id(0), fd(-1), removed(false), start(0), end(0) {}
+
+        int id;
+
+        /** -1 while the device waits to be reopened */
+        int fd;
+        DataHandler handler;
+        ReopenHandler reopen;
+
+        /** When to next call reopen */
+        boost::posix_time::ptime retryTime;
+
+        /** Set by removeDevice(), the handler is not called after */
+        volatile bool removed;
+
+        /** Unconsumed bytes are in [start, end) */
+        size_t start;
+        size_t end;
+        unsigned char buffer[BUFFER_SIZE];
+    };
+    typedef boost::shared_ptr<Device> DevicePtr;
+    typedef std::map<int, DevicePtr> DeviceMap;
+
+    /** Reads everything waiting on the device and hands it over
+     *
+     *  @return
+     *      False if the device was closed or failed
+     */
+    bool service(Device& device);
+
+    /** Adds the descriptor of the device to the wait set */
+    void watch(Device& device);
+
+    /** Removes the descriptor of the device from the wait set */
+    void unwatch(Device& device);
+
+    /** Schedules a reopen for a device which closed, or drops it */
+    void closed(Device& device);
+
+    /** Calls the ReopenHandler of every closed device which is due */
+    void reopenDevices();
+
+    /** Runs poll() until stopped */
+    void loop();
+
+    /** Wakes a waiting poll() */
+    void wakeup();
+
+    /** Guards m_devices and the servicing state below */
+    boost::mutex m_devicesMutex;
+    DeviceMap m_devices;
+    int m_nextID;
+
+    /** True while poll() runs handlers, on m_servicingThread */
+    bool m_servicing;
+    boost::thread::id m_servicingThread;
+
+    /** Counts the passes of poll(), so removal can wait for one to end */
+    unsigned long m_passes;
+    boost::condition m_passDone;
+
+    /** Devices removed by handlers, erased when the pass is done */
+    std::vector<int> m_pendingRemovals;
+
+    /** Wakes the reactor for shutdown */
+    int m_wakeupPipe[2];
+
+    /** The epoll instance, or -1 where poll(2) is used */
+    int m_epollFD;
+
+    volatile bool m_running;
+    boost::thread* m_thread;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SENSORREACTOR_07_14_2011
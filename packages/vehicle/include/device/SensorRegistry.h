@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SensorRegistry.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SENSORREGISTRY_H_07_17_2011
+#define RAM_VEHICLE_DEVICE_SENSORREGISTRY_H_07_17_2011
+
+// STD Includes
+#include <string>
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+/** Gives every sensor name a small integer ID
+ *
+ *  Devices intern their name when they are created, and stamp the ID on
+ *  their raw events, so consumers can keep per sensor state in arrays
+ *  indexed by ID instead of maps keyed by name.  IDs are handed out in
+ *  order from 0 and never reused, and interning a name again returns the
+ *  same ID, so a consumer can intern the names from its config before or
+ *  after the devices exist.
+ */
+class RAM_EXPORT SensorRegistry
+{
+public:
+    /** The ID of events which were not stamped by a device */
+    static const int UNKNOWN = -1;
+
+    /** Returns the ID of the name, giving it the next one if it is new */
+    static int intern(const std::string& name);
+
+    /** Returns the name with the ID, or an empty string if there is none */
+    static std::string getName(int id);
+
+    /** Returns the number of names interned so far, one more than the
+        largest ID */
+    static int count();
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SENSORREGISTRY_H_07_17_2011
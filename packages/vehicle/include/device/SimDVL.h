@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SimDVL.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SIMDVL_H
+#define RAM_VEHICLE_DEVICE_SIMDVL_H
+
+// Project Includes
+#include "vehicle/include/Common.h"
+#include "vehicle/include/Events.h"
+#include "vehicle/include/device/Device.h"
+#include "vehicle/include/device/IVelocitySensor.h"
+#include "vehicle/include/device/SimSensor.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/EventPool.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+/** A DVL for the SimVehicle, measuring its velocity over the bottom
+ *
+ *  Publishes IVelocitySensor::RAW_UPDATE with the in plane velocity of the
+ *  sensor in the body frame, which includes the velocity of its location
+ *  as the vehicle turns.
+ *
+ *  Config values, besides those of SimSensor (update_interval default 50):
+ *    location - m from the center of mass, default 0
+ *    velocityNoise - m/s standard deviation, default 0
+ */
+class RAM_EXPORT SimDVL : public Device, // for getName
+                          public IVelocitySensor,
+                          public SimSensor
+                          // boost::noncopyable
+{
+public:
+    SimDVL(core::ConfigNode config,
+           core::EventHubPtr eventHub = core::EventHubPtr(),
+           IVehiclePtr vehicle = IVehiclePtr());
+
+    virtual ~SimDVL();
+
+    virtual math::Vector3 getLocation();
+
+    // Device Options
+    virtual std::string getName() { return Device::getName(); }
+
+    virtual void update(double timestep) {}
+
+    virtual void setPriority(core::IUpdatable::Priority) {}
+
+    virtual core::IUpdatable::Priority getPriority() {
+        return IUpdatable::NORMAL_PRIORITY;
+    }
+
+    virtual void setAffinity(size_t) {};
+
+    virtual int getAffinity() {
+        return -1;
+    };
+
+    virtual void background(int interval) {};
+
+    virtual void unbackground(bool join = false) {};
+
+    virtual bool backgrounded() { return false; };
+
+protected:
+    virtual void sample(const VehicleDynamics& dynamics, double timestep);
+
+private:
+    math::Vector3 m_location;
+    double m_velocityNoise;
+
+    core::EventPool<RawDVLDataEvent> m_events;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SIMDVL_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SimDepthSensor.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SIMDEPTHSENSOR_H
+#define RAM_VEHICLE_DEVICE_SIMDEPTHSENSOR_H
+
+// Project Includes
+#include "vehicle/include/Common.h"
+#include "vehicle/include/Events.h"
+#include "vehicle/include/device/Device.h"
+#include "vehicle/include/device/IDepthSensor.h"
+#include "vehicle/include/device/SimSensor.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/EventPool.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+/** A pressure sensor for the SimVehicle
+ *
+ *  Publishes IDepthSensor::RAW_UPDATE.  Like the real sensor it is
+ *  calibrated to read the depth of the vehicle while level, so the depth
+ *  it reads only moves away from that as the vehicle tilts.
+ *
+ *  Config values, besides those of SimSensor (update_interval default 20):
+ *    location - m from the center of mass, default 0
+ *    depthNoise - m standard deviation, default 0
+ */
+class RAM_EXPORT SimDepthSensor : public Device, // for getName
+                                  public IDepthSensor,
+                                  public SimSensor
+                                  // boost::noncopyable
+{
+public:
+    SimDepthSensor(core::ConfigNode config,
+                   core::EventHubPtr eventHub = core::EventHubPtr(),
+                   IVehiclePtr vehicle = IVehiclePtr());
+
+    virtual ~SimDepthSensor();
+
+    virtual math::Vector3 getLocation();
+
+    // Device Options
+    virtual std::string getName() { return Device::getName(); }
+
+    virtual void update(double timestep) {}
+
+    virtual void setPriority(core::IUpdatable::Priority) {}
+
+    virtual core::IUpdatable::Priority getPriority() {
+        return IUpdatable::NORMAL_PRIORITY;
+    }
+
+    virtual void setAffinity(size_t) {};
+
+    virtual int getAffinity() {
+        return -1;
+    };
+
+    virtual void background(int interval) {};
+
+    virtual void unbackground(bool join = false) {};
+
+    virtual bool backgrounded() { return false; };
+
+protected:
+    virtual void sample(const VehicleDynamics& dynamics, double timestep);
+
+private:
+    math::Vector3 m_location;
+    double m_depthNoise;
+
+    core::EventPool<RawDepthSensorDataEvent> m_events;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SIMDEPTHSENSOR_H
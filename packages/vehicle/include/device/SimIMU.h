@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SimIMU.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SIMIMU_H
+#define RAM_VEHICLE_DEVICE_SIMIMU_H
+
+// Project Includes
+#include "vehicle/include/Common.h"
+#include "vehicle/include/Events.h"
+#include "vehicle/include/device/Device.h"
+#include "vehicle/include/device/IIMU.h"
+#include "vehicle/include/device/SimSensor.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/EventPool.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+/** An IMU for the SimVehicle, measuring the true state with noise
+ *
+ *  Publishes IIMU::RAW_UPDATE already rotated into the vehicle frame, as
+ *  the IMU driver does.  Acceleration is in G, the rotation rate in rad/s
+ *  and the magnetic field in Gauss.
+ *
+ *  Config values, besides those of SimSensor (update_interval default 5):
+ *    accelNoise, gyroNoise, magNoise - standard deviations, default 0
+ *    magneticInclination - degrees the field dips below north, default 60
+ *    magneticStrength - Gauss, default 0.5
+ */
+class RAM_EXPORT SimIMU : public Device, // for getName
+                          public IIMU,
+                          public SimSensor
+                          // boost::noncopyable
+{
+public:
+    SimIMU(core::ConfigNode config,
+           core::EventHubPtr eventHub = core::EventHubPtr(),
+           IVehiclePtr vehicle = IVehiclePtr());
+
+    virtual ~SimIMU();
+
+    // Device Options
+    virtual std::string getName() { return Device::getName(); }
+
+    virtual void update(double timestep) {}
+
+    virtual void setPriority(core::IUpdatable::Priority) {}
+
+    virtual core::IUpdatable::Priority getPriority() {
+        return IUpdatable::NORMAL_PRIORITY;
+    }
+
+    virtual void setAffinity(size_t) {};
+
+    virtual int getAffinity() {
+        return -1;
+    };
+
+    virtual void background(int interval) {};
+
+    virtual void unbackground(bool join = false) {};
+
+    virtual bool backgrounded() { return false; };
+
+protected:
+    virtual void sample(const VehicleDynamics& dynamics, double timestep);
+
+private:
+    double m_accelNoise;
+    double m_gyroNoise;
+    double m_magNoise;
+
+    /** The magnetic field in the inertial frame */
+    math::Vector3 m_magneticField;
+
+    core::EventPool<RawIMUDataEvent> m_events;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SIMIMU_H
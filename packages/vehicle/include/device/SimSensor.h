@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SimSensor.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SIMSENSOR_H
+#define RAM_VEHICLE_DEVICE_SIMSENSOR_H
+
+// Library Includes
+#include <boost/random/mersenne_twister.hpp>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+
+class VehicleDynamics;
+
+namespace device {
+
+/** Base for the simulated sensors the SimVehicle drives
+ *
+ *  The SimVehicle hands every sensor the true state after each physics
+ *  step, and the sensor samples it when its update interval has passed,
+ *  publishing the same raw event the hardware driver does.  Each sensor
+ *  has its own random generator, seeded from its config, so a run is
+ *  repeatable no matter how many others run beside it.
+ *
+ *  Config values:
+ *    update_interval - ms between samples
+ *    seed - for the measurement noise, default 1
+ */
+class RAM_EXPORT SimSensor
+{
+public:
+    virtual ~SimSensor();
+
+    /** Samples the true state if the sensor is due
+     *
+     *  @param dynamics
+     *      The body being measured
+     *  @param time
+     *      Seconds since the simulation began
+     */
+    void simulate(const VehicleDynamics& dynamics, double time);
+
+protected:
+    SimSensor(core::ConfigNode config, int defaultInterval);
+
+    /** Measures the body and publishes the result
+     *
+     *  @param timestep
+     *      Seconds since the last sample
+     */
+    virtual void sample(const VehicleDynamics& dynamics, double timestep) = 0;
+
+    /** A zero mean normally distributed value */
+    double noise(double stddev);
+
+private:
+    double m_interval;
+    double m_lastSample;
+    bool m_sampled;
+
+    boost::mt19937 m_generator;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SIMSENSOR_H
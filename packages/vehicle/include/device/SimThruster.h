@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/include/device/SimThruster.h
+ */
+
+#ifndef RAM_VEHICLE_DEVICE_SIMTHRUSTER_H
+#define RAM_VEHICLE_DEVICE_SIMTHRUSTER_H
+
+// Project Includes
+#include "vehicle/include/Common.h"
+#include "vehicle/include/device/Device.h"
+#include "vehicle/include/device/IThruster.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/ReadWriteMutex.h"
+#include "core/include/EventPool.h"
+#include "math/include/Events.h"
+
+// Must Be Included last
+#include "vehicle/include/Export.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+/** A thruster with no hardware, for the SimVehicle
+ *
+ *  The force it outputs follows the commanded force with a first order lag
+ *  and is held within its limits.  The SimVehicle advances it with
+ *  simulate() and pushes the vehicle with getForce().  It also keeps the
+ *  energy an ideal propeller would have spent making that force.
+ *
+ *  Config values:
+ *    location, direction - as for IThruster, the way the thruster pushes
+ *      the vehicle for a positive force
+ *    maxForce, minForce - N, default 25 and -25
+ *    timeConstant - s, of the lag, default 0.05
+ *    propellerDiameter - m, default 0.1
+ */
+class RAM_EXPORT SimThruster : public Device, // for getName
+                               public IThruster
+                               // boost::noncopyable
+{
+public:
+    SimThruster(core::ConfigNode config,
+                core::EventHubPtr eventHub = core::EventHubPtr(),
+                IVehiclePtr vehicle = IVehiclePtr());
+
+    virtual ~SimThruster();
+
+    /** Advances the output force by the timestep */
+    void simulate(double timestep);
+
+    /** The energy in Joules spent since the thruster was made */
+    double getEnergy();
+
+    /** Sets the commanded force, which the output then follows */
+    virtual void setForce(double newtons);
+
+    /** The force currently output, in Newtons */
+    virtual double getForce();
+
+    virtual double getMaxForce();
+
+    virtual double getMinForce();
+
+    virtual bool isEnabled();
+
+    virtual void setEnabled(bool state);
+
+    virtual math::Vector3 getLocation();
+
+    virtual math::Vector3 getDirection();
+
+    virtual double getCurrent() { return 0; }
+
+    // Device Options
+    virtual std::string getName() { return Device::getName(); }
+
+    virtual void update(double timestep) {}
+
+    virtual void setPriority(core::IUpdatable::Priority) {}
+
+    virtual core::IUpdatable::Priority getPriority() {
+        return IUpdatable::NORMAL_PRIORITY;
+    }
+
+    virtual void setAffinity(size_t) {};
+
+    virtual int getAffinity() {
+        return -1;
+    };
+
+    virtual void background(int interval) {};
+
+    virtual void unbackground(bool join = false) {};
+
+    virtual bool backgrounded() { return false; };
+
+private:
+    core::ReadWriteMutex m_stateMutex;
+    double m_command;
+    double m_force;
+    double m_energy;
+    bool m_enabled;
+
+    double m_maxForce;
+    double m_minForce;
+    double m_timeConstant;
+
+    /** Twice the density of water times the propeller disk area */
+    double m_powerScale;
+
+    math::Vector3 m_location;
+    math::Vector3 m_direction;
+
+    core::EventPool<math::NumericEvent> m_forceEvents;
+};
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
+
+#endif // RAM_VEHICLE_DEVICE_SIMTHRUSTER_H
@@ -106,6 +106,7 @@ core::EventPtr RawIMUDataEvent::clone()
     copyInto(event);
 
     event->name = name;
+    event->sensorID = sensorID;
     event->rawIMUData = rawIMUData;
     event->magIsCorrupt = magIsCorrupt; 
     event->timestep = timestep;
@@ -119,6 +120,7 @@ core::EventPtr RawDVLDataEvent::clone()
     copyInto(event);
 
     event->name = name;
+    event->sensorID = sensorID;
     event->rawDVLData = rawDVLData;
     event->velocity_b = velocity_b;
     event->angularOffset = angularOffset;
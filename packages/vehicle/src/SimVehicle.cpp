@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/SimVehicle.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Library Includes
+#include <boost/foreach.hpp>
+
+// Project Includes
+#include "vehicle/include/SimVehicle.h"
+#include "vehicle/include/device/SimThruster.h"
+#include "vehicle/include/device/SimSensor.h"
+
+#include "core/include/SubsystemMaker.h"
+
+// Register vehicle into the maker subsystem
+RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::vehicle::SimVehicle, SimVehicle);
+
+namespace ram {
+namespace vehicle {
+
+SimVehicle::SimVehicle(core::ConfigNode config, core::SubsystemList deps) :
+    Vehicle(config, deps),
+    m_dynamics(config["Dynamics"]),
+    m_time(0),
+    m_physicsTimestep(config["physicsTimestep"].asDouble(0.001))
+{
+    BOOST_FOREACH(std::string name, getDeviceNames())
+    {
+        device::IDevicePtr device(getDevice(name));
+
+        boost::shared_ptr<device::SimThruster> thruster =
+            boost::dynamic_pointer_cast<device::SimThruster>(device);
+        if (thruster)
+            m_thrusters.push_back(thruster);
+
+        boost::shared_ptr<device::SimSensor> sensor =
+            boost::dynamic_pointer_cast<device::SimSensor>(device);
+        if (sensor)
+            m_sensors.push_back(sensor);
+    }
+}
+
+SimVehicle::~SimVehicle()
+{
+}
+
+void SimVehicle::step(double timestep)
+{
+    int steps = (int)std::ceil(timestep / m_physicsTimestep - 1e-9);
+    if (steps < 1)
+        steps = 1;
+    double dt = timestep / steps;
+
+    for (int i = 0; i < steps; ++i)
+    {
+        math::Vector3 force(math::Vector3::ZERO);
+        math::Vector3 torque(math::Vector3::ZERO);
+        BOOST_FOREACH(boost::shared_ptr<device::SimThruster> thruster,
+                      m_thrusters)
+        {
+            thruster->simulate(dt);
+            math::Vector3 thrust =
+                thruster->getDirection() * thruster->getForce();
+            force += thrust;
+            torque += thruster->getLocation().crossProduct(thrust);
+        }
+
+        {
+            core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
+            m_dynamics.step(dt, force, torque);
+            m_time += dt;
+        }
+
+        // Sensors publish outside the lock, so handlers may read the state
+        BOOST_FOREACH(boost::shared_ptr<device::SimSensor> sensor, m_sensors)
+            sensor->simulate(m_dynamics, m_time);
+    }
+}
+
+double SimVehicle::getTime()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    return m_time;
+}
+
+VehicleDynamics::State SimVehicle::getTrueState()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    return m_dynamics.getState();
+}
+
+double SimVehicle::getThrusterEnergy()
+{
+    double energy = 0;
+    BOOST_FOREACH(boost::shared_ptr<device::SimThruster> thruster,
+                  m_thrusters)
+    {
+        energy += thruster->getEnergy();
+    }
+    return energy;
+}
+
+void SimVehicle::update(double timestep)
+{
+    Vehicle::update(timestep);
+    step(timestep);
+}
+
+} // namespace vehicle
+} // namespace ram
@@ -37,6 +37,7 @@
 #include "core/include/DependencyGraph.h"
 #include "core/include/EventConnection.h"
 #include "core/include/TimeVal.h"
+#include "core/include/Logging.h"
 
 // Register vehicle into the maker subsystem
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::vehicle::Vehicle, Vehicle);
@@ -137,7 +138,6 @@ Vehicle::Vehicle(core::ConfigNode config, core::SubsystemList deps) :
                                     << node["type"].asString();
             }
         }
-        TLOGGER.warn("starboard port bottom top fore aft");
 
 
         NameDeviceMapIter iter = m_devices.find(m_extraThrusterName);
@@ -146,6 +146,24 @@ Vehicle::Vehicle(core::ConfigNode config, core::SubsystemList deps) :
                 (*iter).second);
     }
 
+    if (config.exists("ThrustTrace"))
+    {
+        boost::filesystem::path traceFile = core::Logging::getLogDir() /
+            config["ThrustTrace"].asString();
+        m_thrustTrace.reset(new core::BinaryTrace(traceFile.string(), 6));
+        if (m_thrustTrace->isOpen())
+        {
+            TLOGGER.infoStream() << "Tracing starboard port bottom top fore "
+                                 << "aft to " << traceFile.string();
+            m_thrustTrace->background(100);
+        }
+        else
+        {
+            TLOGGER.warnStream() << "Could not open thrust trace "
+                                 << traceFile.string();
+            m_thrustTrace.reset();
+        }
+    }
 
 
 }
@@ -307,35 +325,38 @@ void Vehicle::applyForcesAndTorques(const math::Vector3& translationalForces,
     // the force applied and the offset location
     // PRT, STR, TOP, FOR, BOT, AFT
 
-    math::VectorN controlSignal(0.0, 6);
-    controlSignal[0] = translationalForces[0];
-    controlSignal[1] = translationalForces[1];
-    controlSignal[2] = translationalForces[2];
-    controlSignal[3] = rotationalTorques[0];
-    controlSignal[4] = rotationalTorques[1];
-    controlSignal[5] = rotationalTorques[2];
+    // Fixed size, so the thruster forces are found without allocating
+    double controlSignal[6] = {
+        translationalForces[0], translationalForces[1], translationalForces[2],
+        rotationalTorques[0], rotationalTorques[1], rotationalTorques[2]
+    };
 
     //from config values the output force
     //orientation and position will be obtained
     //need to get these added
     //need to discuss how to config this with gary
-    math::VectorN extraThruster(0.0, 6);
     if(m_extraThrustOn == true)
     {
-        //initialize this here! format is fx fy yz tx ty tz
+        //format is fx fy yz tx ty tz
         //first 3  just force*directions, torques are forces cross position vector
-        extraThruster[0] = force*m_extraDirection[0];
-        extraThruster[1] = force*m_extraDirection[1];
-        extraThruster[2] = force*m_extraDirection[2];
-        math::Vector3 fCrossD;
-        fCrossD = (force*m_extraDirection).crossProduct(m_extraLocation);
-        extraThruster[3] = fCrossD[0];
-        extraThruster[4] = fCrossD[1];
-        extraThruster[5] = fCrossD[2];
+        math::Vector3 extraForce(force*m_extraDirection);
+        math::Vector3 fCrossD(extraForce.crossProduct(m_extraLocation));
+        controlSignal[FX] -= extraForce[0];
+        controlSignal[FY] -= extraForce[1];
+        controlSignal[FZ] -= extraForce[2];
+        controlSignal[TX] -= fCrossD[0];
+        controlSignal[TY] -= fCrossD[1];
+        controlSignal[TZ] -= fCrossD[2];
     }
     //now adding in the extra thuster, still needs events
-    math::VectorN thrusterForces = 
-        (m_controlSignalToThrusterForces) * (controlSignal-extraThruster);
+    double thrusterForces[6];
+    for (int i = 0; i < 6; ++i)
+    {
+        const double* row = m_controlSignalToThrusterForces[i];
+        thrusterForces[i] = 0;
+        for (int j = 0; j < 6; ++j)
+            thrusterForces[i] += row[j] * controlSignal[j];
+    }
 
 
     /****** Set Thruster Forces *************************/
@@ -347,18 +368,19 @@ void Vehicle::applyForcesAndTorques(const math::Vector3& translationalForces,
     m_aftThruster->setForce(thrusterForces[AFT]);
 
 
-    ThrustUpdateEventPtr event = ThrustUpdateEventPtr(
-        new ThrustUpdateEvent());
+    ThrustUpdateEventPtr event = m_thrustEvents.acquire();
     event->forces = translationalForces;
     event->torques = rotationalTorques;
     publish(VEHICLE_THRUST_UPDATE ,event);
 
-    TLOGGER.infoStream() << thrusterForces[STR] << " "
-                         << thrusterForces[PRT] << " "
-                         << thrusterForces[BOT] << " "
-                         << thrusterForces[TOP] << " "
-                         << thrusterForces[FOR] << " "
-                         << thrusterForces[AFT];
+    if (m_thrustTrace)
+    {
+        double row[6] = {
+            thrusterForces[STR], thrusterForces[PRT], thrusterForces[BOT],
+            thrusterForces[TOP], thrusterForces[FOR], thrusterForces[AFT]
+        };
+        m_thrustTrace->record(row);
+    }
 }
     
 int Vehicle::_addDevice(device::IDevicePtr device)
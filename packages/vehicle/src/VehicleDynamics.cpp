@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/VehicleDynamics.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Project Includes
+#include "vehicle/include/VehicleDynamics.h"
+
+namespace ram {
+namespace vehicle {
+
+static const double GRAVITY = 9.80665;
+
+/** How far above the surface, in meters, buoyancy has faded to nothing */
+static const double SURFACE_HEIGHT = 0.2;
+
+VehicleDynamics::State::State() :
+    position(math::Vector3::ZERO),
+    velocity(math::Vector3::ZERO),
+    acceleration(math::Vector3::ZERO),
+    orientation(math::Quaternion::IDENTITY),
+    angularRate(math::Vector3::ZERO)
+{
+}
+
+VehicleDynamics::VehicleDynamics(core::ConfigNode config) :
+    m_mass(config["mass"].asDouble(28.2)),
+    m_inertia(readVector(config["inertia"], math::Vector3(0.19, 1.2, 1.2))),
+    m_linearDrag(readVector(config["linearDrag"], math::Vector3(5, 10, 10))),
+    m_quadraticDrag(readVector(config["quadraticDrag"],
+                               math::Vector3(18, 75, 75))),
+    m_angularLinearDrag(readVector(config["angularLinearDrag"],
+                                   math::Vector3(0.5, 1.5, 1.5))),
+    m_angularQuadraticDrag(readVector(config["angularQuadraticDrag"],
+                                      math::Vector3(0.5, 3, 3))),
+    m_buoyancy(config["buoyancy"].asDouble(m_mass * GRAVITY * 1.005)),
+    m_centerOfBuoyancy(readVector(config["centerOfBuoyancy"],
+                                  math::Vector3(0, 0, -0.01))),
+    m_current(readVector(config["current"], math::Vector3::ZERO))
+{
+    math::Vector3 addedMass(readVector(config["addedMass"],
+                                       math::Vector3(3, 22, 22)));
+    math::Vector3 addedInertia(readVector(config["addedInertia"],
+                                          math::Vector3(0.05, 0.8, 0.8)));
+    for (int i = 0; i < 3; ++i)
+    {
+        m_effectiveMass[i] = m_mass + addedMass[i];
+        m_effectiveInertia[i] = m_inertia[i] + addedInertia[i];
+    }
+
+    m_state.position = readVector(config["initialPosition"],
+                                  math::Vector3::ZERO);
+    m_state.orientation = math::Quaternion(
+        math::Degree(config["initialYaw"].asDouble(0)),
+        math::Vector3::UNIT_Z);
+}
+
+void VehicleDynamics::step(double timestep, const math::Vector3& force,
+                           const math::Vector3& torque)
+{
+    const math::Quaternion& orientation = m_state.orientation;
+    math::Quaternion toBody = orientation.UnitInverse();
+
+    // Drag is against the water, not the ground
+    math::Vector3 waterVelocity_b =
+        toBody * (m_state.velocity - m_current);
+    math::Vector3 omega = m_state.angularRate;
+
+    // Buoyancy fades as the vehicle rises out of the water
+    double buoyancy = m_buoyancy;
+    if (m_state.position[2] < 0)
+    {
+        double submerged = 1 + m_state.position[2] / SURFACE_HEIGHT;
+        buoyancy *= submerged > 0 ? submerged : 0;
+    }
+    math::Vector3 buoyancy_b =
+        toBody * math::Vector3(0, 0, -buoyancy);
+    math::Vector3 weight_b =
+        toBody * math::Vector3(0, 0, m_mass * GRAVITY);
+
+    math::Vector3 netForce_b = force + buoyancy_b + weight_b;
+    math::Vector3 netTorque_b = torque +
+        m_centerOfBuoyancy.crossProduct(buoyancy_b) -
+        omega.crossProduct(m_inertia * omega);
+
+    math::Vector3 accel_b;
+    math::Vector3 angularAccel_b;
+    for (int i = 0; i < 3; ++i)
+    {
+        double v = waterVelocity_b[i];
+        netForce_b[i] -= m_linearDrag[i] * v +
+            m_quadraticDrag[i] * std::fabs(v) * v;
+        accel_b[i] = netForce_b[i] / m_effectiveMass[i];
+
+        double w = omega[i];
+        netTorque_b[i] -= m_angularLinearDrag[i] * w +
+            m_angularQuadraticDrag[i] * std::fabs(w) * w;
+        angularAccel_b[i] = netTorque_b[i] / m_effectiveInertia[i];
+    }
+
+    // Semi-implicit Euler, the new rates move the body
+    m_state.acceleration = orientation * accel_b;
+    m_state.velocity += m_state.acceleration * timestep;
+    m_state.position += m_state.velocity * timestep;
+
+    m_state.angularRate += angularAccel_b * timestep;
+    math::Vector3 rotation = m_state.angularRate * timestep;
+    double angle = rotation.length();
+    if (angle > 0)
+    {
+        m_state.orientation = m_state.orientation *
+            math::Quaternion(math::Radian(angle), rotation / angle);
+        m_state.orientation.normalise();
+    }
+}
+
+const VehicleDynamics::State& VehicleDynamics::getState() const
+{
+    return m_state;
+}
+
+void VehicleDynamics::setState(const State& state)
+{
+    m_state = state;
+}
+
+double VehicleDynamics::getMass() const
+{
+    return m_mass;
+}
+
+math::Vector3 VehicleDynamics::readVector(core::ConfigNode node,
+                                          const math::Vector3& def)
+{
+    return math::Vector3(node[0].asDouble(def[0]),
+                         node[1].asDouble(def[1]),
+                         node[2].asDouble(def[2]));
+}
+
+} // namespace vehicle
+} // namespace ram
@@ -15,6 +15,7 @@
 #include <unistd.h>  // for open()
 
 // Library Includes
+#include <boost/bind.hpp>
 #include <log4cpp/Category.hh>
 
 // Project Includes
@@ -28,6 +29,9 @@
 #include "math/include/Vector3.h"
 #include "math/include/Events.h"
 
+#include "core/include/TimeVal.h"
+#include "core/include/LatencyTracker.h"
+
 #include "drivers/dvl/include/dvlapi.h"
 
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("DVL"));
@@ -50,9 +54,15 @@ DVL::DVL(core::ConfigNode config, core::EventHubPtr eventHub,
     m_serialFD(-1),
     m_dvlNum(config["num"].asInt(0)),
     m_location(0, 0, 0),
+    m_reactor(),
+    m_reactorID(-1),
+    m_lastPacketTime(0),
     m_rawState(0)
 {
-    m_rawState = new RawDVLData();
+    m_rawState = new core::Mailbox<RawDVLData>();
+
+    if (config["useReactor"].asInt(1))
+        m_reactor = SensorReactor::getShared();
 
     // Need an api before I can do this
     m_serialFD = openDVL(m_devfile.c_str());
@@ -68,8 +78,9 @@ DVL::DVL(core::ConfigNode config, core::EventHubPtr eventHub,
 
 DVL::~DVL()
 {
-    // Always make sure to shutdown the background thread
-    Updatable::unbackground(true);
+    // Always make sure to shutdown the background thread, or stop the
+    // reactor calling us
+    unbackground(true);
 
     // Only close file if its a non-negative number
     if (m_serialFD >= 0)
@@ -86,47 +97,7 @@ void DVL::update(double timestep)
     {
         RawDVLData newState;
         if (readDVLData(m_serialFD, &newState) == 0)
-        {
-            {
-                // Thread safe copy of good dvl data
-                core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
-                *m_rawState = newState;
-            }
-
-            int xVel = newState.xvel_btm;
-            int yVel = newState.yvel_btm;
-            double mmToMeters = 1.0 / 1000;
-            math::Vector2 velocity(yVel * mmToMeters, xVel * mmToMeters);
-
-            double cmToMeters = 1.0 / 100;
-            double beam1Range = newState.beam1_range * cmToMeters;
-            double beam2Range = newState.beam2_range * cmToMeters;
-            double beam3Range = newState.beam3_range * cmToMeters;
-            double beam4Range = newState.beam4_range * cmToMeters;
-
-            if(xVel != BAD_VELOCITY && yVel != BAD_VELOCITY)
-            {
-                RawDVLDataEventPtr velEvent = RawDVLDataEventPtr(
-                    new RawDVLDataEvent());
-
-                velEvent->velocity_b = velocity;
-                velEvent->timestep = timestep;
-            
-                publish(IVelocitySensor::RAW_UPDATE, velEvent);
-
-                RawBottomRangeEventPtr rangeEvent = RawBottomRangeEventPtr(
-                    new RawBottomRangeEvent());
-                
-                rangeEvent->rangeBeam1 = beam1Range;
-                rangeEvent->rangeBeam2 = beam2Range;
-                rangeEvent->rangeBeam3 = beam3Range;
-                rangeEvent->rangeBeam4 = beam4Range;
-
-                publish(IVelocitySensor::RAW_RANGE_UPDATE, rangeEvent);
-            }
-            LOGGER.infoStream() << velocity[0] << " "
-                                << velocity[1];
-        }
+            processState(newState, timestep, core::LatencyTracker::now());
     }
     // We didn't connect, try to reconnect
     else
@@ -135,6 +106,123 @@ void DVL::update(double timestep)
     }
 }
 
+void DVL::background(int interval)
+{
+    if (!m_reactor)
+    {
+        Updatable::background(interval);
+    }
+    else if (m_reactorID < 0)
+    {
+        // Registered even if the port did not open, so it is retried
+        m_reactorID = m_reactor->addDevice(
+            m_serialFD, boost::bind(&DVL::onData, this, _1, _2),
+            boost::bind(&DVL::reopen, this));
+    }
+}
+
+void DVL::unbackground(bool join)
+{
+    if (m_reactorID >= 0)
+    {
+        m_reactor->removeDevice(m_reactorID);
+        m_reactorID = -1;
+    }
+    Updatable::unbackground(join);
+}
+
+bool DVL::backgrounded()
+{
+    return (m_reactorID >= 0) || Updatable::backgrounded();
+}
+
+int DVL::reopen()
+{
+    if (m_serialFD >= 0)
+        close(m_serialFD);
+
+    m_serialFD = openDVL(m_devfile.c_str());
+    if (m_serialFD >= 0)
+        LOGGER.info("DVL reconnected with serial FD of %d", m_serialFD);
+    return m_serialFD;
+}
+
+size_t DVL::onData(const unsigned char* data, size_t length)
+{
+    // The bytes were read just before this was called
+    boost::int64_t arrival = core::LatencyTracker::now();
+    size_t used = 0;
+    while (used < length)
+    {
+        RawDVLData newState;
+        int consumed = 0;
+        int result = dvl_parsePacket(data + used, length - used, &newState,
+                                     &consumed);
+        used += consumed;
+
+        if (0 == result)
+            break;
+        if (result < 0)
+        {
+            LOGGER.warn("Bad DVL packet, error %d", -result);
+            continue;
+        }
+
+        double now = core::TimeVal::timeOfDay().get_double();
+        double timestep = (m_lastPacketTime > 0) ?
+            (now - m_lastPacketTime) : 0;
+        m_lastPacketTime = now;
+        processState(newState, timestep, arrival);
+    }
+    return used;
+}
+
+void DVL::processState(const RawDVLData& newState, double timestep,
+                       boost::int64_t arrival)
+{
+    m_rawState->write(newState);
+
+    int xVel = newState.xvel_btm;
+    int yVel = newState.yvel_btm;
+    double mmToMeters = 1.0 / 1000;
+    math::Vector2 velocity(yVel * mmToMeters, xVel * mmToMeters);
+
+    double cmToMeters = 1.0 / 100;
+    double beam1Range = newState.beam1_range * cmToMeters;
+    double beam2Range = newState.beam2_range * cmToMeters;
+    double beam3Range = newState.beam3_range * cmToMeters;
+    double beam4Range = newState.beam4_range * cmToMeters;
+
+    if(xVel != BAD_VELOCITY && yVel != BAD_VELOCITY)
+    {
+        RawDVLDataEventPtr velEvent = RawDVLDataEventPtr(
+            new RawDVLDataEvent());
+
+        velEvent->name = getName();
+        velEvent->sensorID = getSensorID();
+        velEvent->velocity_b = velocity;
+        velEvent->timestep = timestep;
+        velEvent->arrivalTime = arrival;
+
+        core::LatencyTracker::record(getName(), core::LatencyTracker::DRIVER,
+                                     arrival);
+        publish(IVelocitySensor::RAW_UPDATE, velEvent);
+
+        RawBottomRangeEventPtr rangeEvent = RawBottomRangeEventPtr(
+            new RawBottomRangeEvent());
+        
+        rangeEvent->rangeBeam1 = beam1Range;
+        rangeEvent->rangeBeam2 = beam2Range;
+        rangeEvent->rangeBeam3 = beam3Range;
+        rangeEvent->rangeBeam4 = beam4Range;
+        rangeEvent->arrivalTime = arrival;
+
+        publish(IVelocitySensor::RAW_RANGE_UPDATE, rangeEvent);
+    }
+    LOGGER.infoStream() << velocity[0] << " "
+                        << velocity[1];
+}
+
 math::Vector3 DVL::getLocation()
 {
     return m_location;
@@ -142,8 +230,7 @@ math::Vector3 DVL::getLocation()
 
 void DVL::getRawState(RawDVLData& dvlState)
 {
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    dvlState = *m_rawState;
+    m_rawState->read(dvlState);
 }
 
 } // namespace device
@@ -14,13 +14,15 @@
 
 // Project Includes
 #include "vehicle/include/device/Device.h"
+#include "vehicle/include/device/SensorRegistry.h"
 
 namespace ram {
 namespace vehicle {
 namespace device {
 
 Device::Device(std::string name) :
-    m_name(name)
+    m_name(name),
+    m_sensorID(SensorRegistry::intern(name))
 {
     assert("None" != name && "Name cannot be 'None'");
 }
@@ -29,6 +31,11 @@ std::string Device::getName()
 {
     return m_name;
 }
+
+int Device::getSensorID()
+{
+    return m_sensorID;
+}
     
 } // namespace device
 } // namespace vehicle
@@ -32,6 +32,10 @@
 #endif // RAM_WITH_DRIVERS
 
 #include "vehicle/include/device/LoopStateEstimator.h"
+#include "vehicle/include/device/SimThruster.h"
+#include "vehicle/include/device/SimIMU.h"
+#include "vehicle/include/device/SimDVL.h"
+#include "vehicle/include/device/SimDepthSensor.h"
 
 #ifdef RAM_WITH_VISION
 #include "vehicle/include/device/VisionVelocitySensor.h"
@@ -65,6 +69,12 @@ RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::SBGrabber,
 
 RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::LoopStateEstimator,
 				   LoopStateEstimator);
+RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::SimThruster,
+                                   SimThruster);
+RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::SimIMU, SimIMU);
+RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::SimDVL, SimDVL);
+RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::SimDepthSensor,
+                                   SimDepthSensor);
 
 #ifdef RAM_WITH_VISION
 RAM_VEHILCE_REGISTER_IDEVICE_MAKER(ram::vehicle::device::VisionVelocitySensor,
@@ -15,6 +15,7 @@
 #include <unistd.h>  // for open()
 
 // Library Includes
+#include <boost/bind.hpp>
 #include <log4cpp/Category.hh>
 
 // Project Includes
@@ -27,6 +28,9 @@
 #include "math/include/Matrix3.h"
 #include "math/include/Events.h"
 
+#include "core/include/TimeVal.h"
+#include "core/include/LatencyTracker.h"
+
 #include "drivers/imu/include/imuapi.h"
 
 static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("IMU"));
@@ -53,10 +57,16 @@ IMU::IMU(core::ConfigNode config, core::EventHubPtr eventHub,
     m_gyroZBias(0),
     m_magCorruptThresh(100),
     m_magNominalLength(0),
+    m_reactor(),
+    m_reactorID(-1),
+    m_lastFrameTime(0),
     m_rawState(0)
 {
     m_serialFD = openIMU(m_devfile.c_str());
-    m_rawState = new RawIMUData();
+    m_rawState = new core::Mailbox<RawIMUData>();
+
+    if (config["useReactor"].asInt(1))
+        m_reactor = SensorReactor::getShared();
 
     // Load Rotation Matrix
     m_IMUToVehicleFrame[0][0] =
@@ -100,14 +110,18 @@ IMU::IMU(core::ConfigNode config, core::EventHubPtr eventHub,
     LOGGER.info("% IMU#(0=main,1=boom) Accel Mag Gyro TimeStamp");
 
     // what is the purpose of this?
-    for (int i = 0; i < 5; ++i)
-        update(1/50.0);
+    if (!m_reactor)
+    {
+        for (int i = 0; i < 5; ++i)
+            update(1/50.0);
+    }
 }
 
 IMU::~IMU()
 {
-    // Always make sure to shut down the background thread
-    Updatable::unbackground(true);
+    // Always make sure to shut down the background thread, or stop the
+    // reactor calling us
+    unbackground(true);
 
     // Only close file if its a non-negative number
     if (m_serialFD >= 0)
@@ -125,80 +139,156 @@ void IMU::update(double timestep)
         // Grab latest state from vehicle
         RawIMUData newState;
         if (readIMUData(m_serialFD, &newState))
+            processState(newState, timestep, core::LatencyTracker::now());
+    }
+}
+
+void IMU::background(int interval)
+{
+    if (!m_reactor)
+    {
+        Updatable::background(interval);
+    }
+    else if (m_reactorID < 0)
+    {
+        // Registered even if the port did not open, so it is retried
+        m_reactorID = m_reactor->addDevice(
+            m_serialFD, boost::bind(&IMU::onData, this, _1, _2),
+            boost::bind(&IMU::reopen, this));
+    }
+}
+
+void IMU::unbackground(bool join)
+{
+    if (m_reactorID >= 0)
+    {
+        m_reactor->removeDevice(m_reactorID);
+        m_reactorID = -1;
+    }
+    Updatable::unbackground(join);
+}
+
+bool IMU::backgrounded()
+{
+    return (m_reactorID >= 0) || Updatable::backgrounded();
+}
+
+int IMU::reopen()
+{
+    if (m_serialFD >= 0)
+        close(m_serialFD);
+
+    m_serialFD = openIMU(m_devfile.c_str());
+    if (m_serialFD >= 0)
+        LOGGER.info("IMU reconnected with serial FD of %d", m_serialFD);
+    return m_serialFD;
+}
+
+size_t IMU::onData(const unsigned char* data, size_t length)
+{
+    // The bytes were read just before this was called
+    boost::int64_t arrival = core::LatencyTracker::now();
+    size_t used = 0;
+    while (used < length)
+    {
+        RawIMUData newState;
+        int consumed = 0;
+        int result = imu_parseFrame(data + used, length - used, &newState,
+                                    &consumed);
+        used += consumed;
+
+        if (0 == result)
+            break;
+        if (result < 0)
         {
-            {
-                // Thread safe copy of good imu data
-                core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
-                *m_rawState = newState;
-            }
-
-            /* Take the raw data, put it into OGRE format applying the
-             * bias corrections.
-             */
-            math::Vector3 linearAccel_debiased(newState.accelX,
-                                               newState.accelY,
-                                               newState.accelZ);
-
-            math::Vector3 mag_debiased(newState.magX - m_magXBias,
-                                       newState.magY - m_magYBias,
-                                       newState.magZ - m_magZBias);
-
-            math::Vector3 gyro_debiased(newState.gyroX - m_gyroXBias,
-                                        newState.gyroY - m_gyroYBias,
-                                        newState.gyroZ - m_gyroZBias);
-
-            math::Matrix3 imuToVehicleFrame(m_IMUToVehicleFrame);
-
-            /* Rotate the data from the IMU frame to the vehicle frame */
-            math::Vector3 rotatedLinearAccel = 
-                imuToVehicleFrame * linearAccel_debiased;
-
-            math::Vector3 rotatedMagnetometer = 
-                imuToVehicleFrame * mag_debiased;
-
-            math::Vector3 rotatedGyro = 
-                imuToVehicleFrame * gyro_debiased;
-
-
-            RawIMUData rotatedState;
-            rotatedState.accelX = rotatedLinearAccel[0];
-            rotatedState.accelY = rotatedLinearAccel[1];
-            rotatedState.accelZ = rotatedLinearAccel[2];
-
-            rotatedState.magX = rotatedMagnetometer[0];
-            rotatedState.magY = rotatedMagnetometer[1];
-            rotatedState.magZ = rotatedMagnetometer[2];
-
-            rotatedState.gyroX = rotatedGyro[0];
-            rotatedState.gyroY = rotatedGyro[1];
-            rotatedState.gyroZ = rotatedGyro[2];
-
-            RawIMUDataEventPtr event = RawIMUDataEventPtr(
-                new RawIMUDataEvent());
-            event->name = getName();
-            event->rawIMUData = rotatedState;
-            event->magIsCorrupt = false;
-            event->timestep = timestep;
-            publish(IIMU::RAW_UPDATE, event);
-
-            LOGGER.infoStream() << m_imuNum << " "
-                                << rotatedState.accelX << " "
-                                << rotatedState.accelY << " "
-                                << rotatedState.accelZ << " "
-                                << rotatedState.magX << " "
-                                << rotatedState.magY << " "
-                                << rotatedState.magZ << " "
-                                << rotatedState.gyroX << " "
-                                << rotatedState.gyroY << " "
-                                << rotatedState.gyroZ;
+            LOGGER.warn("Bad IMU checksum");
+            continue;
         }
+
+        // Frames are published as they arrive, so time them on arrival
+        double now = core::TimeVal::timeOfDay().get_double();
+        double timestep = (m_lastFrameTime > 0) ?
+            (now - m_lastFrameTime) : 1/50.0;
+        m_lastFrameTime = now;
+        processState(newState, timestep, arrival);
     }
+    return used;
+}
+
+void IMU::processState(const RawIMUData& newState, double timestep,
+                       boost::int64_t arrival)
+{
+    // Readers never hold this up, however often they look
+    m_rawState->write(newState);
+
+    /* Take the raw data, put it into OGRE format applying the
+     * bias corrections.
+     */
+    math::Vector3 linearAccel_debiased(newState.accelX,
+                                       newState.accelY,
+                                       newState.accelZ);
+
+    math::Vector3 mag_debiased(newState.magX - m_magXBias,
+                               newState.magY - m_magYBias,
+                               newState.magZ - m_magZBias);
+
+    math::Vector3 gyro_debiased(newState.gyroX - m_gyroXBias,
+                                newState.gyroY - m_gyroYBias,
+                                newState.gyroZ - m_gyroZBias);
+
+    math::Matrix3 imuToVehicleFrame(m_IMUToVehicleFrame);
+
+    /* Rotate the data from the IMU frame to the vehicle frame */
+    math::Vector3 rotatedLinearAccel = 
+        imuToVehicleFrame * linearAccel_debiased;
+
+    math::Vector3 rotatedMagnetometer = 
+        imuToVehicleFrame * mag_debiased;
+
+    math::Vector3 rotatedGyro = 
+        imuToVehicleFrame * gyro_debiased;
+
+
+    RawIMUData rotatedState;
+    rotatedState.accelX = rotatedLinearAccel[0];
+    rotatedState.accelY = rotatedLinearAccel[1];
+    rotatedState.accelZ = rotatedLinearAccel[2];
+
+    rotatedState.magX = rotatedMagnetometer[0];
+    rotatedState.magY = rotatedMagnetometer[1];
+    rotatedState.magZ = rotatedMagnetometer[2];
+
+    rotatedState.gyroX = rotatedGyro[0];
+    rotatedState.gyroY = rotatedGyro[1];
+    rotatedState.gyroZ = rotatedGyro[2];
+
+    RawIMUDataEventPtr event = RawIMUDataEventPtr(
+        new RawIMUDataEvent());
+    event->name = getName();
+    event->sensorID = getSensorID();
+    event->rawIMUData = rotatedState;
+    event->magIsCorrupt = false;
+    event->timestep = timestep;
+    event->arrivalTime = arrival;
+    core::LatencyTracker::record(getName(), core::LatencyTracker::DRIVER,
+                                 arrival);
+    publish(IIMU::RAW_UPDATE, event);
+
+    LOGGER.infoStream() << m_imuNum << " "
+                        << rotatedState.accelX << " "
+                        << rotatedState.accelY << " "
+                        << rotatedState.accelZ << " "
+                        << rotatedState.magX << " "
+                        << rotatedState.magY << " "
+                        << rotatedState.magZ << " "
+                        << rotatedState.gyroX << " "
+                        << rotatedState.gyroY << " "
+                        << rotatedState.gyroZ;
 }
     
 void IMU::getRawState(RawIMUData& imuState)
 {
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    imuState = *m_rawState;
+    m_rawState->read(imuState);
 }
    
 } // namespace device
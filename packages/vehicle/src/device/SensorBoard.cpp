@@ -23,6 +23,8 @@
 
 #include "math/include/Events.h"
 
+#include "core/include/LatencyTracker.h"
+
 
 RAM_CORE_EVENT_TYPE(ram::vehicle::device::SensorBoard, POWERSOURCE_UPDATE);
 RAM_CORE_EVENT_TYPE(ram::vehicle::device::SensorBoard, TEMPSENSOR_UPDATE);
@@ -72,12 +74,12 @@ SensorBoard::SensorBoard(int deviceFD,
                                config["depthSensorLocation"][1].asDouble(0),
                                config["depthSensorLocation"][2].asDouble(0));
 
-    m_state.thrusterValues[0] = 0;
-    m_state.thrusterValues[1] = 0;
-    m_state.thrusterValues[2] = 0;
-    m_state.thrusterValues[3] = 0;
-    m_state.thrusterValues[4] = 0;
-    m_state.thrusterValues[5] = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        m_thrusterValues[i] = 0;
+        m_state.thrusterValues[i] = 0;
+    }
+    m_state.mainBusVoltage = 0;
 
     m_servo1FirePosition = config["servo1FirePosition"].asInt(4000);
     m_servo2FirePosition = config["servo2FirePosition"].asInt(4000);
@@ -109,12 +111,12 @@ SensorBoard::SensorBoard(core::ConfigNode config,
                                config["depthSensorLocation"][1].asDouble(0),
                                config["depthSensorLocation"][2].asDouble(0));
 
-    m_state.thrusterValues[0] = 0;
-    m_state.thrusterValues[1] = 0;
-    m_state.thrusterValues[2] = 0;
-    m_state.thrusterValues[3] = 0;
-    m_state.thrusterValues[4] = 0;
-    m_state.thrusterValues[5] = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        m_thrusterValues[i] = 0;
+        m_state.thrusterValues[i] = 0;
+    }
+    m_state.mainBusVoltage = 0;
 
     m_servo1FirePosition = config["servo1FirePosition"].asInt(4000);
     m_servo2FirePosition = config["servo2FirePosition"].asInt(4000);
@@ -145,15 +147,18 @@ SensorBoard::~SensorBoard()
 
 void SensorBoard::update(double timestep)
 {
-    // Copy the values to local state
-    VehicleState state;
+    // The state is only ever touched here, so it needs no copying in and
+    // out, just take the latest thruster commands
+    VehicleState& state = m_state;
     {
-        core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-        state = m_state;
+        boost::mutex::scoped_lock lock(m_thrusterMutex);
+        for (int i = 0; i < 6; ++i)
+            state.thrusterValues[i] = m_thrusterValues[i];
     }
 
     int partialRet = SB_ERROR;
     double depth = 0;
+    boost::int64_t arrival = 0;
     {
         boost::mutex::scoped_lock lock(m_deviceMutex);
     
@@ -164,12 +169,17 @@ void SensorBoard::update(double timestep)
                   state.thrusterValues[3],
                   state.thrusterValues[4],
                   state.thrusterValues[5]);
+
+        // The speeds are based on whatever sensor data the controller used
+        core::LatencyTracker::forward(core::LatencyTracker::THRUSTERS,
+                                      core::LatencyTracker::CONTROLLER);
     
         // Do a partial read
         partialRet = partialRead(&state.telemetry);
     
         // Now read depth and set its state
         int ret = readDepth();
+        arrival = core::LatencyTracker::now();
         depth = (((double)ret) - m_depthCalibIntercept) / m_depthCalibSlope;
         state.depth = depth;
     } // end deviceMutex lock
@@ -184,6 +194,9 @@ void SensorBoard::update(double timestep)
     rawEvent->rawDepth = depth;
     rawEvent->sensorLocation = m_location;
     rawEvent->timestep = timestep;
+    rawEvent->arrivalTime = arrival;
+    core::LatencyTracker::record(getName(), core::LatencyTracker::DRIVER,
+                                 arrival);
     publish(IDepthSensor::RAW_UPDATE, rawEvent);
 
     // If we got the battery use status or the latest voltages recompute bus
@@ -248,10 +261,21 @@ void SensorBoard::update(double timestep)
                        (int)state.telemetry.temperature[6]);
     } // end partialRet == SB_UPDATEDONE
     
-    // Copy the values back
+    // Hand the getters a new status only when it changes
+    BoardStatus status;
+    status.thrusterState = state.telemetry.thrusterState;
+    status.battEnabled = state.telemetry.battEnabled;
+    status.battUsed = state.telemetry.battUsed;
+    status.mainBusVoltage = state.mainBusVoltage;
+
+    BoardStatus published;
+    m_status.read(published);
+    if ((status.thrusterState != published.thrusterState) ||
+        (status.battEnabled != published.battEnabled) ||
+        (status.battUsed != published.battUsed) ||
+        (status.mainBusVoltage != published.mainBusVoltage))
     {
-        core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
-        m_state = state;
+        m_status.write(status);
     }
 }
 
@@ -264,8 +288,8 @@ math::Vector3 SensorBoard::getLocation()
 void SensorBoard::setThrusterValue(int address, int count)
 {
     assert((0 <= address) && (address < 6) && "Address out of range");
-    core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
-    m_state.thrusterValues[address] = count;
+    boost::mutex::scoped_lock lock(m_thrusterMutex);
+    m_thrusterValues[address] = count;
 }
 
 bool SensorBoard::isThrusterEnabled(int address)
@@ -281,8 +305,9 @@ bool SensorBoard::isThrusterEnabled(int address)
 
     assert((0 <= address) && (address < 6) && "Address out of range");
 
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    return (0 != (addressToEnable[address] & m_state.telemetry.thrusterState));
+    BoardStatus status;
+    m_status.read(status);
+    return (0 != (addressToEnable[address] & status.thrusterState));
 }
 
 void SensorBoard::setThrusterEnable(int address, bool state)
@@ -337,8 +362,9 @@ bool SensorBoard::isPowerSourceEnabled(int address)
 
     assert((0 <= address) && (address < 6) && "Address out of range");
 
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    return (0 != (addressToEnable[address] & m_state.telemetry.battEnabled));
+    BoardStatus status;
+    m_status.read(status);
+    return (0 != (addressToEnable[address] & status.battEnabled));
 }
 
 bool SensorBoard::isPowerSourceInUse(int address)
@@ -354,8 +380,9 @@ bool SensorBoard::isPowerSourceInUse(int address)
 
     assert((0 <= address) && (address < 6) && "Address out of range");
 
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    return (0 != (addressToEnable[address] & m_state.telemetry.battUsed));
+    BoardStatus status;
+    m_status.read(status);
+    return (0 != (addressToEnable[address] & status.battUsed));
 }
 
 void SensorBoard::setPowerSouceEnabled(int address, bool state)
@@ -405,8 +432,9 @@ void SensorBoard::setDVLPowerEnabled(bool state)
 
 double SensorBoard::getMainBusVoltage()
 {
-    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
-    return m_state.mainBusVoltage;
+    BoardStatus status;
+    m_status.read(status);
+    return status.mainBusVoltage;
 }
 
 int SensorBoard::dropMarker()
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SensorReactor.cpp
+ */
+
+// STD Includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+// UNIX Includes
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef RAM_LINUX
+  #include <sys/epoll.h>
+#else
+  #include <poll.h>
+#endif // RAM_LINUX
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <log4cpp/Category.hh>
+
+// Project Includes
+#include "vehicle/include/device/SensorReactor.h"
+
+static log4cpp::Category& LOGGER(
+    log4cpp::Category::getInstance("SensorReactor"));
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+const size_t SensorReactor::BUFFER_SIZE;
+const int SensorReactor::RETRY_MS;
+
+// Events handled per wait
+static const int MAX_EVENTS = 16;
+
+// Device ids start at 1, the wakeup pipe is waited on as 0
+static const int WAKEUP_ID = 0;
+
+static boost::mutex s_sharedMutex;
+static boost::weak_ptr<SensorReactor> s_shared;
+
+static void setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static boost::posix_time::ptime now()
+{
+    return boost::posix_time::microsec_clock::universal_time();
+}
+
+SensorReactor::SensorReactor() :
+    m_nextID(WAKEUP_ID + 1),
+    m_servicing(false),
+    m_passes(0),
+    m_epollFD(-1),
+    m_running(false),
+    m_thread(0)
+{
+    m_wakeupPipe[0] = -1;
+    m_wakeupPipe[1] = -1;
+    if (pipe(m_wakeupPipe) == 0)
+    {
+        setNonBlocking(m_wakeupPipe[0]);
+        setNonBlocking(m_wakeupPipe[1]);
+    }
+    else
+    {
+        LOGGER.errorStream() << "Could not create wakeup pipe: "
+                             << strerror(errno);
+    }
+
+#ifdef RAM_LINUX
+    m_epollFD = epoll_create(MAX_EVENTS);
+    if (m_epollFD < 0)
+    {
+        LOGGER.errorStream() << "Could not create epoll instance: "
+                             << strerror(errno);
+    }
+    else if (m_wakeupPipe[0] >= 0)
+    {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = WAKEUP_ID;
+        epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_wakeupPipe[0], &event);
+    }
+#endif // RAM_LINUX
+}
+
+SensorReactor::~SensorReactor()
+{
+    stop();
+
+    if (m_epollFD >= 0)
+        close(m_epollFD);
+    if (m_wakeupPipe[0] >= 0)
+        close(m_wakeupPipe[0]);
+    if (m_wakeupPipe[1] >= 0)
+        close(m_wakeupPipe[1]);
+}
+
+SensorReactorPtr SensorReactor::getShared()
+{
+    boost::mutex::scoped_lock lock(s_sharedMutex);
+    SensorReactorPtr reactor = s_shared.lock();
+    if (!reactor)
+    {
+        reactor = SensorReactorPtr(new SensorReactor());
+        reactor->start();
+        s_shared = reactor;
+    }
+    return reactor;
+}
+
+void SensorReactor::start()
+{
+    if (m_thread)
+        return;
+
+    m_running = true;
+    m_thread = new boost::thread(boost::bind(&SensorReactor::loop, this));
+}
+
+void SensorReactor::stop()
+{
+    if (!m_thread)
+        return;
+
+    m_running = false;
+    wakeup();
+    m_thread->join();
+    delete m_thread;
+    m_thread = 0;
+}
+
+int SensorReactor::addDevice(int fd, DataHandler handler,
+                             ReopenHandler reopen)
+{
+    DevicePtr device(new Device());
+    device->fd = fd;
+    device->handler = handler;
+    device->reopen = reopen;
+    // Not opened yet, so try on the next pass
+    device->retryTime = now();
+    {
+        boost::mutex::scoped_lock lock(m_devicesMutex);
+        device->id = m_nextID++;
+        m_devices[device->id] = device;
+    }
+
+    if (fd >= 0)
+        watch(*device);
+    else
+        wakeup();
+    return device->id;
+}
+
+void SensorReactor::removeDevice(int id)
+{
+    boost::mutex::scoped_lock lock(m_devicesMutex);
+    DeviceMap::iterator iter = m_devices.find(id);
+    if (m_devices.end() == iter)
+        return;
+
+    DevicePtr device = iter->second;
+    device->removed = true;
+    if (device->fd >= 0)
+        unwatch(*device);
+
+    if (m_servicing)
+    {
+        // A handler removing a device, maybe its own, can't wait on itself
+        if (boost::this_thread::get_id() == m_servicingThread)
+        {
+            m_pendingRemovals.push_back(id);
+            return;
+        }
+
+        // Wait for a handler which is running to return
+        unsigned long pass = m_passes;
+        while (m_servicing && (pass == m_passes))
+            m_passDone.wait(lock);
+    }
+    m_devices.erase(id);
+}
+
+size_t SensorReactor::getDeviceCount()
+{
+    boost::mutex::scoped_lock lock(m_devicesMutex);
+    return m_devices.size();
+}
+
+int SensorReactor::poll(int timeoutMS)
+{
+    std::vector<int> ready;
+
+#ifdef RAM_LINUX
+    struct epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(m_epollFD, events, MAX_EVENTS, timeoutMS);
+    for (int i = 0; i < count; ++i)
+        ready.push_back(events[i].data.u32);
+#else
+    std::vector<struct pollfd> fds;
+    std::vector<int> ids;
+    {
+        boost::mutex::scoped_lock lock(m_devicesMutex);
+        struct pollfd pfd;
+        pfd.fd = m_wakeupPipe[0];
+        pfd.events = POLLIN;
+        fds.push_back(pfd);
+        ids.push_back(WAKEUP_ID);
+        BOOST_FOREACH(DeviceMap::value_type pair, m_devices)
+        {
+            if (pair.second->fd < 0)
+                continue;
+            pfd.fd = pair.second->fd;
+            fds.push_back(pfd);
+            ids.push_back(pair.first);
+        }
+    }
+
+    int count = ::poll(&fds[0], fds.size(), timeoutMS);
+    for (size_t i = 0; (count > 0) && (i < fds.size()); ++i)
+    {
+        if (fds[i].revents)
+            ready.push_back(ids[i]);
+    }
+#endif // RAM_LINUX
+
+    std::vector<DevicePtr> devices;
+    {
+        boost::mutex::scoped_lock lock(m_devicesMutex);
+        m_servicing = true;
+        m_servicingThread = boost::this_thread::get_id();
+        BOOST_FOREACH(int id, ready)
+        {
+            DeviceMap::iterator iter = m_devices.find(id);
+            if (m_devices.end() != iter)
+                devices.push_back(iter->second);
+        }
+    }
+
+    if (std::find(ready.begin(), ready.end(), WAKEUP_ID) != ready.end())
+    {
+        char buffer[64];
+        while (read(m_wakeupPipe[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    int serviced = 0;
+    BOOST_FOREACH(DevicePtr device, devices)
+    {
+        // Removed since the wait returned, or by an earlier handler
+        if (device->removed || (device->fd < 0))
+            continue;
+
+        serviced++;
+        if (!service(*device) && !device->removed)
+            closed(*device);
+    }
+
+    reopenDevices();
+
+    boost::mutex::scoped_lock lock(m_devicesMutex);
+    BOOST_FOREACH(int id, m_pendingRemovals)
+        m_devices.erase(id);
+    m_pendingRemovals.clear();
+    m_servicing = false;
+    m_passes++;
+    m_passDone.notify_all();
+
+    return serviced;
+}
+
+bool SensorReactor::service(Device& device)
+{
+    while (true)
+    {
+        // Make room at the end of the buffer
+        if (BUFFER_SIZE == device.end)
+        {
+            if (0 == device.start)
+            {
+                LOGGER.warnStream() << "fd " << device.fd << " dropped "
+                                    << BUFFER_SIZE << " unparsable bytes";
+                device.end = 0;
+            }
+            else
+            {
+                memmove(device.buffer, device.buffer + device.start,
+                        device.end - device.start);
+                device.end -= device.start;
+                device.start = 0;
+            }
+        }
+
+        ssize_t bytes = read(device.fd, device.buffer + device.end,
+                             BUFFER_SIZE - device.end);
+        if (bytes > 0)
+        {
+            device.end += bytes;
+            size_t consumed = device.handler(device.buffer + device.start,
+                                             device.end - device.start);
+            device.start += std::min(consumed, device.end - device.start);
+            if (device.start == device.end)
+            {
+                device.start = 0;
+                device.end = 0;
+            }
+
+            // The handler removed its own device
+            if (device.removed)
+                return true;
+        }
+        else if (0 == bytes)
+        {
+            return false;
+        }
+        else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            return true;
+        }
+        else if (EINTR != errno)
+        {
+            return false;
+        }
+    }
+}
+
+void SensorReactor::watch(Device& device)
+{
+    setNonBlocking(device.fd);
+
+#ifdef RAM_LINUX
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = device.id;
+    if (epoll_ctl(m_epollFD, EPOLL_CTL_ADD, device.fd, &event) != 0)
+    {
+        LOGGER.errorStream() << "Could not watch fd " << device.fd << ": "
+                             << strerror(errno);
+    }
+#else
+    // Have poll() pick up the new descriptor
+    wakeup();
+#endif // RAM_LINUX
+}
+
+void SensorReactor::unwatch(Device& device)
+{
+#ifdef RAM_LINUX
+    epoll_ctl(m_epollFD, EPOLL_CTL_DEL, device.fd, 0);
+#endif // RAM_LINUX
+}
+
+void SensorReactor::closed(Device& device)
+{
+    unwatch(device);
+
+    if (!device.reopen)
+    {
+        LOGGER.warnStream() << "fd " << device.fd << " closed, no longer "
+                            << "watching it";
+        boost::mutex::scoped_lock lock(m_devicesMutex);
+        m_pendingRemovals.push_back(device.id);
+        return;
+    }
+
+    LOGGER.warnStream() << "fd " << device.fd << " closed, reopening it";
+    // Bytes of the old connection don't continue on the new one
+    device.start = 0;
+    device.end = 0;
+    device.retryTime = now() + boost::posix_time::milliseconds(RETRY_MS);
+    boost::mutex::scoped_lock lock(m_devicesMutex);
+    device.fd = -1;
+}
+
+void SensorReactor::reopenDevices()
+{
+    std::vector<DevicePtr> due;
+    boost::posix_time::ptime current = now();
+    {
+        boost::mutex::scoped_lock lock(m_devicesMutex);
+        BOOST_FOREACH(DeviceMap::value_type pair, m_devices)
+        {
+            DevicePtr device = pair.second;
+            if ((device->fd < 0) && device->reopen && !device->removed &&
+                (device->retryTime <= current))
+            {
+                due.push_back(device);
+            }
+        }
+    }
+
+    BOOST_FOREACH(DevicePtr device, due)
+    {
+        int fd = device->reopen();
+        if (device->removed)
+            continue;
+
+        if (fd < 0)
+        {
+            device->retryTime = current +
+                boost::posix_time::milliseconds(RETRY_MS);
+            continue;
+        }
+
+        LOGGER.infoStream() << "Reopened device as fd " << fd;
+        {
+            boost::mutex::scoped_lock lock(m_devicesMutex);
+            device->fd = fd;
+        }
+        watch(*device);
+    }
+}
+
+void SensorReactor::loop()
+{
+    // Wakes up now and then to reopen closed devices
+    while (m_running)
+        poll(RETRY_MS);
+}
+
+void SensorReactor::wakeup()
+{
+    char byte = 0;
+    if (write(m_wakeupPipe[1], &byte, 1) < 0)
+    {
+        // Already full, so the reactor wakes anyway
+    }
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SensorRegistry.cpp
+ */
+
+// STD Includes
+#include <map>
+#include <vector>
+
+// Library Includes
+#include <boost/thread/mutex.hpp>
+
+// Project Includes
+#include "vehicle/include/device/SensorRegistry.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+namespace {
+
+struct RegistryState
+{
+    boost::mutex mutex;
+    std::map<std::string, int> ids;
+    std::vector<std::string> names;
+};
+
+/** Never freed, IDs stay valid until the process ends, even for consumers
+ *  which look names up while being destroyed */
+RegistryState& getState()
+{
+    static RegistryState* state = new RegistryState();
+    return *state;
+}
+
+} // namespace
+
+const int SensorRegistry::UNKNOWN;
+
+int SensorRegistry::intern(const std::string& name)
+{
+    RegistryState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    std::map<std::string, int>::iterator iter = state.ids.find(name);
+    if (state.ids.end() != iter)
+        return iter->second;
+
+    int id = (int)state.names.size();
+    state.names.push_back(name);
+    state.ids[name] = id;
+    return id;
+}
+
+std::string SensorRegistry::getName(int id)
+{
+    RegistryState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    if (id < 0 || id >= (int)state.names.size())
+        return "";
+    return state.names[id];
+}
+
+int SensorRegistry::count()
+{
+    RegistryState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return (int)state.names.size();
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SimDVL.cpp
+ */
+
+// Project Includes
+#include "vehicle/include/device/SimDVL.h"
+#include "vehicle/include/VehicleDynamics.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+SimDVL::SimDVL(core::ConfigNode config, core::EventHubPtr eventHub,
+               IVehiclePtr vehicle) :
+    Device(config["name"].asString()),
+    IVelocitySensor(eventHub, config["name"].asString()),
+    SimSensor(config, 50),
+    m_location(config["location"][0].asDouble(0),
+               config["location"][1].asDouble(0),
+               config["location"][2].asDouble(0)),
+    m_velocityNoise(config["velocityNoise"].asDouble(0))
+{
+}
+
+SimDVL::~SimDVL()
+{
+}
+
+math::Vector3 SimDVL::getLocation()
+{
+    return m_location;
+}
+
+void SimDVL::sample(const VehicleDynamics& dynamics, double timestep)
+{
+    const VehicleDynamics::State& state = dynamics.getState();
+    math::Vector3 velocity = state.orientation.UnitInverse() * state.velocity +
+        state.angularRate.crossProduct(m_location);
+
+    RawDVLDataEventPtr event = m_events.acquire();
+    event->name = getName();
+    event->sensorID = getSensorID();
+    event->velocity_b = math::Vector2(velocity[0] + noise(m_velocityNoise),
+                                      velocity[1] + noise(m_velocityNoise));
+    event->angularOffset = 0;
+    event->timestep = timestep;
+    publish(IVelocitySensor::RAW_UPDATE, event);
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SimDepthSensor.cpp
+ */
+
+// Project Includes
+#include "vehicle/include/device/SimDepthSensor.h"
+#include "vehicle/include/VehicleDynamics.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+SimDepthSensor::SimDepthSensor(core::ConfigNode config,
+                               core::EventHubPtr eventHub,
+                               IVehiclePtr vehicle) :
+    Device(config["name"].asString()),
+    IDepthSensor(eventHub, config["name"].asString()),
+    SimSensor(config, 20),
+    m_location(config["location"][0].asDouble(0),
+               config["location"][1].asDouble(0),
+               config["location"][2].asDouble(0)),
+    m_depthNoise(config["depthNoise"].asDouble(0))
+{
+}
+
+SimDepthSensor::~SimDepthSensor()
+{
+}
+
+math::Vector3 SimDepthSensor::getLocation()
+{
+    return m_location;
+}
+
+void SimDepthSensor::sample(const VehicleDynamics& dynamics, double timestep)
+{
+    const VehicleDynamics::State& state = dynamics.getState();
+    math::Vector3 offset = state.orientation * m_location - m_location;
+
+    RawDepthSensorDataEventPtr event = m_events.acquire();
+    event->name = getName();
+    event->rawDepth = state.position[2] + offset[2] + noise(m_depthNoise);
+    event->sensorLocation = m_location;
+    event->timestep = timestep;
+    publish(IDepthSensor::RAW_UPDATE, event);
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
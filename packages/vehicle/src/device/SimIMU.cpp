@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SimIMU.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Project Includes
+#include "vehicle/include/device/SimIMU.h"
+#include "vehicle/include/VehicleDynamics.h"
+#include "math/include/Math.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+static const double GRAVITY = 9.80665;
+
+SimIMU::SimIMU(core::ConfigNode config, core::EventHubPtr eventHub,
+               IVehiclePtr vehicle) :
+    Device(config["name"].asString()),
+    IIMU(eventHub, config["name"].asString()),
+    SimSensor(config, 5),
+    m_accelNoise(config["accelNoise"].asDouble(0)),
+    m_gyroNoise(config["gyroNoise"].asDouble(0)),
+    m_magNoise(config["magNoise"].asDouble(0)),
+    m_magneticField(math::Vector3::ZERO)
+{
+    math::Radian inclination(
+        math::Degree(config["magneticInclination"].asDouble(60)));
+    double strength = config["magneticStrength"].asDouble(0.5);
+    m_magneticField = math::Vector3(
+        strength * math::Math::Cos(inclination), 0,
+        strength * math::Math::Sin(inclination));
+}
+
+SimIMU::~SimIMU()
+{
+}
+
+void SimIMU::sample(const VehicleDynamics& dynamics, double timestep)
+{
+    const VehicleDynamics::State& state = dynamics.getState();
+    math::Quaternion toBody = state.orientation.UnitInverse();
+
+    // The accelerometer feels everything but gravity
+    math::Vector3 accel = toBody *
+        (state.acceleration - math::Vector3(0, 0, GRAVITY)) / GRAVITY;
+    math::Vector3 mag = toBody * m_magneticField;
+
+    RawIMUDataEventPtr event = m_events.acquire();
+    RawIMUData& data = event->rawIMUData;
+    data.accelX = accel[0] + noise(m_accelNoise);
+    data.accelY = accel[1] + noise(m_accelNoise);
+    data.accelZ = accel[2] + noise(m_accelNoise);
+    data.gyroX = state.angularRate[0] + noise(m_gyroNoise);
+    data.gyroY = state.angularRate[1] + noise(m_gyroNoise);
+    data.gyroZ = state.angularRate[2] + noise(m_gyroNoise);
+    data.magX = mag[0] + noise(m_magNoise);
+    data.magY = mag[1] + noise(m_magNoise);
+    data.magZ = mag[2] + noise(m_magNoise);
+
+    event->name = getName();
+    event->sensorID = getSensorID();
+    event->magIsCorrupt = false;
+    event->timestep = timestep;
+    publish(IIMU::RAW_UPDATE, event);
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SimSensor.cpp
+ */
+
+// Library Includes
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+
+// Project Includes
+#include "vehicle/include/device/SimSensor.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+SimSensor::SimSensor(core::ConfigNode config, int defaultInterval) :
+    m_interval(config["update_interval"].asInt(defaultInterval) / 1000.0),
+    m_lastSample(0),
+    m_sampled(false),
+    m_generator(config["seed"].asInt(1))
+{
+}
+
+SimSensor::~SimSensor()
+{
+}
+
+void SimSensor::simulate(const VehicleDynamics& dynamics, double time)
+{
+    if (!m_sampled)
+    {
+        // The first sample has no previous one to measure a step from
+        sample(dynamics, m_interval);
+        m_lastSample = time;
+        m_sampled = true;
+    }
+    else if (time - m_lastSample >= m_interval - 1e-9)
+    {
+        sample(dynamics, time - m_lastSample);
+        m_lastSample = time;
+    }
+}
+
+double SimSensor::noise(double stddev)
+{
+    if (stddev <= 0)
+        return 0;
+
+    boost::variate_generator<boost::mt19937&,
+                             boost::normal_distribution<double> >
+        generator(m_generator, boost::normal_distribution<double>(0, stddev));
+    return generator();
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
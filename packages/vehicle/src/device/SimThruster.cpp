@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/src/device/SimThruster.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Project Includes
+#include "vehicle/include/device/SimThruster.h"
+
+namespace ram {
+namespace vehicle {
+namespace device {
+
+static const double WATER_DENSITY = 1000;
+
+SimThruster::SimThruster(core::ConfigNode config, core::EventHubPtr eventHub,
+                         IVehiclePtr vehicle) :
+    Device(config["name"].asString()),
+    IThruster(eventHub, config["name"].asString()),
+    m_command(0),
+    m_force(0),
+    m_energy(0),
+    m_enabled(false),
+    m_maxForce(config["maxForce"].asDouble(25)),
+    m_minForce(config["minForce"].asDouble(-25)),
+    m_timeConstant(config["timeConstant"].asDouble(0.05)),
+    m_powerScale(0),
+    m_location(config["location"][0].asDouble(0),
+               config["location"][1].asDouble(0),
+               config["location"][2].asDouble(0)),
+    m_direction(config["direction"][0].asDouble(0),
+                config["direction"][1].asDouble(0),
+                config["direction"][2].asDouble(0))
+{
+    double radius = config["propellerDiameter"].asDouble(0.1) / 2;
+    m_powerScale = 2 * WATER_DENSITY * M_PI * radius * radius;
+}
+
+SimThruster::~SimThruster()
+{
+}
+
+void SimThruster::simulate(double timestep)
+{
+    core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
+
+    double target = m_enabled ? m_command : 0;
+    if (target > m_maxForce)
+        target = m_maxForce;
+    else if (target < m_minForce)
+        target = m_minForce;
+
+    // Exact step of the lag, so it is stable for any timestep
+    if (m_timeConstant > 0)
+        m_force += (target - m_force) *
+            (1 - std::exp(-timestep / m_timeConstant));
+    else
+        m_force = target;
+
+    // Momentum theory power of a propeller with no losses
+    double magnitude = std::fabs(m_force);
+    m_energy += magnitude * std::sqrt(magnitude / m_powerScale) * timestep;
+}
+
+double SimThruster::getEnergy()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    return m_energy;
+}
+
+void SimThruster::setForce(double newtons)
+{
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
+        m_command = newtons;
+    }
+
+    math::NumericEventPtr event = m_forceEvents.acquire();
+    event->number = newtons;
+    publish(IThruster::FORCE_UPDATE, event);
+}
+
+double SimThruster::getForce()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    return m_force;
+}
+
+double SimThruster::getMaxForce()
+{
+    return m_maxForce;
+}
+
+double SimThruster::getMinForce()
+{
+    return m_minForce;
+}
+
+bool SimThruster::isEnabled()
+{
+    core::ReadWriteMutex::ScopedReadLock lock(m_stateMutex);
+    return m_enabled;
+}
+
+void SimThruster::setEnabled(bool state)
+{
+    bool changed = false;
+    {
+        core::ReadWriteMutex::ScopedWriteLock lock(m_stateMutex);
+        changed = (state != m_enabled);
+        m_enabled = state;
+    }
+
+    if (changed)
+        publish(state ? ENABLED : DISABLED, core::EventPtr(new core::Event));
+}
+
+math::Vector3 SimThruster::getLocation()
+{
+    return m_location;
+}
+
+math::Vector3 SimThruster::getDirection()
+{
+    return m_direction;
+}
+
+} // namespace device
+} // namespace vehicle
+} // namespace ram
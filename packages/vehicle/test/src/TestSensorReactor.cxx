@@ -0,0 +1,527 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/test/src/TestSensorReactor.cxx
+ */
+
+// STD Includes
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+// UNIX Includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+// Project Includes
+#include "vehicle/include/device/SensorReactor.h"
+#include "vehicle/include/device/IMU.h"
+#include "vehicle/include/device/DVL.h"
+#include "vehicle/include/Events.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/EventHub.h"
+#include "core/include/EventConnection.h"
+
+#include "drivers/imu/include/imuapi.h"
+#include "drivers/dvl/include/dvlapi.h"
+
+using namespace ram;
+
+typedef std::vector<unsigned char> Bytes;
+
+// An IMU frame, sync included, with the given raw accelerometer counts
+static Bytes imuFrame(int timer, short accelX, short accelY, short accelZ,
+                      bool goodChecksum = true)
+{
+    Bytes frame(IMU_SYNC_SIZE + IMU_FRAME_SIZE, 0);
+    for (int i = 0; i < IMU_SYNC_SIZE; ++i)
+        frame[i] = 0xFF;
+
+    unsigned char* data = &frame[IMU_SYNC_SIZE];
+    data[0] = 0x31;
+    data[3] = (timer >> 8) & 0xFF;
+    data[4] = timer & 0xFF;
+    short accel[3] = {accelX, accelY, accelZ};
+    for (int i = 0; i < 3; ++i)
+    {
+        data[15 + i * 2] = (accel[i] >> 8) & 0xFF;
+        data[16 + i * 2] = accel[i] & 0xFF;
+    }
+
+    int sum = 0xFF * IMU_SYNC_SIZE;
+    for (int i = 0; i < IMU_FRAME_SIZE - 1; ++i)
+        sum += data[i];
+    data[IMU_FRAME_SIZE - 1] = (sum + (goodChecksum ? 0 : 1)) & 0xFF;
+    return frame;
+}
+
+// A 47 byte PD4 packet with the given bottom track velocities
+static Bytes dvlPacket(short xVel, short yVel, bool goodChecksum = true)
+{
+    Bytes packet(47, 0);
+    packet[0] = 0x7D;
+    packet[2] = 45;
+    packet[5] = xVel & 0xFF;
+    packet[6] = (xVel >> 8) & 0xFF;
+    packet[7] = yVel & 0xFF;
+    packet[8] = (yVel >> 8) & 0xFF;
+    packet[13] = 150;
+
+    unsigned short sum = 0;
+    for (int i = 0; i < 45; ++i)
+        sum += packet[i];
+    if (!goodChecksum)
+        sum++;
+    packet[45] = sum & 0xFF;
+    packet[46] = (sum >> 8) & 0xFF;
+    return packet;
+}
+
+static void append(Bytes& stream, const Bytes& bytes)
+{
+    stream.insert(stream.end(), bytes.begin(), bytes.end());
+}
+
+static double accelCounts(short counts)
+{
+    return counts * 3.0 / 32768.0;
+}
+
+// Stands in for a serial port, the test writes to the master side
+struct Pty
+{
+    Pty() : master(posix_openpt(O_RDWR | O_NOCTTY)), slave(-1)
+    {
+        grantpt(master);
+        unlockpt(master);
+        name = ptsname(master);
+        slave = open(name.c_str(), O_RDWR | O_NOCTTY);
+
+        // Bytes go through untouched, like the real ports
+        struct termios tio;
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+    }
+
+    ~Pty()
+    {
+        closeMaster();
+        if (slave >= 0)
+            close(slave);
+    }
+
+    void closeMaster()
+    {
+        if (master >= 0)
+            close(master);
+        master = -1;
+    }
+
+    // Replays the stream in pieces of random size, splitting frames
+    void replay(const Bytes& stream, int maxChunk)
+    {
+        size_t sent = 0;
+        while (sent < stream.size())
+        {
+            size_t chunk = std::min((size_t)(1 + rand() % maxChunk),
+                                    stream.size() - sent);
+            sent += write(master, &stream[sent], chunk);
+        }
+    }
+
+    int master;
+    int slave;
+    std::string name;
+};
+
+// Parses IMU frames out of what the reactor hands over
+struct IMUCollector
+{
+    IMUCollector() : badFrames(0) {}
+
+    size_t handler(const unsigned char* data, size_t length)
+    {
+        size_t used = 0;
+        while (used < length)
+        {
+            RawIMUData imu;
+            int consumed = 0;
+            int result = imu_parseFrame(data + used, length - used, &imu,
+                                        &consumed);
+            used += consumed;
+            if (0 == result)
+                break;
+            else if (result < 0)
+                badFrames++;
+            else
+                frames.push_back(imu);
+        }
+        return used;
+    }
+
+    std::vector<RawIMUData> frames;
+    int badFrames;
+};
+
+// Polls until count frames arrived, or a second passed
+static void pollFor(vehicle::device::SensorReactor& reactor,
+                    std::vector<RawIMUData>& frames, size_t count)
+{
+    for (int i = 0; (i < 100) && (frames.size() < count); ++i)
+        reactor.poll(10);
+}
+
+SUITE(SensorReactor) {
+
+TEST(imuParseFrame)
+{
+    Bytes stream;
+    stream.push_back(0x12);
+    stream.push_back(0x34);
+    append(stream, imuFrame(1000, 100, -200, 10000));
+
+    RawIMUData imu;
+    int consumed = -1;
+
+    // Not enough of the frame yet, the sync bytes are kept
+    CHECK_EQUAL(0, imu_parseFrame(&stream[0], 4, &imu, &consumed));
+    CHECK_EQUAL(2, consumed);
+    CHECK_EQUAL(0, imu_parseFrame(&stream[0], 20, &imu, &consumed));
+    CHECK_EQUAL(2, consumed);
+
+    CHECK_EQUAL(1, imu_parseFrame(&stream[0], stream.size(), &imu,
+                                  &consumed));
+    CHECK_EQUAL((int)stream.size(), consumed);
+    CHECK_EQUAL(1000, imu.sampleTimer);
+    CHECK_CLOSE(accelCounts(100), imu.accelX, 0.0001);
+    CHECK_CLOSE(accelCounts(-200), imu.accelY, 0.0001);
+    CHECK_CLOSE(accelCounts(10000), imu.accelZ, 0.0001);
+    CHECK(imu.checksumValid);
+
+    // A bad frame only gives up its sync
+    Bytes bad(imuFrame(1, 1, 1, 1, false));
+    CHECK_EQUAL(-1, imu_parseFrame(&bad[0], bad.size(), &imu, &consumed));
+    CHECK_EQUAL(IMU_SYNC_SIZE, consumed);
+}
+
+TEST(dvlParsePacket)
+{
+    Bytes stream;
+    stream.push_back(0x00);
+    stream.push_back(0x7D);
+    stream.push_back(0x12);
+    append(stream, dvlPacket(-300, 1200));
+
+    RawDVLData dvl;
+    int consumed = -1;
+
+    // Waiting on the rest, the garbage can go
+    CHECK_EQUAL(0, dvl_parsePacket(&stream[0], 10, &dvl, &consumed));
+    CHECK_EQUAL(3, consumed);
+    CHECK_EQUAL(0, dvl_parsePacket(&stream[0], 2, &dvl, &consumed));
+    CHECK_EQUAL(1, consumed);
+
+    CHECK_EQUAL(1, dvl_parsePacket(&stream[0], stream.size(), &dvl,
+                                   &consumed));
+    CHECK_EQUAL((int)stream.size(), consumed);
+    CHECK_EQUAL(-300, dvl.xvel_btm);
+    CHECK_EQUAL(1200, dvl.yvel_btm);
+    CHECK_EQUAL(150, dvl.beam1_range);
+    CHECK_EQUAL(1u, dvl.valid);
+
+    Bytes bad(dvlPacket(1, 1, false));
+    CHECK_EQUAL(-ERR_CHKSUM, dvl_parsePacket(&bad[0], bad.size(), &dvl,
+                                             &consumed));
+    CHECK_EQUAL(2, consumed);
+
+    bad[2] = 0xFF;
+    bad[3] = 0xFF;
+    CHECK_EQUAL(-ERR_TOOBIG, dvl_parsePacket(&bad[0], bad.size(), &dvl,
+                                             &consumed));
+    CHECK_EQUAL(2, consumed);
+}
+
+TEST(replay)
+{
+    srand(7);
+    Bytes stream;
+    for (int i = 0; i < 50; ++i)
+    {
+        append(stream, imuFrame(i, i * 10, -i, 5));
+        // Line noise and corrupted frames in between
+        if (i % 10 == 3)
+            stream.push_back(0x42);
+        if (i % 10 == 7)
+            append(stream, imuFrame(0, 0, 0, 0, false));
+    }
+
+    Pty pty;
+    IMUCollector collector;
+    vehicle::device::SensorReactor reactor;
+    reactor.addDevice(pty.slave, boost::bind(&IMUCollector::handler,
+                                             &collector, _1, _2));
+    CHECK_EQUAL(1u, reactor.getDeviceCount());
+
+    pty.replay(stream, 60);
+    pollFor(reactor, collector.frames, 50);
+
+    CHECK_EQUAL(50u, collector.frames.size());
+    CHECK_EQUAL(5, collector.badFrames);
+    for (size_t i = 0; i < collector.frames.size(); ++i)
+    {
+        CHECK_EQUAL((int)i, collector.frames[i].sampleTimer);
+        CHECK_CLOSE(accelCounts(i * 10), collector.frames[i].accelX, 0.0001);
+    }
+
+    // Once the other side goes away the device is dropped
+    pty.closeMaster();
+    reactor.poll(100);
+    CHECK_EQUAL(0u, reactor.getDeviceCount());
+}
+
+TEST(removeDevice)
+{
+    Pty pty;
+    IMUCollector collector;
+    vehicle::device::SensorReactor reactor;
+    reactor.start();
+    int id = reactor.addDevice(
+        pty.slave, boost::bind(&IMUCollector::handler, &collector, _1, _2));
+
+    pty.replay(imuFrame(1, 0, 0, 0), 100);
+    for (int i = 0; (i < 100) && collector.frames.empty(); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    CHECK_EQUAL(1u, collector.frames.size());
+
+    // Nothing is read after removal
+    reactor.removeDevice(id);
+    pty.replay(imuFrame(2, 0, 0, 0), 100);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    CHECK_EQUAL(1u, collector.frames.size());
+    CHECK_EQUAL(0u, reactor.getDeviceCount());
+    reactor.stop();
+}
+
+// Removes its own device after the first frame
+struct SelfRemover
+{
+    SelfRemover(vehicle::device::SensorReactor& reactor_) :
+        reactor(reactor_), id(-1) {}
+
+    size_t handler(const unsigned char* data, size_t length)
+    {
+        size_t used = collector.handler(data, length);
+        if (!collector.frames.empty())
+            reactor.removeDevice(id);
+        return used;
+    }
+
+    vehicle::device::SensorReactor& reactor;
+    IMUCollector collector;
+    int id;
+};
+
+TEST(removeDeviceFromHandler)
+{
+    Pty pty;
+    vehicle::device::SensorReactor reactor;
+    reactor.start();
+    SelfRemover remover(reactor);
+    remover.id = reactor.addDevice(
+        pty.slave, boost::bind(&SelfRemover::handler, &remover, _1, _2));
+
+    // Two frames in one read, the second is not handed over
+    Bytes stream;
+    append(stream, imuFrame(1, 0, 0, 0));
+    append(stream, imuFrame(2, 0, 0, 0));
+    pty.replay(stream, 1);
+    for (int i = 0; (i < 100) && reactor.getDeviceCount(); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+
+    CHECK_EQUAL(0u, reactor.getDeviceCount());
+    pty.replay(imuFrame(3, 0, 0, 0), 100);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+    CHECK_EQUAL(1u, remover.collector.frames.size());
+    reactor.stop();
+}
+
+// Hands out the given descriptors, -1 once they run out
+struct Opener
+{
+    Opener() : calls(0) {}
+
+    int open()
+    {
+        calls++;
+        if (fds.empty())
+            return -1;
+        int fd = fds.front();
+        fds.erase(fds.begin());
+        return fd;
+    }
+
+    std::vector<int> fds;
+    int calls;
+};
+
+TEST(reopen)
+{
+    Pty first;
+    Pty second;
+    IMUCollector collector;
+    Opener opener;
+    vehicle::device::SensorReactor reactor;
+    reactor.addDevice(first.slave,
+                      boost::bind(&IMUCollector::handler, &collector, _1, _2),
+                      boost::bind(&Opener::open, &opener));
+
+    first.replay(imuFrame(1, 0, 0, 0), 100);
+    pollFor(reactor, collector.frames, 1);
+    CHECK_EQUAL(1u, collector.frames.size());
+
+    // Kept after the port goes away, and retried until it opens
+    first.closeMaster();
+    reactor.poll(100);
+    CHECK_EQUAL(1u, reactor.getDeviceCount());
+    CHECK_EQUAL(0, opener.calls);
+
+    opener.fds.push_back(-1);
+    opener.fds.push_back(second.slave);
+    for (int i = 0; (i < 40) && (opener.calls < 2); ++i)
+        reactor.poll(100);
+    CHECK_EQUAL(2, opener.calls);
+
+    second.replay(imuFrame(2, 0, 0, 0), 100);
+    pollFor(reactor, collector.frames, 2);
+    CHECK_EQUAL(2u, collector.frames.size());
+    CHECK_EQUAL(1u, reactor.getDeviceCount());
+}
+
+TEST(openLater)
+{
+    Pty pty;
+    IMUCollector collector;
+    Opener opener;
+    opener.fds.push_back(pty.slave);
+    vehicle::device::SensorReactor reactor;
+
+    // The port did not open at first, the reactor opens it on the next poll
+    reactor.addDevice(-1,
+                      boost::bind(&IMUCollector::handler, &collector, _1, _2),
+                      boost::bind(&Opener::open, &opener));
+    reactor.poll(10);
+    CHECK_EQUAL(1, opener.calls);
+
+    pty.replay(imuFrame(1, 0, 0, 0), 100);
+    pollFor(reactor, collector.frames, 1);
+    CHECK_EQUAL(1u, collector.frames.size());
+}
+
+struct EventCounter
+{
+    EventCounter() : calls(0) {}
+
+    void handler(core::EventPtr event)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        events.push_back(event);
+        calls++;
+    }
+
+    int getCalls()
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return calls;
+    }
+
+    boost::mutex mutex;
+    std::vector<core::EventPtr> events;
+    int calls;
+};
+
+static void waitForCalls(EventCounter& counter, int calls)
+{
+    for (int i = 0; (i < 100) && (counter.getCalls() < calls); ++i)
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+}
+
+TEST(IMU)
+{
+    Pty pty;
+    core::EventHubPtr eventHub(new core::EventHub());
+    vehicle::device::IMU imu(core::ConfigNode::fromString(
+        "{ 'name' : 'IMU', 'devfile' : '" + pty.name + "',"
+        "  'imuToVehicleRotMatrix' : [[1, 0, 0], [0, 1, 0], [0, 0, 1]],"
+        "  'magXBias' : 0, 'magYBias' : 0, 'magZBias' : 0,"
+        "  'gyroXBias' : 0, 'gyroYBias' : 0, 'gyroZBias' : 0 }"),
+        eventHub);
+
+    EventCounter counter;
+    core::EventConnectionPtr connection = imu.subscribe(
+        vehicle::device::IIMU::RAW_UPDATE,
+        boost::bind(&EventCounter::handler, &counter, _1));
+
+    // Read by the shared reactor, no thread of its own
+    imu.background(20);
+    CHECK(imu.backgrounded());
+
+    Bytes stream;
+    append(stream, imuFrame(1, 1000, 0, 0));
+    append(stream, imuFrame(2, 2000, 0, 0));
+    pty.replay(stream, 7);
+    waitForCalls(counter, 2);
+
+    CHECK_EQUAL(2, counter.getCalls());
+    vehicle::RawIMUDataEventPtr event =
+        boost::dynamic_pointer_cast<vehicle::RawIMUDataEvent>(
+            counter.events[1]);
+    CHECK(event);
+    if (event)
+        CHECK_CLOSE(accelCounts(2000), event->rawIMUData.accelX, 0.0001);
+
+    imu.unbackground(true);
+    CHECK(!imu.backgrounded());
+    connection->disconnect();
+}
+
+TEST(DVL)
+{
+    Pty pty;
+    core::EventHubPtr eventHub(new core::EventHub());
+    vehicle::device::DVL dvl(core::ConfigNode::fromString(
+        "{ 'name' : 'DVL', 'devfile' : '" + pty.name + "' }"), eventHub);
+
+    EventCounter counter;
+    core::EventConnectionPtr connection = dvl.subscribe(
+        vehicle::device::IVelocitySensor::RAW_UPDATE,
+        boost::bind(&EventCounter::handler, &counter, _1));
+
+    dvl.background(20);
+    pty.replay(dvlPacket(500, -250), 5);
+    waitForCalls(counter, 1);
+
+    CHECK_EQUAL(1, counter.getCalls());
+    vehicle::RawDVLDataEventPtr event =
+        boost::dynamic_pointer_cast<vehicle::RawDVLDataEvent>(
+            counter.events[0]);
+    CHECK(event);
+    if (event)
+    {
+        CHECK_CLOSE(-0.25, event->velocity_b[0], 0.0001);
+        CHECK_CLOSE(0.5, event->velocity_b[1], 0.0001);
+    }
+
+    dvl.unbackground(true);
+    connection->disconnect();
+}
+
+} // SUITE(SensorReactor)
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/test/src/TestSensorRegistry.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "vehicle/include/device/SensorRegistry.h"
+#include "vehicle/include/device/Device.h"
+#include "vehicle/include/Events.h"
+
+using namespace ram::vehicle;
+
+TEST(SensorRegistryIntern)
+{
+    int first = device::SensorRegistry::intern("TestRegistryA");
+    int second = device::SensorRegistry::intern("TestRegistryB");
+
+    CHECK(first >= 0);
+    CHECK_EQUAL(first + 1, second);
+    CHECK(device::SensorRegistry::count() > second);
+
+    // The same name always gets the same ID
+    CHECK_EQUAL(first, device::SensorRegistry::intern("TestRegistryA"));
+    CHECK_EQUAL("TestRegistryA", device::SensorRegistry::getName(first));
+    CHECK_EQUAL("TestRegistryB", device::SensorRegistry::getName(second));
+}
+
+TEST(SensorRegistryUnknown)
+{
+    CHECK_EQUAL("", device::SensorRegistry::getName(
+                    device::SensorRegistry::UNKNOWN));
+    CHECK_EQUAL("", device::SensorRegistry::getName(
+                    device::SensorRegistry::count()));
+}
+
+TEST(SensorRegistryDevice)
+{
+    // A device and a consumer of its events agree on the ID in either order
+    int id = device::SensorRegistry::intern("TestRegistryDevice");
+    device::Device dev("TestRegistryDevice");
+    CHECK_EQUAL(id, dev.getSensorID());
+}
+
+TEST(SensorRegistryEvents)
+{
+    RawIMUDataEvent imuEvent;
+    CHECK_EQUAL(device::SensorRegistry::UNKNOWN, imuEvent.sensorID);
+    RawDVLDataEvent dvlEvent;
+    CHECK_EQUAL(device::SensorRegistry::UNKNOWN, dvlEvent.sensorID);
+
+    imuEvent.sensorID = 3;
+    RawIMUDataEventPtr clone =
+        boost::dynamic_pointer_cast<RawIMUDataEvent>(imuEvent.clone());
+    CHECK_EQUAL(3, clone->sensorID);
+}
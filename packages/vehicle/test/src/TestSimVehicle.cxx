@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/test/src/TestSimVehicle.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include <boost/bind.hpp>
+#include <boost/assign/list_of.hpp>
+
+// Project Includes
+#include "vehicle/include/SimVehicle.h"
+#include "vehicle/include/Events.h"
+#include "vehicle/include/device/IIMU.h"
+#include "vehicle/include/device/IVelocitySensor.h"
+#include "vehicle/include/device/IDepthSensor.h"
+#include "vehicle/include/device/IThruster.h"
+
+#include "core/include/ConfigNode.h"
+#include "core/include/EventHub.h"
+
+using namespace ram;
+
+static const std::string CONFIG(
+    "{'name' : 'Vehicle',"
+    " 'Dynamics' : {'mass' : 10, 'buoyancy' : 98.0665,"
+    "               'centerOfBuoyancy' : [0, 0, 0],"
+    "               'initialPosition' : [0, 0, 3]},"
+    " 'Devices' : {"
+    "   'StarboardThruster' : {'type' : 'SimThruster',"
+    "       'location' : [-0.1, 0.2, 0], 'direction' : [1, 0, 0]},"
+    "   'PortThruster' : {'type' : 'SimThruster',"
+    "       'location' : [-0.1, -0.2, 0], 'direction' : [1, 0, 0]},"
+    "   'TopThruster' : {'type' : 'SimThruster',"
+    "       'location' : [0, 0, -0.2], 'direction' : [0, 1, 0]},"
+    "   'BottomThruster' : {'type' : 'SimThruster',"
+    "       'location' : [0, 0, 0.2], 'direction' : [0, 1, 0]},"
+    "   'ForeThruster' : {'type' : 'SimThruster',"
+    "       'location' : [0.2, 0, 0], 'direction' : [0, 0, 1]},"
+    "   'AftThruster' : {'type' : 'SimThruster',"
+    "       'location' : [-0.4, 0, 0], 'direction' : [0, 0, 1]},"
+    "   'IMU' : {'type' : 'SimIMU'},"
+    "   'DVL' : {'type' : 'SimDVL', 'update_interval' : 50},"
+    "   'DepthSensor' : {'type' : 'SimDepthSensor'}"
+    " }"
+    "}");
+
+struct SimVehicleFixture
+{
+    SimVehicleFixture() :
+        eventHub(new core::EventHub()),
+        veh(new vehicle::SimVehicle(core::ConfigNode::fromString(CONFIG),
+                                    boost::assign::list_of(eventHub)))
+    {
+    }
+
+    ~SimVehicleFixture() {
+        delete veh;
+    }
+
+    core::EventHubPtr eventHub;
+    vehicle::SimVehicle* veh;
+};
+
+static void countEvent(int* count, core::EventPtr event)
+{
+    (*count)++;
+}
+
+static void depthHelper(double* depth, core::EventPtr event)
+{
+    *depth = boost::dynamic_pointer_cast<vehicle::RawDepthSensorDataEvent>(
+        event)->rawDepth;
+}
+
+TEST_FIXTURE(SimVehicleFixture, SensorRates)
+{
+    int imuCount = 0;
+    int dvlCount = 0;
+    double depth = 0;
+    eventHub->subscribeToType(vehicle::device::IIMU::RAW_UPDATE,
+                              boost::bind(countEvent, &imuCount, _1));
+    eventHub->subscribeToType(vehicle::device::IVelocitySensor::RAW_UPDATE,
+                              boost::bind(countEvent, &dvlCount, _1));
+    eventHub->subscribeToType(vehicle::device::IDepthSensor::RAW_UPDATE,
+                              boost::bind(depthHelper, &depth, _1));
+
+    // The first physics step samples, then each update interval after it
+    veh->step(1.0);
+    CHECK_CLOSE(1.0, veh->getTime(), 0.0001);
+    CHECK_EQUAL(200, imuCount);
+    CHECK_EQUAL(20, dvlCount);
+    CHECK_CLOSE(3, depth, 0.0001);
+}
+
+TEST_FIXTURE(SimVehicleFixture, ThrustersNeedEnabling)
+{
+    veh->applyForcesAndTorques(math::Vector3(10, 0, 0), math::Vector3::ZERO);
+    veh->step(1.0);
+    CHECK_CLOSE(0, veh->getTrueState().velocity[0], 0.0001);
+    CHECK_CLOSE(0, veh->getThrusterEnergy(), 0.0001);
+}
+
+TEST_FIXTURE(SimVehicleFixture, ForcesAndTorques)
+{
+    veh->unsafeThrusters();
+
+    // Forward and down, through the real thruster allocation
+    veh->applyForcesAndTorques(math::Vector3(10, 0, 5), math::Vector3::ZERO);
+    veh->step(2.0);
+    vehicle::VehicleDynamics::State state = veh->getTrueState();
+    CHECK(state.velocity[0] > 0.1);
+    CHECK(state.velocity[2] > 0.05);
+    CHECK_CLOSE(0, state.angularRate.length(), 0.001);
+    CHECK(veh->getThrusterEnergy() > 0);
+
+    // Yaw to starboard
+    veh->applyForcesAndTorques(math::Vector3::ZERO, math::Vector3(0, 0, 1));
+    veh->step(1.0);
+    state = veh->getTrueState();
+    CHECK(state.angularRate[2] > 0.1);
+    CHECK(state.orientation.getYaw().valueRadians() > 0);
+}
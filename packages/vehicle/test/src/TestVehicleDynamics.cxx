@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vehicle/test/src/TestVehicleDynamics.cxx
+ */
+
+// STD Includes
+#include <cmath>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "vehicle/include/VehicleDynamics.h"
+#include "core/include/ConfigNode.h"
+#include "math/test/include/MathChecks.h"
+
+using namespace ram;
+
+// Neutrally buoyant, with buoyancy acting at the center of mass
+static const std::string NEUTRAL(
+    "{'mass' : 10, 'buoyancy' : 98.0665, 'centerOfBuoyancy' : [0, 0, 0],"
+    " 'initialPosition' : [0, 0, 3]}");
+
+static void run(vehicle::VehicleDynamics& dynamics, double seconds,
+                const math::Vector3& force, const math::Vector3& torque)
+{
+    for (int i = 0; i < (int)(seconds / 0.001 + 0.5); ++i)
+        dynamics.step(0.001, force, torque);
+}
+
+TEST(VehicleDynamicsNeutral)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(NEUTRAL));
+    run(dynamics, 5, math::Vector3::ZERO, math::Vector3::ZERO);
+
+    const vehicle::VehicleDynamics::State& state = dynamics.getState();
+    CHECK_CLOSE(math::Vector3(0, 0, 3), state.position, 0.0001);
+    CHECK_CLOSE(math::Vector3::ZERO, state.velocity, 0.0001);
+    CHECK_CLOSE(math::Quaternion::IDENTITY, state.orientation, 0.0001);
+}
+
+TEST(VehicleDynamicsBuoyantRise)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(
+        "{'initialPosition' : [0, 0, 3]}"));
+    run(dynamics, 2, math::Vector3::ZERO, math::Vector3::ZERO);
+    CHECK(dynamics.getState().position[2] < 3);
+    CHECK(dynamics.getState().velocity[2] < 0);
+
+    // Floats with only part of it out of the water
+    run(dynamics, 300, math::Vector3::ZERO, math::Vector3::ZERO);
+    CHECK(dynamics.getState().position[2] < 0);
+    CHECK(dynamics.getState().position[2] > -0.2);
+}
+
+TEST(VehicleDynamicsTerminalVelocity)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(NEUTRAL));
+    run(dynamics, 20, math::Vector3(10, 0, 0), math::Vector3::ZERO);
+
+    // Where the default drag, 5v + 18v^2, balances the force
+    double expected = (-5 + std::sqrt(25.0 + 4 * 18 * 10)) / (2 * 18);
+    CHECK_CLOSE(expected, dynamics.getState().velocity[0], 0.001);
+    CHECK_CLOSE(0, dynamics.getState().velocity[1], 0.0001);
+    CHECK_CLOSE(0, dynamics.getState().acceleration[0], 0.001);
+}
+
+TEST(VehicleDynamicsForceInBodyFrame)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(
+        "{'mass' : 10, 'buoyancy' : 98.0665, 'centerOfBuoyancy' : [0, 0, 0],"
+        " 'initialYaw' : 90}"));
+    run(dynamics, 1, math::Vector3(10, 0, 0), math::Vector3::ZERO);
+
+    // Facing east, forward is +y
+    CHECK(dynamics.getState().velocity[1] > 0.1);
+    CHECK_CLOSE(0, dynamics.getState().velocity[0], 0.0001);
+}
+
+TEST(VehicleDynamicsYaw)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(NEUTRAL));
+    run(dynamics, 1, math::Vector3::ZERO, math::Vector3(0, 0, 1));
+
+    const vehicle::VehicleDynamics::State& state = dynamics.getState();
+    CHECK(state.angularRate[2] > 0);
+    CHECK(state.orientation.getYaw().valueRadians() > 0);
+    CHECK_CLOSE(0, state.orientation.getPitch().valueRadians(), 0.0001);
+    CHECK_CLOSE(0, state.orientation.getRoll().valueRadians(), 0.0001);
+}
+
+TEST(VehicleDynamicsRightingMoment)
+{
+    // Buoyancy above the center of mass rights a rolled vehicle
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(
+        "{'initialPosition' : [0, 0, 3]}"));
+    vehicle::VehicleDynamics::State state = dynamics.getState();
+    state.orientation = math::Quaternion(math::Degree(20),
+                                         math::Vector3::UNIT_X);
+    dynamics.setState(state);
+
+    run(dynamics, 30, math::Vector3::ZERO, math::Vector3::ZERO);
+    CHECK_CLOSE(0, dynamics.getState().orientation.getRoll().valueDegrees(),
+                1);
+}
+
+TEST(VehicleDynamicsCurrent)
+{
+    vehicle::VehicleDynamics dynamics(core::ConfigNode::fromString(
+        "{'mass' : 10, 'buoyancy' : 98.0665, 'centerOfBuoyancy' : [0, 0, 0],"
+        " 'initialPosition' : [0, 0, 3], 'current' : [0.3, 0, 0]}"));
+    run(dynamics, 30, math::Vector3::ZERO, math::Vector3::ZERO);
+    CHECK_CLOSE(0.3, dynamics.getState().velocity[0], 0.001);
+}
@@ -13,6 +13,7 @@
 // STD Includes
 #include <list>
 #include <map>
+#include <vector>
 
 // Project Includes
 #include "core/include/ConfigNode.h"
@@ -39,6 +40,8 @@ class RAM_EXPORT BinDetector : public Detector
 
         Symbol::SymbolType getSymbol() { return m_symbol; }
 
+        void setSymbol(Symbol::SymbolType symbol) { m_symbol = symbol; }
+
         /** Draws the bounds of the bin in green, and its ID */
         void draw(Image* image, Image* red = 0);
 
@@ -132,7 +135,9 @@ class RAM_EXPORT BinDetector : public Detector
     
     /** Processes the bin and fires off found event
      *
-     *  It adds each process bin to the list of current bins.
+     *  It adds each process bin to the list of current bins.  When asked
+     *  to detect the symbol, the symbol image is queued for
+     *  determineSymbols() and the bin is returned without its symbol.
      *
      *  @param bin
      *      The blob which bounds the black box of the bin
@@ -173,20 +178,13 @@ class RAM_EXPORT BinDetector : public Detector
      */
     Image* cropBinImage(Image* redBinImage, unsigned char* storageBuffer);
     
-    /** Called by process bin, if symbol detection is request is true
+    /** Finds the symbols of every image processBin() queued in one call
      *
-     *  @param bin
-     *      The blob which bounds the black box of the bin
-     *  @param input
-     *      The image to extract the symbol from
-     *  @param scratchBuffer
-     *      A buffer to use if a scratch image is needed
-     *  @param output
-     *      Our debug output image
+     *  @param bins
+     *      The bins of this frame, in the order processBin() made them,
+     *      given their symbols
      */
-    Symbol::SymbolType determineSymbol(Image* input,
-                                       unsigned char* scratchBuffer,
-                                       Image* output = 0);
+    void determineSymbols(BinList& bins);
 
     /** Logs the image of the symbol to file based on the symbol type */
     void logSymbolImage(Image* image, Symbol::SymbolType symbol);
@@ -199,6 +197,12 @@ class RAM_EXPORT BinDetector : public Detector
 
     /** Object that determines the symbol in the bin */
     SymbolDetectorPtr m_symbolDetector;
+
+    /** Copies of the symbol images of this frame's bins */
+    std::vector<Image*> m_symbolImages;
+
+    /** The number of the bin each of m_symbolImages came from */
+    std::vector<int> m_symbolBins;
     
     /** Our current set of bins */
     BinList m_bins;
@@ -10,6 +10,9 @@
 #ifndef RAM_VISION_CAMERA_H_05_23_2007
 #define RAM_VISION_CAMERA_H_05_23_2007
 
+// Library Includes
+#include <boost/cstdint.hpp>
+
 // Project Includes
 #include "core/include/Updatable.h"
 #include "core/include/ReadWriteMutex.h"
@@ -48,8 +51,11 @@ public:
      *  @param current
      *      The current image is copied into the given image and that pointer
      *      is returned.
+     *  @param arrivalTime
+     *      If non zero, set to when the image was captured, on the clock of
+     *      core::LatencyTracker::now()
      */
-    void getImage(Image* current);
+    void getImage(Image* current, boost::int64_t* arrivalTime = 0);
 
     /** Waits for next image from the camera, then copies to given image
      *
@@ -164,6 +170,9 @@ private:
 
     /** Image returned from get image*/
     Image* m_publicImage;
+
+    /** When the public image was captured */
+    boost::int64_t m_publicImageArrival;
     
     /** Latch to release threads waiting on a new image */
     core::CountDownLatch m_imageLatch;
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/include/ColorConverter.h
+ */
+
+#ifndef RAM_VISION_COLORCONVERTER_H_07_08_2011
+#define RAM_VISION_COLORCONVERTER_H_07_08_2011
+
+// Project Includes
+#include "vision/include/Image.h"
+
+// This must be included last
+#include "vision/include/Export.h"
+
+namespace ram {
+namespace vision {
+
+/** Converts 8 bit pixels between any two Image::PixelFormats
+ *
+ *  Every conversion is a single pass over the image.  Each block of pixels
+ *  is decoded into floating point RGB which stays in cache, then encoded
+ *  straight into the destination, so there are no intermediate images no
+ *  matter how far apart the formats are.  The linear stages use SSE2 when
+ *  the compiler targets it.
+ *
+ *  The formats are encoded as:
+ *   - PF_GRAY_8: 0.299 R + 0.587 G + 0.114 B
+ *   - PF_YUV444_8: full range BT.601 with U and V offset by 128, the same
+ *     as libdc1394 uses for the cameras' YUV modes
+ *   - PF_HSV_8, PF_LUV_8, PF_LAB_8: exactly like cvCvtColor, so H is
+ *     halved to fit in [0, 180), L is scaled by 2.55, and u, v, a and b
+ *     are offset to fit in a byte
+ *   - PF_LCHUV_8: exactly like LCHConverter, so existing lookup tables and
+ *     color filter settings stay valid.  L is scaled by 2.55, C is raw, and
+ *     H covers [0, 255).  Values are truncated rather than rounded.
+ *   - PF_LCHAB_8: the polar form of PF_LAB_8, scaled like PF_LCHUV_8
+ */
+class RAM_EXPORT ColorConverter
+{
+public:
+    /** True if pixels can be converted from one format to the other */
+    static bool canConvert(Image::PixelFormat from, Image::PixelFormat to);
+
+    /** Converts a width by height block of pixels
+     *
+     *  The source and destination may be the same buffer if both formats
+     *  have the same number of channels.
+     *
+     *  @param srcStep
+     *      Bytes from the start of one source row to the next
+     *  @param dstStep
+     *      Bytes from the start of one destination row to the next
+     */
+    static void convert(Image::PixelFormat from, const unsigned char* src,
+                        int srcStep, Image::PixelFormat to,
+                        unsigned char* dst, int dstStep,
+                        int width, int height);
+
+private:
+    ColorConverter() {}
+};
+
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_COLORCONVERTER_H_07_08_2011
@@ -10,6 +10,9 @@
 #ifndef RAM_VISION_DETECTOR_H_02_07_2008
 #define RAM_VISION_DETECTOR_H_02_07_2008
 
+// Library Includes
+#include <boost/cstdint.hpp>
+
 // Project Includes
 #include "core/include/Forward.h"
 #include "core/include/EventPublisher.h"
@@ -31,16 +34,46 @@ namespace vision {
 class RAM_EXPORT Detector : public core::EventPublisher
 {
 public:
+    /** How much debug output all detectors render into their output image */
+    enum DebugOutputLevel {
+        /** Output images are ignored, nothing is copied or drawn */
+        DEBUG_OUTPUT_NONE = 0,
+        /** Output images get the frame, detectors "debug" levels act as 0 */
+        DEBUG_OUTPUT_FRAME = 1,
+        /** Detectors render as much as their own "debug" property says */
+        DEBUG_OUTPUT_FULL = 2
+    };
+    
     /** Run the detector on the input image, debug results to output Image
      *
      *  @param input   The image to run the detector on
-     *  @param output  Debug image will be copied to this image
+     *  @param output  Debug image will be copied to this image, pass NULL
+     *                 when nothing will look at it
      */
     virtual void processImage(Image* input, Image* output = 0) = 0;
 
+    /** Sets the debug output level of every detector, default is FULL */
+    static void setDebugOutputLevel(DebugOutputLevel level);
+
+    /** Gets the debug output level of every detector */
+    static DebugOutputLevel getDebugOutputLevel();
+
     /** Get the set of properties for this object */
     virtual core::PropertySetPtr getPropertySet();
 
+    /** Sets when the next image to be processed was captured
+     *
+     *  Every event published while processing it is stamped with this as
+     *  its arrivalTime, so estimation can use the vehicle state from when
+     *  the image was taken instead of when the detector finished.  On the
+     *  clock of core::LatencyTracker::now(), 0 leaves events unstamped.
+     */
+    void setFrameArrivalTime(boost::int64_t arrivalTime);
+
+    /** Stamps the event with the frame arrival time, then publishes it */
+    virtual void publish(const core::Event::EventType& type,
+                         core::EventPtr event);
+
     /** Transfrom from OpenCV image coordinates to AI cordinates 
      *
      *  AI coordinates have the origin at the center, +Y up and +X to the 
@@ -65,9 +98,25 @@ public:
 protected:
     Detector(core::EventHubPtr eventHub = core::EventHubPtr());
 
+    /** The output image to render into, NULL when debug output is off
+     *
+     *  Detectors call this first in processImage so that everything they
+     *  render is skipped when nothing consumes it.
+     */
+    static Image* debugOutput(Image* output);
+
+    /** The detectors own debug level limited by the global level */
+    static int debugLevel(int detectorLevel);
+
 private:
+    /** The level for every detector */
+    static DebugOutputLevel s_debugOutputLevel;
+    
     /** Holds all the properties for this detector */
     core::PropertySetPtr m_propertySet;
+
+    /** When the image being processed was captured */
+    boost::int64_t m_frameArrivalTime;
 };
     
 } // namespace vision
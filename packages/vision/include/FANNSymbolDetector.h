@@ -10,8 +10,15 @@
 #ifndef RAM_VISION_FANNSYMBOLDETECTOR_H_07_03_2009
 #define RAM_VISION_FANNSYMBOLDETECTOR_H_07_03_2009
 
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
 // Project Includes
 #include "vision/include/SymbolDetector.h"
+#include "vision/include/QuantizedNetwork.h"
 
 #include "core/include/ConfigNode.h"
 
@@ -29,6 +36,11 @@ namespace vision {
  *
  *  Subclassing and implementing the getImageFeatures function, and running
  *  with a networked trained using the same function will match images.
+ *
+ *  By default an integer copy of the network is run (see QuantizedNetwork),
+ *  which is faster and needs no lock, but can differ from the network when
+ *  two outputs are nearly tied.  Setting "quantized: 0" in the config runs
+ *  the FANN network itself.
  */
 class RAM_EXPORT FANNSymbolDetector : public SymbolDetector
 {
@@ -57,6 +69,26 @@ public:
      */
     int runNN(Image* input);
 
+    /** Runs every image through the NN at once
+     *
+     *  Cheaper than calling runNN(Image*) on each candidate in turn, the
+     *  network is locked, or its weights loaded, once for all of them.
+     *
+     *  @param inputs
+     *      The images to match
+     *  @param results
+     *      Filled with the result for each image, as runNN(Image*) returns
+     */
+    void runNN(const std::vector<Image*>& inputs, std::vector<int>& results);
+
+    /** Matches every image with one batched runNN
+     *
+     *  Only valid for subclasses whose processImage() just calls runNN(),
+     *  others must override it again.
+     */
+    virtual void processImages(const std::vector<Image*>& inputs,
+                               std::vector<Symbol::SymbolType>& symbols);
+
     /** The last result returned from runNN */
     int getResult();
     
@@ -66,6 +98,29 @@ protected:
                        core::EventHubPtr eventHub = core::EventHubPtr());
         
 private:
+    /** A loaded network, and the lock needed to run it */
+    struct Network;
+    typedef boost::shared_ptr<Network> NetworkPtr;
+
+    /** Returns the network stored at path, loading it if needed
+     *
+     *  Networks are shared by every detector using the same file, running
+     *  a network changes its neuron values so each run holds its lock.
+     */
+    static NetworkPtr getNetwork(std::string path);
+
+    /** Runs count sets of features through the network
+     *
+     *  @param features
+     *      count sets of getNumberFeatures() features, one after another
+     *  @param results
+     *      Filled with count results, as runNN returns
+     */
+    void runFeatures(const float* features, int count, int* results);
+
+    /** The matched output, or -1 if none was above the threshold */
+    int bestOutput(const float* outputs);
+
     /** The number of features */
     int m_numberFeatures;
     
@@ -81,8 +136,20 @@ private:
     /** Features */
     float* m_features;
 
+    /** Features of every image in a batch */
+    std::vector<float> m_batchFeatures;
+
+    /** Network outputs for every set of features run */
+    std::vector<float> m_outputs;
+
     /** My nueral network */
-    FANN::neural_net* m_net;
+    NetworkPtr m_net;
+
+    /** Integer copy of the network, only set when using it */
+    boost::shared_ptr<QuantizedNetwork> m_quantized;
+
+    /** Working space for the quantized network */
+    QuantizedNetwork::Scratch m_scratch;
 };
     
 } // namespace vision
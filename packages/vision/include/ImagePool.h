@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/include/ImagePool.h
+ */
+
+#ifndef RAM_VISION_IMAGEPOOL_H_07_06_2011
+#define RAM_VISION_IMAGEPOOL_H_07_06_2011
+
+// STD Includes
+#include <cstddef>
+
+// Library Includes
+#include <boost/utility.hpp>
+#include <boost/cstdint.hpp>
+
+// Project Includes
+#include "vision/include/Common.h"
+
+// This must be included last
+#include "vision/include/Export.h"
+
+// Forward declared to avoid OpenCV Header
+struct CvMemStorage;
+typedef struct CvMemStorage CvMemStorage;
+
+namespace ram {
+namespace vision {
+
+/** A process wide pool of image buffers, keyed by size and format
+ *
+ *  Images are handed out by acquire() and given back with release(), which
+ *  keeps them for the next acquire() of the same size, depth and channels.
+ *  Once every frame size and format in use has been seen, frame processing
+ *  allocates nothing.
+ *
+ *  Pooled images are laid out exactly like cvCreateImage lays them out,
+ *  plenty of code walks getData() assuming that, and their buffers start on
+ *  ALIGNMENT byte boundaries.
+ *
+ *  release() also takes images which didn't come from the pool, it simply
+ *  frees those, so it can replace cvReleaseImage for any image we own.
+ */
+class RAM_EXPORT ImagePool : public boost::noncopyable
+{
+public:
+    struct Stats
+    {
+        Stats() : acquires(0), hits(0), releases(0), discards(0),
+                  idleImages(0), idleBytes(0) {}
+
+        /** Fraction of acquires handed an idle image */
+        double hitRate() const
+        {
+            return acquires ? (double)hits / acquires : 0;
+        }
+
+        boost::uint64_t acquires;
+        boost::uint64_t hits;
+        boost::uint64_t releases;
+        /** Released images freed because their size already had enough */
+        boost::uint64_t discards;
+        size_t idleImages;
+        size_t idleBytes;
+    };
+
+    /** Alignment of the start of pooled image buffers, in bytes */
+    static const int ALIGNMENT = 16;
+
+    /** Most idle images kept of any one size and format */
+    static const size_t MAX_IDLE = 8;
+
+    /** Returns an image with undefined contents */
+    static IplImage* acquire(int width, int height, int depth, int channels);
+
+    /** Gives the image back to the pool and sets the pointer to NULL */
+    static void release(IplImage** image);
+
+    /** Returns empty storage for contours, lines and other sequences */
+    static CvMemStorage* acquireStorage();
+
+    /** Clears the storage and keeps it for the next acquireStorage() */
+    static void releaseStorage(CvMemStorage** storage);
+
+    static Stats getStats();
+
+    static void resetStats();
+
+    /** Frees every idle image and storage */
+    static void clear();
+};
+
+/** Scratch image from the ImagePool for the length of a scope */
+class RAM_EXPORT PooledImage : public boost::noncopyable
+{
+public:
+    PooledImage(int width, int height, int depth, int channels) :
+        m_image(ImagePool::acquire(width, height, depth, channels)) {}
+
+    ~PooledImage() { ImagePool::release(&m_image); }
+
+    IplImage* get() const { return m_image; }
+
+    operator IplImage*() const { return m_image; }
+
+    IplImage* operator->() const { return m_image; }
+
+private:
+    IplImage* m_image;
+};
+
+/** Scratch CvMemStorage from the ImagePool for the length of a scope */
+class RAM_EXPORT PooledStorage : public boost::noncopyable
+{
+public:
+    PooledStorage() : m_storage(ImagePool::acquireStorage()) {}
+
+    ~PooledStorage() { ImagePool::releaseStorage(&m_storage); }
+
+    operator CvMemStorage*() const { return m_storage; }
+
+private:
+    CvMemStorage* m_storage;
+};
+
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_IMAGEPOOL_H_07_06_2011
@@ -31,6 +31,10 @@ public:
 
     static void convert(vision::Image* image);
 
+    /** The RGB to LCh table, indexed [r][g][b][channel], loading it if
+     *  needed.  Returns NULL if it isn't available. */
+    static const unsigned char* getLookupTable();
+
 private:
     /* Here are the steps to convert a BGR pixel to a CIELCH pixel
        assuming a pointer px = &channel 1
@@ -63,6 +67,11 @@ private:
     static void lab2lch_ab(double *l2l, double *a2c, double *b2h);
     static void luv2lch_uv(double *l2l, double *a2c, double *b2h);
 
+    /** True if the lookup table is loaded, trying to load it the first
+     *  time it is needed.  Checked under the lock, so the table is never
+     *  read before it is filled in. */
+    static bool lookupTableReady();
+
     static unsigned char rgb2lchLookup[256][256][256][3];
 
     static bool lookupInit;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/include/QuantizedNetwork.h
+ */
+
+#ifndef RAM_VISION_QUANTIZEDNETWORK_H_08_04_2011
+#define RAM_VISION_QUANTIZEDNETWORK_H_08_04_2011
+
+// STD Includes
+#include <vector>
+
+// Library Includes
+#include <boost/utility.hpp>
+
+// Must be incldued last
+#include "vision/include/Export.h"
+
+namespace FANN {
+    class neural_net;
+}
+
+namespace ram {
+namespace vision {
+
+/** An integer copy of a trained FANN network for fast classification
+ *
+ *  Each layer becomes a dense matrix over the neurons feeding it, with
+ *  connections the network lacks (sparse and shortcut networks) left as
+ *  zero.  Weights are rounded to 16 bit values with a scale for each neuron,
+ *  and when run the values feeding a layer are rounded to 16 bit values
+ *  with one scale per input set, so none is off by more than 1/65534 of the
+ *  largest it is rounded with.  8 bit weights are not enough here: the
+ *  features put a pixel average next to a relative width, and the rounding
+ *  of a weight is multiplied by the size of what it is applied to.  The
+ *  sums are done in integers, eight at a time with SSE2 when it is there,
+ *  then scaled back and put through the same activation function as the
+ *  network.
+ *
+ *  Runs work on any number of inputs at once, so each weight row is loaded
+ *  once for every candidate in a frame instead of once per candidate.
+ *  Running does not change the network, so any number of threads can run it
+ *  at once, each with its own Scratch.
+ */
+class RAM_EXPORT QuantizedNetwork : boost::noncopyable
+{
+public:
+    /** Working space for run(), keep one around to avoid reallocating */
+    struct Scratch
+    {
+        std::vector<float> values;
+        std::vector<short> quantized;
+        std::vector<float> scales;
+    };
+
+    /** Makes the quantized copy of the network, which is not changed */
+    QuantizedNetwork(FANN::neural_net& net);
+
+    int getNumInput() const;
+
+    int getNumOutput() const;
+
+    /** Runs each input through the network
+     *
+     *  @param inputs
+     *      count sets of getNumInput() values, one after another
+     *  @param count
+     *      The number of inputs
+     *  @param outputs
+     *      Filled with count sets of getNumOutput() values
+     *  @param scratch
+     *      Working space, only ever used by one thread at a time
+     */
+    void run(const float* inputs, int count, float* outputs,
+             Scratch& scratch) const;
+
+private:
+    struct Layer
+    {
+        /** Index of the first neuron computed by this layer */
+        int first;
+
+        /** The number of neurons computed, not counting any bias */
+        int size;
+
+        /** First neuron feeding this layer, they are contiguous */
+        int columnBegin;
+
+        /** Number of neurons feeding this layer */
+        int columns;
+
+        /** Columns rounded up to a whole number of SIMD blocks */
+        int stride;
+
+        /** size rows of stride rounded weights */
+        std::vector<short> weights;
+
+        /** What each row of weights is multiplied by to be the real ones */
+        std::vector<float> scales;
+
+        /** Activation function and steepness of each neuron */
+        std::vector<int> activations;
+        std::vector<float> steepness;
+    };
+
+    /** Applies a FANN activation function to the steepness scaled sum */
+    static float activate(int function, float value);
+
+    int m_numInput;
+    int m_numOutput;
+
+    /** Total neurons, including bias neurons */
+    int m_numNeurons;
+
+    /** Indices of every bias neuron, which always output one */
+    std::vector<int> m_biasNeurons;
+
+    std::vector<Layer> m_layers;
+};
+
+} // namespace vision
+} // namespace ram
+
+#endif // RAM_VISION_QUANTIZEDNETWORK_H_08_04_2011
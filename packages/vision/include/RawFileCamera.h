@@ -76,6 +76,12 @@ private:
     /** Our current frame number */
     int m_currentFrame;
 
+    /** Total of the update timesteps, only used in virtual time */
+    double m_playTime;
+
+    /** Frames read (or skipped) so far, only used in virtual time */
+    int m_framesPlayed;
+
     /** Holds the raw picture data read from the file */
     unsigned char* m_dataBuffer;
 
@@ -17,6 +17,7 @@
 
 // Library Includes
 #include <boost/thread/mutex.hpp>
+#include <boost/cstdint.hpp>
 
 // Project Includes
 #include "vision/include/Common.h"
@@ -95,6 +96,12 @@ class RAM_EXPORT Recorder : public core::Updatable
     
     /** Called when ever there is a new frame to record */
     virtual void recordFrame(Image* image) = 0;
+
+    /** When the frame passed to recordFrame was captured
+     *
+     *  On the clock of core::LatencyTracker::now(), 0 if unknown.
+     */
+    boost::int64_t getFrameArrivalTime();
     
   private:
     /** Called when the camera has processed a new event */
@@ -126,6 +133,9 @@ class RAM_EXPORT Recorder : public core::Updatable
     /** The frame we get from the camera */
     Image* m_frameFromCamera;
 
+    /** When m_frameFromCamera was captured */
+    boost::int64_t m_frameArrivalTime;
+
     /** The current frame we are recording */
     Image* m_frameResized;
 
@@ -10,6 +10,9 @@
 #ifndef RAM_VISION_SYMBOLDETECTOR_H_06_30_2009
 #define RAM_VISION_SYMBOLDETECTOR_H_06_30_2009
 
+// STD Includes
+#include <vector>
+
 // Project Includes
 #include "vision/include/Detector.h"
 #include "vision/include/Symbol.h"
@@ -29,6 +32,20 @@ public:
     /** Whether or not the detector needs the image cropped to a square */
     virtual bool needSquareCropped() = 0;
 
+    /** Finds the symbol in each of the images
+     *
+     *  The default runs processImage() and getSymbol() on each image in
+     *  turn, detectors which can classify many images at once for less
+     *  override it.
+     *
+     *  @param inputs
+     *      The candidate symbol images, from one frame
+     *  @param symbols
+     *      Filled with the symbol of each image
+     */
+    virtual void processImages(const std::vector<Image*>& inputs,
+                               std::vector<Symbol::SymbolType>& symbols);
+
 protected:
     SymbolDetector(core::EventHubPtr eventHub = core::EventHubPtr());
 };
@@ -13,6 +13,9 @@
 // STD Includes
 #include <string>
 
+// Library Includes
+#include <boost/shared_ptr.hpp>
+
 // Project Includes
 #include "vision/include/Common.h"
 #include "vision/include/ImageFilter.h"
@@ -47,11 +50,20 @@ public:
     static void createLookupTable(std::string filepath, 
                                   math::ImplicitSurface &iSurface);
 
+    /** Returns the table stored at filepath, loading it if needed
+     *
+     *  Tables are shared between every filter using the same file, and
+     *  freed once the last of them is destroyed.
+     */
+    static boost::shared_ptr<core::BitField3D> getLookupTable(
+        std::string filepath);
+
 private:
-    bool loadLookupTable();
+    static boost::shared_ptr<core::BitField3D> loadLookupTable(
+        std::string filepath);
 
     // property set and properties
-    core::BitField3D m_filterTable;
+    boost::shared_ptr<core::BitField3D> m_filterTable;
     core::PropertySetPtr m_propertySet;
     std::string m_filepath;
 };
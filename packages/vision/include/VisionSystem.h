@@ -12,11 +12,17 @@
 
 // STD Includes
 #include <map>
+#include <set>
+#include <list>
+
+// Library Includes
+#include <boost/thread/mutex.hpp>
 
 // Project Includes
 #include "core/include/Subsystem.h"
 #include "core/include/ConfigNode.h"
 #include "core/include/Forward.h"
+#include "core/include/Clock.h"
 
 #include "vision/include/Common.h"
 
@@ -109,9 +115,9 @@ public:
      */
     virtual void unbackground(bool join = false);
 
-    /** Not implemented, always return true */
+    /** Always true, except in virtual time where we are stepped */
     virtual bool backgrounded() {
-      return true;
+      return !core::Clock::isVirtual();
 //        return Updatable::backgrounded();
     };
 
@@ -183,11 +189,19 @@ private:
     void createRecorder(CameraPtr camera, std::string recorderString,
                         int frameRate, bool debugPrint = false);
 
-    /** Add a detector to the forward runner */
-    void addForwardDetector(DetectorPtr detector);
+    /** Returns the named detector, constructing it on first use
+     *
+     *  An unknown name is logged and returns an empty DetectorPtr.
+     *
+     *  @note m_detectorMutex must be held
+     */
+    DetectorPtr getDetector(std::string name);
+
+    /** Starts the named detector on the given runner */
+    void detectorOn(std::string name, VisionRunner* runner);
 
-    /** Add a detector to the downward runner */
-    void addDownwardDetector(DetectorPtr detector);
+    /** Stops the named detector, keeping it cached if there is room */
+    void detectorOff(std::string name, VisionRunner* runner);
 
     core::ConfigNode getConfig(core::ConfigNode config, std::string name);
     
@@ -201,13 +215,26 @@ private:
     VisionRunner* m_forward;
     VisionRunner* m_downward;
 
-    DetectorPtr m_buoyDetector;
-    DetectorPtr m_binDetector;
-    DetectorPtr m_pipelineDetector;
-    DetectorPtr m_downwardSafeDetector;
-    DetectorPtr m_gateDetector;
-    DetectorPtr m_cupidDetector;
-    DetectorPtr m_loversLaneDetector;
+    /** Used to construct detectors when they are first turned on */
+    core::ConfigNode m_config;
+    core::EventHubPtr m_eventHub;
+
+    typedef std::map<std::string, DetectorPtr> StrDetectorMap;
+    
+    /** Every constructed detector: the active ones and the cached ones */
+    StrDetectorMap m_detectors;
+
+    /** Names of the detectors currently running */
+    std::set<std::string> m_activeDetectors;
+
+    /** Names of the cached inactive detectors, most recently used first */
+    std::list<std::string> m_inactiveDetectors;
+
+    /** Most inactive detectors kept constructed, set by 'detectorCacheSize' */
+    size_t m_detectorCacheSize;
+
+    /** Guards the detector members above */
+    boost::mutex m_detectorMutex;
 
     /** Flag which when true enables use of back/unback and update */
     bool m_testing;
@@ -15,6 +15,7 @@
 #include "core/include/ConfigNode.h"
 #include "vision/include/Events.h"
 #include "vision/include/Common.h"
+#include "vision/include/ImagePool.h"
 
 //Include me last.
 #include "vision/include/Export.h"
@@ -291,8 +292,8 @@ void AdaptiveThresher::segmentImage(Image* in, Image* out)
 
 void AdaptiveThresher::findCircle()
 {
-    IplImage* img = cvCreateImage(cvSize(m_working.getWidth(), m_working.getHeight()), 8, 1);
-    CvMemStorage* storage = cvCreateMemStorage(0);
+    PooledImage img(m_working.getWidth(), m_working.getHeight(), 8, 1);
+    PooledStorage storage;
     unsigned char * data = (unsigned char *)m_working.getData();
     unsigned char * data2 = (unsigned char *)img->imageData;
     int len = m_working.getWidth() * m_working.getHeight() * 3;
@@ -311,8 +312,6 @@ void AdaptiveThresher::findCircle()
         cvCircle(m_working, cvPoint(cvRound(p[0]), cvRound(p[1])),(int)p[2],
                  CV_RGB(255,0,0), 3, 8, 0);
     }
-
-    cvReleaseImage(&img);
 }
 
 }//vision
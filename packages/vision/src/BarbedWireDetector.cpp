@@ -111,6 +111,8 @@ void BarbedWireDetector::setBottomRemovePercentage(double percent)
     
 void BarbedWireDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Ensure our working image is the same size
     if ((m_image->getWidth() != input->getWidth()) || 
         (m_image->getHeight() != input->getHeight()))
@@ -31,6 +31,7 @@
 #include "vision/include/DetectorMaker.h"
 #include "vision/include/SymbolDetector.h"
 #include "vision/include/ColorFilter.h"
+#include "vision/include/ImagePool.h"
 
 #include "math/include/Vector2.h"
 
@@ -180,6 +181,8 @@ BinDetector::~BinDetector()
 
 void BinDetector::processImage(Image* input, Image* out)
 {
+    out = debugOutput(out);
+
     m_frame->copyFrom(input);
 
     // Ensure all the images are the proper size
@@ -247,6 +250,9 @@ void BinDetector::processImage(Image* input, Image* out)
             binNumber++;
         }
 
+        // Classify all the symbols found at once
+        determineSymbols(newBins);
+
         // Sort through our new bins and match them to the old ones
         TrackedBlob::updateIds(&m_bins, &newBins, &m_lostBins,
                                m_binSameThreshold, m_binLostFrames);
@@ -1014,7 +1020,13 @@ BinDetector::Bin BinDetector::processBin(BlobDetector::Blob bin,
 
         if (cropped)
         {
-            symbol = determineSymbol(redBinImage, m_scratchBuffer1, output);
+            // Kept until determineSymbols(), the buffer is reused per bin
+            Image* symbolImage = new OpenCVImage(
+                redBinImage->getWidth(), redBinImage->getHeight(),
+                redBinImage->getPixelFormat());
+            symbolImage->copyFrom(redBinImage);
+            m_symbolImages.push_back(symbolImage);
+            m_symbolBins.push_back(binNum);
 
             if (output && (binNum < 4))
             {
@@ -1028,10 +1040,6 @@ BinDetector::Bin BinDetector::processBin(BlobDetector::Blob bin,
                 delete scaledBin; // m_scratchBuffer1 free to use
             }
 
-            // Log the images if desired
-            if (m_logSymbolImages)
-                logSymbolImage(redBinImage, symbol);
-            
             delete cropped;// m_scratchBuffer2 free to use
         }
         delete rotatedBinImage; // m_scratchBuffer1 free to use
@@ -1082,22 +1090,25 @@ double BinDetector::getRedFillPercentage(BlobDetector::Blob bin,
 bool BinDetector::calculateAngleOfBin(BlobDetector::Blob bin, Image* input,
                                       math::Degree& foundAngle, Image* output)
 {
-    // Grab a gray scale version of the input image
+    // Grab a gray scale version of the input image, the headers live on the
+    // stack since the data is already in our scratch buffers
     CvSize size = cvGetSize(input->asIplImage());
-    IplImage* grayScale = cvCreateImageHeader(size, IPL_DEPTH_8U, 1);
-    cvSetData(grayScale, m_scratchBuffer1, input->getWidth());
-    cvCvtColor(input->asIplImage(), grayScale, CV_BGR2GRAY);
+    IplImage grayScale;
+    cvInitImageHeader(&grayScale, size, IPL_DEPTH_8U, 1);
+    cvSetData(&grayScale, m_scratchBuffer1, input->getWidth());
+    cvCvtColor(input->asIplImage(), &grayScale, CV_BGR2GRAY);
 
     // Grab a cannied version of our image
-    IplImage* cannied = cvCreateImageHeader(size, IPL_DEPTH_8U, 1);
-    cvSetData(cannied, m_scratchBuffer2, input->getWidth());
-    cvCanny(grayScale, cannied, 50, 200, 3 );
+    IplImage cannied;
+    cvInitImageHeader(&cannied, size, IPL_DEPTH_8U, 1);
+    cvSetData(&cannied, m_scratchBuffer2, input->getWidth());
+    cvCanny(&grayScale, &cannied, 50, 200, 3 );
 
     // Run the hough transform on the cannied image
-    CvMemStorage* storage = cvCreateMemStorage(0);
+    PooledStorage storage;
     CvSeq* lines = 0;
     
-    lines = cvHoughLines2( cannied, storage, CV_HOUGH_PROBABILISTIC,
+    lines = cvHoughLines2( &cannied, storage, CV_HOUGH_PROBABILISTIC,
                            m_binHoughPixelRes,
                            CV_PI/180, m_binHoughThreshold,
                            m_binHoughMinLineLength, m_binHoughMaxLineGap);
@@ -1114,7 +1125,7 @@ bool BinDetector::calculateAngleOfBin(BlobDetector::Blob bin, Image* input,
         cvLine(input->asIplImage(), line[0], line[1], CV_RGB(255,255,0),
                5, CV_AA, 0);
         
-        if (output && m_debug == 1)
+        if (output && debugLevel(m_debug) == 1)
         {
             line[0].x += bin.getCenterX() - input->getWidth() / 2;
             line[0].y += bin.getCenterY() - input->getHeight() / 2;
@@ -1150,10 +1161,6 @@ bool BinDetector::calculateAngleOfBin(BlobDetector::Blob bin, Image* input,
         success = true;
     }
     
-    cvReleaseImageHeader(&cannied);
-    cvReleaseMemStorage(&storage);
-    cvReleaseImageHeader(&grayScale);
-    
     return success;
 }
 
@@ -1267,14 +1274,34 @@ Image* BinDetector::cropBinImage(Image* redBinImage,
     return croppedImage;
 }
 
-Symbol::SymbolType BinDetector::determineSymbol(Image* input,
-                                                unsigned char* scratchBuffer,
-                                                Image* output)
+void BinDetector::determineSymbols(BinList& bins)
 {
-    m_symbolDetector->processImage(input, output);
-    // Filter symbol type
-    Symbol::SymbolType symbolFound = m_symbolDetector->getSymbol(); 
-    return symbolFound;
+    if (m_symbolImages.empty())
+        return;
+
+    std::vector<Symbol::SymbolType> symbols;
+    m_symbolDetector->processImages(m_symbolImages, symbols);
+
+    size_t next = 0;
+    int binNum = 0;
+    for (BinListIter iter = bins.begin(); iter != bins.end(); ++iter)
+    {
+        if ((next < m_symbolBins.size()) && (m_symbolBins[next] == binNum))
+        {
+            iter->setSymbol(symbols[next]);
+
+            // Log the images if desired
+            if (m_logSymbolImages)
+                logSymbolImage(m_symbolImages[next], symbols[next]);
+            next++;
+        }
+        binNum++;
+    }
+
+    BOOST_FOREACH(Image* image, m_symbolImages)
+        delete image;
+    m_symbolImages.clear();
+    m_symbolBins.clear();
 }
 
 void BinDetector::logSymbolImage(Image* image, Symbol::SymbolType symbol)
@@ -119,6 +119,8 @@ BlobDetector::~BlobDetector()
     
 void BlobDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     m_blobs.clear();
     buildBlobs(input->asIplImage());
 
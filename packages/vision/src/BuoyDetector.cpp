@@ -432,7 +432,8 @@ bool BuoyDetector::processColor(Image* input, Image* output,
 
 void BuoyDetector::processImage(Image* input, Image* output)
 {
-    
+    output = debugOutput(output);
+
     frame->copyFrom(input);
 
     int topRowsToIgnore = m_topIgnorePercentage * frame->getHeight();
@@ -607,7 +608,7 @@ void BuoyDetector::processImage(Image* input, Image* output)
     if(output)
     {
         output->copyFrom(frame);
-        if (m_debug >= 1) {
+        if (debugLevel(m_debug) >= 1) {
             output->copyFrom(frame);
 
             unsigned char *data = output->getData();
@@ -642,7 +643,7 @@ void BuoyDetector::processImage(Image* input, Image* output)
             Image::fillMask(output, blackFrame, 147, 20, 255);
         }
 
-        if (m_debug == 2) {
+        if (debugLevel(m_debug) == 2) {
             if (redFound)
                 drawBuoyDebug(output, redBlob, 255, 0, 0);
             if (greenFound)
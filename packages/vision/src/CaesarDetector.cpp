@@ -212,6 +212,8 @@ void CaesarDetector::setLookupTable(bool lookupTable)
 
 void CaesarDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     input->setPixelFormat(Image::PF_BGR_8);
     m_frame->copyFrom(input);
 
@@ -331,12 +333,12 @@ void CaesarDetector::processImage(Image* input, Image* output)
     if(output)
     {
         output->copyFrom(m_frame);
-        if(m_debug > 0)
+        if(debugLevel(m_debug) > 0)
         {
             Image::fillMask(output, m_redFrame, 200, 0, 0);
             Image::fillMask(output, m_blueFrame, 0, 0, 200);
             
-            if(m_debug == 2)
+            if(debugLevel(m_debug) == 2)
             {
                 if(redFound)
                     drawDebugCircle(redBlob, output, 200, 0, 0);
@@ -22,6 +22,8 @@
 #include "vision/include/CameraMaker.h"
 #include "vision/include/VisionSystem.h"
 
+#include "core/include/LatencyTracker.h"
+
 RAM_CORE_EVENT_TYPE(ram::vision::Camera, IMAGE_CAPTURED);
 
 namespace ram {
@@ -31,6 +33,7 @@ Camera::Camera() :
     Updatable(this),
     EventPublisher(core::EventHubPtr()),
     m_publicImage(0),
+    m_publicImageArrival(0),
     m_imageLatch(1)
 {
     /// TODO: Make me a basic image, and check that copying work properly
@@ -46,7 +49,7 @@ Camera::~Camera()
     delete m_publicImage;
 }
 
-void Camera::getImage(Image* current)
+void Camera::getImage(Image* current, boost::int64_t* arrivalTime)
 {
     assert(current && "Can't copy into a null image");
     
@@ -54,6 +57,8 @@ void Camera::getImage(Image* current)
 
     // Copy over the image (uses copy assignment operator)
     current->copyFrom(m_publicImage);
+    if (arrivalTime)
+        *arrivalTime = m_publicImageArrival;
 }
 
 bool Camera::waitForImage(Image* current)
@@ -114,7 +119,7 @@ CameraPtr Camera::createCamera(const std::string input,
     // Look up the configuration for the camera
     bool found = false;
     std::string nodeUsed;
-    core::ConfigNode config(core::ConfigNode::fromString("{}"));
+    core::ConfigNode config(core::ConfigNode::fromYamlString("{}"));
     if ("NONE" != configPath)
     {
         core::ConfigNode cfg(core::ConfigNode::fromFile(configPath));
@@ -148,8 +153,8 @@ CameraPtr Camera::createCamera(const std::string input,
     }
     else
     {
-        camera = Camera::createCamera(input, core::ConfigNode::fromString("{}"),
-                                      message);
+        camera = Camera::createCamera(
+            input, core::ConfigNode::fromYamlString("{}"), message);
     }
 
     return camera;
@@ -173,6 +178,9 @@ void Camera::cleanup()
 void Camera::capturedImage(Image* newImage)
 {
     assert(newImage && "Can't copy null image");
+
+    // Subclasses hand over frames as soon as they are captured
+    boost::int64_t arrival = core::LatencyTracker::now();
     
     {    
         core::ReadWriteMutex::ScopedWriteLock lock(m_imageMutex);
@@ -182,6 +190,7 @@ void Camera::capturedImage(Image* newImage)
         if (newImage)
         {
             copyToPublic(newImage, m_publicImage);
+            m_publicImageArrival = arrival;
         }
     }
 
@@ -194,8 +203,11 @@ void Camera::capturedImage(Image* newImage)
     // we could add a timestamp or index for the image in order to
     // let other modules figure out if they are getting duplicate
     // frames or dropping frames
-    publish(Camera::IMAGE_CAPTURED,
-            ImageEventPtr(new ImageEvent(m_publicImage)));
+    ImageEventPtr event(new ImageEvent(m_publicImage));
+    event->arrivalTime = arrival;
+    core::LatencyTracker::record(getPublisherName(),
+                                 core::LatencyTracker::DRIVER, arrival);
+    publish(Camera::IMAGE_CAPTURED, event);
     
     // Now release all waiting threads
     m_imageLatch.countDown();
@@ -0,0 +1,836 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/src/ColorConverter.cpp
+ */
+
+// STD Includes
+#include <cmath>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+
+// Library Includes
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Project Includes
+#include "vision/include/ColorConverter.h"
+#include "vision/include/LCHConverter.h"
+
+namespace ram {
+namespace vision {
+
+namespace {
+
+/** Pixels converted at a time, small enough that a block stays in L1 */
+const int BLOCK = 64;
+
+const float PI = 3.14159265358979f;
+
+/** A block of pixels as RGB, each channel in [0, 255] */
+struct RGBBlock
+{
+    float r[BLOCK];
+    float g[BLOCK];
+    float b[BLOCK];
+};
+
+typedef void (*Decoder)(const unsigned char* src, int n, RGBBlock& rgb);
+typedef void (*Encoder)(RGBBlock& rgb, int n, unsigned char* dst);
+
+/** A 3x3 matrix applied to every pixel, plus an offset */
+struct Transform
+{
+    float m[9];
+    float offset[3];
+};
+
+Transform makeTransform(const double m[9], double o0 = 0, double o1 = 0,
+                        double o2 = 0)
+{
+    Transform t;
+    for (int i = 0; i < 9; ++i)
+        t.m[i] = (float)m[i];
+    t.offset[0] = (float)o0;
+    t.offset[1] = (float)o1;
+    t.offset[2] = (float)o2;
+    return t;
+}
+
+void invert(const double m[9], double inv[9])
+{
+    double det = m[0] * (m[4] * m[8] - m[5] * m[7]) -
+                 m[1] * (m[3] * m[8] - m[5] * m[6]) +
+                 m[2] * (m[3] * m[7] - m[4] * m[6]);
+    inv[0] =  (m[4] * m[8] - m[5] * m[7]) / det;
+    inv[1] = -(m[1] * m[8] - m[2] * m[7]) / det;
+    inv[2] =  (m[1] * m[5] - m[2] * m[4]) / det;
+    inv[3] = -(m[3] * m[8] - m[5] * m[6]) / det;
+    inv[4] =  (m[0] * m[8] - m[2] * m[6]) / det;
+    inv[5] = -(m[0] * m[5] - m[2] * m[3]) / det;
+    inv[6] =  (m[3] * m[7] - m[4] * m[6]) / det;
+    inv[7] = -(m[0] * m[7] - m[1] * m[6]) / det;
+    inv[8] =  (m[0] * m[4] - m[1] * m[3]) / det;
+}
+
+/** Applies the transform to n pixels in place */
+void transform(const Transform& t, float* c0, float* c1, float* c2, int n)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128 m0 = _mm_set1_ps(t.m[0]), m1 = _mm_set1_ps(t.m[1]),
+        m2 = _mm_set1_ps(t.m[2]), m3 = _mm_set1_ps(t.m[3]),
+        m4 = _mm_set1_ps(t.m[4]), m5 = _mm_set1_ps(t.m[5]),
+        m6 = _mm_set1_ps(t.m[6]), m7 = _mm_set1_ps(t.m[7]),
+        m8 = _mm_set1_ps(t.m[8]);
+    const __m128 o0 = _mm_set1_ps(t.offset[0]),
+        o1 = _mm_set1_ps(t.offset[1]), o2 = _mm_set1_ps(t.offset[2]);
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(c0 + i);
+        __m128 b = _mm_loadu_ps(c1 + i);
+        __m128 c = _mm_loadu_ps(c2 + i);
+
+        _mm_storeu_ps(c0 + i, _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m0, a), _mm_mul_ps(m1, b)),
+            _mm_add_ps(_mm_mul_ps(m2, c), o0)));
+        _mm_storeu_ps(c1 + i, _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m3, a), _mm_mul_ps(m4, b)),
+            _mm_add_ps(_mm_mul_ps(m5, c), o1)));
+        _mm_storeu_ps(c2 + i, _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m6, a), _mm_mul_ps(m7, b)),
+            _mm_add_ps(_mm_mul_ps(m8, c), o2)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        float a = c0[i], b = c1[i], c = c2[i];
+        c0[i] = t.m[0] * a + t.m[1] * b + t.m[2] * c + t.offset[0];
+        c1[i] = t.m[3] * a + t.m[4] * b + t.m[5] * c + t.offset[1];
+        c2[i] = t.m[6] * a + t.m[7] * b + t.m[8] * c + t.offset[2];
+    }
+}
+
+/** out = sqrt(a^2 + b^2) for n values */
+void magnitude(const float* a, const float* b, float* out, int n)
+{
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(a + i);
+        __m128 y = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(
+            _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = std::sqrt(a[i] * a[i] + b[i] * b[i]);
+}
+
+/** atan2 in [0, 2 PI), good to about 1e-5 radians */
+inline float fastAtan2(float y, float x)
+{
+    float ax = std::fabs(x), ay = std::fabs(y);
+    if ((0 == ax) && (0 == ay))
+        return 0;
+
+    float a = std::min(ax, ay) / std::max(ax, ay);
+    float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) *
+        s * a + a;
+    if (ay > ax)
+        r = PI / 2 - r;
+    if (x < 0)
+        r = PI - r;
+    if (y < 0)
+        r = 2 * PI - r;
+    return (r >= 2 * PI) ? 0 : r;
+}
+
+inline unsigned char roundByte(float v)
+{
+    if (v <= 0)
+        return 0;
+    if (v >= 255)
+        return 255;
+    return (unsigned char)(v + 0.5f);
+}
+
+inline unsigned char truncateByte(float v)
+{
+    if (v <= 0)
+        return 0;
+    if (v >= 255)
+        return 255;
+    return (unsigned char)v;
+}
+
+inline float clampChannel(float v)
+{
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+/** Samples of a function over [0, max], linearly interpolated between */
+template<int SIZE>
+struct FunctionTable
+{
+    template<typename F>
+    void init(F f, double max_)
+    {
+        max = (float)max_;
+        scale = SIZE / max;
+        for (int i = 0; i <= SIZE; ++i)
+            values[i] = (float)f(i * max_ / SIZE);
+        values[SIZE + 1] = values[SIZE];
+    }
+
+    float operator()(float x) const
+    {
+        x = (x < 0) ? 0 : ((x > max) ? max : x) * scale;
+        int i = (int)x;
+        float frac = x - i;
+        return values[i] + frac * (values[i + 1] - values[i]);
+    }
+
+    float max;
+    float scale;
+    float values[SIZE + 2];
+};
+
+// Reference white and CIE constants
+const double EPSILON = 0.008856;
+const double KAPPA = 903.3;
+
+/** The sRGB white point cvCvtColor uses */
+const double OPENCV_XN = 0.950456;
+const double OPENCV_ZN = 1.088754;
+
+double srgbToLinear(double c)
+{
+    c /= 255;
+    return (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+double gamma22ToLinear(double c)
+{
+    return std::pow(c / 255, 2.2);
+}
+
+double labF(double t)
+{
+    return (t > EPSILON) ? std::pow(t, 1.0 / 3) : 7.787 * t + 16.0 / 116;
+}
+
+/** LCHConverter's L*, which uses 0.3333 as its cube root */
+double lchLightness(double y)
+{
+    return (y > EPSILON) ? 116 * std::pow(y, 0.3333) - 16 : KAPPA * y;
+}
+
+/** Gamma encodings of linear values, as functions of their square roots,
+ *  which are smooth enough near black to interpolate */
+double sqrtLinearToSRGB(double s)
+{
+    double l = s * s;
+    return 255 * ((l <= 0.0031308) ? 12.92 * l :
+                  1.055 * std::pow(l, 1 / 2.4) - 0.055);
+}
+
+double sqrtLinearToGamma22(double s)
+{
+    return 255 * std::pow(s, 2 / 2.2);
+}
+
+inline float labFInverse(float f)
+{
+    return (f > 6.0f / 29) ? f * f * f : (f - 16.0f / 116) / 7.787f;
+}
+
+/** Everything computed once when the library loads */
+struct Tables
+{
+    Tables()
+    {
+        static const double srgb2xyz[9] = {
+            0.412453, 0.357580, 0.180423,
+            0.212671, 0.715160, 0.072169,
+            0.019334, 0.119193, 0.950227};
+        // The matrix LCHConverter uses
+        static const double lch2xyz[9] = {
+            0.4124564, 0.3575761, 0.1804375,
+            0.2126729, 0.7151522, 0.0721750,
+            0.0193339, 0.1191920, 0.9503041};
+        static const double rgb2yuv[9] = {
+            0.299, 0.587, 0.114,
+            -0.168736, -0.331264, 0.5,
+            0.5, -0.418688, -0.081312};
+
+        double inv[9];
+
+        // Lab wants X and Z relative to the white point, and the channels
+        // from the decoders are in [0, 255]
+        double lab[9];
+        for (int i = 0; i < 3; ++i)
+        {
+            lab[i] = srgb2xyz[i] / OPENCV_XN;
+            lab[3 + i] = srgb2xyz[3 + i];
+            lab[6 + i] = srgb2xyz[6 + i] / OPENCV_ZN;
+        }
+        toLabXYZ = makeTransform(lab);
+        invert(lab, inv);
+        fromLabXYZ = makeTransform(inv);
+
+        toLuvXYZ = makeTransform(srgb2xyz);
+        invert(srgb2xyz, inv);
+        fromLuvXYZ = makeTransform(inv);
+
+        toLchXYZ = makeTransform(lch2xyz);
+        invert(lch2xyz, inv);
+        fromLchXYZ = makeTransform(inv);
+
+        toYUV = makeTransform(rgb2yuv, 0, 128, 128);
+        invert(rgb2yuv, inv);
+        // Undo the offset before the matrix
+        fromYUV = makeTransform(inv, -(inv[1] + inv[2]) * 128,
+                                -(inv[4] + inv[5]) * 128,
+                                -(inv[7] + inv[8]) * 128);
+
+        srgbLinear.init(srgbToLinear, 255);
+        gamma22Linear.init(gamma22ToLinear, 255);
+        srgbEncode.init(sqrtLinearToSRGB, 1);
+        gamma22Encode.init(sqrtLinearToGamma22, 1);
+        labCbrt.init(labF, 1);
+        lchL.init(lchLightness, 1);
+
+        double denom = OPENCV_XN + 15 + 3 * OPENCV_ZN;
+        luvUn = (float)(4 * OPENCV_XN / denom);
+        luvVn = (float)(9 / denom);
+
+        // LCHConverter's white point, from the D65 chromaticity
+        double x = 0.31271, y = 0.32902;
+        double xRef = x / y, zRef = (1 - x - y) / y;
+        denom = xRef + 15 + 3 * zRef;
+        lchUn = (float)(4 * xRef / denom);
+        lchVn = (float)(9 / denom);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            double angle = i * 3.14159265358979323846 / 127.5;
+            hueCos[i] = (float)std::cos(angle);
+            hueSin[i] = (float)std::sin(angle);
+        }
+    }
+
+    Transform toLabXYZ, fromLabXYZ;
+    Transform toLuvXYZ, fromLuvXYZ;
+    Transform toLchXYZ, fromLchXYZ;
+    Transform toYUV, fromYUV;
+
+    FunctionTable<256> srgbLinear;
+    FunctionTable<256> gamma22Linear;
+    FunctionTable<1024> srgbEncode;
+    FunctionTable<1024> gamma22Encode;
+    FunctionTable<2048> labCbrt;
+    FunctionTable<2048> lchL;
+
+    float luvUn, luvVn;
+    float lchUn, lchVn;
+
+    /** Unit vector for each LCh hue byte */
+    float hueCos[256];
+    float hueSin[256];
+};
+
+const Tables TABLES;
+
+// ------------------------------------------------------------------------
+// Decoders, from each format into an RGBBlock
+
+void decodeRGB(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.r[i] = src[0];
+        rgb.g[i] = src[1];
+        rgb.b[i] = src[2];
+    }
+}
+
+void decodeBGR(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.b[i] = src[0];
+        rgb.g[i] = src[1];
+        rgb.r[i] = src[2];
+    }
+}
+
+void decodeGray(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i)
+        rgb.r[i] = rgb.g[i] = rgb.b[i] = src[i];
+}
+
+void decodeYUV(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    decodeRGB(src, n, rgb);
+    transform(TABLES.fromYUV, rgb.r, rgb.g, rgb.b, n);
+    for (int i = 0; i < n; ++i)
+    {
+        rgb.r[i] = clampChannel(rgb.r[i]);
+        rgb.g[i] = clampChannel(rgb.g[i]);
+        rgb.b[i] = clampChannel(rgb.b[i]);
+    }
+}
+
+void decodeHSV(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        float v = src[2];
+        float s = src[1] / 255.0f;
+        float h = src[0] / 30.0f;
+        while (h >= 6)
+            h -= 6;
+
+        int sector = (int)h;
+        float frac = h - sector;
+        float p = v * (1 - s);
+        float q = v * (1 - s * frac);
+        float t = v * (1 - s * (1 - frac));
+
+        float r, g, b;
+        switch (sector)
+        {
+            case 0: r = v; g = t; b = p; break;
+            case 1: r = q; g = v; b = p; break;
+            case 2: r = p; g = v; b = t; break;
+            case 3: r = p; g = q; b = v; break;
+            case 4: r = t; g = p; b = v; break;
+            default: r = v; g = p; b = q; break;
+        }
+        rgb.r[i] = r;
+        rgb.g[i] = g;
+        rgb.b[i] = b;
+    }
+}
+
+/** Turns linear RGB in the block into gamma encoded channels */
+void encodeGamma(RGBBlock& rgb, int n, bool srgb)
+{
+    const FunctionTable<1024>& table =
+        srgb ? TABLES.srgbEncode : TABLES.gamma22Encode;
+
+    float* channels[3] = {rgb.r, rgb.g, rgb.b};
+    for (int c = 0; c < 3; ++c)
+    {
+        float* values = channels[c];
+        int i = 0;
+#ifdef __SSE2__
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(values + i, _mm_sqrt_ps(
+                _mm_max_ps(_mm_loadu_ps(values + i), zero)));
+        }
+#endif
+        for (; i < n; ++i)
+            values[i] = std::sqrt(std::max(values[i], 0.0f));
+
+        for (i = 0; i < n; ++i)
+            values[i] = clampChannel(table(values[i]));
+    }
+}
+
+/** XYZ from L* u* v*, the block holds L, u, v going in */
+void luvToXYZ(RGBBlock& block, int n, float un, float vn, double cubeRoot)
+{
+    float exponent = (float)(1 / cubeRoot);
+    for (int i = 0; i < n; ++i)
+    {
+        float L = block.r[i], u = block.g[i], v = block.b[i];
+        if (L <= 0)
+        {
+            block.r[i] = block.g[i] = block.b[i] = 0;
+            continue;
+        }
+
+        float Y = (L > KAPPA * EPSILON) ?
+            std::pow((L + 16) / 116, exponent) : L / (float)KAPPA;
+        float uPrime = u / (13 * L) + un;
+        float vPrime = v / (13 * L) + vn;
+
+        block.r[i] = Y * 9 * uPrime / (4 * vPrime);
+        block.g[i] = Y;
+        block.b[i] = Y * (12 - 3 * uPrime - 20 * vPrime) / (4 * vPrime);
+    }
+}
+
+void decodeLUV(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.r[i] = src[0] / 2.55f;
+        rgb.g[i] = src[1] * (354 / 255.0f) - 134;
+        rgb.b[i] = src[2] * (256 / 255.0f) - 140;
+    }
+    luvToXYZ(rgb, n, TABLES.luvUn, TABLES.luvVn, 1.0 / 3);
+    transform(TABLES.fromLuvXYZ, rgb.r, rgb.g, rgb.b, n);
+    encodeGamma(rgb, n, true);
+}
+
+void decodeLCHUV(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.r[i] = src[0] / 2.55f;
+        rgb.g[i] = src[1] * TABLES.hueCos[src[2]];
+        rgb.b[i] = src[1] * TABLES.hueSin[src[2]];
+    }
+    luvToXYZ(rgb, n, TABLES.lchUn, TABLES.lchVn, 0.3333);
+    transform(TABLES.fromLchXYZ, rgb.r, rgb.g, rgb.b, n);
+    encodeGamma(rgb, n, false);
+}
+
+/** Linear RGB from L* a* b*, the block holds L, a, b going in */
+void labToLinear(RGBBlock& block, int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        float fy = (block.r[i] + 16) / 116;
+        float fx = fy + block.g[i] / 500;
+        float fz = fy - block.b[i] / 200;
+
+        block.r[i] = labFInverse(fx);
+        block.g[i] = labFInverse(fy);
+        block.b[i] = labFInverse(fz);
+    }
+    transform(TABLES.fromLabXYZ, block.r, block.g, block.b, n);
+}
+
+void decodeLAB(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.r[i] = src[0] / 2.55f;
+        rgb.g[i] = src[1] - 128.0f;
+        rgb.b[i] = src[2] - 128.0f;
+    }
+    labToLinear(rgb, n);
+    encodeGamma(rgb, n, true);
+}
+
+void decodeLCHAB(const unsigned char* src, int n, RGBBlock& rgb)
+{
+    for (int i = 0; i < n; ++i, src += 3)
+    {
+        rgb.r[i] = src[0] / 2.55f;
+        rgb.g[i] = src[1] * TABLES.hueCos[src[2]];
+        rgb.b[i] = src[1] * TABLES.hueSin[src[2]];
+    }
+    labToLinear(rgb, n);
+    encodeGamma(rgb, n, true);
+}
+
+// ------------------------------------------------------------------------
+// Encoders, from an RGBBlock into each format
+
+void encodeRGB(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        dst[0] = roundByte(rgb.r[i]);
+        dst[1] = roundByte(rgb.g[i]);
+        dst[2] = roundByte(rgb.b[i]);
+    }
+}
+
+void encodeBGR(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        dst[0] = roundByte(rgb.b[i]);
+        dst[1] = roundByte(rgb.g[i]);
+        dst[2] = roundByte(rgb.r[i]);
+    }
+}
+
+void encodeGray(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        dst[i] = roundByte(0.299f * rgb.r[i] + 0.587f * rgb.g[i] +
+                           0.114f * rgb.b[i]);
+    }
+}
+
+void encodeYUV(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    transform(TABLES.toYUV, rgb.r, rgb.g, rgb.b, n);
+    encodeRGB(rgb, n, dst);
+}
+
+void encodeHSV(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        // Only defined for whole RGB values, like cvCvtColor
+        float r = roundByte(rgb.r[i]), g = roundByte(rgb.g[i]),
+            b = roundByte(rgb.b[i]);
+        float v = std::max(r, std::max(g, b));
+        float diff = v - std::min(r, std::min(g, b));
+
+        float h = 0, s = 0;
+        if (diff > 0)
+        {
+            s = 255 * diff / v;
+            if (v == r)
+                h = 30 * (g - b) / diff;
+            else if (v == g)
+                h = 30 * (b - r + 2 * diff) / diff;
+            else
+                h = 30 * (r - g + 4 * diff) / diff;
+        }
+
+        // Round before wrapping, like cvCvtColor
+        int hue = (int)std::floor(h + 0.5f);
+        if (hue < 0)
+            hue += 180;
+        dst[0] = (unsigned char)(hue % 180);
+        dst[1] = roundByte(s);
+        dst[2] = roundByte(v);
+    }
+}
+
+/** Linearizes the block in place */
+void linearize(RGBBlock& rgb, int n, const FunctionTable<256>& table)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        rgb.r[i] = table(rgb.r[i]);
+        rgb.g[i] = table(rgb.g[i]);
+        rgb.b[i] = table(rgb.b[i]);
+    }
+}
+
+/** Replaces XYZ in the block with L* u* v* */
+void xyzToLuv(RGBBlock& block, int n, const FunctionTable<2048>& lightness,
+              bool cubeRootTable, float un, float vn)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        float X = block.r[i], Y = block.g[i], Z = block.b[i];
+        float L = cubeRootTable ? 116 * lightness(Y) - 16 : lightness(Y);
+        float denom = X + 15 * Y + 3 * Z;
+        float u = 0, v = 0;
+        if (denom > 0)
+        {
+            u = 13 * L * (4 * X / denom - un);
+            v = 13 * L * (9 * Y / denom - vn);
+        }
+        block.r[i] = L;
+        block.g[i] = u;
+        block.b[i] = v;
+    }
+}
+
+void encodeLUV(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    linearize(rgb, n, TABLES.srgbLinear);
+    transform(TABLES.toLuvXYZ, rgb.r, rgb.g, rgb.b, n);
+    xyzToLuv(rgb, n, TABLES.labCbrt, true, TABLES.luvUn, TABLES.luvVn);
+
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        dst[0] = roundByte(rgb.r[i] * 2.55f);
+        dst[1] = roundByte(rgb.g[i] * (255 / 354.0f) + 134 * 255 / 354.0f);
+        dst[2] = roundByte(rgb.b[i] * (255 / 256.0f) + 140 * 255 / 256.0f);
+    }
+}
+
+/** Writes L, C and H of the block, where the block holds L and the two
+ *  chromatic axes */
+void encodePolar(RGBBlock& block, int n, unsigned char* dst)
+{
+    float chroma[BLOCK];
+    magnitude(block.g, block.b, chroma, n);
+
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        dst[0] = truncateByte(block.r[i] * 2.55f);
+        dst[1] = truncateByte(chroma[i]);
+        dst[2] = truncateByte(fastAtan2(block.b[i], block.g[i]) *
+                              (127.5f / PI));
+    }
+}
+
+void encodeLCHUV(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    linearize(rgb, n, TABLES.gamma22Linear);
+    transform(TABLES.toLchXYZ, rgb.r, rgb.g, rgb.b, n);
+    xyzToLuv(rgb, n, TABLES.lchL, false, TABLES.lchUn, TABLES.lchVn);
+    encodePolar(rgb, n, dst);
+}
+
+/** Replaces the block with L* a* b* */
+void rgbToLab(RGBBlock& rgb, int n)
+{
+    linearize(rgb, n, TABLES.srgbLinear);
+    transform(TABLES.toLabXYZ, rgb.r, rgb.g, rgb.b, n);
+    for (int i = 0; i < n; ++i)
+    {
+        float fx = TABLES.labCbrt(rgb.r[i]);
+        float fy = TABLES.labCbrt(rgb.g[i]);
+        float fz = TABLES.labCbrt(rgb.b[i]);
+
+        rgb.r[i] = 116 * fy - 16;
+        rgb.g[i] = 500 * (fx - fy);
+        rgb.b[i] = 200 * (fy - fz);
+    }
+}
+
+void encodeLAB(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    rgbToLab(rgb, n);
+    for (int i = 0; i < n; ++i, dst += 3)
+    {
+        dst[0] = roundByte(rgb.r[i] * 2.55f);
+        dst[1] = roundByte(rgb.g[i] + 128);
+        dst[2] = roundByte(rgb.b[i] + 128);
+    }
+}
+
+void encodeLCHAB(RGBBlock& rgb, int n, unsigned char* dst)
+{
+    rgbToLab(rgb, n);
+    encodePolar(rgb, n, dst);
+}
+
+// ------------------------------------------------------------------------
+// Dispatch
+
+struct FormatCodec
+{
+    Decoder decode;
+    Encoder encode;
+};
+
+/** Indexed by Image::PixelFormat */
+const FormatCodec CODECS[Image::PF_END] = {
+    {0, 0},                        // PF_START
+    {decodeRGB, encodeRGB},        // PF_RGB_8
+    {decodeBGR, encodeBGR},        // PF_BGR_8
+    {decodeYUV, encodeYUV},        // PF_YUV444_8
+    {decodeGray, encodeGray},      // PF_GRAY_8
+    {decodeHSV, encodeHSV},        // PF_HSV_8
+    {decodeLUV, encodeLUV},        // PF_LUV_8
+    {decodeLCHUV, encodeLCHUV},    // PF_LCHUV_8
+    {decodeLAB, encodeLAB},        // PF_LAB_8
+    {decodeLCHAB, encodeLCHAB}     // PF_LCHAB_8
+};
+
+bool isRGBOrBGR(Image::PixelFormat format)
+{
+    return (Image::PF_RGB_8 == format) || (Image::PF_BGR_8 == format);
+}
+
+void swapRedBlue(const unsigned char* src, unsigned char* dst, int n)
+{
+    for (int i = 0; i < n; ++i, src += 3, dst += 3)
+    {
+        unsigned char first = src[0];
+        dst[1] = src[1];
+        dst[0] = src[2];
+        dst[2] = first;
+    }
+}
+
+void grayToColor(const unsigned char* src, unsigned char* dst, int n)
+{
+    for (int i = 0; i < n; ++i, dst += 3)
+        dst[0] = dst[1] = dst[2] = src[i];
+}
+
+/** Uses LCHConverter's precomputed table, it's faster than anything */
+void lookupLCHUV(const unsigned char* table, bool bgr,
+                 const unsigned char* src, unsigned char* dst, int n)
+{
+    int first = bgr ? 2 : 0, last = bgr ? 0 : 2;
+    for (int i = 0; i < n; ++i, src += 3, dst += 3)
+    {
+        const unsigned char* lch =
+            table + ((src[first] * 256 + src[1]) * 256 + src[last]) * 3;
+        dst[0] = lch[0];
+        dst[1] = lch[1];
+        dst[2] = lch[2];
+    }
+}
+
+} // namespace
+
+bool ColorConverter::canConvert(Image::PixelFormat from,
+                                Image::PixelFormat to)
+{
+    return (from > Image::PF_START) && (from < Image::PF_END) &&
+        (to > Image::PF_START) && (to < Image::PF_END);
+}
+
+void ColorConverter::convert(Image::PixelFormat from,
+                             const unsigned char* src, int srcStep,
+                             Image::PixelFormat to, unsigned char* dst,
+                             int dstStep, int width, int height)
+{
+    assert(canConvert(from, to) && "Invalid pixel formats");
+
+    int srcChannels = Image::getFormatNumChannels(from);
+    int dstChannels = Image::getFormatNumChannels(to);
+    assert((src != dst || srcChannels == dstChannels) &&
+           "Can only convert in place between same size pixels");
+
+    const unsigned char* lchTable = 0;
+    if (isRGBOrBGR(from) && (Image::PF_LCHUV_8 == to))
+        lchTable = LCHConverter::getLookupTable();
+
+    const FormatCodec& decoder = CODECS[from];
+    const FormatCodec& encoder = CODECS[to];
+    RGBBlock block;
+
+    for (int y = 0; y < height; ++y, src += srcStep, dst += dstStep)
+    {
+        if (from == to)
+        {
+            if (src != dst)
+                memcpy(dst, src, width * srcChannels);
+        }
+        else if (isRGBOrBGR(from) && isRGBOrBGR(to))
+        {
+            swapRedBlue(src, dst, width);
+        }
+        else if ((Image::PF_GRAY_8 == from) && isRGBOrBGR(to))
+        {
+            grayToColor(src, dst, width);
+        }
+        else if (lchTable)
+        {
+            lookupLCHUV(lchTable, Image::PF_BGR_8 == from, src, dst, width);
+        }
+        else
+        {
+            for (int x = 0; x < width; x += BLOCK)
+            {
+                int n = std::min(BLOCK, width - x);
+                decoder.decode(src + x * srcChannels, n, block);
+                encoder.encode(block, n, dst + x * dstChannels);
+            }
+        }
+    }
+}
+
+} // namespace vision
+} // namespace ram
@@ -228,6 +228,8 @@ void CupidDetector::setLookupTable(bool lookupTable)
 
 void CupidDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     input->setPixelFormat(Image::PF_BGR_8);
     m_frame->copyFrom(input);
 
@@ -347,12 +349,12 @@ void CupidDetector::processImage(Image* input, Image* output)
     if(output)
     {
         output->copyFrom(m_frame);
-        if(m_debug > 0)
+        if(debugLevel(m_debug) > 0)
         {
             Image::fillMask(output, m_redFrame, 200, 0, 0);
             Image::fillMask(output, m_blueFrame, 0, 0, 200);
             
-            if(m_debug == 2)
+            if(debugLevel(m_debug) == 2)
             {
                 if(redFound)
                     drawDebugCircle(redBlob, output, 200, 0, 0);
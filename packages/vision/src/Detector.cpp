@@ -14,13 +14,18 @@
 #include "vision/include/Image.h"
 
 #include "core/include/PropertySet.h"
+#include "core/include/Event.h"
 
 namespace ram {
 namespace vision {
 
+Detector::DebugOutputLevel Detector::s_debugOutputLevel =
+    Detector::DEBUG_OUTPUT_FULL;
+    
 Detector::Detector(core::EventHubPtr eventHub) :
     core::EventPublisher(eventHub),
-    m_propertySet(new core::PropertySet())
+    m_propertySet(new core::PropertySet()),
+    m_frameArrivalTime(0)
 {
 }
 
@@ -29,6 +34,43 @@ core::PropertySetPtr Detector::getPropertySet()
     return m_propertySet;
 }
 
+void Detector::setFrameArrivalTime(boost::int64_t arrivalTime)
+{
+    m_frameArrivalTime = arrivalTime;
+}
+
+void Detector::publish(const core::Event::EventType& type,
+                       core::EventPtr event)
+{
+    if (0 == event->arrivalTime)
+        event->arrivalTime = m_frameArrivalTime;
+    core::EventPublisher::publish(type, event);
+}
+
+void Detector::setDebugOutputLevel(DebugOutputLevel level)
+{
+    s_debugOutputLevel = level;
+}
+
+Detector::DebugOutputLevel Detector::getDebugOutputLevel()
+{
+    return s_debugOutputLevel;
+}
+
+Image* Detector::debugOutput(Image* output)
+{
+    if (DEBUG_OUTPUT_NONE == s_debugOutputLevel)
+        return 0;
+    return output;
+}
+
+int Detector::debugLevel(int detectorLevel)
+{
+    if (DEBUG_OUTPUT_FULL == s_debugOutputLevel)
+        return detectorLevel;
+    return 0;
+}
+
 void Detector::imageToAICoordinates(const Image* image, 
                                     const int& imageX, const int& imageY,
                                     double& outX, double& outY)
@@ -81,7 +81,9 @@ void DownwardDuctDetector::init(core::ConfigNode config)
 }
     
 void DownwardDuctDetector::processImage(Image* input, Image* output)
-{   
+{
+    output = debugOutput(output);
+
     m_working->copyFrom(input);
 
     // Grab data pointers
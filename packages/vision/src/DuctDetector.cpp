@@ -23,6 +23,7 @@
 #include "vision/include/DuctDetector.h"
 #include "vision/include/Events.h"
 #include "vision/include/main.h"
+#include "vision/include/ImagePool.h"
 #include <boost/foreach.hpp>
 
 #ifndef M_PI
@@ -282,6 +283,8 @@ void DuctDetector::init(core::ConfigNode config)
     
 void DuctDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
   //  printf("\n");
 /* TODO:  Merge yellow blobs together before checking whether any contain
           black blobs, turn merging by intersection into a function of blobs
@@ -312,7 +315,7 @@ void DuctDetector::processImage(Image* input, Image* output)
     m_possiblyAligned = false;
     
     cvCvtColor(m_working->asIplImage(),m_src,CV_BGR2GRAY);
-    CvMemStorage* storage = cvCreateMemStorage(0);
+    PooledStorage storage;
     CvSeq* lines = 0;
     cvCanny(m_src, m_dst, 50, 200, 3 );
     
@@ -7,10 +7,14 @@
  * File:  packages/vision/src/FANNSymboleDetector.h
  */
 #include <iostream>
+#include <map>
+#include <algorithm>
 
 // Library Includes
 #define BOOST_FILESYSTEM_NO_DEPRECATED
 #include <boost/filesystem.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <floatfann.h>
 #include <fann_cpp.h>
@@ -23,6 +27,35 @@
 namespace ram {
 namespace vision {
 
+struct FANNSymbolDetector::Network
+{
+    FANN::neural_net net;
+    boost::mutex mutex;
+
+    /** Made from net the first time a detector asks for it */
+    boost::shared_ptr<QuantizedNetwork> quantized;
+};
+
+FANNSymbolDetector::NetworkPtr FANNSymbolDetector::getNetwork(std::string path)
+{
+    // Networks currently loaded, by file path
+    typedef std::map<std::string, boost::weak_ptr<Network> > StrNetworkMap;
+    static StrNetworkMap networks;
+    static boost::mutex networksMutex;
+
+    boost::mutex::scoped_lock lock(networksMutex);
+
+    NetworkPtr network = networks[path].lock();
+    if (!network)
+    {
+        network = NetworkPtr(new Network());
+        if (!network->net.create_from_file(path))
+            return NetworkPtr();
+        networks[path] = network;
+    }
+    return network;
+}
+
 int FANNSymbolDetector::getNumberFeatures()
 {
     return m_numberFeatures;
@@ -38,25 +71,86 @@ int FANNSymbolDetector::runNN(Image* input)
     // Grab the features from the image
     getImageFeatures(input, m_features);
 
-    // Run the detector on the features
-    fann_type* outValue = m_net->run(m_features);
-    
+    runFeatures(m_features, 1, &m_result);
+    return m_result;
+}
+
+void FANNSymbolDetector::runNN(const std::vector<Image*>& inputs,
+                               std::vector<int>& results)
+{
+    int count = (int)inputs.size();
+    results.resize(count);
+    if (count == 0)
+        return;
+
+    m_batchFeatures.resize(count * m_numberFeatures);
+    for (int i = 0; i < count; ++i)
+        getImageFeatures(inputs[i], &m_batchFeatures[i * m_numberFeatures]);
+
+    runFeatures(&m_batchFeatures[0], count, &results[0]);
+    m_result = results.back();
+}
+
+void FANNSymbolDetector::processImages(
+    const std::vector<Image*>& inputs, std::vector<Symbol::SymbolType>& symbols)
+{
+    std::vector<int> results;
+    runNN(inputs, results);
+
+    // getSymbol() maps the last result, so make each one the last in turn
+    symbols.resize(results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        m_result = results[i];
+        symbols[i] = getSymbol();
+    }
+}
+
+void FANNSymbolDetector::runFeatures(const float* features, int count,
+                                     int* results)
+{
+    m_outputs.resize(count * m_outputCount);
+
+    if (m_quantized)
+    {
+        // Never changed once made, so any number of detectors can run it
+        m_quantized->run(features, count, &m_outputs[0], m_scratch);
+    }
+    else
+    {
+        // The outputs belong to the network so they must be read before
+        // another detector runs it
+        boost::mutex::scoped_lock lock(m_net->mutex);
+        for (int i = 0; i < count; ++i)
+        {
+            fann_type* outValue = m_net->net.run(
+                const_cast<fann_type*>(features + i * m_numberFeatures));
+            std::copy(outValue, outValue + m_outputCount,
+                      &m_outputs[i * m_outputCount]);
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+        results[i] = bestOutput(&m_outputs[i * m_outputCount]);
+}
+
+int FANNSymbolDetector::bestOutput(const float* outputs)
+{
     // Find the highest output of the network
-    unsigned int highest_out = 0;
-    for (unsigned int i = 0; i < m_net->get_num_output(); ++i)
+    int highest_out = 0;
+    for (int i = 0; i < m_outputCount; ++i)
     {
-        if (outValue[i] > outValue[highest_out])
+        if (outputs[i] > outputs[highest_out])
         {
             highest_out = i;
         }
     }
-    
+
     // Determine if its above the threshold or not
-    if (outValue[highest_out] > m_outputThreshold)
-        m_result = highest_out;
+    if (outputs[highest_out] > m_outputThreshold)
+        return highest_out;
     else
-        m_result = -1;
-    return m_result;
+        return -1;
 }
 
 int FANNSymbolDetector::getResult()
@@ -73,7 +167,7 @@ FANNSymbolDetector::FANNSymbolDetector(int numberOfFeatures, int outputCount,
     m_result(-1),
     m_outputThreshold(0),
     m_features(new fann_type[numberOfFeatures]),
-    m_net(new FANN::neural_net())
+    m_net(NetworkPtr())
 {
     // NOTE: The property set automatically loads the value from the given
     //       config if its present, if not it uses the default value presented.
@@ -97,15 +191,31 @@ FANNSymbolDetector::FANNSymbolDetector(int numberOfFeatures, int outputCount,
         assert(boost::filesystem::exists(path) &&
                "Nueral network file does not exists");
     
-        // Load the network
-        assert(m_net->create_from_file(path.file_string()) &&
-               "Nueral network file found, but error in loading");
+        // Load the network, or share it if another detector already has
+        m_net = getNetwork(path.file_string());
+        assert(m_net && "Nueral network file found, but error in loading");
 
         // Ensure it matches our parameters
-        assert(getOutputCount() == (int)m_net->get_num_output() &&
+        assert(getOutputCount() == (int)m_net->net.get_num_output() &&
                "Wrong network output count");
-        assert(getNumberFeatures() == (int)m_net->get_num_input() &&
+        assert(getNumberFeatures() == (int)m_net->net.get_num_input() &&
                "Wrong network input count");
+
+        if (config["quantized"].asInt(1) == 1)
+        {
+            boost::mutex::scoped_lock lock(m_net->mutex);
+            if (!m_net->quantized)
+            {
+                m_net->quantized = boost::shared_ptr<QuantizedNetwork>(
+                    new QuantizedNetwork(m_net->net));
+            }
+            m_quantized = m_net->quantized;
+        }
+    }
+    else
+    {
+        // Not loaded while training, keep an empty network of our own
+        m_net = NetworkPtr(new Network());
     }
 }
     
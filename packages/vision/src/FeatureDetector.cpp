@@ -118,6 +118,8 @@ void FeatureDetector::update()
     
 void FeatureDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     printf("Processing\n");
 	raw=(IplImage*)(*input);
 	cvCopyImage(raw,image);
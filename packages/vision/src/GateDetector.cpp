@@ -85,7 +85,9 @@ void GateDetector::update()
 }
     
 void GateDetector::processImage(Image* input, Image* output)
-{	
+{
+    output = debugOutput(output);
+
 	IplImage* image =(IplImage*)(*input);
 //  These lines are correct only if the camera is on sideways again.
 //	rotate90Deg(image,gateFrame);//Rotate image into gateFrame, so that it will be vertical.
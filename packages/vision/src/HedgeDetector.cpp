@@ -224,6 +224,8 @@ bool HedgeDetector::processSides(Image* input,
 
 void HedgeDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     frame->copyFrom(input);
     
     BlobDetector::Blob hedgeBlob, leftBlob, rightBlob;
@@ -243,7 +245,7 @@ void HedgeDetector::processImage(Image* input, Image* output)
 
     if(output)
     {
-        if(m_debug == 0) {
+        if(debugLevel(m_debug) == 0) {
             output->copyFrom(frame);
         } else {
             output->copyFrom(frame);
@@ -263,7 +265,7 @@ void HedgeDetector::processImage(Image* input, Image* output)
                 greenPtr += 3;
             }
 
-            if(m_debug == 2) {
+            if(debugLevel(m_debug) == 2) {
 
                 if(found){
                     CvPoint center;
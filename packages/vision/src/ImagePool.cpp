@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/src/ImagePool.cpp
+ */
+
+// STD Includes
+#include <map>
+#include <vector>
+#include <cassert>
+
+// Library Includes
+#include "cv.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+
+// Project Includes
+#include "vision/include/ImagePool.h"
+
+namespace ram {
+namespace vision {
+
+namespace {
+
+/** Width, height, depth, channels */
+typedef boost::tuple<int, int, int, int> ImageKey;
+typedef std::map<ImageKey, std::vector<IplImage*> > ImageFreeLists;
+
+/** Every pooled image has its imageId pointed here, so release() can tell
+ *  them from images made some other way */
+char POOLED_MARKER = 0;
+
+struct PoolState
+{
+    boost::mutex mutex;
+    ImageFreeLists images;
+    std::vector<CvMemStorage*> storages;
+    ImagePool::Stats stats;
+};
+
+/** Never freed, so images released by destructors run at exit still have
+ *  a free list to go back to */
+PoolState& getState()
+{
+    static PoolState* state = new PoolState();
+    return *state;
+}
+
+ImageKey keyOf(const IplImage* image)
+{
+    return ImageKey(image->width, image->height, image->depth,
+                    image->nChannels);
+}
+
+} // namespace
+
+const int ImagePool::ALIGNMENT;
+const size_t ImagePool::MAX_IDLE;
+
+IplImage* ImagePool::acquire(int width, int height, int depth, int channels)
+{
+    PoolState& state = getState();
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        state.stats.acquires++;
+
+        ImageFreeLists::iterator iter =
+            state.images.find(ImageKey(width, height, depth, channels));
+        if ((state.images.end() != iter) && !iter->second.empty())
+        {
+            IplImage* image = iter->second.back();
+            iter->second.pop_back();
+
+            state.stats.hits++;
+            state.stats.idleImages--;
+            state.stats.idleBytes -= image->imageSize;
+            return image;
+        }
+    }
+
+    // cvCreateImage gets its buffer from cvAlloc, which aligns it to
+    // CV_MALLOC_ALIGN, so the rows are the same as any other image's
+    IplImage* image = cvCreateImage(cvSize(width, height), depth, channels);
+    assert(0 == ((size_t)image->imageData % ALIGNMENT) &&
+           "cvAlloc returned a misaligned buffer");
+    image->imageId = &POOLED_MARKER;
+    return image;
+}
+
+void ImagePool::release(IplImage** image)
+{
+    if (!image || !*image)
+        return;
+
+    IplImage* released = *image;
+    *image = 0;
+
+    if (&POOLED_MARKER != released->imageId)
+    {
+        cvReleaseImage(&released);
+        return;
+    }
+
+    // The next user expects the whole image
+    cvResetImageROI(released);
+
+    PoolState& state = getState();
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        state.stats.releases++;
+
+        std::vector<IplImage*>& idle = state.images[keyOf(released)];
+        if (idle.size() < MAX_IDLE)
+        {
+            idle.push_back(released);
+            state.stats.idleImages++;
+            state.stats.idleBytes += released->imageSize;
+            return;
+        }
+        state.stats.discards++;
+    }
+
+    cvReleaseImage(&released);
+}
+
+CvMemStorage* ImagePool::acquireStorage()
+{
+    PoolState& state = getState();
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        if (!state.storages.empty())
+        {
+            CvMemStorage* storage = state.storages.back();
+            state.storages.pop_back();
+            return storage;
+        }
+    }
+
+    return cvCreateMemStorage(0);
+}
+
+void ImagePool::releaseStorage(CvMemStorage** storage)
+{
+    if (!storage || !*storage)
+        return;
+
+    CvMemStorage* released = *storage;
+    *storage = 0;
+
+    // Keeps the blocks, so the next user doesn't have to allocate them
+    cvClearMemStorage(released);
+
+    PoolState& state = getState();
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        if (state.storages.size() < MAX_IDLE)
+        {
+            state.storages.push_back(released);
+            return;
+        }
+    }
+
+    cvReleaseMemStorage(&released);
+}
+
+ImagePool::Stats ImagePool::getStats()
+{
+    PoolState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+    return state.stats;
+}
+
+void ImagePool::resetStats()
+{
+    PoolState& state = getState();
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    Stats stats;
+    stats.idleImages = state.stats.idleImages;
+    stats.idleBytes = state.stats.idleBytes;
+    state.stats = stats;
+}
+
+void ImagePool::clear()
+{
+    ImageFreeLists images;
+    std::vector<CvMemStorage*> storages;
+
+    PoolState& state = getState();
+    {
+        boost::mutex::scoped_lock lock(state.mutex);
+        images.swap(state.images);
+        storages.swap(state.storages);
+        state.stats.idleImages = 0;
+        state.stats.idleBytes = 0;
+    }
+
+    for (ImageFreeLists::iterator iter = images.begin();
+         iter != images.end(); ++iter)
+    {
+        for (size_t i = 0; i < iter->second.size(); ++i)
+            cvReleaseImage(&iter->second[i]);
+    }
+    for (size_t i = 0; i < storages.size(); ++i)
+        cvReleaseMemStorage(&storages[i]);
+}
+
+} // namespace vision
+} // namespace ram
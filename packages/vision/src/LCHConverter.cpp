@@ -14,6 +14,9 @@
 #include <string>
 #include <stdlib.h>
 
+// Library Includes
+#include <boost/thread/mutex.hpp>
+
 // Project Includes
 #include "math/include/Math.h"
 #include "math/include/Vector3.h"
@@ -24,6 +27,13 @@ namespace vision {
 
 bool LCHConverter::lookupInit = false;
 
+// set when the lookup table file could not be read, so convert() falls back
+// to computing pixels instead of trying the file again every frame
+static bool lookupFailed = false;
+
+// guards loading of the lookup table, which is shared by every detector
+static boost::mutex lookupMutex;
+
 unsigned char LCHConverter::rgb2lchLookup[256][256][256][3] = {{{{0}}}};
 
 // gamma correction factor
@@ -188,9 +198,7 @@ void LCHConverter::convert(vision::Image* image)
 {
     assert(image->getPixelFormat() == Image::PF_RGB_8 && "Incorrect Pixel Format");
 
-    bool lookupTableAvailable = true;
-    if(!lookupInit)
-        lookupTableAvailable = loadLookupTable();
+    bool lookupTableAvailable = lookupTableReady();
     
     unsigned char *data = (unsigned char *) image->getData();
 
@@ -218,6 +226,21 @@ void LCHConverter::convert(vision::Image* image)
     }
 }
 
+const unsigned char* LCHConverter::getLookupTable()
+{
+    return lookupTableReady() ? &rgb2lchLookup[0][0][0][0] : 0;
+}
+
+bool LCHConverter::lookupTableReady()
+{
+    {
+        boost::mutex::scoped_lock lock(lookupMutex);
+        if (lookupInit || lookupFailed)
+            return lookupInit;
+    }
+    return loadLookupTable();
+}
+
 void LCHConverter::convertPixel(unsigned char &r,
                                 unsigned char &g,
                                 unsigned char &b)
@@ -277,6 +300,12 @@ void LCHConverter::saveLookupTable(const char *data)
 
 bool LCHConverter::loadLookupTable()
 {
+    boost::mutex::scoped_lock lock(lookupMutex);
+
+    // Already loaded by another detector
+    if (lookupInit)
+        return true;
+
     std::ifstream lookupFile;
     char *data = (char *) &rgb2lchLookup[0][0][0][0];
     std::string baseDir(getenv("RAM_SVN_DIR"));
@@ -287,8 +316,10 @@ bool LCHConverter::loadLookupTable()
         lookupFile.seekg(0, std::ios::beg);
         lookupFile.read(data, 256*256*256*3);
         lookupInit = true;
+        lookupFailed = false;
         return true;
     } else {
+        lookupFailed = true;
         return false;
     }
 }
@@ -18,6 +18,7 @@
 #include "vision/include/Image.h"
 #include "vision/include/LineDetector.h"
 #include "vision/include/OpenCVImage.h"
+#include "vision/include/ImagePool.h"
 
 namespace ram {
 namespace vision {
@@ -91,6 +92,8 @@ void LineDetector::init(core::ConfigNode config)
 
 void LineDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Clear the line list
     m_lines.clear();
 
@@ -213,7 +216,7 @@ void LineDetector::processImage(Image* input, Image* output)
 int LineDetector::houghTransform()
 {
     // Create memory storage for cvHoughLines2
-    CvMemStorage* storage = cvCreateMemStorage(0);
+    PooledStorage storage;
     CvSeq* lines = 0;
 
     // ThetaThreshold = 0.5, RhoThreshold = 0.5
@@ -291,6 +291,8 @@ bool LoversLaneDetector::processSides(Image* input,
 
 void LoversLaneDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     frame->copyFrom(input);
     
     BlobDetector::Blob loversLaneBlob, leftBlob, rightBlob;
@@ -316,7 +318,7 @@ void LoversLaneDetector::processImage(Image* input, Image* output)
 
     if(output)
     {
-        if(m_debug == 0) {
+        if(debugLevel(m_debug) == 0) {
             output->copyFrom(frame);
         } else {
             output->copyFrom(frame);
@@ -336,7 +338,7 @@ void LoversLaneDetector::processImage(Image* input, Image* output)
                 greenPtr += 3;
             }
 
-            if(m_debug == 2) {
+            if(debugLevel(m_debug) == 2) {
 
                 if(found){
                     CvPoint center;
@@ -98,14 +98,16 @@ void NullDetector::setImageLogging(bool value)
 
 void NullDetector::processImage(Image* input, Image* output)
 {
-    
+    output = debugOutput(output);
+
     frame->copyFrom(input);
 
     if(m_logImages)
     {
         logImage(frame);
     }
-    output->copyFrom(input);
+    if (output)
+        output->copyFrom(input);
 }
 
 
@@ -20,12 +20,11 @@
 #include "highgui.h"
 
 // Project incldues
-#include "vision/include/LCHConverter.h"
+#include "vision/include/ColorConverter.h"
 #include "vision/include/Exception.h"
+#include "vision/include/ImagePool.h"
 #include "vision/include/OpenCVImage.h"
 
-#define RGB2LCHUV -3
-
 /** Error handler to send an abort signal if OpenCV throws an error */
 int cvErrorHandler(int status, char const* func_name,
                    char const* err_msg, char const* file_name,
@@ -68,7 +67,7 @@ OpenCVImage::OpenCVImage(int width, int height, Image::PixelFormat fmt) :
     int depth = getFormatDepth(fmt);
     int channels = getFormatNumChannels(fmt);
 
-    m_img = cvCreateImage(cvSize(width, height), depth, channels);
+    m_img = ImagePool::acquire(width, height, depth, channels);
     assert(m_img && "Error creating OpenCV Image");
 }
     
@@ -143,10 +142,10 @@ void OpenCVImage::copyFrom(const Image* src)
         if (m_img)
         {
             assert(m_own && "Cannot perform resize unless I own the image");
-            cvReleaseImage(&m_img);
+            ImagePool::release(&m_img);
         }
-        m_img = cvCreateImage(cvSize(src->getWidth(), src->getHeight()),
-                              src->getDepth(), src->getNumChannels());
+        m_img = ImagePool::acquire(src->getWidth(), src->getHeight(),
+                                   src->getDepth(), src->getNumChannels());
     }
 
     // Copy the internal image data over
@@ -167,7 +166,7 @@ OpenCVImage::~OpenCVImage()
         }
         else if (m_img)
         {
-            cvReleaseImage(&m_img);
+            ImagePool::release(&m_img);
         }
     }
     else if (m_data)
@@ -240,10 +239,10 @@ void  OpenCVImage::setSize(int width, int height)
     int depth = getDepth();
     int channels = getNumChannels();
 
-    m_img = cvCreateImage(cvSize(width, height), depth, channels);
+    m_img = ImagePool::acquire(width, height, depth, channels);
     cvResize (old, m_img);
     
-    cvReleaseImage(&old);
+    ImagePool::release(&old);
 }
 
 void OpenCVImage::setPixelFormat(Image::PixelFormat format)
@@ -252,79 +251,48 @@ void OpenCVImage::setPixelFormat(Image::PixelFormat format)
     assert(format != PF_END   && "No format specified");
     assert(m_own && "Must have ownership of the image to change its format");
 
-    /**
-     * Lookup table for conversion codes
-     * Invalid conversions labeled with -1
-     * Conversions to the same colorspace labeled with -2
-     * Conversions on a sentinal value are ALWAYS invalid
-     * Macros are defined in cv.h
-     *
-     * Table is constructed so the row is the current colorspace,
-     * column is the colorspace to convert to.
-     */
-    static const int lookupTable[11][11] = {
-        /* Sentinal value */
-        {-1,         -1,         -1,-1,         -1,        -1,        -1,        -1, -1, -1, -1},
-        /* RGB */
-        {-1,         -2, CV_RGB2BGR,-1,CV_RGB2GRAY,CV_RGB2HSV,CV_RGB2Luv, RGB2LCHUV, -1, -1, -1},
-        /* BGR */
-        {-1, CV_BGR2RGB,         -2,-1,CV_BGR2GRAY,CV_BGR2HSV,CV_BGR2Luv,        -1, -1, -1, -1},
-        /* YUV */
-        {-1,         -1,         -1,-2,         -1,        -1,        -1,        -1, -1, -1, -1},
-        /* Grayscale */
-        {-1,CV_GRAY2RGB,CV_GRAY2BGR,-1,         -2,        -1,        -1,        -1, -1, -1, -1},
-        /* HSV */ 
-        {-1, CV_HSV2RGB, CV_HSV2BGR,-1,         -1,        -2,        -1,        -1, -1, -1, -1},
-        /* CIELUV */
-        {-1, CV_Luv2RGB, CV_Luv2BGR,-1,         -1,        -1,        -2,        -1, -1, -1, -1},
-        /* CIELCh_uv */
-        {-1,         -1,         -1,-1,         -1,        -1,        -1,        -2, -1, -1, -1},
-        /* CIELAB */
-        {-1,         -1,         -1,-1,         -1,        -1,        -1,        -1, -2, -1, -1},
-        /* CIELCh_ab */
-        {-1,         -1,         -1,-1,         -1,        -1,        -1,        -1, -1, -2, -1},
-        /* Sentinal value */
-        {-1,         -1,         -1,-1,         -1,        -1,        -1,        -1, -1, -1, -2}
-    };
-
-    int code = lookupTable[m_fmt][format];
-    if(code == RGB2LCHUV) {
-        LCHConverter::convert(this);
-        m_fmt = Image::PF_LCHUV_8;
-    } else if (code == -1) {
+    if (format == m_fmt)
+        return;
+    if (!ColorConverter::canConvert(m_fmt, format))
         throw ImageConversionException(m_fmt, format);
-    } else if (code != -2) {
-        // If the number of channels or depth change, we need a new image
-        int depth = getDepth();
-        int channels = getNumChannels();
-
-        int newDepth = getFormatDepth(format);
-        int newChannels = getFormatNumChannels(format);
-
-        if (depth != newDepth || channels != newChannels) {
-            // Create a new image with the new depth/channels
-            IplImage* newImg = cvCreateImage(cvGetSize(m_img),
-                                             newDepth, newChannels);
-            cvCvtColor(m_img, newImg, code);
-
-            // Delete old image data
-            if (m_data) {
-                cvReleaseImageHeader(&m_img);
-                delete[] m_data;
-                m_data = NULL;
-            } else {
-                cvReleaseImage(&m_img);
-            }
-
-            // Assign modified image as current image
-            m_img = newImg;
+
+    int width = getWidth();
+    int height = getHeight();
+    int newDepth = getFormatDepth(format);
+    int newChannels = getFormatNumChannels(format);
+
+    // If the number of channels or depth change, we need a new image
+    if ((int)getDepth() != newDepth || (int)getNumChannels() != newChannels)
+    {
+        IplImage* newImg = ImagePool::acquire(width, height,
+                                              newDepth, newChannels);
+        ColorConverter::convert(m_fmt, (unsigned char*)m_img->imageData,
+                                m_img->widthStep, format,
+                                (unsigned char*)newImg->imageData,
+                                newImg->widthStep, width, height);
+
+        // Delete old image data
+        if (m_data) {
+            cvReleaseImageHeader(&m_img);
+            delete[] m_data;
+            m_data = NULL;
         } else {
-            cvCvtColor(m_img, m_img, code);
+            ImagePool::release(&m_img);
         }
 
-        // Change the format flag
-        m_fmt = format;
+        // Assign modified image as current image
+        m_img = newImg;
     }
+    else
+    {
+        ColorConverter::convert(m_fmt, (unsigned char*)m_img->imageData,
+                                m_img->widthStep, format,
+                                (unsigned char*)m_img->imageData,
+                                m_img->widthStep, width, height);
+    }
+
+    // Change the format flag
+    m_fmt = format;
 }
 
 OpenCVImage::operator IplImage* ()
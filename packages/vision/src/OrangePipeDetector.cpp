@@ -197,6 +197,8 @@ OrangePipeDetector::~OrangePipeDetector()
 
 void OrangePipeDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     //Plan is:  Search out orange with a strict orange filter, as soon as we
     // see a good deal of orange use a less strict filter, and reduce the
     // amount we need to see. In theory this makes us follow the pipeline as
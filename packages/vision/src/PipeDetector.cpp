@@ -140,6 +140,8 @@ void PipeDetector::setHough(bool value)
 
 void PipeDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Find all blobs that could be pipes
     if (found())
         m_blobDetector.setMinimumBlobSize(m_minPixelsFound);
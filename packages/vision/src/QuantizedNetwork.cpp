@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/src/QuantizedNetwork.cpp
+ */
+
+// STD Includes
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+// Library Includes
+#include <floatfann.h>
+#include <fann_cpp.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+
+// Project Includes
+#include "vision/include/QuantizedNetwork.h"
+
+namespace ram {
+namespace vision {
+
+namespace {
+
+/** Columns in a SIMD register */
+const int BLOCK = 8;
+
+/** Largest magnitude of a quantized weight or value
+ *
+ *  Two products of this size still add up to less than 2^31, which is what
+ *  each 32 bit lane of _mm_madd_epi16 holds.
+ */
+const float LIMIT = 32767;
+
+inline short roundToShort(float value)
+{
+    return (short)std::floor(value + 0.5f);
+}
+
+/** Where FANN's stepwise sigmoids change slope */
+const float STEPS[6] = {
+    -2.64665246009826660156e+00f, -1.47221946716308593750e+00f,
+    -5.49306154251098632812e-01f, 5.49306154251098632812e-01f,
+    1.47221934795379638672e+00f, 2.64665293693542480469e+00f
+};
+
+/** The sigmoid at each step, the symmetric one is twice this less one */
+const float STEP_VALUES[6] = {
+    4.99999988824129104614e-03f, 5.00000007450580596924e-02f,
+    2.50000000000000000000e-01f, 7.50000000000000000000e-01f,
+    9.49999988079071044922e-01f, 9.95000004768371582031e-01f
+};
+
+/** FANN's piecewise linear sigmoid, from 0 to 1 */
+float stepwise(float value)
+{
+    if (value < STEPS[0])
+        return 0;
+    for (int i = 1; i < 6; ++i)
+    {
+        if (value < STEPS[i])
+        {
+            return STEP_VALUES[i - 1] +
+                (STEP_VALUES[i] - STEP_VALUES[i - 1]) *
+                (value - STEPS[i - 1]) / (STEPS[i] - STEPS[i - 1]);
+        }
+    }
+    return 1;
+}
+
+/** Sums a[i] * b[i], length must be a multiple of BLOCK */
+double dot(const short* a, const short* b, int length)
+{
+#ifdef __SSE2__
+    // Each pair of products is moved into doubles before the next is added
+    __m128d sum = _mm_setzero_pd();
+    for (int i = 0; i < length; i += BLOCK)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i pairs = _mm_madd_epi16(x, y);
+        sum = _mm_add_pd(sum, _mm_cvtepi32_pd(pairs));
+        sum = _mm_add_pd(sum, _mm_cvtepi32_pd(
+            _mm_shuffle_epi32(pairs, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    double halves[2];
+    _mm_storeu_pd(halves, sum);
+    return halves[0] + halves[1];
+#else
+    double total = 0;
+    for (int i = 0; i < length; ++i)
+        total += a[i] * b[i];
+    return total;
+#endif // __SSE2__
+}
+
+} // namespace
+
+QuantizedNetwork::QuantizedNetwork(FANN::neural_net& net) :
+    m_numInput(net.get_num_input()),
+    m_numOutput(net.get_num_output()),
+    m_numNeurons(0)
+{
+    unsigned int numLayers = net.get_num_layers();
+    assert(numLayers >= 2 && "Network has no layers");
+    std::vector<unsigned int> layerSizes(numLayers);
+    std::vector<unsigned int> biases(numLayers);
+    net.get_layer_array(&layerSizes[0]);
+    net.get_bias_array(&biases[0]);
+
+    // Neurons are numbered layer by layer, with any bias neurons at the end
+    // of their layer
+    std::vector<int> layerStarts(numLayers);
+    for (unsigned int i = 0; i < numLayers; ++i)
+    {
+        layerStarts[i] = m_numNeurons;
+        for (unsigned int j = 0; j < biases[i]; ++j)
+            m_biasNeurons.push_back(m_numNeurons + layerSizes[i] + j);
+        m_numNeurons += layerSizes[i] + biases[i];
+    }
+
+    std::vector<FANN::connection> connections(net.get_total_connections());
+    if (!connections.empty())
+        net.get_connection_array(&connections[0]);
+
+    m_layers.resize(numLayers - 1);
+    for (unsigned int i = 1; i < numLayers; ++i)
+    {
+        Layer& layer = m_layers[i - 1];
+        layer.first = layerStarts[i];
+        layer.size = layerSizes[i];
+        int last = layer.first + layer.size;
+
+        // Find the neurons feeding this layer, just the layer before it
+        // unless this is a shortcut network
+        int begin = m_numNeurons;
+        int end = 0;
+        for (size_t c = 0; c < connections.size(); ++c)
+        {
+            int to = connections[c].to_neuron;
+            if ((layer.first <= to) && (to < last))
+            {
+                begin = std::min(begin, (int)connections[c].from_neuron);
+                end = std::max(end, (int)connections[c].from_neuron + 1);
+            }
+        }
+        if (end <= begin)
+            begin = end = 0;
+
+        layer.columnBegin = begin;
+        layer.columns = end - begin;
+        layer.stride = (layer.columns + BLOCK - 1) / BLOCK * BLOCK;
+
+        std::vector<float> weights(layer.size * layer.stride, 0);
+        for (size_t c = 0; c < connections.size(); ++c)
+        {
+            int to = connections[c].to_neuron;
+            if ((layer.first <= to) && (to < last))
+            {
+                weights[(to - layer.first) * layer.stride +
+                        connections[c].from_neuron - begin] +=
+                    connections[c].weight;
+            }
+        }
+
+        // Round each neuron's weights against its largest one
+        layer.weights.assign(layer.size * layer.stride, 0);
+        layer.scales.assign(layer.size, 0);
+        for (int row = 0; row < layer.size; ++row)
+        {
+            float* rowWeights = &weights[row * layer.stride];
+            float largest = 0;
+            for (int col = 0; col < layer.columns; ++col)
+                largest = std::max(largest, std::fabs(rowWeights[col]));
+            if (largest <= 0)
+                continue;
+
+            float scale = largest / LIMIT;
+            for (int col = 0; col < layer.columns; ++col)
+            {
+                layer.weights[row * layer.stride + col] =
+                    roundToShort(rowWeights[col] / scale);
+            }
+            layer.scales[row] = scale;
+        }
+
+        layer.activations.resize(layer.size);
+        layer.steepness.resize(layer.size);
+        for (int n = 0; n < layer.size; ++n)
+        {
+            layer.activations[n] = net.get_activation_function(i, n);
+            layer.steepness[n] = net.get_activation_steepness(i, n);
+        }
+    }
+}
+
+int QuantizedNetwork::getNumInput() const
+{
+    return m_numInput;
+}
+
+int QuantizedNetwork::getNumOutput() const
+{
+    return m_numOutput;
+}
+
+void QuantizedNetwork::run(const float* inputs, int count, float* outputs,
+                           Scratch& scratch) const
+{
+    scratch.values.resize(count * m_numNeurons);
+    scratch.scales.resize(count);
+
+    // Lay out each input set with its bias neurons
+    for (int set = 0; set < count; ++set)
+    {
+        float* values = &scratch.values[set * m_numNeurons];
+        std::copy(inputs + set * m_numInput,
+                  inputs + (set + 1) * m_numInput, values);
+        for (size_t i = 0; i < m_biasNeurons.size(); ++i)
+            values[m_biasNeurons[i]] = 1;
+    }
+
+    for (size_t i = 0; i < m_layers.size(); ++i)
+    {
+        const Layer& layer = m_layers[i];
+
+        // Round what feeds the layer, for every input set
+        scratch.quantized.assign(count * layer.stride, 0);
+        for (int set = 0; set < count; ++set)
+        {
+            const float* feed =
+                &scratch.values[set * m_numNeurons + layer.columnBegin];
+            float largest = 0;
+            for (int col = 0; col < layer.columns; ++col)
+                largest = std::max(largest, std::fabs(feed[col]));
+
+            scratch.scales[set] = largest / LIMIT;
+            if (largest <= 0)
+                continue;
+
+            float inverse = LIMIT / largest;
+            short* quantized = &scratch.quantized[set * layer.stride];
+            for (int col = 0; col < layer.columns; ++col)
+                quantized[col] = roundToShort(feed[col] * inverse);
+        }
+
+        // Each row of weights is used for every input set before the next
+        for (int row = 0; row < layer.size; ++row)
+        {
+            const short* weights = &layer.weights[row * layer.stride];
+            for (int set = 0; set < count; ++set)
+            {
+                double sum = dot(weights,
+                                 &scratch.quantized[set * layer.stride],
+                                 layer.stride) *
+                    layer.scales[row] * scratch.scales[set];
+                scratch.values[set * m_numNeurons + layer.first + row] =
+                    activate(layer.activations[row],
+                             (float)sum * layer.steepness[row]);
+            }
+        }
+    }
+
+    int outputStart = m_layers.back().first;
+    for (int set = 0; set < count; ++set)
+    {
+        const float* values = &scratch.values[set * m_numNeurons];
+        std::copy(values + outputStart, values + outputStart + m_numOutput,
+                  outputs + set * m_numOutput);
+    }
+}
+
+float QuantizedNetwork::activate(int function, float value)
+{
+    // The same functions as fann_activation.h
+    switch (function)
+    {
+        case FANN::LINEAR:
+            return value;
+        case FANN::THRESHOLD:
+            return (value < 0) ? 0 : 1;
+        case FANN::THRESHOLD_SYMMETRIC:
+            return (value < 0) ? -1 : 1;
+        case FANN::SIGMOID:
+            return 1 / (1 + std::exp(-2 * value));
+        case FANN::SIGMOID_STEPWISE:
+            return stepwise(value);
+        case FANN::SIGMOID_SYMMETRIC:
+            return 2 / (1 + std::exp(-2 * value)) - 1;
+        case FANN::SIGMOID_SYMMETRIC_STEPWISE:
+            return 2 * stepwise(value) - 1;
+        case FANN::GAUSSIAN:
+        case FANN::GAUSSIAN_STEPWISE:
+            return std::exp(-value * value);
+        case FANN::GAUSSIAN_SYMMETRIC:
+            return 2 * std::exp(-value * value) - 1;
+        case FANN::ELLIOT:
+            return value / 2 / (1 + std::fabs(value)) + 0.5f;
+        case FANN::ELLIOT_SYMMETRIC:
+            return value / (1 + std::fabs(value));
+        case FANN::LINEAR_PIECE:
+            return std::max(0.0f, std::min(1.0f, value));
+        case FANN::LINEAR_PIECE_SYMMETRIC:
+            return std::max(-1.0f, std::min(1.0f, value));
+        case FANN::SIN_SYMMETRIC:
+            return std::sin(value);
+        case FANN::COS_SYMMETRIC:
+            return std::cos(value);
+        case FANN::SIN:
+            return std::sin(value) / 2 + 0.5f;
+        case FANN::COS:
+            return std::cos(value) / 2 + 0.5f;
+        default:
+            assert(false && "Unknown activation function");
+            return value;
+    }
+}
+
+} // namespace vision
+} // namespace ram
@@ -18,6 +18,7 @@
 #include "vision/include/RawFileCamera.h"
 #include "vision/include/RawFileRecorder.h"
 #include "vision/include/OpenCVImage.h"
+#include "core/include/Clock.h"
 
 namespace ram {
 namespace vision {
@@ -29,6 +30,8 @@ RawFileCamera::RawFileCamera(std::string filename) :
     m_duration(0),
     m_currentTime(0),
     m_currentFrame(0),
+    m_playTime(0),
+    m_framesPlayed(0),
     m_dataBuffer(0),
     m_file(0),
     m_fileSize(0)
@@ -83,6 +86,21 @@ RawFileCamera::~RawFileCamera()
 
 void RawFileCamera::update(double timestep)
 {
+    if (core::Clock::isVirtual())
+    {
+        // Stepped in lockstep, so play the video at its own rate instead of
+        // reading a frame every update
+        m_playTime += timestep;
+        int frames = (int)(m_playTime * m_fps + 1e-6) + 1;
+        if (frames <= m_framesPlayed)
+            return;
+
+        // Skip the frames we stepped over
+        for (int i = m_framesPlayed + 1; i < frames; ++i)
+            readNextFrame(true);
+        m_framesPlayed = frames;
+    }
+    
     // Grab the next frame
     readNextFrame();
 
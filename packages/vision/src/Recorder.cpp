@@ -50,6 +50,7 @@ Recorder::Recorder(Camera* camera, Recorder::RecordingPolicy policy,
     m_newFrame(false),
     m_camera(camera),
     m_frameFromCamera(new OpenCVImage(camera->width(), camera->height())),
+    m_frameArrivalTime(0),
     m_frameResized(new OpenCVImage(recordWidth, recordHeight)),
     m_currentTime(0),
     m_nextRecordTime(0)
@@ -83,9 +84,7 @@ void Recorder::update(double timeSinceLastUpdate)
             // Don't record if not enough time has passed
             if (m_currentTime < m_nextRecordTime)
             {
-                boost::this_thread::sleep(
-                    boost::posix_time::seconds(
-                        m_nextRecordTime - m_currentTime));
+                core::TimeVal::sleep(m_nextRecordTime - m_currentTime);
             }
             else
             {
@@ -100,7 +99,7 @@ void Recorder::update(double timeSinceLastUpdate)
             if (m_newFrame)
             {
                 // Get a working copy of new frame from the camera
-                m_camera->getImage(m_frameFromCamera);
+                m_camera->getImage(m_frameFromCamera, &m_frameArrivalTime);
                 m_frameFromCamera->setSize(m_width, m_height);
                 recordFrame(m_frameFromCamera);
                 {
@@ -240,6 +239,11 @@ void Recorder::waitForImage(Camera* camera)
 {
     camera->waitForImage(0);
 }
+
+boost::int64_t Recorder::getFrameArrivalTime()
+{
+    return m_frameArrivalTime;
+}
     
 void Recorder::newImageCapture(core::EventPtr event)
 {
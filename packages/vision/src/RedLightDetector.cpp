@@ -192,6 +192,8 @@ void RedLightDetector::update()
     
 void RedLightDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Resize images if needed
     if ((image->width != (int)input->getWidth()) &&
         (image->height != (int)input->getHeight()))
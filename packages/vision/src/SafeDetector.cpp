@@ -97,6 +97,8 @@ void SafeDetector::init(core::ConfigNode config)
     
 void SafeDetector::processImage(Image* input, Image* out)
 {
+    out = debugOutput(out);
+
     BlobDetector::Blob empty(0,0,0,0,0,0,0);
 
     m_working->copyFrom(input);
@@ -18,6 +18,17 @@ SymbolDetector::SymbolDetector(core::EventHubPtr eventHub) :
     Detector(eventHub)
 {
 }
+
+void SymbolDetector::processImages(const std::vector<Image*>& inputs,
+                                   std::vector<Symbol::SymbolType>& symbols)
+{
+    symbols.resize(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        processImage(inputs[i]);
+        symbols[i] = getSymbol();
+    }
+}
     
 } // namespace vision
 } // namespace ram
@@ -10,7 +10,11 @@
 // STD Includes
 #include <iostream>
 #include <fstream>
+#include <map>
+
 // Library Includes
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 
@@ -23,15 +27,37 @@
 namespace ram {
 namespace vision {
 
+typedef std::map<std::string, boost::weak_ptr<core::BitField3D> >
+    StrBitFieldMap;
+
+/** Tables currently loaded, by file path */
+static StrBitFieldMap s_lookupTables;
+static boost::mutex s_lookupTablesMutex;
+
 TableColorFilter::TableColorFilter(std::string filepath) :
-    m_filterTable(256u, 256u, 256u),
+    m_filterTable(getLookupTable(filepath)),
     m_propertySet(core::PropertySetPtr()),
     m_filepath(filepath)
 {
-    if(!loadLookupTable())
+    if(!m_filterTable)
         assert(false && "lookup table could not be loaded");
 }
 
+boost::shared_ptr<core::BitField3D> TableColorFilter::getLookupTable(
+    std::string filepath)
+{
+    boost::mutex::scoped_lock lock(s_lookupTablesMutex);
+
+    boost::shared_ptr<core::BitField3D> table =
+        s_lookupTables[filepath].lock();
+    if (!table)
+    {
+        table = loadLookupTable(filepath);
+        s_lookupTables[filepath] = table;
+    }
+    return table;
+}
+
 
 void TableColorFilter::saveLookupTable(std::string filepath, core::BitField3D &filterTable)
 {
@@ -44,14 +70,17 @@ void TableColorFilter::saveLookupTable(std::string filepath, core::BitField3D &f
     }
 }
 
-bool TableColorFilter::loadLookupTable()
+boost::shared_ptr<core::BitField3D> TableColorFilter::loadLookupTable(
+    std::string filepath)
 {
-    std::ifstream ifs(m_filepath.c_str());
+    boost::shared_ptr<core::BitField3D> table(
+        new core::BitField3D(256u, 256u, 256u));
+    std::ifstream ifs(filepath.c_str());
     {
         boost::archive::binary_iarchive ia(ifs);
-        ia >> m_filterTable;
+        ia >> *table;
     }
-    return true;
+    return table;
 }
 
 void TableColorFilter::createLookupTable(std::string filepath, 
@@ -110,7 +139,7 @@ void TableColorFilter::filterImage(Image* input, Image* output)
 
     for(int i = 0; i < numPixels; ++i)
     {
-        unsigned char result = m_filterTable(
+        unsigned char result = (*m_filterTable)(
             *inputData, *(inputData + 1), *(inputData + 2));
 
         for(int k = 0; k < nChannels; k++, outputData++)
@@ -144,7 +173,7 @@ void TableColorFilter::inverseFilterImage(Image* input, Image* output)
 
     for(int i = 0; i < numPixels; ++i)
     {
-        unsigned char result = !m_filterTable(
+        unsigned char result = !(*m_filterTable)(
             *inputData, *(inputData + 1), *(inputData + 2));
 
         for(int k = 0; k < nChannels; k++, outputData++)
@@ -139,6 +139,8 @@ void TargetDetector::setBottomRemovePercentage(double percent)
     
 void TargetDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Ensure our working image is the same size
     if ((m_image->getWidth() != input->getWidth()) || 
         (m_image->getHeight() != input->getHeight()))
@@ -102,6 +102,8 @@ VelocityDetector::~VelocityDetector()
     
 void VelocityDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     // Resize images and data structures if needed
     if ((m_lastFrame->getWidth() != input->getWidth()) &&
         (m_lastFrame->getHeight() != input->getHeight()))
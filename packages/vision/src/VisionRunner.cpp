@@ -18,6 +18,7 @@
 #include "vision/include/VisionRunner.h"
 #include "vision/include/Camera.h"
 #include "vision/include/Detector.h"
+#include "core/include/Clock.h"
 
 namespace ram {
 namespace vision {
@@ -48,7 +49,7 @@ void VisionRunner::update(double timestep)
     {
         if (backgrounded())
             unbackground(false);
-        else
+        else if (!core::Clock::isVirtual())
             background(-1);
     }
 }
@@ -87,9 +88,12 @@ void VisionRunner::recordFrame(Image* image)
     if(processDetectorChanges() || (m_detectors.size() == 0))
         return;
 
-    // Have each detector process the image
+    // Have each detector process the image, stamping what it finds with
+    // when the image was captured
+    boost::int64_t arrivalTime = getFrameArrivalTime();
     BOOST_FOREACH(DetectorPtr detector, m_detectors)
     {
+        detector->setFrameArrivalTime(arrivalTime);
         detector->processImage(image);
     }
 }
@@ -142,7 +146,8 @@ bool VisionRunner::processDetectorChanges(bool canBackground)
     // Background or unbackground depending on size change
     if ((0 == startSize) && (m_detectors.size() > 0))
     {
-        if (canBackground)
+        // In virtual time the VisionSystem steps us
+        if (canBackground && !core::Clock::isVirtual())
             background(-1);
         return true;
     }
@@ -8,9 +8,15 @@
  */
 
 #include <iostream>
+#include <cstdio>
+
+#ifdef RAM_LINUX
+#include <unistd.h>
+#endif
 
 // Library Includes
 #include <boost/foreach.hpp>
+#include <log4cpp/Category.hh>
 
 // Project Includes
 #include "vision/include/VisionSystem.h"
@@ -19,6 +25,7 @@
 #include "vision/include/FileRecorder.h"
 #include "vision/include/NetworkRecorder.h"
 #include "vision/include/LCHConverter.h"
+#include "vision/include/ImagePool.h"
 
 #include "vision/include/RedLightDetector.h"
 #include "vision/include/BuoyDetector.h"
@@ -38,13 +45,55 @@
 #include "core/include/EventHub.h"
 #include "core/include/SubsystemMaker.h"
 #include "core/include/Logging.h"
+#include "core/include/TimeVal.h"
 
 // Register controller in subsystem maker system
 RAM_CORE_REGISTER_SUBSYSTEM_MAKER(ram::vision::VisionSystem, VisionSystem);
 
+static log4cpp::Category& LOGGER(log4cpp::Category::getInstance("Vision"));
+
 namespace ram {
 namespace vision {
 
+template<class DetectorType>
+static DetectorPtr makeDetector(core::ConfigNode config,
+                                core::EventHubPtr eventHub)
+{
+    return DetectorPtr(new DetectorType(config, eventHub));
+}
+
+/** The detectors which can be turned on, by config section name */
+static const struct {
+    const char* name;
+    DetectorPtr (*make)(core::ConfigNode, core::EventHubPtr);
+} DETECTOR_TYPES[] = {
+    {"BuoyDetector", &makeDetector<BuoyDetector>},
+    {"BinDetector", &makeDetector<BinDetector>},
+    {"OrangePipeDetector", &makeDetector<OrangePipeDetector>},
+    {"SafeDetector", &makeDetector<SafeDetector>},
+    {"GateDetector", &makeDetector<GateDetector>},
+    {"CupidDetector", &makeDetector<CupidDetector>},
+    {"LoversLaneDetector", &makeDetector<LoversLaneDetector>}
+};
+
+/** Resident memory of the process in kB, 0 if unknown */
+static long residentMemoryKB()
+{
+    long resident = 0;
+#ifdef RAM_LINUX
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm)
+    {
+        long size = 0;
+        if (fscanf(statm, "%ld %ld", &size, &resident) != 2)
+            resident = 0;
+        fclose(statm);
+    }
+    resident *= sysconf(_SC_PAGESIZE) / 1024;
+#endif
+    return resident;
+}
+
 static math::Degree FUJINON_TF28DA8_HFOV(89 + 8.0 / 60);
 static math::Degree FUJINON_TF28DA8_VFOV(69 + 20.0 / 60);
 static math::Degree FISHEYE_HFO(107);
@@ -68,12 +117,9 @@ VisionSystem::VisionSystem(core::ConfigNode config,
     m_downwardCamera(CameraPtr()),
     m_forward(0),
     m_downward(0),
-    m_buoyDetector(DetectorPtr()),
-    m_binDetector(DetectorPtr()),
-    m_pipelineDetector(DetectorPtr()),
-    m_gateDetector(DetectorPtr()),
-    m_cupidDetector(DetectorPtr()),
-    m_loversLaneDetector(DetectorPtr())
+    m_config(config),
+    m_eventHub(core::EventHubPtr()),
+    m_detectorCacheSize(2)
 {
     init(config, core::Subsystem::getSubsystemOfType<core::EventHub>(deps));
 }
@@ -85,18 +131,18 @@ VisionSystem::VisionSystem(CameraPtr forward, CameraPtr downward,
     m_downwardCamera(downward),
     m_forward(0),
     m_downward(0),
-    m_buoyDetector(DetectorPtr()),
-    m_binDetector(DetectorPtr()),
-    m_pipelineDetector(DetectorPtr()),
-    m_gateDetector(DetectorPtr()),
-    m_cupidDetector(DetectorPtr()),
-    m_loversLaneDetector(DetectorPtr())
+    m_config(config),
+    m_eventHub(core::EventHubPtr()),
+    m_detectorCacheSize(2)
 {
     init(config, core::Subsystem::getSubsystemOfType<core::EventHub>(deps));
 }
     
 void VisionSystem::init(core::ConfigNode config, core::EventHubPtr eventHub)
 {
+    core::TimeVal startTime(core::TimeVal::timeOfDay());
+    m_eventHub = eventHub;
+    
     if (!m_forwardCamera)
     {
         core::ConfigNode cameraConfig(config["ForwardCamera"]);
@@ -119,8 +165,12 @@ void VisionSystem::init(core::ConfigNode config, core::EventHubPtr eventHub)
                                                           eventHub));
     }
 
-    // Read int as bool
-    m_testing = config["testing"].asInt(0) != 0;
+    // Read int as bool, virtual time always steps us like testing does
+    m_testing = (config["testing"].asInt(0) != 0) || core::Clock::isVirtual();
+
+    // How much debug rendering all detectors do, 0 turns it off
+    Detector::setDebugOutputLevel((Detector::DebugOutputLevel)
+        config["debugOutputLevel"].asInt(Detector::DEBUG_OUTPUT_FULL));
 
     // Load the lookup table if necessary
     int lchLookupTable = config["loadLCHLookupTable"].asInt(0);
@@ -139,26 +189,51 @@ void VisionSystem::init(core::ConfigNode config, core::EventHubPtr eventHub)
     m_forward = new VisionRunner(m_forwardCamera.get(), Recorder::NEXT_FRAME);
     m_downward = new VisionRunner(m_downwardCamera.get(), Recorder::NEXT_FRAME);
 
-    // Detectors
-    m_buoyDetector = DetectorPtr(
-        new BuoyDetector(getConfig(config, "BuoyDetector"), eventHub));
-    m_binDetector = DetectorPtr(
-        new BinDetector(getConfig(config, "BinDetector"), eventHub));
-    m_pipelineDetector = DetectorPtr(
-        new OrangePipeDetector(getConfig(config, "OrangePipeDetector"),
-                                         eventHub));
-    m_downwardSafeDetector = DetectorPtr(
-        new SafeDetector(getConfig(config, "SafeDetector"), eventHub));
-    m_gateDetector = DetectorPtr(
-        new GateDetector(getConfig(config, "GateDetector"), eventHub));
-    m_cupidDetector = DetectorPtr(
-        new CupidDetector(getConfig(config, "CupidDetector"), eventHub));
-    m_loversLaneDetector = DetectorPtr(
-        new LoversLaneDetector(getConfig(config, "LoversLaneDetector"), eventHub));
+    // Detectors are built when first turned on, except for the ones listed
+    // here, which are built now to avoid the delay later
+    int cacheSize = config["detectorCacheSize"].asInt(2);
+    if (cacheSize < 1)
+    {
+        LOGGER.warnStream() << "detectorCacheSize " << cacheSize
+                            << " is below 1, using 1";
+        cacheSize = 1;
+    }
+    m_detectorCacheSize = (size_t)cacheSize;
+    if (config.exists("preloadDetectors"))
+    {
+        core::ConfigNode preload(config["preloadDetectors"]);
+
+        // Anything past the cache size would be freed the first time any
+        // detector is turned off, so it is not worth building now
+        size_t count = preload.size();
+        if (count > m_detectorCacheSize)
+        {
+            LOGGER.warnStream() << "Only preloading the first "
+                                << m_detectorCacheSize << " of " << count
+                                << " detectors, raise detectorCacheSize to"
+                                << " preload more";
+            count = m_detectorCacheSize;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string name(preload[i].asString());
+            if (getDetector(name))
+                m_inactiveDetectors.push_back(name);
+        }
+    }
 
     // Start camera in the background (at the fastest rate possible)
-    m_forwardCamera->background(-1);
-    m_downwardCamera->background(-1);
+    if (!core::Clock::isVirtual())
+    {
+        m_forwardCamera->background(-1);
+        m_downwardCamera->background(-1);
+    }
+
+    core::TimeVal elapsed(core::TimeVal::timeOfDay() - startTime);
+    LOGGER.infoStream() << "VisionSystem started in " << elapsed.get_double()
+                        << "s, resident memory " << residentMemoryKB()
+                        << " kB";
 }
     
 void VisionSystem::createRecordersFromConfig(core::ConfigNode recorderCfg,
@@ -196,16 +271,82 @@ void VisionSystem::createRecorder(CameraPtr camera, std::string recorderString,
     m_recorders[recorderString] = recorder;
 }
     
-void VisionSystem::addForwardDetector(DetectorPtr detector)
+DetectorPtr VisionSystem::getDetector(std::string name)
 {
-    assert(detector && "Can't use a NULL detector");
-    m_forward->addDetector(detector);
+    StrDetectorMap::iterator iter = m_detectors.find(name);
+    if (m_detectors.end() != iter)
+        return iter->second;
+
+    core::TimeVal startTime(core::TimeVal::timeOfDay());
+    long startMemory = residentMemoryKB();
+
+    DetectorPtr detector;
+    for (size_t i = 0; i < sizeof(DETECTOR_TYPES) / sizeof(*DETECTOR_TYPES);
+         ++i)
+    {
+        if (name == DETECTOR_TYPES[i].name)
+        {
+            detector = DETECTOR_TYPES[i].make(getConfig(m_config, name),
+                                              m_eventHub);
+        }
+    }
+    if (!detector)
+    {
+        LOGGER.errorStream() << "Unknown detector type \"" << name
+                             << "\", skipping it";
+        return detector;
+    }
+
+    core::TimeVal elapsed(core::TimeVal::timeOfDay() - startTime);
+    LOGGER.infoStream() << "Created " << name << " in "
+                        << elapsed.get_double() << "s, resident memory +"
+                        << residentMemoryKB() - startMemory << " kB";
+
+    m_detectors[name] = detector;
+    return detector;
 }
 
-void VisionSystem::addDownwardDetector(DetectorPtr detector)
+void VisionSystem::detectorOn(std::string name, VisionRunner* runner)
 {
-    assert(detector && "Can't use a NULL detector");
-    m_downward->addDetector(detector);
+    boost::mutex::scoped_lock lock(m_detectorMutex);
+
+    if (m_activeDetectors.end() != m_activeDetectors.find(name))
+        return;
+
+    DetectorPtr detector(getDetector(name));
+    if (!detector)
+        return;
+    m_inactiveDetectors.remove(name);
+    m_activeDetectors.insert(name);
+    
+    runner->addDetector(detector);
+}
+
+void VisionSystem::detectorOff(std::string name, VisionRunner* runner)
+{
+    boost::mutex::scoped_lock lock(m_detectorMutex);
+
+    // Never turned on, so there is nothing to stop
+    if (0 == m_activeDetectors.erase(name))
+        return;
+
+    runner->removeDetector(m_detectors[name]);
+    m_inactiveDetectors.push_front(name);
+
+    // Free the least recently used detectors, the runner holds its own
+    // reference until it has actually removed the detector
+    while (m_inactiveDetectors.size() > m_detectorCacheSize)
+    {
+        m_detectors.erase(m_inactiveDetectors.back());
+        m_inactiveDetectors.pop_back();
+    }
+
+    ImagePool::Stats stats = ImagePool::getStats();
+    LOGGER.infoStream() << "Stopped " << name << ", image pool "
+                        << stats.acquires << " acquires, "
+                        << stats.hitRate() * 100 << "% reused, "
+                        << stats.idleImages << " idle images ("
+                        << stats.idleBytes / 1024 << " kB)";
 }
 
 core::ConfigNode VisionSystem::getConfig(core::ConfigNode config,
@@ -214,7 +355,7 @@ core::ConfigNode VisionSystem::getConfig(core::ConfigNode config,
     if (config.exists(name))
         return config[name];
     else
-        return core::ConfigNode::fromString("{}");
+        return core::ConfigNode::fromYamlString("{}");
 }
     
 VisionSystem::~VisionSystem()
@@ -237,98 +378,98 @@ VisionSystem::~VisionSystem()
 
 void VisionSystem::binDetectorOn()
 {
-    addDownwardDetector(m_binDetector);
+    detectorOn("BinDetector", m_downward);
     publish(EventType::BIN_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::binDetectorOff()
 {
-    m_downward->removeDetector(m_binDetector);
+    detectorOff("BinDetector", m_downward);
     publish(EventType::BIN_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::pipeLineDetectorOn()
 {
-    addDownwardDetector(m_pipelineDetector);
+    detectorOn("OrangePipeDetector", m_downward);
     publish(EventType::PIPELINE_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::pipeLineDetectorOff()
 {
-    m_downward->removeDetector(m_pipelineDetector);
+    detectorOff("OrangePipeDetector", m_downward);
     publish(EventType::PIPELINE_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::downwardSafeDetectorOn()
 {
-    addDownwardDetector(m_downwardSafeDetector);
+    detectorOn("SafeDetector", m_downward);
     publish(EventType::SAFE_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
     
 void VisionSystem::downwardSafeDetectorOff()
 {
-    m_downward->removeDetector(m_downwardSafeDetector);
+    detectorOff("SafeDetector", m_downward);
     publish(EventType::SAFE_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
     
 void VisionSystem::gateDetectorOn()
 {
-    addForwardDetector(m_gateDetector);
+    detectorOn("GateDetector", m_forward);
     publish(EventType::GATE_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::gateDetectorOff()
 {
-    m_forward->removeDetector(m_gateDetector);
+    detectorOff("GateDetector", m_forward);
     publish(EventType::GATE_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::buoyDetectorOn()
 {
-    addForwardDetector(m_buoyDetector);
+    detectorOn("BuoyDetector", m_forward);
     publish(EventType::BUOY_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::buoyDetectorOff()
 {
-    m_forward->removeDetector(m_buoyDetector);
+    detectorOff("BuoyDetector", m_forward);
     publish(EventType::BUOY_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::cupidDetectorOn()
 {
-    addForwardDetector(m_cupidDetector);
+    detectorOn("CupidDetector", m_forward);
     publish(EventType::CUPID_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::cupidDetectorOff()
 {
-    m_forward->removeDetector(m_cupidDetector);
+    detectorOff("CupidDetector", m_forward);
     publish(EventType::CUPID_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::loversLaneDetectorOn()
 {
-    addForwardDetector(m_loversLaneDetector);
+    detectorOn("LoversLaneDetector", m_forward);
     publish(EventType::LOVERSLANE_DETECTOR_ON,
             core::EventPtr(new core::Event()));
 }
 
 void VisionSystem::loversLaneDetectorOff()
 {
-    m_forward->removeDetector(m_loversLaneDetector);
+    detectorOff("LoversLaneDetector", m_forward);
     publish(EventType::LOVERSLANE_DETECTOR_OFF,
             core::EventPtr(new core::Event()));
 }
@@ -534,7 +675,7 @@ void VisionSystem::_setDownVerticalPixelResolution(int pixels)
 core::ConfigNode VisionSystem::findVisionSystemConfig(core::ConfigNode cfg,
                                                       std::string& nodeUsed)
 {
-    core::ConfigNode config(core::ConfigNode::fromString("{}"));
+    core::ConfigNode config(core::ConfigNode::fromYamlString("{}"));
     // Attempt to find the section deeper in the file
     if (cfg.exists("Subsystems"))
     {
@@ -277,6 +277,8 @@ bool WindowDetector::processBackground(Image *input, ColorFilter& filter,
 
 void WindowDetector::processImage(Image* input, Image* output)
 {
+    output = debugOutput(output);
+
     frame->copyFrom(input);
 
     BlobDetector::Blob redBlob, greenBlob, yellowBlob, blueBlob;
@@ -330,7 +332,7 @@ void WindowDetector::processImage(Image* input, Image* output)
 
     if (output)
     {
-        if (m_debug == 0) {
+        if (debugLevel(m_debug) == 0) {
             output->copyFrom(frame);
         } else {
             output->copyFrom(frame);
@@ -374,7 +376,7 @@ void WindowDetector::processImage(Image* input, Image* output)
             //     bluePtr += 3;
             // }
             
-            if (m_debug == 2) {
+            if (debugLevel(m_debug) == 2) {
                 if (redFound) {
                     CvPoint center;
                     center.x = redBlob.getCenterX();
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/test/src/BenchmarkColorConversion.cpp
+ */
+
+// Reports the throughput of every ColorConverter conversion on a camera
+// sized frame, and of the per pixel LCHConverter path setPixelFormat used
+// for RGB to LCh before.
+//
+// Usage: BenchmarkColorConversion [frames]
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+
+// Project Includes
+#include "core/include/TimeVal.h"
+#include "vision/include/ColorConverter.h"
+#include "vision/include/LCHConverter.h"
+
+using namespace ram;
+using vision::Image;
+
+static const int WIDTH = 640;
+static const int HEIGHT = 480;
+
+static const char* NAMES[] = {
+    "", "RGB", "BGR", "YUV444", "GRAY", "HSV", "LUV", "LCHUV", "LAB", "LCHAB"
+};
+
+static double seconds()
+{
+    return core::TimeVal::timeOfDay().get_double();
+}
+
+static void report(std::string name, int frames, double elapsed)
+{
+    std::cout << std::setw(16) << std::left << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1)
+              << frames * WIDTH * HEIGHT / elapsed / 1e6 << " Mpix/s"
+              << std::setw(10) << std::setprecision(2)
+              << elapsed / frames * 1000 << " ms/frame" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 20;
+
+    // Something like an underwater scene, with every format filled from it
+    std::vector<unsigned char> rgb(WIDTH * HEIGHT * 3);
+    srand(42);
+    for (size_t i = 0; i < rgb.size(); i += 3)
+    {
+        rgb[i] = rand() % 96;
+        rgb[i + 1] = 64 + rand() % 128;
+        rgb[i + 2] = 64 + rand() % 160;
+    }
+
+    std::vector<unsigned char> images[Image::PF_END];
+    for (int format = Image::PF_START + 1; format < Image::PF_END; ++format)
+    {
+        int channels = Image::getFormatNumChannels((Image::PixelFormat)format);
+        images[format].resize(WIDTH * HEIGHT * channels);
+        vision::ColorConverter::convert(
+            Image::PF_RGB_8, &rgb[0], WIDTH * 3, (Image::PixelFormat)format,
+            &images[format][0], WIDTH * channels, WIDTH, HEIGHT);
+    }
+
+    std::cout << "Converting " << frames << " " << WIDTH << "x" << HEIGHT
+              << " frames" << std::endl;
+
+    std::vector<unsigned char> dst(WIDTH * HEIGHT * 3);
+    for (int from = Image::PF_START + 1; from < Image::PF_END; ++from)
+    {
+        for (int to = Image::PF_START + 1; to < Image::PF_END; ++to)
+        {
+            if (from == to)
+                continue;
+
+            Image::PixelFormat fromFmt = (Image::PixelFormat)from;
+            Image::PixelFormat toFmt = (Image::PixelFormat)to;
+            int srcStep = WIDTH * Image::getFormatNumChannels(fromFmt);
+            int dstStep = WIDTH * Image::getFormatNumChannels(toFmt);
+
+            double start = seconds();
+            for (int i = 0; i < frames; ++i)
+            {
+                vision::ColorConverter::convert(
+                    fromFmt, &images[from][0], srcStep, toFmt, &dst[0],
+                    dstStep, WIDTH, HEIGHT);
+            }
+            report(std::string(NAMES[from]) + " -> " + NAMES[to], frames,
+                   seconds() - start);
+        }
+    }
+
+    // What RGB to LCh cost without the lookup table before
+    double start = seconds();
+    for (int i = 0; i < frames; ++i)
+    {
+        dst = rgb;
+        for (size_t j = 0; j < dst.size(); j += 3)
+            vision::LCHConverter::convertPixel(dst[j], dst[j + 1], dst[j + 2]);
+    }
+    report("LCHConverter", frames, seconds() - start);
+
+    return 0;
+}
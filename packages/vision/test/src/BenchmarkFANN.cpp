@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/test/src/BenchmarkFANN.cpp
+ */
+
+// Reports how many candidates a second the FANN symbol networks classify:
+// the float network one candidate at a time, as FANNSymbolDetector did, and
+// the QuantizedNetwork one at a time and a frame's worth at once.  Networks
+// are built like FANNTrainer builds them, at the sizes of the letter and
+// gladiator detectors and at a larger size, and how often the quantized
+// network picks a different output than the float one is printed too.
+//
+// Usage: BenchmarkFANN [frames] [candidates per frame]
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+// Library Includes
+#include <floatfann.h>
+#include <fann_cpp.h>
+
+// Project Includes
+#include "core/include/TimeVal.h"
+#include "vision/include/QuantizedNetwork.h"
+
+using namespace ram;
+
+static double seconds()
+{
+    return core::TimeVal::timeOfDay().get_double();
+}
+
+static void report(std::string name, int candidates, double elapsed)
+{
+    std::cout << "  " << std::setw(20) << std::left << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(0)
+              << candidates / elapsed << " candidates/s"
+              << std::setw(10) << std::setprecision(3)
+              << elapsed / candidates * 1e6 << " us/candidate" << std::endl;
+}
+
+static int argmax(const float* outputs, int count)
+{
+    int best = 0;
+    for (int i = 1; i < count; ++i)
+    {
+        if (outputs[i] > outputs[best])
+            best = i;
+    }
+    return best;
+}
+
+static void benchmark(int inputs, int outputs, int layers, int frames,
+                      int candidates)
+{
+    // Shaped like FANNTrainer's default, every layer as wide as the input
+    std::vector<unsigned int> layerSizes(layers, inputs);
+    layerSizes.back() = outputs;
+
+    FANN::neural_net net;
+    net.create_sparse_array(0.75, layers, &layerSizes[0]);
+    net.set_activation_steepness_hidden(0.5);
+    net.set_activation_steepness_output(0.5);
+    net.set_activation_function_hidden(FANN::SIGMOID_STEPWISE);
+    net.set_activation_function_output(FANN::SIGMOID_STEPWISE);
+    net.randomize_weights(-1, 1);
+
+    vision::QuantizedNetwork quantized(net);
+    vision::QuantizedNetwork::Scratch scratch;
+
+    // Features of different sizes, as the detectors extract
+    int total = frames * candidates;
+    std::vector<float> features(total * inputs);
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        float value = rand() / (float)RAND_MAX;
+        features[i] = (i % 2) ? value : value * 255;
+    }
+
+    std::vector<float> floatOutputs(total * outputs);
+    std::vector<float> singleOutputs(total * outputs);
+    std::vector<float> batchOutputs(total * outputs);
+
+    std::cout << inputs << " features, " << layers << " layers, "
+              << outputs << " outputs, " << net.get_total_connections()
+              << " connections" << std::endl;
+
+    double start = seconds();
+    for (int i = 0; i < total; ++i)
+    {
+        fann_type* result = net.run(&features[i * inputs]);
+        std::copy(result, result + outputs, &floatOutputs[i * outputs]);
+    }
+    report("float", total, seconds() - start);
+
+    start = seconds();
+    for (int i = 0; i < total; ++i)
+    {
+        quantized.run(&features[i * inputs], 1, &singleOutputs[i * outputs],
+                      scratch);
+    }
+    report("quantized", total, seconds() - start);
+
+    start = seconds();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        int first = frame * candidates;
+        quantized.run(&features[first * inputs], candidates,
+                      &batchOutputs[first * outputs], scratch);
+    }
+    report("quantized batch", total, seconds() - start);
+
+    float largest = 0;
+    int disagree = 0;
+    for (int i = 0; i < total; ++i)
+    {
+        const float* expected = &floatOutputs[i * outputs];
+        const float* actual = &batchOutputs[i * outputs];
+        for (int j = 0; j < outputs; ++j)
+            largest = std::max(largest, std::fabs(actual[j] - expected[j]));
+        if (argmax(expected, outputs) != argmax(actual, outputs))
+            disagree++;
+    }
+    std::cout << "  largest output difference " << std::setprecision(5)
+              << largest << ", " << disagree << " of " << total
+              << " matched differently" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 2000;
+    int candidates = (argc > 2) ? atoi(argv[2]) : 8;
+
+    std::cout << "Classifying " << frames << " frames of " << candidates
+              << " candidates" << std::endl;
+
+    srand(42);
+    // FANNLetterDetector
+    benchmark(4, 4, 3, frames, candidates);
+    // FANNGladiatorDetector
+    benchmark(6, 4, 3, frames, candidates);
+    // A network on raw pixels of a small symbol image
+    benchmark(256, 8, 3, frames, candidates);
+
+    return 0;
+}
@@ -35,12 +35,16 @@
 #include "core/include/ConfigNode.h"
 #include "core/include/EventHub.h"
 #include "core/include/PropertySet.h"
+#include "core/include/TimeVal.h"
 
 namespace po = boost::program_options;
 using namespace ram;
 
 static const char* PROCESSED_WINDOW = "Processed Image";
 
+/** Number of frames between timing reports */
+static const int TIMING_REPORT_FRAMES = 100;
+
 /** Creates a recorder based on the input stream */
 vision::Recorder* createRecorder(std::string output, vision::Camera* camera);
 
@@ -73,6 +77,7 @@ int main(int argc, char** argv)
     bool show = true;
     bool outputing = false;
     bool runDetector = false;
+    bool timing = false;
     
     try
     {
@@ -87,6 +92,9 @@ int main(int argc, char** argv)
              "Suppress display of image")
             ("disable-detector,d", po::bool_switch(&runDetector),
              "Do not run the detector on input")
+            ("timing,t", po::bool_switch(&timing),
+             "Report detector time with and without debug rendering, runs "
+             "the detector twice per frame")
             ("output,o", po::value<std::string>(&output),
              "File or network port to send images to")
             ("input", po::value<std::string>(&input),
@@ -122,7 +130,7 @@ int main(int argc, char** argv)
     if (output.length() != 0)
         outputing = true;
 
-    if (!(show || outputing))
+    if (!(show || outputing || timing))
     {
         std::cout << "Nothing to show on screen or write to disk, closing."
                   << std::endl;
@@ -173,6 +181,11 @@ int main(int argc, char** argv)
                   << std::endl;
     }
 
+    // Total detector time, with and without an output image
+    double headlessTime = 0;
+    double renderingTime = 0;
+    int timedFrames = 0;
+    
     // Main Loop
     bool inputing = true;
     while(1)
@@ -186,7 +199,29 @@ int main(int argc, char** argv)
             camera->getImage(frame);
         }
 
-        if (runDetector)
+        if (runDetector && timing)
+        {
+            core::TimeVal start(core::TimeVal::timeOfDay());
+            detector->processImage(frame, 0);
+            core::TimeVal middle(core::TimeVal::timeOfDay());
+            detector->processImage(frame, outputImage);
+            core::TimeVal end(core::TimeVal::timeOfDay());
+
+            headlessTime += (middle - start).get_double();
+            renderingTime += (end - middle).get_double();
+            workingImage = outputImage;
+
+            if (++timedFrames % TIMING_REPORT_FRAMES == 0)
+            {
+                std::cout << detectorName << ": "
+                          << 1000 * headlessTime / timedFrames
+                          << " ms/frame headless, "
+                          << 1000 * renderingTime / timedFrames
+                          << " ms/frame rendering (" << timedFrames
+                          << " frames)" << std::endl;
+            }
+        }
+        else if (runDetector)
         {
             detector->processImage(frame, outputImage);
             workingImage = outputImage;
@@ -0,0 +1,551 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/test/src/TestColorConverter.cxx
+ */
+
+// STD Includes
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+// Project Includes
+#include "vision/include/ColorConverter.h"
+
+using namespace ram;
+using vision::Image;
+
+namespace {
+
+// Straightforward double precision versions of every conversion, written
+// from the definitions rather than for speed
+
+const double PI = 3.14159265358979323846;
+const double XN = 0.950456, ZN = 1.088754;
+
+const double SRGB2XYZ[9] = {0.412453, 0.357580, 0.180423,
+                            0.212671, 0.715160, 0.072169,
+                            0.019334, 0.119193, 0.950227};
+const double LCH2XYZ[9] = {0.4124564, 0.3575761, 0.1804375,
+                           0.2126729, 0.7151522, 0.0721750,
+                           0.0193339, 0.1191920, 0.9503041};
+
+struct Triple
+{
+    Triple(double a_ = 0, double b_ = 0, double c_ = 0) :
+        a(a_), b(b_), c(c_) {}
+    double a, b, c;
+};
+
+Triple multiply(const double m[9], Triple v)
+{
+    return Triple(m[0] * v.a + m[1] * v.b + m[2] * v.c,
+                  m[3] * v.a + m[4] * v.b + m[5] * v.c,
+                  m[6] * v.a + m[7] * v.b + m[8] * v.c);
+}
+
+/** Solves m * x = v */
+Triple solve(const double m[9], Triple v)
+{
+    double det = m[0] * (m[4] * m[8] - m[5] * m[7]) -
+                 m[1] * (m[3] * m[8] - m[5] * m[6]) +
+                 m[2] * (m[3] * m[7] - m[4] * m[6]);
+    double dx = v.a * (m[4] * m[8] - m[5] * m[7]) -
+                m[1] * (v.b * m[8] - m[5] * v.c) +
+                m[2] * (v.b * m[7] - m[4] * v.c);
+    double dy = m[0] * (v.b * m[8] - m[5] * v.c) -
+                v.a * (m[3] * m[8] - m[5] * m[6]) +
+                m[2] * (m[3] * v.c - v.b * m[6]);
+    double dz = m[0] * (m[4] * v.c - v.b * m[7]) -
+                m[1] * (m[3] * v.c - v.b * m[6]) +
+                v.a * (m[3] * m[7] - m[4] * m[6]);
+    return Triple(dx / det, dy / det, dz / det);
+}
+
+double clamp255(double v) { return std::max(0.0, std::min(255.0, v)); }
+
+unsigned char roundByte(double v)
+{
+    return (unsigned char)std::floor(clamp255(v) + 0.5);
+}
+
+unsigned char truncateByte(double v)
+{
+    return (unsigned char)clamp255(v);
+}
+
+double srgbToLinear(double c)
+{
+    c /= 255;
+    return (c <= 0.04045) ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+double linearToSRGB(double l)
+{
+    return 255 * ((l <= 0.0031308) ? 12.92 * l :
+                  1.055 * std::pow(l, 1 / 2.4) - 0.055);
+}
+
+double labF(double t)
+{
+    return (t > 0.008856) ? std::pow(t, 1.0 / 3) : 7.787 * t + 16.0 / 116;
+}
+
+double labFInverse(double f)
+{
+    return (f > 6.0 / 29) ? f * f * f : (f - 16.0 / 116) / 7.787;
+}
+
+void whitePoint(bool lch, double& un, double& vn)
+{
+    double xRef = XN, zRef = ZN;
+    if (lch)
+    {
+        xRef = 0.31271 / 0.32902;
+        zRef = (1 - 0.31271 - 0.32902) / 0.32902;
+    }
+    un = 4 * xRef / (xRef + 15 + 3 * zRef);
+    vn = 9 / (xRef + 15 + 3 * zRef);
+}
+
+/** L* u* v*, using LCHConverter's math when lch is set */
+Triple rgbToLuv(Triple rgb, bool lch)
+{
+    Triple linear = lch ?
+        Triple(std::pow(rgb.a / 255, 2.2), std::pow(rgb.b / 255, 2.2),
+               std::pow(rgb.c / 255, 2.2)) :
+        Triple(srgbToLinear(rgb.a), srgbToLinear(rgb.b),
+               srgbToLinear(rgb.c));
+    Triple xyz = multiply(lch ? LCH2XYZ : SRGB2XYZ, linear);
+
+    double L = lch ?
+        ((xyz.b > 0.008856) ? 116 * std::pow(xyz.b, 0.3333) - 16 :
+         903.3 * xyz.b) :
+        116 * labF(xyz.b) - 16;
+
+    double un, vn;
+    whitePoint(lch, un, vn);
+    double denom = xyz.a + 15 * xyz.b + 3 * xyz.c;
+    if (denom <= 0)
+        return Triple(L, 0, 0);
+    return Triple(L, 13 * L * (4 * xyz.a / denom - un),
+                  13 * L * (9 * xyz.b / denom - vn));
+}
+
+Triple luvToRGB(Triple luv, bool lch)
+{
+    double L = luv.a;
+    if (L <= 0)
+        return Triple(0, 0, 0);
+
+    double un, vn;
+    whitePoint(lch, un, vn);
+    double Y = (L > 8) ?
+        std::pow((L + 16) / 116, lch ? 1 / 0.3333 : 3.0) : L / 903.3;
+    double uPrime = luv.b / (13 * L) + un;
+    double vPrime = luv.c / (13 * L) + vn;
+    Triple xyz(Y * 9 * uPrime / (4 * vPrime), Y,
+               Y * (12 - 3 * uPrime - 20 * vPrime) / (4 * vPrime));
+
+    Triple linear = solve(lch ? LCH2XYZ : SRGB2XYZ, xyz);
+    if (lch)
+    {
+        return Triple(255 * std::pow(std::max(linear.a, 0.0), 1 / 2.2),
+                      255 * std::pow(std::max(linear.b, 0.0), 1 / 2.2),
+                      255 * std::pow(std::max(linear.c, 0.0), 1 / 2.2));
+    }
+    return Triple(linearToSRGB(linear.a), linearToSRGB(linear.b),
+                  linearToSRGB(linear.c));
+}
+
+Triple rgbToLab(Triple rgb)
+{
+    Triple xyz = multiply(SRGB2XYZ, Triple(srgbToLinear(rgb.a),
+                                           srgbToLinear(rgb.b),
+                                           srgbToLinear(rgb.c)));
+    double fx = labF(xyz.a / XN), fy = labF(xyz.b), fz = labF(xyz.c / ZN);
+    return Triple(116 * fy - 16, 500 * (fx - fy), 200 * (fy - fz));
+}
+
+Triple labToRGB(Triple lab)
+{
+    double fy = (lab.a + 16) / 116;
+    Triple xyz(XN * labFInverse(fy + lab.b / 500), labFInverse(fy),
+               ZN * labFInverse(fy - lab.c / 200));
+    Triple linear = solve(SRGB2XYZ, xyz);
+    return Triple(linearToSRGB(linear.a), linearToSRGB(linear.b),
+                  linearToSRGB(linear.c));
+}
+
+/** L, C, H bytes from L and the two chromatic axes */
+void toPolar(Triple cie, unsigned char* out)
+{
+    double hue = std::atan2(cie.c, cie.b) / PI;
+    if (hue < 0)
+        hue += 2;
+    out[0] = truncateByte(cie.a * 2.55);
+    out[1] = truncateByte(std::sqrt(cie.b * cie.b + cie.c * cie.c));
+    out[2] = truncateByte(hue * 127.5);
+}
+
+Triple fromPolar(const unsigned char* in)
+{
+    double angle = in[2] * PI / 127.5;
+    return Triple(in[0] / 2.55, in[1] * std::cos(angle),
+                  in[1] * std::sin(angle));
+}
+
+/** Encodes an RGB color, with channels in [0, 255], into the format */
+void encode(Image::PixelFormat format, Triple rgb, unsigned char* out)
+{
+    double r = rgb.a, g = rgb.b, b = rgb.c;
+    switch (format)
+    {
+        case Image::PF_RGB_8:
+            out[0] = roundByte(r); out[1] = roundByte(g); out[2] = roundByte(b);
+            break;
+        case Image::PF_BGR_8:
+            out[0] = roundByte(b); out[1] = roundByte(g); out[2] = roundByte(r);
+            break;
+        case Image::PF_GRAY_8:
+            out[0] = roundByte(0.299 * r + 0.587 * g + 0.114 * b);
+            break;
+        case Image::PF_YUV444_8:
+        {
+            double y = 0.299 * r + 0.587 * g + 0.114 * b;
+            out[0] = roundByte(y);
+            out[1] = roundByte((b - y) / 1.772 + 128);
+            out[2] = roundByte((r - y) / 1.402 + 128);
+            break;
+        }
+        case Image::PF_HSV_8:
+        {
+            // Only defined for whole RGB values, like cvCvtColor
+            r = roundByte(r);
+            g = roundByte(g);
+            b = roundByte(b);
+            double v = std::max(r, std::max(g, b));
+            double diff = v - std::min(r, std::min(g, b));
+            double h = 0;
+            if (diff > 0)
+            {
+                if (v == r)
+                    h = 60 * (g - b) / diff;
+                else if (v == g)
+                    h = 120 + 60 * (b - r) / diff;
+                else
+                    h = 240 + 60 * (r - g) / diff;
+            }
+            int hue = (int)std::floor(h / 2 + 0.5);
+            out[0] = (unsigned char)((hue + 180) % 180);
+            out[1] = roundByte(v > 0 ? 255 * diff / v : 0);
+            out[2] = roundByte(v);
+            break;
+        }
+        case Image::PF_LUV_8:
+        {
+            Triple luv = rgbToLuv(rgb, false);
+            out[0] = roundByte(luv.a * 2.55);
+            out[1] = roundByte((luv.b + 134) * 255 / 354);
+            out[2] = roundByte((luv.c + 140) * 255 / 256);
+            break;
+        }
+        case Image::PF_LCHUV_8:
+            toPolar(rgbToLuv(rgb, true), out);
+            break;
+        case Image::PF_LAB_8:
+        {
+            Triple lab = rgbToLab(rgb);
+            out[0] = roundByte(lab.a * 2.55);
+            out[1] = roundByte(lab.b + 128);
+            out[2] = roundByte(lab.c + 128);
+            break;
+        }
+        case Image::PF_LCHAB_8:
+            toPolar(rgbToLab(rgb), out);
+            break;
+        default:
+            CHECK(false && "Unknown format");
+    }
+}
+
+/** Decodes a pixel of the format into RGB, with channels in [0, 255] */
+Triple decode(Image::PixelFormat format, const unsigned char* in)
+{
+    Triple rgb;
+    switch (format)
+    {
+        case Image::PF_RGB_8:
+            rgb = Triple(in[0], in[1], in[2]);
+            break;
+        case Image::PF_BGR_8:
+            rgb = Triple(in[2], in[1], in[0]);
+            break;
+        case Image::PF_GRAY_8:
+            rgb = Triple(in[0], in[0], in[0]);
+            break;
+        case Image::PF_YUV444_8:
+        {
+            double y = in[0], u = in[1] - 128.0, v = in[2] - 128.0;
+            rgb = Triple(y + 1.402 * v, y - 0.344136 * u - 0.714136 * v,
+                         y + 1.772 * u);
+            break;
+        }
+        case Image::PF_HSV_8:
+        {
+            double h = in[0] * 2.0, s = in[1] / 255.0, v = in[2];
+            double c = v * s;
+            double x = c * (1 - std::fabs(std::fmod(h / 60, 2) - 1));
+            double m = v - c;
+            int sector = ((int)(h / 60)) % 6;
+            double table[6][3] = {{c, x, 0}, {x, c, 0}, {0, c, x},
+                                  {0, x, c}, {x, 0, c}, {c, 0, x}};
+            rgb = Triple(table[sector][0] + m, table[sector][1] + m,
+                         table[sector][2] + m);
+            break;
+        }
+        case Image::PF_LUV_8:
+            rgb = luvToRGB(Triple(in[0] / 2.55, in[1] * 354.0 / 255 - 134,
+                                  in[2] * 256.0 / 255 - 140), false);
+            break;
+        case Image::PF_LCHUV_8:
+            rgb = luvToRGB(fromPolar(in), true);
+            break;
+        case Image::PF_LAB_8:
+            rgb = labToRGB(Triple(in[0] / 2.55, in[1] - 128.0, in[2] - 128.0));
+            break;
+        case Image::PF_LCHAB_8:
+            rgb = labToRGB(fromPolar(in));
+            break;
+        default:
+            CHECK(false && "Unknown format");
+    }
+    return Triple(clamp255(rgb.a), clamp255(rgb.b), clamp255(rgb.c));
+}
+
+/** Channel holding a hue, and the value it wraps at, or -1 for none */
+int hueChannel(Image::PixelFormat format, int& wrap)
+{
+    if (Image::PF_HSV_8 == format)
+    {
+        wrap = 180;
+        return 0;
+    }
+    if ((Image::PF_LCHUV_8 == format) || (Image::PF_LCHAB_8 == format))
+    {
+        wrap = 255;
+        return 2;
+    }
+    return -1;
+}
+
+/** True if the hue of the pixel is too poorly conditioned to compare */
+bool hueUndefined(Image::PixelFormat format, const unsigned char* pixel)
+{
+    if (Image::PF_HSV_8 == format)
+        return pixel[1] * pixel[2] < 4 * 255;
+    return pixel[1] < 4;
+}
+
+/** Largest channel difference between the two pixels */
+int difference(Image::PixelFormat format, const unsigned char* expected,
+               const unsigned char* actual)
+{
+    int wrap = 0;
+    int hue = hueChannel(format, wrap);
+    int channels = Image::getFormatNumChannels(format);
+
+    int worst = 0;
+    for (int c = 0; c < channels; ++c)
+    {
+        int diff = std::abs((int)expected[c] - (int)actual[c]);
+        if (c == hue)
+        {
+            if (hueUndefined(format, expected))
+                continue;
+            diff = std::min(diff, wrap - diff);
+        }
+        worst = std::max(worst, diff);
+    }
+    return worst;
+}
+
+/** RGB colors spread over the whole cube */
+std::vector<Triple> sampleColors()
+{
+    std::vector<Triple> colors;
+    for (int r = 0; r < 256; r += 17)
+        for (int g = 0; g < 256; g += 17)
+            for (int b = 0; b < 256; b += 17)
+                colors.push_back(Triple(r, g, b));
+
+    // And some which aren't on the grid
+    for (int i = 0; i < 512; ++i)
+    {
+        colors.push_back(Triple((i * 97) % 256, (i * 53 + 7) % 256,
+                                (i * 29 + 101) % 256));
+    }
+    return colors;
+}
+
+/** Converts the colors with ColorConverter, as an image with padded rows,
+ *  and returns the worst difference from the reference */
+int worstDifference(Image::PixelFormat from, Image::PixelFormat to,
+                    const std::vector<Triple>& colors)
+{
+    const int width = 67;
+    const int height = (colors.size() + width - 1) / width;
+    int srcChannels = Image::getFormatNumChannels(from);
+    int dstChannels = Image::getFormatNumChannels(to);
+    int srcStep = width * srcChannels + 5;
+    int dstStep = width * dstChannels + 3;
+
+    std::vector<unsigned char> src(srcStep * height, 0);
+    std::vector<unsigned char> expected(dstStep * height, 0);
+    std::vector<unsigned char> actual(dstStep * height, 0);
+
+    for (size_t i = 0; i < colors.size(); ++i)
+    {
+        unsigned char* pixel = &src[(i / width) * srcStep +
+                                    (i % width) * srcChannels];
+        encode(from, colors[i], pixel);
+
+        unsigned char* expectedPixel =
+            &expected[(i / width) * dstStep + (i % width) * dstChannels];
+        if (from == to)
+            std::copy(pixel, pixel + srcChannels, expectedPixel);
+        else
+            encode(to, decode(from, pixel), expectedPixel);
+    }
+
+    vision::ColorConverter::convert(from, &src[0], srcStep, to, &actual[0],
+                                    dstStep, width, height);
+
+    int worst = 0;
+    for (size_t i = 0; i < colors.size(); ++i)
+    {
+        size_t offset = (i / width) * dstStep + (i % width) * dstChannels;
+        worst = std::max(worst, difference(to, &expected[offset],
+                                           &actual[offset]));
+    }
+    return worst;
+}
+
+Image::PixelFormat formatAt(int i)
+{
+    return (Image::PixelFormat)i;
+}
+
+} // namespace
+
+SUITE(ColorConverter) {
+
+TEST(canConvert)
+{
+    for (int from = Image::PF_START + 1; from < Image::PF_END; ++from)
+    {
+        for (int to = Image::PF_START + 1; to < Image::PF_END; ++to)
+        {
+            CHECK(vision::ColorConverter::canConvert(formatAt(from),
+                                                     formatAt(to)));
+        }
+    }
+
+    CHECK(!vision::ColorConverter::canConvert(Image::PF_START,
+                                              Image::PF_RGB_8));
+    CHECK(!vision::ColorConverter::canConvert(Image::PF_RGB_8,
+                                              Image::PF_END));
+}
+
+TEST(knownColors)
+{
+    unsigned char red[3] = {255, 0, 0};
+    unsigned char out[3] = {0, 0, 0};
+
+    vision::ColorConverter::convert(Image::PF_RGB_8, red, 3,
+                                    Image::PF_GRAY_8, out, 1, 1, 1);
+    CHECK_EQUAL(76, out[0]);
+
+    vision::ColorConverter::convert(Image::PF_RGB_8, red, 3,
+                                    Image::PF_HSV_8, out, 3, 1, 1);
+    CHECK_EQUAL(0, out[0]);
+    CHECK_EQUAL(255, out[1]);
+    CHECK_EQUAL(255, out[2]);
+
+    unsigned char white[3] = {255, 255, 255};
+    vision::ColorConverter::convert(Image::PF_RGB_8, white, 3,
+                                    Image::PF_YUV444_8, out, 3, 1, 1);
+    CHECK_EQUAL(255, out[0]);
+    CHECK_EQUAL(128, out[1]);
+    CHECK_EQUAL(128, out[2]);
+
+    vision::ColorConverter::convert(Image::PF_RGB_8, white, 3,
+                                    Image::PF_LAB_8, out, 3, 1, 1);
+    CHECK_CLOSE(255, out[0], 1);
+    CHECK_CLOSE(128, out[1], 1);
+    CHECK_CLOSE(128, out[2], 1);
+}
+
+TEST(everyPairMatchesReference)
+{
+    std::vector<Triple> colors(sampleColors());
+
+    for (int from = Image::PF_START + 1; from < Image::PF_END; ++from)
+    {
+        for (int to = Image::PF_START + 1; to < Image::PF_END; ++to)
+        {
+            int worst = worstDifference(formatAt(from), formatAt(to),
+                                        colors);
+            if (worst > 1)
+            {
+                std::cout << "Conversion " << from << " -> " << to
+                          << " off by " << worst << std::endl;
+            }
+            CHECK(worst <= 1);
+        }
+    }
+}
+
+TEST(inPlace)
+{
+    std::vector<Triple> colors(sampleColors());
+    const int width = colors.size();
+
+    for (int from = Image::PF_START + 1; from < Image::PF_END; ++from)
+    {
+        for (int to = Image::PF_START + 1; to < Image::PF_END; ++to)
+        {
+            if (Image::getFormatNumChannels(formatAt(from)) !=
+                Image::getFormatNumChannels(formatAt(to)))
+            {
+                continue;
+            }
+
+            int channels = Image::getFormatNumChannels(formatAt(from));
+            std::vector<unsigned char> image(width * channels);
+            for (int i = 0; i < width; ++i)
+                encode(formatAt(from), colors[i], &image[i * channels]);
+
+            std::vector<unsigned char> expected(width * channels);
+            vision::ColorConverter::convert(
+                formatAt(from), &image[0], width * channels, formatAt(to),
+                &expected[0], width * channels, width, 1);
+            vision::ColorConverter::convert(
+                formatAt(from), &image[0], width * channels, formatAt(to),
+                &image[0], width * channels, width, 1);
+            if (expected != image)
+            {
+                std::cout << "In place " << from << " -> " << to
+                          << " differs" << std::endl;
+            }
+            CHECK(expected == image);
+        }
+    }
+}
+
+} // SUITE(ColorConverter)
@@ -15,8 +15,11 @@
 
 // Test Includes
 #include "vision/include/Detector.h"
+#include "vision/include/BlobDetector.h"
 #include "vision/include/OpenCVImage.h"
 
+#include "vision/test/include/Utility.h"
+
 using namespace ram;
 SUITE(Detector) {
 
@@ -49,4 +52,33 @@ TEST(imageToAICoordinates)
     CHECK_CLOSE(expectedY, outY, 0.001);
 }
 
+TEST(debugOutputLevel)
+{
+    CHECK_EQUAL(vision::Detector::DEBUG_OUTPUT_FULL,
+                vision::Detector::getDebugOutputLevel());
+
+    vision::OpenCVImage input(640, 480);
+    vision::makeColor(&input, 0, 0, 0);
+    drawSquare(&input, 200, 200, 100, 200, 0, CV_RGB(255,255,255));
+
+    vision::OpenCVImage output(640, 480);
+    vision::makeColor(&output, 0, 0, 255);
+    vision::BlobDetector detector(core::ConfigNode::fromString("{}"));
+
+    // Nothing is rendered, but the detector still works
+    vision::Detector::setDebugOutputLevel(vision::Detector::DEBUG_OUTPUT_NONE);
+    detector.processImage(&input, &output);
+    vision::Detector::setDebugOutputLevel(vision::Detector::DEBUG_OUTPUT_FULL);
+
+    CHECK_EQUAL(1u, detector.getBlobs().size());
+    unsigned char* pixel = output.getData() + (200 * 640 + 200) * 3;
+    CHECK_EQUAL(255, pixel[0]);
+    CHECK_EQUAL(0, pixel[1]);
+    CHECK_EQUAL(0, pixel[2]);
+
+    // Rendering back on copies the input into the output
+    detector.processImage(&input, &output);
+    CHECK_EQUAL(255, pixel[1]);
+}
+
 } // SUITE(Detector)
@@ -14,7 +14,7 @@
 // Library Includes
 #include <UnitTest++/UnitTest++.h>
 
-//#include <boost/filesystem.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 
 // Project Includes
@@ -31,7 +31,6 @@
 using namespace ram;
 namespace bf = boost::filesystem;
 
-/*
 static boost::filesystem::path getImagesDir()
 {
     boost::filesystem::path root(getenv("RAM_SVN_DIR"));
@@ -39,6 +38,7 @@ static boost::filesystem::path getImagesDir()
         "testfann";
 }
 
+/*
 static std::string getSymbolNetworkFile()
 {
     boost::filesystem::path root(getenv("RAM_SVN_DIR"));
@@ -109,6 +109,45 @@ struct FANNFixture
         images.push_back(image);
     }
 
+    /** Trains the color network on generated images and saves it */
+    void trainNetwork()
+    {
+        // Generate test images
+        addImage(yellowImages, 235, 255, 0);
+        addImage(yellowImages, 255, 232, 0);
+        addImage(yellowImages, 255, 239, 0);
+        addImage(yellowImages, 255, 215, 0);
+
+        // Generate purple test images
+        addImage(purpleImages, 235, 0, 255);
+        addImage(purpleImages, 255, 0, 232);
+        addImage(purpleImages, 255, 0, 239);
+        addImage(purpleImages, 255, 0, 215);
+
+        // Generate teal images
+        addImage(tealImages, 0, 235, 255);
+        addImage(tealImages, 0, 255, 232);
+        addImage(tealImages, 0, 255, 239);
+        addImage(tealImages, 0, 255, 215);
+
+        // Train our nueral network
+        vision::FANNSymbolDetectorPtr colorDetector(
+            new ColorDetector("{ 'training' : 1 }"));
+        vision::FANNTrainer trainer(colorDetector);
+
+        // Load up the data
+        FANN::training_data data;
+        trainer.addTrainData(0, data, yellowImages);
+        trainer.addTrainData(1, data, purpleImages);
+        trainer.addTrainData(2, data, tealImages);
+
+        // train the network
+        trainer.runTraining (data);
+
+        // save the network
+        trainer.save(bf::path(fileName));
+    }
+
     std::string fileName;
     
     std::vector<vision::Image*> yellowImages;
@@ -120,40 +159,7 @@ SUITE(FANN) {
     
 TEST_FIXTURE(FANNFixture, test)
 {
-    // Generate test images
-    addImage(yellowImages, 235, 255, 0);
-    addImage(yellowImages, 255, 232, 0);
-    addImage(yellowImages, 255, 239, 0);
-    addImage(yellowImages, 255, 215, 0);
-
-    // Generate purple test images
-    addImage(purpleImages, 235, 0, 255);
-    addImage(purpleImages, 255, 0, 232);
-    addImage(purpleImages, 255, 0, 239);
-    addImage(purpleImages, 255, 0, 215);
-
-    // Generate teal images
-    addImage(tealImages, 0, 235, 255);
-    addImage(tealImages, 0, 255, 232);
-    addImage(tealImages, 0, 255, 239);
-    addImage(tealImages, 0, 255, 215);
-
-    // Train our nueral network
-    vision::FANNSymbolDetectorPtr colorDetector(
-        new ColorDetector("{ 'training' : 1 }"));
-    vision::FANNTrainer trainer(colorDetector);
-
-    // Load up the data
-    FANN::training_data data;
-    trainer.addTrainData(0, data, yellowImages);
-    trainer.addTrainData(1, data, purpleImages);
-    trainer.addTrainData(2, data, tealImages);
-
-    // train the network
-    trainer.runTraining (data);
-    
-    // save the network
-    trainer.save(bf::path(fileName));
+    trainNetwork();
 
     // Now lets test the detector by creating one
     std::stringstream cfg;
@@ -185,5 +191,50 @@ TEST_FIXTURE(FANNFixture, test)
     delete purple;
     delete teal;
 }
+
+TEST_FIXTURE(FANNFixture, quantized)
+{
+    trainNetwork();
+
+    std::stringstream cfg;
+    cfg << "{ 'nueralNetworkFile' : '"  << fileName << "'";
+    vision::FANNSymbolDetectorPtr floatDetector(
+        new ColorDetector(cfg.str() + ", 'quantized' : 0 }"));
+    vision::FANNSymbolDetectorPtr quantizedDetector(
+        new ColorDetector(cfg.str() + "}"));
+
+    // Everything trained on, plus the symbol images which were not
+    std::vector<vision::Image*> images;
+    images.insert(images.end(), yellowImages.begin(), yellowImages.end());
+    images.insert(images.end(), purpleImages.begin(), purpleImages.end());
+    images.insert(images.end(), tealImages.begin(), tealImages.end());
+
+    std::vector<vision::Image*> symbols;
+    const char* names[] = {"club.jpg", "diamond.jpg", "heart.jpg",
+                           "spade.jpg"};
+    BOOST_FOREACH(const char* name, names)
+    {
+        vision::Image* image =
+            vision::Image::loadFromFile((getImagesDir() / name).string());
+        image->setSize(100, 100);
+        symbols.push_back(image);
+    }
+    images.insert(images.end(), symbols.begin(), symbols.end());
+
+    // The quantized network must match the same images, in one batch
+    std::vector<int> results;
+    quantizedDetector->runNN(images, results);
+    CHECK_EQUAL(images.size(), results.size());
+    for (size_t i = 0; i < images.size(); ++i)
+        CHECK_EQUAL(floatDetector->runNN(images[i]), results[i]);
+
+    // Batching the float network changes nothing either
+    std::vector<int> floatResults;
+    floatDetector->runNN(images, floatResults);
+    CHECK_ARRAY_EQUAL(results, floatResults, (int)images.size());
+
+    BOOST_FOREACH(vision::Image* image, symbols)
+        delete image;
+}
     
 } // SUITE(FANNSymbolDetector)
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/test/src/TestImagePool.cxx
+ */
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+#include "cv.h"
+
+// Project Includes
+#include "vision/include/ImagePool.h"
+#include "vision/include/OpenCVImage.h"
+
+using namespace ram;
+
+struct ImagePoolFixture
+{
+    ImagePoolFixture()
+    {
+        vision::ImagePool::clear();
+        vision::ImagePool::resetStats();
+    }
+
+    ~ImagePoolFixture()
+    {
+        vision::ImagePool::clear();
+    }
+};
+
+SUITE(ImagePool) {
+
+TEST_FIXTURE(ImagePoolFixture, reuse)
+{
+    IplImage* image = vision::ImagePool::acquire(640, 480, IPL_DEPTH_8U, 3);
+    CHECK(image);
+    CHECK_EQUAL(640, image->width);
+    CHECK_EQUAL(480, image->height);
+    CHECK_EQUAL(3, image->nChannels);
+    CHECK_EQUAL(0u, (size_t)image->imageData % vision::ImagePool::ALIGNMENT);
+
+    char* data = image->imageData;
+    vision::ImagePool::release(&image);
+    CHECK(!image);
+
+    // Same size and format gets the same buffer back
+    image = vision::ImagePool::acquire(640, 480, IPL_DEPTH_8U, 3);
+    CHECK_EQUAL((void*)data, (void*)image->imageData);
+
+    // Different formats don't
+    IplImage* gray = vision::ImagePool::acquire(640, 480, IPL_DEPTH_8U, 1);
+    CHECK_EQUAL(1, gray->nChannels);
+
+    vision::ImagePool::release(&image);
+    vision::ImagePool::release(&gray);
+
+    vision::ImagePool::Stats stats = vision::ImagePool::getStats();
+    CHECK_EQUAL(3u, stats.acquires);
+    CHECK_EQUAL(1u, stats.hits);
+    CHECK_EQUAL(3u, stats.releases);
+    CHECK_EQUAL(2u, stats.idleImages);
+    CHECK_EQUAL((size_t)(640 * 480 * 4), stats.idleBytes);
+    CHECK_CLOSE(1.0 / 3, stats.hitRate(), 0.0001);
+}
+
+TEST_FIXTURE(ImagePoolFixture, maxIdle)
+{
+    const size_t count = vision::ImagePool::MAX_IDLE + 2;
+    IplImage* images[count];
+    for (size_t i = 0; i < count; ++i)
+        images[i] = vision::ImagePool::acquire(32, 32, IPL_DEPTH_8U, 1);
+    for (size_t i = 0; i < count; ++i)
+        vision::ImagePool::release(&images[i]);
+
+    vision::ImagePool::Stats stats = vision::ImagePool::getStats();
+    CHECK_EQUAL(vision::ImagePool::MAX_IDLE, stats.idleImages);
+    CHECK_EQUAL(2u, stats.discards);
+}
+
+TEST_FIXTURE(ImagePoolFixture, releaseForeign)
+{
+    // Images from elsewhere are just freed
+    IplImage* image = cvCreateImage(cvSize(16, 16), IPL_DEPTH_8U, 3);
+    vision::ImagePool::release(&image);
+    CHECK(!image);
+
+    vision::ImagePool::Stats stats = vision::ImagePool::getStats();
+    CHECK_EQUAL(0u, stats.releases);
+    CHECK_EQUAL(0u, stats.idleImages);
+
+    // And NULL is ignored
+    vision::ImagePool::release(&image);
+}
+
+TEST_FIXTURE(ImagePoolFixture, resetsROI)
+{
+    IplImage* image = vision::ImagePool::acquire(64, 64, IPL_DEPTH_8U, 1);
+    cvSetImageROI(image, cvRect(8, 8, 16, 16));
+    vision::ImagePool::release(&image);
+
+    image = vision::ImagePool::acquire(64, 64, IPL_DEPTH_8U, 1);
+    CHECK(!image->roi);
+    vision::ImagePool::release(&image);
+}
+
+TEST_FIXTURE(ImagePoolFixture, storage)
+{
+    CvMemStorage* storage = vision::ImagePool::acquireStorage();
+    CvSeq* seq = cvCreateSeq(0, sizeof(CvSeq), sizeof(CvPoint), storage);
+    for (int i = 0; i < 1000; ++i)
+    {
+        CvPoint point = cvPoint(i, i);
+        cvSeqPush(seq, &point);
+    }
+    CvMemStorage* first = storage;
+    vision::ImagePool::releaseStorage(&storage);
+    CHECK(!storage);
+
+    // Comes back empty
+    storage = vision::ImagePool::acquireStorage();
+    CHECK_EQUAL(first, storage);
+    CHECK(storage->bottom);
+    CHECK_EQUAL(storage->bottom, storage->top);
+    vision::ImagePool::releaseStorage(&storage);
+}
+
+TEST_FIXTURE(ImagePoolFixture, scoped)
+{
+    char* data = 0;
+    {
+        vision::PooledImage image(100, 100, IPL_DEPTH_8U, 3);
+        data = image->imageData;
+        vision::PooledStorage storage;
+        CHECK((CvMemStorage*)storage);
+    }
+
+    vision::PooledImage image(100, 100, IPL_DEPTH_8U, 3);
+    CHECK_EQUAL((void*)data, (void*)image->imageData);
+}
+
+TEST_FIXTURE(ImagePoolFixture, OpenCVImage)
+{
+    // Converting back and forth between formats every frame only allocates
+    // on the first frame
+    for (int i = 0; i < 10; ++i)
+    {
+        vision::OpenCVImage img(640, 480, vision::Image::PF_BGR_8);
+        img.setPixelFormat(vision::Image::PF_GRAY_8);
+        img.setPixelFormat(vision::Image::PF_BGR_8);
+        img.setSize(320, 240);
+    }
+
+    vision::ImagePool::Stats stats = vision::ImagePool::getStats();
+    CHECK_EQUAL(40u, stats.acquires);
+    CHECK_EQUAL(37u, stats.hits);
+    CHECK_EQUAL(40u, stats.releases);
+}
+
+} // SUITE(ImagePool)
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  packages/vision/test/src/TestQuantizedNetwork.cxx
+ */
+
+// STD Includes
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Library Includes
+#include <UnitTest++/UnitTest++.h>
+
+#include <floatfann.h>
+#include <fann_cpp.h>
+
+// Project Includes
+#include "vision/include/QuantizedNetwork.h"
+
+using namespace ram;
+
+static const int INPUTS = 6;
+static const int OUTPUTS = 4;
+static const int SETS = 200;
+
+struct QuantizedNetworkFixture
+{
+    QuantizedNetworkFixture() :
+        inputs(SETS * INPUTS),
+        floatOutputs(SETS * OUTPUTS),
+        outputs(SETS * OUTPUTS)
+    {
+        srand(42);
+
+        // Features of very different sizes, like the detectors extract
+        for (int i = 0; i < SETS * INPUTS; ++i)
+        {
+            float value = rand() / (float)RAND_MAX;
+            inputs[i] = ((i % INPUTS) == 3) ? value * 255 : value;
+        }
+    }
+
+    void setup(FANN::activation_function_enum function =
+               FANN::SIGMOID_SYMMETRIC)
+    {
+        net.set_activation_function_hidden(function);
+        net.set_activation_function_output(function);
+        net.set_activation_steepness_hidden(0.5);
+        net.set_activation_steepness_output(0.5);
+        net.randomize_weights(-1, 1);
+
+        for (int set = 0; set < SETS; ++set)
+        {
+            fann_type* result = net.run(&inputs[set * INPUTS]);
+            std::copy(result, result + OUTPUTS, &floatOutputs[set * OUTPUTS]);
+        }
+    }
+
+    /** Largest difference between the quantized and float outputs */
+    float runQuantized()
+    {
+        vision::QuantizedNetwork quantized(net);
+        CHECK_EQUAL(INPUTS, quantized.getNumInput());
+        CHECK_EQUAL(OUTPUTS, quantized.getNumOutput());
+
+        quantized.run(&inputs[0], SETS, &outputs[0], scratch);
+
+        float largest = 0;
+        for (int i = 0; i < SETS * OUTPUTS; ++i)
+        {
+            largest = std::max(largest,
+                               std::fabs(outputs[i] - floatOutputs[i]));
+        }
+        return largest;
+    }
+
+    FANN::neural_net net;
+    vision::QuantizedNetwork::Scratch scratch;
+    std::vector<float> inputs;
+    std::vector<float> floatOutputs;
+    std::vector<float> outputs;
+};
+
+SUITE(QuantizedNetwork) {
+
+TEST_FIXTURE(QuantizedNetworkFixture, Standard)
+{
+    unsigned int layers[] = {INPUTS, 12, OUTPUTS};
+    net.create_standard_array(3, layers);
+    setup();
+    CHECK(runQuantized() < 0.01);
+}
+
+TEST_FIXTURE(QuantizedNetworkFixture, Sparse)
+{
+    // How FANNTrainer makes its networks
+    unsigned int layers[] = {INPUTS, INPUTS, INPUTS, OUTPUTS};
+    net.create_sparse_array(0.75, 4, layers);
+    setup();
+    CHECK(runQuantized() < 0.01);
+}
+
+TEST_FIXTURE(QuantizedNetworkFixture, Shortcut)
+{
+    unsigned int layers[] = {INPUTS, 3, 3, OUTPUTS};
+    net.create_shortcut_array(4, layers);
+    setup();
+    CHECK(runQuantized() < 0.01);
+}
+
+TEST_FIXTURE(QuantizedNetworkFixture, Stepwise)
+{
+    // FANNTrainer trains with the stepwise sigmoid
+    unsigned int layers[] = {INPUTS, INPUTS, INPUTS, OUTPUTS};
+    net.create_sparse_array(0.75, 4, layers);
+    setup(FANN::SIGMOID_STEPWISE);
+    CHECK(runQuantized() < 0.01);
+}
+
+TEST_FIXTURE(QuantizedNetworkFixture, Wide)
+{
+    // Long rows, so the rounding of many weights adds up
+    unsigned int layers[] = {INPUTS, 300, OUTPUTS};
+    net.create_standard_array(3, layers);
+    setup();
+    CHECK(runQuantized() < 0.01);
+}
+
+TEST_FIXTURE(QuantizedNetworkFixture, BatchMatchesSingle)
+{
+    unsigned int layers[] = {INPUTS, 12, OUTPUTS};
+    net.create_standard_array(3, layers);
+    setup();
+    runQuantized();
+
+    // Every input set is quantized on its own, so batching changes nothing
+    vision::QuantizedNetwork quantized(net);
+    float single[OUTPUTS];
+    for (int set = 0; set < SETS; ++set)
+    {
+        quantized.run(&inputs[set * INPUTS], 1, single, scratch);
+        CHECK_ARRAY_EQUAL(&outputs[set * OUTPUTS], single, OUTPUTS);
+    }
+}
+
+} // SUITE(QuantizedNetwork)
@@ -214,6 +214,49 @@ TEST(CreateDestroy)
                                 core::SubsystemList());
 }
 
+TEST(DetectorCache)
+{
+    MockCamera* forwardCamera = new MockCamera();
+    MockCamera* downwardCamera = new MockCamera();
+    vision::VisionSystem vision(vision::CameraPtr(forwardCamera),
+                                vision::CameraPtr(downwardCamera),
+                                core::ConfigNode::fromString(
+                                    "{'testing' : 1, 'detectorCacheSize' : 1,"
+                                    " 'preloadDetectors' : ['GateDetector',"
+                                    " 'BinDetector']}"),
+                                core::SubsystemList());
+    
+    // Turn each detector on and off twice, so detectors are evicted from the
+    // cache and built again
+    for (int i = 0; i < 2; ++i)
+    {
+        vision.buoyDetectorOn();
+        vision.pipeLineDetectorOn();
+        vision.update(0);
+        vision.buoyDetectorOff();
+        vision.pipeLineDetectorOff();
+
+        vision.binDetectorOn();
+        vision.gateDetectorOn();
+        vision.update(0);
+        vision.binDetectorOff();
+        vision.gateDetectorOff();
+
+        vision.downwardSafeDetectorOn();
+        vision.cupidDetectorOn();
+        vision.loversLaneDetectorOn();
+        vision.update(0);
+        vision.downwardSafeDetectorOff();
+        vision.cupidDetectorOff();
+        vision.loversLaneDetectorOff();
+        vision.update(0);
+    }
+
+    // Turning off a detector which was never on does nothing
+    vision.buoyDetectorOff();
+    vision.update(0);
+}
+
 TEST_FIXTURE(VisionSystemFixture, BuoyDetector)
 {
     // Blue Image with red circle in upper left
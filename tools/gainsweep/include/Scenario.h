@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  tools/gainsweep/include/Scenario.h
+ */
+
+#ifndef RAM_TOOLS_GAINSWEEP_SCENARIO_H
+#define RAM_TOOLS_GAINSWEEP_SCENARIO_H
+
+// STD Includes
+#include <string>
+#include <vector>
+
+// Project Includes
+#include "core/include/ConfigNode.h"
+
+/** How well one axis of the vehicle followed a commanded step
+ *
+ *  Measured against the true state of the simulation, not the estimate,
+ *  from the moment the command was given.
+ */
+struct AxisMetrics
+{
+    AxisMetrics();
+
+    /** Whether the maneuver commanded this axis at all */
+    bool commanded;
+
+    /** Seconds until the error stays within the settling band, negative if
+     *  it never does */
+    double settlingTime;
+
+    /** Percent of the step the axis went past its target */
+    double overshoot;
+
+    /** Error at the end of the run, in meters or degrees */
+    double finalError;
+};
+
+struct ScenarioResult
+{
+    ScenarioResult();
+
+    AxisMetrics depth;
+    AxisMetrics heading;
+    AxisMetrics position;
+
+    /** Joules the thrusters spent after the command */
+    double energy;
+
+    /** Seconds the run took to compute */
+    double wallTime;
+};
+
+/** A single simulated run of the real estimator and controller
+ *
+ *  Builds a SimVehicle, ModularStateEstimator and CombineController from
+ *  the config, lets the vehicle settle under the controller's initial hold
+ *  and then commands the maneuver, stepping everything in virtual time.
+ *
+ *  Config sections:
+ *    Vehicle, StateEstimator, Controller - as for the subsystems
+ *    Run - controlInterval (s, default 0.025), settleTime (s, default 3)
+ *
+ *  Maneuver values, each axis optional:
+ *    depth - m, heading - degrees, position - [x, y] in m
+ *    duration - s after the command, default 20
+ *    depthBand, headingBand, positionBand - settling bands, default 0.1 m,
+ *      5 degrees and 0.25 m
+ */
+class Scenario
+{
+public:
+    Scenario(ram::core::ConfigNode config, ram::core::ConfigNode maneuver);
+
+    ScenarioResult run();
+
+private:
+    ram::core::ConfigNode m_config;
+    ram::core::ConfigNode m_maneuver;
+};
+
+#endif // RAM_TOOLS_GAINSWEEP_SCENARIO_H
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  tools/gainsweep/src/Scenario.cpp
+ */
+
+// STD Includes
+#include <cmath>
+
+// Library Includes
+#include <boost/assign/list_of.hpp>
+
+// Project Includes
+#include "Scenario.h"
+
+#include "core/include/EventHub.h"
+#include "core/include/TimeVal.h"
+#include "vehicle/include/SimVehicle.h"
+#include "estimation/include/ModularStateEstimator.h"
+#include "control/include/CombineController.h"
+#include "math/include/Vector2.h"
+
+using namespace ram;
+
+/** Wraps an angle in degrees into [-180, 180) */
+static double wrapDegrees(double angle)
+{
+    angle = std::fmod(angle + 180, 360);
+    if (angle < 0)
+        angle += 360;
+    return angle - 180;
+}
+
+/** Follows one axis through a step to find its metrics */
+class AxisTracker
+{
+public:
+    AxisTracker(double step, double band) :
+        m_step(std::fabs(step)),
+        m_band(band),
+        m_lastOutside(0),
+        m_maxProgress(0),
+        m_error(0)
+    {
+    }
+
+    /**
+     *  @param progress
+     *      How far the axis has moved toward the target since the command
+     *  @param error
+     *      How far it is from the target
+     */
+    void sample(double time, double progress, double error)
+    {
+        if (error > m_band)
+            m_lastOutside = time;
+        if (progress > m_maxProgress)
+            m_maxProgress = progress;
+        m_error = error;
+    }
+
+    AxisMetrics getMetrics(bool commanded) const
+    {
+        AxisMetrics metrics;
+        metrics.commanded = commanded;
+        metrics.settlingTime = (m_error > m_band) ? -1 : m_lastOutside;
+        if (m_step > 1e-6 && m_maxProgress > m_step)
+            metrics.overshoot = (m_maxProgress - m_step) / m_step * 100;
+        metrics.finalError = m_error;
+        return metrics;
+    }
+
+private:
+    double m_step;
+    double m_band;
+    double m_lastOutside;
+    double m_maxProgress;
+    double m_error;
+};
+
+AxisMetrics::AxisMetrics() :
+    commanded(false),
+    settlingTime(0),
+    overshoot(0),
+    finalError(0)
+{
+}
+
+ScenarioResult::ScenarioResult() :
+    energy(0),
+    wallTime(0)
+{
+}
+
+Scenario::Scenario(core::ConfigNode config, core::ConfigNode maneuver) :
+    m_config(config),
+    m_maneuver(maneuver)
+{
+}
+
+ScenarioResult Scenario::run()
+{
+    double startTime = core::TimeVal::timeOfDay().get_double();
+
+    core::EventHubPtr eventHub(new core::EventHub());
+    boost::shared_ptr<vehicle::SimVehicle> vehicle(
+        new vehicle::SimVehicle(m_config["Vehicle"],
+                                boost::assign::list_of(eventHub)));
+    estimation::IStateEstimatorPtr estimator(
+        new estimation::ModularStateEstimator(m_config["StateEstimator"],
+                                              eventHub));
+    control::CombineController controller(eventHub, vehicle, estimator,
+                                          m_config["Controller"]);
+    vehicle->unsafeThrusters();
+
+    double interval = m_config["Run"]["controlInterval"].asDouble(0.025);
+    int settleSteps = (int)(m_config["Run"]["settleTime"].asDouble(3) /
+                            interval + 0.5);
+    int runSteps = (int)(m_maneuver["duration"].asDouble(20) / interval +
+                         0.5);
+
+    // Let the estimator converge while the controller holds its start
+    for (int i = 0; i < settleSteps; ++i)
+    {
+        controller.update(interval);
+        vehicle->step(interval);
+    }
+
+    vehicle::VehicleDynamics::State start = vehicle->getTrueState();
+    double startDepth = start.position[2];
+    double startYaw = start.orientation.getYaw().valueDegrees();
+    math::Vector2 startPosition(start.position[0], start.position[1]);
+    double startEnergy = vehicle->getThrusterEnergy();
+
+    // Command the maneuver, any axis it leaves out is held where it is
+    bool depthCommanded = m_maneuver.exists("depth");
+    double targetDepth = m_maneuver["depth"].asDouble(startDepth);
+    if (depthCommanded)
+        controller.changeDepth(targetDepth);
+
+    bool headingCommanded = m_maneuver.exists("heading");
+    double targetYaw = m_maneuver["heading"].asDouble(startYaw);
+    if (headingCommanded)
+    {
+        controller.rotate(math::Quaternion(math::Degree(targetYaw),
+                                           math::Vector3::UNIT_Z));
+    }
+
+    bool positionCommanded = m_maneuver.exists("position");
+    math::Vector2 targetPosition(
+        m_maneuver["position"][0].asDouble(startPosition[0]),
+        m_maneuver["position"][1].asDouble(startPosition[1]));
+    if (positionCommanded)
+        controller.translate(targetPosition);
+
+    double depthSign = (targetDepth >= startDepth) ? 1 : -1;
+    double yawStep = wrapDegrees(targetYaw - startYaw);
+    double yawSign = (yawStep >= 0) ? 1 : -1;
+    math::Vector2 positionStep = targetPosition - startPosition;
+    math::Vector2 positionDirection = math::Vector2::ZERO;
+    if (positionStep.length() > 1e-6)
+        positionDirection = positionStep / positionStep.length();
+
+    AxisTracker depth(targetDepth - startDepth,
+                      m_maneuver["depthBand"].asDouble(0.1));
+    AxisTracker heading(yawStep, m_maneuver["headingBand"].asDouble(5));
+    AxisTracker position(positionStep.length(),
+                         m_maneuver["positionBand"].asDouble(0.25));
+
+    for (int i = 0; i < runSteps; ++i)
+    {
+        controller.update(interval);
+        vehicle->step(interval);
+
+        double time = (i + 1) * interval;
+        vehicle::VehicleDynamics::State state = vehicle->getTrueState();
+
+        double currentDepth = state.position[2];
+        depth.sample(time, (currentDepth - startDepth) * depthSign,
+                     std::fabs(targetDepth - currentDepth));
+
+        double yaw = state.orientation.getYaw().valueDegrees();
+        heading.sample(time, wrapDegrees(yaw - startYaw) * yawSign,
+                       std::fabs(wrapDegrees(targetYaw - yaw)));
+
+        math::Vector2 currentPosition(state.position[0], state.position[1]);
+        position.sample(time,
+                        (currentPosition - startPosition).dotProduct(
+                            positionDirection),
+                        (targetPosition - currentPosition).length());
+    }
+
+    ScenarioResult result;
+    result.depth = depth.getMetrics(depthCommanded);
+    result.heading = heading.getMetrics(headingCommanded);
+    result.position = position.getMetrics(positionCommanded);
+    result.energy = vehicle->getThrusterEnergy() - startEnergy;
+    result.wallTime = core::TimeVal::timeOfDay().get_double() - startTime;
+    return result;
+}
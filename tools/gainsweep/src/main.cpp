@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  tools/gainsweep/src/main.cpp
+ */
+
+// Runs every combination of the gains in a config's Sweep section against
+// each of its Maneuvers, on the headless SimVehicle with the real estimator
+// and controller, and prints a CSV row of metrics per run.
+//
+// Usage: gainsweep <config.yml> [threads]
+//
+// The Sweep section maps dotted config paths to the values to try:
+//
+//   Sweep:
+//       Controller.DepthController.kp: [10, 20, 40]
+//       Controller.DepthController.kd: [1, 3, 6]
+//
+// Settling times are in seconds, -1 if the axis never settled, overshoot in
+// percent of the step and final error in meters or degrees.  Fields of an
+// axis the maneuver did not command are left empty.
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+// Library Includes
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/algorithm/string.hpp>
+#include <log4cpp/Category.hh>
+#include <log4cpp/Priority.hh>
+
+// Project Includes
+#include "Scenario.h"
+#include "core/include/ConfigNode.h"
+#include "core/include/YamlConfigNodeImp.h"
+#include "core/include/TimeVal.h"
+
+using namespace ram;
+
+struct SweepRun
+{
+    std::string maneuver;
+    std::vector<double> values;
+
+    ScenarioResult result;
+    std::string error;
+};
+
+/** Sets the value at a dotted path, like Controller.DepthController.kp */
+static void setPath(core::ConfigNode node, const std::string& path,
+                    double value)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, path, boost::is_any_of("."));
+    for (size_t i = 0; i + 1 < parts.size(); ++i)
+        node = node[parts[i]];
+    node.set(parts.back(), value);
+}
+
+/** Hands the runs out to the worker threads one at a time */
+class Sweeper
+{
+public:
+    Sweeper(core::YamlConfigNodeImp::NodePtr config,
+            std::vector<std::string> keys, std::vector<SweepRun>& runs) :
+        m_config(config),
+        m_keys(keys),
+        m_runs(runs),
+        m_next(0),
+        m_finished(0)
+    {
+    }
+
+    void work()
+    {
+        while (true)
+        {
+            size_t index;
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if (m_next >= m_runs.size())
+                    return;
+                index = m_next++;
+            }
+
+            SweepRun& run = m_runs[index];
+            try
+            {
+                // Each run gets its own copy of the config to change
+                core::ConfigNode config(core::ConfigNodeImpPtr(
+                    new core::YamlConfigNodeImp(
+                        core::YamlConfigNodeImp::copy(m_config))));
+                for (size_t i = 0; i < m_keys.size(); ++i)
+                    setPath(config, m_keys[i], run.values[i]);
+
+                Scenario scenario(config, config["Maneuvers"][run.maneuver]);
+                run.result = scenario.run();
+            }
+            catch (std::exception& e)
+            {
+                run.error = e.what();
+            }
+
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_finished++;
+            std::cerr << "\r" << m_finished << "/" << m_runs.size()
+                      << " runs" << std::flush;
+        }
+    }
+
+private:
+    /** Parsed once, only ever read by the workers */
+    core::YamlConfigNodeImp::NodePtr m_config;
+    std::vector<std::string> m_keys;
+    std::vector<SweepRun>& m_runs;
+
+    boost::mutex m_mutex;
+    size_t m_next;
+    size_t m_finished;
+};
+
+static void writeAxis(std::ostream& out, const AxisMetrics& axis)
+{
+    if (axis.commanded)
+    {
+        out << "," << axis.settlingTime << "," << axis.overshoot << ","
+            << axis.finalError;
+    }
+    else
+    {
+        out << ",,,";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: gainsweep <config.yml> [threads]" << std::endl;
+        return 1;
+    }
+    std::string configPath(argv[1]);
+    size_t threads = boost::thread::hardware_concurrency();
+    if (argc > 2)
+        threads = std::atoi(argv[2]);
+    if (threads < 1)
+        threads = 1;
+
+    // Keep the per sample logging of every run out of the way
+    log4cpp::Category::getRoot().setPriority(log4cpp::Priority::WARN);
+
+    // Parsed natively, the workers copy it without touching Python
+    core::YamlConfigNodeImp::NodePtr tree(
+        core::YamlConfigNodeImp::parseFile(configPath));
+    core::ConfigNode config(core::ConfigNodeImpPtr(
+        new core::YamlConfigNodeImp(core::YamlConfigNodeImp::copy(tree))));
+
+    // The values of each swept path, in a fixed order
+    std::vector<std::string> keys;
+    std::vector<std::vector<double> > values;
+    core::ConfigNode sweep(config["Sweep"]);
+    BOOST_FOREACH(std::string key, sweep.subNodes())
+    {
+        std::vector<double> keyValues;
+        for (size_t i = 0; i < sweep[key].size(); ++i)
+            keyValues.push_back(sweep[key][i].asDouble());
+        if (keyValues.empty())
+            continue;
+
+        keys.push_back(key);
+        values.push_back(keyValues);
+    }
+
+    // Every maneuver with every combination of values
+    std::vector<SweepRun> runs;
+    BOOST_FOREACH(std::string maneuver, config["Maneuvers"].subNodes())
+    {
+        std::vector<size_t> digits(keys.size(), 0);
+        bool done = false;
+        while (!done)
+        {
+            SweepRun run;
+            run.maneuver = maneuver;
+            for (size_t i = 0; i < keys.size(); ++i)
+                run.values.push_back(values[i][digits[i]]);
+            runs.push_back(run);
+
+            done = true;
+            for (size_t i = 0; i < digits.size() && done; ++i)
+            {
+                if (++digits[i] < values[i].size())
+                    done = false;
+                else
+                    digits[i] = 0;
+            }
+        }
+    }
+
+    std::cerr << runs.size() << " runs on " << threads << " threads"
+              << std::endl;
+    double start = core::TimeVal::timeOfDay().get_double();
+
+    Sweeper sweeper(tree, keys, runs);
+    boost::thread_group workers;
+    for (size_t i = 0; i < threads; ++i)
+        workers.create_thread(boost::bind(&Sweeper::work, &sweeper));
+    workers.join_all();
+
+    std::cerr << std::endl << "Finished in "
+              << core::TimeVal::timeOfDay().get_double() - start << "s"
+              << std::endl;
+
+    // Results in the order the runs were made
+    std::cout << "run,maneuver";
+    BOOST_FOREACH(std::string key, keys)
+        std::cout << "," << key;
+    std::cout << ",depthSettling,depthOvershoot,depthError"
+              << ",headingSettling,headingOvershoot,headingError"
+              << ",positionSettling,positionOvershoot,positionError"
+              << ",energy,error" << std::endl;
+
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const SweepRun& run = runs[i];
+        std::cout << i << "," << run.maneuver;
+        BOOST_FOREACH(double value, run.values)
+            std::cout << "," << value;
+
+        if (run.error.empty())
+        {
+            writeAxis(std::cout, run.result.depth);
+            writeAxis(std::cout, run.result.heading);
+            writeAxis(std::cout, run.result.position);
+            std::cout << "," << run.result.energy << "," << std::endl;
+        }
+        else
+        {
+            std::cout << ",,,,,,,,,,,\"" << run.error << "\"" << std::endl;
+        }
+    }
+
+    return 0;
+}
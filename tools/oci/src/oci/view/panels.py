@@ -691,9 +691,12 @@ class ProfilePanel(wx.grid.Grid):
     def _onProfile(self, event):
         if event.sender != "UNNAMED":
             sender = str(event.sender.getPublisherName())
+            text = str(event.data)
+            if event.deadlineMisses > 0:
+                text += ' (%d missed)' % event.deadlineMisses
     
             if not self._profileTable.has_key(sender):
-                self._profileTable[sender] = str(event.data)
+                self._profileTable[sender] = text
                 location = self._findLocation(sender)
                 
                 self.InsertRows(pos = location )
@@ -706,7 +709,7 @@ class ProfilePanel(wx.grid.Grid):
                 self.AutoSizeColumn(1)
                 self.AutoSizeRow(location)
             else:
-                self._profileTable[sender] = str(event.data)
+                self._profileTable[sender] = text
 
     def _timerHandler(self, event):
          for row in range(self._size):
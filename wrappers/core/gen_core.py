@@ -29,15 +29,20 @@ def expose_publisher(local_ns, cls_name):
     ePublisher.add_declaration_code("""
     ram::core::EventConnectionPtr %s_pysubscribe(ram::core::%s & epub,
                                               std::string type,
-                                              boost::python::object pyFunction)
+                                              boost::python::object pyFunction,
+                                              DeliveryPolicy delivery)
     {
-        return epub.subscribe(type, EventFunctor(pyFunction));
+        return epub.subscribe(
+            type, EventDispatcher::makeHandler(pyFunction, delivery));
     }
     """ % (cls_name, cls_name))
     ePublisher.add_registration_code(
-        'def("subscribe", &::%s_pysubscribe)' % (cls_name),
+        'def("subscribe", &::%s_pysubscribe, (boost::python::arg("type"), '
+        'boost::python::arg("handler"), '
+        'boost::python::arg("delivery") = DeliveryPolicy()))' % (cls_name),
         works_on_instance = True )
     ePublisher.include_files.append('wrappers/core/include/EventFunctor.h')
+    ePublisher.include_files.append('wrappers/core/include/EventDispatcher.h')
     ePublisher.include_files.append('core/include/EventConnection.h')
     return ePublisher
 
@@ -111,7 +116,10 @@ def generate(module_builder, local_ns, global_ns):
     events = wrap.expose_events(local_ns, filter_func = filterFunc)
     classes += events
 
-    # Add registrations functions for hand wrapped classes
+    # Add registrations functions for hand wrapped classes, DeliveryPolicy
+    # has to be registered before it is used as a default argument
+    module_builder.add_registration_code("registerEventDispatcherClass();",
+                                         tail = False)
     module_builder.add_registration_code("registerSubsystemList();")
     module_builder.add_registration_code("registerSubsystemClass();")
     module_builder.add_registration_code("registerSubsystemMakerClass();")
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  wrappers/core/include/EventDispatcher.h
+ */
+
+#ifndef RAM_CORE_WRAP_EVENTDISPATCHER_H_07_05_2011
+#define RAM_CORE_WRAP_EVENTDISPATCHER_H_07_05_2011
+
+// STD Includes
+#include <deque>
+#include <map>
+#include <string>
+
+// Library Includes
+#include <boost/python.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility.hpp>
+
+// Project Includes
+#include "core/include/Event.h"
+#include "wrappers/core/include/EventFunctor.h"
+
+/** How events are handed to a Python handler
+ *
+ *  DIRECT calls the handler on the publishing thread, like always.  Every
+ *  other mode queues the event without touching the interpreter, and the
+ *  EventDispatcher thread later delivers it with a batch of others.
+ */
+struct DeliveryPolicy
+{
+    enum Mode {
+        /** Call the handler in publish() */
+        DIRECT,
+        /** Deliver every event, from the dispatcher thread */
+        QUEUED,
+        /** Deliver only the newest event of each type not yet delivered */
+        LATEST,
+        /** Deliver one out of every n events of each type */
+        EVERY_NTH,
+        /** Deliver the newest event of each type, at most rate per second
+            of wall clock time, even when the Clock is virtual */
+        MAX_RATE
+    };
+
+    DeliveryPolicy(Mode mode_ = DIRECT, int n_ = 1, double rate_ = 0) :
+        mode(mode_), n(n_), rate(rate_) {}
+
+    static DeliveryPolicy direct() { return DeliveryPolicy(DIRECT); }
+    static DeliveryPolicy queued() { return DeliveryPolicy(QUEUED); }
+    static DeliveryPolicy latest() { return DeliveryPolicy(LATEST); }
+    static DeliveryPolicy everyNth(int n)
+        { return DeliveryPolicy(EVERY_NTH, n); }
+    static DeliveryPolicy maxRate(double rate)
+        { return DeliveryPolicy(MAX_RATE, 1, rate); }
+
+    Mode mode;
+    int n;
+    double rate;
+};
+
+/** Delivers queued events to Python handlers from its own thread
+ *
+ *  Publishing threads only take a mutex to queue the event, or to replace
+ *  the one already waiting.  The dispatcher thread takes everything which
+ *  is due and delivers it all under a single acquisition of the interpreter
+ *  lock, so C++ sensor threads never wait on Python.
+ */
+class EventDispatcher : boost::noncopyable
+{
+public:
+    struct Stats
+    {
+        Stats() : received(0), coalesced(0), skipped(0), dropped(0),
+                  delivered(0), batches(0) {}
+
+        /** Events given to a queued handler */
+        boost::uint64_t received;
+        /** Replaced by a newer event before delivery */
+        boost::uint64_t coalesced;
+        /** Passed over by EVERY_NTH */
+        boost::uint64_t skipped;
+        /** Thrown away because the queue was full */
+        boost::uint64_t dropped;
+        boost::uint64_t delivered;
+        /** Times the interpreter lock was taken to deliver */
+        boost::uint64_t batches;
+    };
+
+    /**
+     *  @param maxQueued
+     *      Most events QUEUED handlers may have waiting, past that the
+     *      oldest are dropped
+     */
+    EventDispatcher(size_t maxQueued = 1000);
+
+    /** Stops the thread, anything still queued is never delivered */
+    ~EventDispatcher();
+
+    /** The dispatcher used by the Python subscribe functions */
+    static EventDispatcher* getDefault();
+
+    /** Makes the handler to subscribe for the Python object
+     *
+     *  DIRECT policies get back a plain EventFunctor, anything else queues
+     *  on the default dispatcher.
+     */
+    static boost::function<void (ram::core::EventPtr)> makeHandler(
+        boost::python::object pyFunction, DeliveryPolicy policy);
+
+    /** Makes a handler which queues events for the Python object on this
+     *  dispatcher */
+    boost::function<void (ram::core::EventPtr)> wrap(
+        boost::python::object pyFunction, DeliveryPolicy policy);
+
+    /** Waits until everything queued so far has been delivered
+     *
+     *  The caller must not hold the interpreter lock.
+     */
+    void flush();
+
+    Stats getStats();
+
+private:
+    struct Subscription;
+    typedef boost::shared_ptr<Subscription> SubscriptionPtr;
+    class QueuingHandler;
+
+    /** An event waiting for delivery */
+    struct Pending
+    {
+        SubscriptionPtr subscription;
+        ram::core::EventPtr event;
+    };
+
+    /** Applies the subscription's policy, called on the publishing thread */
+    void enqueue(SubscriptionPtr subscription, ram::core::EventPtr event);
+
+    void run();
+
+    /** Moves everything due out of the queues, returns the time the next
+     *  held event is due, or -1 if none are held */
+    boost::int64_t takeDue(std::deque<Pending>& batch, boost::int64_t now);
+
+    /** Delivers the batch under one interpreter lock, then releases it and
+        the replaced events while still holding the lock */
+    void deliver(std::deque<Pending>& batch, std::deque<Pending>& replaced);
+
+    /** Guards everything below */
+    boost::mutex m_mutex;
+
+    /** Signaled when events are queued or the dispatcher stops */
+    boost::condition m_queued;
+
+    /** Signaled when a batch has been delivered */
+    boost::condition m_delivered;
+
+    bool m_running;
+
+    size_t m_maxQueued;
+
+    /** Events from QUEUED and EVERY_NTH handlers, in publish order */
+    std::deque<Pending> m_queue;
+
+    /** Newest undelivered event of each type for LATEST and MAX_RATE */
+    typedef std::map<std::pair<Subscription*, std::string>, Pending> HeldMap;
+    HeldMap m_held;
+
+    /** Events dropped or coalesced away, which may hold Python objects, so
+        they are released with the next batch instead of by the publisher */
+    std::deque<Pending> m_replaced;
+
+    /** Events taken from the queues, but not yet delivered */
+    size_t m_inFlight;
+
+    Stats m_stats;
+
+    boost::thread m_thread;
+};
+
+#endif // RAM_CORE_WRAP_EVENTDISPATCHER_H_07_05_2011
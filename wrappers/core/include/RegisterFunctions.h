@@ -15,5 +15,6 @@ void registerSubsystemList();
 void registerSubsystemMakerClass();
 void registerEventHubClass();
 void registerQueuedEventHubClass();
+void registerEventDispatcherClass();
 
 #endif // RAM_CORE_WRAP_REGISTERFUNCTIONS_H_12_11_2007
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  wrappers/core/src/EventDispatcher.cpp
+ */
+
+// STD Includes
+#include <utility>
+#include <algorithm>
+
+// Library Includes
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+// Project Includes
+#include "core/include/GILock.h"
+#include "wrappers/core/include/EventDispatcher.h"
+
+namespace bp = boost::python;
+
+/** Microseconds since the epoch on the clock timed waits use, MAX_RATE is
+ *  timed on it rather than Clock::monotonicTime(), which can be virtual */
+static boost::int64_t systemTime()
+{
+    boost::posix_time::time_duration sinceEpoch =
+        boost::posix_time::microsec_clock::universal_time() -
+        boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1));
+    return sinceEpoch.total_microseconds();
+}
+
+/** One Python handler, and the state its policy needs */
+struct EventDispatcher::Subscription
+{
+    Subscription(bp::object pyFunction, DeliveryPolicy policy_) :
+        functor(new EventFunctor(pyFunction)),
+        policy(policy_)
+    {
+    }
+
+    ~Subscription()
+    {
+        // The handler is a Python object, it can only be released under the
+        // interpreter lock
+        if (Py_IsInitialized())
+        {
+            ram::core::ScopedGILock lock;
+            delete functor;
+        }
+    }
+
+    EventFunctor* functor;
+    DeliveryPolicy policy;
+
+    /** Events seen of each type, for EVERY_NTH */
+    std::map<std::string, int> counts;
+
+    /** Time the last event of each type was delivered, for MAX_RATE */
+    std::map<std::string, boost::int64_t> lastDelivered;
+};
+
+/** What actually gets subscribed, it never touches the interpreter */
+class EventDispatcher::QueuingHandler
+{
+public:
+    QueuingHandler(EventDispatcher* dispatcher,
+                   SubscriptionPtr subscription) :
+        m_dispatcher(dispatcher),
+        m_subscription(subscription)
+    {
+    }
+
+    void operator()(ram::core::EventPtr event)
+    {
+        m_dispatcher->enqueue(m_subscription, event);
+    }
+
+private:
+    EventDispatcher* m_dispatcher;
+    SubscriptionPtr m_subscription;
+};
+
+EventDispatcher::EventDispatcher(size_t maxQueued) :
+    m_running(true),
+    m_maxQueued(maxQueued),
+    m_inFlight(0)
+{
+    m_thread = boost::thread(boost::bind(&EventDispatcher::run, this));
+}
+
+EventDispatcher::~EventDispatcher()
+{
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_running = false;
+        m_queued.notify_all();
+        m_delivered.notify_all();
+    }
+    m_thread.join();
+
+    // Undelivered events may hold the last reference to a handler, or be
+    // Python objects themselves
+    std::deque<Pending> queue;
+    std::deque<Pending> replaced;
+    HeldMap held;
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        queue.swap(m_queue);
+        replaced.swap(m_replaced);
+        held.swap(m_held);
+    }
+    if (Py_IsInitialized())
+    {
+        ram::core::ScopedGILock gil;
+        queue.clear();
+        replaced.clear();
+        held.clear();
+    }
+}
+
+EventDispatcher* EventDispatcher::getDefault()
+{
+    static boost::mutex mutex;
+    boost::mutex::scoped_lock lock(mutex);
+
+    // Never deleted, so its thread can't be joined during static
+    // destruction after the interpreter is gone
+    static EventDispatcher* dispatcher = 0;
+    if (!dispatcher)
+        dispatcher = new EventDispatcher();
+    return dispatcher;
+}
+
+boost::function<void (ram::core::EventPtr)> EventDispatcher::makeHandler(
+    bp::object pyFunction, DeliveryPolicy policy)
+{
+    if (DeliveryPolicy::DIRECT == policy.mode)
+        return EventFunctor(pyFunction);
+    return getDefault()->wrap(pyFunction, policy);
+}
+
+boost::function<void (ram::core::EventPtr)> EventDispatcher::wrap(
+    bp::object pyFunction, DeliveryPolicy policy)
+{
+    if (DeliveryPolicy::DIRECT == policy.mode)
+        return EventFunctor(pyFunction);
+
+    if ((DeliveryPolicy::EVERY_NTH == policy.mode) && (policy.n < 1))
+    {
+        PyErr_SetString(PyExc_ValueError, "Must deliver every n >= 1 events");
+        bp::throw_error_already_set();
+    }
+    if ((DeliveryPolicy::MAX_RATE == policy.mode) && (policy.rate <= 0))
+    {
+        PyErr_SetString(PyExc_ValueError, "Max rate must be positive");
+        bp::throw_error_already_set();
+    }
+
+    // The interpreter has to be threaded before another thread can take
+    // the lock
+    PyEval_InitThreads();
+
+    SubscriptionPtr subscription(new Subscription(pyFunction, policy));
+    return QueuingHandler(this, subscription);
+}
+
+void EventDispatcher::flush()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (m_running &&
+           (!m_queue.empty() || !m_held.empty() || (m_inFlight > 0)))
+    {
+        m_delivered.wait(lock);
+    }
+}
+
+EventDispatcher::Stats EventDispatcher::getStats()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_stats;
+}
+
+void EventDispatcher::enqueue(SubscriptionPtr subscription,
+                              ram::core::EventPtr event)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_stats.received++;
+
+    Pending pending;
+    pending.subscription = subscription;
+    pending.event = event;
+
+    switch (subscription->policy.mode)
+    {
+        case DeliveryPolicy::EVERY_NTH:
+        {
+            // Deliver the first, and every nth one after it
+            int& count = subscription->counts[event->type];
+            bool deliver = (0 == count);
+            count = (count + 1) % subscription->policy.n;
+            if (!deliver)
+            {
+                m_stats.skipped++;
+                return;
+            }
+        }
+        // Fall through
+        case DeliveryPolicy::QUEUED:
+            if (m_queue.size() >= m_maxQueued)
+            {
+                m_replaced.push_back(m_queue.front());
+                m_queue.pop_front();
+                m_stats.dropped++;
+            }
+            m_queue.push_back(pending);
+            break;
+
+        default:
+        {
+            Pending& held = m_held[
+                std::make_pair(subscription.get(), event->type)];
+            if (held.event)
+            {
+                m_replaced.push_back(held);
+                m_stats.coalesced++;
+            }
+            held = pending;
+            break;
+        }
+    }
+
+    m_queued.notify_all();
+}
+
+void EventDispatcher::run()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    while (m_running)
+    {
+        std::deque<Pending> batch;
+        boost::int64_t now = systemTime();
+        boost::int64_t nextDue = takeDue(batch, now);
+
+        // Replaced events wait for the next batch, so coalescing doesn't
+        // take the interpreter lock, unless too many pile up
+        if (batch.empty() && (m_replaced.size() < m_maxQueued))
+        {
+            if (nextDue < 0)
+            {
+                m_queued.wait(lock);
+            }
+            else
+            {
+                m_queued.timed_wait(
+                    lock, boost::posix_time::microseconds(nextDue - now));
+            }
+            continue;
+        }
+
+        std::deque<Pending> replaced;
+        replaced.swap(m_replaced);
+        m_inFlight = batch.size();
+        lock.unlock();
+        deliver(batch, replaced);
+        lock.lock();
+
+        if (m_inFlight > 0)
+        {
+            m_stats.delivered += m_inFlight;
+            m_stats.batches++;
+        }
+        m_inFlight = 0;
+        m_delivered.notify_all();
+    }
+}
+
+boost::int64_t EventDispatcher::takeDue(std::deque<Pending>& batch,
+                                        boost::int64_t now)
+{
+    batch.swap(m_queue);
+
+    boost::int64_t nextDue = -1;
+    HeldMap::iterator iter = m_held.begin();
+    while (m_held.end() != iter)
+    {
+        Subscription* subscription = iter->first.first;
+        if (DeliveryPolicy::MAX_RATE == subscription->policy.mode)
+        {
+            boost::int64_t period =
+                (boost::int64_t)(1000000 / subscription->policy.rate);
+            std::map<std::string, boost::int64_t>::iterator last =
+                subscription->lastDelivered.find(iter->first.second);
+
+            if (subscription->lastDelivered.end() != last)
+            {
+                boost::int64_t due = last->second + period;
+                if (now < due)
+                {
+                    if ((nextDue < 0) || (due < nextDue))
+                        nextDue = due;
+                    ++iter;
+                    continue;
+                }
+            }
+            subscription->lastDelivered[iter->first.second] = now;
+        }
+
+        batch.push_back(iter->second);
+        m_held.erase(iter++);
+    }
+
+    return nextDue;
+}
+
+void EventDispatcher::deliver(std::deque<Pending>& batch,
+                              std::deque<Pending>& replaced)
+{
+    ram::core::ScopedGILock gil;
+
+    BOOST_FOREACH(Pending& pending, batch)
+    {
+        try
+        {
+            (*pending.subscription->functor)(pending.event);
+        }
+        catch (bp::error_already_set&)
+        {
+            // Nobody to raise it to, so report it and keep going
+            PyErr_Print();
+        }
+    }
+
+    // Events and handlers may be Python objects, release them under the lock
+    batch.clear();
+    replaced.clear();
+}
+
+static void pyFlush()
+{
+    // Release the interpreter so the dispatcher can deliver
+    PyThreadState* threadState = PyEval_SaveThread();
+    EventDispatcher::getDefault()->flush();
+    PyEval_RestoreThread(threadState);
+}
+
+static EventDispatcher::Stats pyGetStats()
+{
+    return EventDispatcher::getDefault()->getStats();
+}
+
+void registerEventDispatcherClass()
+{
+    bp::class_<DeliveryPolicy>("DeliveryPolicy")
+        .def_readonly("n", &DeliveryPolicy::n)
+        .def_readonly("rate", &DeliveryPolicy::rate)
+        .def("direct", &DeliveryPolicy::direct)
+        .staticmethod("direct")
+        .def("queued", &DeliveryPolicy::queued)
+        .staticmethod("queued")
+        .def("latest", &DeliveryPolicy::latest)
+        .staticmethod("latest")
+        .def("everyNth", &DeliveryPolicy::everyNth, (bp::arg("n")))
+        .staticmethod("everyNth")
+        .def("maxRate", &DeliveryPolicy::maxRate, (bp::arg("rate")))
+        .staticmethod("maxRate");
+
+    bp::class_<EventDispatcher::Stats>("EventDispatcherStats")
+        .def_readonly("received", &EventDispatcher::Stats::received)
+        .def_readonly("coalesced", &EventDispatcher::Stats::coalesced)
+        .def_readonly("skipped", &EventDispatcher::Stats::skipped)
+        .def_readonly("dropped", &EventDispatcher::Stats::dropped)
+        .def_readonly("delivered", &EventDispatcher::Stats::delivered)
+        .def_readonly("batches", &EventDispatcher::Stats::batches);
+
+    bp::class_<EventDispatcher, boost::noncopyable>("EventDispatcher",
+                                                    bp::no_init)
+        .def("flush", &pyFlush)
+        .staticmethod("flush")
+        .def("getStats", &pyGetStats)
+        .staticmethod("getStats");
+}
@@ -16,6 +16,7 @@
 #include "core/include/EventConnection.h"
 #include "core/include/SubsystemConverter.h"
 #include "wrappers/core/include/EventFunctor.h"
+#include "wrappers/core/include/EventDispatcher.h"
 
 namespace bp = boost::python;
 
@@ -26,22 +27,28 @@ REGISTER_EVENTHUB_CONVERTER;
 ram::core::EventConnectionPtr subscribe(ram::core::EventHub& epub,
                                         std::string type,
                                         ram::core::EventPublisher* publisher,
-                                        boost::python::object pyFunction)
+                                        boost::python::object pyFunction,
+                                        DeliveryPolicy delivery)
 {
-    return epub.subscribe(type, publisher, EventFunctor(pyFunction));
+    return epub.subscribe(type, publisher,
+                          EventDispatcher::makeHandler(pyFunction, delivery));
 }
 
 ram::core::EventConnectionPtr subscribeToType(ram::core::EventHub& epub,
                                               std::string type,
-                                              boost::python::object pyFunction)
+                                              boost::python::object pyFunction,
+                                              DeliveryPolicy delivery)
 {
-    return epub.subscribeToType(type, EventFunctor(pyFunction));
+    return epub.subscribeToType(
+        type, EventDispatcher::makeHandler(pyFunction, delivery));
 }
 
 ram::core::EventConnectionPtr subscribeToAll(ram::core::EventHub& epub,
-                                             boost::python::object pyFunction)
+                                             boost::python::object pyFunction,
+                                             DeliveryPolicy delivery)
 {
-    return epub.subscribeToAll(EventFunctor(pyFunction));
+    return epub.subscribeToAll(
+        EventDispatcher::makeHandler(pyFunction, delivery));
 }
 
 
@@ -53,10 +60,13 @@ void registerEventHubClass()
         .def(bp::init<ram::core::ConfigNode,
              bp::optional<ram::core::SubsystemList> >())
         .def("subscribe", &subscribe,
-             (bp::arg("type"), bp::arg("publisher"), bp::arg("handler")))    
+             (bp::arg("type"), bp::arg("publisher"), bp::arg("handler"),
+              bp::arg("delivery") = DeliveryPolicy()))
         .def("subscribeToType", &subscribeToType,
-             (bp::arg("type"), bp::arg("handler")))
-        .def("subscribeToAll", &::subscribeToAll, (bp::arg("handler")));
+             (bp::arg("type"), bp::arg("handler"),
+              bp::arg("delivery") = DeliveryPolicy()))
+        .def("subscribeToAll", &::subscribeToAll,
+             (bp::arg("handler"), bp::arg("delivery") = DeliveryPolicy()));
 
     bp::register_ptr_to_python<ram::core::EventConnectionPtr>();
     bp::register_ptr_to_python<boost::shared_ptr<ram::core::EventHub> >();
@@ -17,19 +17,59 @@
 #include "core/include/EventConnection.h"
 #include "core/include/SubsystemConverter.h"
 #include "wrappers/core/include/EventFunctor.h"
+#include "wrappers/core/include/EventDispatcher.h"
 
 namespace bp = boost::python;
 
 static ram::core::SpecificSubsystemConverter<ram::core::EventHub>
 REGISTER_QUEUEDEVENTHUB_CONVERTER;
 
+// Without a lane the type stays in whichever lane it is in
+ram::core::EventConnectionPtr
+queuedSubscribeToType(ram::core::QueuedEventHub& hub,
+                      std::string type,
+                      boost::python::object pyFunction,
+                      DeliveryPolicy delivery,
+                      boost::python::object lane)
+{
+    boost::function<void (ram::core::EventPtr)> handler =
+        EventDispatcher::makeHandler(pyFunction, delivery);
+    if (lane.ptr() == Py_None)
+        return hub.subscribeToType(type, handler);
+    
+    return hub.subscribeToType(
+        type, handler, bp::extract<ram::core::QueuedEventHub::Lane>(lane)());
+}
+
 void registerQueuedEventHubClass()
 {
-    bp::class_<ram::core::QueuedEventHub,
-        bp::bases<ram::core::EventHub> >("QueuedEventHub",
-            bp::init<ram::core::EventHubPtr, bp::optional<std::string> >(
+    typedef bp::class_<ram::core::QueuedEventHub,
+        bp::bases<ram::core::EventHub> > QueuedEventHubExposer;
+    QueuedEventHubExposer queuedEventHubExposer("QueuedEventHub",
+        bp::init<ram::core::EventHubPtr, bp::optional<std::string> >(
             (bp::arg("eventHub"),
-             bp::arg("name") = std::string("QueuedEventHub")) ))
+             bp::arg("name") = std::string("QueuedEventHub")) ));
+    bp::scope queuedEventHubScope(queuedEventHubExposer);
+
+    bp::enum_<ram::core::QueuedEventHub::Lane>("Lane")
+        .value("CRITICAL_LANE", ram::core::QueuedEventHub::CRITICAL_LANE)
+        .value("NORMAL_LANE", ram::core::QueuedEventHub::NORMAL_LANE)
+        .value("LATEST_LANE", ram::core::QueuedEventHub::LATEST_LANE)
+        .export_values();
+
+    queuedEventHubExposer
+        .def("subscribeToType", &queuedSubscribeToType,
+             (bp::arg("type"), bp::arg("handler"),
+              bp::arg("delivery") = DeliveryPolicy(),
+              bp::arg("lane") = bp::object()))
+        .def("setTypeLane",
+             &ram::core::QueuedEventHub::setTypeLane)
+        .def("setNameLane",
+             &ram::core::QueuedEventHub::setNameLane)
+        .def("getTypeLane",
+             &ram::core::QueuedEventHub::getTypeLane)
+        .def("getCoalescedCount",
+             &ram::core::QueuedEventHub::getCoalescedCount)
         .def("setWaitUpdate",
              &ram::core::QueuedEventHub::setWaitUpdate)
         .def("publishEvents",
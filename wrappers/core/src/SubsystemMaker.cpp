@@ -18,6 +18,7 @@
 // Project Includes
 #include "core/include/SubsystemMaker.h"
 #include "core/include/SubsystemConverter.h"
+#include "core/include/GILock.h"
 
 namespace bp = boost::python;
 
@@ -36,6 +37,9 @@ struct SubsystemMakerWrapper : ram::core::SubsystemMaker,
     virtual ram::core::SubsystemPtr makeObject(
         ram::core::SubsystemMakerParamType params)
     {
+        // Subsystems can be constructed on threads which don't hold the
+        // interpreter lock, see Application
+        ram::core::ScopedGILock lock;
         bp::override func_makeObject = this->get_override( "makeObject" );
         bp::list deps;
 
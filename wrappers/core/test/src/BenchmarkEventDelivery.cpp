@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2011 Robotics at Maryland
+ * All rights reserved.
+ *
+ * File:  wrappers/core/test/src/BenchmarkEventDelivery.cpp
+ */
+
+// Measures how long a C++ sensor thread spends in publish() when a Python
+// handler is subscribed, while the main thread keeps the interpreter busy
+// the way the AI's state machine does.  Needs build_ext on the PYTHONPATH.
+
+// STD Includes
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+// Library Includes
+#include <boost/python.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+// Project Includes
+#include "core/include/Event.h"
+#include "core/include/EventPublisher.h"
+#include "core/include/Clock.h"
+
+namespace py = boost::python;
+using namespace ram;
+
+static const int EVENTS = 2000;
+static const boost::int64_t PUBLISH_PERIOD = 2000;
+
+/** Publishes at a steady rate, like an IMU, timing each publish */
+static void sensorThread(core::EventPublisher* publisher,
+                         std::vector<boost::int64_t>* latencies)
+{
+    boost::int64_t next = core::Clock::monotonicTime();
+    for (int i = 0; i < EVENTS; ++i)
+    {
+        core::EventPtr event(new core::Event());
+        boost::int64_t start = core::Clock::monotonicTime();
+        publisher->publish("SENSOR", event);
+        latencies->push_back(core::Clock::monotonicTime() - start);
+
+        next += PUBLISH_PERIOD;
+        core::Clock::sleepUntil(next);
+    }
+}
+
+static void report(std::string name, std::vector<boost::int64_t> latencies,
+                   int calls)
+{
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (size_t i = 0; i < latencies.size(); ++i)
+        total += latencies[i];
+
+    std::cout << std::setw(12) << name
+              << std::setw(10) << total / latencies.size()
+              << std::setw(10) << latencies[latencies.size() / 2]
+              << std::setw(10) << latencies[latencies.size() * 99 / 100]
+              << std::setw(10) << latencies.back()
+              << std::setw(10) << calls << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    Py_Initialize();
+    PyEval_InitThreads();
+
+    try {
+        py::object main_module(py::import("__main__"));
+        py::object main_namespace(main_module.attr("__dict__"));
+        py::exec("import time\n"
+                 "import ext.core as core\n"
+                 "epub = core.EventPublisher()\n"
+                 "calls = 0\n"
+                 "def handler(event):\n"
+                 "    global calls\n"
+                 "    calls += 1\n"
+                 "    sum(xrange(2000))\n"
+                 "def busy(seconds):\n"
+                 "    end = time.time() + seconds\n"
+                 "    while time.time() < end:\n"
+                 "        sum(xrange(1000))\n",
+                 main_namespace, main_namespace);
+
+        core::EventPublisher* publisher =
+            py::extract<core::EventPublisher*>(main_namespace["epub"]);
+
+        const char* policies[] = {
+            "direct()", "queued()", "latest()", "everyNth(10)", "maxRate(50)",
+            0};
+
+        std::cout << "Publish latency (us) over " << EVENTS
+                  << " events with a busy interpreter" << std::endl;
+        std::cout << std::setw(12) << "Delivery" << std::setw(10) << "Mean"
+                  << std::setw(10) << "P50" << std::setw(10) << "P99"
+                  << std::setw(10) << "Max" << std::setw(10) << "Calls"
+                  << std::endl;
+
+        for (int i = 0; policies[i]; ++i)
+        {
+            std::string policy(policies[i]);
+            py::exec(("calls = 0\n"
+                      "conn = epub.subscribe('SENSOR', handler, "
+                      "core.DeliveryPolicy." + policy + ")\n").c_str(),
+                     main_namespace, main_namespace);
+
+            std::vector<boost::int64_t> latencies;
+            latencies.reserve(EVENTS);
+            boost::thread sensor(
+                boost::bind(&sensorThread, publisher, &latencies));
+
+            // Keep the interpreter busy for as long as the sensor runs
+            double seconds = EVENTS * PUBLISH_PERIOD / 1000000.0;
+            py::exec(("busy(" + boost::lexical_cast<std::string>(seconds) +
+                      ")\n").c_str(), main_namespace, main_namespace);
+
+            PyThreadState* threadState = PyEval_SaveThread();
+            sensor.join();
+            PyEval_RestoreThread(threadState);
+
+            py::exec("core.EventDispatcher.flush()\n"
+                     "conn.disconnect()\n",
+                     main_namespace, main_namespace);
+            int calls = py::extract<int>(main_namespace["calls"]);
+            report(policy, latencies, calls);
+        }
+    } catch (py::error_already_set&) {
+        PyErr_Print();
+        return 1;
+    }
+
+    return 0;
+}
@@ -72,5 +72,62 @@ class TestEventHub(unittest.TestCase):
         epub.publish("Type", core.Event())
         self.assertEquals(1, recv.calls)
 
+    def testQueuedDelivery(self):
+        recv = Reciever()
+        self.ehub.subscribeToType("Type", recv, core.DeliveryPolicy.queued())
+
+        self.epubA.publish("Type", core.Event())
+        self.epubB.publish("Type", core.Event())
+        core.EventDispatcher.flush()
+        self.assertEquals(2, recv.calls)
+        self.assertEquals("Type", recv.etype)
+
+    def testEveryNthDelivery(self):
+        recv = Reciever()
+        self.ehub.subscribeToType("Type", recv,
+                                  core.DeliveryPolicy.everyNth(3))
+
+        # The 1st, 4th and 7th
+        for i in xrange(7):
+            self.epubA.publish("Type", core.Event())
+        core.EventDispatcher.flush()
+        self.assertEquals(3, recv.calls)
+
+    def testLatestDelivery(self):
+        recv = Reciever()
+        self.ehub.subscribeToAll(recv, core.DeliveryPolicy.latest())
+        before = core.EventDispatcher.getStats()
+
+        for i in xrange(10):
+            self.epubA.publish("Type", core.Event())
+        self.epubA.publish("Other", core.Event())
+        core.EventDispatcher.flush()
+
+        # Anything not delivered was replaced by a newer event
+        stats = core.EventDispatcher.getStats()
+        self.assert_(recv.calls >= 2)
+        self.assertEquals(11, stats.received - before.received)
+        self.assertEquals(11, (stats.delivered - before.delivered) +
+                          (stats.coalesced - before.coalesced))
+
+    def testMaxRateDelivery(self):
+        recv = Reciever()
+        self.ehub.subscribeToType("Type", recv,
+                                  core.DeliveryPolicy.maxRate(10))
+
+        # The first may go right away, the rest wait out the period
+        for i in xrange(5):
+            self.epubA.publish("Type", core.Event())
+        core.EventDispatcher.flush()
+        self.assert_(recv.calls >= 1)
+        self.assert_(recv.calls <= 2)
+
+    def testBadDelivery(self):
+        recv = Reciever()
+        self.assertRaises(ValueError, self.ehub.subscribeToType, "Type", recv,
+                          core.DeliveryPolicy.everyNth(0))
+        self.assertRaises(ValueError, self.ehub.subscribeToType, "Type", recv,
+                          core.DeliveryPolicy.maxRate(0))
+
 if __name__ == '__main__':
     unittest.main()
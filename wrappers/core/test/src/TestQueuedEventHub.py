@@ -69,5 +69,23 @@ class TestQueuedEventHub(unittest.TestCase):
         self.qehub.publishEvents()
         self.assertEquals(1, recv.calls)
 
+    def testLanes(self):
+        recv = Reciever()
+        self.qehub.subscribeToType('Normal', recv)
+        self.qehub.subscribeToType('Critical', recv,
+                                   lane = core.QueuedEventHub.CRITICAL_LANE)
+        self.qehub.subscribeToType('Latest', recv,
+                                   lane = core.QueuedEventHub.LATEST_LANE)
+        self.assertEquals(core.QueuedEventHub.LATEST_LANE,
+                          self.qehub.getTypeLane('Latest'))
+
+        self.epubA.publish('Latest', core.Event())
+        self.epubA.publish('Normal', core.Event())
+        self.epubA.publish('Latest', core.Event())
+        self.epubA.publish('Critical', core.Event())
+        self.assertEquals(3, self.qehub.publishEvents())
+        self.assertEquals(['Critical', 'Normal', 'Latest'], recv.etypes)
+        self.assertEquals(1, self.qehub.getCoalescedCount())
+
 if __name__ == '__main__':
     unittest.main()